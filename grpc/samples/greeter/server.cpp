@@ -7,12 +7,15 @@
 #include <memory>
 #include <string>
 
-class GreeterServiceImpl final : public Greeter::Service {
-  virtual grpc::Status SayHello(
+// `ArenaService` is `Service` with every unary method replaced by a
+// `Build...` method, that builds the response in the calling thread's
+// `flatbuffers::grpc::MessageBuilder` (see `ThreadMessageBuilder()`). Its
+// memory is reused from call to call.
+class GreeterServiceImpl final : public Greeter::ArenaService {
+  virtual grpc::Status BuildSayHello(
       grpc::ServerContext *context,
       const flatbuffers::grpc::Message<HelloRequest> *request_msg,
-      flatbuffers::grpc::Message<HelloReply> *response_msg) override {
-    // flatbuffers::grpc::MessageBuilder mb_;
+      flatbuffers::grpc::MessageBuilder *mb) override {
     // We call GetRoot to "parse" the message. Verification is already
     // performed by default. See the notes below for more details.
     const HelloRequest *request = request_msg->GetRoot();
@@ -23,15 +26,13 @@ class GreeterServiceImpl final : public Greeter::Service {
     // `flatbuffers::grpc::MessageBuilder` is a `FlatBufferBuilder` with a
     // special allocator for efficient gRPC buffer transfer, but otherwise
     // usage is the same as usual.
-    auto msg_offset = mb_.CreateString("Hello, " + name);
-    auto hello_offset = CreateHelloReply(mb_, msg_offset);
-    mb_.Finish(hello_offset);
+    auto msg_offset = mb->CreateString("Hello, " + name);
+    auto hello_offset = CreateHelloReply(*mb, msg_offset);
+    mb->Finish(hello_offset);
 
-    // The `ReleaseMessage<T>()` function detaches the message from the
-    // builder, so we can transfer the resopnse to gRPC while simultaneously
-    // detaching that memory buffer from the builer.
-    *response_msg = mb_.ReleaseMessage<HelloReply>();
-    assert(response_msg->Verify());
+    // The generated `SayHello()` then calls `ReleaseMessage<T>()`, which
+    // detaches the message from the builder, to transfer the response to
+    // gRPC without copying it.
 
     // Return an OK status.
     return grpc::Status::OK;
@@ -49,16 +50,15 @@ class GreeterServiceImpl final : public Greeter::Service {
     int num_greetings = request->num_greetings();
 
     for (int i = 0; i < num_greetings; i++) {
-      auto msg_offset = mb_.CreateString("Many hellos, " + name);
-      auto hello_offset = CreateHelloReply(mb_, msg_offset);
-      mb_.Finish(hello_offset);
-      writer->Write(mb_.ReleaseMessage<HelloReply>());
+      auto &mb = flatbuffers::grpc::ThreadMessageBuilder();
+      auto msg_offset = mb.CreateString("Many hellos, " + name);
+      auto hello_offset = CreateHelloReply(mb, msg_offset);
+      mb.Finish(hello_offset);
+      writer->Write(mb.ReleaseMessage<HelloReply>());
     }
 
     return grpc::Status::OK;
   }
-
-  flatbuffers::grpc::MessageBuilder mb_;
 };
 
 void RunServer() {
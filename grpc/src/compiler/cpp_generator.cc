@@ -785,6 +785,52 @@ void PrintHeaderServerMethodStreamedUnary(
   }
 }
 
+// A mixin for unary methods whose handler only builds the response. It gets
+// the calling thread's MessageBuilder, and the finished buffer is handed to
+// gRPC as is.
+void PrintHeaderServerMethodArena(grpc_generator::Printer *printer,
+                                  const grpc_generator::Method *method,
+                                  std::map<grpc::string, grpc::string> *vars) {
+  (*vars)["Method"] = method->name();
+  (*vars)["Request"] = method->input_type_name();
+  (*vars)["Response"] = method->output_type_name();
+  if (method->NoStreaming()) {
+    printer->Print(*vars, "template <class BaseClass>\n");
+    printer->Print(*vars,
+                   "class WithArenaMethod_$Method$ : public BaseClass {\n");
+    printer->Print(
+        " private:\n"
+        "  void BaseClassMustBeDerivedFromService(const Service *service) "
+        "{}\n");
+    printer->Print(" public:\n");
+    printer->Indent();
+    printer->Print(*vars,
+                   "~WithArenaMethod_$Method$() override {\n"
+                   "  BaseClassMustBeDerivedFromService(this);\n"
+                   "}\n");
+    printer->Print(
+        *vars,
+        "// build the response with the calling thread's builder\n"
+        "::grpc::Status $Method$("
+        "::grpc::ServerContext* context, const $Request$* request, "
+        "$Response$* response) final override {\n"
+        "  auto &fbb = ::flatbuffers::grpc::ThreadMessageBuilder();\n"
+        "  auto status = Build$Method$(context, request, &fbb);\n"
+        "  if (status.ok()) {\n"
+        "    *response = fbb.ReleaseMessage< $Response$::RootType>();\n"
+        "  }\n"
+        "  return status;\n"
+        "}\n");
+    printer->Print(*vars,
+                   "// finish the response in fbb, don't release it\n"
+                   "virtual ::grpc::Status Build$Method$("
+                   "::grpc::ServerContext* context, const $Request$* request, "
+                   "::flatbuffers::grpc::MessageBuilder* fbb) = 0;\n");
+    printer->Outdent();
+    printer->Print(*vars, "};\n");
+  }
+}
+
 void PrintHeaderServerMethodSplitStreaming(
     grpc_generator::Printer *printer, const grpc_generator::Method *method,
     std::map<grpc::string, grpc::string> *vars) {
@@ -908,9 +954,30 @@ void PrintHeaderServerMethodGeneric(
   printer->Print(*vars, "};\n");
 }
 
+// Typedefs for reading the streamed messages of a method one at a time, also
+// when the sender packs several per message with a FrameWriter.
+void PrintHeaderFrameReaders(grpc_generator::Printer *printer,
+                             const grpc_generator::Method *method,
+                             std::map<grpc::string, grpc::string> *vars) {
+  (*vars)["Method"] = method->name();
+  (*vars)["Request"] = method->input_type_name();
+  (*vars)["Response"] = method->output_type_name();
+  if (method->ClientStreaming() || method->BidiStreaming()) {
+    printer->Print(*vars,
+                   "typedef ::flatbuffers::grpc::FrameReader< $Request$> "
+                   "$Method$RequestFrameReader;\n");
+  }
+  if (method->ServerStreaming() || method->BidiStreaming()) {
+    printer->Print(*vars,
+                   "typedef ::flatbuffers::grpc::FrameReader< $Response$> "
+                   "$Method$ResponseFrameReader;\n");
+  }
+}
+
 void PrintHeaderService(grpc_generator::Printer *printer,
                         const grpc_generator::Service *service,
-                        std::map<grpc::string, grpc::string> *vars) {
+                        std::map<grpc::string, grpc::string> *vars,
+                        const Parameters &params) {
   (*vars)["Service"] = service->name();
 
   printer->Print(service->GetLeadingComments("//").c_str());
@@ -924,6 +991,11 @@ void PrintHeaderService(grpc_generator::Printer *printer,
                  "static constexpr char const* service_full_name() {\n"
                  "  return \"$Package$$Service$\";\n"
                  "}\n");
+  if (params.generate_frame_readers) {
+    for (int i = 0; i < service->method_count(); ++i) {
+      PrintHeaderFrameReaders(printer, service->method(i).get(), vars);
+    }
+  }
 
   // Client side
   printer->Print(
@@ -1034,6 +1106,28 @@ void PrintHeaderService(grpc_generator::Printer *printer,
   }
   printer->Print(" StreamedUnaryService;\n");
 
+  // Server side - responses built in a per-thread arena
+  if (params.generate_arena_methods) {
+    for (int i = 0; i < service->method_count(); ++i) {
+      PrintHeaderServerMethodArena(printer, service->method(i).get(), vars);
+    }
+
+    printer->Print("typedef ");
+    for (int i = 0; i < service->method_count(); ++i) {
+      (*vars)["method_name"] = service->method(i).get()->name();
+      if (service->method(i)->NoStreaming()) {
+        printer->Print(*vars, "WithArenaMethod_$method_name$<");
+      }
+    }
+    printer->Print("Service");
+    for (int i = 0; i < service->method_count(); ++i) {
+      if (service->method(i)->NoStreaming()) {
+        printer->Print(" >");
+      }
+    }
+    printer->Print(" ArenaService;\n");
+  }
+
   // Server side - controlled server-side streaming
   for (int i = 0; i < service->method_count(); ++i) {
     (*vars)["Idx"] = as_string(i);
@@ -1105,7 +1199,7 @@ grpc::string GetHeaderServices(grpc_generator::File *file,
     }
 
     for (int i = 0; i < file->service_count(); ++i) {
-      PrintHeaderService(printer.get(), file->service(i).get(), &vars);
+      PrintHeaderService(printer.get(), file->service(i).get(), &vars, params);
       printer->Print("\n");
     }
 
@@ -67,6 +67,10 @@ struct Parameters {
   grpc::string grpc_search_path;
   // Generate GMOCK code to facilitate unit testing.
   bool generate_mock_code;
+  // Generate FrameReader typedefs for streaming methods (FlatBuffers only).
+  bool generate_frame_readers;
+  // Generate WithArenaMethod_ server mixins (FlatBuffers only).
+  bool generate_arena_methods;
 };
 
 // Return the prologue of the generated header file.
@@ -25,18 +25,16 @@ using namespace MyGame::Example;
 
 // The callback implementation of our server, that derives from the generated
 // code. It implements all rpcs specified in the FlatBuffers schema.
-class ServiceImpl final : public MyGame::Example::MonsterStorage::Service {
-  virtual ::grpc::Status Store(
+class ServiceImpl final : public MyGame::Example::MonsterStorage::ArenaService {
+  virtual ::grpc::Status BuildStore(
       ::grpc::ServerContext *context,
       const flatbuffers::grpc::Message<Monster> *request,
-      flatbuffers::grpc::Message<Stat> *response) override {
-    // Create a response from the incoming request name.
-    fbb_.Clear();
+      flatbuffers::grpc::MessageBuilder *fbb) override {
+    // Create a response from the incoming request name, in this thread's
+    // builder. The generated code transfers ownership of it to gRPC.
     auto stat_offset = CreateStat(
-        fbb_, fbb_.CreateString("Hello, " + request->GetRoot()->name()->str()));
-    fbb_.Finish(stat_offset);
-    // Transfer ownership of the message to gRPC
-    *response = fbb_.ReleaseMessage<Stat>();
+        *fbb, fbb->CreateString("Hello, " + request->GetRoot()->name()->str()));
+    fbb->Finish(stat_offset);
     return grpc::Status::OK;
   }
   virtual ::grpc::Status Retrieve(
@@ -44,6 +42,8 @@ class ServiceImpl final : public MyGame::Example::MonsterStorage::Service {
       const flatbuffers::grpc::Message<Stat> *request,
       ::grpc::ServerWriter<flatbuffers::grpc::Message<Monster>> *writer)
       override {
+    // Pack the monsters into batches of up to 4, in slices from the pool.
+    flatbuffers::grpc::FrameWriter<Monster> batch(1024, &slice_pool_);
     for (int i = 0; i < 10; i++) {
       fbb_.Clear();
       // Create 10 monsters for resposne.
@@ -53,17 +53,18 @@ class ServiceImpl final : public MyGame::Example::MonsterStorage::Service {
                                           " No." + std::to_string(i)));
       fbb_.Finish(monster_offset);
 
-      flatbuffers::grpc::Message<Monster> monster =
-          fbb_.ReleaseMessage<Monster>();
+      batch.Add(fbb_);
 
-      // Send monster to client using streaming.
-      writer->Write(monster);
+      // Send monsters to client using streaming.
+      if (batch.count() == 4) writer->Write(batch.Release());
     }
+    if (!batch.empty()) writer->Write(batch.Release());
     return grpc::Status::OK;
   }
 
  private:
-  flatbuffers::grpc::MessageBuilder fbb_;
+  flatbuffers::grpc::SlicePool slice_pool_;
+  flatbuffers::grpc::MessageBuilder fbb_{1024, &slice_pool_};
 };
 
 // Track the server instance, so we can terminate it later.
@@ -132,11 +133,67 @@ int main(int /*argc*/, const char * /*argv*/ []) {
     auto request = fbb.ReleaseMessage<Stat>();
 
     flatbuffers::grpc::Message<Monster> response;
+    // The server batches its responses, so they are verified frame by frame,
+    // and the frame reader takes them apart.
+    flatbuffers::grpc::SetReceiveVerification<Monster>(
+        flatbuffers::grpc::kVerifyFramesOnReceive);
+    assert(flatbuffers::grpc::GetReceiveVerification<Stat>() ==
+           flatbuffers::grpc::GetReceiveVerification());
     auto stream = stub->Retrieve(&context, request);
-    while (stream->Read(&response)) {
+    MyGame::Example::MonsterStorage::RetrieveResponseFrameReader frames;
+    int count = 0;
+    while (frames.Read(stream.get(), &response)) {
       auto resp = response.GetRoot()->name();
       std::cout << "RPC Streaming response: " << resp->str() << std::endl;
+      count++;
     }
+    assert(count == 10);
+    flatbuffers::grpc::ResetReceiveVerification<Monster>();
+  }
+  {
+    // A batch is only taken apart when asked to, it doesn't verify as a T.
+    flatbuffers::grpc::FrameWriter<Monster> batch;
+    for (int i = 0; i < 2; i++) {
+      fbb.Clear();
+      fbb.Finish(CreateMonster(fbb, 0, 0, 0, fbb.CreateString("Fred")));
+      batch.Add(fbb.GetBufferPointer(), fbb.GetSize());
+    }
+    auto msg = batch.Release();
+    assert(!msg.Verify());
+    assert(msg.VerifyFrames());
+    std::vector<flatbuffers::grpc::Message<Monster>> split;
+    assert(msg.SplitFrames(&split));
+    assert(split.size() == 2);
+    for (auto it = split.begin(); it != split.end(); ++it) {
+      assert((it->data() - msg.data()) % FLATBUFFERS_MAX_ALIGNMENT == 0);
+      assert(it->GetVerifiedRoot()->name()->str() == "Fred");
+    }
+  }
+  {
+    // Every message received so far was either referenced or copied.
+    auto &stats = flatbuffers::grpc::GetReceiveStats();
+    assert(stats.messages > 0);
+    assert(stats.zero_copy + stats.copied == stats.messages);
+    std::cout << "Received " << stats.messages << " messages, "
+              << stats.copied << " copied" << std::endl;
+  }
+  {
+    // With verification deferred, the handler verifies, once.
+    flatbuffers::grpc::SetReceiveVerification<Stat>(
+        flatbuffers::grpc::kVerifyOnAccess);
+    grpc::ClientContext context;
+    fbb.Clear();
+    auto monster_offset = CreateMonster(fbb, 0, 0, 0, fbb.CreateString("Fred"));
+    fbb.Finish(monster_offset);
+    auto request = fbb.ReleaseMessage<Monster>();
+    flatbuffers::grpc::Message<Stat> response;
+    auto status = stub->Store(&context, request, &response);
+    assert(status.ok());
+    auto verified = flatbuffers::grpc::GetReceiveStats().verified.load();
+    assert(response.GetVerifiedRoot());
+    assert(response.GetVerifiedRoot()->id()->str() == "Hello, Fred");
+    assert(flatbuffers::grpc::GetReceiveStats().verified == verified + 1);
+    flatbuffers::grpc::ResetReceiveVerification<Stat>();
   }
 
 #if !FLATBUFFERS_GRPC_DISABLE_AUTO_VERIFICATION
@@ -99,6 +99,34 @@
   #endif
 #endif // !defined(FLATBUFFERS_LITTLEENDIAN)
 
+// SIMD instructions used to speed up verification, unless FLATBUFFERS_NO_SIMD
+// is defined. They are only used on little endian platforms, where the wire
+// format can be loaded directly.
+#if !defined(FLATBUFFERS_NO_SIMD) && FLATBUFFERS_LITTLEENDIAN
+  #if defined(__AVX2__)
+    #define FLATBUFFERS_SIMD_AVX2
+    #include <immintrin.h>
+  #elif defined(__SSE2__) || defined(_M_X64) || \
+        (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define FLATBUFFERS_SIMD_SSE2
+    #include <emmintrin.h>
+  #elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define FLATBUFFERS_SIMD_NEON
+    #include <arm_neon.h>
+  #endif
+#endif
+
+// Hint that the cache line at `addr` will be read soon, if the compiler
+// supports it.
+#if defined(__GNUC__) || defined(__clang__)
+  #define FLATBUFFERS_PREFETCH(addr) __builtin_prefetch(addr)
+#elif defined(FLATBUFFERS_SIMD_AVX2) || defined(FLATBUFFERS_SIMD_SSE2)
+  #define FLATBUFFERS_PREFETCH(addr) \
+    _mm_prefetch(reinterpret_cast<const char *>(addr), _MM_HINT_T0)
+#else
+  #define FLATBUFFERS_PREFETCH(addr) ((void)(addr))
+#endif
+
 #define FLATBUFFERS_VERSION_MAJOR 1
 #define FLATBUFFERS_VERSION_MINOR 8
 #define FLATBUFFERS_VERSION_REVISION 0
@@ -135,6 +163,12 @@
   #define FLATBUFFERS_NOEXCEPT
 #endif
 
+#if (!defined(_MSC_VER) || _MSC_VER >= 1900) && \
+    (!defined(__GNUC__) || defined(__clang__) || \
+     (__GNUC__ * 100 + __GNUC_MINOR__ >= 408))
+  #define FLATBUFFERS_THREAD_LOCAL thread_local
+#endif
+
 // NOTE: the FLATBUFFERS_DELETE_FUNC macro may change the access mode to
 // private, so be sure to put it at the end or reset access mode explicitly.
 #if (!defined(_MSC_VER) || _MSC_FULL_VER >= 180020827) && \
@@ -144,6 +178,17 @@
   #define FLATBUFFERS_DELETE_FUNC(func) private: func;
 #endif
 
+// Reports an event to the BuilderStats of a builder, if it has any, e.g.
+// FLATBUFFERS_BUILDER_STAT(stats_, Padding(n)). Builders only count with
+// FLATBUFFERS_BUILDER_STATS defined (for all code using FlatBuffers);
+// otherwise this is nothing, and its arguments aren't evaluated.
+#ifdef FLATBUFFERS_BUILDER_STATS
+  #define FLATBUFFERS_BUILDER_STAT(stats, event) \
+    do { if (stats) (stats)->event; } while (false)
+#else
+  #define FLATBUFFERS_BUILDER_STAT(stats, event) do {} while (false)
+#endif
+
 #if defined(_MSC_VER)
   #pragma warning(push)
   #pragma warning(disable: 4127) // C4127: conditional expression is constant
@@ -237,5 +282,77 @@ inline size_t PaddingBytes(size_t buf_size, size_t scalar_size) {
   return ((~buf_size) + 1) & (scalar_size - 1);
 }
 
+class BuilderStats;
+
+#ifdef FLATBUFFERS_BUILDER_STATS
+// What builders spend their work on, see FlatBufferBuilder::SetStats() and
+// flexbuffers::Builder::SetStats(). Only available if
+// FLATBUFFERS_BUILDER_STATS is defined. Builders have the same layout either
+// way, but only count in code compiled with it. The counts add up over all
+// buffers built until Clear(). To feed them to a metrics system instead (or
+// as well), override Count().
+class BuilderStats {
+ public:
+  enum Counter {
+    kReallocations,      // The buffer growing into a new allocation.
+    kBytesCopied,        // Bytes moved from the old allocation when it did.
+    kVtablesEmitted,     // New vtables (FlexBuffers: map key vectors).
+    kVtablesDeduped,     // Those found to exist already, and shared.
+    kSharedStrings,      // New shared strings (FlexBuffers: and keys).
+    kSharedStringHits,   // Those found to exist already, and shared.
+    kPaddingBytes,       // Bytes spent on alignment.
+    kBuffersFinished,
+    kFinishedBytes,      // The total size of the buffers finished.
+    kNumCounters
+  };
+
+  BuilderStats() { Clear(); }
+  virtual ~BuilderStats() {}
+
+  virtual void Count(Counter counter, size_t n) { counts_[counter] += n; }
+
+  uint64_t count(Counter counter) const { return counts_[counter]; }
+
+  static const char *CounterName(Counter counter) {
+    static const char *const names[] = {
+      "reallocations", "bytes_copied", "vtables_emitted", "vtables_deduped",
+      "shared_strings", "shared_string_hits", "padding_bytes",
+      "buffers_finished", "finished_bytes"
+    };
+    return names[counter];
+  }
+
+  void Clear() {
+    for (int i = 0; i < kNumCounters; i++) counts_[i] = 0;
+  }
+
+  // Called by the builders.
+  void Reallocated(size_t bytes_copied) {
+    Count(kReallocations, 1);
+    Count(kBytesCopied, bytes_copied);
+  }
+  // For buffers in a std::vector: before writing `len` more bytes.
+  void Grow(size_t size, size_t capacity, size_t len) {
+    if (size + len > capacity) Reallocated(size);
+  }
+  void Vtable(bool deduped) {
+    Count(deduped ? kVtablesDeduped : kVtablesEmitted, 1);
+  }
+  void SharedString(bool hit) {
+    Count(hit ? kSharedStringHits : kSharedStrings, 1);
+  }
+  void Padding(size_t bytes) {
+    if (bytes) Count(kPaddingBytes, bytes);
+  }
+  void Finished(size_t size) {
+    Count(kBuffersFinished, 1);
+    Count(kFinishedBytes, size);
+  }
+
+ private:
+  uint64_t counts_[kNumCounters];
+};
+#endif  // FLATBUFFERS_BUILDER_STATS
+
 }  // namespace flatbuffers
 #endif  // FLATBUFFERS_BASE_H_
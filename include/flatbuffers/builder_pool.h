@@ -0,0 +1,178 @@
+/*
+ * Copyright 2018 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLATBUFFERS_BUILDER_POOL_H_
+#define FLATBUFFERS_BUILDER_POOL_H_
+
+#include <mutex>
+
+#include "flatbuffers/flatbuffers.h"
+
+namespace flatbuffers {
+
+// A pool of builders that can be shared between threads, so that a service
+// doesn't construct (and allocate for) a new builder for every message it
+// sends. Builders are handed out with `Acquire()` and go back to the pool
+// when the returned handle goes out of scope. A returned builder is
+// `Clear()`-ed, so it keeps its memory for the next buffer, unless it grew
+// beyond the pool's high-water mark, in which case it is `Reset()`.
+//
+// `Builder` is `FlatBufferBuilder` or a class derived from it, such as
+// `grpc::MessageBuilder`. Call `ReleaseMessage()` on a message builder before
+// giving it back: `Clear()` would otherwise reuse memory still owned by the
+// message.
+template<typename Builder> class BuilderPool {
+ public:
+  class Handle {
+   public:
+    Handle() : pool_(nullptr), builder_(nullptr) {}
+    Handle(Handle &&other) : pool_(other.pool_), builder_(other.builder_) {
+      other.builder_ = nullptr;
+    }
+    Handle &operator=(Handle &&other) {
+      if (this != &other) {
+        reset();
+        pool_ = other.pool_;
+        builder_ = other.builder_;
+        other.builder_ = nullptr;
+      }
+      return *this;
+    }
+    ~Handle() { reset(); }
+
+    Builder &operator*() const { return *builder_; }
+    Builder *operator->() const { return builder_; }
+    Builder *get() const { return builder_; }
+    explicit operator bool() const { return builder_ != nullptr; }
+
+    // Give the builder back to the pool before the handle goes away.
+    void reset() {
+      if (builder_) pool_->Return(builder_);
+      builder_ = nullptr;
+    }
+
+   private:
+    friend class BuilderPool;
+    Handle(BuilderPool *pool, Builder *builder)
+        : pool_(pool), builder_(builder) {}
+    FLATBUFFERS_DELETE_FUNC(Handle(const Handle &))
+    FLATBUFFERS_DELETE_FUNC(Handle &operator=(const Handle &))
+
+    BuilderPool *pool_;
+    Builder *builder_;
+  };
+
+  // `max_pooled` is how many idle builders the pool holds on to, anything
+  // returned beyond that is deleted. A returned builder whose buffer has grown
+  // beyond `high_water_mark` bytes is `Reset()` rather than `Clear()`-ed, so
+  // that one unusually large message doesn't pin its memory in the pool
+  // (0 means never trim). New builders are constructed with `initial_size`.
+  explicit BuilderPool(size_t max_pooled = 16,
+                       size_t high_water_mark = 1024 * 1024,
+                       uoffset_t initial_size = 1024)
+      : max_pooled_(max_pooled),
+        high_water_mark_(high_water_mark),
+        initial_size_(initial_size),
+        num_created_(0) {}
+
+  // Handles must not outlive the pool.
+  ~BuilderPool() { Trim(0); }
+
+  // Get a builder from the pool, or construct one if none are idle. The
+  // builder is empty and ready to build a new buffer.
+  Handle Acquire() {
+    Builder *builder = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!free_.empty()) {
+        builder = free_.back();
+        free_.pop_back();
+      } else {
+        num_created_++;
+      }
+    }
+    if (!builder) builder = new Builder(initial_size_);
+    return Handle(this, builder);
+  }
+
+  // Delete idle builders until at most `max_idle` are left.
+  void Trim(size_t max_idle) {
+    std::vector<Builder *> trimmed;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      while (free_.size() > max_idle) {
+        trimmed.push_back(free_.back());
+        free_.pop_back();
+      }
+    }
+    for (auto it = trimmed.begin(); it != trimmed.end(); ++it) delete *it;
+  }
+
+  void SetHighWaterMark(size_t high_water_mark) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    high_water_mark_ = high_water_mark;
+  }
+
+  // The number of idle builders in the pool.
+  size_t idle() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return free_.size();
+  }
+
+  // The number of builders the pool has constructed so far.
+  size_t created() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return num_created_;
+  }
+
+ private:
+  FLATBUFFERS_DELETE_FUNC(BuilderPool(const BuilderPool &))
+  FLATBUFFERS_DELETE_FUNC(BuilderPool &operator=(const BuilderPool &))
+
+  void Return(Builder *builder) {
+    size_t high_water_mark;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      high_water_mark = high_water_mark_;
+    }
+    // Do the (possibly expensive) cleanup outside of the lock.
+    if (high_water_mark && builder->GetCapacity() > high_water_mark)
+      builder->Reset();
+    else
+      builder->Clear();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (free_.size() < max_pooled_) {
+        free_.push_back(builder);
+        builder = nullptr;
+      }
+    }
+    if (builder) delete builder;
+  }
+
+  mutable std::mutex mutex_;
+  std::vector<Builder *> free_;
+  size_t max_pooled_;
+  size_t high_water_mark_;
+  uoffset_t initial_size_;
+  size_t num_created_;
+};
+
+typedef BuilderPool<FlatBufferBuilder> FlatBufferBuilderPool;
+
+}  // namespace flatbuffers
+
+#endif  // FLATBUFFERS_BUILDER_POOL_H_
@@ -0,0 +1,270 @@
+/*
+ * Copyright 2018 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLATBUFFERS_COLUMN_EXTRACTOR_H_
+#define FLATBUFFERS_COLUMN_EXTRACTOR_H_
+
+#include "flatbuffers/reflection.h"
+
+namespace flatbuffers {
+
+// Reads fields of many FlatBuffers of a binary schema (see reflection.h)
+// into columns, one per field, e.g. for analytics on a stream of records
+// whose schema is only known at runtime. The fields are given as paths like
+// those of FieldAccessor, and must be scalars or strings.
+//
+// Each column is laid out like an Arrow array of the field's type:
+// - `validity` has a bit per row, least significant bit first, set unless
+//   the row is null.
+// - Scalars are native endian values in `values`, e.g. int16 for a short.
+//   Bools are packed into a bit per row, like `validity`.
+// - Strings are UTF-8, row i being the bytes of `data` from `offsets[i]` to
+//   `offsets[i + 1]`.
+// Scalars are never null: a field that isn't set, or is in a table that
+// isn't, reads as its default like with FieldAccessor. Strings that aren't
+// set are null.
+//
+// The root tables of a batch of buffers are often laid out the same, with
+// identical vtables. So where the fields of the root tables are is only
+// worked out once for each run of rows with the same vtable. With a
+// ParallelExecutor (e.g. a ThreadPool), the rows are split into chunks that
+// are read in parallel.
+//
+// The buffers must have been verified. An extractor is meant to be kept
+// around: the columns keep their memory between batches.
+class ColumnExtractor {
+ public:
+  struct Column {
+    std::string path;
+    reflection::BaseType type;
+    size_t length;  // The number of rows.
+    size_t null_count;
+    std::vector<uint8_t> validity;
+    std::vector<uint8_t> values;  // Scalars only.
+    std::vector<int32_t> offsets;  // Strings only, length + 1 of them.
+    std::vector<char> data;        // Strings only.
+  };
+
+  // `schema` must outlive the extractor, the buffers are expected to have
+  // a root table of type `object`.
+  ColumnExtractor(const reflection::Schema &schema,
+                  const reflection::Object &object)
+      : schema_(schema), object_(object), buffers_(nullptr), rows_(0) {}
+
+  // Adds a column for the field at `path`. Returns false if it doesn't name
+  // a field, or the field isn't a scalar or string.
+  bool AddColumn(const char *path) {
+    Plan plan;
+    if (!plan.accessor.Resolve(schema_, object_, path)) return false;
+    auto type = plan.accessor.field().type()->base_type();
+    if (!IsScalar(type) && type != reflection::String) return false;
+    plan.size = IsScalar(type) ? GetTypeSize(type) : 0;
+    plan.store = nullptr;
+    // clang-format off
+    #define FLATBUFFERS_STORE(T) \
+      plan.store = Store<T>; \
+      SetDefault<T>(plan.accessor, plan.default_value); \
+      break
+    switch (type) {
+      case reflection::UType:
+      case reflection::UByte:  FLATBUFFERS_STORE(uint8_t);
+      case reflection::Byte:   FLATBUFFERS_STORE(int8_t);
+      case reflection::Short:  FLATBUFFERS_STORE(int16_t);
+      case reflection::UShort: FLATBUFFERS_STORE(uint16_t);
+      case reflection::Int:    FLATBUFFERS_STORE(int32_t);
+      case reflection::UInt:   FLATBUFFERS_STORE(uint32_t);
+      case reflection::Long:   FLATBUFFERS_STORE(int64_t);
+      case reflection::ULong:  FLATBUFFERS_STORE(uint64_t);
+      case reflection::Float:  FLATBUFFERS_STORE(float);
+      case reflection::Double: FLATBUFFERS_STORE(double);
+      default: break;  // Bools and strings are special cased.
+    }
+    #undef FLATBUFFERS_STORE
+    // clang-format on
+    plan.default_bool = plan.accessor.default_i_ != 0;
+    plans_.push_back(plan);
+    Column column;
+    column.path = path;
+    column.type = type;
+    column.length = 0;
+    column.null_count = 0;
+    columns_.push_back(column);
+    return true;
+  }
+
+  size_t num_columns() const { return columns_.size(); }
+  const Column &column(size_t i) const { return columns_[i]; }
+
+  // Replaces the contents of the columns with a row for each of the `count`
+  // buffers.
+  void Extract(const uint8_t *const *buffers, size_t count,
+               ParallelExecutor *executor = nullptr) {
+    buffers_ = buffers;
+    rows_ = count;
+    auto bitmap_size = (count + 7) / 8;
+    for (size_t i = 0; i < columns_.size(); i++) {
+      auto &column = columns_[i];
+      auto &plan = plans_[i];
+      column.length = count;
+      column.null_count = 0;
+      column.validity.assign(bitmap_size, 0);
+      if (column.type == reflection::Bool) {
+        column.values.assign(bitmap_size, 0);
+      } else {
+        column.values.resize(count * plan.size);
+      }
+      column.offsets.resize(column.type == reflection::String ? count + 1 : 0);
+      column.data.clear();
+    }
+    auto num_chunks = (count + kRowsPerChunk - 1) / kRowsPerChunk;
+    if (chunks_.size() < num_chunks) chunks_.resize(num_chunks);
+    if (executor) {
+      executor->ParallelFor(num_chunks, ExtractChunkTask, this);
+    } else {
+      for (size_t i = 0; i < num_chunks; i++) ExtractChunk(i);
+    }
+    // Stitch the chunks' strings together.
+    for (size_t i = 0; i < columns_.size(); i++) {
+      auto &column = columns_[i];
+      for (size_t c = 0; c < num_chunks; c++) {
+        auto &chunk = chunks_[c];
+        column.null_count += chunk.null_counts[i];
+        if (column.type != reflection::String) continue;
+        auto &data = chunk.strings[i];
+        auto base = column.data.size();
+        assert(base + data.size() <= 0x7FFFFFFF);  // Arrow's offsets limit.
+        auto begin = c * kRowsPerChunk;
+        auto end = (std::min)(begin + kRowsPerChunk, count);
+        for (auto row = begin; row < end; row++) {
+          column.offsets[row + 1] += static_cast<int32_t>(base);
+        }
+        column.data.insert(column.data.end(), data.begin(), data.end());
+      }
+      if (column.type == reflection::String) column.offsets[0] = 0;
+    }
+  }
+
+ private:
+  // A multiple of 8, so chunks don't share bytes of the bitmaps.
+  static const size_t kRowsPerChunk = 1024;
+
+  struct Plan {
+    FieldAccessor accessor;
+    size_t size;
+    // Copies a scalar from a buffer to a column, in native endianness.
+    void (*store)(const uint8_t *src, uint8_t *dest);
+    uint64_t default_value;  // As it is stored in the column.
+    bool default_bool;
+  };
+
+  // Scratch space of a chunk of rows.
+  struct Chunk {
+    std::vector<voffset_t> positions;  // Of the columns' root table fields.
+    std::vector<size_t> null_counts;
+    std::vector<std::vector<char>> strings;
+  };
+
+  template<typename T> static void Store(const uint8_t *src, uint8_t *dest) {
+    auto val = ReadScalar<T>(src);
+    memcpy(dest, &val, sizeof(T));
+  }
+
+  template<typename T>
+  static void SetDefault(const FieldAccessor &accessor, uint64_t &dest) {
+    T val = std::is_floating_point<T>::value
+                ? static_cast<T>(accessor.default_f_)
+                : static_cast<T>(accessor.default_i_);
+    dest = 0;
+    memcpy(&dest, &val, sizeof(T));
+  }
+
+  static void ExtractChunkTask(void *context, size_t i) {
+    reinterpret_cast<ColumnExtractor *>(context)->ExtractChunk(i);
+  }
+
+  void ExtractChunk(size_t c) {
+    auto &chunk = chunks_[c];
+    chunk.positions.resize(plans_.size());
+    chunk.null_counts.assign(plans_.size(), 0);
+    chunk.strings.resize(plans_.size());
+    for (auto it = chunk.strings.begin(); it != chunk.strings.end(); ++it)
+      it->clear();
+    auto begin = c * kRowsPerChunk;
+    auto end = (std::min)(begin + kRowsPerChunk, rows_);
+    const uint8_t *vtable = nullptr;
+    voffset_t vtable_size = 0;
+    for (auto row = begin; row < end; row++) {
+      auto table = GetAnyRoot(buffers_[row]);
+      auto table_data = reinterpret_cast<const uint8_t *>(table);
+      auto row_vtable = table->GetVTable();
+      auto row_vtable_size = ReadScalar<voffset_t>(row_vtable);
+      if (!vtable || row_vtable_size != vtable_size ||
+          memcmp(row_vtable, vtable, vtable_size)) {
+        vtable = row_vtable;
+        vtable_size = row_vtable_size;
+        for (size_t i = 0; i < plans_.size(); i++) {
+          auto offset = plans_[i].accessor.steps_[0].offset;
+          chunk.positions[i] =
+              offset < vtable_size ? ReadScalar<voffset_t>(vtable + offset) : 0;
+        }
+      }
+      for (size_t i = 0; i < plans_.size(); i++) {
+        auto &plan = plans_[i];
+        auto &column = columns_[i];
+        auto position = chunk.positions[i];
+        auto p = plan.accessor.Follow(position ? table_data + position
+                                                : nullptr);
+        auto bit = static_cast<uint8_t>(1 << (row & 7));
+        if (column.type == reflection::String) {
+          auto &data = chunk.strings[i];
+          if (p) {
+            auto str =
+                reinterpret_cast<const String *>(p + ReadScalar<uoffset_t>(p));
+            data.insert(data.end(), str->c_str(), str->c_str() + str->size());
+            column.validity[row >> 3] |= bit;
+          } else {
+            chunk.null_counts[i]++;
+          }
+          // Relative to the chunk until Extract() adds up the chunks.
+          column.offsets[row + 1] = static_cast<int32_t>(data.size());
+          continue;
+        }
+        column.validity[row >> 3] |= bit;
+        if (column.type == reflection::Bool) {
+          if (p ? *p != 0 : plan.default_bool) column.values[row >> 3] |= bit;
+        } else if (p) {
+          plan.store(p, &column.values[row * plan.size]);
+        } else {
+          memcpy(&column.values[row * plan.size], &plan.default_value,
+                 plan.size);
+        }
+      }
+    }
+  }
+
+  const reflection::Schema &schema_;
+  const reflection::Object &object_;
+  std::vector<Plan> plans_;
+  std::vector<Column> columns_;
+  std::vector<Chunk> chunks_;
+  // The batch being extracted.
+  const uint8_t *const *buffers_;
+  size_t rows_;
+};
+
+}  // namespace flatbuffers
+
+#endif  // FLATBUFFERS_COLUMN_EXTRACTOR_H_
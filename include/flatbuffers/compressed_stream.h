@@ -0,0 +1,616 @@
+/*
+ * Copyright 2018 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLATBUFFERS_COMPRESSED_STREAM_H_
+#define FLATBUFFERS_COMPRESSED_STREAM_H_
+
+#include "flatbuffers/stream.h"
+
+// clang-format off
+#ifdef FLATBUFFERS_USE_ZSTD
+  #include <zdict.h>
+  #include <zstd.h>
+#endif
+#ifdef FLATBUFFERS_USE_LZ4
+  #include <lz4.h>
+#endif
+// clang-format on
+
+// Compression for streams (see stream.h): records are grouped into blocks of
+// a fixed number of them, and each block is compressed and stored as one
+// record of an ordinary stream. Reading a record only decompresses its block,
+// which the stream's index finds directly.
+//
+// A block is stored as its size prefix, the id of the codec it was
+// compressed with (0 if it is stored as is, when compressing doesn't make it
+// smaller), its uncompressed size, the number of records in it (all 32-bit),
+// and then the compressed data. Uncompressed, a block holds its records laid
+// out as in a stream: each size-prefixed, starting at a multiple of
+// FLATBUFFERS_MAX_ALIGNMENT.
+
+namespace flatbuffers {
+
+// A compression algorithm for blocks of records, e.g. LzBlockCodec below, or
+// a wrapper of a compression library. Codecs may keep state (such as a
+// dictionary or a compression context), so a codec is used by one reader or
+// writer at a time.
+class BlockCodec {
+ public:
+  virtual ~BlockCodec() {}
+
+  // Identifies the compressed format, and is stored with every block so that
+  // readers can tell they have the right codec. 0 is reserved for blocks
+  // stored uncompressed.
+  virtual uint32_t id() const = 0;
+
+  // Appends the compressed form of the `size` bytes at `data` to `out`.
+  virtual bool Compress(const uint8_t *data, size_t size,
+                        std::vector<uint8_t> *out) = 0;
+
+  // Decompresses the `size` bytes at `data` into `raw_size` bytes at `out`.
+  // Returns false unless they decompress to exactly `raw_size` bytes.
+  virtual bool Decompress(const uint8_t *data, size_t size, uint8_t *out,
+                          size_t raw_size) = 0;
+
+  // The most bytes `size` compressed bytes can decompress to, so that readers
+  // can reject a block claiming to be larger before allocating memory for it.
+  virtual size_t MaxRawSize(size_t size) const = 0;
+};
+
+// A simple, fast LZ77 codec in the style of LZ4, without dependencies.
+// FlatBuffers compress well with it, since they are full of zero padding,
+// default values and repeated vtables and strings.
+// Matches can also refer to a dictionary: data typical of the records,
+// such as a few sample buffers of the schema concatenated, which helps a lot
+// when blocks are small. The same dictionary must be used to decompress.
+//
+// The data is a series of sequences, each a token byte whose high and low 4
+// bits are the number of literals and the length of the match after them
+// minus 4 (15 meaning more follows, in bytes of 255 up to a smaller one), the
+// literals, and the 16-bit distance back to the match. The last sequence
+// ends after its literals.
+class LzBlockCodec : public BlockCodec {
+ public:
+  static const uint32_t kId = 0x315a4c46;  // "FLZ1"
+
+  // `dictionary` (not owned) must outlive the codec; only its last 64KB are
+  // used.
+  explicit LzBlockCodec(const uint8_t *dictionary = nullptr,
+                        size_t dictionary_size = 0)
+      : dictionary_(dictionary), dictionary_size_(0) {
+    if (dictionary_size > kMaxDistance) {
+      dictionary_ += dictionary_size - kMaxDistance;
+      dictionary_size = kMaxDistance;
+    }
+    dictionary_size_ = dictionary_size;
+  }
+
+  uint32_t id() const FLATBUFFERS_OVERRIDE { return kId; }
+
+  bool Compress(const uint8_t *data, size_t size,
+                std::vector<uint8_t> *out) FLATBUFFERS_OVERRIDE {
+    // Look for matches in the dictionary and the data as one window.
+    window_.assign(dictionary_, dictionary_ + dictionary_size_);
+    window_.insert(window_.end(), data, data + size);
+    table_.assign(kTableSize, -1);
+    const uint8_t *w = window_.data();
+    auto end = window_.size();
+    for (size_t pos = 0; pos + kMinMatch <= dictionary_size_; pos++)
+      table_[Hash(w + pos)] = static_cast<int32_t>(pos);
+    auto anchor = dictionary_size_;
+    auto pos = dictionary_size_;
+    while (pos + kMinMatch <= end) {
+      auto &slot = table_[Hash(w + pos)];
+      auto match = slot;
+      slot = static_cast<int32_t>(pos);
+      if (match < 0 || pos - static_cast<size_t>(match) > kMaxDistance ||
+          memcmp(w + match, w + pos, kMinMatch)) {
+        pos++;
+        continue;
+      }
+      auto len = kMinMatch;
+      while (pos + len < end && w[match + len] == w[pos + len]) len++;
+      PutSequence(w + anchor, pos - anchor, len, pos - match, out);
+      // Remember some positions inside the match, for the matches after it.
+      for (size_t i = pos + 1; i + kMinMatch <= pos + len && i < pos + 16; i++)
+        table_[Hash(w + i)] = static_cast<int32_t>(i);
+      pos += len;
+      anchor = pos;
+    }
+    PutSequence(w + anchor, end - anchor, 0, 0, out);
+    return true;
+  }
+
+  bool Decompress(const uint8_t *data, size_t size, uint8_t *out,
+                  size_t raw_size) FLATBUFFERS_OVERRIDE {
+    auto end = data + size;
+    size_t op = 0;
+    // Every sequence is followed by another, up to the last, literals only.
+    for (;;) {
+      if (data == end) return false;
+      auto token = *data++;
+      size_t literals = token >> 4;
+      if (literals == 15 && !GetLength(&data, end, &literals)) return false;
+      if (literals > static_cast<size_t>(end - data) ||
+          literals > raw_size - op)
+        return false;
+      memcpy(out + op, data, literals);
+      data += literals;
+      op += literals;
+      if (data == end) return op == raw_size;
+      if (end - data < 2) return false;
+      // Little endian, and bytewise since it needn't be aligned.
+      size_t distance = data[0] | (static_cast<size_t>(data[1]) << 8);
+      data += 2;
+      size_t len = token & 15;
+      if (len == 15 && !GetLength(&data, end, &len)) return false;
+      len += kMinMatch;
+      if (!distance || distance > dictionary_size_ + op || len > raw_size - op)
+        return false;
+      // Bytewise, since matches may overlap the bytes they produce.
+      auto from = dictionary_size_ + op - distance;
+      for (size_t i = 0; i < len; i++, from++) {
+        out[op + i] = from < dictionary_size_
+                          ? dictionary_[from]
+                          : out[from - dictionary_size_];
+      }
+      op += len;
+    }
+  }
+
+  // A length byte of 255 adds 255 bytes to a match, and no byte adds more.
+  size_t MaxRawSize(size_t size) const FLATBUFFERS_OVERRIDE {
+    return size * 255;
+  }
+
+ private:
+  static const size_t kMinMatch = 4;
+  static const size_t kMaxDistance = 65535;
+  static const size_t kTableBits = 14;
+  static const size_t kTableSize = 1 << kTableBits;
+
+  static size_t Hash(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return (v * 2654435761U) >> (32 - kTableBits);
+  }
+
+  static void PutLength(size_t len, std::vector<uint8_t> *out) {
+    for (; len >= 255; len -= 255) out->push_back(255);
+    out->push_back(static_cast<uint8_t>(len));
+  }
+
+  static bool GetLength(const uint8_t **data, const uint8_t *end,
+                        size_t *len) {
+    uint8_t b;
+    do {
+      if (*data == end) return false;
+      b = *(*data)++;
+      *len += b;
+    } while (b == 255);
+    return true;
+  }
+
+  // `len` 0 means no match: the last sequence.
+  static void PutSequence(const uint8_t *literals, size_t num_literals,
+                          size_t len, size_t distance,
+                          std::vector<uint8_t> *out) {
+    auto match = len ? len - kMinMatch : 0;
+    out->push_back(static_cast<uint8_t>(
+        ((num_literals < 15 ? num_literals : 15) << 4) |
+        (match < 15 ? match : 15)));
+    if (num_literals >= 15) PutLength(num_literals - 15, out);
+    out->insert(out->end(), literals, literals + num_literals);
+    if (!len) return;
+    out->push_back(static_cast<uint8_t>(distance));
+    out->push_back(static_cast<uint8_t>(distance >> 8));
+    if (match >= 15) PutLength(match - 15, out);
+  }
+
+  const uint8_t *dictionary_;
+  size_t dictionary_size_;
+  std::vector<uint8_t> window_;
+  std::vector<int32_t> table_;
+};
+
+// clang-format off
+#ifdef FLATBUFFERS_USE_ZSTD
+// clang-format on
+// Zstandard, optionally with a dictionary, e.g. from TrainDictionary().
+class ZstdBlockCodec : public BlockCodec {
+ public:
+  static const uint32_t kId = 0x3154535a;  // "ZST1"
+
+  // `dictionary` (not owned) must outlive the codec.
+  explicit ZstdBlockCodec(int level = 3, const uint8_t *dictionary = nullptr,
+                          size_t dictionary_size = 0)
+      : level_(level),
+        dictionary_(dictionary),
+        dictionary_size_(dictionary_size),
+        cctx_(ZSTD_createCCtx()),
+        dctx_(ZSTD_createDCtx()) {}
+
+  ~ZstdBlockCodec() {
+    ZSTD_freeCCtx(cctx_);
+    ZSTD_freeDCtx(dctx_);
+  }
+
+  uint32_t id() const FLATBUFFERS_OVERRIDE { return kId; }
+
+  bool Compress(const uint8_t *data, size_t size,
+                std::vector<uint8_t> *out) FLATBUFFERS_OVERRIDE {
+    auto start = out->size();
+    out->resize(start + ZSTD_compressBound(size));
+    auto n = ZSTD_compress_usingDict(cctx_, out->data() + start,
+                                     out->size() - start, data, size,
+                                     dictionary_, dictionary_size_, level_);
+    if (ZSTD_isError(n)) return false;
+    out->resize(start + n);
+    return true;
+  }
+
+  bool Decompress(const uint8_t *data, size_t size, uint8_t *out,
+                  size_t raw_size) FLATBUFFERS_OVERRIDE {
+    auto n = ZSTD_decompress_usingDict(dctx_, out, raw_size, data, size,
+                                       dictionary_, dictionary_size_);
+    return !ZSTD_isError(n) && n == raw_size;
+  }
+
+  // The best a frame can do is a series of run-length blocks of 4 bytes each.
+  size_t MaxRawSize(size_t size) const FLATBUFFERS_OVERRIDE {
+    return (size / 4 + 1) * ZSTD_BLOCKSIZE_MAX;
+  }
+
+  // Trains a dictionary of at most `max_size` bytes on `samples`, e.g. a few
+  // hundred typical buffers of a schema. Returns an empty one on failure
+  // (such as too few samples).
+  static std::vector<uint8_t> TrainDictionary(
+      const std::vector<std::string> &samples, size_t max_size = 16384) {
+    std::string concatenated;
+    std::vector<size_t> sizes;
+    for (auto it = samples.begin(); it != samples.end(); ++it) {
+      concatenated += *it;
+      sizes.push_back(it->size());
+    }
+    std::vector<uint8_t> dictionary(max_size);
+    auto n = ZDICT_trainFromBuffer(dictionary.data(), max_size,
+                                   concatenated.data(), sizes.data(),
+                                   static_cast<unsigned>(sizes.size()));
+    dictionary.resize(ZDICT_isError(n) ? 0 : n);
+    return dictionary;
+  }
+
+ private:
+  FLATBUFFERS_DELETE_FUNC(ZstdBlockCodec(const ZstdBlockCodec &))
+  FLATBUFFERS_DELETE_FUNC(ZstdBlockCodec &operator=(const ZstdBlockCodec &))
+
+  int level_;
+  const uint8_t *dictionary_;
+  size_t dictionary_size_;
+  ZSTD_CCtx *cctx_;
+  ZSTD_DCtx *dctx_;
+};
+// clang-format off
+#endif  // FLATBUFFERS_USE_ZSTD
+
+#ifdef FLATBUFFERS_USE_LZ4
+// clang-format on
+// LZ4, optionally with a dictionary (of which LZ4 uses the last 64KB).
+class Lz4BlockCodec : public BlockCodec {
+ public:
+  static const uint32_t kId = 0x31345a4c;  // "LZ41"
+
+  // `dictionary` (not owned) must outlive the codec.
+  explicit Lz4BlockCodec(const uint8_t *dictionary = nullptr,
+                         size_t dictionary_size = 0)
+      : dictionary_(reinterpret_cast<const char *>(dictionary)),
+        dictionary_size_(static_cast<int>(dictionary_size)),
+        stream_(LZ4_createStream()) {}
+
+  ~Lz4BlockCodec() { LZ4_freeStream(stream_); }
+
+  uint32_t id() const FLATBUFFERS_OVERRIDE { return kId; }
+
+  bool Compress(const uint8_t *data, size_t size,
+                std::vector<uint8_t> *out) FLATBUFFERS_OVERRIDE {
+    auto start = out->size();
+    auto bound = LZ4_compressBound(static_cast<int>(size));
+    out->resize(start + static_cast<size_t>(bound));
+    // Loading the dictionary also starts a new, independent block.
+    LZ4_loadDict(stream_, dictionary_, dictionary_size_);
+    auto n = LZ4_compress_fast_continue(
+        stream_, reinterpret_cast<const char *>(data),
+        reinterpret_cast<char *>(out->data() + start), static_cast<int>(size),
+        bound, 1);
+    if (n <= 0) return false;
+    out->resize(start + static_cast<size_t>(n));
+    return true;
+  }
+
+  bool Decompress(const uint8_t *data, size_t size, uint8_t *out,
+                  size_t raw_size) FLATBUFFERS_OVERRIDE {
+    auto n = LZ4_decompress_safe_usingDict(
+        reinterpret_cast<const char *>(data), reinterpret_cast<char *>(out),
+        static_cast<int>(size), static_cast<int>(raw_size), dictionary_,
+        dictionary_size_);
+    return n >= 0 && static_cast<size_t>(n) == raw_size;
+  }
+
+  // LZ4 expands data at most 255 times, as does LzBlockCodec.
+  size_t MaxRawSize(size_t size) const FLATBUFFERS_OVERRIDE {
+    return size * 255;
+  }
+
+ private:
+  FLATBUFFERS_DELETE_FUNC(Lz4BlockCodec(const Lz4BlockCodec &))
+  FLATBUFFERS_DELETE_FUNC(Lz4BlockCodec &operator=(const Lz4BlockCodec &))
+
+  const char *dictionary_;
+  int dictionary_size_;
+  LZ4_stream_t *stream_;
+};
+// clang-format off
+#endif  // FLATBUFFERS_USE_LZ4
+// clang-format on
+
+static const size_t kCompressedBlockHeaderSize = 4 * sizeof(uint32_t);
+
+// Writes records to a Sink as a compressed stream.
+class CompressedStreamWriter {
+ public:
+  // Compresses every `records_per_block` records as a block with `codec`
+  // (not owned). Larger blocks compress better, smaller ones make reading a
+  // record cheaper.
+  CompressedStreamWriter(Sink &out, BlockCodec &codec,
+                         uint32_t records_per_block = 64)
+      : stream_(out, 1),
+        codec_(codec),
+        records_per_block_(records_per_block ? records_per_block : 1),
+        num_records_(0),
+        block_records_(0),
+        ok_(stream_.ok()) {}
+
+  // Adds the `size` byte size-prefixed FlatBuffer at `buf` to the current
+  // block, compressing and writing it out once it is full. Returns false if
+  // `buf` isn't size-prefixed, or writing failed.
+  bool Append(const uint8_t *buf, size_t size) {
+    if (!ok_ || size < sizeof(uoffset_t) ||
+        ReadScalar<uoffset_t>(buf) != size - sizeof(uoffset_t))
+      return false;
+    raw_.insert(raw_.end(), buf, buf + size);
+    raw_.resize(raw_.size() +
+                PaddingBytes(raw_.size(), FLATBUFFERS_MAX_ALIGNMENT));
+    num_records_++;
+    if (++block_records_ == records_per_block_) return FlushBlock();
+    return true;
+  }
+
+  // Appends the buffer `fbb` was finished with, using FinishSizePrefixed().
+  bool Append(const FlatBufferBuilder &fbb) {
+    return Append(fbb.GetBufferPointer(), fbb.GetSize());
+  }
+
+  // Writes out the last block, and the stream's index.
+  bool Finish() {
+    if (!ok_ || !FlushBlock()) return false;
+    ok_ = false;
+    return stream_.Finish();
+  }
+
+  // The number of records added.
+  size_t size() const { return num_records_; }
+
+  // The number of bytes written so far.
+  uint64_t bytes() const { return stream_.bytes(); }
+
+ private:
+  FLATBUFFERS_DELETE_FUNC(
+      CompressedStreamWriter(const CompressedStreamWriter &))
+  FLATBUFFERS_DELETE_FUNC(
+      CompressedStreamWriter &operator=(const CompressedStreamWriter &))
+
+  bool FlushBlock() {
+    if (!block_records_) return true;
+    block_.assign(kCompressedBlockHeaderSize, 0);
+    auto id = codec_.id();
+    if (!codec_.Compress(raw_.data(), raw_.size(), &block_)) {
+      ok_ = false;
+      return false;
+    }
+    if (block_.size() - kCompressedBlockHeaderSize >= raw_.size()) {
+      // Not worth it: store the block as is.
+      id = 0;
+      block_.resize(kCompressedBlockHeaderSize);
+      block_.insert(block_.end(), raw_.begin(), raw_.end());
+    }
+    WriteScalar(&block_[0],
+                static_cast<uoffset_t>(block_.size() - sizeof(uoffset_t)));
+    WriteScalar(&block_[4], id);
+    WriteScalar(&block_[8], static_cast<uint32_t>(raw_.size()));
+    WriteScalar(&block_[12], block_records_);
+    raw_.clear();
+    block_records_ = 0;
+    ok_ = stream_.Append(block_.data(), block_.size());
+    return ok_;
+  }
+
+  StreamWriter stream_;
+  BlockCodec &codec_;
+  uint32_t records_per_block_;
+  size_t num_records_;
+  uint32_t block_records_;  // In the current block.
+  bool ok_;
+  std::vector<uint8_t> raw_;    // The current block, uncompressed.
+  std::vector<uint8_t> block_;  // The current block, compressed.
+};
+
+// Reads a compressed stream. The last block read is kept decompressed, so
+// reading the records of a block one after the other only decompresses it
+// once.
+class CompressedStreamReader {
+ public:
+  // `codec` (not owned) must be the one, or one compatible with the one, the
+  // stream was written with. Records are copied into memory from `allocator`
+  // (by default per-thread pools of power of 2 size classes, where
+  // available, so that memory is reused).
+  explicit CompressedStreamReader(BlockCodec &codec,
+                                  Allocator *allocator = nullptr)
+      : codec_(codec),
+        allocator_(allocator ? allocator : DefaultRecordAllocator()),
+        records_per_block_(1),
+        num_records_(0),
+        block_index_(0),
+        block_valid_(false) {}
+
+  // Reads the stream of the `size` bytes at `data`, which must stay valid
+  // while it is read. Returns false if it isn't a compressed stream.
+  bool Open(const uint8_t *data, size_t size) {
+    return stream_.Open(data, size) && ReadBlockCount();
+  }
+
+  // Maps the file "name" and reads it as above.
+  bool Open(const char *name) {
+    return stream_.Open(name) && ReadBlockCount();
+  }
+
+  // The number of records.
+  size_t size() const { return num_records_; }
+
+  // The number of blocks.
+  size_t num_blocks() const { return stream_.size(); }
+
+  // Record `i` as a size-prefixed FlatBuffer in memory of its own, or an
+  // empty buffer if `i` is out of range or its block can't be decompressed.
+  DetachedBuffer Record(size_t i) {
+    size_t size;
+    auto record = RecordPointer(i, &size);
+    if (!record) return DetachedBuffer();
+    auto buf = allocator_->allocate(size);
+    memcpy(buf, record, size);
+    return DetachedBuffer(allocator_, false, buf, size, buf, size);
+  }
+
+  // Record `i` as a size-prefixed FlatBuffer, and its size including the
+  // prefix in `*size` if given, without copying it. It stays valid until a
+  // record from another block is read.
+  const uint8_t *RecordPointer(size_t i, size_t *size = nullptr) {
+    if (i >= num_records_ || !LoadBlock(i / records_per_block_))
+      return nullptr;
+    size_t pos = 0;
+    for (size_t n = i % records_per_block_;; n--) {
+      if (pos + sizeof(uoffset_t) > block_.size()) return nullptr;
+      size_t record_size =
+          ReadScalar<uoffset_t>(block_.data() + pos) + sizeof(uoffset_t);
+      if (record_size > block_.size() - pos) return nullptr;
+      if (!n) {
+        if (size) *size = record_size;
+        return block_.data() + pos;
+      }
+      pos += record_size;
+      pos += PaddingBytes(pos, FLATBUFFERS_MAX_ALIGNMENT);
+    }
+  }
+
+  // The root of record `i`, valid as long as RecordPointer()'s is.
+  template<typename T> const T *GetRoot(size_t i) {
+    auto record = RecordPointer(i);
+    return record ? GetSizePrefixedRoot<T>(record) : nullptr;
+  }
+
+  template<typename T> bool VerifyRecord(size_t i) {
+    size_t size;
+    auto record = RecordPointer(i, &size);
+    if (!record) return false;
+    Verifier verifier(record, size);
+    return verifier.VerifySizePrefixedBuffer<T>(nullptr);
+  }
+
+ private:
+  FLATBUFFERS_DELETE_FUNC(
+      CompressedStreamReader(const CompressedStreamReader &))
+  FLATBUFFERS_DELETE_FUNC(
+      CompressedStreamReader &operator=(const CompressedStreamReader &))
+
+  static Allocator *DefaultRecordAllocator() {
+    // clang-format off
+    #ifdef FLATBUFFERS_THREAD_LOCAL
+      return &PoolAllocator::instance();
+    #else
+      return &DefaultAllocator::instance();
+    #endif
+    // clang-format on
+  }
+
+  // Every block but the last has the same number of records.
+  bool ReadBlockCount() {
+    block_valid_ = false;
+    num_records_ = 0;
+    if (!stream_.size()) return true;
+    uint32_t first_count, last_count;
+    if (!BlockCount(0, &first_count) ||
+        !BlockCount(stream_.size() - 1, &last_count))
+      return false;
+    records_per_block_ = first_count;
+    num_records_ = (stream_.size() - 1) * first_count + last_count;
+    return true;
+  }
+
+  bool BlockCount(size_t b, uint32_t *count) const {
+    size_t size;
+    auto block = stream_.Record(b, &size);
+    if (!block || size < kCompressedBlockHeaderSize) return false;
+    *count = ReadScalar<uint32_t>(block + 12);
+    return *count > 0;
+  }
+
+  bool LoadBlock(size_t b) {
+    if (block_valid_ && block_index_ == b) return true;
+    block_valid_ = false;
+    size_t size;
+    auto block = stream_.Record(b, &size);
+    if (!block || size < kCompressedBlockHeaderSize) return false;
+    auto id = ReadScalar<uint32_t>(block + 4);
+    auto raw_size = ReadScalar<uint32_t>(block + 8);
+    auto data = block + kCompressedBlockHeaderSize;
+    auto data_size = size - kCompressedBlockHeaderSize;
+    // Check the size against the data before trusting it with an allocation.
+    if (id == 0 ? data_size != raw_size
+                : id != codec_.id() || raw_size > codec_.MaxRawSize(data_size))
+      return false;
+    block_.resize(raw_size);
+    if (id == 0) {
+      memcpy(block_.data(), data, raw_size);
+    } else if (!codec_.Decompress(data, data_size, block_.data(), raw_size)) {
+      return false;
+    }
+    block_index_ = b;
+    block_valid_ = true;
+    return true;
+  }
+
+  StreamReader stream_;
+  BlockCodec &codec_;
+  Allocator *allocator_;
+  size_t records_per_block_;
+  size_t num_records_;
+  std::vector<uint8_t> block_;  // Block `block_index_`, decompressed.
+  size_t block_index_;
+  bool block_valid_;
+};
+
+}  // namespace flatbuffers
+
+#endif  // FLATBUFFERS_COMPRESSED_STREAM_H_
@@ -19,6 +19,16 @@
 
 #include "flatbuffers/base.h"
 
+// clang-format off
+#ifdef FLATBUFFERS_VERIFIER_STATS
+  #include <chrono>
+  #if defined(__GXX_RTTI) || defined(_CPPRTTI) || defined(__cpp_rtti)
+    #include <typeinfo>
+    #define FLATBUFFERS_HAS_RTTI
+  #endif
+#endif
+// clang-format on
+
 namespace flatbuffers {
 // Wrapper for uoffset_t to allow safe template specialization.
 // Value is allowed to be 0 to indicate a null object (see e.g. AddOffset).
@@ -176,6 +186,52 @@ template<typename T, typename IT> struct VectorIterator {
 
 struct String;
 
+// The first 32 bits of a key, in an order-preserving encoding: if a < b, then
+// KeyPrefix(a) <= KeyPrefix(b). Used for key indices, see
+// FlatBufferBuilder::CreateKeyIndex().
+inline uint32_t KeyPrefix(const char *key) {
+  // The first 4 characters, big endian, the way strcmp() compares them.
+  uint32_t prefix = 0;
+  for (int i = 0; i < 4; i++) {
+    prefix <<= 8;
+    if (*key) prefix |= static_cast<uint8_t>(*key++);
+  }
+  return prefix;
+}
+
+template<typename T> uint32_t KeyPrefix(T key) {
+  static_assert(flatbuffers::is_scalar<T>::value,
+                "keys are scalars or strings");
+  uint64_t bits;
+  if (flatbuffers::is_floating_point<T>::value) {
+    // Order IEEE doubles like unsigned integers: flip all bits of negative
+    // numbers, and just the sign bit of positive ones. -0.0 == 0.0.
+    double d = static_cast<double>(key);
+    if (d == 0) d = 0;
+    memcpy(&bits, &d, sizeof(bits));
+    bits = bits >> 63 ? ~bits : bits | (1ULL << 63);
+  } else {
+    // Offset signed types so their minimum is 0, then left align them so
+    // the prefix holds the top bits. This also works for (scoped) enums.
+    bits = static_cast<uint64_t>(key);
+    if (static_cast<T>(-1) < static_cast<T>(0))
+      bits += 1ULL << (sizeof(T) * 8 - 1);
+    bits <<= 64 - sizeof(T) * 8;
+  }
+  return static_cast<uint32_t>(bits >> 32);
+}
+
+// The type of the key of a generated table or struct T, as taken by its
+// KeyCompareWithValue(). Keys are converted to it before computing their
+// prefix (or hash), which depend on the type.
+template<typename F> struct KeyCompareArg;
+template<typename C, typename A> struct KeyCompareArg<int (C::*)(A) const> {
+  typedef A type;
+};
+template<typename T> struct KeyType {
+  typedef typename KeyCompareArg<decltype(&T::KeyCompareWithValue)>::type type;
+};
+
 // This is used as a helper type for accessing vectors.
 // Vector::data() assumes the vector elements start after the length field.
 template<typename T> class Vector {
@@ -263,17 +319,79 @@ template<typename T> class Vector {
   const T *data() const { return reinterpret_cast<const T *>(Data()); }
   T *data() { return reinterpret_cast<T *>(Data()); }
 
+  // Find an element by its key in a vector of tables (or structs) sorted by
+  // key, e.g. created with FlatBufferBuilder::CreateVectorOfSortedTables().
+  // Returns nullptr if it isn't there.
   template<typename K> return_type LookupByKey(K key) const {
-    void *search_result = std::bsearch(
-        &key, Data(), size(), IndirectHelper<T>::element_stride, KeyCompare<K>);
-
-    if (!search_result) {
-      return nullptr;  // Key not found.
+    auto n = size();
+    if (!n) return nullptr;
+    // Branchless binary search: narrow down to the last element less than
+    // key, or the first element if there is none, with at most one
+    // (predictable) branch per step.
+    auto base = Data();
+    while (n > 1) {
+      auto half = n / 2;
+      auto middle = IndirectHelper<T>::Read(base, half);
+      base += middle->KeyCompareWithValue(key) < 0
+                  ? half * IndirectHelper<T>::element_stride
+                  : 0;
+      n -= half;
     }
-
-    const uint8_t *element = reinterpret_cast<const uint8_t *>(search_result);
-
-    return IndirectHelper<T>::Read(element, 0);
+    auto element = IndirectHelper<T>::Read(base, 0);
+    auto comp = element->KeyCompareWithValue(key);
+    if (!comp) return element;
+    if (comp > 0) return nullptr;
+    base += IndirectHelper<T>::element_stride;
+    if (base == Data() + size() * IndirectHelper<T>::element_stride)
+      return nullptr;
+    element = IndirectHelper<T>::Read(base, 0);
+    return element->KeyCompareWithValue(key) ? nullptr : element;
+  }
+
+  // Like LookupByKey(key), with an index made by
+  // FlatBufferBuilder::CreateKeyIndex(). The index holds a prefix of each key
+  // next to each other, so the search only has to look at (and chase offsets
+  // to) elements whose key starts like the one searched for. Without a (valid)
+  // index, this is the same as LookupByKey(key).
+  template<typename K>
+  return_type LookupByKey(K key, const Vector<uint32_t> *index) const {
+    if (!index || index->size() != size()) return LookupByKey(key);
+    auto n = size();
+    if (!n) return nullptr;
+    typedef typename std::remove_pointer<return_type>::type element_type;
+    auto prefix =
+        KeyPrefix(static_cast<typename KeyType<element_type>::type>(key));
+    auto prefixes = index->data();
+    // Lower bound of the prefix, as above.
+    auto base = prefixes;
+    while (n > 1) {
+      auto half = n / 2;
+      base += EndianScalar(base[half]) < prefix ? half : 0;
+      n -= half;
+    }
+    auto lo = static_cast<uoffset_t>(base - prefixes);
+    lo += EndianScalar(*base) < prefix;
+    // Many keys may start alike, so find the end of the equal prefixes in the
+    // index as well, then binary search them by the full key.
+    auto hi = size();
+    for (auto first = lo; first < hi;) {
+      auto middle = first + (hi - first) / 2;
+      if (EndianScalar(prefixes[middle]) > prefix)
+        hi = middle;
+      else
+        first = middle + 1;
+    }
+    while (lo < hi) {
+      auto middle = lo + (hi - lo) / 2;
+      auto element = IndirectHelper<T>::Read(Data(), middle);
+      auto comp = element->KeyCompareWithValue(key);
+      if (!comp) return element;
+      if (comp < 0)
+        lo = middle + 1;
+      else
+        hi = middle;
+    }
+    return nullptr;
   }
 
  protected:
@@ -287,16 +405,6 @@ template<typename T> class Vector {
   // This class is a pointer. Copying will therefore create an invalid object.
   // Private and unimplemented copy constructor.
   Vector(const Vector &);
-
-  template<typename K> static int KeyCompare(const void *ap, const void *bp) {
-    const K *key = reinterpret_cast<const K *>(ap);
-    const uint8_t *data = reinterpret_cast<const uint8_t *>(bp);
-    auto table = IndirectHelper<T>::Read(data, 0);
-
-    // std::bsearch compares with the operands transposed, so we negate the
-    // result here.
-    return -table->KeyCompareWithValue(*key);
-  }
 };
 
 // Represent a vector much like the template above, but in this case we
@@ -319,6 +427,114 @@ class VectorOfAny {
   VectorOfAny(const VectorOfAny &);
 };
 
+// Iterates over a vector of tables like Vector::const_iterator, but issues
+// prefetches for the table `distance` elements ahead of the current one. On
+// cold data this hides most of the latency of following each offset. Use it
+// through PrefetchingRange.
+template<typename T> class PrefetchingIterator {
+ public:
+  typedef std::forward_iterator_tag iterator_category;
+  typedef const T *value_type;
+  typedef ptrdiff_t difference_type;
+  typedef const T **pointer;
+  typedef const T *reference;  // operator* returns by value.
+
+  PrefetchingIterator(const uint8_t *data, const uint8_t *end,
+                      uoffset_t distance)
+      : data_(data), end_(end), distance_(distance) {
+    // The first table is read right away, so prefetching it is no use.
+    for (uoffset_t i = 1; i <= distance_; i++) PrefetchTable(i);
+  }
+
+  bool operator==(const PrefetchingIterator &other) const {
+    return data_ == other.data_;
+  }
+
+  bool operator!=(const PrefetchingIterator &other) const {
+    return data_ != other.data_;
+  }
+
+  const T *operator*() const {
+    return IndirectHelper<Offset<T>>::Read(data_, 0);
+  }
+
+  const T *operator->() const {
+    return IndirectHelper<Offset<T>>::Read(data_, 0);
+  }
+
+  PrefetchingIterator &operator++() {
+    data_ += sizeof(uoffset_t);
+    if (distance_) PrefetchTable(distance_);
+    return *this;
+  }
+
+  PrefetchingIterator operator++(int) {
+    PrefetchingIterator temp(*this);
+    ++*this;
+    return temp;
+  }
+
+ private:
+  // The offset slots themselves are read sequentially, which the hardware
+  // prefetcher takes care of.
+  const uint8_t *Slot(uoffset_t ahead) const {
+    return static_cast<size_t>(end_ - data_) / sizeof(uoffset_t) > ahead
+               ? data_ + ahead * sizeof(uoffset_t)
+               : nullptr;
+  }
+
+  // Finding a table's vtable would take reading the table, which is what is
+  // being waited for. But the builder writes a vtable right below the table
+  // it is first used for (and later tables use it too, so it is likely
+  // cached by then), so the line below the table is prefetched instead.
+  // There is always something below a table, at least the root offset.
+  void PrefetchTable(uoffset_t ahead) const {
+    auto slot = Slot(ahead);
+    if (!slot) return;
+    auto table = slot + ReadScalar<uoffset_t>(slot);
+    FLATBUFFERS_PREFETCH(table);
+    FLATBUFFERS_PREFETCH(table - 1);
+  }
+
+  const uint8_t *data_;
+  const uint8_t *end_;
+  uoffset_t distance_;
+};
+
+// A range over a vector of tables for use with range-based for loops, that
+// prefetches ahead (see PrefetchingIterator). A null vector is an empty range,
+// so accessors for absent fields can be passed in directly:
+//
+//   for (auto monster : PrefetchingRange<Monster>(root->monsters())) ...
+//
+// The best `distance` depends on how much work is done per table: it should
+// cover the time of a cache miss. 0 turns prefetching off.
+template<typename T> class PrefetchingRange {
+ public:
+  typedef PrefetchingIterator<T> iterator;
+  typedef PrefetchingIterator<T> const_iterator;
+
+  static const uoffset_t kDefaultDistance = 8;
+
+  explicit PrefetchingRange(const Vector<Offset<T>> *vec,
+                            uoffset_t distance = kDefaultDistance)
+      : begin_(vec ? vec->Data() : nullptr),
+        end_(vec ? vec->Data() + vec->size() * sizeof(uoffset_t) : nullptr),
+        distance_(distance) {}
+
+  iterator begin() const { return iterator(begin_, end_, distance_); }
+  iterator end() const { return iterator(end_, end_, 0); }
+
+  uoffset_t size() const {
+    return static_cast<uoffset_t>((end_ - begin_) / sizeof(uoffset_t));
+  }
+
+ private:
+  const uint8_t *begin_;
+  const uint8_t *end_;
+  uoffset_t distance_;
+};
+
 #ifndef FLATBUFFERS_CPP98_STL
 template<typename T, typename U>
 Vector<Offset<T>> *VectorCast(Vector<Offset<U>> *ptr) {
@@ -348,6 +564,8 @@ struct String : public Vector<char> {
   }
 };
 
+inline uint32_t KeyPrefix(const String *key) { return KeyPrefix(key->c_str()); }
+
 // Allocator interface. This is flatbuffers-specific and meant only for
 // `vector_downward` usage.
 class Allocator {
@@ -407,6 +625,279 @@ class DefaultAllocator : public Allocator {
   }
 };
 
+// ArenaAllocator hands out memory from large blocks, carving allocations from
+// the top of a block downwards. Since `vector_downward` also grows towards
+// lower addresses, growing the most recent allocation is done in place
+// whenever the block has room: only the scratchpad at the front is moved, the
+// data at the back stays where it is.
+// Memory is only returned to the arena when the most recent allocation is
+// deallocated, or all at once with `Reset()`. The arena must outlive any
+// builder or `DetachedBuffer` using it.
+class ArenaAllocator : public Allocator {
+ public:
+  // Allocates blocks of (at least) `block_size` bytes as needed.
+  explicit ArenaAllocator(size_t block_size = 16384)
+      : block_size_(block_size),
+        begin_(nullptr),
+        cur_(nullptr),
+        initial_(nullptr),
+        initial_size_(0) {}
+
+  // Uses `initial_size` bytes at `initial_block` (not owned) before falling
+  // back to allocating blocks of `block_size`.
+  ArenaAllocator(uint8_t *initial_block, size_t initial_size,
+                 size_t block_size = 16384)
+      : block_size_(block_size),
+        begin_(initial_block),
+        cur_(initial_block + initial_size),
+        initial_(initial_block),
+        initial_size_(initial_size) {}
+
+  virtual ~ArenaAllocator() { ReleaseBlocks(0); }
+
+  virtual uint8_t *allocate(size_t size) FLATBUFFERS_OVERRIDE {
+    if (!Fits(size)) NewBlock(size);
+    cur_ = AlignDown(cur_ - size);
+    return cur_;
+  }
+
+  virtual void deallocate(uint8_t *p, size_t size) FLATBUFFERS_OVERRIDE {
+    // Only the most recent allocation can be handed back.
+    if (p == cur_) cur_ = p + size;
+  }
+
+  virtual uint8_t *reallocate_downward(uint8_t *old_p, size_t old_size,
+                                       size_t new_size, size_t in_use_back,
+                                       size_t in_use_front)
+      FLATBUFFERS_OVERRIDE {
+    assert(new_size > old_size);  // vector_downward only grows
+    auto grow = new_size - old_size;
+    if (old_p == cur_ && static_cast<size_t>(cur_ - begin_) >= grow) {
+      cur_ -= grow;
+      memmove(cur_, old_p, in_use_front);
+      return cur_;
+    }
+    return Allocator::reallocate_downward(old_p, old_size, new_size,
+                                          in_use_back, in_use_front);
+  }
+
+  // Makes all memory available for reuse, invalidating everything that was
+  // allocated from this arena. Only the largest block is kept.
+  void Reset() {
+    if (blocks_.empty()) {
+      begin_ = initial_;
+      cur_ = initial_ + initial_size_;
+    } else {
+      ReleaseBlocks(1);
+      cur_ = begin_ + blocks_[0].size;
+    }
+  }
+
+  // Total bytes of memory held by this arena.
+  size_t capacity() const {
+    size_t total = initial_size_;
+    for (auto it = blocks_.begin(); it != blocks_.end(); ++it)
+      total += it->size;
+    return total;
+  }
+
+ private:
+  struct Block {
+    uint8_t *data;
+    size_t size;
+  };
+
+  static uint8_t *AlignDown(uint8_t *p) {
+    return reinterpret_cast<uint8_t *>(reinterpret_cast<uintptr_t>(p) &
+                                       ~(FLATBUFFERS_MAX_ALIGNMENT - 1));
+  }
+
+  bool Fits(size_t size) const {
+    return cur_ && static_cast<size_t>(cur_ - begin_) >= size &&
+           AlignDown(cur_ - size) >= begin_;
+  }
+
+  void NewBlock(size_t size) {
+    // Grow geometrically, so the number of blocks stays logarithmic.
+    auto block_size = (std::max)(size + FLATBUFFERS_MAX_ALIGNMENT,
+                                 blocks_.empty() ? block_size_
+                                                 : blocks_.back().size * 2);
+    Block block = { new uint8_t[block_size], block_size };
+    blocks_.push_back(block);
+    begin_ = block.data;
+    cur_ = block.data + block.size;
+  }
+
+  // Frees all blocks except for the `keep` largest (which are the last ones),
+  // which are moved to the front of `blocks_`.
+  void ReleaseBlocks(size_t keep) {
+    keep = (std::min)(keep, blocks_.size());
+    auto first_kept = blocks_.size() - keep;
+    for (size_t i = 0; i < first_kept; i++) delete[] blocks_[i].data;
+    blocks_.erase(blocks_.begin(),
+                  blocks_.begin() + static_cast<ptrdiff_t>(first_kept));
+    if (!blocks_.empty()) begin_ = blocks_.back().data;
+  }
+
+  size_t block_size_;
+  std::vector<Block> blocks_;  // Owned, in order of allocation.
+  uint8_t *begin_;             // Start of the current block.
+  uint8_t *cur_;               // Lowest address handed out in current block.
+  uint8_t *initial_;           // Not owned.
+  size_t initial_size_;
+
+  FLATBUFFERS_DELETE_FUNC(ArenaAllocator(const ArenaAllocator &))
+  FLATBUFFERS_DELETE_FUNC(ArenaAllocator &operator=(const ArenaAllocator &))
+};
+
+// clang-format off
+#ifdef FLATBUFFERS_THREAD_LOCAL
+// clang-format on
+// PoolAllocator rounds allocations up to power of 2 size classes, and keeps
+// freed memory in a per-thread cache for each class, so a thread repeatedly
+// building buffers of similar sizes rarely needs to go to the heap.
+// Growing within the size class of the current allocation is done in place.
+// Memory may be freed on a different thread than it was allocated on.
+class PoolAllocator : public Allocator {
+ public:
+  // Smallest and largest size classes. Larger allocations bypass the pool.
+  static const size_t kMinSizeClass = 256;
+  static const size_t kMaxSizeClass = 1 << 22;
+
+  // `max_cached` is the number of free allocations kept per size class, per
+  // thread.
+  explicit PoolAllocator(size_t max_cached = 8) : max_cached_(max_cached) {}
+
+  virtual uint8_t *allocate(size_t size) FLATBUFFERS_OVERRIDE {
+    auto size_class = SizeClass(size);
+    if (size_class > kMaxSizeClass) return new uint8_t[size];
+    auto &cached = Cache().lists[SizeClassIndex(size_class)];
+    if (cached.empty()) return new uint8_t[size_class];
+    auto p = cached.back();
+    cached.pop_back();
+    return p;
+  }
+
+  virtual void deallocate(uint8_t *p, size_t size) FLATBUFFERS_OVERRIDE {
+    auto size_class = SizeClass(size);
+    if (size_class <= kMaxSizeClass) {
+      auto &cached = Cache().lists[SizeClassIndex(size_class)];
+      if (cached.size() < max_cached_) {
+        cached.push_back(p);
+        return;
+      }
+    }
+    delete[] p;
+  }
+
+  virtual uint8_t *reallocate_downward(uint8_t *old_p, size_t old_size,
+                                       size_t new_size, size_t in_use_back,
+                                       size_t in_use_front)
+      FLATBUFFERS_OVERRIDE {
+    assert(new_size > old_size);  // vector_downward only grows
+    if (SizeClass(old_size) <= kMaxSizeClass &&
+        SizeClass(new_size) == SizeClass(old_size)) {
+      // Still fits: only the data at the back needs to move up.
+      memmove(old_p + new_size - in_use_back, old_p + old_size - in_use_back,
+              in_use_back);
+      return old_p;
+    }
+    return Allocator::reallocate_downward(old_p, old_size, new_size,
+                                          in_use_back, in_use_front);
+  }
+
+  // Frees all memory cached for the calling thread.
+  static void Trim() { Cache().Trim(); }
+
+  static PoolAllocator &instance() {
+    static PoolAllocator inst;
+    return inst;
+  }
+
+ private:
+  static const size_t kNumSizeClasses = 15;  // kMinSizeClass..kMaxSizeClass
+
+  struct ThreadCache {
+    std::vector<uint8_t *> lists[kNumSizeClasses];
+    ~ThreadCache() { Trim(); }
+    void Trim() {
+      for (size_t i = 0; i < kNumSizeClasses; i++) {
+        for (auto it = lists[i].begin(); it != lists[i].end(); ++it)
+          delete[] *it;
+        lists[i].clear();
+      }
+    }
+  };
+
+  static ThreadCache &Cache() {
+    static FLATBUFFERS_THREAD_LOCAL ThreadCache cache;
+    return cache;
+  }
+
+  static size_t SizeClass(size_t size) {
+    size_t size_class = kMinSizeClass;
+    while (size_class < size) size_class <<= 1;
+    return size_class;
+  }
+
+  static size_t SizeClassIndex(size_t size_class) {
+    size_t index = 0;
+    while ((kMinSizeClass << index) < size_class) index++;
+    return index;
+  }
+
+  size_t max_cached_;
+};
+// clang-format off
+#endif  // FLATBUFFERS_THREAD_LOCAL
+// clang-format on
+
+// Adapts an Allocator for use by standard containers, e.g.
+// std::vector<T, AllocatorAdapter<T>>. A null allocator means the
+// DefaultAllocator. The allocator must outlive the containers using it.
+template<typename T> class AllocatorAdapter {
+ public:
+  typedef T value_type;
+  typedef T *pointer;
+  typedef const T *const_pointer;
+  typedef T &reference;
+  typedef const T &const_reference;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+  template<typename U> struct rebind { typedef AllocatorAdapter<U> other; };
+
+  explicit AllocatorAdapter(Allocator *allocator = nullptr)
+      : allocator_(allocator ? allocator : &DefaultAllocator::instance()) {}
+  template<typename U>
+  AllocatorAdapter(const AllocatorAdapter<U> &other)
+      : allocator_(other.allocator()) {}
+
+  T *allocate(size_t n, const void * = nullptr) {
+    return reinterpret_cast<T *>(allocator_->allocate(n * sizeof(T)));
+  }
+  void deallocate(T *p, size_t n) {
+    allocator_->deallocate(reinterpret_cast<uint8_t *>(p), n * sizeof(T));
+  }
+
+  void construct(T *p, const T &value) { new (p) T(value); }
+  void destroy(T *p) { p->~T(); }
+  size_t max_size() const { return FLATBUFFERS_MAX_BUFFER_SIZE / sizeof(T); }
+  T *address(T &value) const { return &value; }
+  const T *address(const T &value) const { return &value; }
+
+  Allocator *allocator() const { return allocator_; }
+
+  template<typename U> bool operator==(const AllocatorAdapter<U> &o) const {
+    return allocator_ == o.allocator();
+  }
+  template<typename U> bool operator!=(const AllocatorAdapter<U> &o) const {
+    return allocator_ != o.allocator();
+  }
+
+ private:
+  Allocator *allocator_;
+};
+
 // DetachedBuffer is a finished flatbuffer memory region, detached from its
 // builder. The original memory region and allocator are also stored so that
 // the DetachedBuffer can manage the memory lifetime.
@@ -517,12 +1008,100 @@ class DetachedBuffer {
   }
 };
 
+// A contiguous part of a buffer that was built in segments, see
+// FlatBufferBuilder::BuildInSegments(). Mirrors the layout of POSIX
+// `struct iovec`.
+struct BufferSegment {
+  const uint8_t *data;
+  size_t size;
+};
+
+// Somewhere to write finished buffers to, such as a file or socket, see
+// FlatBufferBuilder::WriteTo(). See FileDescriptorSink in util.h.
+class Sink {
+ public:
+  virtual ~Sink() {}
+
+  // Write all `size` bytes at `data`, or return false on error.
+  virtual bool Write(const uint8_t *data, size_t size) = 0;
+};
+
+// Sink that passes data on to another sink only in whole blocks of
+// `block_size` bytes, from memory aligned to `block_size`, as needed for
+// writing to files opened with O_DIRECT. Bytes that don't fill a block are
+// held until more data arrives, so several buffers can be written in a row;
+// call Flush() after the last one.
+class BlockAlignedSink : public Sink {
+ public:
+  // `block_size` must be a power of 2. Data is passed on `blocks_per_write`
+  // blocks at a time.
+  explicit BlockAlignedSink(Sink &out, size_t block_size = 4096,
+                            size_t blocks_per_write = 16)
+      : out_(out),
+        block_size_(block_size),
+        capacity_(block_size * blocks_per_write),
+        used_(0) {
+    assert(block_size && !(block_size & (block_size - 1)) && blocks_per_write);
+    alloc_ = new uint8_t[capacity_ + block_size_];
+    auto misalign = reinterpret_cast<size_t>(alloc_) & (block_size_ - 1);
+    buf_ = misalign ? alloc_ + block_size_ - misalign : alloc_;
+  }
+
+  // Bytes not flushed yet are lost.
+  ~BlockAlignedSink() { delete[] alloc_; }
+
+  bool Write(const uint8_t *data, size_t size) FLATBUFFERS_OVERRIDE {
+    while (size) {
+      auto n = (std::min)(size, capacity_ - used_);
+      memcpy(buf_ + used_, data, n);
+      used_ += n;
+      data += n;
+      size -= n;
+      if (used_ == capacity_) {
+        if (!out_.Write(buf_, capacity_)) return false;
+        used_ = 0;
+      }
+    }
+    return true;
+  }
+
+  // Pass on any bytes held back, padded with zeros to a whole block. The
+  // number of padding bytes is stored in `padding` if given, e.g. to
+  // truncate the file afterwards.
+  bool Flush(size_t *padding = nullptr) {
+    auto pad = PaddingBytes(used_, block_size_);
+    memset(buf_ + used_, 0, pad);
+    if (padding) *padding = pad;
+    auto size = used_ + pad;
+    used_ = 0;
+    return !size || out_.Write(buf_, size);
+  }
+
+  // The number of bytes held back, waiting for a block to fill up.
+  size_t pending() const { return used_; }
+
+ private:
+  FLATBUFFERS_DELETE_FUNC(BlockAlignedSink(const BlockAlignedSink &))
+  FLATBUFFERS_DELETE_FUNC(BlockAlignedSink &operator=(const BlockAlignedSink &))
+
+  Sink &out_;
+  size_t block_size_;
+  size_t capacity_;
+  size_t used_;
+  uint8_t *alloc_;
+  uint8_t *buf_;
+};
+
 // This is a minimal replication of std::vector<uint8_t> functionality,
 // except growing from higher to lower addresses. i.e push_back() inserts data
 // in the lowest address in the vector.
 // Since this vector leaves the lower part unused, we support a "scratch-pad"
 // that can be stored there for temporary data, to share the allocated space.
 // Essentially, this supports 2 std::vectors in a single buffer.
+// Optionally, the vector can be kept in segments instead (see
+// set_segment_size()): when the current allocation is full, a new one is
+// started and only the scratch-pad is moved to it. Data already written never
+// moves, but is then only contiguous within each single push/make_space.
 class vector_downward {
  public:
   explicit vector_downward(size_t initial_size,
@@ -533,17 +1112,25 @@ class vector_downward {
         own_allocator_(own_allocator),
         initial_size_(initial_size),
         buffer_minalign_(buffer_minalign),
+        reserve_(0),
         reserved_(0),
         buf_(nullptr),
         cur_(nullptr),
-        scratch_(nullptr) {
+        scratch_(nullptr),
+        num_reallocations_(0),
+        bytes_reallocated_(0),
+        segment_size_(0),
+        segment_skew_(0),
+        segments_size_(0) {
     assert(allocator_);
+    stats_ = nullptr;
   }
 
   ~vector_downward() {
+    free_segments();
     if (buf_) {
       assert(allocator_);
-      allocator_->deallocate(buf_, reserved_);
+      allocator_->deallocate(buf_, reserved_ + segment_skew_);
     }
     if (own_allocator_ && allocator_) { delete allocator_; }
   }
@@ -551,28 +1138,98 @@ class vector_downward {
   void reset() {
     if (buf_) {
       assert(allocator_);
-      allocator_->deallocate(buf_, reserved_);
+      allocator_->deallocate(buf_, reserved_ + segment_skew_);
       buf_ = nullptr;
     }
     clear();
   }
 
   void clear() {
+    free_segments();
     if (buf_) {
+      reserved_ += segment_skew_;
+      segment_skew_ = 0;
       cur_ = buf_ + reserved_;
     } else {
+      segment_skew_ = 0;
       reserved_ = 0;
       cur_ = nullptr;
     }
     clear_scratch();
+    num_reallocations_ = 0;
+    bytes_reallocated_ = 0;
+  }
+
+  // Make sure the next buffer can grow to `min_capacity` bytes without
+  // reallocating. Only call this when empty: if the current allocation is too
+  // small it is freed, and the next one will be made large enough.
+  void reserve(size_t min_capacity) {
+    assert(!size() && !scratch_size());
+    if (min_capacity <= reserved_) return;
+    if (buf_) {
+      assert(allocator_);
+      allocator_->deallocate(buf_, reserved_ + segment_skew_);
+      buf_ = nullptr;
+      clear();
+    }
+    reserve_ = min_capacity;
   }
 
   void clear_scratch() {
     scratch_ = buf_;
   }
 
+  // Keep the vector in allocations of (at least) `segment_size` bytes each,
+  // rather than reallocating, or 0 for a single contiguous allocation.
+  // Only call this when empty.
+  void set_segment_size(size_t segment_size) {
+    assert(!size() && !scratch_size());
+    segment_size_ = segment_size;
+  }
+
+  // Whether the data is in a single allocation, so data() points to all of it.
+  bool contiguous() const { return segments_.empty(); }
+
+  // Appends the contiguous parts of the data, in memory order (from data()
+  // onwards).
+  void segments(std::vector<BufferSegment> *out) const {
+    BufferSegment front = { cur_,
+                            static_cast<size_t>(buf_ + reserved_ - cur_) };
+    if (front.size) out->push_back(front);
+    for (auto it = segments_.rbegin(); it != segments_.rend(); ++it) {
+      BufferSegment seg = { it->data, it->size };
+      out->push_back(seg);
+    }
+  }
+
+  // Copies a segmented vector into a single allocation.
+  void flatten() {
+    if (contiguous()) return;
+    assert(allocator_);
+    auto total = static_cast<size_t>(size());
+    auto reserved =
+        (total + buffer_minalign_ - 1) & ~(buffer_minalign_ - 1);
+    auto buf = allocator_->allocate(reserved);
+    auto cur = buf + reserved - total;
+    std::vector<BufferSegment> parts;
+    segments(&parts);
+    auto dest = cur;
+    for (auto it = parts.begin(); it != parts.end(); ++it) {
+      memcpy(dest, it->data, it->size);
+      dest += it->size;
+    }
+    allocator_->deallocate(buf_, reserved_ + segment_skew_);
+    free_segments();
+    buf_ = buf;
+    reserved_ = reserved;
+    segment_skew_ = 0;
+    cur_ = cur;
+    scratch_ = buf_;
+  }
+
   // Relinquish the pointer to the caller.
   DetachedBuffer release() {
+    flatten();
     DetachedBuffer fb(allocator_, own_allocator_, buf_, reserved_, cur_,
                       size());
     allocator_ = nullptr;
@@ -599,7 +1256,7 @@ class vector_downward {
   Allocator &get_allocator() { return *allocator_; }
 
   uoffset_t size() const {
-    return static_cast<uoffset_t>(reserved_ - (cur_ - buf_));
+    return static_cast<uoffset_t>(segments_size_ + reserved_ - (cur_ - buf_));
   }
 
   uoffset_t scratch_size() const {
@@ -608,6 +1265,14 @@ class vector_downward {
 
   size_t capacity() const { return reserved_; }
 
+  // How often the buffer had to grow since the last clear(), not counting
+  // the initial allocation, and how many bytes in use had to be moved.
+  size_t num_reallocations() const { return num_reallocations_; }
+  size_t bytes_reallocated() const { return bytes_reallocated_; }
+
+  BuilderStats *stats() const { return stats_; }
+  void set_stats(BuilderStats *stats) { stats_ = stats; }
+
   uint8_t *data() const {
     assert(cur_);
     return cur_;
@@ -623,7 +1288,11 @@ class vector_downward {
     return scratch_;
   }
 
-  uint8_t *data_at(size_t offset) const { return buf_ + reserved_ - offset; }
+  uint8_t *data_at(size_t offset) const {
+    return offset > segments_size_ || segments_.empty()
+               ? buf_ + reserved_ + segments_size_ - offset
+               : segment_data_at(offset);
+  }
 
   void push(const uint8_t *bytes, size_t num) {
     memcpy(make_space(num), bytes, num);
@@ -641,6 +1310,13 @@ class vector_downward {
     scratch_ += sizeof(T);
   }
 
+  uint8_t *scratch_make_space(size_t len) {
+    ensure_space(len);
+    auto p = scratch_;
+    scratch_ += len;
+    return p;
+  }
+
   // fill() is most frequently called with small byte counts (<= 4),
   // which is why we're using loops rather than calling memset.
   void fill(size_t zero_pad_bytes) {
@@ -653,9 +1329,20 @@ class vector_downward {
     memset(make_space(zero_pad_bytes), 0, zero_pad_bytes);
   }
 
-  void pop(size_t bytes_to_remove) { cur_ += bytes_to_remove; }
+  void pop(size_t bytes_to_remove) {
+    // Can't pop beyond the start of the current segment.
+    assert(bytes_to_remove <= static_cast<size_t>(buf_ + reserved_ - cur_));
+    cur_ += bytes_to_remove;
+  }
   void scratch_pop(size_t bytes_to_remove) { scratch_ -= bytes_to_remove; }
 
+  // Adds `len` bytes at `data` to the vector without copying them: they
+  // become a segment of their own (see set_segment_size()), and must stay
+  // valid and unchanged until the vector is cleared or flattened.
+  void push_external(const uint8_t *data, size_t len) {
+    if (len) new_segment(0, data, len);
+  }
+
  private:
   // You shouldn't really be copying instances of this class.
   FLATBUFFERS_DELETE_FUNC(vector_downward(const vector_downward &))
@@ -665,30 +1352,171 @@ class vector_downward {
   bool own_allocator_;
   size_t initial_size_;
   size_t buffer_minalign_;
+  // Minimum size of the next initial allocation, see reserve().
+  size_t reserve_;
   size_t reserved_;
   uint8_t *buf_;
   uint8_t *cur_;  // Points at location between empty (below) and used (above).
   uint8_t *scratch_;  // Points to the end of the scratchpad in use.
+  size_t num_reallocations_;
+  size_t bytes_reallocated_;
+  BuilderStats *stats_;
+
+  // Allocations of previous segments, when segment_size_ is set. Each holds
+  // `size` bytes of data at `data`, at offset `offset` from the end of the
+  // vector. The first is the oldest, at the end of the vector.
+  struct Segment {
+    uint8_t *alloc;
+    size_t alloc_size;
+    uint8_t *data;
+    size_t size;
+    size_t offset;
+  };
+  size_t segment_size_;
+  std::vector<Segment> segments_;
+  // The end of the current allocation is moved down by this many bytes, for
+  // data in it to have the same alignment it would have in a contiguous
+  // buffer.
+  size_t segment_skew_;
+  size_t segments_size_;  // Sum of the sizes in segments_.
+
+  struct SegmentOffsetCompare {
+    bool operator()(size_t offset, const Segment &seg) const {
+      return offset <= seg.offset;
+    }
+  };
+
+  uint8_t *segment_data_at(size_t offset) const {
+    // Find the last segment starting before `offset`.
+    auto it = std::upper_bound(segments_.begin(), segments_.end(), offset,
+                               SegmentOffsetCompare());
+    assert(it != segments_.begin());
+    --it;
+    return it->data + it->size + it->offset - offset;
+  }
+
+  void free_segments() {
+    for (auto it = segments_.begin(); it != segments_.end(); ++it) {
+      if (it->alloc) allocator_->deallocate(it->alloc, it->alloc_size);
+    }
+    segments_.clear();
+    segments_size_ = 0;
+  }
+
+  // Starts a new allocation with room for at least `len` bytes, after
+  // optionally adding a segment of `external_size` bytes at `external`, which
+  // isn't owned.
+  void new_segment(size_t len, const uint8_t *external = nullptr,
+                   size_t external_size = 0) {
+    auto old_scratch_size = scratch_size();
+    auto old_reserved = reserved_;
+    uint8_t *old_buf = nullptr;
+    size_t old_alloc_size = 0;
+    if (buf_) {
+      // Data in the current allocation stays where it is.
+      Segment seg = { buf_, reserved_ + segment_skew_, cur_,
+                      static_cast<size_t>(buf_ + reserved_ - cur_),
+                      segments_size_ };
+      if (seg.size) {
+        segments_.push_back(seg);
+        segments_size_ += seg.size;
+      } else {
+        old_buf = seg.alloc;
+        old_alloc_size = seg.alloc_size;
+      }
+    }
+    if (external_size) {
+      Segment seg = { nullptr, 0, const_cast<uint8_t *>(external),
+                      external_size, segments_size_ };
+      segments_.push_back(seg);
+      segments_size_ += external_size;
+    }
+    segment_skew_ = segments_size_ & (buffer_minalign_ - 1);
+    // Without a segment size, the pieces around external segments are sized
+    // like the allocation before them.
+    auto alloc_size = (std::max)(
+        segment_size_ ? segment_size_ : (std::max)(initial_size_, old_reserved),
+        len + old_scratch_size + segment_skew_);
+    alloc_size = (alloc_size + buffer_minalign_ - 1) & ~(buffer_minalign_ - 1);
+    auto buf = allocator_->allocate(alloc_size);
+    if (buf_) {
+      memcpy(buf, buf_, old_scratch_size);
+      FLATBUFFERS_BUILDER_STAT(stats_, Reallocated(old_scratch_size));
+    }
+    if (old_buf) allocator_->deallocate(old_buf, old_alloc_size);
+    buf_ = buf;
+    reserved_ = alloc_size - segment_skew_;
+    cur_ = buf_ + reserved_;
+    scratch_ = buf_ + old_scratch_size;
+  }
 
   void reallocate(size_t len) {
     assert(allocator_);
+    if (segment_size_ || !segments_.empty()) {
+      new_segment(len);
+      return;
+    }
     auto old_reserved = reserved_;
     auto old_size = size();
     auto old_scratch_size = scratch_size();
-    reserved_ += (std::max)(len,
-                            old_reserved ? old_reserved / 2 : initial_size_);
+    reserved_ += (std::max)(len, old_reserved
+                                     ? old_reserved / 2
+                                     : (std::max)(initial_size_, reserve_));
     reserved_ = (reserved_ + buffer_minalign_ - 1) & ~(buffer_minalign_ - 1);
     if (buf_) {
       buf_ = allocator_->reallocate_downward(buf_, old_reserved, reserved_,
                                              old_size, old_scratch_size);
+      num_reallocations_++;
+      bytes_reallocated_ += old_size + old_scratch_size;
+      FLATBUFFERS_BUILDER_STAT(stats_,
+                               Reallocated(old_size + old_scratch_size));
     } else {
       buf_ = allocator_->allocate(reserved_);
+      reserve_ = 0;
     }
     cur_ = buf_ + reserved_ - old_size;
     scratch_ = buf_ + old_scratch_size;
   }
 };
 
+// Remembers how large the last few buffers finished by builders using it were,
+// so a builder starting on a new buffer can reserve enough memory up front
+// instead of growing (and copying) its buffer several times.
+// See FlatBufferBuilder::SetSizeHint(). Typically one is kept per root type.
+// This is not thread-safe, share it only between builders on the same thread.
+class BufferSizeHint {
+ public:
+  // Number of recent buffers the estimate is based on.
+  static const size_t kHistory = 8;
+
+  BufferSizeHint() : next_(0) { std::fill(sizes_, sizes_ + kHistory, 0); }
+
+  void Record(size_t size) {
+    sizes_[next_] = size;
+    next_ = (next_ + 1) % kHistory;
+  }
+
+  // The largest of the recently recorded sizes, or 0 if there are none.
+  size_t Estimate() const {
+    return *std::max_element(sizes_, sizes_ + kHistory);
+  }
+
+ private:
+  size_t sizes_[kHistory];
+  size_t next_;
+};
+
+// FNV-1a, used to hash vtables and strings while building.
+inline uint32_t HashBytes(const void *data, size_t len) {
+  auto bytes = reinterpret_cast<const uint8_t *>(data);
+  uint32_t hash = 0x811C9DC5;
+  for (auto end = bytes + len; bytes != end; ++bytes) {
+    hash ^= *bytes;
+    hash *= 0x01000193;
+  }
+  return hash;
+}
+
 // Converts a Field ID to a virtual table offset.
 inline voffset_t FieldIndexToOffset(voffset_t field_id) {
   // Should correspond to what EndTable() below builds up.
@@ -741,17 +1569,22 @@ class FlatBufferBuilder {
         minalign_(1),
         force_defaults_(false),
         dedup_vtables_(true),
+        vtable_index_threshold_(kDefaultVtableIndexThreshold),
+        vtable_index_(nullptr),
+        size_hint_(nullptr),
         string_pool(nullptr) {
     EndianCheck();
   }
 
   ~FlatBufferBuilder() {
+    if (vtable_index_) delete vtable_index_;
     if (string_pool) delete string_pool;
   }
 
   void Reset() {
     Clear();       // clear builder state
     buf_.reset();  // deallocate buffer
+    ReserveFromSizeHint();
   }
 
   /// @brief Reset all the state in this FlatBufferBuilder so it can be reused
@@ -762,21 +1595,98 @@ class FlatBufferBuilder {
     nested = false;
     finished = false;
     minalign_ = 1;
+    if (vtable_index_) vtable_index_->clear();
     if (string_pool) string_pool->clear();
+    ReserveFromSizeHint();
   }
 
   /// @brief The current size of the serialized buffer, counting from the end.
   /// @return Returns an `uoffset_t` with the current size of the buffer.
   uoffset_t GetSize() const { return buf_.size(); }
 
+  /// @brief The number of bytes currently allocated for the buffer, which
+  /// `Clear()` keeps around for the next buffer and `Reset()` releases.
+  size_t GetCapacity() const { return buf_.capacity(); }
+
+  /// @brief Use a `BufferSizeHint` to size this builder's buffer. The size of
+  /// every buffer finished from now on is recorded in it, and whenever the
+  /// builder is (re)started with `Clear()` or `Reset()` it reserves enough
+  /// memory for a buffer as large as the recent ones, plus some headroom.
+  /// @param[in] hint The hint to use, which may be shared by several
+  /// builders. It is not owned, and must outlive the builder. Pass `nullptr`
+  /// to stop using it.
+  void SetSizeHint(BufferSizeHint *hint) {
+    size_hint_ = hint;
+    if (!GetSize() && !buf_.scratch_size()) ReserveFromSizeHint();
+  }
+
+  /// @brief The number of times the buffer had to grow while building the
+  /// current buffer, not counting its initial allocation.
+  size_t GetReallocationCount() const { return buf_.num_reallocations(); }
+
+  /// @brief The number of bytes that had to be moved to a new allocation
+  /// while building the current buffer.
+  size_t GetReallocatedBytes() const { return buf_.bytes_reallocated(); }
+
+  /// @brief Count what this builder does in `stats` from now on: growing its
+  /// buffer, deduplicating vtables, sharing strings, padding and finishing
+  /// buffers. Only code compiled with FLATBUFFERS_BUILDER_STATS counts.
+  /// @param[in] stats The stats to add to, which may be shared by several
+  /// builders on the same thread. It is not owned, and must outlive the
+  /// builder. Pass `nullptr` to stop counting.
+  void SetStats(BuilderStats *stats) { buf_.set_stats(stats); }
+
   /// @brief Get the serialized buffer (after you call `Finish()`).
   /// @return Returns an `uint8_t` pointer to the FlatBuffer data inside the
   /// buffer.
   uint8_t *GetBufferPointer() const {
     Finished();
+    // If you get this assert, the buffer was built in segments, see
+    // GetBufferSegments().
+    assert(buf_.contiguous());
     return buf_.data();
   }
 
+  /// @brief Build buffers in segments of (at least) `segment_size` bytes
+  /// each, rather than in one allocation that is reallocated as it grows.
+  /// Bytes already written are never copied, which matters for very large
+  /// buffers. The finished buffer is then read with `GetBufferSegments()`,
+  /// or copied into a single allocation with `Release()`.
+  /// `GetBufferPointer()` and `CreateVectorOfSortedTables()` need a
+  /// contiguous buffer, and can't be used in this mode.
+  /// @param[in] segment_size The minimum size of each segment, or `0` to use
+  /// a single contiguous allocation (the default).
+  /// Only call this on an empty builder.
+  void BuildInSegments(size_t segment_size) {
+    buf_.set_segment_size(segment_size);
+  }
+
+  /// @brief Get the finished buffer as a list of memory regions that,
+  /// concatenated in order, form the buffer. There is just one unless
+  /// `BuildInSegments()` or `CreateReferenceVector()` was used.
+  /// @return The regions, suitable for scatter-gather output such as
+  /// `writev()`. They are valid until the builder is modified.
+  std::vector<BufferSegment> GetBufferSegments() const {
+    Finished();
+    std::vector<BufferSegment> segments;
+    buf_.segments(&segments);
+    return segments;
+  }
+
+  /// @brief Write the finished buffer to `sink`, straight from the builder's
+  /// memory, whether it was built in segments or not.
+  /// @return Returns `false` if the sink failed.
+  bool WriteTo(Sink &sink) const {
+    Finished();
+    if (buf_.contiguous()) return sink.Write(buf_.data(), buf_.size());
+    std::vector<BufferSegment> segments;
+    buf_.segments(&segments);
+    for (auto it = segments.begin(); it != segments.end(); ++it) {
+      if (!sink.Write(it->data, it->size)) return false;
+    }
+    return true;
+  }
+
   /// @brief Get a pointer to an unfinished buffer.
   /// @return Returns a `uint8_t` pointer to the unfinished buffer.
   uint8_t *GetCurrentBufferPointer() const { return buf_.data(); }
@@ -792,6 +1702,7 @@ class FlatBufferBuilder {
   }
 
   /// @brief Get the released DetachedBuffer.
+  /// A buffer built in segments is copied into a single allocation first.
   /// @return A `DetachedBuffer` that owns the buffer and its allocator.
   DetachedBuffer Release() {
     Finished();
@@ -828,6 +1739,16 @@ class FlatBufferBuilder {
   /// @param[in] bool dedup When set to `true`, dedup vtables.
   void DedupVtables(bool dedup) { dedup_vtables_ = dedup; }
 
+  /// @brief Vtables are deduped with a linear scan over the ones written so
+  /// far, which is fastest for small buffers. Once a buffer contains more than
+  /// `threshold` distinct vtables, the builder switches to a hash index keyed
+  /// by vtable contents instead. The resulting buffer is identical either way.
+  /// @param[in] threshold The number of distinct vtables at which to start
+  /// hashing them, or `0` to always use the linear scan.
+  void VtableIndexThreshold(size_t threshold) {
+    vtable_index_threshold_ = threshold;
+  }
+
   /// @cond FLATBUFFERS_INTERNAL
   void Pad(size_t num_bytes) { buf_.fill(num_bytes); }
 
@@ -837,7 +1758,9 @@ class FlatBufferBuilder {
 
   void Align(size_t elem_size) {
     TrackMinAlign(elem_size);
-    buf_.fill(PaddingBytes(buf_.size(), elem_size));
+    auto padding = PaddingBytes(buf_.size(), elem_size);
+    buf_.fill(padding);
+    FLATBUFFERS_BUILDER_STAT(buf_.stats(), Padding(padding));
   }
 
   void PushFlatBuffer(const uint8_t *bytes, size_t size) {
@@ -885,6 +1808,41 @@ class FlatBufferBuilder {
     TrackField(field, off);
   }
 
+  // Like calling AddElement for each of `count` fields of the same scalar
+  // type, with the same result, but aligns once, reserves space once for all
+  // the values and their FieldLocs, and writes them in a single pass. Fields
+  // of different types can be added by calling this once per type, largest
+  // type first to avoid padding.
+  template<typename T>
+  void AddElements(const voffset_t *fields, const T *values, const T *defs,
+                   size_t count) {
+    AssertScalarT<T>();
+    size_t num_present = 0;
+    for (size_t i = 0; i < count; i++) {
+      if (!(values[i] == defs[i]) || force_defaults_) num_present++;
+    }
+    if (!num_present) return;
+    Align(sizeof(T));
+    buf_.ensure_space(num_present * (sizeof(T) + sizeof(FieldLoc)));
+    auto dest = buf_.make_space(num_present * sizeof(T)) +
+                num_present * sizeof(T);
+    auto locs =
+        reinterpret_cast<FieldLoc *>(buf_.scratch_make_space(num_present *
+                                                             sizeof(FieldLoc)));
+    auto off = GetSize() - static_cast<uoffset_t>(num_present * sizeof(T));
+    for (size_t i = 0; i < count; i++) {
+      if (values[i] == defs[i] && !force_defaults_) continue;
+      dest -= sizeof(T);
+      WriteScalar(dest, values[i]);
+      off += static_cast<uoffset_t>(sizeof(T));
+      locs->off = off;
+      locs->id = fields[i];
+      locs++;
+      max_voffset_ = (std::max)(max_voffset_, fields[i]);
+    }
+    num_field_loc += static_cast<uoffset_t>(num_present);
+  }
+
   template<typename T> void AddOffset(voffset_t field, Offset<T> off) {
     if (off.IsNull()) return;  // Don't store.
     AddElement(field, ReferTo(off.o), static_cast<uoffset_t>(0));
@@ -934,6 +1892,20 @@ class FlatBufferBuilder {
     return GetSize();
   }
 
+  // Like StartTable(), but first makes sure there is room for adding up to
+  // `num_fields` fields that take up at most `max_inline_size` bytes, padding
+  // included, and ending the table. So the buffer is grown once rather than
+  // (maybe) partway through. Used by generated code, with sizes known from
+  // the schema.
+  uoffset_t StartTable(size_t max_inline_size, voffset_t num_fields) {
+    // The fields, the aligned vtable offset and the vtable, plus the FieldLocs
+    // and the vtable's entry in the scratch area.
+    buf_.ensure_space(max_inline_size + 2 * sizeof(soffset_t) - 1 +
+                      FieldIndexToOffset(num_fields) +
+                      num_fields * sizeof(FieldLoc) + sizeof(uoffset_t));
+    return StartTable();
+  }
+
   // This finishes one serialized object by generating the vtable if it's a
   // table, comparing it against existing vtables, and writing the
   // resulting vtable offset.
@@ -972,7 +1944,14 @@ class FlatBufferBuilder {
     auto vt_use = GetSize();
     // See if we already have generated a vtable with this exact same
     // layout before. If so, make it point to the old one, remove this one.
-    if (dedup_vtables_) {
+    bool hashed = dedup_vtables_ && vtable_index_ && !vtable_index_->empty();
+    if (hashed) {
+      auto existing = vtable_index_->find(buf_, vt1);
+      if (existing) {
+        vt_use = existing;
+        buf_.pop(GetSize() - vtableoffsetloc);
+      }
+    } else if (dedup_vtables_) {
       for (auto it = buf_.scratch_data(); it < buf_.scratch_end();
            it += sizeof(uoffset_t)) {
         auto vt_offset_ptr = reinterpret_cast<uoffset_t *>(it);
@@ -984,8 +1963,23 @@ class FlatBufferBuilder {
         break;
       }
     }
+    FLATBUFFERS_BUILDER_STAT(buf_.stats(), Vtable(vt_use != GetSize()));
     // If this is a new vtable, remember it.
-    if (vt_use == GetSize()) { buf_.scratch_push_small(vt_use); }
+    if (vt_use == GetSize()) {
+      buf_.scratch_push_small(vt_use);
+      if (hashed) {
+        vtable_index_->insert(buf_, vt_use);
+      } else if (dedup_vtables_ && vtable_index_threshold_ &&
+                 buf_.scratch_size() / sizeof(uoffset_t) >
+                     vtable_index_threshold_) {
+        // Too many vtables for a linear scan to be cheap, index all of them.
+        if (!vtable_index_) vtable_index_ = new VtableIndex();
+        for (auto it = buf_.scratch_data(); it < buf_.scratch_end();
+             it += sizeof(uoffset_t)) {
+          vtable_index_->insert(buf_, *reinterpret_cast<uoffset_t *>(it));
+        }
+      }
+    }
     // Fill the vtable offset we created above.
     // The offset points from the beginning of the object to where the
     // vtable is stored.
@@ -1008,7 +2002,7 @@ class FlatBufferBuilder {
   // just been constructed.
   template<typename T> void Required(Offset<T> table, voffset_t field) {
     auto table_ptr = buf_.data_at(table.o);
-    auto vtable_ptr = table_ptr - ReadScalar<soffset_t>(table_ptr);
+    auto vtable_ptr = buf_.data_at(table.o + ReadScalar<soffset_t>(table_ptr));
     bool ok = ReadScalar<voffset_t>(vtable_ptr + field) != 0;
     // If this fails, the caller will show what field needs to be set.
     assert(ok);
@@ -1032,7 +2026,9 @@ class FlatBufferBuilder {
   // after it with "alignment" without padding.
   void PreAlign(size_t len, size_t alignment) {
     TrackMinAlign(alignment);
-    buf_.fill(PaddingBytes(GetSize() + len, alignment));
+    auto padding = PaddingBytes(GetSize() + len, alignment);
+    buf_.fill(padding);
+    FLATBUFFERS_BUILDER_STAT(buf_.stats(), Padding(padding));
   }
   template<typename T> void PreAlign(size_t len) {
     AssertScalarT<T>();
@@ -1046,10 +2042,14 @@ class FlatBufferBuilder {
   /// @return Returns the offset in the buffer where the string starts.
   Offset<String> CreateString(const char *str, size_t len) {
     NotNested();
-    PreAlign<uoffset_t>(len + 1);  // Always 0-terminated.
-    buf_.fill(1);
-    PushBytes(reinterpret_cast<const uint8_t *>(str), len);
-    PushElement(static_cast<uoffset_t>(len));
+    // Write length, data, terminator and alignment padding in one go.
+    TrackMinAlign(sizeof(uoffset_t));
+    auto padding = PaddingBytes(GetSize() + len + 1, sizeof(uoffset_t));
+    auto dest = buf_.make_space(sizeof(uoffset_t) + len + 1 + padding);
+    WriteScalar(dest, static_cast<uoffset_t>(len));
+    dest += sizeof(uoffset_t);
+    memcpy(dest, str, len);
+    memset(dest + len, 0, 1 + padding);  // Always 0-terminated.
     return Offset<String>(GetSize());
   }
 
@@ -1096,21 +2096,17 @@ class FlatBufferBuilder {
   /// @param[in] len The number of bytes that should be stored from `str`.
   /// @return Returns the offset in the buffer where the string starts.
   Offset<String> CreateSharedString(const char *str, size_t len) {
-    if (!string_pool)
-      string_pool = new StringOffsetMap(StringOffsetCompare(buf_));
-    auto size_before_string = buf_.size();
-    // Must first serialize the string, since the set is all offsets into
-    // buffer.
-    auto off = CreateString(str, len);
-    auto it = string_pool->find(off);
+    // Also when the string is found, as it could not be created here.
+    NotNested();
+    if (!string_pool) string_pool = new StringPool();
+    auto hash = HashBytes(str, len);
     // If it exists we reuse existing serialized data!
-    if (it != string_pool->end()) {
-      // We can remove the string we serialized.
-      buf_.pop(buf_.size() - size_before_string);
-      return *it;
-    }
+    auto existing = string_pool->find(buf_, str, len, hash);
+    FLATBUFFERS_BUILDER_STAT(buf_.stats(), SharedString(existing != 0));
+    if (existing) return existing;
     // Record this string for future use.
-    string_pool->insert(off);
+    auto off = CreateString(str, len);
+    string_pool->insert(off.o, hash);
     return off;
   }
 
@@ -1194,6 +2190,32 @@ class FlatBufferBuilder {
     return Offset<Vector<T>>(EndVector(len));
   }
 
+  /// @brief Serialize an array of scalars into a FlatBuffer `vector` without
+  /// copying it into the builder: the builder only refers to the array, and
+  /// its bytes are part of the output when the buffer is obtained with
+  /// `GetBufferSegments()` (no copy at all) or `Release()` (copied once).
+  /// The buffer is not contiguous afterwards, so `GetBufferPointer()` can't
+  /// be used. On big-endian platforms this makes a copy, like `CreateVector`.
+  /// @tparam T The data type of the array elements.
+  /// @param[in] v A pointer to the array of type `T`, which must stay valid
+  /// and unchanged until the buffer is released, or the builder cleared.
+  /// @param[in] len The number of elements in the array.
+  /// @return Returns a typed `Offset` into the serialized data indicating
+  /// where the vector is stored.
+  template<typename T>
+  Offset<Vector<T>> CreateReferenceVector(const T *v, size_t len) {
+    AssertScalarT<T>();
+    // clang-format off
+    #if FLATBUFFERS_LITTLEENDIAN
+      StartVector(len, sizeof(T));
+      buf_.push_external(reinterpret_cast<const uint8_t *>(v), len * sizeof(T));
+      return Offset<Vector<T>>(EndVector(len));
+    #else
+      return CreateVector(v, len);
+    #endif
+    // clang-format on
+  }
+
   template<typename T>
   Offset<Vector<Offset<T>>> CreateVector(const Offset<T> *v, size_t len) {
     StartVector(len, sizeof(Offset<T>));
@@ -1465,6 +2487,8 @@ class FlatBufferBuilder {
   template<typename T>
   Offset<Vector<Offset<T>>> CreateVectorOfSortedTables(Offset<T> *v,
                                                        size_t len) {
+    // Tables can't be compared when the buffer is not contiguous.
+    assert(buf_.contiguous());
     std::sort(v, v + len, TableKeyComparator<T>(buf_));
     return CreateVector(v, len);
   }
@@ -1482,6 +2506,41 @@ class FlatBufferBuilder {
     return CreateVectorOfSortedTables(data(*v), v->size());
   }
 
+  /// @brief Serialize an index for looking up keys in a vector created with
+  /// `CreateVectorOfSortedTables()`, to be passed to `Vector::LookupByKey()`.
+  /// It holds a 32-bit prefix of the key of each table, in the same order.
+  /// Store it in a field of type `[uint]` next to the vector.
+  /// @tparam T The data type that the offset refers to.
+  /// @param[in] v The offsets passed to `CreateVectorOfSortedTables()`, which
+  /// it has sorted.
+  /// @param[in] len The number of elements in `v`.
+  /// @param[in] key The accessor of the key field, e.g. `&Monster::name`.
+  /// @return Returns a typed `Offset` into the serialized data indicating
+  /// where the index is stored.
+  template<typename T, typename K>
+  Offset<Vector<uint32_t>> CreateKeyIndex(const Offset<T> *v, size_t len,
+                                          K (T::*key)() const) {
+    // Tables can't be read when the buffer is not contiguous.
+    assert(buf_.contiguous());
+    uint32_t *prefixes;
+    auto index = CreateUninitializedVector(len, &prefixes);
+    for (size_t i = 0; i < len; i++) {
+      auto table = reinterpret_cast<const T *>(buf_.data_at(v[i].o));
+      WriteScalar(prefixes + i, KeyPrefix((table->*key)()));
+    }
+    return index;
+  }
+
+  /// @brief Serialize an index for looking up keys in a vector created with
+  /// `CreateVectorOfSortedTables()`, see above.
+  /// @param[in] v The offsets passed to `CreateVectorOfSortedTables()`.
+  /// @param[in] key The accessor of the key field, e.g. `&Monster::name`.
+  template<typename T, typename K>
+  Offset<Vector<uint32_t>> CreateKeyIndex(const std::vector<Offset<T>> &v,
+                                          K (T::*key)() const) {
+    return CreateKeyIndex(data(v), v.size(), key);
+  }
+
   /// @brief Specialized version of `CreateVector` for non-copying use cases.
   /// Write the data any time later to the returned buffer pointer `buf`.
   /// @param[in] len The number of elements to store in the `vector`.
@@ -1522,6 +2581,46 @@ class FlatBufferBuilder {
     return Offset<const T *>(GetSize());
   }
 
+  /// @brief Copy everything built so far by another builder into this one,
+  /// so that subtrees can be built in parallel in separate builders (e.g. one
+  /// per thread) and then combined into a single buffer.
+  /// @param[in] sub A builder that is not finished, and not in the middle
+  /// of building a table. It is left unchanged.
+  /// @return Returns the amount to add to any offset returned by `sub` to
+  /// get the corresponding offset in this builder. Use `Relocate()` for a
+  /// typed offset.
+  /// All offsets inside a FlatBuffer are relative, so the data is copied
+  /// verbatim, padded to keep its alignment. The vtables of `sub` are
+  /// added to those of this builder, so tables built here afterwards share
+  /// them where possible.
+  uoffset_t Splice(const FlatBufferBuilder &sub) {
+    NotNested();
+    assert(!sub.nested && !sub.finished);
+    Align(sub.minalign_);
+    auto base = GetSize();
+    std::vector<BufferSegment> segments;
+    sub.buf_.segments(&segments);
+    for (auto it = segments.rbegin(); it != segments.rend(); ++it) {
+      PushBytes(it->data, it->size);
+    }
+    if (!sub.buf_.scratch_size()) return base;
+    for (auto it = sub.buf_.scratch_data(); it < sub.buf_.scratch_end();
+         it += sizeof(uoffset_t)) {
+      auto vt_offset = *reinterpret_cast<uoffset_t *>(it) + base;
+      buf_.scratch_push_small(vt_offset);
+      if (vtable_index_ && !vtable_index_->empty()) {
+        vtable_index_->insert(buf_, vt_offset);
+      }
+    }
+    return base;
+  }
+
+  /// @brief Map an offset returned by the builder passed to `Splice()`
+  /// to the corresponding offset in this builder.
+  template<typename T> Offset<T> Relocate(Offset<T> off, uoffset_t base) {
+    return off.IsNull() ? off : Offset<T>(off.o + base);
+  }
+
   /// @brief The length of a FlatBuffer file header.
   static const size_t kFileIdentifierLength = 4;
 
@@ -1546,6 +2645,24 @@ class FlatBufferBuilder {
     Finish(root.o, file_identifier, true);
   }
 
+  /// @brief Like `Finish()`, then write the buffer to `sink`.
+  /// @return Returns `false` if the sink failed.
+  template<typename T>
+  bool FinishTo(Offset<T> root, Sink &sink,
+                const char *file_identifier = nullptr) {
+    Finish(root.o, file_identifier, false);
+    return WriteTo(sink);
+  }
+
+  /// @brief Like `FinishSizePrefixed()`, then write the buffer to `sink`.
+  /// @return Returns `false` if the sink failed.
+  template<typename T>
+  bool FinishSizePrefixedTo(Offset<T> root, Sink &sink,
+                            const char *file_identifier = nullptr) {
+    Finish(root.o, file_identifier, true);
+    return WriteTo(sink);
+  }
+
  protected:
   // You shouldn't really be copying instances of this class.
   FlatBufferBuilder(const FlatBufferBuilder &);
@@ -1553,7 +2670,10 @@ class FlatBufferBuilder {
 
   void Finish(uoffset_t root, const char *file_identifier, bool size_prefix) {
     NotNested();
+    // The vtable offsets in the scratchpad took space when building too.
+    auto scratch_size = buf_.scratch_size();
     buf_.clear_scratch();
+    if (vtable_index_) vtable_index_->clear();
     // This will cause the whole buffer to be aligned.
     PreAlign((size_prefix ? sizeof(uoffset_t) : 0) + sizeof(uoffset_t) +
                  (file_identifier ? kFileIdentifierLength : 0),
@@ -1566,6 +2686,14 @@ class FlatBufferBuilder {
     PushElement(ReferTo(root));  // Location of root.
     if (size_prefix) { PushElement(GetSize()); }
     finished = true;
+    FLATBUFFERS_BUILDER_STAT(buf_.stats(), Finished(GetSize()));
+    if (size_hint_) size_hint_->Record(GetSize() + scratch_size);
+  }
+
+  void ReserveFromSizeHint() {
+    if (!size_hint_) return;
+    auto estimate = size_hint_->Estimate();
+    if (estimate) buf_.reserve(estimate + estimate / 8);
   }
 
   struct FieldLoc {
@@ -1594,20 +2722,142 @@ class FlatBufferBuilder {
 
   bool dedup_vtables_;
 
-  struct StringOffsetCompare {
-    StringOffsetCompare(const vector_downward &buf) : buf_(&buf) {}
-    bool operator()(const Offset<String> &a, const Offset<String> &b) const {
-      auto stra = reinterpret_cast<const String *>(buf_->data_at(a.o));
-      auto strb = reinterpret_cast<const String *>(buf_->data_at(b.o));
-      return strncmp(stra->c_str(), strb->c_str(),
-                     (std::min)(stra->size(), strb->size()) + 1) < 0;
+  // Number of distinct vtables after which EndTable switches from a linear
+  // scan to vtable_index_.
+  size_t vtable_index_threshold_;
+  static const size_t kDefaultVtableIndexThreshold = 16;
+
+  // Open addressing hash set of the vtables in the scratchpad of buf_, keyed
+  // by their contents. Entries are vtable offsets from the end of the buffer,
+  // so they remain valid when buf_ reallocates. 0 marks an empty slot.
+  class VtableIndex {
+   public:
+    VtableIndex() : count_(0) {}
+
+    bool empty() const { return !count_; }
+
+    void clear() {
+      std::fill(slots_.begin(), slots_.end(), 0);
+      count_ = 0;
+    }
+
+    // Returns the offset of a vtable equal to `vt`, or 0 if there is none.
+    uoffset_t find(const vector_downward &buf, const voffset_t *vt) {
+      return *lookup(buf, vt);
+    }
+
+    void insert(const vector_downward &buf, uoffset_t vt_offset) {
+      // Keep the load factor at or below 1/2.
+      if ((count_ + 1) * 2 > slots_.size()) {
+        std::vector<uoffset_t> old_slots(
+            (std::max)(slots_.size() * 2, static_cast<size_t>(64)), 0);
+        old_slots.swap(slots_);
+        for (auto it = old_slots.begin(); it != old_slots.end(); ++it) {
+          if (*it) *lookup(buf, vtable_at(buf, *it)) = *it;
+        }
+      }
+      auto slot = lookup(buf, vtable_at(buf, vt_offset));
+      if (!*slot) {
+        *slot = vt_offset;
+        count_++;
+      }
+    }
+
+   private:
+    static const voffset_t *vtable_at(const vector_downward &buf,
+                                      uoffset_t vt_offset) {
+      return reinterpret_cast<const voffset_t *>(buf.data_at(vt_offset));
+    }
+
+    // Returns the slot holding a vtable equal to `vt`, or the empty slot
+    // where it should be inserted.
+    uoffset_t *lookup(const vector_downward &buf, const voffset_t *vt) {
+      auto mask = slots_.size() - 1;
+      auto vt_size = ReadScalar<voffset_t>(vt);
+      for (auto i = HashBytes(vt, vt_size) & mask;; i = (i + 1) & mask) {
+        auto &slot = slots_[i];
+        if (!slot) return &slot;
+        auto vt2 = vtable_at(buf, slot);
+        if (ReadScalar<voffset_t>(vt2) == vt_size && !memcmp(vt2, vt, vt_size))
+          return &slot;
+      }
+    }
+
+    std::vector<uoffset_t> slots_;  // Size is always 0 or a power of 2.
+    size_t count_;
+  };
+
+  // Instantiated once a buffer exceeds vtable_index_threshold_.
+  VtableIndex *vtable_index_;
+
+  BufferSizeHint *size_hint_;  // Not owned, may be null.
+
+  // Open addressing hash set of the strings created by CreateSharedString,
+  // so a string can be looked up before it is serialized. Entries keep the
+  // hash of the string next to its offset (0 marks an empty slot), so most
+  // mismatches don't need to touch the buffer.
+  class StringPool {
+   public:
+    StringPool() : count_(0) {}
+
+    void clear() {
+      Entry empty = { 0, 0 };
+      std::fill(slots_.begin(), slots_.end(), empty);
+      count_ = 0;
+    }
+
+    // Returns the offset of a string equal to `str`, or 0 if there is none.
+    uoffset_t find(const vector_downward &buf, const char *str, size_t len,
+                   uint32_t hash) const {
+      if (!count_) return 0;
+      auto mask = slots_.size() - 1;
+      for (auto i = hash & mask;; i = (i + 1) & mask) {
+        auto &slot = slots_[i];
+        if (!slot.offset) return 0;
+        if (slot.hash != hash) continue;
+        auto pooled =
+            reinterpret_cast<const String *>(buf.data_at(slot.offset));
+        if (pooled->size() == len && !memcmp(pooled->c_str(), str, len))
+          return slot.offset;
+      }
+    }
+
+    // Adds a string that find() didn't return.
+    void insert(uoffset_t offset, uint32_t hash) {
+      // Keep the load factor at or below 1/2.
+      if ((count_ + 1) * 2 > slots_.size()) {
+        Entry empty = { 0, 0 };
+        std::vector<Entry> old_slots(
+            (std::max)(slots_.size() * 2, static_cast<size_t>(64)), empty);
+        old_slots.swap(slots_);
+        for (auto it = old_slots.begin(); it != old_slots.end(); ++it) {
+          if (it->offset) *empty_slot(it->hash) = *it;
+        }
+      }
+      Entry entry = { offset, hash };
+      *empty_slot(hash) = entry;
+      count_++;
+    }
+
+   private:
+    struct Entry {
+      uoffset_t offset;
+      uint32_t hash;
+    };
+
+    Entry *empty_slot(uint32_t hash) {
+      auto mask = slots_.size() - 1;
+      auto i = hash & mask;
+      while (slots_[i].offset) i = (i + 1) & mask;
+      return &slots_[i];
     }
-    const vector_downward *buf_;
+
+    std::vector<Entry> slots_;  // Size is always 0 or a power of 2.
+    size_t count_;
   };
 
   // For use with CreateSharedString. Instantiated on first use only.
-  typedef std::set<Offset<String>, StringOffsetCompare> StringOffsetMap;
-  StringOffsetMap *string_pool;
+  StringPool *string_pool;
 
  private:
   // Allocates space for a vector of structures.
@@ -1675,6 +2925,252 @@ inline bool BufferHasIdentifier(const void *buf, const char *identifier, bool si
                  FlatBufferBuilder::kFileIdentifierLength) == 0;
 }
 
+// Checks that none of the `count` offsets stored from `offsets` onwards
+// points more than `limit` bytes past the first one, i.e. that the i-th
+// offset is no larger than `limit - i * sizeof(uoffset_t)`. The caller must
+// make sure `limit` is at least `(count - 1) * sizeof(uoffset_t)`.
+inline bool OffsetsWithinLimit(const uint8_t *offsets, size_t count,
+                               uoffset_t limit) {
+  size_t i = 0;
+  // clang-format off
+  #if defined(FLATBUFFERS_SIMD_AVX2) || defined(FLATBUFFERS_SIMD_SSE2)
+    // There are no unsigned compares, so compare with the sign bit flipped
+    // instead, which is the same as adding 2^31. The per lane limits are
+    // computed unsigned, where they may wrap if the loop below never runs.
+    const uint32_t sign = 0x80000000u;
+  #endif
+  #if defined(FLATBUFFERS_SIMD_AVX2)
+    const uint32_t lanes[8] = {
+      limit ^ sign,        (limit - 4) ^ sign,  (limit - 8) ^ sign,
+      (limit - 12) ^ sign, (limit - 16) ^ sign, (limit - 20) ^ sign,
+      (limit - 24) ^ sign, (limit - 28) ^ sign
+    };
+    const __m256i signs = _mm256_set1_epi32(-0x7FFFFFFF - 1);
+    const __m256i step = _mm256_set1_epi32(8 * sizeof(uoffset_t));
+    __m256i limits =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lanes));
+    __m256i bad = _mm256_setzero_si256();
+    for (; i + 8 <= count; i += 8) {
+      auto v = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i *>(offsets + i * sizeof(uoffset_t)));
+      bad = _mm256_or_si256(
+          bad, _mm256_cmpgt_epi32(_mm256_xor_si256(v, signs), limits));
+      limits = _mm256_sub_epi32(limits, step);
+    }
+    if (!_mm256_testz_si256(bad, bad)) return false;
+    limit -= static_cast<uoffset_t>(i * sizeof(uoffset_t));
+  #elif defined(FLATBUFFERS_SIMD_SSE2)
+    const uint32_t lanes[4] = { limit ^ sign, (limit - 4) ^ sign,
+                                (limit - 8) ^ sign, (limit - 12) ^ sign };
+    const __m128i signs = _mm_set1_epi32(-0x7FFFFFFF - 1);
+    const __m128i step = _mm_set1_epi32(4 * sizeof(uoffset_t));
+    __m128i limits = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lanes));
+    __m128i bad = _mm_setzero_si128();
+    for (; i + 4 <= count; i += 4) {
+      auto v = _mm_loadu_si128(
+          reinterpret_cast<const __m128i *>(offsets + i * sizeof(uoffset_t)));
+      bad = _mm_or_si128(bad,
+                         _mm_cmpgt_epi32(_mm_xor_si128(v, signs), limits));
+      limits = _mm_sub_epi32(limits, step);
+    }
+    if (_mm_movemask_epi8(bad)) return false;
+    limit -= static_cast<uoffset_t>(i * sizeof(uoffset_t));
+  #elif defined(FLATBUFFERS_SIMD_NEON)
+    const uint32_t lanes[4] = { limit, limit - 4, limit - 8, limit - 12 };
+    const uint32x4_t step = vdupq_n_u32(4 * sizeof(uoffset_t));
+    uint32x4_t limits = vld1q_u32(lanes);
+    uint32x4_t ok = vdupq_n_u32(0xFFFFFFFFu);
+    for (; i + 4 <= count; i += 4) {
+      auto v = vreinterpretq_u32_u8(vld1q_u8(offsets + i * sizeof(uoffset_t)));
+      ok = vandq_u32(ok, vcleq_u32(v, limits));
+      limits = vsubq_u32(limits, step);
+    }
+    if ((vgetq_lane_u32(ok, 0) & vgetq_lane_u32(ok, 1) &
+         vgetq_lane_u32(ok, 2) & vgetq_lane_u32(ok, 3)) != 0xFFFFFFFFu)
+      return false;
+    limit -= static_cast<uoffset_t>(i * sizeof(uoffset_t));
+  #endif
+  // clang-format on
+  for (; i < count; i++, limit -= sizeof(uoffset_t)) {
+    if (ReadScalar<uoffset_t>(offsets + i * sizeof(uoffset_t)) > limit)
+      return false;
+  }
+  return true;
+}
+
+class VerifierStats;
+
+// clang-format off
+#ifdef FLATBUFFERS_VERIFIER_STATS
+// clang-format on
+// Where a Verifier spends its time, per table type, see Verifier::SetStats().
+// Only available if FLATBUFFERS_VERIFIER_STATS is defined. The Verifier has
+// the same layout either way, but only collects statistics in code compiled
+// with it.
+class VerifierStats {
+ public:
+  struct TypeStats {
+    // The fully qualified name of the type if known, see TableTypeName().
+    const char *name;
+    // How many tables of this type were verified.
+    size_t tables;
+    // Bytes checked for the tables themselves, their vtables, and the
+    // strings and vectors they refer to (but not the tables in those).
+    size_t bytes;
+    // The deepest a table of this type was found, the root being at 1.
+    uoffset_t max_depth;
+    // Time spent on tables of this type, not counting the tables below.
+    double seconds;
+  };
+
+  VerifierStats() : bytes_(0), failed_type_(nullptr) {}
+
+  // All table types encountered, in the order they were first seen.
+  const std::vector<TypeStats> &types() const { return types_; }
+
+  // Find the stats of one type, or nullptr if none were verified.
+  const TypeStats *Find(const char *name) const {
+    for (auto it = types_.begin(); it != types_.end(); ++it) {
+      if (it->name == name || !strcmp(it->name, name)) return &*it;
+    }
+    return nullptr;
+  }
+
+  // The total amount of tables, deepest nesting and bytes checked.
+  size_t tables() const {
+    size_t n = 0;
+    for (auto it = types_.begin(); it != types_.end(); ++it) n += it->tables;
+    return n;
+  }
+  uoffset_t max_depth() const {
+    uoffset_t depth = 0;
+    for (auto it = types_.begin(); it != types_.end(); ++it) {
+      depth = (std::max)(depth, it->max_depth);
+    }
+    return depth;
+  }
+  size_t bytes() const { return bytes_; }
+
+  // If verification failed, the type of the table it failed in (or
+  // nullptr, e.g. because the root offset was bad).
+  const char *failed_type() const { return failed_type_; }
+
+  void Clear() {
+    types_.clear();
+    stack_.clear();
+    bytes_ = 0;
+    failed_type_ = nullptr;
+  }
+
+  // Called by the Verifier.
+  void BeginTable(const char *name, uoffset_t depth) {
+    if (!name) name = "?";
+    size_t type = 0;
+    while (type < types_.size() && types_[type].name != name &&
+           strcmp(types_[type].name, name)) {
+      type++;
+    }
+    if (type == types_.size()) {
+      TypeStats stats = { name, 0, 0, 0, 0 };
+      types_.push_back(stats);
+    }
+    types_[type].tables++;
+    types_[type].max_depth = (std::max)(types_[type].max_depth, depth);
+    Frame frame = { type, Clock::now(), Clock::duration::zero() };
+    stack_.push_back(frame);
+  }
+
+  void EndTable() {
+    assert(!stack_.empty());
+    auto &frame = stack_.back();
+    auto elapsed = Clock::now() - frame.start;
+    types_[frame.type].seconds +=
+        std::chrono::duration<double>(elapsed - frame.children).count();
+    stack_.pop_back();
+    if (!stack_.empty()) stack_.back().children += elapsed;
+  }
+
+  void Touch(size_t bytes) {
+    bytes_ += bytes;
+    if (!stack_.empty()) types_[stack_.back().type].bytes += bytes;
+  }
+
+  void Fail() {
+    if (!failed_type_ && !stack_.empty()) {
+      failed_type_ = types_[stack_.back().type].name;
+    }
+  }
+
+  // How many tables are being verified, one inside the other. Tables that
+  // fail don't get to EndTable(), nor do the ones around them, so the
+  // Verifier ends them with Unwind() back to where it started.
+  size_t depth() const { return stack_.size(); }
+  void Unwind(size_t depth) {
+    while (stack_.size() > depth) EndTable();
+  }
+
+ private:
+  typedef std::chrono::steady_clock Clock;
+
+  struct Frame {
+    size_t type;
+    Clock::time_point start;
+    Clock::duration children;  // Time spent on tables below this one.
+  };
+
+  std::vector<TypeStats> types_;
+  std::vector<Frame> stack_;
+  size_t bytes_;
+  const char *failed_type_;
+};
+
+template<typename T> class HasFullyQualifiedName {
+  template<typename U>
+  static char Test(decltype(&U::GetFullyQualifiedName));
+  template<typename U> static long Test(...);
+
+ public:
+  static const bool value = sizeof(Test<T>(nullptr)) == 1;
+};
+
+// The name of a generated table type for VerifierStats: the fully qualified
+// name if the code was generated with --gen-name-strings, otherwise the
+// (compiler specific) name from RTTI, if enabled.
+template<typename T>
+typename std::enable_if<HasFullyQualifiedName<T>::value, const char *>::type
+TableTypeName() {
+  return T::GetFullyQualifiedName();
+}
+
+template<typename T>
+typename std::enable_if<!HasFullyQualifiedName<T>::value, const char *>::type
+TableTypeName() {
+  // clang-format off
+  #ifdef FLATBUFFERS_HAS_RTTI
+    return typeid(T).name();
+  #else
+    return nullptr;
+  #endif
+  // clang-format on
+}
+// clang-format off
+#endif  // FLATBUFFERS_VERIFIER_STATS
+// clang-format on
+
+// Runs independent tasks in parallel, e.g. on a thread pool. Used by the
+// Verifier to check large vectors of tables, see Verifier::SetParallel().
+// See ThreadPool in thread_pool.h for an implementation.
+class ParallelExecutor {
+ public:
+  typedef void (*Task)(void *context, size_t index);
+
+  virtual ~ParallelExecutor() {}
+
+  // Call `task(context, i)` for every i in [0, num_tasks), in any order and
+  // on any thread, and return once all calls have returned.
+  virtual void ParallelFor(size_t num_tasks, Task task, void *context) = 0;
+};
+
 // Helper class to verify the integrity of a FlatBuffer
 class Verifier FLATBUFFERS_FINAL_CLASS {
  public:
@@ -1685,7 +3181,12 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
         depth_(0),
         max_depth_(_max_depth),
         num_tables_(0),
-        max_tables_(_max_tables)
+        max_tables_(_max_tables),
+        executor_(nullptr),
+        parallel_threshold_(0),
+        shallow_(false),
+        stats_(nullptr),
+        next_table_type_(nullptr)
   // clang-format off
     #ifdef FLATBUFFERS_TRACK_VERIFIER_BUFFER_SIZE
         , upper_bound_(buf)
@@ -1694,12 +3195,42 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
   {
   }
 
+  // Verify vectors of at least `min_vector_size` tables by splitting them
+  // across `executor`, with a Verifier per task, instead of one table after
+  // the other. The depth and table limits still apply to the buffer as a
+  // whole. Tables inside such a vector are verified sequentially. Pass
+  // `nullptr` to turn this off again.
+  void SetParallel(ParallelExecutor *executor,
+                   uoffset_t min_vector_size = 4096) {
+    executor_ = executor;
+    parallel_threshold_ =
+        (std::max)(min_vector_size, static_cast<uoffset_t>(kTablesPerTask));
+  }
+
+  // Only check the tables passed to their Verify() directly, including
+  // the strings and vectors they refer to, but not the tables (or vectors of
+  // tables and strings) below them. See LazyVerifier.
+  void SetShallow(bool shallow) { shallow_ = shallow; }
+
+  // Collect statistics in `stats` (not owned), or `nullptr` to stop. Only
+  // code compiled with FLATBUFFERS_VERIFIER_STATS collects them.
+  // Vectors of tables aren't verified in parallel while collecting them.
+  void SetStats(VerifierStats *stats) { stats_ = stats; }
+  VerifierStats *GetStats() const { return stats_; }
+
+  // The type of the table about to be verified, for the statistics. Set
+  // automatically for generated code.
+  void SetNextTableType(const char *name) { next_table_type_ = name; }
+
   // Central location where any verification failures register.
   bool Check(bool ok) const {
     // clang-format off
     #ifdef FLATBUFFERS_DEBUG_VERIFICATION_FAILURE
       assert(ok);
     #endif
+    #ifdef FLATBUFFERS_VERIFIER_STATS
+      if (!ok && stats_) stats_->Fail();
+    #endif
     #ifdef FLATBUFFERS_TRACK_VERIFIER_BUFFER_SIZE
       if (!ok)
         upper_bound_ = buf_;
@@ -1711,6 +3242,9 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
   // Verify any range within the buffer.
   bool Verify(const void *elem, size_t elem_len) const {
     // clang-format off
+    #ifdef FLATBUFFERS_VERIFIER_STATS
+      if (stats_) stats_->Touch(elem_len);
+    #endif
     #ifdef FLATBUFFERS_TRACK_VERIFIER_BUFFER_SIZE
       auto upper_bound = reinterpret_cast<const uint8_t *>(elem) + elem_len;
       if (upper_bound_ < upper_bound)
@@ -1728,7 +3262,8 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
 
   // Verify a pointer (may be NULL) of a table type.
   template<typename T> bool VerifyTable(const T *table) {
-    return !table || table->Verify(*this);
+    if (!table || (shallow_ && depth_)) return true;
+    return VerifyTableOfType(table);
   }
 
   // Verify a pointer (may be NULL) of any vector type.
@@ -1770,7 +3305,9 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
 
   // Special case for string contents, after the above has been called.
   bool VerifyVectorOfStrings(const Vector<Offset<String>> *vec) const {
-    if (vec) {
+    if (vec && !shallow_) {
+      if (VerifyStringsInBulk(vec)) return true;
+      // Find the culprit the slow way, for Check() to report it.
       for (uoffset_t i = 0; i < vec->size(); i++) {
         if (!Verify(vec->Get(i))) return false;
       }
@@ -1780,9 +3317,16 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
 
   // Special case for table contents, after the above has been called.
   template<typename T> bool VerifyVectorOfTables(const Vector<Offset<T>> *vec) {
-    if (vec) {
+    if (vec && !shallow_) {
+      bool parallel = executor_ && vec->size() >= parallel_threshold_;
+      // clang-format off
+      #ifdef FLATBUFFERS_VERIFIER_STATS
+        parallel = parallel && !stats_;
+      #endif
+      // clang-format on
+      if (parallel) return VerifyVectorOfTablesInParallel(vec);
       for (uoffset_t i = 0; i < vec->size(); i++) {
-        if (!vec->Get(i)->Verify(*this)) return false;
+        if (!VerifyTableOfType(vec->Get(i))) return false;
       }
     }
     return true;
@@ -1798,7 +3342,7 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
 
     // Call T::Verify, which must be in the generated code for this type.
     auto o = VerifyOffset(start);
-    return o && reinterpret_cast<const T *>(start + o)->Verify(*this)
+    return o && VerifyTableOfType(reinterpret_cast<const T *>(start + o))
 #ifdef FLATBUFFERS_TRACK_VERIFIER_BUFFER_SIZE
            && GetComputedSize()
 #endif
@@ -1832,12 +3376,23 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
   bool VerifyComplexity() {
     depth_++;
     num_tables_++;
+    // clang-format off
+    #ifdef FLATBUFFERS_VERIFIER_STATS
+      if (stats_) stats_->BeginTable(next_table_type_, depth_);
+      next_table_type_ = nullptr;
+    #endif
+    // clang-format on
     return Check(depth_ <= max_depth_ && num_tables_ <= max_tables_);
   }
 
   // Called at the end of a table to pop the depth count.
   bool EndTable() {
     depth_--;
+    // clang-format off
+    #ifdef FLATBUFFERS_VERIFIER_STATS
+      if (stats_) stats_->EndTable();
+    #endif
+    // clang-format on
     return true;
   }
 
@@ -1854,12 +3409,140 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
   // clang-format on
 
  private:
+  // Checks the same as verifying each string of a vector, which must have
+  // been verified itself: first that all offsets point inside the buffer
+  // (with SIMD, if available), then the sizes and terminators of all
+  // strings, without branching on each one.
+  bool VerifyStringsInBulk(const Vector<Offset<String>> *vec) const {
+    auto count = vec->size();
+    if (!count) return true;
+    auto first = vec->Data();
+    // Every string's size field must be inside the buffer.
+    auto limit = static_cast<uoffset_t>(end_ - first - sizeof(uoffset_t));
+    if (!OffsetsWithinLimit(first, count, limit)) return false;
+    bool ok = true;
+    // clang-format off
+    #ifdef FLATBUFFERS_TRACK_VERIFIER_BUFFER_SIZE
+      auto upper_bound = upper_bound_;
+    #endif
+    // clang-format on
+    for (uoffset_t i = 0; i < count; i++) {
+      auto elem = first + i * sizeof(uoffset_t);
+      auto str = elem + ReadScalar<uoffset_t>(elem);
+      auto size = ReadScalar<uoffset_t>(str);
+      auto fits = size < static_cast<size_t>(end_ - str) - sizeof(uoffset_t);
+      // Only look at the terminator if it is inside the buffer.
+      auto terminator = fits ? str + sizeof(uoffset_t) + size : str;
+      ok &= fits & !*terminator;
+      // clang-format off
+      #ifdef FLATBUFFERS_TRACK_VERIFIER_BUFFER_SIZE
+        if (upper_bound < terminator + 1) upper_bound = terminator + 1;
+      #endif
+      // clang-format on
+    }
+    // clang-format off
+    #ifdef FLATBUFFERS_TRACK_VERIFIER_BUFFER_SIZE
+      if (ok) upper_bound_ = upper_bound;
+    #endif
+    // clang-format on
+    return ok;
+  }
+
+  // How many tables of a vector each parallel task verifies.
+  static const uoffset_t kTablesPerTask = 256;
+
+  template<typename T> struct ParallelVectorTask {
+    const Verifier *parent;
+    const Vector<Offset<T>> *vec;
+    // Per task results, so the tasks don't share any mutable state.
+    std::vector<uint8_t> ok;
+    std::vector<uoffset_t> num_tables;
+    // clang-format off
+    #ifdef FLATBUFFERS_TRACK_VERIFIER_BUFFER_SIZE
+      std::vector<const uint8_t *> upper_bound;
+    #endif
+    // clang-format on
+
+    static void Run(void *context, size_t index) {
+      auto self = reinterpret_cast<ParallelVectorTask *>(context);
+      auto parent = self->parent;
+      // Each task gets all of the remaining table budget, the total is
+      // checked once all tasks are done.
+      Verifier verifier(parent->buf_,
+                        static_cast<size_t>(parent->end_ - parent->buf_),
+                        parent->max_depth_,
+                        parent->max_tables_ - parent->num_tables_);
+      verifier.depth_ = parent->depth_;
+      auto begin = static_cast<uoffset_t>(index) * kTablesPerTask;
+      auto end = (std::min)(begin + kTablesPerTask, self->vec->size());
+      bool ok = true;
+      for (auto i = begin; ok && i < end; i++) {
+        ok = self->vec->Get(i)->Verify(verifier);
+      }
+      self->ok[index] = ok;
+      self->num_tables[index] = verifier.num_tables_;
+      // clang-format off
+      #ifdef FLATBUFFERS_TRACK_VERIFIER_BUFFER_SIZE
+        self->upper_bound[index] = verifier.upper_bound_;
+      #endif
+      // clang-format on
+    }
+  };
+
+  template<typename T>
+  bool VerifyVectorOfTablesInParallel(const Vector<Offset<T>> *vec) {
+    auto num_tasks = (vec->size() + kTablesPerTask - 1) / kTablesPerTask;
+    ParallelVectorTask<T> task;
+    task.parent = this;
+    task.vec = vec;
+    task.ok.resize(num_tasks);
+    task.num_tables.resize(num_tasks);
+    // clang-format off
+    #ifdef FLATBUFFERS_TRACK_VERIFIER_BUFFER_SIZE
+      task.upper_bound.resize(num_tasks);
+    #endif
+    // clang-format on
+    executor_->ParallelFor(num_tasks, &ParallelVectorTask<T>::Run, &task);
+    for (size_t i = 0; i < num_tasks; i++) {
+      if (!task.ok[i]) return false;
+      num_tables_ += task.num_tables[i];
+      // clang-format off
+      #ifdef FLATBUFFERS_TRACK_VERIFIER_BUFFER_SIZE
+        if (upper_bound_ < task.upper_bound[i])
+          upper_bound_ = task.upper_bound[i];
+      #endif
+      // clang-format on
+    }
+    return Check(num_tables_ <= max_tables_);
+  }
+
+  // Calls T::Verify, ending the VerifierStats tables it leaves behind if it
+  // fails.
+  template<typename T> bool VerifyTableOfType(const T *table) {
+    // clang-format off
+    #ifdef FLATBUFFERS_VERIFIER_STATS
+      next_table_type_ = TableTypeName<T>();
+      auto stats_depth = stats_ ? stats_->depth() : 0;
+      if (table->Verify(*this)) return true;
+      if (stats_) stats_->Unwind(stats_depth);
+      return false;
+    #else
+      return table->Verify(*this);
+    #endif
+    // clang-format on
+  }
+
   const uint8_t *buf_;
   const uint8_t *end_;
   uoffset_t depth_;
   uoffset_t max_depth_;
   uoffset_t num_tables_;
   uoffset_t max_tables_;
+  ParallelExecutor *executor_;
+  uoffset_t parallel_threshold_;
+  bool shallow_;
+  VerifierStats *stats_;
+  const char *next_table_type_;
   // clang-format off
   #ifdef FLATBUFFERS_TRACK_VERIFIER_BUFFER_SIZE
     mutable const uint8_t *upper_bound_;
@@ -1867,6 +3550,113 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
   // clang-format on
 };
 
+// Verifies a buffer bit by bit, as it is being read, rather than all of it up
+// front with a Verifier. Check each table, vector and string with Verify()
+// before accessing it; tables are checked once (per type), after that
+// Verify() finds them in a bitmap of verified tables. This costs about as
+// much as using the Verifier for the parts of the buffer that are actually
+// read, plus up to 1 bit per 4 bytes of buffer per table type, allocated as
+// needed. This class is not thread-safe.
+//
+//   flatbuffers::LazyVerifier lazy(buf, len);
+//   if (!lazy.VerifyRoot<Monster>()) { /* error */ }
+//   auto monster = GetMonster(buf);
+//   if (!lazy.Verify(monster->enemy())) { /* error */ }
+//   /* enemy() may now be used (if not null) */
+class LazyVerifier FLATBUFFERS_FINAL_CLASS {
+ public:
+  LazyVerifier(const uint8_t *buf, size_t buf_len)
+      : buf_(buf), buf_len_(buf_len) {}
+
+  // Check the root offset (and file identifier if given) and root table.
+  template<typename T> bool VerifyRoot(const char *identifier = nullptr) {
+    if (identifier &&
+        (buf_len_ < 2 * sizeof(uoffset_t) ||
+         !BufferHasIdentifier(buf_, identifier))) {
+      return false;
+    }
+    Verifier verifier(buf_, buf_len_);
+    auto o = verifier.VerifyOffset(buf_);
+    return o && Verify(reinterpret_cast<const T *>(buf_ + o));
+  }
+
+  // Check a table (not the tables below it) before accessing its fields.
+  // Strings and vectors it refers to are checked too. Null tables pass.
+  template<typename T> bool Verify(const T *table) {
+    if (!table) return true;
+    auto offset = static_cast<size_t>(
+        reinterpret_cast<const uint8_t *>(table) - buf_);
+    auto &bitmap = Bitmap(TypeKey<T>());
+    // Tables outside of the buffer, or unaligned, aren't remembered.
+    bool remember = offset < buf_len_ && !(offset % sizeof(uoffset_t));
+    auto index = offset / sizeof(uoffset_t);
+    if (remember && bitmap.Get(index)) return true;
+    Verifier verifier(buf_, buf_len_);
+    verifier.SetShallow(true);
+    if (!table->Verify(verifier)) return false;
+    if (remember) bitmap.Set(index);
+    return true;
+  }
+
+  // Check a string. This is cheap, so it isn't remembered.
+  bool Verify(const String *str) {
+    return Verifier(buf_, buf_len_).Verify(str);
+  }
+
+  // Check a vector, but not the tables or strings it may contain: check those
+  // on access with the functions above. This is cheap, so it isn't
+  // remembered.
+  template<typename T> bool Verify(const Vector<T> *vec) {
+    return Verifier(buf_, buf_len_).Verify(vec);
+  }
+
+ private:
+  // A bit per table, allocated in pages of kPageBits bits as needed.
+  class PagedBitmap {
+   public:
+    static const size_t kPageBits = 1 << 15;
+
+    bool Get(size_t index) const {
+      auto page = index / kPageBits;
+      if (page >= pages_.size() || pages_[page].empty()) return false;
+      auto bit = index % kPageBits;
+      return (pages_[page][bit / 64] >> (bit % 64)) & 1;
+    }
+
+    void Set(size_t index) {
+      auto page = index / kPageBits;
+      if (page >= pages_.size()) pages_.resize(page + 1);
+      if (pages_[page].empty()) pages_[page].resize(kPageBits / 64);
+      auto bit = index % kPageBits;
+      pages_[page][bit / 64] |= static_cast<uint64_t>(1) << (bit % 64);
+    }
+
+   private:
+    std::vector<std::vector<uint64_t>> pages_;
+  };
+
+  // An address unique to each table type.
+  template<typename T> static const void *TypeKey() {
+    static const char key = 0;
+    return &key;
+  }
+
+  PagedBitmap &Bitmap(const void *type_key) {
+    // There are only a few table types, so a linear search is fastest.
+    for (auto it = bitmaps_.begin(); it != bitmaps_.end(); ++it) {
+      if (it->first == type_key) return it->second;
+    }
+    bitmaps_.push_back(std::make_pair(type_key, PagedBitmap()));
+    return bitmaps_.back().second;
+  }
+
+  const uint8_t *buf_;
+  size_t buf_len_;
+  // Separate per table type, a table verified as one type isn't safe to
+  // access as another.
+  std::vector<std::pair<const void *, PagedBitmap>> bitmaps_;
+};
+
 // Convenient way to bundle a buffer and its length, to pass it around
 // typed by its root.
 // A BufferRef does not own its buffer.
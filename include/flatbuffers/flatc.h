@@ -76,9 +76,100 @@ class FlatCompiler {
   std::string GetUsageString(const char *program_name) const;
 
  private:
-  void ParseFile(flatbuffers::Parser &parser, const std::string &filename,
+  // Something to tell the user about one input file. They're kept until the
+  // files before it have been reported, so compiling files in parallel
+  // (--jobs) doesn't change the output.
+  struct Message {
+    enum Kind { kMakeRule, kWarning, kError };
+    Message(Kind k, const std::string &t, bool u, bool s)
+        : kind(k), text(t), usage(u), show_exe_name(s) {}
+
+    Kind kind;
+    std::string text;
+    bool usage;
+    bool show_exe_name;
+  };
+  typedef std::vector<Message> Messages;
+
+  // What Compile() does with every input file.
+  struct Settings {
+    flatbuffers::IDLOptions opts;
+    std::string output_path;
+    std::vector<const char *> include_directories;
+    std::vector<bool> generator_enabled;
+    const flatbuffers::Parser *conform_parser;  // Null without --conform.
+    std::vector<const char *> conform_include_directories;
+    bool print_make_rules;
+    bool grpc_enabled;
+    bool schema_binary;
+  };
+
+  // A compiled schema file. Its parser is kept for the data files that follow
+  // it on the command line.
+  struct SchemaResult {
+    SchemaResult() : keep_parser(false) {}
+
+    std::unique_ptr<flatbuffers::Parser> parser;
+    bool keep_parser;
+    Messages messages;
+  };
+
+  struct SchemaTasks {
+    const FlatCompiler *flatc;
+    const Settings *settings;
+    std::vector<std::pair<const std::string *, SchemaResult *>> schemas;
+  };
+
+  // A schema compared by --conform-dir, with the old and new versions at the
+  // same path in the two directories.
+  struct ConformResult {
+    enum Status { kOk, kAdded, kRemoved, kIncompatible, kInvalid };
+    ConformResult() : status(kOk) {}
+
+    std::string path;
+    Status status;
+    std::vector<std::string> errors;
+  };
+
+  struct ConformTasks {
+    const FlatCompiler *flatc;
+    const Settings *settings;
+    std::string old_dir;
+    std::string new_dir;
+    std::vector<ConformResult> *results;
+  };
+
+  bool ParseFile(flatbuffers::Parser &parser, const std::string &filename,
                  const std::string &contents,
-                 std::vector<const char *> &include_directories) const;
+                 const std::vector<const char *> &include_directories,
+                 Messages *messages) const;
+
+  void CompileSchema(const Settings &settings, const std::string &filename,
+                     SchemaResult *result) const;
+
+  static void CompileSchemaTask(void *context, size_t i);
+
+  // Parses the version of result->path in "dir", returning false and adding
+  // to result->errors if that fails.
+  bool ParseConformSchema(const std::string &dir,
+                          const std::vector<const char *> &include_directories,
+                          flatbuffers::Parser &parser,
+                          ConformResult *result) const;
+
+  void ConformSchema(const ConformTasks &tasks, ConformResult *result) const;
+
+  static void ConformSchemaTask(void *context, size_t i);
+
+  // Checks every schema in "new_dir" against the one at the same path in
+  // "old_dir", printing a line of JSON for each.
+  int ConformDirectories(const Settings &settings, const std::string &old_dir,
+                         const std::string &new_dir, size_t jobs) const;
+
+  bool GenerateFiles(const Settings &settings, flatbuffers::Parser &parser,
+                     const std::string &filename, bool is_schema,
+                     Messages *messages) const;
+
+  void Report(const Messages &messages) const;
 
   void Warn(const std::string &warn, bool show_exe_name = true) const;
 
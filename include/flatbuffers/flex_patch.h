@@ -0,0 +1,319 @@
+/*
+ * Copyright 2018 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLATBUFFERS_FLEX_PATCH_H_
+#define FLATBUFFERS_FLEX_PATCH_H_
+
+#include "flatbuffers/flexbuffers.h"
+
+namespace flexbuffers {
+
+// A batch of updates to values in an existing FlexBuffer, each addressed by a
+// Path (e.g. "users[3].name"). Updates that fit in the space of the old value
+// are written in place, like Reference::MutateInt() etc. do. For the others,
+// the new buffer is a copy of the old one followed by new versions of just
+// the maps and vectors on the way to them: everything else, including the
+// keys of those maps, is referred to where it already is.
+//
+// Updates replace existing values, they don't add keys or elements. Of
+// several updates of the same path the last one wins, but one path can't
+// lead through another (e.g. "a" and "a.b").
+//
+// A Patch can be applied to many buffers, and reuses its memory for each.
+class Patch {
+ public:
+  Patch() : base_(nullptr) {}
+
+  void SetInt(const char *path, int64_t i) { Add(path, TYPE_INT).i = i; }
+  void SetUInt(const char *path, uint64_t u) { Add(path, TYPE_UINT).u = u; }
+  void SetFloat(const char *path, double f) { Add(path, TYPE_FLOAT).f = f; }
+  void SetBool(const char *path, bool b) { Add(path, TYPE_BOOL).u = b; }
+  void SetString(const char *path, const std::string &str) {
+    Add(path, TYPE_STRING).str = str;
+  }
+  void SetNull(const char *path) { Add(path, TYPE_NULL); }
+
+  // The number of updates queued.
+  size_t size() const { return updates_.size(); }
+
+  void Clear() { updates_.clear(); }
+
+  // Applies the updates directly to `buf`, if they all fit. Returns false if
+  // some don't, in which case `buf` has the ones that do and Apply() is
+  // needed for the rest, or if a path doesn't exist (see error()).
+  bool ApplyInPlace(uint8_t *buf, size_t size) {
+    if (!Prepare(buf, size)) return false;
+    auto all_fit = true;
+    for (auto it = order_.begin(); it != order_.end(); ++it) {
+      all_fit = MutateInPlace(updates_[*it], targets_[*it]) && all_fit;
+    }
+    return all_fit;
+  }
+
+  // Writes the updated buffer to `out`. Returns false if a path doesn't
+  // exist, see error().
+  bool Apply(const uint8_t *buf, size_t size, std::vector<uint8_t> *out) {
+    if (!Prepare(buf, size)) return false;
+    out->assign(buf, buf + size);
+    auto copy = flatbuffers::vector_data(*out);
+    auto rebuild = false;
+    for (auto it = order_.begin(); it != order_.end(); ++it) {
+      auto &update = updates_[*it];
+      auto &target = targets_[*it];
+      // The copy is laid out the same, so the target is at the same offset.
+      Reference copied(copy + (target.data_ - buf), target.parent_width_,
+                       target.byte_width_, target.type_);
+      update.in_place = MutateInPlace(update, copied);
+      rebuild = rebuild || !update.in_place;
+    }
+    if (!rebuild) return true;
+    // Build the new maps and vectors after the copy, reading the old ones
+    // from `buf`.
+    builder_.Clear();
+    builder_.buf_.swap(*out);
+    base_ = buf;
+    RebuildValue(GetRoot(buf, size), 0, 0, order_.size());
+    builder_.Finish();
+    builder_.buf_.swap(*out);
+    builder_.Clear();
+    return true;
+  }
+
+  // Why the last Apply() or ApplyInPlace() failed.
+  const std::string &error() const { return error_; }
+
+ private:
+  struct Update {
+    Update(const char *path_text, Type t)
+        : path(path_text),
+          text(path_text),
+          type(t),
+          u(0),
+          in_place(false) {}
+
+    Path path;
+    std::string text;
+    Type type;
+    union {
+      int64_t i;
+      uint64_t u;
+      double f;
+    };
+    std::string str;
+    // Where in the buffer it goes: the index of each step in its parent.
+    std::vector<size_t> indices;
+    bool in_place;
+  };
+
+  Update &Add(const char *path, Type type) {
+    updates_.push_back(Update(path, type));
+    return updates_.back();
+  }
+
+  bool Error(const Update &update, const char *msg) {
+    error_ = msg;
+    error_ += ": ";
+    error_ += update.text;
+    return false;
+  }
+
+  // Finds the target of each update, and puts them in `order_` sorted by
+  // where they are in the buffer, leaving out all but the last update of
+  // each path.
+  bool Prepare(const uint8_t *buf, size_t size) {
+    error_.clear();
+    order_.clear();
+    targets_.clear();
+    auto root = GetRoot(buf, size);
+    for (size_t i = 0; i < updates_.size(); i++) {
+      auto &update = updates_[i];
+      if (!update.path.valid()) return Error(update, "invalid path");
+      update.indices.clear();
+      auto node = root;
+      for (auto it = update.path.steps_.begin();
+           it != update.path.steps_.end(); ++it) {
+        size_t index;
+        if (!Path::Descend(*it, &node, &index))
+          return Error(update, "no such value");
+        update.indices.push_back(index);
+      }
+      targets_.push_back(node);
+      order_.push_back(i);
+    }
+    auto &updates = updates_;
+    std::stable_sort(order_.begin(), order_.end(),
+                     [&updates](size_t a, size_t b) {
+                       return updates[a].indices < updates[b].indices;
+                     });
+    size_t kept = 0;
+    for (size_t i = 0; i < order_.size(); i++) {
+      auto &indices = updates_[order_[i]].indices;
+      if (i + 1 < order_.size()) {
+        auto &next = updates_[order_[i + 1]].indices;
+        // Stable sorting keeps the later update of a path last.
+        if (indices == next) continue;
+        // Anything below a path sorts directly after it.
+        if (indices.size() < next.size() &&
+            std::equal(indices.begin(), indices.end(), next.begin()))
+          return Error(updates_[order_[i + 1]], "path inside another update");
+      }
+      order_[kept++] = order_[i];
+    }
+    order_.resize(kept);
+    return true;
+  }
+
+  // Only writes values of the same type in place, so e.g. an int doesn't
+  // silently turn into an uint.
+  static bool MutateInPlace(const Update &update, Reference target) {
+    auto type = target.GetType();
+    switch (update.type) {
+      case TYPE_INT:
+        return (type == TYPE_INT || type == TYPE_INDIRECT_INT) &&
+               target.MutateInt(update.i);
+      case TYPE_UINT:
+        return (type == TYPE_UINT || type == TYPE_INDIRECT_UINT) &&
+               target.MutateUInt(update.u);
+      case TYPE_FLOAT:
+        return (type == TYPE_FLOAT || type == TYPE_INDIRECT_FLOAT) &&
+               target.MutateFloat(update.f);
+      case TYPE_BOOL: return target.MutateBool(update.u != 0);
+      case TYPE_STRING:
+        return type == TYPE_STRING && target.MutateString(update.str);
+      case TYPE_NULL: return type == TYPE_NULL;
+      default: assert(false); return false;
+    }
+  }
+
+  // Adds `node` to the builder's stack, updated with the updates from
+  // order_[lo] to order_[hi], which are all inside it. Their paths are
+  // `depth` steps long up to `node`.
+  void RebuildValue(Reference node, size_t depth, size_t lo, size_t hi) {
+    if (lo == hi) return Reuse(node);
+    auto &first = updates_[order_[lo]];
+    if (first.indices.size() == depth) {
+      // An update of `node` itself. If it was done in place, it's already in
+      // the copy, unless `node` is stored inline in its parent.
+      if (!first.in_place || IsInline(node.type_)) return Push(first);
+      return Reuse(node);
+    }
+    auto rebuild = false;
+    for (auto i = lo; i < hi; i++) {
+      rebuild = rebuild || !updates_[order_[i]].in_place;
+    }
+    if (!rebuild) return Reuse(node);
+    auto start = builder_.stack_.size();
+    auto type = node.type_;
+    if (type == TYPE_MAP) {
+      auto map = node.AsMap();
+      auto keys = map.Keys();
+      RebuildElements(map.Values(), map.size(), depth, lo, hi);
+      // Same keys, so the map can use the keys vector it has.
+      Builder::Value keys_vector(
+          static_cast<uint64_t>(keys.data_ - base_), TYPE_VECTOR_KEY,
+          Builder::WidthB(keys.byte_width_));
+      EndVector(start, false, false, &keys_vector);
+    } else if (type == TYPE_VECTOR) {
+      auto vec = node.AsVector();
+      RebuildElements(vec, vec.size(), depth, lo, hi);
+      EndVector(start, false, false, nullptr);
+    } else if (IsTypedVector(type)) {
+      auto vec = node.AsTypedVector();
+      RebuildElements(vec, vec.size(), depth, lo, hi);
+      // Stays typed if the elements still have its type.
+      EndVector(start, IsOfType(start, ToTypedVectorElementType(type)), false,
+                nullptr);
+    } else {
+      assert(IsFixedTypedVector(type));
+      auto vec = node.AsFixedTypedVector();
+      uint8_t len;
+      auto elem_type = ToFixedTypedVectorElementType(type, &len);
+      RebuildElements(vec, len, depth, lo, hi);
+      auto typed = IsOfType(start, elem_type);
+      EndVector(start, typed, typed, nullptr);
+    }
+  }
+
+  template<typename V>
+  void RebuildElements(const V &vec, size_t len, size_t depth, size_t lo,
+                       size_t hi) {
+    auto pos = lo;
+    for (size_t i = 0; i < len; i++) {
+      auto end = pos;
+      while (end < hi && updates_[order_[end]].indices[depth] == i) end++;
+      RebuildValue(vec[i], depth + 1, pos, end);
+      pos = end;
+    }
+  }
+
+  bool IsOfType(size_t start, Type type) const {
+    auto &stack = builder_.stack_;
+    for (auto i = start; i < stack.size(); i++) {
+      if (stack[i].type_ != type) return false;
+    }
+    return true;
+  }
+
+  void EndVector(size_t start, bool typed, bool fixed,
+                 const Builder::Value *keys) {
+    auto &stack = builder_.stack_;
+    auto vec = builder_.CreateVector(start, stack.size() - start, 1, typed,
+                                     fixed, keys);
+    stack.resize(start);
+    stack.push_back(vec);
+  }
+
+  // Adds an unchanged value, referring to the old data rather than copying
+  // it where it isn't inline.
+  void Reuse(const Reference &value) {
+    switch (value.type_) {
+      case TYPE_NULL: builder_.Null(); break;
+      case TYPE_INT: builder_.Int(value.AsInt64()); break;
+      case TYPE_UINT: builder_.UInt(value.AsUInt64()); break;
+      case TYPE_FLOAT: builder_.Double(value.AsDouble()); break;
+      case TYPE_BOOL: builder_.Bool(value.AsBool()); break;
+      default:
+        builder_.stack_.push_back(Builder::Value(
+            static_cast<uint64_t>(value.Indirect() - base_), value.type_,
+            Builder::WidthB(value.byte_width_)));
+        break;
+    }
+  }
+
+  void Push(const Update &update) {
+    switch (update.type) {
+      case TYPE_INT: builder_.Int(update.i); break;
+      case TYPE_UINT: builder_.UInt(update.u); break;
+      case TYPE_FLOAT: builder_.Double(update.f); break;
+      case TYPE_BOOL: builder_.Bool(update.u != 0); break;
+      case TYPE_STRING: builder_.String(update.str); break;
+      case TYPE_NULL: builder_.Null(); break;
+      default: assert(false); break;
+    }
+  }
+
+  std::vector<Update> updates_;
+  // Scratch state of the buffer being patched.
+  std::vector<size_t> order_;
+  std::vector<Reference> targets_;
+  const uint8_t *base_;
+  Builder builder_;
+  std::string error_;
+};
+
+}  // namespace flexbuffers
+
+#endif  // FLATBUFFERS_FLEX_PATCH_H_
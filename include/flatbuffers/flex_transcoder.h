@@ -0,0 +1,584 @@
+/*
+ * Copyright 2018 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLATBUFFERS_FLEX_TRANSCODER_H_
+#define FLATBUFFERS_FLEX_TRANSCODER_H_
+
+#include "flatbuffers/flexbuffers.h"
+#include "flatbuffers/hash.h"
+#include "flatbuffers/reflection.h"
+
+namespace flatbuffers {
+
+// Converts FlexBuffers to FlatBuffers of the types of a binary schema (see
+// reflection.h) directly, rather than through JSON text. The values are
+// expected to be shaped like the JSON for the same data: a map of field names
+// to values for a table or struct, a vector for a vector, and a number or bool
+// for a scalar. Like in JSON, a scalar may also be a string holding a number,
+// an enum value may be given by name, and a `null` field is left out. A union
+// is written as its type (number or name) under the key `<field>_type`, and
+// its table under the field name. Binary schemas don't store the `hash` and
+// `bit_flags` attributes, so unlike in JSON, such fields can't be given as
+// a string to hash, or as a list of flag names.
+//
+// The schema is compiled into a plan per type up front, which maps the keys of
+// a map to fields by walking both in sorted order. A transcoder is meant to be
+// kept around and reused: it keeps its scratch memory between conversions.
+class FlexTranscoder {
+ public:
+  // `schema` must outlive the transcoder. Map keys that don't name a field
+  // are an error, unless `skip_unknown_fields` is set.
+  explicit FlexTranscoder(const reflection::Schema &schema,
+                          bool skip_unknown_fields = false)
+      : schema_(schema), skip_unknown_fields_(skip_unknown_fields) {
+    auto objects = schema.objects();
+    objects_.resize(objects->size());
+    for (uoffset_t i = 0; i < objects->size(); i++) {
+      auto &plan = objects_[i];
+      plan.def = objects->Get(i);
+      plan.num_required = 0;
+      auto fields = plan.def->fields();
+      for (auto it = fields->begin(); it != fields->end(); ++it) {
+        if (it->deprecated()) continue;
+        plan.fields.push_back(FieldPlan(**it));
+        if (it->required()) plan.num_required++;
+      }
+    }
+    auto enums = schema.enums();
+    enums_.resize(enums->size());
+    for (uoffset_t i = 0; i < enums->size(); i++) {
+      auto &plan = enums_[i];
+      plan.def = enums->Get(i);
+      auto values = plan.def->values();
+      for (uoffset_t j = 0; j < values->size(); j++) {
+        plan.by_name.push_back(values->Get(j));
+      }
+      std::sort(plan.by_name.begin(), plan.by_name.end(), EnumNameLess);
+    }
+  }
+
+  // Converts `root` to the schema's root table and finishes `fbb` with it.
+  // On failure returns false and sets error(); `fbb` may then hold part of
+  // the conversion, and should be cleared before reuse.
+  bool Transcode(FlatBufferBuilder &fbb, flexbuffers::Reference root) {
+    auto root_table = schema_.root_table();
+    if (!root_table) return Error("schema has no root type");
+    Offset<Table> table;
+    if (!TranscodeTable(fbb, root, *root_table, &table)) return false;
+    auto ident = schema_.file_ident();
+    fbb.Finish(table, ident && ident->size() ? ident->c_str() : nullptr);
+    return true;
+  }
+
+  // Converts `value` to a table of type `object`, which must be one of the
+  // schema's objects.
+  bool TranscodeTable(FlatBufferBuilder &fbb, flexbuffers::Reference value,
+                      const reflection::Object &object, Offset<Table> *table) {
+    error_.clear();
+    for (size_t i = 0; i < objects_.size(); i++) {
+      if (objects_[i].def == &object) {
+        uoffset_t offset;
+        if (!BuildTable(fbb, value, objects_[i], &offset)) return false;
+        *table = Offset<Table>(offset);
+        return true;
+      }
+    }
+    return Error("object is not part of the schema");
+  }
+
+  const std::string &error() const { return error_; }
+
+ private:
+  struct FieldPlan {
+    explicit FieldPlan(const reflection::Field &f)
+        : def(&f),
+          name(f.name()->c_str()),
+          type(f.type()->base_type()),
+          element(f.type()->element()),
+          index(f.type()->index()) {
+      if (type == reflection::Union)
+        type_key = std::string(name) + UnionTypeFieldSuffix();
+    }
+
+    const reflection::Field *def;
+    const char *name;
+    reflection::BaseType type;
+    reflection::BaseType element;  // For vectors.
+    // The object (of tables, structs and vectors of them) or enum (of
+    // scalars, unions and their vectors) of the field, or -1.
+    int index;
+    std::string type_key;  // For unions, the key of their type.
+  };
+
+  struct ObjectPlan {
+    const reflection::Object *def;
+    // The non-deprecated fields, sorted by name like the keys of a map.
+    std::vector<FieldPlan> fields;
+    size_t num_required;
+  };
+
+  struct EnumPlan {
+    const reflection::Enum *def;
+    std::vector<const reflection::EnumVal *> by_name;
+  };
+
+  static bool EnumNameLess(const reflection::EnumVal *a,
+                           const reflection::EnumVal *b) {
+    return strcmp(a->name()->c_str(), b->name()->c_str()) < 0;
+  }
+
+  // A table field being converted, until the table itself can be started.
+  struct Entry {
+    const FieldPlan *field;
+    size_t align;
+    int64_t i;     // Integer scalars.
+    double f;      // Floating point scalars.
+    uoffset_t o;   // Strings, vectors, tables and unions.
+    size_t bytes;  // Structs: where their data is in bytes_.
+  };
+
+  bool Error(const std::string &msg) {
+    error_ = msg;
+    return false;
+  }
+
+  bool Error(const ObjectPlan &object, const FieldPlan &field,
+             const char *msg) {
+    return Error(object.def->name()->str() + "." + field.name + ": " + msg);
+  }
+
+  // Finds the field for `key`. Since both the keys of a map and the fields
+  // are sorted, `next` carries on from the previous key's field. Returns null
+  // for a key that doesn't name a field, and sets `ok` to false unless such
+  // keys are skipped.
+  const FieldPlan *MatchField(const ObjectPlan &object, const char *key,
+                              size_t *next, bool *ok) {
+    auto &fields = object.fields;
+    auto &j = *next;
+    int comp = 1;
+    while (j < fields.size() && (comp = strcmp(fields[j].name, key)) < 0) j++;
+    if (j == fields.size() || comp) {
+      if (!skip_unknown_fields_)
+        *ok = Error(object.def->name()->str() + ": unknown field: " + key);
+      return nullptr;
+    }
+    return &fields[j++];
+  }
+
+  bool BuildTable(FlatBufferBuilder &fbb, flexbuffers::Reference value,
+                  const ObjectPlan &object, uoffset_t *offset) {
+    if (!value.IsMap())
+      return Error(object.def->name()->str() + ": table must be a map");
+    if (object.def->is_struct())
+      return Error(object.def->name()->str() + ": is a struct, not a table");
+    auto map = value.AsMap();
+    // Create all sub-objects first, since they can't be made once the table
+    // has been started.
+    auto base = entries_.size();
+    auto bytes_base = bytes_.size();
+    size_t num_required = 0;
+    auto keys = map.Keys();
+    auto values = map.Values();
+    size_t next = 0;
+    auto ok = true;
+    for (size_t i = 0; ok && i < keys.size(); i++) {
+      auto field = MatchField(object, keys[i].AsKey(), &next, &ok);
+      if (!field || values[i].IsNull()) continue;
+      ok = AddEntry(fbb, map, object, *field, values[i]);
+      if (field->def->required()) num_required++;
+    }
+    if (ok && num_required != object.num_required) {
+      for (auto it = object.fields.begin(); it != object.fields.end(); ++it) {
+        if (it->def->required() && map[it->name].IsNull()) {
+          ok = Error(object, *it, "required field is missing");
+          break;
+        }
+      }
+    }
+    if (!ok) {
+      entries_.resize(base);
+      bytes_.resize(bytes_base);
+      return false;
+    }
+    // Add the largest fields first, to need the least padding.
+    auto start = fbb.StartTable();
+    for (size_t align = FLATBUFFERS_MAX_ALIGNMENT; align; align /= 2) {
+      for (auto i = base; i < entries_.size(); i++) {
+        auto &e = entries_[i];
+        if (e.align != align) continue;
+        auto &field = *e.field;
+        auto voffset = field.def->offset();
+        switch (field.type) {
+          case reflection::String:
+          case reflection::Vector:
+          case reflection::Union:
+            fbb.AddOffset(voffset, Offset<void>(e.o));
+            break;
+          case reflection::Obj: {
+            auto &sub = *objects_[field.index].def;
+            if (!sub.is_struct()) {
+              fbb.AddOffset(voffset, Offset<void>(e.o));
+              break;
+            }
+            fbb.Align(align);
+            fbb.PushBytes(&bytes_[e.bytes], sub.bytesize());
+            fbb.TrackField(voffset, fbb.GetSize());
+            break;
+          }
+          default: AddScalar(fbb, e); break;
+        }
+      }
+    }
+    *offset = fbb.EndTable(start);
+    entries_.resize(base);
+    bytes_.resize(bytes_base);
+    return true;
+  }
+
+  // Converts the (non-null) field `v` of `map` for the table being built,
+  // storing the result in entries_.
+  bool AddEntry(FlatBufferBuilder &fbb, const flexbuffers::Map &map,
+                const ObjectPlan &object, const FieldPlan &field,
+                flexbuffers::Reference v) {
+    Entry e;
+    e.field = &field;
+    e.i = 0;
+    e.f = 0;
+    e.o = 0;
+    e.bytes = 0;
+    switch (field.type) {
+      case reflection::String:
+        if (!v.IsString()) return Error(object, field, "expected a string");
+        e.o = fbb.CreateString(v.AsString().c_str(), v.AsString().length()).o;
+        e.align = sizeof(uoffset_t);
+        break;
+      case reflection::Vector:
+        if (!BuildVector(fbb, v, object, field, &e.o)) return false;
+        e.align = sizeof(uoffset_t);
+        break;
+      case reflection::Union: {
+        auto type_value = map[field.type_key.c_str()];
+        if (type_value.IsNull())
+          return Error(object, field, "missing union type");
+        int64_t type;
+        if (!ConvertScalar(object, field, reflection::UType, type_value,
+                           &type, nullptr))
+          return false;
+        auto enumval = enums_[field.index].def->values()->LookupByKey(type);
+        if (!type || !enumval || !enumval->union_type() ||
+            enumval->union_type()->index() < 0)
+          return Error(object, field, "unknown union type");
+        auto &sub = objects_[enumval->union_type()->index()];
+        if (!BuildTable(fbb, v, sub, &e.o)) return false;
+        e.align = sizeof(uoffset_t);
+        break;
+      }
+      case reflection::Obj: {
+        auto &sub = objects_[field.index];
+        if (sub.def->is_struct()) {
+          e.bytes = bytes_.size();
+          bytes_.resize(bytes_.size() + sub.def->bytesize(), 0);
+          if (!BuildStruct(v, sub, e.bytes)) return false;
+          e.align = static_cast<size_t>(sub.def->minalign());
+        } else {
+          if (!BuildTable(fbb, v, sub, &e.o)) return false;
+          e.align = sizeof(uoffset_t);
+        }
+        break;
+      }
+      default:
+        if (!ConvertScalar(object, field, field.type, v, &e.i, &e.f))
+          return false;
+        e.align = GetTypeSize(field.type);
+        break;
+    }
+    entries_.push_back(e);
+    return true;
+  }
+
+  // Writes the struct in `value` to bytes_ at `at`.
+  bool BuildStruct(flexbuffers::Reference value, const ObjectPlan &object,
+                   size_t at) {
+    if (!value.IsMap())
+      return Error(object.def->name()->str() + ": struct must be a map");
+    auto map = value.AsMap();
+    auto keys = map.Keys();
+    auto values = map.Values();
+    size_t next = 0;
+    size_t num_fields = 0;
+    auto ok = true;
+    for (size_t i = 0; ok && i < keys.size(); i++) {
+      auto field = MatchField(object, keys[i].AsKey(), &next, &ok);
+      if (!field) continue;
+      num_fields++;
+      auto dest = at + field->def->offset();
+      if (field->type == reflection::Obj) {
+        ok = BuildStruct(values[i], objects_[field->index], dest);
+        continue;
+      }
+      int64_t iv;
+      double fv;
+      ok = ConvertScalar(object, *field, field->type, values[i], &iv, &fv);
+      if (ok) StoreScalar(field->type, &bytes_[dest], iv, fv);
+    }
+    if (ok && num_fields != object.fields.size()) {
+      return Error(object.def->name()->str() +
+                   ": all fields of a struct must be given");
+    }
+    return ok;
+  }
+
+  bool BuildVector(FlatBufferBuilder &fbb, flexbuffers::Reference value,
+                   const ObjectPlan &object, const FieldPlan &field,
+                   uoffset_t *offset) {
+    auto type = value.GetType();
+    if (type == flexbuffers::TYPE_BLOB && (field.element == reflection::UByte ||
+                                           field.element == reflection::Byte)) {
+      auto blob = value.AsBlob();
+      *offset = fbb.CreateVector(blob.data(), blob.size()).o;
+      return true;
+    }
+    if (type == flexbuffers::TYPE_VECTOR) {
+      auto vec = value.AsVector();
+      return BuildVectorElements(fbb, vec, vec.size(), object, field, offset);
+    }
+    if (flexbuffers::IsTypedVector(type)) {
+      auto vec = value.AsTypedVector();
+      return BuildVectorElements(fbb, vec, vec.size(), object, field, offset);
+    }
+    if (flexbuffers::IsFixedTypedVector(type)) {
+      auto vec = value.AsFixedTypedVector();
+      return BuildVectorElements(fbb, vec, vec.size(), object, field, offset);
+    }
+    return Error(object, field, "expected a vector");
+  }
+
+  template<typename V>
+  bool BuildVectorElements(FlatBufferBuilder &fbb, const V &vec, size_t len,
+                           const ObjectPlan &object, const FieldPlan &field,
+                           uoffset_t *offset) {
+    auto offsets_base = offsets_.size();
+    auto bytes_base = bytes_.size();
+    switch (field.element) {
+      case reflection::String:
+      case reflection::Obj:
+        if (field.element == reflection::Obj &&
+            objects_[field.index].def->is_struct()) {
+          auto &sub = objects_[field.index];
+          auto size = static_cast<size_t>(sub.def->bytesize());
+          bytes_.resize(bytes_base + len * size, 0);
+          for (size_t i = 0; i < len; i++) {
+            if (!BuildStruct(vec[i], sub, bytes_base + i * size)) {
+              bytes_.resize(bytes_base);
+              return false;
+            }
+          }
+          // Like CreateVectorOfStructs(), this aligns to the struct.
+          auto align = static_cast<size_t>(sub.def->minalign());
+          fbb.StartVector(len * size / align, align);
+          if (len) fbb.PushBytes(&bytes_[bytes_base], len * size);
+          *offset = fbb.EndVector(len);
+          bytes_.resize(bytes_base);
+          return true;
+        }
+        for (size_t i = 0; i < len; i++) {
+          auto elem = vec[i];
+          uoffset_t o;
+          if (field.element == reflection::String) {
+            if (!elem.IsString()) {
+              offsets_.resize(offsets_base);
+              return Error(object, field, "expected a vector of strings");
+            }
+            o = fbb.CreateString(elem.AsString().c_str(),
+                                 elem.AsString().length())
+                    .o;
+          } else if (!BuildTable(fbb, elem, objects_[field.index], &o)) {
+            offsets_.resize(offsets_base);
+            return false;
+          }
+          offsets_.push_back(o);
+        }
+        fbb.StartVector(len, sizeof(uoffset_t));
+        for (auto i = len; i > 0; i--) {
+          fbb.PushElement(Offset<void>(offsets_[offsets_base + i - 1]));
+        }
+        *offset = fbb.EndVector(len);
+        offsets_.resize(offsets_base);
+        return true;
+      case reflection::Union:
+      case reflection::Vector:
+        return Error(object, field, "vectors of unions are not supported");
+      default: {
+        auto size = GetTypeSize(field.element);
+        bytes_.resize(bytes_base + len * size, 0);
+        for (size_t i = 0; i < len; i++) {
+          int64_t iv;
+          double fv;
+          if (!ConvertScalar(object, field, field.element, vec[i], &iv, &fv)) {
+            bytes_.resize(bytes_base);
+            return false;
+          }
+          StoreScalar(field.element, &bytes_[bytes_base + i * size], iv, fv);
+        }
+        fbb.StartVector(len, size);
+        if (len) fbb.PushBytes(&bytes_[bytes_base], len * size);
+        *offset = fbb.EndVector(len);
+        bytes_.resize(bytes_base);
+        return true;
+      }
+    }
+  }
+
+  // Converts `value` to a scalar of `type`, in `i` for integers or `f` for
+  // floating point types.
+  bool ConvertScalar(const ObjectPlan &object, const FieldPlan &field,
+                     reflection::BaseType type, flexbuffers::Reference value,
+                     int64_t *i, double *f) {
+    auto is_float = IsFloat(type);
+    if (value.IsString() || value.IsKey()) {
+      auto str = value.IsKey() ? value.AsKey() : value.AsString().c_str();
+      char *end = nullptr;
+      if (is_float) {
+        *f = strtod(str, &end);
+      } else if (type == reflection::ULong) {
+        *i = static_cast<int64_t>(StringToUInt(str, &end));
+      } else {
+        *i = StringToInt(str, &end);
+      }
+      if (end == str || *end) {
+        if (field.index < 0 || is_float || !EnumValue(field, str, i))
+          return Error(object, field, "expected a number or enum value");
+      }
+    } else if (value.IsNumeric() || value.IsBool()) {
+      if (is_float) {
+        *f = value.AsDouble();
+      } else if (value.IsFloat()) {
+        // Converting NaN, or a double past the range of the integer type, is
+        // undefined, so check first (this is also false for NaN).
+        auto d = value.AsDouble();
+        if (type == reflection::ULong) {
+          if (!(d > -1.0 && d < 18446744073709551616.0))
+            return Error(object, field, "value out of range");
+          *i = static_cast<int64_t>(static_cast<uint64_t>(d));
+        } else {
+          if (!(d >= -9223372036854775808.0 && d < 9223372036854775808.0))
+            return Error(object, field, "value out of range");
+          *i = static_cast<int64_t>(d);
+        }
+      } else if (type == reflection::ULong || value.IsUInt()) {
+        auto u = value.AsUInt64();
+        // Only a ulong holds what doesn't fit in an int64_t.
+        if (type != reflection::ULong &&
+            u > static_cast<uint64_t>(numeric_limits<int64_t>::max()))
+          return Error(object, field, "value out of range");
+        *i = static_cast<int64_t>(u);
+      } else {
+        *i = value.AsInt64();
+      }
+    } else if (value.IsNull()) {
+      return Error(object, field, "missing value");
+    } else {
+      return Error(object, field, "expected a scalar");
+    }
+    if (!is_float && !InRange(type, *i))
+      return Error(object, field, "value out of range");
+    return true;
+  }
+
+  bool EnumValue(const FieldPlan &field, const char *name, int64_t *value) {
+    auto &plan = enums_[field.index];
+    // Only the name is compared, so any EnumVal will do for the key.
+    auto key = plan.def->values()->Get(0);
+    auto it = std::lower_bound(
+        plan.by_name.begin(), plan.by_name.end(), key,
+        [&](const reflection::EnumVal *a, const reflection::EnumVal *) {
+          return strcmp(a->name()->c_str(), name) < 0;
+        });
+    if (it == plan.by_name.end() || strcmp((*it)->name()->c_str(), name))
+      return false;
+    *value = (*it)->value();
+    return true;
+  }
+
+  static bool InRange(reflection::BaseType type, int64_t i) {
+    // clang-format off
+    #define FLATBUFFERS_RANGE(T) \
+      return i >= static_cast<int64_t>(numeric_limits<T>::min()) && \
+             i <= static_cast<int64_t>(numeric_limits<T>::max())
+    switch (type) {
+      case reflection::UType:
+      case reflection::UByte:  FLATBUFFERS_RANGE(uint8_t);
+      case reflection::Bool:   return i == 0 || i == 1;
+      case reflection::Byte:   FLATBUFFERS_RANGE(int8_t);
+      case reflection::Short:  FLATBUFFERS_RANGE(int16_t);
+      case reflection::UShort: FLATBUFFERS_RANGE(uint16_t);
+      case reflection::Int:    FLATBUFFERS_RANGE(int32_t);
+      case reflection::UInt:   FLATBUFFERS_RANGE(uint32_t);
+      default:                 return true;  // 64 bit.
+    }
+    #undef FLATBUFFERS_RANGE
+    // clang-format on
+  }
+
+  static void StoreScalar(reflection::BaseType type, uint8_t *dest, int64_t i,
+                          double f) {
+    if (IsFloat(type))
+      SetAnyValueF(type, dest, f);
+    else
+      SetAnyValueI(type, dest, i);
+  }
+
+  static void AddScalar(FlatBufferBuilder &fbb, const Entry &e) {
+    auto &field = *e.field->def;
+    auto voffset = field.offset();
+    auto def_i = field.default_integer();
+    auto def_f = field.default_real();
+    // clang-format off
+    #define FLATBUFFERS_ADD(T, V, D) \
+      fbb.AddElement<T>(voffset, static_cast<T>(V), static_cast<T>(D)); break
+    switch (e.field->type) {
+      case reflection::UType:
+      case reflection::Bool:
+      case reflection::UByte:  FLATBUFFERS_ADD(uint8_t, e.i, def_i);
+      case reflection::Byte:   FLATBUFFERS_ADD(int8_t, e.i, def_i);
+      case reflection::Short:  FLATBUFFERS_ADD(int16_t, e.i, def_i);
+      case reflection::UShort: FLATBUFFERS_ADD(uint16_t, e.i, def_i);
+      case reflection::Int:    FLATBUFFERS_ADD(int32_t, e.i, def_i);
+      case reflection::UInt:   FLATBUFFERS_ADD(uint32_t, e.i, def_i);
+      case reflection::Long:   FLATBUFFERS_ADD(int64_t, e.i, def_i);
+      case reflection::ULong:  FLATBUFFERS_ADD(uint64_t, e.i, def_i);
+      case reflection::Float:  FLATBUFFERS_ADD(float, e.f, def_f);
+      case reflection::Double: FLATBUFFERS_ADD(double, e.f, def_f);
+      default: break;
+    }
+    #undef FLATBUFFERS_ADD
+    // clang-format on
+  }
+
+  const reflection::Schema &schema_;
+  bool skip_unknown_fields_;
+  std::vector<ObjectPlan> objects_;
+  std::vector<EnumPlan> enums_;
+  std::string error_;
+  // Scratch space, used as stacks by nested tables.
+  std::vector<Entry> entries_;
+  std::vector<uint8_t> bytes_;
+  std::vector<uoffset_t> offsets_;
+};
+
+}  // namespace flatbuffers
+
+#endif  // FLATBUFFERS_FLEX_TRANSCODER_H_
@@ -22,6 +22,7 @@
 #include "flatbuffers/base.h"
 // We use the basic binary writing functions from the regular FlatBuffers.
 #include "flatbuffers/util.h"
+#include "flatbuffers/hash.h"
 
 #ifdef _MSC_VER
 #  include <intrin.h>
@@ -36,6 +37,10 @@ namespace flexbuffers {
 
 class Reference;
 class Map;
+class CachedKey;
+class Path;
+class PathSet;
+class Patch;
 
 // These are used in the lower 2 bits of a type field to determine the size of
 // the elements (and or size field) of the item pointed to (e.g. vector).
@@ -208,6 +213,8 @@ class Object {
       : data_(data), byte_width_(byte_width) {}
 
  protected:
+  friend class Patch;
+
   const uint8_t *data_;
   uint8_t byte_width_;
 };
@@ -269,6 +276,15 @@ class TypedVector : public Sized {
 
   Reference operator[](size_t i) const;
 
+  // Copies up to `max` elements to `dest`, converted to T like As<T>() does,
+  // and returns how many it copied. Numeric elements are converted in bulk,
+  // which is much faster than reading them one by one.
+  template<typename T> size_t CopyTo(T *dest, size_t max) const;
+
+  // The elements, if they are stored as T exactly (the same size and kind of
+  // number), else nullptr.
+  template<typename T> const T *Data() const;
+
   static TypedVector EmptyTypedVector() {
     static const uint8_t empty_typed_vector[] = { 0 /*len*/ };
     return TypedVector(empty_typed_vector + 1, 1, TYPE_INT);
@@ -293,6 +309,10 @@ class FixedTypedVector : public Object {
 
   Reference operator[](size_t i) const;
 
+  // See TypedVector.
+  template<typename T> size_t CopyTo(T *dest, size_t max) const;
+  template<typename T> const T *Data() const;
+
   static FixedTypedVector EmptyFixedTypedVector() {
     static const uint8_t fixed_empty_vector[] = { 0 /* unused */ };
     return FixedTypedVector(fixed_empty_vector, 1, TYPE_INT, 0);
@@ -315,6 +335,8 @@ class Map : public Vector {
 
   Reference operator[](const char *key) const;
   Reference operator[](const std::string &key) const;
+  // Remembers where `key` was found for the next map it is used with.
+  Reference operator[](CachedKey &key) const;
 
   Vector Values() const { return Vector(data_, byte_width_); }
 
@@ -335,6 +357,48 @@ class Map : public Vector {
   }
 
   bool IsTheEmptyMap() const { return data_ == EmptyMap().data_; }
+
+  // True if the map was built with BUILDER_FLAG_HASH_MAP_KEYS, so lookups
+  // don't need a binary search.
+  bool HasKeyHashes() const { return KeyHashSlots(Keys()) != nullptr; }
+
+ private:
+  friend class Path;
+
+  const uint8_t *KeyHashSlots(const TypedVector &keys) const;
+  // These return the index of `key` in `keys`, or keys.size() if it's not
+  // in the map.
+  size_t HashedKeyIndex(const TypedVector &keys, const uint8_t *slots,
+                        const char *key, uint32_t hash) const;
+  size_t SortedKeyIndex(const TypedVector &keys, const char *key) const;
+  size_t KeyIndex(const TypedVector &keys, const char *key,
+                  uint32_t hash) const {
+    auto slots = KeyHashSlots(keys);
+    return slots ? HashedKeyIndex(keys, slots, key, hash)
+                 : SortedKeyIndex(keys, key);
+  }
+  static const char *KeyAt(const TypedVector &keys, size_t i) {
+    return reinterpret_cast<const char *>(
+        Indirect(keys.data_ + i * keys.byte_width_, keys.byte_width_));
+  }
+};
+
+// A key to look up in many maps, e.g. the same field of every element of a
+// vector of maps. It remembers its index in the last map it was found in, so
+// maps with the same keys find it again with a single string comparison.
+// `key` must outlive it.
+class CachedKey {
+ public:
+  explicit CachedKey(const char *key);
+
+  const char *c_str() const { return key_; }
+
+ private:
+  friend class Map;
+
+  const char *key_;
+  uint32_t hash_;
+  size_t index_;
 };
 
 class Reference {
@@ -529,13 +593,14 @@ class Reference {
       }
       s += " }";
     } else if (IsVector()) {
-      s += "[ ";
       auto v = AsVector();
-      for (size_t i = 0; i < v.size(); i++) {
-        v[i].ToString(true, keys_quoted, s);
-        if (i < v.size() - 1) s += ", ";
-      }
-      s += " ]";
+      ElementsToString(v, v.size(), keys_quoted, s);
+    } else if (IsTypedVector(type_)) {
+      auto v = AsTypedVector();
+      ElementsToString(v, v.size(), keys_quoted, s);
+    } else if (IsFixedTypedVector(type_)) {
+      auto v = AsFixedTypedVector();
+      ElementsToString(v, v.size(), keys_quoted, s);
     } else {
       s += "(?)";
     }
@@ -667,10 +732,23 @@ class Reference {
   }
 
  private:
+  friend class Patch;
+
   const uint8_t *Indirect() const {
     return flexbuffers::Indirect(data_, parent_width_);
   }
 
+  template<typename V>
+  static void ElementsToString(const V &v, size_t len, bool keys_quoted,
+                               std::string &s) {
+    s += "[ ";
+    for (size_t i = 0; i < len; i++) {
+      v[i].ToString(true, keys_quoted, s);
+      if (i < len - 1) s += ", ";
+    }
+    s += " ]";
+  }
+
   template<typename T>
   bool Mutate(const uint8_t *dest, T t, size_t byte_width,
               BitWidth value_width) {
@@ -765,6 +843,241 @@ inline Reference FixedTypedVector::operator[](size_t i) const {
   return Reference(elem, byte_width_, 1, type_);
 }
 
+// clang-format off
+#if defined(FLATBUFFERS_SIMD_SSE2)
+  inline void Widen32To64(__m128i v, bool is_signed, __m128i *out) {
+    auto ext = is_signed ? _mm_srai_epi32(v, 31) : _mm_setzero_si128();
+    _mm_storeu_si128(out, _mm_unpacklo_epi32(v, ext));
+    _mm_storeu_si128(out + 1, _mm_unpackhi_epi32(v, ext));
+  }
+
+  inline void Widen16To64(__m128i v, bool is_signed, __m128i *out) {
+    auto ext = is_signed ? _mm_srai_epi16(v, 15) : _mm_setzero_si128();
+    Widen32To64(_mm_unpacklo_epi16(v, ext), is_signed, out);
+    Widen32To64(_mm_unpackhi_epi16(v, ext), is_signed, out + 2);
+  }
+
+  inline void Widen8To64(__m128i v, bool is_signed, __m128i *out) {
+    auto ext = is_signed ? _mm_cmpgt_epi8(_mm_setzero_si128(), v)
+                         : _mm_setzero_si128();
+    Widen16To64(_mm_unpacklo_epi8(v, ext), is_signed, out);
+    Widen16To64(_mm_unpackhi_epi8(v, ext), is_signed, out + 4);
+  }
+#endif
+// clang-format on
+
+// Widens `len` integers of type S at `data` to 64 bits at `dest`, as far as
+// it can with SIMD. Returns how many it converted, the caller does the rest.
+template<typename S>
+size_t WidenTo64(const uint8_t *data, size_t len, uint8_t *dest) {
+  size_t i = 0;
+  const bool is_signed = std::is_signed<S>::value;
+  // clang-format off
+  #if defined(FLATBUFFERS_SIMD_AVX2)
+    for (; i + 4 <= len; i += 4) {
+      auto src = data + i * sizeof(S);
+      __m256i wide;
+      if (sizeof(S) == 1) {
+        int32_t bytes;
+        memcpy(&bytes, src, sizeof(bytes));
+        auto v = _mm_cvtsi32_si128(bytes);
+        wide = is_signed ? _mm256_cvtepi8_epi64(v) : _mm256_cvtepu8_epi64(v);
+      } else if (sizeof(S) == 2) {
+        auto v = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(src));
+        wide = is_signed ? _mm256_cvtepi16_epi64(v) : _mm256_cvtepu16_epi64(v);
+      } else {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        wide = is_signed ? _mm256_cvtepi32_epi64(v) : _mm256_cvtepu32_epi64(v);
+      }
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(dest + i * 8), wide);
+    }
+  #elif defined(FLATBUFFERS_SIMD_SSE2)
+    const size_t step = 16 / sizeof(S);
+    for (; i + step <= len; i += step) {
+      auto v = _mm_loadu_si128(
+          reinterpret_cast<const __m128i *>(data + i * sizeof(S)));
+      auto out = reinterpret_cast<__m128i *>(dest + i * 8);
+      if (sizeof(S) == 1) Widen8To64(v, is_signed, out);
+      else if (sizeof(S) == 2) Widen16To64(v, is_signed, out);
+      else Widen32To64(v, is_signed, out);
+    }
+  #else
+    (void)data;
+    (void)len;
+    (void)dest;
+    (void)is_signed;
+  #endif
+  // clang-format on
+  return i;
+}
+
+// Like WidenTo64(), for floats to doubles.
+inline size_t FloatsToDoubles(const uint8_t *data, size_t len, double *dest) {
+  size_t i = 0;
+  // clang-format off
+  #if defined(FLATBUFFERS_SIMD_AVX2)
+    for (; i + 4 <= len; i += 4) {
+      auto v = _mm_loadu_ps(reinterpret_cast<const float *>(data) + i);
+      _mm256_storeu_pd(dest + i, _mm256_cvtps_pd(v));
+    }
+  #elif defined(FLATBUFFERS_SIMD_SSE2)
+    for (; i + 4 <= len; i += 4) {
+      auto v = _mm_loadu_ps(reinterpret_cast<const float *>(data) + i);
+      _mm_storeu_pd(dest + i, _mm_cvtps_pd(v));
+      _mm_storeu_pd(dest + i + 2, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+    }
+  #else
+    (void)data;
+    (void)len;
+    (void)dest;
+  #endif
+  // clang-format on
+  return i;
+}
+
+// Converts `len` elements of type S at `data` to T, going through the same
+// 64-bit type as As<T>() does, so the results are the same.
+template<typename T, typename S>
+void ConvertElements(const uint8_t *data, size_t len, T *dest) {
+  size_t i = 0;
+  // clang-format off
+  #if FLATBUFFERS_LITTLEENDIAN
+    if (std::is_same<T, S>::value) {
+      if (len) memcpy(dest, data, len * sizeof(T));
+      return;
+    }
+  #endif
+  // clang-format on
+  if (sizeof(T) == 8 && std::is_integral<T>::value &&
+      std::is_integral<S>::value && sizeof(S) < 8) {
+    i = WidenTo64<S>(data, len, reinterpret_cast<uint8_t *>(dest));
+  } else if (std::is_same<T, double>::value && std::is_same<S, float>::value) {
+    i = FloatsToDoubles(data, len, reinterpret_cast<double *>(dest));
+  }
+  typedef typename std::conditional<
+      std::is_floating_point<T>::value, double,
+      typename std::conditional<std::is_signed<T>::value, int64_t,
+                                uint64_t>::type>::type Wide;
+  for (; i < len; i++) {
+    auto v = flatbuffers::ReadScalar<S>(data + i * sizeof(S));
+    dest[i] = static_cast<T>(static_cast<Wide>(v));
+  }
+}
+
+// Converts `len` elements of a typed vector to T, with the type switch
+// outside of the loop. Returns false for elements that aren't numbers.
+template<typename T>
+bool CopyElements(const uint8_t *data, uint8_t byte_width, Type type,
+                  size_t len, T *dest) {
+  switch (type) {
+    case TYPE_INT:
+      switch (byte_width) {
+        case 1: ConvertElements<T, int8_t>(data, len, dest); return true;
+        case 2: ConvertElements<T, int16_t>(data, len, dest); return true;
+        case 4: ConvertElements<T, int32_t>(data, len, dest); return true;
+        case 8: ConvertElements<T, int64_t>(data, len, dest); return true;
+      }
+      break;
+    case TYPE_UINT:
+    case TYPE_BOOL:
+      switch (byte_width) {
+        case 1: ConvertElements<T, uint8_t>(data, len, dest); return true;
+        case 2: ConvertElements<T, uint16_t>(data, len, dest); return true;
+        case 4: ConvertElements<T, uint32_t>(data, len, dest); return true;
+        case 8: ConvertElements<T, uint64_t>(data, len, dest); return true;
+      }
+      break;
+    case TYPE_FLOAT:
+      switch (byte_width) {
+        case 4: ConvertElements<T, float>(data, len, dest); return true;
+        case 8: ConvertElements<T, double>(data, len, dest); return true;
+      }
+      break;
+    default: break;
+  }
+  return false;
+}
+
+template<typename T>
+const T *TypedElements(const uint8_t *data, uint8_t byte_width, Type type) {
+  // clang-format off
+  #if FLATBUFFERS_LITTLEENDIAN
+    auto is_int = std::is_integral<T>::value;
+    auto kind_matches =
+        type == TYPE_FLOAT ? std::is_floating_point<T>::value
+      : type == TYPE_INT ? is_int && std::is_signed<T>::value
+      : type == TYPE_UINT || type == TYPE_BOOL
+          ? is_int && std::is_unsigned<T>::value
+          : false;
+    if (sizeof(T) == byte_width && kind_matches)
+      return reinterpret_cast<const T *>(data);
+  #else
+    (void)data;
+    (void)byte_width;
+    (void)type;
+  #endif
+  // clang-format on
+  return nullptr;
+}
+
+template<typename T>
+size_t TypedVector::CopyTo(T *dest, size_t max) const {
+  auto len = (std::min)(size(), max);
+  if (!CopyElements(data_, byte_width_, type_, len, dest)) {
+    for (size_t i = 0; i < len; i++) dest[i] = (*this)[i].As<T>();
+  }
+  return len;
+}
+
+template<typename T> const T *TypedVector::Data() const {
+  return TypedElements<T>(data_, byte_width_, type_);
+}
+
+template<typename T>
+size_t FixedTypedVector::CopyTo(T *dest, size_t max) const {
+  auto len = (std::min)(static_cast<size_t>(len_), max);
+  if (!CopyElements(data_, byte_width_, type_, len, dest)) {
+    for (size_t i = 0; i < len; i++) dest[i] = (*this)[i].As<T>();
+  }
+  return len;
+}
+
+template<typename T> const T *FixedTypedVector::Data() const {
+  return TypedElements<T>(data_, byte_width_, type_);
+}
+
+// Maps built with BUILDER_FLAG_HASH_MAP_KEYS store a hash table of their keys
+// right after their keys vector, where readers that don't know about it never
+// look. It starts with a 32-bit tag (kKeyHashTag ^ the number of slots), and
+// each 32-bit slot holds the high 16 bits of a key's hash and 1 + the key's
+// index, or 0 if the slot is empty.
+static const uint32_t kKeyHashTag = 0x484b4c46;  // "FLKH"
+// Maps with more keys than this don't get a hash table.
+static const size_t kMaxHashedMapKeys = 0xFFFF;
+
+inline uint32_t KeyHash(const char *key) {
+  return flatbuffers::HashFnv1a<uint32_t>(key);
+}
+
+// The table is kept at most half full, so probe sequences stay short.
+inline size_t NumKeyHashSlots(size_t num_keys) {
+  size_t slots = 4;
+  while (slots < num_keys * 2) slots *= 2;
+  return slots;
+}
+
+// The table isn't aligned, since it directly follows the keys.
+inline uint32_t ReadKeyHashWord(const uint8_t *p) {
+  uint32_t word;
+  memcpy(&word, p, sizeof(word));
+  return flatbuffers::EndianScalar(word);
+}
+
+inline void WriteKeyHashWord(uint8_t *p, uint32_t word) {
+  word = flatbuffers::EndianScalar(word);
+  memcpy(p, &word, sizeof(word));
+}
+
 template<typename T> int KeyCompare(const void *key, const void *elem) {
   auto str_elem = reinterpret_cast<const char *>(
       Indirect<T>(reinterpret_cast<const uint8_t *>(elem)));
@@ -772,8 +1085,43 @@ template<typename T> int KeyCompare(const void *key, const void *elem) {
   return strcmp(skey, str_elem);
 }
 
-inline Reference Map::operator[](const char *key) const {
-  auto keys = Keys();
+inline const uint8_t *Map::KeyHashSlots(const TypedVector &keys) const {
+  auto len = keys.size();
+  if (!len || len > kMaxHashedMapKeys) return nullptr;
+  auto num_slots = NumKeyHashSlots(len);
+  auto table = keys.data_ + len * keys.byte_width_;
+  // The table must fit between the keys and the start of this map.
+  auto map_start = data_ - byte_width_ * 3;
+  if (table > map_start ||
+      static_cast<size_t>(map_start - table) <
+          (num_slots + 1) * sizeof(uint32_t) ||
+      ReadKeyHashWord(table) !=
+          (kKeyHashTag ^ static_cast<uint32_t>(num_slots)))
+    return nullptr;
+  return table + sizeof(uint32_t);
+}
+
+inline size_t Map::HashedKeyIndex(const TypedVector &keys,
+                                  const uint8_t *slots, const char *key,
+                                  uint32_t hash) const {
+  auto len = keys.size();
+  auto num_slots = NumKeyHashSlots(len);
+  auto mask = num_slots - 1;
+  auto i = hash & mask;
+  // Bounded, so a corrupt table can't make us loop forever.
+  for (size_t probes = 0; probes < num_slots; probes++, i = (i + 1) & mask) {
+    auto slot = ReadKeyHashWord(slots + i * sizeof(uint32_t));
+    if (!slot) break;
+    auto index = static_cast<size_t>(slot & 0xFFFF) - 1;
+    if ((slot >> 16) == (hash >> 16) && index < len &&
+        !strcmp(key, KeyAt(keys, index)))
+      return index;
+  }
+  return len;
+}
+
+inline size_t Map::SortedKeyIndex(const TypedVector &keys,
+                                  const char *key) const {
   // We can't pass keys.byte_width_ to the comparison function, so we have
   // to pick the right one ahead of time.
   int (*comp)(const void *, const void *) = nullptr;
@@ -784,15 +1132,259 @@ inline Reference Map::operator[](const char *key) const {
     case 8: comp = KeyCompare<uint64_t>; break;
   }
   auto res = std::bsearch(key, keys.data_, keys.size(), keys.byte_width_, comp);
-  if (!res) return Reference(nullptr, 1, NullPackedType());
-  auto i = (reinterpret_cast<uint8_t *>(res) - keys.data_) / keys.byte_width_;
+  if (!res) return keys.size();
+  return (reinterpret_cast<uint8_t *>(res) - keys.data_) / keys.byte_width_;
+}
+
+inline Reference Map::operator[](const char *key) const {
+  auto keys = Keys();
+  auto slots = KeyHashSlots(keys);
+  auto i = slots ? HashedKeyIndex(keys, slots, key, KeyHash(key))
+                 : SortedKeyIndex(keys, key);
+  // Out of range (not found) gives a Null.
   return (*static_cast<const Vector *>(this))[i];
 }
 
+inline CachedKey::CachedKey(const char *key)
+    : key_(key), hash_(KeyHash(key)), index_(0) {}
+
+inline Reference Map::operator[](CachedKey &key) const {
+  auto keys = Keys();
+  if (key.index_ >= keys.size() || strcmp(key.key_, KeyAt(keys, key.index_)))
+    key.index_ = KeyIndex(keys, key.key_, key.hash_);
+  return (*static_cast<const Vector *>(this))[key.index_];
+}
+
 inline Reference Map::operator[](const std::string &key) const {
   return (*this)[key.c_str()];
 }
 
+// A path to a value inside nested maps and vectors, such as "a[3].b": map
+// keys separated by dots, and vector (or map) indices in brackets. The empty
+// path is the root itself. Keys can't contain '.' or '['.
+class Path {
+ public:
+  explicit Path(const char *path);
+
+  // False if the path didn't parse, in which case it finds nothing.
+  bool valid() const { return valid_; }
+
+  // The number of keys and indices in the path.
+  size_t size() const { return steps_.size(); }
+
+  // Finds the value at this path below `root`. Returns false if there is
+  // none (a key or index doesn't exist, or a value on the way isn't a map or
+  // vector).
+  bool Find(Reference root, Reference *value) const;
+
+  // Like Find(), but returns a null if there is no such value.
+  Reference operator()(Reference root) const {
+    Reference value(nullptr, 1, NullPackedType());
+    Find(root, &value);
+    return value;
+  }
+
+ private:
+  friend class PathSet;
+  friend class Patch;
+
+  struct Step {
+    Step() : index(0), hash(0), is_index(false) {}
+    std::string key;
+    size_t index;
+    uint32_t hash;  // Of the key.
+    bool is_index;
+  };
+
+  // Moves `node` to its child at `step`, and sets `index` to that child's
+  // position in `node`. A map key is first looked for at `*hint`, if given,
+  // which is then set to where it was found.
+  static bool Descend(const Step &step, Reference *node, size_t *index,
+                      size_t *hint = nullptr);
+
+  std::vector<Step> steps_;
+  bool valid_;
+};
+
+inline Path::Path(const char *path) : valid_(true) {
+  auto p = path;
+  while (*p && valid_) {
+    Step step;
+    if (*p == '[') {
+      char *end = nullptr;
+      if (p[1] >= '0' && p[1] <= '9')
+        step.index = static_cast<size_t>(strtoull(p + 1, &end, 10));
+      if (!end || *end != ']') {
+        valid_ = false;
+        break;
+      }
+      step.is_index = true;
+      p = end + 1;
+    } else {
+      auto end = p;
+      while (*end && *end != '.' && *end != '[') end++;
+      step.key.assign(p, end);
+      step.hash = KeyHash(step.key.c_str());
+      p = end;
+    }
+    steps_.push_back(step);
+    // Keys are separated by dots, indices follow directly.
+    if (*p == '.') {
+      p++;
+      valid_ = *p && *p != '.' && *p != '[';
+    } else {
+      valid_ = !*p || *p == '[';
+    }
+    // No empty keys.
+    valid_ = valid_ && (step.is_index || !step.key.empty());
+  }
+  if (!valid_) steps_.clear();
+}
+
+inline bool Path::Descend(const Step &step, Reference *node, size_t *index,
+                          size_t *hint) {
+  auto type = node->GetType();
+  if (step.is_index) {
+    if (type == TYPE_VECTOR || type == TYPE_MAP) {
+      auto vec = node->AsVector();
+      if (step.index >= vec.size()) return false;
+      *node = vec[step.index];
+    } else if (IsTypedVector(type)) {
+      auto vec = node->AsTypedVector();
+      if (step.index >= vec.size()) return false;
+      *node = vec[step.index];
+    } else if (IsFixedTypedVector(type)) {
+      auto vec = node->AsFixedTypedVector();
+      if (step.index >= vec.size()) return false;
+      *node = vec[step.index];
+    } else {
+      return false;
+    }
+    *index = step.index;
+    return true;
+  }
+  if (type != TYPE_MAP) return false;
+  auto map = node->AsMap();
+  auto keys = map.Keys();
+  auto key = step.key.c_str();
+  size_t i;
+  if (hint && *hint < keys.size() && !strcmp(Map::KeyAt(keys, *hint), key)) {
+    i = *hint;
+  } else {
+    i = map.KeyIndex(keys, key, step.hash);
+    if (i >= keys.size()) return false;
+    if (hint) *hint = i;
+  }
+  *node = map.Values()[i];
+  *index = i;
+  return true;
+}
+
+inline bool Path::Find(Reference root, Reference *value) const {
+  if (!valid_) return false;
+  size_t index;
+  for (auto it = steps_.begin(); it != steps_.end(); ++it) {
+    if (!Descend(*it, &root, &index)) return false;
+  }
+  *value = root;
+  return true;
+}
+
+// Many paths, parsed once, to find in many buffers, such as the fields a set
+// of rules looks at in every message. Their common prefixes (like "a.b" in
+// "a.b.c" and "a.b.d") are followed only once per buffer, and each map key
+// remembers where it was found in the last buffer (see CachedKey), so
+// buffers that are shaped alike rarely need a binary search.
+class PathSet {
+ public:
+  PathSet() : nodes_(1) {}
+
+  // Adds `path`, returning its index in the results of Find(). An invalid
+  // path is never found.
+  size_t Add(const char *path) {
+    Path parsed(path);
+    size_t node = 0;
+    if (!parsed.valid()) {
+      node = kInvalid;
+    } else {
+      for (auto it = parsed.steps_.begin(); it != parsed.steps_.end(); ++it)
+        node = Child(node, *it);
+    }
+    paths_.push_back(node);
+    return paths_.size() - 1;
+  }
+
+  // The number of paths added.
+  size_t size() const { return paths_.size(); }
+
+  // Finds the values of all paths below `root`, in the order they were
+  // added, with nulls for the ones that don't exist (see found()). Returns
+  // how many exist.
+  size_t Find(Reference root, std::vector<Reference> *values) {
+    Reference null(nullptr, 1, NullPackedType());
+    values_.assign(nodes_.size(), null);
+    found_.assign(nodes_.size(), false);
+    values_[0] = root;
+    found_[0] = true;
+    // Parents come before their children.
+    for (size_t i = 1; i < nodes_.size(); i++) {
+      auto &node = nodes_[i];
+      if (!found_[node.parent]) continue;
+      auto value = values_[node.parent];
+      size_t index;
+      if (Path::Descend(node.step, &value, &index, &node.hint)) {
+        values_[i] = value;
+        found_[i] = true;
+      }
+    }
+    values->clear();
+    size_t num_found = 0;
+    for (auto it = paths_.begin(); it != paths_.end(); ++it) {
+      auto ok = found(static_cast<size_t>(it - paths_.begin()));
+      values->push_back(ok ? values_[*it] : null);
+      num_found += ok;
+    }
+    return num_found;
+  }
+
+  // Whether path `i` existed in the last Find().
+  bool found(size_t i) const {
+    return paths_[i] != kInvalid && paths_[i] < found_.size() &&
+           found_[paths_[i]];
+  }
+
+ private:
+  static const size_t kInvalid = ~static_cast<size_t>(0);
+
+  // A step of one or more paths. The root has no step.
+  struct Node {
+    Node() : parent(0), hint(0) {}
+    Path::Step step;
+    size_t parent;
+    size_t hint;
+  };
+
+  // The node for `step` below `parent`, added if it's new.
+  size_t Child(size_t parent, const Path::Step &step) {
+    for (size_t i = parent + 1; i < nodes_.size(); i++) {
+      auto &node = nodes_[i];
+      if (node.parent == parent && node.step.is_index == step.is_index &&
+          node.step.index == step.index && node.step.key == step.key)
+        return i;
+    }
+    nodes_.push_back(Node());
+    nodes_.back().step = step;
+    nodes_.back().parent = parent;
+    return nodes_.size() - 1;
+  }
+
+  std::vector<Node> nodes_;
+  std::vector<size_t> paths_;  // The node each path ends at.
+  // Scratch state of the last Find(), per node.
+  std::vector<Reference> values_;
+  std::vector<bool> found_;
+};
+
 inline Reference GetRoot(const uint8_t *buffer, size_t size) {
   // See Finish() below for the serialization counterpart of this.
   // The root starts at the end of the buffer, so we parse backwards from there.
@@ -807,11 +1399,289 @@ inline Reference GetRoot(const std::vector<uint8_t> &buffer) {
   return GetRoot(flatbuffers::vector_data(buffer), buffer.size());
 }
 
+// A streamable buffer (see Builder::StartStream()) starts with this, followed
+// by one segment per element of its root vector. A segment is a 32-bit size
+// followed by that many bytes: the element's data and a root for it (in the
+// same format as the buffer's root), so it can be read with GetRoot(). A size
+// of 0 ends the stream, and is followed by the root vector and buffer root.
+// Readers that don't know about streams never look at the sizes.
+static const char kStreamIdentifier[] = "FLXS";
+static const size_t kStreamIdentifierLength = 4;
+
+inline uint32_t ReadStreamSize(const uint8_t *p) {
+  uint32_t size;
+  memcpy(&size, p, sizeof(size));
+  return flatbuffers::EndianScalar(size);
+}
+
+// Reads the elements of a streamable buffer while it is arriving, e.g. over
+// the network: each element can be used as soon as its segment is complete.
+class StreamReader {
+ public:
+  StreamReader() : pos_(0), count_(0), done_(false), error_(false) {}
+
+  // Get the next element, if it has completely arrived. `data` and `size`
+  // are all of the buffer received so far, and may move between calls (the
+  // element is then only valid until the next move). Returns false if the
+  // next element isn't complete yet, or if there are no more elements, see
+  // done().
+  bool Next(const uint8_t *data, size_t size, Reference *element) {
+    if (done_ || error_) return false;
+    if (!pos_) {
+      if (size < kStreamIdentifierLength) return false;
+      if (memcmp(data, kStreamIdentifier, kStreamIdentifierLength)) {
+        error_ = true;
+        return false;
+      }
+      pos_ = kStreamIdentifierLength;
+    }
+    if (size < pos_ + sizeof(uint32_t)) return false;
+    auto segment_size = ReadStreamSize(data + pos_);
+    if (!segment_size) {
+      done_ = true;
+      return false;
+    }
+    // The smallest element is a 1 byte value, its type and its width.
+    if (segment_size < 3) {
+      error_ = true;
+      return false;
+    }
+    if (size - pos_ - sizeof(uint32_t) < segment_size) return false;
+    *element = GetRoot(data + pos_ + sizeof(uint32_t), segment_size);
+    pos_ += sizeof(uint32_t) + segment_size;
+    count_++;
+    return true;
+  }
+
+  // All elements have been read. The root vector follows, so once the
+  // buffer has arrived entirely, it can also be read as usual with GetRoot().
+  bool done() const { return done_; }
+
+  // The buffer isn't a stream, or is corrupt.
+  bool error() const { return error_; }
+
+  // The number of elements read so far.
+  size_t count() const { return count_; }
+
+  // How much of the buffer has been read so far.
+  size_t position() const { return pos_; }
+
+ private:
+  size_t pos_;
+  size_t count_;
+  bool done_;
+  bool error_;
+};
+
+// Checks that a FlexBuffer from an untrusted source can be read safely: that
+// all offsets and sizes stay within the buffer, types and widths are valid,
+// values are aligned to their width (relative to the start of the buffer, as
+// Builder writes them), strings and keys are terminated, and the keys of each
+// map are sorted (so looking them up works). `max_depth` limits how deeply
+// vectors and maps can nest, and `max_vectors` how many strings, blobs, vectors
+// and maps are checked in all, since a buffer can refer to the same data any
+// number of times. Readers only need the root of a verified buffer to be valid.
+class Verifier FLATBUFFERS_FINAL_CLASS {
+ public:
+  Verifier(const uint8_t *buf, size_t buf_len, size_t max_depth = 64,
+           size_t max_vectors = 1000000)
+      : buf_(buf),
+        end_(buf + buf_len),
+        depth_(0),
+        max_depth_(max_depth),
+        num_vectors_(0),
+        max_vectors_(max_vectors),
+        last_keys_(nullptr),
+        last_keys_width_(0) {}
+
+  bool VerifyBuffer() {
+    // See GetRoot().
+    if (end_ - buf_ < 3) return false;
+    auto byte_width = end_[-1];
+    if (!IsValidWidth(byte_width) || end_ - buf_ - 2 < byte_width)
+      return false;
+    auto root = end_ - 2 - byte_width;
+    return IsAligned(root, byte_width) &&
+           VerifyRef(root, byte_width, end_[-2]);
+  }
+
+ private:
+  static bool IsValidWidth(uint64_t width) {
+    return width == 1 || width == 2 || width == 4 || width == 8;
+  }
+
+  bool IsAligned(const uint8_t *p, size_t width) const {
+    return !(static_cast<size_t>(p - buf_) & (width - 1));
+  }
+
+  // Whether [p, p + len) lies within the buffer.
+  bool InBuffer(const uint8_t *p, size_t len) const {
+    return p >= buf_ && p <= end_ && len <= static_cast<size_t>(end_ - p);
+  }
+
+  // Finds where the `width` bytes wide offset at `p` (in the buffer) points.
+  bool Follow(const uint8_t *p, uint8_t width, const uint8_t **target) const {
+    auto offset = ReadUInt64(p, width);
+    if (offset > static_cast<uint64_t>(p - buf_)) return false;
+    *target = p - static_cast<size_t>(offset);
+    return true;
+  }
+
+  // Reads the size in front of the vector, string or blob at `p`, with
+  // `width` bytes wide size field, and checks that `len` elements of
+  // `elem_size` bytes plus `extra` bytes fit after it.
+  bool VerifySize(const uint8_t *p, uint8_t width, size_t elem_size,
+                  size_t extra, size_t *len) const {
+    if (static_cast<size_t>(p - buf_) < width) return false;
+    auto size = ReadUInt64(p - width, width);
+    auto room = static_cast<size_t>(end_ - p);
+    if (size > room / elem_size || size * elem_size + extra > room)
+      return false;
+    *len = static_cast<size_t>(size);
+    return true;
+  }
+
+  // Counts a string, blob, vector or map against `max_vectors`.
+  bool Count() { return ++num_vectors_ <= max_vectors_; }
+
+  bool VerifyKey(const uint8_t *key) const {
+    return memchr(key, 0, static_cast<size_t>(end_ - key)) != nullptr;
+  }
+
+  // Checks the value at `p` (in the buffer) of a vector or root that is
+  // `parent_width` bytes wide, with type and width `packed_type`.
+  bool VerifyRef(const uint8_t *p, uint8_t parent_width, uint8_t packed_type) {
+    return VerifyValue(p, parent_width,
+                       static_cast<uint8_t>(1U << (packed_type & 3)),
+                       static_cast<Type>(packed_type >> 2));
+  }
+
+  bool VerifyValue(const uint8_t *p, uint8_t parent_width, uint8_t byte_width,
+                   Type type) {
+    if (IsInline(type)) return true;  // Checked with the parent.
+    const uint8_t *target;
+    if (!Follow(p, parent_width, &target)) return false;
+    if (type != TYPE_KEY && !IsAligned(target, byte_width)) return false;
+    size_t len;
+    switch (type) {
+      case TYPE_KEY: return VerifyKey(target);
+      case TYPE_STRING:
+        return Count() && VerifySize(target, byte_width, 1, 1, &len) &&
+               !target[len];
+      case TYPE_BLOB:
+        return Count() && VerifySize(target, byte_width, 1, 0, &len);
+      case TYPE_INDIRECT_INT:
+      case TYPE_INDIRECT_UINT:
+      case TYPE_INDIRECT_FLOAT: return InBuffer(target, byte_width);
+      case TYPE_MAP: return VerifyMap(target, byte_width);
+      case TYPE_VECTOR: return VerifyVector(target, byte_width);
+      default: break;
+    }
+    if (IsTypedVector(type)) {
+      return VerifyTypedVector(target, byte_width,
+                               ToTypedVectorElementType(type));
+    }
+    if (IsFixedTypedVector(type)) {
+      uint8_t fixed_len;
+      ToFixedTypedVectorElementType(type, &fixed_len);
+      // Only numbers, so the elements themselves are always valid.
+      return Count() && InBuffer(target, fixed_len * byte_width);
+    }
+    return false;  // Not a type.
+  }
+
+  bool VerifyVector(const uint8_t *vec, uint8_t byte_width, size_t *len) {
+    // The elements, followed by a type byte for each.
+    if (!Count() || !VerifySize(vec, byte_width, byte_width + 1U, 0, len))
+      return false;
+    if (++depth_ > max_depth_) return false;
+    auto types = vec + *len * byte_width;
+    for (size_t i = 0; i < *len; i++) {
+      if (!VerifyRef(vec + i * byte_width, byte_width, types[i])) return false;
+    }
+    depth_--;
+    return true;
+  }
+
+  bool VerifyVector(const uint8_t *vec, uint8_t byte_width) {
+    size_t len;
+    return VerifyVector(vec, byte_width, &len);
+  }
+
+  bool VerifyTypedVector(const uint8_t *vec, uint8_t byte_width,
+                         Type elem_type) {
+    size_t len;
+    if (!Count() || !VerifySize(vec, byte_width, byte_width, 0, &len))
+      return false;
+    // Numbers are checked by now, keys and strings are offsets.
+    if (IsInline(elem_type)) return true;
+    for (size_t i = 0; i < len; i++) {
+      // See TypedVector::operator[] for the width of strings.
+      if (!VerifyValue(vec + i * byte_width, byte_width, 1, elem_type))
+        return false;
+    }
+    return true;
+  }
+
+  bool VerifyMap(const uint8_t *map, uint8_t byte_width) {
+    // The keys vector and its width come before the size of the values.
+    if (static_cast<size_t>(map - buf_) < 3U * byte_width) return false;
+    auto keys_width = ReadUInt64(map - byte_width * 2, byte_width);
+    const uint8_t *keys;
+    size_t len;
+    if (!IsValidWidth(keys_width) ||
+        !Follow(map - byte_width * 3, byte_width, &keys) ||
+        !VerifyVector(map, byte_width, &len))
+      return false;
+    auto kw = static_cast<uint8_t>(keys_width);
+    // Maps with the same keys often share their keys vector (see
+    // BUILDER_FLAG_SHARE_KEY_VECTORS), which then needn't be checked again.
+    if (keys == last_keys_ && kw == last_keys_width_) {
+      return ReadUInt64(keys - kw, kw) == len;
+    }
+    size_t num_keys;
+    if (!Count() || !IsAligned(keys, kw) ||
+        !VerifySize(keys, kw, kw, 0, &num_keys) ||
+        num_keys != len)
+      return false;
+    const char *prev = nullptr;
+    for (size_t i = 0; i < len; i++) {
+      const uint8_t *key;
+      if (!Follow(keys + i * kw, kw, &key) || !VerifyKey(key)) return false;
+      auto str = reinterpret_cast<const char *>(key);
+      if (prev && strcmp(prev, str) >= 0) return false;
+      prev = str;
+    }
+    last_keys_ = keys;
+    last_keys_width_ = kw;
+    return true;
+  }
+
+  const uint8_t *buf_;
+  const uint8_t *end_;
+  size_t depth_;
+  size_t max_depth_;
+  size_t num_vectors_;
+  size_t max_vectors_;
+  // The keys vector of the last map checked.
+  const uint8_t *last_keys_;
+  uint8_t last_keys_width_;
+};
+
+inline bool VerifyBuffer(const uint8_t *buf, size_t buf_len) {
+  Verifier verifier(buf, buf_len);
+  return verifier.VerifyBuffer();
+}
+
+inline bool VerifyBuffer(const std::vector<uint8_t> &buf) {
+  return VerifyBuffer(flatbuffers::vector_data(buf), buf.size());
+}
+
 // Flags that configure how the Builder behaves.
 // The "Share" flags determine if the Builder automatically tries to pool
 // this type. Pooling can reduce the size of serialized data if there are
 // multiple maps of the same kind, at the expense of slightly slower
-// serialization (the cost of lookups) and more memory use (std::set).
+// serialization (the cost of lookups) and more memory use (a hash table).
 // By default this is on for keys, but off for strings.
 // Turn keys off if you have e.g. only one map.
 // Turn strings on if you expect many non-unique string values.
@@ -822,23 +1692,52 @@ enum BuilderFlag {
   BUILDER_FLAG_SHARE_KEYS = 1,
   BUILDER_FLAG_SHARE_STRINGS = 2,
   BUILDER_FLAG_SHARE_KEYS_AND_STRINGS = 3,
+  // Maps with the same keys share one keys vector. Keys are only recognized
+  // as the same if they are shared too (BUILDER_FLAG_SHARE_KEYS).
   BUILDER_FLAG_SHARE_KEY_VECTORS = 4,
   BUILDER_FLAG_SHARE_ALL = 7,
+  // Store a hash table of the keys of each map, so that looking up a key
+  // doesn't need a binary search. Costs 8 to 16 bytes per key; readers that
+  // don't know about it still read the map as usual.
+  BUILDER_FLAG_HASH_MAP_KEYS = 8,
+  // Store untyped vectors whose elements are all ints, all uints, all floats
+  // or all bools as typed vectors instead (fixed typed vectors if they have 2
+  // to 4 ints, uints or floats), which saves the type byte of each element.
+  // Readers must then use AsTypedVector() / AsFixedTypedVector() for them
+  // rather than AsVector().
+  BUILDER_FLAG_AUTO_TYPED_VECTORS = 16,
 };
 
 class Builder FLATBUFFERS_FINAL_CLASS {
  public:
+  // `allocator` is used for the builder's value stack and sharing pools (the
+  // default allocator if null), and must outlive the builder. Like the buffer
+  // itself, these keep their memory across `Clear()`, so a builder that is
+  // reused for many similar buffers stops allocating once it has warmed up.
   Builder(size_t initial_size = 256,
-          BuilderFlag flags = BUILDER_FLAG_SHARE_KEYS)
+          BuilderFlag flags = BUILDER_FLAG_SHARE_KEYS,
+          flatbuffers::Allocator *allocator = nullptr)
       : buf_(initial_size),
+        stack_(ValueAllocator(allocator)),
         finished_(false),
         flags_(flags),
         force_min_bit_width_(BIT_WIDTH_8),
-        key_pool(KeyOffsetCompare(buf_)),
-        string_pool(StringOffsetCompare(buf_)) {
+        stream_count_(0),
+        stream_segment_(0),
+        stream_ready_(0),
+        streaming_(false),
+        key_pool(allocator),
+        string_pool(allocator),
+        key_vector_pool(allocator) {
     buf_.clear();
+    stats_ = nullptr;
   }
 
+  // Count what this builder does in `stats` (not owned), or `nullptr` to
+  // stop, see flatbuffers::BuilderStats. Only code compiled with
+  // FLATBUFFERS_BUILDER_STATS counts.
+  void SetStats(flatbuffers::BuilderStats *stats) { stats_ = stats; }
+
   /// @brief Get the serialized buffer (after you call `Finish()`).
   /// @return Returns a vector owned by this class.
   const std::vector<uint8_t> &GetBuffer() const {
@@ -849,6 +1748,34 @@ class Builder FLATBUFFERS_FINAL_CLASS {
   // Size of the buffer. Does not include unfinished values.
   size_t GetSize() const { return buf_.size(); }
 
+  // Hand over the finished buffer without copying it, either as a
+  // DetachedBuffer (like FlatBufferBuilder::Release()) or as the vector
+  // itself. The builder is then empty, as after Clear(), and allocates a new
+  // buffer for what it builds next.
+  flatbuffers::DetachedBuffer Release() {
+    auto owner = new VectorOwner(ReleaseVector());
+    auto &buf = owner->buf;
+    auto data = flatbuffers::vector_data(buf);
+    return flatbuffers::DetachedBuffer(owner, true, data, buf.capacity(), data,
+                                       buf.size());
+  }
+
+  std::vector<uint8_t> ReleaseVector() {
+    Finished();
+    std::vector<uint8_t> buf;
+    buf.swap(buf_);
+    Clear();
+    return buf;
+  }
+
+  // Like Clear(), but build the next buffer in `buf` (which is cleared)
+  // reusing its memory, e.g. a vector released earlier that has been sent
+  // since.
+  void Clear(std::vector<uint8_t> &&buf) {
+    buf_.swap(buf);
+    Clear();
+  }
+
   // Reset all state so we can re-use the buffer.
   void Clear() {
     buf_.clear();
@@ -856,8 +1783,20 @@ class Builder FLATBUFFERS_FINAL_CLASS {
     finished_ = false;
     // flags_ remains as-is;
     force_min_bit_width_ = BIT_WIDTH_8;
+    streaming_ = false;
+    stream_ready_ = 0;
     key_pool.clear();
     string_pool.clear();
+    key_vectors_.clear();
+    key_vector_pool.clear();
+  }
+
+  // Makes room for `values` values under construction at once (the elements
+  // of all the vectors and maps that are open, and their keys) and a buffer
+  // of `bytes`, when that is known or can be estimated up front.
+  void Reserve(size_t values, size_t bytes) {
+    stack_.reserve(values);
+    buf_.reserve(bytes);
   }
 
   // All value constructing functions below have two versions: one that
@@ -930,19 +1869,19 @@ class Builder FLATBUFFERS_FINAL_CLASS {
     IndirectDouble(d);
   }
 
+  // `str` doesn't need to be 0-terminated, so a key can be taken directly
+  // from e.g. JSON text. With BUILDER_FLAG_SHARE_KEYS it's looked up before
+  // being written, so a key that is already in the buffer isn't copied.
   size_t Key(const char *str, size_t len) {
     auto sloc = buf_.size();
-    WriteBytes(str, len + 1);
     if (flags_ & BUILDER_FLAG_SHARE_KEYS) {
-      auto it = key_pool.find(sloc);
-      if (it != key_pool.end()) {
-        // Already in the buffer. Remove key we just serialized, and use
-        // existing offset instead.
-        buf_.resize(sloc);
-        sloc = *it;
-      } else {
-        key_pool.insert(sloc);
-      }
+      sloc = key_pool.Intern(buf_, str, len, sloc);
+      FLATBUFFERS_BUILDER_STAT(stats_, SharedString(sloc != buf_.size()));
+    }
+    if (sloc == buf_.size()) {
+      WriteBytes(str, len);
+      FLATBUFFERS_BUILDER_STAT(stats_, Grow(buf_.size(), buf_.capacity(), 1));
+      buf_.push_back(0);
     }
     stack_.push_back(Value(static_cast<uint64_t>(sloc), TYPE_KEY, BIT_WIDTH_8));
     return sloc;
@@ -955,16 +1894,14 @@ class Builder FLATBUFFERS_FINAL_CLASS {
     auto reset_to = buf_.size();
     auto sloc = CreateBlob(str, len, 1, TYPE_STRING);
     if (flags_ & BUILDER_FLAG_SHARE_STRINGS) {
-      StringOffset so(sloc, len);
-      auto it = string_pool.find(so);
-      if (it != string_pool.end()) {
+      auto existing = string_pool.FindOrAdd(buf_, sloc, len + 1);
+      FLATBUFFERS_BUILDER_STAT(stats_, SharedString(existing != sloc));
+      if (existing != sloc) {
         // Already in the buffer. Remove string we just serialized, and use
         // existing offset instead.
         buf_.resize(reset_to);
-        sloc = it->first;
+        sloc = existing;
         stack_.back().u_ = sloc;
-      } else {
-        string_pool.insert(so);
       }
     }
     return sloc;
@@ -1015,6 +1952,9 @@ class Builder FLATBUFFERS_FINAL_CLASS {
   // TODO(wvo): allow this to specify an aligment greater than the natural
   // alignment.
   size_t EndVector(size_t start, bool typed, bool fixed) {
+    if (!typed && (flags_ & BUILDER_FLAG_AUTO_TYPED_VECTORS)) {
+      typed = IsHomogeneous(start, &fixed);
+    }
     auto vec = CreateVector(start, stack_.size() - start, 1, typed, fixed);
     // Remove temp elements and return vector.
     stack_.resize(start);
@@ -1065,9 +2005,7 @@ class Builder FLATBUFFERS_FINAL_CLASS {
                 return comp < 0;
               });
     // First create a vector out of all keys.
-    // TODO(wvo): if kBuilderFlagShareKeyVectors is true, see if we can share
-    // the first vector.
-    auto keys = CreateVector(start, len, 2, true, false);
+    auto keys = KeysVector(start, len);
     auto vec = CreateVector(start + 1, len, 2, false, false, &keys);
     // Remove temp elements and return map.
     stack_.resize(start);
@@ -1217,6 +2155,65 @@ class Builder FLATBUFFERS_FINAL_CLASS {
     force_min_bit_width_ = bw;
   }
 
+  // Streaming: builds a buffer whose root is a vector, in a way that lets
+  // the elements be sent (see GetStreamReadySize()) and read (see
+  // StreamReader) one by one, before the buffer is finished. Call on an empty
+  // builder, add each element followed by EndStreamElement(), then call
+  // EndStream(), which also finishes the buffer. Each element costs about 8
+  // extra bytes; the result is still an ordinary FlexBuffer.
+  void StartStream() {
+    assert(buf_.empty() && stack_.empty() && !finished_);
+    WriteBytes(kStreamIdentifier, kStreamIdentifierLength);
+    stream_count_ = 0;
+    streaming_ = true;
+    StartStreamSegment();
+  }
+
+  // Call after adding each element to a stream: completes its segment.
+  void EndStreamElement() {
+    assert(streaming_);
+    // Exactly one new (finished) element must have been added.
+    assert(stack_.size() == stream_count_ + 1);
+    auto &elem = stack_.back();
+    auto byte_width = Align(elem.ElemWidth(buf_.size(), 0));
+    WriteAny(elem, byte_width);
+    Write(elem.StoredPackedType(), 1);
+    Write(byte_width, 1);
+    PatchStreamSegment();
+    stream_count_++;
+    StartStreamSegment();
+  }
+
+  // Ends the stream's root vector and finishes the buffer. Returns the
+  // number of elements.
+  size_t EndStream() {
+    assert(streaming_);
+    assert(stack_.size() == stream_count_);
+    // The segment started after the last element stays empty, which marks
+    // the end of the stream.
+    PatchStreamSegment();
+    // Untyped whatever the flags say, which the segments rely on.
+    auto vec = CreateVector(0, stack_.size(), 1, false, false);
+    stack_.clear();
+    stack_.push_back(vec);
+    Finish();
+    streaming_ = false;
+    return stream_count_;
+  }
+
+  // How much of the buffer being streamed is ready to be sent: up to the end
+  // of the last complete element, or all of it once finished. Bytes before
+  // this won't change anymore.
+  size_t GetStreamReadySize() const {
+    return finished_ ? buf_.size() : stream_ready_;
+  }
+
+  // The start of the buffer being streamed, valid until the next call that
+  // adds to it.
+  const uint8_t *GetStreamData() const {
+    return flatbuffers::vector_data(buf_);
+  }
+
   void Finish() {
     // If you hit this assert, you likely have objects that were never included
     // in a parent. You need to have exactly one root to finish a buffer.
@@ -1233,6 +2230,7 @@ class Builder FLATBUFFERS_FINAL_CLASS {
     Write(byte_width, 1);
 
     finished_ = true;
+    FLATBUFFERS_BUILDER_STAT(stats_, Finished(buf_.size()));
   }
 
  private:
@@ -1243,15 +2241,34 @@ class Builder FLATBUFFERS_FINAL_CLASS {
     assert(finished_);
   }
 
+  // Starts the segment of the next element of a stream, with a size to be
+  // filled in by PatchStreamSegment().
+  void StartStreamSegment() {
+    stream_segment_ = buf_.size();
+    Write<uint32_t>(0, sizeof(uint32_t));
+  }
+
+  void PatchStreamSegment() {
+    auto size = flatbuffers::EndianScalar(static_cast<uint32_t>(
+        buf_.size() - stream_segment_ - sizeof(uint32_t)));
+    memcpy(flatbuffers::vector_data(buf_) + stream_segment_, &size,
+           sizeof(size));
+    stream_ready_ = buf_.size();
+  }
+
   // Align to prepare for writing a scalar with a certain size.
   uint8_t Align(BitWidth alignment) {
     auto byte_width = 1U << alignment;
-    buf_.insert(buf_.end(), flatbuffers::PaddingBytes(buf_.size(), byte_width),
-                0);
+    auto padding = flatbuffers::PaddingBytes(buf_.size(), byte_width);
+    FLATBUFFERS_BUILDER_STAT(stats_, Padding(padding));
+    FLATBUFFERS_BUILDER_STAT(stats_,
+                             Grow(buf_.size(), buf_.capacity(), padding));
+    buf_.insert(buf_.end(), padding, 0);
     return static_cast<uint8_t>(byte_width);
   }
 
   void WriteBytes(const void *val, size_t size) {
+    FLATBUFFERS_BUILDER_STAT(stats_, Grow(buf_.size(), buf_.capacity(), size));
     buf_.insert(buf_.end(), reinterpret_cast<const uint8_t *>(val),
                 reinterpret_cast<const uint8_t *>(val) + size);
   }
@@ -1390,7 +2407,11 @@ class Builder FLATBUFFERS_FINAL_CLASS {
     auto byte_width = Align(bit_width);
     Write<uint64_t>(len, byte_width);
     auto sloc = buf_.size();
-    WriteBytes(data, len + trailing);
+    WriteBytes(data, len);
+    // Zeros rather than whatever follows `data`, which needn't be terminated.
+    FLATBUFFERS_BUILDER_STAT(stats_,
+                             Grow(buf_.size(), buf_.capacity(), trailing));
+    for (size_t i = 0; i < trailing; i++) buf_.push_back(0);
     stack_.push_back(Value(static_cast<uint64_t>(sloc), type, bit_width));
     return sloc;
   }
@@ -1400,6 +2421,9 @@ class Builder FLATBUFFERS_FINAL_CLASS {
     auto vector_type = GetScalarType<T>();
     auto byte_width = sizeof(T);
     auto bit_width = WidthB(byte_width);
+    // Align the elements (and so the size field before them), like
+    // CreateVector() does, so they can be read in place (see Data<T>()).
+    Align(bit_width);
     // If you get this assert, you're trying to write a vector with a size
     // field that is bigger than the scalars you're trying to write (e.g. a
     // byte vector > 255 elements). For such types, write a "blob" instead.
@@ -1458,6 +2482,8 @@ class Builder FLATBUFFERS_FINAL_CLASS {
     }
     // Then the types.
     if (!typed) {
+      FLATBUFFERS_BUILDER_STAT(stats_,
+                               Grow(buf_.size(), buf_.capacity(), vec_len));
       for (size_t i = start; i < stack_.size(); i += step) {
         buf_.push_back(stack_[i].StoredPackedType(bit_width));
       }
@@ -1469,12 +2495,120 @@ class Builder FLATBUFFERS_FINAL_CLASS {
                  bit_width);
   }
 
+  // Whether the elements from `start` on the stack all have the same type,
+  // and it's one a typed vector can hold. Sets `fixed` if they would also fit
+  // in a fixed typed vector.
+  bool IsHomogeneous(size_t start, bool *fixed) const {
+    auto len = stack_.size() - start;
+    if (!len) return false;
+    auto type = stack_[start].type_;
+    if (type != TYPE_INT && type != TYPE_UINT && type != TYPE_FLOAT &&
+        type != TYPE_BOOL)
+      return false;
+    for (auto i = start + 1; i < stack_.size(); i++) {
+      if (stack_[i].type_ != type) return false;
+    }
+    *fixed = type != TYPE_BOOL && len >= 2 && len <= 4;
+    return true;
+  }
+
+  // Creates the keys vector for the `len` (sorted) keys at `start` on the
+  // stack, followed by their hash table if enabled. With
+  // BUILDER_FLAG_SHARE_KEY_VECTORS this returns the keys vector of an earlier
+  // map instead, if it had the same keys.
+  Value KeysVector(size_t start, size_t len) {
+    auto share = (flags_ & BUILDER_FLAG_SHARE_KEY_VECTORS) && len;
+    // `key_vectors_` holds the key offsets of each distinct keys vector,
+    // followed by the vector itself (offset and bit width).
+    auto entry = key_vectors_.size();
+    auto keys_size = len * sizeof(uint64_t);
+    if (share) {
+      key_vectors_.resize(entry + keys_size);
+      for (size_t i = 0; i < len; i++) {
+        auto offset = stack_[start + i * 2].u_;
+        memcpy(&key_vectors_[entry + i * sizeof(uint64_t)], &offset,
+               sizeof(uint64_t));
+      }
+      auto found = key_vector_pool.FindOrAdd(key_vectors_, entry, keys_size);
+      FLATBUFFERS_BUILDER_STAT(stats_, Vtable(found != entry));
+      if (found != entry) {
+        key_vectors_.resize(entry);
+        uint64_t offset;
+        memcpy(&offset, &key_vectors_[found + keys_size], sizeof(uint64_t));
+        auto bit_width =
+            static_cast<BitWidth>(key_vectors_[found + keys_size + 8]);
+        return Value(offset, TYPE_VECTOR_KEY, bit_width);
+      }
+    }
+    auto keys = CreateVector(start, len, 2, true, false);
+    if ((flags_ & BUILDER_FLAG_HASH_MAP_KEYS) && len &&
+        len <= kMaxHashedMapKeys) {
+      WriteKeyHashes(start, len);
+    }
+    if (share) {
+      key_vectors_.resize(entry + keys_size + 9);
+      memcpy(&key_vectors_[entry + keys_size], &keys.u_, sizeof(uint64_t));
+      key_vectors_[entry + keys_size + 8] =
+          static_cast<uint8_t>(keys.min_bit_width_);
+    }
+    return keys;
+  }
+
+  // Writes the hash table for the `len` (sorted) keys at `start` on the stack
+  // directly after their keys vector, see Map::KeyHashSlots().
+  void WriteKeyHashes(size_t start, size_t len) {
+    auto num_slots = NumKeyHashSlots(len);
+    auto table = buf_.size();
+    FLATBUFFERS_BUILDER_STAT(
+        stats_,
+        Grow(table, buf_.capacity(), (num_slots + 1) * sizeof(uint32_t)));
+    buf_.resize(table + (num_slots + 1) * sizeof(uint32_t), 0);
+    auto base = flatbuffers::vector_data(buf_);
+    WriteKeyHashWord(base + table,
+                     kKeyHashTag ^ static_cast<uint32_t>(num_slots));
+    auto slots = base + table + sizeof(uint32_t);
+    auto mask = num_slots - 1;
+    for (size_t k = 0; k < len; k++) {
+      auto hash = KeyHash(
+          reinterpret_cast<const char *>(base + stack_[start + k * 2].u_));
+      auto i = hash & mask;
+      while (ReadKeyHashWord(slots + i * sizeof(uint32_t))) i = (i + 1) & mask;
+      WriteKeyHashWord(slots + i * sizeof(uint32_t),
+                       (hash & 0xFFFF0000) | static_cast<uint32_t>(k + 1));
+    }
+  }
+
+  friend class Patch;
+
   // You shouldn't really be copying instances of this class.
   Builder(const Builder &);
   Builder &operator=(const Builder &);
 
+  typedef flatbuffers::AllocatorAdapter<Value> ValueAllocator;
+
+  // Keeps a released buffer alive for as long as the DetachedBuffer that
+  // points into it, see Release().
+  class VectorOwner : public flatbuffers::Allocator {
+   public:
+    explicit VectorOwner(std::vector<uint8_t> &&released)
+        : buf(std::move(released)) {}
+
+    uint8_t *allocate(size_t) FLATBUFFERS_OVERRIDE {
+      assert(false);  // Only ever owns a finished buffer.
+      return nullptr;
+    }
+
+    void deallocate(uint8_t *, size_t) FLATBUFFERS_OVERRIDE {
+      std::vector<uint8_t>().swap(buf);
+    }
+
+    std::vector<uint8_t> buf;
+  };
+
   std::vector<uint8_t> buf_;
-  std::vector<Value> stack_;
+  std::vector<Value, ValueAllocator> stack_;
+
+  flatbuffers::BuilderStats *stats_;
 
   bool finished_;
 
@@ -1482,36 +2616,94 @@ class Builder FLATBUFFERS_FINAL_CLASS {
 
   BitWidth force_min_bit_width_;
 
-  struct KeyOffsetCompare {
-    KeyOffsetCompare(const std::vector<uint8_t> &buf) : buf_(&buf) {}
-    bool operator()(size_t a, size_t b) const {
-      auto stra =
-          reinterpret_cast<const char *>(flatbuffers::vector_data(*buf_) + a);
-      auto strb =
-          reinterpret_cast<const char *>(flatbuffers::vector_data(*buf_) + b);
-      return strcmp(stra, strb) < 0;
+  // Streaming state, see StartStream().
+  size_t stream_count_;    // Elements completed so far.
+  size_t stream_segment_;  // Where the size of the current segment is.
+  size_t stream_ready_;    // The end of the last complete segment.
+  bool streaming_;
+
+  // An open addressing hash set of the keys or strings written to `buf_` so
+  // far, each identified by its offset and size (including the terminator).
+  class BytesPool {
+   public:
+    explicit BytesPool(flatbuffers::Allocator *allocator)
+        : slots_(SlotAllocator(allocator)), used_(0) {}
+
+    // Returns the offset of an earlier copy of the `size` bytes at `offset`
+    // in `buf`, or adds them to the pool and returns `offset` if there is
+    // none.
+    size_t FindOrAdd(const std::vector<uint8_t> &buf, size_t offset,
+                     size_t size) {
+      return Intern(buf, flatbuffers::vector_data(buf) + offset, size, offset);
+    }
+
+    // Like FindOrAdd(), for `size` bytes at `data` that aren't in `buf` yet:
+    // if there's no earlier copy, they're added as if they were at `offset`,
+    // and the caller must write them there before the pool is used again.
+    size_t Intern(const std::vector<uint8_t> &buf, const void *data,
+                  size_t size, size_t offset) {
+      if (slots_.empty()) Grow();
+      auto base = flatbuffers::vector_data(buf);
+      auto hash = flatbuffers::XxHash64::Hash(data, size);
+      auto mask = slots_.size() - 1;
+      for (auto i = static_cast<size_t>(hash) & mask;; i = (i + 1) & mask) {
+        auto &slot = slots_[i];
+        if (slot.offset == kEmpty) {
+          slot.offset = offset;
+          slot.size = size;
+          slot.hash = hash;
+          // Keep the table at most half full, so probe sequences stay short.
+          if (++used_ * 2 > slots_.size()) Grow();
+          return offset;
+        }
+        if (slot.hash == hash && slot.size == size &&
+            !memcmp(base + slot.offset, data, size)) {
+          return slot.offset;
+        }
+      }
+    }
+
+    // Forget all entries, but keep the table for the next buffer.
+    void clear() {
+      if (used_) std::fill(slots_.begin(), slots_.end(), Slot());
+      used_ = 0;
+    }
+
+   private:
+    static const size_t kEmpty = ~static_cast<size_t>(0);
+
+    struct Slot {
+      Slot() : offset(kEmpty), size(0), hash(0) {}
+      size_t offset;  // kEmpty for an empty slot.
+      size_t size;
+      uint64_t hash;
+    };
+    typedef flatbuffers::AllocatorAdapter<Slot> SlotAllocator;
+
+    void Grow() {
+      std::vector<Slot, SlotAllocator> old(
+          slots_.empty() ? 16 : slots_.size() * 2, Slot(),
+          slots_.get_allocator());
+      old.swap(slots_);
+      auto mask = slots_.size() - 1;
+      for (auto it = old.begin(); it != old.end(); ++it) {
+        if (it->offset == kEmpty) continue;
+        auto i = static_cast<size_t>(it->hash) & mask;
+        while (slots_[i].offset != kEmpty) i = (i + 1) & mask;
+        slots_[i] = *it;
+      }
     }
-    const std::vector<uint8_t> *buf_;
-  };
 
-  typedef std::pair<size_t, size_t> StringOffset;
-  struct StringOffsetCompare {
-    StringOffsetCompare(const std::vector<uint8_t> &buf) : buf_(&buf) {}
-    bool operator()(const StringOffset &a, const StringOffset &b) const {
-      auto stra = reinterpret_cast<const char *>(
-          flatbuffers::vector_data(*buf_) + a.first);
-      auto strb = reinterpret_cast<const char *>(
-          flatbuffers::vector_data(*buf_) + b.first);
-      return strncmp(stra, strb, (std::min)(a.second, b.second) + 1) < 0;
-    }
-    const std::vector<uint8_t> *buf_;
+    std::vector<Slot, SlotAllocator> slots_;
+    size_t used_;
   };
 
-  typedef std::set<size_t, KeyOffsetCompare> KeyOffsetMap;
-  typedef std::set<StringOffset, StringOffsetCompare> StringOffsetMap;
+  BytesPool key_pool;
+  BytesPool string_pool;
 
-  KeyOffsetMap key_pool;
-  StringOffsetMap string_pool;
+  // The keys vectors written so far, see KeysVector().
+  std::vector<uint8_t> key_vectors_;
+  BytesPool key_vector_pool;
 };
 
 }  // namespace flexbuffers
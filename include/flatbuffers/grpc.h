@@ -19,6 +19,10 @@
 
 // Helper functionality to glue FlatBuffers and GRPC.
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+
 #include "flatbuffers/flatbuffers.h"
 #include "grpc++/support/byte_buffer.h"
 #include "grpc/byte_buffer_reader.h"
@@ -26,21 +30,131 @@
 namespace flatbuffers {
 namespace grpc {
 
+// How received messages are verified. By default Deserialize() verifies each
+// one before handing it to the application. With kVerifyOnAccess it doesn't,
+// and it is up to the handler to call Verify() or GetVerifiedRoot() (which
+// only verify once per message), so messages that are dropped or forwarded
+// untouched are never walked. kVerifyNever trusts the peer entirely.
+// kVerifyFramesOnReceive is for receivers of streams a FrameWriter batches:
+// like kVerifyOnReceive, but a message that is a batch is verified frame by
+// frame with VerifyFrames(). A batch still isn't a T, so Verify() and
+// GetVerifiedRoot() fail on it, and it should be read with a FrameReader or
+// SplitFrames().
+enum ReceiveVerification {
+  kVerifyOnReceive,
+  kVerifyOnAccess,
+  kVerifyNever,
+  kVerifyFramesOnReceive
+};
+
+// Counters kept by Deserialize(), for all message types together, to tell how
+// often received messages had to be copied to make them contiguous.
+struct ReceiveStats {
+  std::atomic<size_t> messages;      // Messages received.
+  std::atomic<size_t> zero_copy;     // Of those, referenced in place.
+  std::atomic<size_t> copied;        // Of those, copied into a new slice.
+  std::atomic<size_t> bytes_copied;  // Payload bytes the copies took.
+  std::atomic<size_t> verified;      // Verifications run, on receive or not.
+
+  void Reset() {
+    messages = 0;
+    zero_copy = 0;
+    copied = 0;
+    bytes_copied = 0;
+    verified = 0;
+  }
+};
+
+namespace detail {
+// Statics in inline functions, so they are shared across translation units
+// without needing a .cpp file.
+inline ReceiveStats &ReceiveStatsInstance() {
+  static ReceiveStats stats;  // Zero-initialized, being static.
+  return stats;
+}
+
+inline std::atomic<int> &ReceiveVerificationInstance() {
+#if FLATBUFFERS_GRPC_DISABLE_AUTO_VERIFICATION
+  static std::atomic<int> mode(kVerifyNever);
+#else
+  static std::atomic<int> mode(kVerifyOnReceive);
+#endif
+  return mode;
+}
+
+// The mode of messages of type T, or -1 to use the one above.
+template<class T> std::atomic<int> &TypeReceiveVerificationInstance() {
+  static std::atomic<int> mode(-1);
+  return mode;
+}
+}  // namespace detail
+
+inline const ReceiveStats &GetReceiveStats() {
+  return detail::ReceiveStatsInstance();
+}
+
+inline void ResetReceiveStats() { detail::ReceiveStatsInstance().Reset(); }
+
+inline ReceiveVerification GetReceiveVerification() {
+  return static_cast<ReceiveVerification>(
+      detail::ReceiveVerificationInstance().load());
+}
+
+// Sets how messages received from now on are verified, unless their type has
+// a mode of its own. Defaults to kVerifyNever when
+// FLATBUFFERS_GRPC_DISABLE_AUTO_VERIFICATION is set, kVerifyOnReceive
+// otherwise.
+inline void SetReceiveVerification(ReceiveVerification mode) {
+  detail::ReceiveVerificationInstance() = mode;
+}
+
+// How messages of type T are verified: the mode set for T, if any, or the
+// default above.
+template<class T> ReceiveVerification GetReceiveVerification() {
+  auto mode = detail::TypeReceiveVerificationInstance<T>().load();
+  return mode < 0 ? GetReceiveVerification()
+                  : static_cast<ReceiveVerification>(mode);
+}
+
+// Sets how messages of type T received from now on are verified, e.g.
+// kVerifyFramesOnReceive for the response type of a batched stream, leaving
+// other types alone.
+template<class T> void SetReceiveVerification(ReceiveVerification mode) {
+  detail::TypeReceiveVerificationInstance<T>() = mode;
+}
+
+// Makes messages of type T follow the default mode again.
+template<class T> void ResetReceiveVerification() {
+  detail::TypeReceiveVerificationInstance<T>() = -1;
+}
+
 // Message is a typed wrapper around a buffer that manages the underlying
 // `grpc_slice` and also provides flatbuffers-specific helpers such as `Verify`
 // and `GetRoot`. Since it is backed by a `grpc_slice`, the underlying buffer
 // is refcounted and ownership is be managed automatically.
 template<class T> class Message {
  public:
-  Message() : slice_(grpc_empty_slice()) {}
+  typedef T RootType;
+
+  Message()
+      : slice_(grpc_empty_slice()),
+        verified_(kUnverified),
+        frames_verified_(kUnverified) {}
 
   Message(grpc_slice slice, bool add_ref)
-      : slice_(add_ref ? grpc_slice_ref(slice) : slice) {}
+      : slice_(add_ref ? grpc_slice_ref(slice) : slice),
+        verified_(kUnverified),
+        frames_verified_(kUnverified) {}
 
   Message &operator=(const Message &other) = delete;
 
-  Message(Message &&other) : slice_(other.slice_) {
+  Message(Message &&other)
+      : slice_(other.slice_),
+        verified_(other.verified_),
+        frames_verified_(other.frames_verified_) {
     other.slice_ = grpc_empty_slice();
+    other.verified_ = kUnverified;
+    other.frames_verified_ = kUnverified;
   }
 
   Message(const Message &other) = delete;
@@ -48,7 +162,11 @@ template<class T> class Message {
   Message &operator=(Message &&other) {
     grpc_slice_unref(slice_);
     slice_ = other.slice_;
+    verified_ = other.verified_;
+    frames_verified_ = other.frames_verified_;
     other.slice_ = grpc_empty_slice();
+    other.verified_ = kUnverified;
+    other.frames_verified_ = kUnverified;
     return *this;
   }
 
@@ -60,30 +178,242 @@ template<class T> class Message {
 
   size_t size() const { return GRPC_SLICE_LENGTH(slice_); }
 
+  // Verifies the message as a T the first time it is called, and returns the
+  // same result after that without walking the buffer again. A batch made by
+  // a FrameWriter isn't a T, see VerifyFrames() for those.
   bool Verify() const {
-    Verifier verifier(data(), size());
-    return verifier.VerifyBuffer<T>(nullptr);
+    if (verified_ == kUnverified) {
+      Verifier verifier(data(), size());
+      verified_ = verifier.VerifyBuffer<T>(nullptr) ? kValid : kInvalid;
+      detail::ReceiveStatsInstance().verified++;
+    }
+    return verified_ == kValid;
+  }
+
+  // For streams a FrameWriter may batch: verifies every frame of a batch, or
+  // just this message as with Verify() if it isn't one. Like Verify(), only
+  // walks the buffer the first time.
+  bool VerifyFrames() const {
+    if (!IsFrameBatch()) return Verify();
+    if (frames_verified_ == kUnverified) {
+      std::vector<Message> frames;
+      auto ok = SplitFrames(&frames);
+      for (auto it = frames.begin(); ok && it != frames.end(); ++it)
+        ok = it->Verify();
+      frames_verified_ = ok ? kValid : kInvalid;
+    }
+    return frames_verified_ == kValid;
+  }
+
+  // Whether this message looks like several FlatBuffers packed by a
+  // FrameWriter: those start with a root offset of 0, which FlatBufferBuilder
+  // never writes. Only SplitFrames(), VerifyFrames() and FrameReader go by
+  // this, everything else takes a message to be one T.
+  bool IsFrameBatch() const {
+    return size() >= kFrameBatchHeaderSize &&
+           ReadScalar<uoffset_t>(data()) == 0;
+  }
+
+  // Appends the messages in this batch to `frames`, each referencing its
+  // part of this message's slice, or just this message if it isn't a batch.
+  // Returns false if the batch is malformed. Frames of a batch checked with
+  // VerifyFrames() are verified too.
+  // Frames are aligned to FLATBUFFERS_MAX_ALIGNMENT if the batch is: gRPC
+  // only stores slices of up to GRPC_SLICE_INLINED_SIZE bytes inline (and so
+  // unaligned), and a batch that small holds no valid FlatBuffer.
+  bool SplitFrames(std::vector<Message> *frames) const {
+    if (!IsFrameBatch()) {
+      frames->push_back(Message(slice_, true));
+      frames->back().verified_ = verified_;
+      return true;
+    }
+    auto count = ReadScalar<uoffset_t>(data() + sizeof(uoffset_t));
+    size_t pos = kFrameBatchHeaderSize;
+    for (uoffset_t i = 0; i < count; i++) {
+      pos = FramePrefixOffset(pos);
+      if (pos + sizeof(uoffset_t) > size()) return false;
+      auto frame_size = ReadScalar<uoffset_t>(data() + pos);
+      pos += sizeof(uoffset_t);
+      if (frame_size > size() - pos) return false;
+      frames->push_back(Message(SubSlice(slice_, pos, pos + frame_size),
+                                false));
+      frames->back().verified_ = frames_verified_;
+      pos += frame_size;
+    }
+    return true;
   }
 
   T *GetMutableRoot() { return flatbuffers::GetMutableRoot<T>(mutable_data()); }
 
   const T *GetRoot() const { return flatbuffers::GetRoot<T>(data()); }
 
+  // Like GetRoot(), but verifies first if that hasn't been done yet, and
+  // returns nullptr if the message doesn't verify. For use with
+  // kVerifyOnAccess.
+  const T *GetVerifiedRoot() const { return Verify() ? GetRoot() : nullptr; }
+
   // This is only intended for serializer use, or if you know what you're doing
   const grpc_slice &BorrowSlice() const { return slice_; }
 
  private:
+  enum VerifyState { kUnverified, kValid, kInvalid };
+
+  // The batch marker and frame count.
+  static const size_t kFrameBatchHeaderSize = 2 * sizeof(uoffset_t);
+
+  // Where the size prefix of a frame written at or after `pos` goes, so that
+  // the FlatBuffer after it is aligned for any scalar or struct in it.
+  static size_t FramePrefixOffset(size_t pos) {
+    pos += sizeof(uoffset_t);
+    pos += PaddingBytes(pos, FLATBUFFERS_MAX_ALIGNMENT);
+    return pos - sizeof(uoffset_t);
+  }
+
+  // Like grpc_slice_sub(), but references `slice` even for small parts,
+  // which grpc_slice_sub() copies into the returned slice itself, where they
+  // are unaligned.
+  static grpc_slice SubSlice(const grpc_slice &slice, size_t begin,
+                             size_t end) {
+    return grpc_slice_ref(grpc_slice_sub_no_ref(slice, begin, end));
+  }
+
+  template<class U> friend class FrameWriter;
+
   grpc_slice slice_;
+  mutable VerifyState verified_;
+  mutable VerifyState frames_verified_;  // Of a batch, see VerifyFrames().
 };
 
 class MessageBuilder;
 
+// SlicePool keeps the memory of slices that gRPC is done with, rounded up to
+// power of 2 size classes, so builders sending many similar messages (e.g. on
+// a streaming call) don't go to the heap for each one. Slices handed out may
+// outlive the pool: memory coming back after it is gone is simply freed.
+// Thread-safe, since gRPC may release slices on any thread.
+class SlicePool {
+ public:
+  // Smallest and largest size classes. Larger slices bypass the pool.
+  static const size_t kMinSizeClass = 256;
+  static const size_t kMaxSizeClass = 1 << 22;
+
+  // `max_cached` is the number of free blocks kept per size class.
+  explicit SlicePool(size_t max_cached = 16)
+      : state_(std::make_shared<State>(max_cached)) {}
+
+  SlicePool(const SlicePool &other) = delete;
+  SlicePool &operator=(const SlicePool &other) = delete;
+
+  // A slice of exactly `size` bytes, in a block of its size class.
+  grpc_slice Allocate(size_t size) {
+    auto size_class = SizeClass(size);
+    if (size_class > kMaxSizeClass) return grpc_slice_malloc(size);
+    Block *block = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(state_->mutex);
+      auto &cached = state_->lists[SizeClassIndex(size_class)];
+      if (!cached.empty()) {
+        block = cached.back();
+        cached.pop_back();
+        state_->reused++;
+      } else {
+        state_->allocated++;
+      }
+    }
+    if (!block) block = new Block(new uint8_t[size_class], size_class);
+    block->state = state_;
+    return grpc_slice_new_with_user_data(block->data, size, Release, block);
+  }
+
+  // Frees all cached blocks.
+  void Trim() { state_->Trim(); }
+
+  // The number of slices handed out using a cached block, and using a newly
+  // allocated one.
+  size_t reused() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->reused;
+  }
+  size_t allocated() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->allocated;
+  }
+
+ private:
+  static const size_t kNumSizeClasses = 15;  // kMinSizeClass..kMaxSizeClass
+
+  struct State;
+
+  struct Block {
+    Block(uint8_t *_data, size_t _size_class)
+        : data(_data), size_class(_size_class) {}
+    ~Block() { delete[] data; }
+    uint8_t *data;
+    size_t size_class;
+    std::shared_ptr<State> state;  // Set while the block is in use.
+  };
+
+  struct State {
+    explicit State(size_t _max_cached)
+        : max_cached(_max_cached), reused(0), allocated(0) {}
+    ~State() { Trim(); }
+    void Trim() {
+      std::vector<Block *> trimmed;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < kNumSizeClasses; i++) {
+          trimmed.insert(trimmed.end(), lists[i].begin(), lists[i].end());
+          lists[i].clear();
+        }
+      }
+      for (auto it = trimmed.begin(); it != trimmed.end(); ++it) delete *it;
+    }
+    std::mutex mutex;
+    std::vector<Block *> lists[kNumSizeClasses];
+    size_t max_cached;
+    size_t reused;
+    size_t allocated;
+  };
+
+  // Called by gRPC when the last reference to a slice goes away.
+  static void Release(void *user_data) {
+    auto block = static_cast<Block *>(user_data);
+    // Cached blocks don't keep the pool alive; this may be the last reference.
+    auto state = std::move(block->state);
+    {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      auto &cached = state->lists[SizeClassIndex(block->size_class)];
+      if (cached.size() < state->max_cached) {
+        cached.push_back(block);
+        block = nullptr;
+      }
+    }
+    delete block;
+  }
+
+  static size_t SizeClass(size_t size) {
+    size_t size_class = kMinSizeClass;
+    while (size_class < size) size_class <<= 1;
+    return size_class;
+  }
+
+  static size_t SizeClassIndex(size_t size_class) {
+    size_t index = 0;
+    while ((kMinSizeClass << index) < size_class) index++;
+    return index;
+  }
+
+  std::shared_ptr<State> state_;
+};
+
 // SliceAllocator is a gRPC-specific allocator that uses the `grpc_slice`
 // refcounted slices to manage memory ownership. This makes it easy and
-// efficient to transfer buffers to gRPC.
+// efficient to transfer buffers to gRPC. Slices come from `pool` if given
+// (not owned), and are allocated one by one otherwise.
 class SliceAllocator : public Allocator {
  public:
-  SliceAllocator() : slice_(grpc_empty_slice()) {}
+  explicit SliceAllocator(SlicePool *pool = nullptr)
+      : slice_(grpc_empty_slice()), pool_(pool) {}
 
   SliceAllocator(const SliceAllocator &other) = delete;
   SliceAllocator &operator=(const SliceAllocator &other) = delete;
@@ -92,7 +422,7 @@ class SliceAllocator : public Allocator {
 
   virtual uint8_t *allocate(size_t size) override {
     assert(GRPC_SLICE_IS_EMPTY(slice_));
-    slice_ = grpc_slice_malloc(size);
+    slice_ = NewSlice(size);
     return GRPC_SLICE_START_PTR(slice_);
   }
 
@@ -110,7 +440,7 @@ class SliceAllocator : public Allocator {
     assert(old_size == GRPC_SLICE_LENGTH(slice_));
     assert(new_size > old_size);
     grpc_slice old_slice = slice_;
-    grpc_slice new_slice = grpc_slice_malloc(new_size);
+    grpc_slice new_slice = NewSlice(new_size);
     uint8_t *new_p = GRPC_SLICE_START_PTR(new_slice);
     memcpy_downward(old_p, old_size, new_p, new_size, in_use_back,
                     in_use_front);
@@ -126,7 +456,12 @@ class SliceAllocator : public Allocator {
     return slice_;
   }
 
+  grpc_slice NewSlice(size_t size) {
+    return pool_ ? pool_->Allocate(size) : grpc_slice_malloc(size);
+  }
+
   grpc_slice slice_;
+  SlicePool *pool_;
 
   friend class MessageBuilder;
 };
@@ -136,6 +471,7 @@ class SliceAllocator : public Allocator {
 // the allocator is used in the FlatBufferBuilder ctor.
 namespace detail {
 struct SliceAllocatorMember {
+  explicit SliceAllocatorMember(SlicePool *pool) : slice_allocator_(pool) {}
   SliceAllocator slice_allocator_;
 };
 }  // namespace detail
@@ -146,7 +482,14 @@ class MessageBuilder : private detail::SliceAllocatorMember,
                        public FlatBufferBuilder {
  public:
   explicit MessageBuilder(uoffset_t initial_size = 1024)
-      : FlatBufferBuilder(initial_size, &slice_allocator_, false) {}
+      : detail::SliceAllocatorMember(nullptr),
+        FlatBufferBuilder(initial_size, &slice_allocator_, false) {}
+
+  // Takes the slices for its buffers from `pool`, which must outlive the
+  // builder (but not the messages it released).
+  MessageBuilder(uoffset_t initial_size, SlicePool *pool)
+      : detail::SliceAllocatorMember(pool),
+        FlatBufferBuilder(initial_size, &slice_allocator_, false) {}
 
   MessageBuilder(const MessageBuilder &other) = delete;
   MessageBuilder &operator=(const MessageBuilder &other) = delete;
@@ -188,6 +531,128 @@ class MessageBuilder : private detail::SliceAllocatorMember,
   // SliceAllocator slice_allocator_;  // part of SliceAllocatorMember
 };
 
+// clang-format off
+#ifdef FLATBUFFERS_THREAD_LOCAL
+// clang-format on
+// The calling thread's MessageBuilder, `Clear()`-ed and ready for a new
+// message. Its slices come from a SlicePool of the same thread, so a thread
+// serving many calls reuses the memory of messages gRPC has finished sending
+// rather than allocating for each one. Use it for one message at a time, and
+// `ReleaseMessage()` that before building the next.
+inline MessageBuilder &ThreadMessageBuilder() {
+  // Constructed in this order, so destroyed in the reverse.
+  static FLATBUFFERS_THREAD_LOCAL SlicePool pool;
+  static FLATBUFFERS_THREAD_LOCAL MessageBuilder builder(1024, &pool);
+  builder.Clear();
+  return builder;
+}
+// clang-format off
+#endif  // FLATBUFFERS_THREAD_LOCAL
+// clang-format on
+
+// FrameWriter packs many small FlatBuffers into one message, each as a
+// size-prefixed frame, so a streaming call can send them with one slice and
+// one Write() rather than one each. The receiving side gets them back with
+// Message<T>::SplitFrames(), or one at a time with a FrameReader, without
+// copying.
+// A batch is laid out as a root offset of 0 (which marks it), the number of
+// frames, then the frames, each a 32-bit size followed by the FlatBuffer,
+// padded so that every FlatBuffer is aligned to FLATBUFFERS_MAX_ALIGNMENT.
+template<class T> class FrameWriter {
+ public:
+  // Batches are at most `capacity` bytes, taken from `pool` if given (not
+  // owned, must outlive the writer).
+  explicit FrameWriter(size_t capacity = 64 * 1024, SlicePool *pool = nullptr)
+      : capacity_(capacity), pool_(pool), slice_(grpc_empty_slice()),
+        size_(0), count_(0) {}
+
+  FrameWriter(const FrameWriter &other) = delete;
+  FrameWriter &operator=(const FrameWriter &other) = delete;
+
+  ~FrameWriter() { grpc_slice_unref(slice_); }
+
+  // Copies the `size` byte FlatBuffer at `buf` (not size-prefixed) in as the
+  // next frame. Returns false if there is no room left, in which case the
+  // batch should be sent with Release() first. A FlatBuffer larger than the
+  // capacity never fits, and should be sent on its own.
+  bool Add(const uint8_t *buf, size_t size) {
+    if (GRPC_SLICE_IS_EMPTY(slice_)) {
+      slice_ =
+          pool_ ? pool_->Allocate(capacity_) : grpc_slice_malloc(capacity_);
+      size_ = Message<T>::kFrameBatchHeaderSize;
+      count_ = 0;
+    }
+    auto prefix = Message<T>::FramePrefixOffset(size_);
+    if (prefix + sizeof(uoffset_t) + size > capacity_) return false;
+    auto p = GRPC_SLICE_START_PTR(slice_);
+    memset(p + size_, 0, prefix - size_);
+    WriteScalar(p + prefix, static_cast<uoffset_t>(size));
+    memcpy(p + prefix + sizeof(uoffset_t), buf, size);
+    size_ = prefix + sizeof(uoffset_t) + size;
+    count_++;
+    return true;
+  }
+
+  // Adds the finished buffer of `fbb`, which can then be Clear()-ed and
+  // reused for the next one.
+  bool Add(const FlatBufferBuilder &fbb) {
+    return Add(fbb.GetBufferPointer(), fbb.GetSize());
+  }
+
+  bool Add(const Message<T> &msg) { return Add(msg.data(), msg.size()); }
+
+  // The number of frames in the current batch.
+  size_t count() const { return count_; }
+
+  bool empty() const { return count_ == 0; }
+
+  // Returns the frames added so far as one message, and starts a new batch.
+  Message<T> Release() {
+    if (!count_) return Message<T>();
+    auto p = GRPC_SLICE_START_PTR(slice_);
+    WriteScalar(p, static_cast<uoffset_t>(0));
+    WriteScalar(p + sizeof(uoffset_t), static_cast<uoffset_t>(count_));
+    Message<T> msg(Message<T>::SubSlice(slice_, 0, size_), false);
+    grpc_slice_unref(slice_);
+    slice_ = grpc_empty_slice();
+    count_ = 0;
+    return msg;
+  }
+
+ private:
+  size_t capacity_;
+  SlicePool *pool_;
+  grpc_slice slice_;
+  size_t size_;
+  size_t count_;
+};
+
+// FrameReader reads messages one at a time from a gRPC reader (anything with
+// `bool Read(M *)`, such as a ClientReader or ServerReaderWriter), splitting
+// batches sent by a FrameWriter into their frames. Plain messages pass
+// through unchanged, so it works whether or not the sender batches.
+// `M` is the `Message<T>` type, as used in the generated service.
+template<class M> class FrameReader {
+ public:
+  FrameReader() : next_(0) {}
+
+  // Like `reader->Read(msg)`. A malformed batch ends the stream.
+  template<class Reader> bool Read(Reader *reader, M *msg) {
+    while (next_ == frames_.size()) {
+      frames_.clear();
+      next_ = 0;
+      M batch;
+      if (!reader->Read(&batch) || !batch.SplitFrames(&frames_)) return false;
+    }
+    *msg = std::move(frames_[next_++]);
+    return true;
+  }
+
+ private:
+  std::vector<M> frames_;
+  size_t next_;
+};
+
 }  // namespace grpc
 }  // namespace flatbuffers
 
@@ -209,20 +674,38 @@ template<class T> class SerializationTraits<flatbuffers::grpc::Message<T>> {
     return grpc::Status::OK;
   }
 
-  // Deserialize by pulling the
+  // Deserialize by pulling the payload out of `buffer`, without copying it
+  // when it sits in a single slice.
   static grpc::Status Deserialize(grpc_byte_buffer *buffer,
                                   flatbuffers::grpc::Message<T> *msg) {
     if (!buffer) {
       return ::grpc::Status(::grpc::StatusCode::INTERNAL, "No payload");
     }
-    // Check if this is a single uncompressed slice.
+    auto &stats = flatbuffers::grpc::detail::ReceiveStatsInstance();
+    stats.messages++;
+    // Find the one slice holding the whole payload, if there is one: gRPC
+    // may hand us empty slices around it, which needn't force a copy.
+    const grpc_slice *payload = nullptr;
+    bool contiguous = false;
     if ((buffer->type == GRPC_BB_RAW) &&
-        (buffer->data.raw.compression == GRPC_COMPRESS_NONE) &&
-        (buffer->data.raw.slice_buffer.count == 1)) {
-      // If it is, then we can reference the `grpc_slice` directly.
-      grpc_slice slice = buffer->data.raw.slice_buffer.slices[0];
-      // We wrap a `Message<T>` around the slice, incrementing the refcount.
-      *msg = flatbuffers::grpc::Message<T>(slice, true);
+        (buffer->data.raw.compression == GRPC_COMPRESS_NONE)) {
+      const grpc_slice_buffer &slices = buffer->data.raw.slice_buffer;
+      contiguous = true;
+      for (size_t i = 0; i < slices.count; i++) {
+        if (GRPC_SLICE_IS_EMPTY(slices.slices[i])) continue;
+        if (payload) {
+          contiguous = false;
+          break;
+        }
+        payload = &slices.slices[i];
+      }
+    }
+    if (contiguous) {
+      // If so, we can reference the `grpc_slice` directly. We wrap a
+      // `Message<T>` around it, incrementing the refcount.
+      *msg = payload ? flatbuffers::grpc::Message<T>(*payload, true)
+                     : flatbuffers::grpc::Message<T>();
+      stats.zero_copy++;
     } else {
       // Otherwise, we need to use `grpc_byte_buffer_reader_readall` to read
       // `buffer` into a single contiguous `grpc_slice`. The gRPC reader gives
@@ -233,18 +716,24 @@ template<class T> class SerializationTraits<flatbuffers::grpc::Message<T>> {
       grpc_byte_buffer_reader_destroy(&reader);
       // We wrap a `Message<T>` around the slice, but dont increment refcount
       *msg = flatbuffers::grpc::Message<T>(slice, false);
+      stats.copied++;
+      stats.bytes_copied += msg->size();
     }
     grpc_byte_buffer_destroy(buffer);
-#if FLATBUFFERS_GRPC_DISABLE_AUTO_VERIFICATION
-    return ::grpc::Status::OK;
-#else
-    if (msg->Verify()) {
+    bool ok;
+    switch (flatbuffers::grpc::GetReceiveVerification<T>()) {
+      case flatbuffers::grpc::kVerifyOnReceive: ok = msg->Verify(); break;
+      case flatbuffers::grpc::kVerifyFramesOnReceive:
+        ok = msg->VerifyFrames();
+        break;
+      default: ok = true; break;
+    }
+    if (ok) {
       return ::grpc::Status::OK;
     } else {
       return ::grpc::Status(::grpc::StatusCode::INTERNAL,
                             "Message verification failed");
     }
-#endif
   }
 };
 
@@ -22,6 +22,12 @@
 
 #include "flatbuffers/flatbuffers.h"
 
+// clang-format off
+#ifndef FLATBUFFERS_CPP98_STL
+  #include <random>
+#endif
+// clang-format on
+
 namespace flatbuffers {
 
 template<typename T> struct FnvTraits {
@@ -67,6 +73,120 @@ template <> FLATBUFFERS_CONSTEXPR_CPP14 inline uint16_t HashFnv1a<uint16_t>(cons
   return (hash >> 16) ^ (hash & 0xffff);
 }
 
+// xxHash64, for hashing larger amounts of data than FNV is suited for: it
+// processes 32 bytes at a time rather than one (8 for the last 31 bytes).
+// Also the better choice for strings of more than a few characters, and its
+// bits are well distributed, so any of them can be used as a smaller hash.
+class XxHash64 {
+ public:
+  static uint64_t Hash(const void *data, size_t len, uint64_t seed = 0) {
+    auto p = reinterpret_cast<const uint8_t *>(data);
+    auto end = p + len;
+    uint64_t h;
+    if (len >= 32) {
+      uint64_t v1 = seed + kPrime1 + kPrime2;
+      uint64_t v2 = seed + kPrime2;
+      uint64_t v3 = seed;
+      uint64_t v4 = seed - kPrime1;
+      for (; p + 32 <= end; p += 32) {
+        v1 = Round(v1, Read64(p));
+        v2 = Round(v2, Read64(p + 8));
+        v3 = Round(v3, Read64(p + 16));
+        v4 = Round(v4, Read64(p + 24));
+      }
+      h = Rotl(v1, 1) + Rotl(v2, 7) + Rotl(v3, 12) + Rotl(v4, 18);
+      h = MergeRound(h, v1);
+      h = MergeRound(h, v2);
+      h = MergeRound(h, v3);
+      h = MergeRound(h, v4);
+    } else {
+      h = seed + kPrime5;
+    }
+    h += len;
+    for (; p + 8 <= end; p += 8) {
+      h ^= Round(0, Read64(p));
+      h = Rotl(h, 27) * kPrime1 + kPrime4;
+    }
+    if (p + 4 <= end) {
+      h ^= Read32(p) * kPrime1;
+      h = Rotl(h, 23) * kPrime2 + kPrime3;
+      p += 4;
+    }
+    for (; p < end; p++) {
+      h ^= *p * kPrime5;
+      h = Rotl(h, 11) * kPrime1;
+    }
+    h ^= h >> 33;
+    h *= kPrime2;
+    h ^= h >> 29;
+    h *= kPrime3;
+    h ^= h >> 32;
+    return h;
+  }
+
+  // Hashes `count` strings at once, where the `i`th is the `lengths[i]` bytes
+  // at `strings[i]`, into `hashes[i]` (like Hash()). Many strings, such as
+  // identifiers from all over the heap, hash faster like this than one after
+  // the other: the next strings are prefetched while hashing the current one.
+  static void HashBatch(const char *const *strings, const size_t *lengths,
+                        size_t count, uint64_t *hashes, uint64_t seed = 0) {
+    for (size_t i = 0; i < count; i++) {
+      if (i + kPrefetchDistance < count)
+        FLATBUFFERS_PREFETCH(strings[i + kPrefetchDistance]);
+      hashes[i] = Hash(strings[i], lengths[i], seed);
+    }
+  }
+
+  // The same for `count` 0-terminated strings.
+  static void HashBatch(const char *const *strings, size_t count,
+                        uint64_t *hashes, uint64_t seed = 0) {
+    for (size_t i = 0; i < count; i++) {
+      if (i + kPrefetchDistance < count)
+        FLATBUFFERS_PREFETCH(strings[i + kPrefetchDistance]);
+      hashes[i] = Hash(strings[i], strlen(strings[i]), seed);
+    }
+  }
+
+ private:
+  // How many strings ahead HashBatch() prefetches.
+  static const size_t kPrefetchDistance = 8;
+
+  static const uint64_t kPrime1 = 11400714785074694791ULL;
+  static const uint64_t kPrime2 = 14029467366897019727ULL;
+  static const uint64_t kPrime3 = 1609587929392839161ULL;
+  static const uint64_t kPrime4 = 9650029242287828579ULL;
+  static const uint64_t kPrime5 = 2870177450012600261ULL;
+
+  static uint64_t Rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+  static uint64_t Round(uint64_t acc, uint64_t input) {
+    return Rotl(acc + input * kPrime2, 31) * kPrime1;
+  }
+
+  static uint64_t MergeRound(uint64_t acc, uint64_t val) {
+    return (acc ^ Round(0, val)) * kPrime1 + kPrime4;
+  }
+
+  // The input may be unaligned.
+  static uint64_t Read64(const uint8_t *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return EndianScalar(v);
+  }
+
+  static uint64_t Read32(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return EndianScalar(v);
+  }
+};
+
+// xxHash64 of a 0-terminated string, folded to smaller types by taking the
+// low bits, for the `hash` attribute.
+template<typename T> T HashXxHash64(const char *input) {
+  return static_cast<T>(XxHash64::Hash(input, strlen(input)));
+}
+
 template <typename T> struct NamedHashFunction {
   const char *name;
 
@@ -77,16 +197,129 @@ template <typename T> struct NamedHashFunction {
 const NamedHashFunction<uint16_t> kHashFunctions16[] = {
   { "fnv1_16",  HashFnv1<uint16_t> },
   { "fnv1a_16", HashFnv1a<uint16_t> },
+  { "xxhash_16", HashXxHash64<uint16_t> },
 };
 
 const NamedHashFunction<uint32_t> kHashFunctions32[] = {
   { "fnv1_32", HashFnv1<uint32_t> },
   { "fnv1a_32", HashFnv1a<uint32_t> },
+  { "xxhash_32", HashXxHash64<uint32_t> },
 };
 
 const NamedHashFunction<uint64_t> kHashFunctions64[] = {
   { "fnv1_64", HashFnv1<uint64_t> },
   { "fnv1a_64", HashFnv1a<uint64_t> },
+  { "xxhash_64", HashXxHash64<uint64_t> },
+};
+
+// Remembers which buffers have been verified, so that verifying a buffer
+// byte-identical to one verified before only costs hashing it. Buffers are
+// identified by their root type, length and a 64 bit hash of their
+// contents, with only the most recent `capacity` ones remembered (roughly).
+// The hash is seeded randomly by default, but it isn't a cryptographic hash:
+// this is not a defense against adversarial inputs, which may collide with a
+// verified buffer and skip verification. Only use it for trusted sources.
+// This class is not thread-safe.
+class VerificationCache {
+ public:
+  explicit VerificationCache(size_t capacity = 1024,
+                             uoffset_t max_depth = 64,
+                             uoffset_t max_tables = 1000000)
+      : max_depth_(max_depth), max_tables_(max_tables), hits_(0), misses_(0) {
+    // clang-format off
+    #ifndef FLATBUFFERS_CPP98_STL
+      std::random_device random;
+      seed_ = (static_cast<uint64_t>(random()) << 32) ^ random();
+    #else
+      seed_ = reinterpret_cast<size_t>(this);
+    #endif
+    // clang-format on
+    size_t size = 1;
+    while (size < capacity) size *= 2;
+    Entry empty = { 0, 0, nullptr };
+    entries_.resize(size, empty);
+  }
+
+  // Use a fixed seed instead of a random one.
+  void SetSeed(uint64_t seed) {
+    seed_ = seed;
+    Clear();
+  }
+
+  // Like Verifier::VerifyBuffer<T>(identifier).
+  template<typename T>
+  bool VerifyBuffer(const uint8_t *buf, size_t len,
+                    const char *identifier = nullptr) {
+    if (identifier && (len < 2 * sizeof(uoffset_t) ||
+                       !BufferHasIdentifier(buf, identifier))) {
+      return false;
+    }
+    return Verify<T>(buf, len, false);
+  }
+
+  // Like Verifier::VerifySizePrefixedBuffer<T>(identifier).
+  template<typename T>
+  bool VerifySizePrefixedBuffer(const uint8_t *buf, size_t len,
+                                const char *identifier = nullptr) {
+    if (identifier &&
+        (len < 3 * sizeof(uoffset_t) ||
+         !BufferHasIdentifier(buf + sizeof(uoffset_t), identifier))) {
+      return false;
+    }
+    return Verify<T>(buf, len, true);
+  }
+
+  // Forget all verified buffers.
+  void Clear() {
+    Entry empty = { 0, 0, nullptr };
+    std::fill(entries_.begin(), entries_.end(), empty);
+  }
+
+  // How often a buffer was found to have been verified before, and how often
+  // it had to be verified.
+  size_t hits() const { return hits_; }
+  size_t misses() const { return misses_; }
+
+ private:
+  struct Entry {
+    uint64_t hash;
+    size_t len;
+    const void *type;  // Also tells size-prefixed buffers apart.
+  };
+
+  // An address unique to each root type and variant.
+  template<typename T, bool kSizePrefixed> static const void *TypeKey() {
+    static const char key = 0;
+    return &key;
+  }
+
+  template<typename T>
+  bool Verify(const uint8_t *buf, size_t len, bool size_prefixed) {
+    auto type = size_prefixed ? TypeKey<T, true>() : TypeKey<T, false>();
+    auto hash = XxHash64::Hash(buf, len, seed_);
+    auto &entry = entries_[static_cast<size_t>(hash) & (entries_.size() - 1)];
+    if (entry.type == type && entry.hash == hash && entry.len == len) {
+      hits_++;
+      return true;
+    }
+    misses_++;
+    Verifier verifier(buf, len, max_depth_, max_tables_);
+    // The identifier, if any, was checked already.
+    bool ok = size_prefixed ? verifier.VerifySizePrefixedBuffer<T>(nullptr)
+                            : verifier.VerifyBuffer<T>(nullptr);
+    if (ok) {
+      Entry verified = { hash, len, type };
+      entry = verified;
+    }
+    return ok;
+  }
+
+  uint64_t seed_;
+  uoffset_t max_depth_;
+  uoffset_t max_tables_;
+  std::vector<Entry> entries_;
+  size_t hits_;
+  size_t misses_;
 };
 
 inline NamedHashFunction<uint16_t>::HashFunction FindHashFunction16(
@@ -122,6 +355,106 @@ inline NamedHashFunction<uint64_t>::HashFunction FindHashFunction64(
   return nullptr;
 }
 
+// Hash indices: open addressing hash tables over a vector of tables with a
+// key field, for constant time lookups in place, see LookupByKeyHashed().
+// Fields with the `hashed` attribute get one in a generated `_hash_index`
+// field. The index is a vector of 2^k slots, each either 0 for an empty
+// slot, or 1 + the position of a table in the vector. A table goes into the
+// first empty slot at or after (HashKey(key) mod 2^k), wrapping around.
+
+// The hash of a key, as stored in a hash index: FNV-1a of the characters of
+// a string, or of the little endian bytes of a scalar.
+inline uint32_t HashKey(const char *key) { return HashFnv1a<uint32_t>(key); }
+
+inline uint32_t HashKey(const String *key) { return HashKey(key->c_str()); }
+
+template<typename T> uint32_t HashKey(T key) {
+  static_assert(flatbuffers::is_scalar<T>::value,
+                "keys are scalars or strings");
+  if (flatbuffers::is_floating_point<T>::value && key == 0) key = 0;  // -0.0
+  key = EndianScalar(key);
+  uint32_t hash = FnvTraits<uint32_t>::kOffsetBasis;
+  auto bytes = reinterpret_cast<const uint8_t *>(&key);
+  for (size_t i = 0; i < sizeof(T); i++) {
+    hash ^= bytes[i];
+    hash *= FnvTraits<uint32_t>::kFnvPrime;
+  }
+  return hash;
+}
+
+// Serialize a hash index for a vector of tables, given the HashKey() of the
+// key of each, in the order of the vector. The index has at least twice as
+// many slots as there are tables.
+inline Offset<Vector<uint32_t>> CreateHashIndex(
+    FlatBufferBuilder &fbb, const std::vector<uint32_t> &hashes) {
+  size_t num_slots = 1;
+  while (num_slots < hashes.size() * 2) num_slots *= 2;
+  std::vector<uint32_t> slots(num_slots, 0);
+  for (size_t i = 0; i < hashes.size(); i++) {
+    auto slot = hashes[i] & (num_slots - 1);
+    while (slots[slot]) slot = (slot + 1) & (num_slots - 1);
+    slots[slot] = static_cast<uint32_t>(i + 1);
+  }
+  return fbb.CreateVector(slots);
+}
+
+// Serialize a hash index for the tables `v` (stored in that order in a
+// vector), given the accessor of their key field, e.g. `&Monster::name`.
+template<typename T, typename K>
+Offset<Vector<uint32_t>> CreateHashIndex(FlatBufferBuilder &fbb,
+                                         const Offset<T> *v, size_t len,
+                                         K (T::*key)() const) {
+  std::vector<uint32_t> hashes(len);
+  for (size_t i = 0; i < len; i++)
+    hashes[i] = HashKey((GetTemporaryPointer(fbb, v[i])->*key)());
+  return CreateHashIndex(fbb, hashes);
+}
+
+template<typename T, typename K>
+Offset<Vector<uint32_t>> CreateHashIndex(FlatBufferBuilder &fbb,
+                                         const std::vector<Offset<T>> &v,
+                                         K (T::*key)() const) {
+  return CreateHashIndex(fbb, data(v), v.size(), key);
+}
+
+// Serialize a hash index for the vector `vec` already serialized in `fbb`,
+// as the object API's Pack() does. Returns 0 if `vec` is.
+template<typename T, typename K>
+Offset<Vector<uint32_t>> CreateHashIndex(FlatBufferBuilder &fbb,
+                                         Offset<Vector<Offset<T>>> vec,
+                                         K (T::*key)() const) {
+  if (vec.IsNull()) return 0;
+  auto tables = GetTemporaryPointer(fbb, vec);
+  std::vector<uint32_t> hashes(tables->size());
+  for (uoffset_t i = 0; i < tables->size(); i++)
+    hashes[i] = HashKey((tables->Get(i)->*key)());
+  return CreateHashIndex(fbb, hashes);
+}
+
+// Find the table with `key` in `vec` using its hash index: worst case this
+// checks all tables that hashed to the same slot or the slots after it, on
+// average about 1.5 tables for keys that are there. Safe to use on verified
+// buffers, a corrupt index just makes lookups fail. Returns nullptr if the key
+// is not found, or if there is no index. `key` is converted to the type of
+// the key field first, since that is what was hashed.
+template<typename T, typename K>
+const T *LookupByKeyHashed(const Vector<Offset<T>> *vec,
+                           const Vector<uint32_t> *index, K key) {
+  if (!vec || !index) return nullptr;
+  auto num_slots = index->size();
+  if (!num_slots || (num_slots & (num_slots - 1))) return nullptr;
+  auto field_key = static_cast<typename KeyType<T>::type>(key);
+  auto slot = HashKey(field_key) & (num_slots - 1);
+  for (uoffset_t probes = 0; probes < num_slots; probes++) {
+    auto i = index->Get(slot);
+    if (!i || i > vec->size()) return nullptr;
+    auto table = vec->Get(i - 1);
+    if (!table->KeyCompareWithValue(field_key)) return table;
+    slot = (slot + 1) & (num_slots - 1);
+  }
+  return nullptr;
+}
+
 }  // namespace flatbuffers
 
 #endif  // FLATBUFFERS_HASH_H_
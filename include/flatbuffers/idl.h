@@ -158,41 +158,231 @@ struct Value {
   voffset_t offset;
 };
 
+// FNV-1a of the name of a definition, for looking it up.
+inline uint64_t HashName(const char *name, size_t len) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (size_t i = 0; i < len; i++) {
+    hash ^= static_cast<uint8_t>(name[i]);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
 // Helper class that retains the original order of a set of identifiers and
-// also provides quick lookup.
+// also provides quick lookup, with an open addressing hash table. It doesn't
+// own what it refers to: the definitions of a Parser are in its
+// DefinitionArena.
 template<typename T> class SymbolTable {
  public:
-  ~SymbolTable() {
-    for (auto it = vec.begin(); it != vec.end(); ++it) { delete *it; }
-  }
+  SymbolTable() : count_(0) {}
 
   bool Add(const std::string &name, T *e) {
     vector_emplace_back(&vec, e);
-    auto it = dict.find(name);
-    if (it != dict.end()) return true;
-    dict[name] = e;
+    auto hash = HashName(name.c_str(), name.length());
+    if (Find(name.c_str(), name.length(), hash)) return true;
+    Insert(name, e, hash);
     return false;
   }
 
   void Move(const std::string &oldname, const std::string &newname) {
-    auto it = dict.find(oldname);
-    if (it != dict.end()) {
-      auto obj = it->second;
-      dict.erase(it);
-      dict[newname] = obj;
+    auto slot = Find(oldname.c_str(), oldname.length(),
+                     HashName(oldname.c_str(), oldname.length()));
+    if (slot) {
+      auto obj = slot->value;
+      Erase(slot);
+      auto hash = HashName(newname.c_str(), newname.length());
+      auto existing = Find(newname.c_str(), newname.length(), hash);
+      if (existing) {
+        existing->value = obj;
+      } else {
+        Insert(newname, obj, hash);
+      }
     } else {
       assert(false);
     }
   }
 
+  // Makes `name` unknown, though whatever it was stays in `vec`.
+  void Remove(const std::string &name) {
+    auto hash = HashName(name.c_str(), name.length());
+    auto slot = Find(name.c_str(), name.length(), hash);
+    if (slot) Erase(slot);
+  }
+
   T *Lookup(const std::string &name) const {
-    auto it = dict.find(name);
-    return it == dict.end() ? nullptr : it->second;
+    return Lookup(name.c_str(), name.length());
+  }
+
+  T *Lookup(const char *name, size_t len) const {
+    auto slot = Find(name, len, HashName(name, len));
+    return slot ? slot->value : nullptr;
+  }
+
+  // Calls f(name, e) for every name, in no particular order.
+  template<typename F> void ForEach(F f) const {
+    for (auto it = slots_.begin(); it != slots_.end(); ++it) {
+      if (it->value) f(it->name, it->value);
+    }
   }
 
  public:
-  std::map<std::string, T *> dict;  // quick lookup
-  std::vector<T *> vec;             // Used to iterate in order of insertion
+  std::vector<T *> vec;  // Used to iterate in order of insertion
+
+ private:
+  struct Slot {
+    Slot() : value(nullptr), hash(0) {}
+    std::string name;
+    T *value;  // Null if the slot is free.
+    uint64_t hash;
+  };
+
+  size_t Home(uint64_t hash) const {
+    return static_cast<size_t>(hash) & (slots_.size() - 1);
+  }
+
+  Slot *Find(const char *name, size_t len, uint64_t hash) const {
+    if (slots_.empty()) return nullptr;
+    auto mask = slots_.size() - 1;
+    for (auto i = Home(hash);; i = (i + 1) & mask) {
+      auto &slot = slots_[i];
+      if (!slot.value) return nullptr;
+      if (slot.hash == hash && slot.name.length() == len &&
+          !memcmp(slot.name.c_str(), name, len))
+        return const_cast<Slot *>(&slot);
+    }
+  }
+
+  Slot &FreeSlot(uint64_t hash) {
+    auto mask = slots_.size() - 1;
+    auto i = Home(hash);
+    while (slots_[i].value) i = (i + 1) & mask;
+    return slots_[i];
+  }
+
+  void Insert(const std::string &name, T *e, uint64_t hash) {
+    // At most half full, so lookups find a free slot soon.
+    if ((count_ + 1) * 2 > slots_.size()) {
+      std::vector<Slot> old(slots_.empty() ? 8 : slots_.size() * 2);
+      old.swap(slots_);
+      for (auto it = old.begin(); it != old.end(); ++it) {
+        if (!it->value) continue;
+        auto &slot = FreeSlot(it->hash);
+        slot.name.swap(it->name);
+        slot.value = it->value;
+        slot.hash = it->hash;
+      }
+    }
+    auto &slot = FreeSlot(hash);
+    slot.name = name;
+    slot.value = e;
+    slot.hash = hash;
+    count_++;
+  }
+
+  // Moves later slots of the same run back, so Find() needs no tombstones.
+  void Erase(Slot *slot) {
+    auto mask = slots_.size() - 1;
+    auto i = static_cast<size_t>(slot - &slots_[0]);
+    for (auto j = (i + 1) & mask; slots_[j].value; j = (j + 1) & mask) {
+      // It can fill the hole unless it hashes to somewhere after the hole.
+      if (((j - Home(slots_[j].hash)) & mask) >= ((j - i) & mask)) {
+        slots_[i].name.swap(slots_[j].name);
+        slots_[i].value = slots_[j].value;
+        slots_[i].hash = slots_[j].hash;
+        i = j;
+      }
+    }
+    slots_[i].name.clear();
+    slots_[i].value = nullptr;
+    count_--;
+  }
+
+  std::vector<Slot> slots_;
+  size_t count_;
+};
+
+// Owns the definitions of a Parser (structs, fields, enums and their values,
+// attributes...). They're allocated in large blocks rather than one at a
+// time, and are all destroyed with the arena.
+class DefinitionArena {
+ public:
+  DefinitionArena() : last_(nullptr), cur_(nullptr), end_(nullptr) {}
+
+  ~DefinitionArena() {
+    // Newest first, like destroying them one by one would.
+    for (auto object = last_; object; object = object->prev) {
+      object->destroy(object + 1);
+    }
+    for (auto it = blocks_.begin(); it != blocks_.end(); ++it) delete[] *it;
+  }
+
+  template<typename T> T *New() {
+    auto object = Allocate<T>();
+    return Track(object, new (object + 1) T());
+  }
+
+  template<typename T, typename A> T *New(const A &a) {
+    auto object = Allocate<T>();
+    return Track(object, new (object + 1) T(a));
+  }
+
+  template<typename T, typename A, typename B>
+  T *New(const A &a, const B &b) {
+    auto object = Allocate<T>();
+    return Track(object, new (object + 1) T(a, b));
+  }
+
+  template<typename T, typename A, typename B, typename C>
+  T *New(const A &a, const B &b, const C &c) {
+    auto object = Allocate<T>();
+    return Track(object, new (object + 1) T(a, b, c));
+  }
+
+ private:
+  FLATBUFFERS_DELETE_FUNC(DefinitionArena(const DefinitionArena &))
+  FLATBUFFERS_DELETE_FUNC(DefinitionArena &operator=(const DefinitionArena &))
+
+  // Precedes every object in the blocks.
+  struct Object {
+    void (*destroy)(void *);
+    Object *prev;
+  };
+
+  static const size_t kBlockSize = 16384;
+
+  template<typename T> static void Destroy(void *p) {
+    static_cast<T *>(p)->~T();
+  }
+
+  template<typename T> Object *Allocate() {
+    auto align = (std::max)(AlignOf<T>(), AlignOf<Object>());
+    auto size = sizeof(Object) + sizeof(T);
+    if (static_cast<size_t>(end_ - cur_) < size + align) {
+      // new[] aligns for any of them.
+      auto block_size =
+          (std::max)(size + align, static_cast<size_t>(kBlockSize));
+      cur_ = new uint8_t[block_size];
+      end_ = cur_ + block_size;
+      blocks_.push_back(cur_);
+    }
+    auto p = cur_ + PaddingBytes(reinterpret_cast<size_t>(cur_) +
+                                     sizeof(Object),
+                                 align);
+    cur_ = p + size;
+    return reinterpret_cast<Object *>(p);
+  }
+
+  template<typename T> T *Track(Object *object, T *t) {
+    object->destroy = Destroy<T>;
+    object->prev = last_;
+    last_ = object;
+    return t;
+  }
+
+  Object *last_;
+  uint8_t *cur_;
+  uint8_t *end_;
+  std::vector<uint8_t *> blocks_;
 };
 
 // A name space, as set in the schema.
@@ -268,7 +458,8 @@ struct StructDef : public Definition {
         sortbysize(true),
         has_key(false),
         minalign(1),
-        bytesize(0) {}
+        bytesize(0),
+        columnar_row(nullptr) {}
 
   void PadLastField(size_t min_align) {
     auto padding = PaddingBytes(bytesize, min_align);
@@ -279,6 +470,24 @@ struct StructDef : public Definition {
   Offset<reflection::Object> Serialize(FlatBufferBuilder *builder,
                                        const Parser &parser) const;
 
+  // Same as fields.Lookup(), but always with a single probe, for parsing
+  // JSON. Needs IndexFields() after fields are added.
+  FieldDef *LookupField(const char *field_name, size_t len) const {
+    if (field_slots.empty()) {
+      return fields.Lookup(field_name, len);
+    }
+    auto hash = HashName(field_name, len);
+    auto seed = field_seeds[(hash >> 48) & (field_seeds.size() - 1)];
+    auto field = field_slots[FieldSlot(hash, seed)];
+    return field && field->name.length() == len &&
+                   !memcmp(field->name.c_str(), field_name, len)
+               ? field
+               : nullptr;
+  }
+
+  // Builds a perfect hash table of the field names for LookupField().
+  void IndexFields();
+
   SymbolTable<FieldDef> fields;
 
   bool fixed;       // If it's struct, not a table.
@@ -287,8 +496,23 @@ struct StructDef : public Definition {
   bool has_key;     // It has a key field.
   size_t minalign;  // What the whole object needs to be aligned to.
   size_t bytesize;  // Size if fixed.
+  // For the tables generated for (columnar) vectors: the table whose fields
+  // this one stores column by column.
+  StructDef *columnar_row;
 
   flatbuffers::unique_ptr<std::string> original_location;
+
+  // The field lookup table: the fields hashing to bucket i go in the slots
+  // picked with field_seeds[i], where none of them collide.
+  std::vector<FieldDef *> field_slots;
+  std::vector<uint32_t> field_seeds;
+
+ private:
+  size_t FieldSlot(uint64_t hash, uint32_t seed) const {
+    auto step = static_cast<uint32_t>(hash >> 32) | 1;
+    return (static_cast<uint32_t>(hash) + seed * step) &
+           (field_slots.size() - 1);
+  }
 };
 
 inline bool IsStruct(const Type &type) {
@@ -372,6 +596,7 @@ struct IDLOptions {
   bool skip_unexpected_fields_in_json;
   bool generate_name_strings;
   bool generate_object_based_api;
+  bool generate_json_api;
   std::string cpp_object_api_pointer_type;
   std::string cpp_object_api_string_type;
   bool gen_nullable;
@@ -382,6 +607,7 @@ struct IDLOptions {
   std::string include_prefix;
   bool keep_include_path;
   bool binary_schema_comments;
+  bool binary_schema_builtins;
   bool skip_flatbuffers_import;
   std::string go_import;
   std::string go_namespace;
@@ -433,6 +659,7 @@ struct IDLOptions {
         skip_unexpected_fields_in_json(false),
         generate_name_strings(false),
         generate_object_based_api(false),
+        generate_json_api(false),
         cpp_object_api_pointer_type("std::unique_ptr"),
         gen_nullable(false),
         object_suffix("T"),
@@ -440,6 +667,7 @@ struct IDLOptions {
         allow_non_utf8(false),
         keep_include_path(false),
         binary_schema_comments(false),
+        binary_schema_builtins(false),
         skip_flatbuffers_import(false),
         reexport_ts_modules(true),
         protobuf_ascii_alike(false),
@@ -508,6 +736,8 @@ class CheckedError {
 #endif
 // clang-format on
 
+class CompiledSchema;
+
 class Parser : public ParserState {
  public:
   explicit Parser(const IDLOptions &options = IDLOptions())
@@ -516,7 +746,10 @@ class Parser : public ParserState {
         root_struct_def_(nullptr),
         opts(options),
         uses_flexbuffers_(false),
+        uses_hash_indices_(false),
+        schema_(nullptr),
         source_(nullptr),
+        source_end_(nullptr),
         anonymous_counter(0) {
     // Start out with the empty namespace being current.
     empty_namespace_ = new Namespace();
@@ -543,8 +776,16 @@ class Parser : public ParserState {
     known_attributes_["native_type"] = true;
     known_attributes_["native_default"] = true;
     known_attributes_["flexbuffer"] = true;
+    known_attributes_["columnar"] = true;
+    known_attributes_["hashed"] = true;
   }
 
+  // A parser for JSON only, using the definitions of `schema` rather than its
+  // own, as well as its root type and options (which can be changed after).
+  // It is cheap to create, and any number of them can use the same schema,
+  // in different threads too.
+  explicit Parser(const CompiledSchema &schema);
+
   ~Parser() {
     for (auto it = namespaces_.begin(); it != namespaces_.end(); ++it) {
       delete *it;
@@ -580,10 +821,24 @@ class Parser : public ParserState {
   // See reflection/reflection.fbs
   void Serialize();
 
+  // The reverse of Serialize(): fills an empty parser with the definitions
+  // of a binary schema (.bfbs), as if its schema had been parsed, other than
+  // which files it came from. Parsing JSON with it works the same, if the
+  // schema was serialized with opts.binary_schema_builtins (flatc
+  // --bfbs-builtins): otherwise the attributes that change how JSON is parsed
+  // (hash, nested_flatbuffer, flexbuffer, original_order) are not in it.
+  // Verifies `buf` first. Returns false on an error, which is then in error_.
+  bool Deserialize(const uint8_t *buf, size_t size);
+  bool Deserialize(const reflection::Schema *schema);
+
   // Checks that the schema represented by this parser is a safe evolution
   // of the schema provided. Returns non-empty error on any problems.
   std::string ConformTo(const Parser &base);
 
+  // Like the above, but appends all the problems found to "errors", rather
+  // than just the first one. Returns true if there were none.
+  bool ConformTo(const Parser &base, std::vector<std::string> *errors) const;
+
   // Similar to Parse(), but now only accepts JSON to be parsed into a
   // FlexBuffer.
   bool ParseFlexBuffer(const char *source, const char *source_filename,
@@ -613,6 +868,8 @@ class Parser : public ParserState {
                                      const std::string &name, const Type &type,
                                      FieldDef **dest);
   FLATBUFFERS_CHECKED_ERROR ParseField(StructDef &struct_def);
+  FLATBUFFERS_CHECKED_ERROR LookupCreateColumns(StructDef &row,
+                                                StructDef **dest);
   FLATBUFFERS_CHECKED_ERROR ParseString(Value &val);
   FLATBUFFERS_CHECKED_ERROR ParseComma();
   FLATBUFFERS_CHECKED_ERROR ParseAnyValue(Value &val, FieldDef *field,
@@ -635,6 +892,8 @@ class Parser : public ParserState {
                                                  void *state);
   FLATBUFFERS_CHECKED_ERROR ParseTable(const StructDef &struct_def,
                                        std::string *value, uoffset_t *ovalue);
+  FLATBUFFERS_CHECKED_ERROR AddHashIndices(const StructDef &struct_def,
+                                           size_t &fieldn);
   void SerializeStruct(const StructDef &struct_def, const Value &val);
   // clang-format off
   #if defined(FLATBUFFERS_CPP98_STL)
@@ -696,6 +955,19 @@ class Parser : public ParserState {
   bool SupportsVectorOfUnions() const;
   Namespace *UniqueNamespace(Namespace *ns);
 
+  bool DeserializeError(const std::string &msg);
+  Namespace *DeserializeName(const flatbuffers::String *qualified_name,
+                             std::string *name);
+  bool DeserializeStruct(const reflection::Object &object,
+                         StructDef *struct_def);
+  bool DeserializeField(const reflection::Field &field,
+                        const StructDef &struct_def, FieldDef *field_def);
+  bool DeserializeEnum(const reflection::Enum &serialized, EnumDef *enum_def);
+  bool DeserializeType(const reflection::Type *type, Type *dest);
+  bool DeserializeAttributes(
+      const Vector<Offset<reflection::KeyValue>> *attributes,
+      Definition *def);
+
  public:
   SymbolTable<Type> types_;
   SymbolTable<StructDef> structs_;
@@ -719,9 +991,20 @@ class Parser : public ParserState {
 
   IDLOptions opts;
   bool uses_flexbuffers_;
+  bool uses_hash_indices_;
 
  private:
+  // Where the definitions are, if not in this parser.
+  const Parser *schema_;
+
+  DefinitionArena arena_;  // Everything the symbol tables above refer to.
+
+  // The definitions of the binary schema being deserialized, by index.
+  std::vector<StructDef *> deserialized_structs_;
+  std::vector<EnumDef *> deserialized_enums_;
+
   const char *source_;
+  const char *source_end_;  // The terminating 0 of source_.
 
   std::string file_being_parsed_;
 
@@ -730,6 +1013,56 @@ class Parser : public ParserState {
   int anonymous_counter;
 };
 
+// A schema parsed once and from then on only read: any number of Parsers can
+// parse JSON with it, and GenerateText() can use parser(), from many threads
+// at once, without a copy of the schema each.
+class CompiledSchema {
+ public:
+  explicit CompiledSchema(const IDLOptions &options = IDLOptions())
+      : parser_(options) {}
+
+  // Parses the schema, see Parser::Parse(). Returns false on an error, which
+  // is then in parser().error_.
+  bool Parse(const char *source, const char **include_paths = nullptr,
+             const char *source_filename = nullptr) {
+    return parser_.Parse(source, include_paths, source_filename);
+  }
+
+  // Loads a binary schema instead, see Parser::Deserialize().
+  bool Deserialize(const uint8_t *buf, size_t size) {
+    return parser_.Deserialize(buf, size);
+  }
+
+  const Parser &parser() const { return parser_; }
+
+  // Parses newline separated JSON records of the root type (NDJSON) into one
+  // buffer each, skipping blank lines. With an `executor`, parses groups of
+  // lines in parallel. Returns false if a record doesn't parse, with the
+  // first such error in `error`.
+  bool ParseRecords(const char *text, size_t len,
+                    std::vector<DetachedBuffer> *buffers, std::string *error,
+                    ParallelExecutor *executor = nullptr) const;
+
+  // Same, but writes the records to `stream` as one buffer, in order: each
+  // size prefixed, and padded so the next one is aligned too (for any
+  // buffer of this schema, e.g. to 8 bytes if it has doubles).
+  bool ParseRecordsToStream(const char *text, size_t len,
+                            std::vector<uint8_t> *stream, std::string *error,
+                            ParallelExecutor *executor = nullptr) const;
+
+ private:
+  struct Records;
+
+  bool ParseRecords(const char *text, size_t len, Records *records,
+                    std::string *error, ParallelExecutor *executor) const;
+  size_t StreamAlignment() const;
+
+  FLATBUFFERS_DELETE_FUNC(CompiledSchema(const CompiledSchema &))
+  FLATBUFFERS_DELETE_FUNC(CompiledSchema &operator=(const CompiledSchema &))
+
+  Parser parser_;
+};
+
 // Utility functions for multiple generators:
 
 extern std::string MakeCamel(const std::string &in, bool first = true);
@@ -745,6 +1078,12 @@ extern std::string MakeCamel(const std::string &in, bool first = true);
 extern bool GenerateText(const Parser &parser,
                          const void *flatbuffer,
                          std::string *text);
+
+// Same as GenerateText(), but writes the text to `sink` in chunks as it is
+// generated, rather than keeping all of it in memory. Also returns false if
+// the sink fails.
+extern bool GenerateTextTo(const Parser &parser, const void *flatbuffer,
+                           Sink &sink);
 extern bool GenerateTextFile(const Parser &parser,
                              const std::string &path,
                              const std::string &file_name);
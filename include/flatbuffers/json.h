@@ -0,0 +1,955 @@
+/*
+ * Copyright 2018 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLATBUFFERS_JSON_H_
+#define FLATBUFFERS_JSON_H_
+
+#include "flatbuffers/flatbuffers.h"
+#include "flatbuffers/flexbuffers.h"
+#include "flatbuffers/hash.h"
+#include "flatbuffers/util.h"
+
+namespace flatbuffers {
+
+// The runtime of the JSON parsers and printers generated with
+// `flatc --cpp --gen-json-api`. These are specialized for one schema, so
+// they need neither a Parser nor the schema at runtime, and read and write
+// the same JSON as Parser and GenerateText() do with the same options.
+
+struct JsonOptions {
+  // Parsing: require quoted field names and no trailing commas.
+  // Printing: quote field names.
+  bool strict_json;
+  // Parsing: ignore fields that aren't in the schema rather than fail.
+  bool skip_unexpected_fields_in_json;
+  // Parsing: accept strings that aren't valid UTF-8.
+  // Printing: write such strings with \x escapes rather than fail.
+  bool allow_non_utf8;
+  // Printing: the indentation per level. Less than 0 also means no newlines.
+  int indent_step;
+
+  JsonOptions()
+      : strict_json(false),
+        skip_unexpected_fields_in_json(false),
+        allow_non_utf8(false),
+        indent_step(2) {}
+};
+
+// Reads JSON text. Besides standard JSON, it accepts what Parser does:
+// unquoted field names (unless strict), trailing commas, comments, single
+// quoted strings, hexadecimal integers, numbers in strings and enum values
+// by name, e.g. `color: Red`, or `"Red Blue"` for several bit flags.
+//
+// Generated code reads objects with
+//   if (!json.StartObject()) return false;
+//   while (json.NextKey()) { ... switch on json.key_hash() ... }
+//   if (!json.ok()) return false;
+// and arrays the same way with StartArray() and NextElement(). All methods
+// return false on an error, after which the reader mustn't be used anymore.
+class JsonReader {
+ public:
+  // Looks up the value of an enum by name, for ParseScalar().
+  typedef bool (*EnumLookup)(const char *name, size_t len, int64_t *val);
+
+  explicit JsonReader(const char *text,
+                      const JsonOptions &opts = JsonOptions())
+      : opts_(opts),
+        text_(text),
+        cursor_(text),
+        key_(nullptr),
+        key_size_(0),
+        key_hash_(0),
+        first_(false) {
+    SkipByteOrderMark();
+  }
+
+  // Starts reading `text`, keeping the memory of the scratch buffers, so one
+  // reader can be reused for many documents without allocating.
+  void Reset(const char *text) {
+    text_ = text;
+    cursor_ = text;
+    key_ = nullptr;
+    key_size_ = 0;
+    key_hash_ = 0;
+    first_ = false;
+    elements_.clear();
+    error_.clear();
+    SkipByteOrderMark();
+  }
+
+  // The hash of field names that key_hash() returns, computed by flatc for
+  // the names in the schema.
+  static uint64_t HashKey(const char *key, size_t len) {
+    auto hash = FnvTraits<uint64_t>::kOffsetBasis;
+    for (size_t i = 0; i < len; i++) {
+      hash ^= static_cast<unsigned char>(key[i]);
+      hash *= FnvTraits<uint64_t>::kFnvPrime;
+    }
+    return hash;
+  }
+
+  // Sets the error, unless there already is one, and returns false.
+  bool Error(const std::string &msg) {
+    if (error_.empty()) {
+      auto line = 1 + std::count(text_, cursor_, '\n');
+      error_ = "line " + NumToString(line) + ": " + msg;
+    }
+    return false;
+  }
+
+  const std::string &error() const { return error_; }
+  bool ok() const { return error_.empty(); }
+
+  // Checks that nothing but whitespace follows the root value.
+  bool Finish() {
+    if (Peek()) return Error("unexpected text after the root value");
+    return ok();
+  }
+
+  bool StartObject() { return Open('{'); }
+
+  // Reads the name of the next field of the current object, and the colon
+  // after it. Returns false at the end of the object (or on an error).
+  bool NextKey() {
+    if (!NextMember('}')) return false;
+    auto c = Peek();
+    if (c == '\"' || c == '\'') {
+      if (!ReadString(&key_, &key_size_)) return false;
+      key_hash_ = HashKey(key_, key_size_);
+    } else if (!opts_.strict_json && IsIdentifierStart(c)) {
+      // Hash while scanning, since most names are unquoted.
+      auto hash = FnvTraits<uint64_t>::kOffsetBasis;
+      key_ = cursor_;
+      for (; IsIdentifierChar(*cursor_); cursor_++) {
+        hash ^= static_cast<unsigned char>(*cursor_);
+        hash *= FnvTraits<uint64_t>::kFnvPrime;
+      }
+      key_size_ = static_cast<size_t>(cursor_ - key_);
+      key_hash_ = hash;
+    } else {
+      return Error("expecting a field name");
+    }
+    return Expect(':');
+  }
+
+  uint64_t key_hash() const { return key_hash_; }
+  bool KeyIs(const char *name, size_t len) const {
+    return key_size_ == len && !memcmp(key_, name, len);
+  }
+  std::string key() const { return std::string(key_, key_size_); }
+
+  // Handles the value of a field that isn't in the schema.
+  bool UnknownField() {
+    if (KeyIs("$schema", 7)) return SkipValue();
+    if (!opts_.skip_unexpected_fields_in_json)
+      return Error("unknown field: " + key());
+    return SkipValue();
+  }
+
+  // Marks a field as seen, failing if it already was.
+  bool SetOnce(bool *seen) {
+    if (*seen) return Error("field set more than once: " + key());
+    *seen = true;
+    return true;
+  }
+
+  // Skips a null value, which leaves a field unset.
+  bool SkipNull() {
+    if (Peek() != 'n' || strncmp(cursor_, "null", 4) ||
+        IsIdentifierChar(cursor_[4]))
+      return false;
+    cursor_ += 4;
+    return true;
+  }
+
+  bool StartArray() { return Open('['); }
+
+  // Returns false at the end of the current array (or on an error).
+  bool NextElement() { return NextMember(']'); }
+
+  // The next (non-whitespace) character, 0 at the end of the text.
+  char Peek() {
+    for (;;) {
+      auto c = *cursor_;
+      if (c == ' ' || c == '\n' || c == '\t' || c == '\r') {
+        cursor_++;
+      } else if (c == '/' && cursor_[1] == '/') {
+        while (*cursor_ && *cursor_ != '\n') cursor_++;
+      } else if (c == '/' && cursor_[1] == '*') {
+        auto end = strstr(cursor_ + 2, "*/");
+        if (!end) {
+          Error("end of file in comment");
+          cursor_ += strlen(cursor_);
+          return 0;
+        }
+        cursor_ = end + 2;
+      } else {
+        return c;
+      }
+    }
+  }
+
+  // Where the reader is in the text, to Seek() back to it.
+  const char *cursor() const { return cursor_; }
+  void Seek(const char *cursor) { cursor_ = cursor; }
+
+  // Reads a number, a bool, or an enum value by name with `lookup`.
+  template<typename T> bool ParseScalar(T *val, EnumLookup lookup = nullptr) {
+    auto c = Peek();
+    const char *s;
+    size_t len;
+    if (c == '\"' || c == '\'') {
+      if (std::is_same<T, bool>::value)
+        return Error("type mismatch: expecting a bool");
+      if (!ReadString(&s, &len)) return false;
+      if (len && IsIdentifierStart(*s)) return ParseEnum(s, len, lookup, val);
+      return ConvertNumber(s, len, false, val);
+    }
+    if (IsIdentifierStart(c)) {
+      s = cursor_;
+      while (IsIdentifierChar(*cursor_)) cursor_++;
+      len = static_cast<size_t>(cursor_ - s);
+      auto is_true = len == 4 && !memcmp(s, "true", 4);
+      if (is_true || (len == 5 && !memcmp(s, "false", 5))) {
+        if (!std::is_same<T, bool>::value)
+          return Error("type mismatch: not expecting a bool");
+        *val = static_cast<T>(is_true);
+        return true;
+      }
+      return ParseEnum(s, len, lookup, val);
+    }
+    bool is_float;
+    if (!ReadNumber(&s, &len, &is_float)) return false;
+    if (is_float && !std::is_floating_point<T>::value)
+      return Error("type mismatch: expecting an integer");
+    return ConvertNumber(s, len, true, val);
+  }
+
+  // Reads a bool into the byte that stores it.
+  template<typename T> bool ParseBool(T *val) {
+    bool b;
+    if (!ParseScalar(&b)) return false;
+    *val = static_cast<T>(b);
+    return true;
+  }
+
+  // Reads an integer, or the `hash` of a string.
+  template<typename T, typename H>
+  bool ParseHash(T *val, H (*hash)(const char *)) {
+    auto c = Peek();
+    if (c != '\"' && c != '\'' && !IsIdentifierStart(c))
+      return ParseScalar(val);
+    const char *s;
+    size_t len;
+    if (IsIdentifierStart(c)) {
+      s = cursor_;
+      while (IsIdentifierChar(*cursor_)) cursor_++;
+      len = static_cast<size_t>(cursor_ - s);
+    } else if (!ReadString(&s, &len)) {
+      return false;
+    }
+    *val = static_cast<T>(hash(std::string(s, len).c_str()));
+    return true;
+  }
+
+  bool ParseString(FlatBufferBuilder &fbb, Offset<String> *str) {
+    auto c = Peek();
+    if (c != '\"' && c != '\'') return Error("expecting a string");
+    const char *s;
+    size_t len;
+    if (!ReadString(&s, &len)) return false;
+    *str = fbb.CreateString(s, len);
+    return true;
+  }
+
+  // Reads an array into a vector, each element with
+  // `bool parse_element(T *elem)`.
+  template<typename T, typename F>
+  bool ParseVector(FlatBufferBuilder &fbb, Offset<Vector<T>> *vec,
+                   F parse_element) {
+    size_t start, count;
+    if (!ParseElements<T>(parse_element, &start, &count)) return false;
+    *vec = fbb.CreateVector(ElementsAt<T>(start), count);
+    elements_.resize(start);
+    return true;
+  }
+
+  template<typename T, typename F>
+  bool ParseStructVector(FlatBufferBuilder &fbb, Offset<Vector<const T *>> *vec,
+                         F parse_element) {
+    size_t start, count;
+    if (!ParseElements<T>(parse_element, &start, &count)) return false;
+    *vec = fbb.CreateVectorOfStructs(ElementsAt<T>(start), count);
+    elements_.resize(start);
+    return true;
+  }
+
+  // Reads a (nested_flatbuffer) vector of bytes holding a FlatBuffer of
+  // type T, given as an object read with `parse_root`, or as bytes.
+  template<typename T>
+  bool ParseNestedFlatBuffer(FlatBufferBuilder &fbb,
+                             Offset<Vector<uint8_t>> *vec,
+                             bool (*parse_root)(JsonReader &,
+                                                FlatBufferBuilder &,
+                                                Offset<T> *)) {
+    if (Peek() == '[') {
+      return ParseVector(fbb, vec,
+                         [this](uint8_t *e) { return ParseScalar(e); });
+    }
+    FlatBufferBuilder nested;
+    Offset<T> root;
+    if (!parse_root(*this, nested, &root)) return false;
+    nested.Finish(root);
+    *vec = fbb.CreateVector(nested.GetBufferPointer(), nested.GetSize());
+    return true;
+  }
+
+  // Reads any value into a (flexbuffer) vector of bytes holding a
+  // FlexBuffer.
+  bool ParseFlexBuffer(FlatBufferBuilder &fbb, Offset<Vector<uint8_t>> *vec) {
+    flexbuffers::Builder builder(1024, flexbuffers::BUILDER_FLAG_SHARE_ALL);
+    if (!ParseFlexValue(&builder)) return false;
+    builder.Finish();
+    *vec = fbb.CreateVector(builder.GetBuffer());
+    return true;
+  }
+
+  // Reads a value of any type onto the stack of `builder`, as a map for an
+  // object and an untyped vector for an array.
+  bool ParseFlexValue(flexbuffers::Builder *builder) {
+    auto c = Peek();
+    if (c == '{') {
+      auto start = builder->StartMap();
+      StartObject();
+      while (NextKey()) {
+        builder->Key(key_, key_size_);
+        if (!ParseFlexValue(builder)) return false;
+      }
+      if (!ok()) return false;
+      builder->EndMap(start);
+      return true;
+    }
+    if (c == '[') {
+      auto start = builder->StartVector();
+      StartArray();
+      while (NextElement()) {
+        if (!ParseFlexValue(builder)) return false;
+      }
+      if (!ok()) return false;
+      builder->EndVector(start, false, false);
+      return true;
+    }
+    const char *s;
+    size_t len;
+    if (c == '\"' || c == '\'') {
+      if (!ReadString(&s, &len)) return false;
+      builder->String(s, len);
+      return true;
+    }
+    if (IsIdentifierStart(c)) {
+      s = cursor_;
+      while (IsIdentifierChar(*cursor_)) cursor_++;
+      len = static_cast<size_t>(cursor_ - s);
+      if (len == 4 && !memcmp(s, "true", 4)) {
+        builder->Bool(true);
+      } else if (len == 5 && !memcmp(s, "false", 5)) {
+        builder->Bool(false);
+      } else if (len == 4 && !memcmp(s, "null", 4)) {
+        builder->Null();
+      } else {
+        cursor_ = s;
+        return Error("cannot parse value starting with: " +
+                     std::string(s, len));
+      }
+      return true;
+    }
+    bool is_float;
+    if (!ReadNumber(&s, &len, &is_float)) return false;
+    if (is_float) {
+      double d;
+      if (!ConvertNumber(s, len, true, &d)) return false;
+      builder->Double(d);
+    } else {
+      int64_t i;
+      if (!ConvertNumber(s, len, true, &i)) return false;
+      builder->Int(i);
+    }
+    return true;
+  }
+
+  bool SkipValue() {
+    auto c = Peek();
+    if (c == '{') {
+      StartObject();
+      while (NextKey()) {
+        if (!SkipValue()) return false;
+      }
+      return ok();
+    }
+    if (c == '[') {
+      StartArray();
+      while (NextElement()) {
+        if (!SkipValue()) return false;
+      }
+      return ok();
+    }
+    const char *s;
+    size_t len;
+    if (c == '\"' || c == '\'') return ReadString(&s, &len);
+    if (IsIdentifierStart(c)) {
+      while (IsIdentifierChar(*cursor_)) cursor_++;
+      return true;
+    }
+    bool is_float;
+    return ReadNumber(&s, &len, &is_float);
+  }
+
+ private:
+  static bool IsIdentifierStart(char c) {
+    return isalpha(static_cast<unsigned char>(c)) || c == '_';
+  }
+  static bool IsIdentifierChar(char c) {
+    return isalnum(static_cast<unsigned char>(c)) || c == '_';
+  }
+
+  bool Expect(char c) {
+    if (Peek() != c) return Error(std::string("expecting: ") + c);
+    cursor_++;
+    return true;
+  }
+
+  bool Open(char c) {
+    if (!Expect(c)) return false;
+    first_ = true;
+    return true;
+  }
+
+  // Skips a UTF-8 byte order mark, like Parser. Compares one char at a time
+  // so as not to read past the end of shorter text.
+  void SkipByteOrderMark() {
+    if (cursor_[0] == '\xEF' && cursor_[1] == '\xBB' && cursor_[2] == '\xBF')
+      cursor_ += 3;
+  }
+
+  // Reads the comma before the next member of an object or array, if any.
+  // `first_` is set between an opening bracket and its first member only,
+  // a closing bracket is always followed by more members of the parent.
+  bool NextMember(char close) {
+    auto c = Peek();
+    auto first = first_;
+    first_ = false;
+    if (c == close) {
+      cursor_++;
+      return false;
+    }
+    if (first) return true;
+    if (c != ',') return Error(std::string("expecting: , or ") + close);
+    cursor_++;
+    if (!opts_.strict_json && Peek() == close) {
+      cursor_++;
+      return false;
+    }
+    return true;
+  }
+
+  // Reads a string, pointing `*s` into the text if it has no escapes.
+  bool ReadString(const char **s, size_t *len) {
+    auto quote = *cursor_++;
+    auto start = cursor_;
+    auto ascii = true;
+    for (;; cursor_++) {
+      auto c = static_cast<unsigned char>(*cursor_);
+      if (c == static_cast<unsigned char>(quote) || c == '\\') break;
+      if (c < ' ') {
+        if (!c) return Error("end of file in string constant");
+        return Error("illegal character in string constant");
+      }
+      ascii = ascii && c < 0x80;
+    }
+    if (*cursor_ == quote) {
+      *s = start;
+      *len = static_cast<size_t>(cursor_++ - start);
+      return ascii || ValidUTF8(*s, *len);
+    }
+    str_.assign(start, cursor_);
+    int high_surrogate = -1;
+    while (*cursor_ != quote) {
+      auto c = *cursor_++;
+      if (static_cast<unsigned char>(c) < ' ') {
+        cursor_--;
+        if (!c) return Error("end of file in string constant");
+        return Error("illegal character in string constant");
+      }
+      if (c != '\\') {
+        if (high_surrogate != -1) return UnpairedHighSurrogate();
+        str_ += c;
+        continue;
+      }
+      c = *cursor_++;
+      if (high_surrogate != -1 && c != 'u') return UnpairedHighSurrogate();
+      switch (c) {
+        case 'n': str_ += '\n'; break;
+        case 't': str_ += '\t'; break;
+        case 'r': str_ += '\r'; break;
+        case 'b': str_ += '\b'; break;
+        case 'f': str_ += '\f'; break;
+        case '\"':
+        case '\'':
+        case '\\':
+        case '/': str_ += c; break;
+        case 'x': {  // Not in the JSON standard.
+          uint32_t val;
+          if (!ReadHex(2, &val)) return false;
+          str_ += static_cast<char>(val);
+          break;
+        }
+        case 'u': {
+          uint32_t val;
+          if (!ReadHex(4, &val)) return false;
+          if (val >= 0xD800 && val <= 0xDBFF) {
+            if (high_surrogate != -1)
+              return Error(
+                  "illegal Unicode sequence (multiple high surrogates)");
+            high_surrogate = static_cast<int>(val);
+          } else if (val >= 0xDC00 && val <= 0xDFFF) {
+            if (high_surrogate == -1)
+              return Error("illegal Unicode sequence (unpaired low surrogate)");
+            ToUTF8(0x10000 + ((high_surrogate & 0x03FF) << 10) + (val & 0x03FF),
+                   &str_);
+            high_surrogate = -1;
+          } else {
+            if (high_surrogate != -1) return UnpairedHighSurrogate();
+            ToUTF8(val, &str_);
+          }
+          break;
+        }
+        default:
+          cursor_--;
+          return Error("unknown escape code in string constant");
+      }
+    }
+    if (high_surrogate != -1) return UnpairedHighSurrogate();
+    cursor_++;
+    *s = str_.c_str();
+    *len = str_.size();
+    return ValidUTF8(*s, *len);
+  }
+
+  bool UnpairedHighSurrogate() {
+    return Error("illegal Unicode sequence (unpaired high surrogate)");
+  }
+
+  bool ValidUTF8(const char *s, size_t len) {
+    if (opts_.allow_non_utf8) return true;
+    for (auto end = s + len; s < end;) {
+      if (FromUTF8(&s) < 0) return Error("illegal UTF-8 sequence");
+    }
+    return true;
+  }
+
+  bool ReadHex(int digits, uint32_t *val) {
+    *val = 0;
+    for (int i = 0; i < digits; i++, cursor_++) {
+      auto c = *cursor_;
+      if (!isxdigit(static_cast<unsigned char>(c)))
+        return Error("escape code must be followed by " +
+                     NumToString(digits) + " hex digits");
+      *val = *val * 16 + static_cast<uint32_t>(
+                             isdigit(static_cast<unsigned char>(c))
+                                 ? c - '0'
+                                 : tolower(static_cast<unsigned char>(c)) -
+                                       'a' + 10);
+    }
+    return true;
+  }
+
+  // Scans a number the way Parser does: decimal or hexadecimal integers, and
+  // floats with a fraction and/or an exponent.
+  bool ReadNumber(const char **s, size_t *len, bool *is_float) {
+    auto start = cursor_;
+    auto p = cursor_;
+    if (*p == '-') p++;
+    *is_float = false;
+    if (*p == '0' && (p[1] == 'x' || p[1] == 'X')) {
+      p += 2;
+      while (isxdigit(static_cast<unsigned char>(*p))) p++;
+    } else {
+      if (!isdigit(static_cast<unsigned char>(*p))) {
+        auto c = *cursor_;
+        return Error(std::string("cannot parse value starting with: ") +
+                     (c ? std::string(1, c) : "end of file"));
+      }
+      while (isdigit(static_cast<unsigned char>(*p))) p++;
+      if (*p == '.') {
+        *is_float = true;
+        p++;
+        while (isdigit(static_cast<unsigned char>(*p))) p++;
+      }
+      if (*p == 'e' || *p == 'E') {
+        *is_float = true;
+        p++;
+        if (*p == '+' || *p == '-') p++;
+        while (isdigit(static_cast<unsigned char>(*p))) p++;
+      }
+    }
+    cursor_ = p;
+    *s = start;
+    *len = static_cast<size_t>(p - start);
+    return true;
+  }
+
+  // Converts a number scanned by ReadNumber(), or the contents of a string.
+  template<typename T>
+  bool ConvertNumber(const char *s, size_t len, bool token, T *val) {
+    char *end;
+    if (std::is_floating_point<T>::value) {
+      auto d = strtod(s, &end);
+      if (end != s + len) return Error("invalid float: " + std::string(s, len));
+      *val = static_cast<T>(d);
+      return true;
+    }
+    auto negative = len && *s == '-';
+    auto digits = s + negative;
+    int64_t i;
+    if (token && len > 2u + negative && digits[0] == '0' &&
+        (digits[1] == 'x' || digits[1] == 'X')) {
+      auto u = StringToUInt(digits + 2, &end, 16);
+      i = static_cast<int64_t>(negative ? 0 - u : u);
+    } else if (std::is_same<T, uint64_t>::value) {
+      i = static_cast<int64_t>(StringToUInt(s, &end));
+    } else {
+      i = StringToInt(s, &end);
+    }
+    if (!len || end != s + len)
+      return Error("invalid integer: " + std::string(s, len));
+    return Assign(i, val);
+  }
+
+  template<typename T> bool Assign(int64_t i, T *val) {
+    if (std::is_same<T, bool>::value) {
+      *val = static_cast<T>(i != 0);
+    } else if (!std::is_same<T, uint64_t>::value &&
+               (i < static_cast<int64_t>(numeric_limits<T>::min()) ||
+                i > static_cast<int64_t>(numeric_limits<T>::max()))) {
+      return Error("constant does not fit in a " +
+                   NumToString(sizeof(T) * 8) + "-bit field: " +
+                   NumToString(i));
+    } else {
+      *val = static_cast<T>(i);
+    }
+    return true;
+  }
+
+  // Reads enum values separated by spaces, or'ing them together.
+  template<typename T>
+  bool ParseEnum(const char *s, size_t len, EnumLookup lookup, T *val) {
+    if (!lookup || std::is_floating_point<T>::value)
+      return Error("not a valid value for this field: " +
+                   std::string(s, len));
+    int64_t result = 0;
+    for (auto end = s + len; s != end;) {
+      auto word_end = std::find(s, end, ' ');
+      int64_t v;
+      if (!lookup(s, static_cast<size_t>(word_end - s), &v))
+        return Error("unknown enum value: " + std::string(s, word_end));
+      result |= v;
+      s = word_end;
+      while (s != end && *s == ' ') s++;
+    }
+    return Assign(result, val);
+  }
+
+  // Reads an array onto elements_, where arrays being read around it have
+  // their elements below `*start`.
+  template<typename T, typename F>
+  bool ParseElements(F parse_element, size_t *start, size_t *count) {
+    if (!StartArray()) return false;
+    *start = elements_.size() + PaddingBytes(elements_.size(), AlignOf<T>());
+    *count = 0;
+    while (NextElement()) {
+      T elem;
+      if (!parse_element(&elem)) return false;
+      auto at = *start + *count * sizeof(T);
+      elements_.resize(at + sizeof(T));
+      memcpy(&elements_[at], &elem, sizeof(T));
+      ++*count;
+    }
+    elements_.resize(*start + *count * sizeof(T));
+    return ok();
+  }
+
+  template<typename T> const T *ElementsAt(size_t start) {
+    return reinterpret_cast<const T *>(vector_data(elements_) + start);
+  }
+
+  JsonOptions opts_;
+  const char *text_;
+  const char *cursor_;
+  // The current field name, in the text or in str_.
+  const char *key_;
+  size_t key_size_;
+  uint64_t key_hash_;
+  bool first_;
+  std::string str_;  // Strings with escapes.
+  // The elements of the vectors being read, innermost last.
+  std::vector<uint8_t> elements_;
+  std::string error_;
+};
+
+// Converts JSON without a schema to FlexBuffers, like
+// Parser::ParseFlexBuffer(), but with a JsonReader rather than Parser's
+// tokenizer: strings without escapes and keys go straight from the text into
+// the buffer. Before each document, a quick scan of its brackets and
+// separators finds how many values will be under construction at once, so
+// the builder's stack is sized once up front.
+//
+// Meant to be kept around and reused: the reader's scratch buffers and the
+// builder, with its stack and sharing pools, keep their memory between
+// documents, so converting similar documents stops allocating once warmed
+// up.
+class JsonFlexParser {
+ public:
+  explicit JsonFlexParser(
+      const JsonOptions &opts = JsonOptions(),
+      flexbuffers::BuilderFlag flags = flexbuffers::BUILDER_FLAG_SHARE_KEYS)
+      : reader_("", opts), builder_(256, flags) {}
+
+  // Converts `text` to a finished buffer, see GetBuffer(). Returns false on
+  // an error, see error().
+  bool Parse(const char *text) {
+    reader_.Reset(text);
+    builder_.Clear();
+    builder_.Reserve(CountValues(text), strlen(text));
+    if (!reader_.ParseFlexValue(&builder_) || !reader_.Finish()) return false;
+    builder_.Finish();
+    return true;
+  }
+
+  // The result of the last successful Parse(), valid until the next one.
+  const std::vector<uint8_t> &GetBuffer() const {
+    return builder_.GetBuffer();
+  }
+
+  // E.g. to Release() the buffer rather than copy it.
+  flexbuffers::Builder &builder() { return builder_; }
+
+  const std::string &error() const { return reader_.error(); }
+
+ private:
+  // The most values that will be on the builder's stack at once for `text`:
+  // the elements (and keys) of all the objects and arrays that are open.
+  // Only brackets, separators, strings and comments are looked at; for text
+  // that isn't valid JSON the count is just a (harmless) wrong guess.
+  size_t CountValues(const char *text) {
+    // The values pushed in each object or array that is open, innermost last.
+    open_.assign(1, 0);
+    size_t pending = 0;
+    size_t most = 0;
+    auto in_value = false;  // In a value that hasn't been counted yet.
+    for (auto p = text;; p++) {
+      switch (*p) {
+        case '\0':
+          if (in_value) Count(&pending, &most);
+          return most;
+        case '{':
+        case '[':
+          open_.push_back(0);
+          in_value = false;
+          break;
+        case '}':
+        case ']':
+          if (in_value) Count(&pending, &most);
+          // Its elements are replaced by the object or array itself, which
+          // is counted as a value of its parent.
+          if (open_.size() > 1) {
+            pending -= open_.back();
+            open_.pop_back();
+          }
+          in_value = true;
+          break;
+        case ',':
+          if (in_value) Count(&pending, &most);
+          in_value = false;
+          break;
+        case ':':  // After a key.
+          Count(&pending, &most);
+          in_value = false;
+          break;
+        case '\"':
+        case '\'': {
+          auto quote = *p;
+          for (p++; *p != quote; p++) {
+            if (!*p) return most;
+            if (*p == '\\' && !*++p) return most;
+          }
+          in_value = true;
+          break;
+        }
+        case '/':
+          if (p[1] == '/') {
+            while (p[1] && p[1] != '\n') p++;
+          } else if (p[1] == '*') {
+            for (p += 2; *p && !(*p == '*' && p[1] == '/'); p++) {}
+            if (!*p) return most;
+            p++;
+          } else {
+            in_value = true;
+          }
+          break;
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\r': break;
+        default: in_value = true; break;
+      }
+    }
+  }
+
+  void Count(size_t *pending, size_t *most) {
+    open_.back()++;
+    *most = (std::max)(*most, ++*pending);
+  }
+
+  JsonReader reader_;
+  flexbuffers::Builder builder_;
+  std::vector<size_t> open_;
+};
+
+// Writes JSON text the way GenerateText() does.
+class JsonWriter {
+ public:
+  explicit JsonWriter(std::string *text,
+                      const JsonOptions &opts = JsonOptions())
+      : opts_(opts),
+        text_(*text),
+        step_((std::max)(opts.indent_step, 0)),
+        level_(0),
+        first_(false),
+        ok_(true) {}
+
+  // False if a string wasn't valid UTF-8 (and allow_non_utf8 isn't set).
+  bool ok() const { return ok_; }
+
+  void StartObject() {
+    text_ += '{';
+    level_ += step_;
+    first_ = true;
+  }
+
+  void Key(const char *name) {
+    if (!first_) text_ += ',';
+    first_ = false;
+    NewLine();
+    text_.append(level_, ' ');
+    if (opts_.strict_json) text_ += '\"';
+    text_ += name;
+    if (opts_.strict_json) text_ += '\"';
+    text_ += ": ";
+  }
+
+  void EndObject() { Close('}'); }
+
+  void StartArray() {
+    text_ += '[';
+    level_ += step_;
+    NewLine();
+    first_ = true;
+  }
+
+  // Call before each element of an array.
+  void Element() {
+    if (!first_) {
+      text_ += ',';
+      NewLine();
+    }
+    first_ = false;
+    text_.append(level_, ' ');
+  }
+
+  void EndArray() { Close(']'); }
+
+  template<typename T> void Scalar(T val) { AppendNumber(val, &text_); }
+  void Scalar(bool b) { text_ += b ? "true" : "false"; }
+
+  // Writes the name of an enum value, or the number if it has none.
+  template<typename T> void Enum(T val, const char *(*name)(int64_t)) {
+    auto s = name(static_cast<int64_t>(val));
+    if (!s) return Scalar(val);
+    text_ += '\"';
+    text_ += s;
+    text_ += '\"';
+  }
+
+  void String(const flatbuffers::String &str) {
+    ok_ = EscapeString(str.c_str(), str.size(), &text_,
+                       opts_.allow_non_utf8) &&
+          ok_;
+  }
+
+  template<typename T> void ScalarVector(const Vector<T> &vec) {
+    StartArray();
+    for (uoffset_t i = 0; i < vec.size(); i++) {
+      Element();
+      Scalar(vec.Get(i));
+    }
+    EndArray();
+  }
+
+  void StringVector(const Vector<Offset<flatbuffers::String>> &vec) {
+    StartArray();
+    for (uoffset_t i = 0; i < vec.size(); i++) {
+      Element();
+      String(*vec.Get(i));
+    }
+    EndArray();
+  }
+
+  void FlexBuffer(const Vector<uint8_t> &vec) {
+    flexbuffers::GetRoot(vec.data(), vec.size())
+        .ToString(true, opts_.strict_json, text_);
+  }
+
+  void Null() { text_ += "null"; }
+
+  // Ends the text after the root value.
+  void Finish() { NewLine(); }
+
+ private:
+  JsonWriter &operator=(const JsonWriter &);
+
+  void NewLine() {
+    if (opts_.indent_step >= 0) text_ += '\n';
+  }
+
+  void Close(char c) {
+    level_ -= step_;
+    NewLine();
+    text_.append(level_, ' ');
+    text_ += c;
+    first_ = false;
+  }
+
+  JsonOptions opts_;
+  std::string &text_;
+  int step_;
+  int level_;
+  bool first_;
+  bool ok_;
+};
+
+}  // namespace flatbuffers
+
+#endif  // FLATBUFFERS_JSON_H_
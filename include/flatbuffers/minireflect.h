@@ -33,6 +33,12 @@ namespace flatbuffers {
 // `FooTypeTable()` if the type of the root is `Foo`.
 
 // First, a generic iterator that can be used by multiple algorithms.
+// IterateObject() etc. are templates of the type of visitor, so they can
+// call a visitor directly rather than through virtual functions, if it is
+// passed as its own type. Visitors that only use a few of the callbacks, or
+// are called for a lot of values (e.g. hashers or counters), are best
+// derived from StaticIterationVisitor rather than IterationVisitor, so the
+// calls to them can be inlined.
 
 struct IterationVisitor {
   // These mark the scope of a table or struct.
@@ -69,6 +75,34 @@ struct IterationVisitor {
   virtual ~IterationVisitor() {}
 };
 
+// The same callbacks as IterationVisitor, as non-virtual functions that do
+// nothing. Visitors derived from this define the ones they need.
+struct StaticIterationVisitor {
+  void StartSequence() {}
+  void EndSequence() {}
+  void Field(size_t /*field_idx*/, size_t /*set_idx*/, ElementaryType /*type*/,
+             bool /*is_vector*/, const TypeTable * /*type_table*/,
+             const char * /*name*/, const uint8_t * /*val*/) {}
+  void UType(uint8_t, const char *) {}
+  void Bool(bool) {}
+  void Char(int8_t, const char *) {}
+  void UChar(uint8_t, const char *) {}
+  void Short(int16_t, const char *) {}
+  void UShort(uint16_t, const char *) {}
+  void Int(int32_t, const char *) {}
+  void UInt(uint32_t, const char *) {}
+  void Long(int64_t) {}
+  void ULong(uint64_t) {}
+  void Float(float) {}
+  void Double(double) {}
+  void String(const String *) {}
+  void Unknown(const uint8_t *) {}
+  void StartVector() {}
+  void EndVector() {}
+  void Element(size_t /*i*/, ElementaryType /*type*/,
+               const TypeTable * /*type_table*/, const uint8_t * /*val*/) {}
+};
+
 inline size_t InlineSize(ElementaryType type, const TypeTable *type_table) {
   switch (type) {
     case ET_UTYPE:
@@ -114,12 +148,14 @@ template<typename T> const char *EnumName(T tval, const TypeTable *type_table) {
   return nullptr;
 }
 
+template<typename Visitor>
 void IterateObject(const uint8_t *obj, const TypeTable *type_table,
-                   IterationVisitor *visitor);
+                   Visitor *visitor);
 
+template<typename Visitor>
 inline void IterateValue(ElementaryType type, const uint8_t *val,
                          const TypeTable *type_table, const uint8_t *prev_val,
-                         soffset_t vector_index, IterationVisitor *visitor) {
+                         soffset_t vector_index, Visitor *visitor) {
   switch (type) {
     case ET_UTYPE: {
       auto tval = *reinterpret_cast<const uint8_t *>(val);
@@ -228,8 +264,9 @@ inline void IterateValue(ElementaryType type, const uint8_t *val,
   }
 }
 
+template<typename Visitor>
 inline void IterateObject(const uint8_t *obj, const TypeTable *type_table,
-                          IterationVisitor *visitor) {
+                          Visitor *visitor) {
   visitor->StartSequence();
   const uint8_t *prev_val = nullptr;
   size_t set_idx = 0;
@@ -272,64 +309,86 @@ inline void IterateObject(const uint8_t *obj, const TypeTable *type_table,
   visitor->EndSequence();
 }
 
+template<typename Visitor>
 inline void IterateFlatBuffer(const uint8_t *buffer,
                               const TypeTable *type_table,
-                              IterationVisitor *callback) {
+                              Visitor *callback) {
   IterateObject(GetRoot<uint8_t>(buffer), type_table, callback);
 }
 
 // Outputting a Flatbuffer to a string. Tries to conform as close to JSON /
 // the output generated by idl_gen_text.cpp.
 
-struct ToStringVisitor : public IterationVisitor {
-  std::string s;
-  void StartSequence() { s += "{ "; }
-  void EndSequence() { s += " }"; }
+// Appends to "text", and can be used as either kind of visitor depending on
+// "Base". Numbers are appended in place, see AppendNumber().
+template<typename Base> struct BasicToStringVisitor : public Base {
+  explicit BasicToStringVisitor(std::string *text) : text_(text) {}
+  void StartSequence() { *text_ += "{ "; }
+  void EndSequence() { *text_ += " }"; }
   void Field(size_t /*field_idx*/, size_t set_idx, ElementaryType /*type*/,
              bool /*is_vector*/, const TypeTable * /*type_table*/,
              const char *name, const uint8_t *val) {
     if (!val) return;
-    if (set_idx) s += ", ";
+    if (set_idx) *text_ += ", ";
     if (name) {
-      s += name;
-      s += ": ";
+      *text_ += name;
+      *text_ += ": ";
     }
   }
   template<typename T> void Named(T x, const char *name) {
     if (name)
-      s += name;
+      *text_ += name;
     else
-      s += NumToString(x);
+      AppendNumber(x, text_);
   }
   void UType(uint8_t x, const char *name) { Named(x, name); }
-  void Bool(bool x) { s += x ? "true" : "false"; }
+  void Bool(bool x) { *text_ += x ? "true" : "false"; }
   void Char(int8_t x, const char *name) { Named(x, name); }
   void UChar(uint8_t x, const char *name) { Named(x, name); }
   void Short(int16_t x, const char *name) { Named(x, name); }
   void UShort(uint16_t x, const char *name) { Named(x, name); }
   void Int(int32_t x, const char *name) { Named(x, name); }
   void UInt(uint32_t x, const char *name) { Named(x, name); }
-  void Long(int64_t x) { s += NumToString(x); }
-  void ULong(uint64_t x) { s += NumToString(x); }
-  void Float(float x) { s += NumToString(x); }
-  void Double(double x) { s += NumToString(x); }
+  void Long(int64_t x) { AppendNumber(x, text_); }
+  void ULong(uint64_t x) { AppendNumber(x, text_); }
+  void Float(float x) { AppendNumber(x, text_); }
+  void Double(double x) { AppendNumber(x, text_); }
   void String(const struct String *str) {
-    EscapeString(str->c_str(), str->size(), &s, true);
+    EscapeString(str->c_str(), str->size(), text_, true);
   }
-  void Unknown(const uint8_t *) { s += "(?)"; }
-  void StartVector() { s += "[ "; }
-  void EndVector() { s += " ]"; }
+  void Unknown(const uint8_t *) { *text_ += "(?)"; }
+  void StartVector() { *text_ += "[ "; }
+  void EndVector() { *text_ += " ]"; }
   void Element(size_t i, ElementaryType /*type*/,
                const TypeTable * /*type_table*/, const uint8_t * /*val*/) {
-    if (i) s += ", ";
+    if (i) *text_ += ", ";
   }
+
+ private:
+  std::string *text_;
 };
 
+struct ToStringVisitor : public BasicToStringVisitor<IterationVisitor> {
+  ToStringVisitor() : BasicToStringVisitor<IterationVisitor>(&s) {}
+  std::string s;
+};
+
+// Appends to a string owned by the caller, which can be reused for many
+// buffers without allocating once it has grown large enough.
+typedef BasicToStringVisitor<StaticIterationVisitor> AppendToStringVisitor;
+
+inline void FlatBufferToString(const uint8_t *buffer,
+                               const TypeTable *type_table,
+                               std::string *text) {
+  AppendToStringVisitor tostring_visitor(text);
+  IterateFlatBuffer(buffer, type_table, &tostring_visitor);
+}
+
 inline std::string FlatBufferToString(const uint8_t *buffer,
                                       const TypeTable *type_table) {
-  ToStringVisitor tostring_visitor;
-  IterateFlatBuffer(buffer, type_table, &tostring_visitor);
-  return tostring_visitor.s;
+  std::string text;
+  FlatBufferToString(buffer, type_table, &text);
+  return text;
 }
 
 }  // namespace flatbuffers
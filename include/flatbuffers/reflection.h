@@ -255,6 +255,124 @@ T *GetAnyFieldAddressOf(const Struct &st, const reflection::Field &field) {
   return (T *)st.GetAddressOf(field.offset());
 }
 
+// ------------------------- COMPILED ACCESSORS -------------------------
+
+// A field of a table, or a path to one through tables and structs (e.g.
+// "pos.test3.a" or "enemy.name"), resolved against a schema once. Reading it
+// then needs no name lookups, since each step is just an offset, and scalars
+// are read by a function picked for their type up front. Meant to be set up
+// once and used for many buffers, e.g. for every record in a generic
+// pipeline.
+//
+// If the field, or a table on the way to it, isn't set, the field's default
+// is returned. Unlike GetAnyFieldI() and GetAnyFieldF(), that is the default
+// converted to the type asked for, e.g. GetF() of an int field with default
+// 100 is 100.0.
+class FieldAccessor {
+ public:
+  FieldAccessor()
+      : schema_(nullptr),
+        field_(nullptr),
+        get_i_(nullptr),
+        get_f_(nullptr),
+        default_i_(0),
+        default_f_(0) {}
+
+  // Resolves `path`, a field name or several separated by '.', for tables of
+  // type `object`. Returns false if a name isn't a field of the type before
+  // it, or if a field other than the last isn't a table or struct (vectors
+  // and unions can't be part of a path). `schema` must outlive the accessor.
+  bool Resolve(const reflection::Schema &schema,
+               const reflection::Object &object, const char *path);
+
+  bool valid() const { return field_ != nullptr; }
+
+  // The last field of the path.
+  const reflection::Field &field() const {
+    assert(field_);
+    return *field_;
+  }
+
+  // Whether the field and all tables on the way to it are set in `table`.
+  bool IsPresent(const Table &table) const { return Locate(table) != nullptr; }
+
+  // Like GetAnyFieldI().
+  int64_t GetI(const Table &table) const {
+    auto p = Locate(table);
+    if (!p) return default_i_;
+    return get_i_ ? get_i_(p) : GetAnyValueI(field_->type()->base_type(), p);
+  }
+
+  // Like GetAnyFieldF().
+  double GetF(const Table &table) const {
+    auto p = Locate(table);
+    if (!p) return default_f_;
+    return get_f_ ? get_f_(p) : GetAnyValueF(field_->type()->base_type(), p);
+  }
+
+  // Like GetAnyFieldS(), with tables pretty-printed using the schema.
+  std::string GetS(const Table &table) const;
+
+  // A string field, or null if it isn't set.
+  const String *GetString(const Table &table) const {
+    assert(field_->type()->base_type() == reflection::String);
+    auto p = Locate(table);
+    return p ? reinterpret_cast<const String *>(p + ReadScalar<uoffset_t>(p))
+             : nullptr;
+  }
+
+  // A table field, or null if it isn't set.
+  const Table *GetTable(const Table &table) const {
+    assert(field_->type()->base_type() == reflection::Obj);
+    auto p = Locate(table);
+    return p ? reinterpret_cast<const Table *>(p + ReadScalar<uoffset_t>(p))
+             : nullptr;
+  }
+
+ private:
+  struct Step {
+    uoffset_t offset;  // In the vtable, or in the struct if in_struct.
+    bool in_struct;    // Otherwise in the table the previous step refers to.
+  };
+
+  friend class ColumnExtractor;
+
+  // The address of the value of the last field, or null if it isn't set.
+  const uint8_t *Locate(const Table &table) const {
+    assert(field_);
+    return Follow(table.GetAddressOf(static_cast<voffset_t>(steps_[0].offset)));
+  }
+
+  // Carries on from `p`, the value of the first field (or null).
+  const uint8_t *Follow(const uint8_t *p) const {
+    for (auto it = steps_.begin() + 1; p && it != steps_.end(); ++it) {
+      if (it->in_struct) {
+        p += it->offset;
+      } else {
+        auto t = reinterpret_cast<const Table *>(p + ReadScalar<uoffset_t>(p));
+        p = t->GetAddressOf(static_cast<voffset_t>(it->offset));
+      }
+    }
+    return p;
+  }
+
+  template<typename T> static int64_t ReadI(const uint8_t *p) {
+    return static_cast<int64_t>(ReadScalar<T>(p));
+  }
+  template<typename T> static double ReadF(const uint8_t *p) {
+    return static_cast<double>(ReadScalar<T>(p));
+  }
+
+  const reflection::Schema *schema_;
+  const reflection::Field *field_;
+  std::vector<Step> steps_;
+  // For scalars, otherwise GetAnyValueI() / GetAnyValueF() are used.
+  int64_t (*get_i_)(const uint8_t *p);
+  double (*get_f_)(const uint8_t *p);
+  int64_t default_i_;
+  double default_f_;
+};
+
 // ------------------------- SETTERS -------------------------
 
 // Set any scalar field, if you know its exact type.
@@ -378,6 +496,9 @@ pointer_inside_vector<T, U> piv(T *ptr, std::vector<U> &vec) {
 
 inline const char *UnionTypeFieldSuffix() { return "_type"; }
 
+// The suffix of the field holding the index of a `hashed` vector field.
+inline const char *HashIndexFieldSuffix() { return "_hash_index"; }
+
 // Helper to figure out the actual table type a union refers to.
 inline const reflection::Object &GetUnionType(
     const reflection::Schema &schema, const reflection::Object &parent,
@@ -431,6 +552,95 @@ void ResizeVector(const reflection::Schema &schema, uoffset_t newsize, T val,
   }
 }
 
+// Changes the sizes of several strings and vectors inside a FlatBuffer at
+// once. Each of SetString() and ResizeAnyVector() walks the whole buffer to
+// fix up its offsets and shifts everything after the change, so many edits
+// mean many passes. A ResizeBatch queues the edits, and Apply() moves the
+// data and fixes up the offsets for all of them in one pass each.
+// The strings and vectors must all be different, and live inside "flatbuf"
+// as it is when Apply() is called. They may be invalidated by Apply(), after
+// which the batch is empty and can be reused.
+// If your FlatBuffer's root table is not the schema's root table, you should
+// pass in your root_table type as well.
+class ResizeBatch {
+ public:
+  ResizeBatch(const reflection::Schema &schema, std::vector<uint8_t> *flatbuf,
+              const reflection::Object *root_table = nullptr)
+      : schema_(schema),
+        root_table_(root_table ? *root_table : *schema.root_table()),
+        flatbuf_(*flatbuf) {}
+
+  // Queues changing the contents of "str" to "val", like SetString().
+  void SetString(const String *str, const std::string &val);
+
+  // Queues resizing "vec" to "newsize" elements, like ResizeAnyVector().
+  // New elements are set to 0.
+  void ResizeAnyVector(const VectorOfAny *vec, uoffset_t num_elems,
+                       uoffset_t elem_size, uoffset_t newsize) {
+    AddVector(vec, num_elems, elem_size, newsize, nullptr);
+  }
+
+  // Queues resizing "vec" to "newsize" elements, like ResizeVector(). New
+  // elements are set to "val".
+  template<typename T>
+  void ResizeVector(const Vector<T> *vec, uoffset_t newsize, T val) {
+    uint8_t elem[sizeof(T)];
+    auto is_scalar = flatbuffers::is_scalar<T>::value;
+    if (is_scalar) {
+      WriteScalar(elem, val);
+    } else {  // struct
+      memcpy(elem, &val, sizeof(T));
+    }
+    AddVector(reinterpret_cast<const VectorOfAny *>(vec), vec->size(),
+              static_cast<uoffset_t>(sizeof(T)), newsize, elem);
+  }
+
+  // The number of edits queued.
+  size_t size() const { return edits_.size(); }
+
+  // Does all the queued edits.
+  void Apply();
+
+ private:
+  struct Edit {
+    uoffset_t length_loc;  // Of the string or vector.
+    uoffset_t length;      // The new one.
+    // Where bytes are inserted or removed in the buffer, and how many.
+    uoffset_t start;
+    int delta;
+    uoffset_t clear;  // Bytes at "start" to zero before they move.
+    // Written "count" times at "start" once the bytes have moved, e.g. the
+    // new elements of a vector.
+    size_t payload;  // Index into payloads_.
+    uoffset_t payload_size;
+    uoffset_t count;
+    bool operator<(const Edit &o) const { return start < o.start; }
+  };
+
+  void AddVector(const VectorOfAny *vec, uoffset_t num_elems,
+                 uoffset_t elem_size, uoffset_t newsize, const uint8_t *elem);
+  Edit &Add(const void *length_loc, uoffset_t length, uoffset_t start,
+            int delta);
+  // How far the byte at "pos" (before the edits) moves.
+  int Shift(const uint8_t *pos) const;
+  template<typename T>
+  void FixOffset(uint8_t *offsetloc, const uint8_t *from, const uint8_t *to);
+  uint8_t &Visited(const void *offsetloc);
+  void FixTable(const reflection::Object &objectdef, Table *table);
+  void MoveBytes();
+  void operator=(const ResizeBatch &);
+
+  const reflection::Schema &schema_;
+  const reflection::Object &root_table_;
+  std::vector<uint8_t> &flatbuf_;
+  std::vector<Edit> edits_;
+  std::vector<uint8_t> payloads_;
+  // Scratch state of Apply().
+  std::vector<int> shifts_;  // Sum of the deltas up to each edit.
+  std::vector<uint8_t> visited_;
+  std::vector<uint8_t> moved_;
+};
+
 // Adds any new data (in the form of a new FlatBuffer) to an existing
 // FlatBuffer. This can be used when any of the above methods are not
 // sufficient, in particular for adding new tables and new fields.
@@ -465,6 +675,211 @@ Offset<const Table *> CopyTable(FlatBufferBuilder &fbb,
                                 const Table &table,
                                 bool use_string_pooling = false);
 
+// Copies tables like CopyTable(), but works out how to copy each type of
+// table once up front rather than for every table, so it is a lot faster for
+// copying many or large buffers of a schema. It can also leave out fields,
+// e.g. to project buffers down to the fields some consumer needs.
+// Strings, and vectors of scalars and structs are copied in one piece, as
+// are the scalars and structs stored in tables that are copied whole. Tables
+// with fields left out get theirs stored largest first, so they need no
+// padding between them. Either way the builder shares vtables that are the
+// same.
+class TableCopier {
+ public:
+  TableCopier(const reflection::Schema &schema,
+              const reflection::Object &objectdef,
+              bool use_string_pooling = false);
+
+  // Only copies the field at "path", and others given to this. A path (e.g.
+  // "enemy.name" or "testarrayoftables.hp") goes through tables, vectors of
+  // tables and structs, and keeps the tables on the way to the field with
+  // just the fields asked for. Structs and unions are always kept whole, and
+  // tables always keep their required fields. Returns false if "path"
+  // doesn't name a field.
+  bool Keep(const char *path);
+
+  // Leaves out the field at "path", a path through tables and vectors of
+  // tables as for Keep(). Returns false if "path" doesn't name a field, or
+  // the field is required or inside a struct.
+  bool Drop(const char *path);
+
+  // Copies "table", which must be of the object type given to the
+  // constructor, into "fbb".
+  Offset<const Table *> Copy(FlatBufferBuilder &fbb, const Table &table);
+
+ private:
+  // Copies the tables SchemaMigrator finds unchanged.
+  friend class SchemaMigrator;
+
+  struct FieldPlan {
+    voffset_t offset;
+    reflection::BaseType type;
+    reflection::BaseType element;  // Of vectors.
+    // Of scalars and structs, or the elements of vectors of them.
+    uoffset_t size;
+    uoffset_t align;
+    bool nested_flatbuffer;  // Aligned so the buffer in it can be read.
+    size_t plan;  // Of tables, or vectors of them.
+    // Of unions: the type field, and the plans by type in union_plans_.
+    voffset_t union_type;
+    size_t unions;
+    size_t num_unions;
+  };
+
+  struct Plan {
+    // Scalars and structs, largest alignment first. Those before num_wide
+    // align to at least an offset, so are stored before the offsets.
+    std::vector<FieldPlan> inline_fields;
+    size_t num_wide;
+    std::vector<FieldPlan> offset_fields;  // Strings, tables etc.
+    // Copying all fields, so the whole of a table's inline data can be
+    // copied at once.
+    bool whole;
+  };
+
+  void MakePlans();
+  bool ValidPath(const char *path, bool drop) const;
+  size_t ObjectIndex(const reflection::Object *objectdef) const;
+  size_t AddPlan(size_t object, const std::vector<std::string> &keeps,
+                 const std::vector<std::string> &drops);
+  void FillPlan(size_t object, const std::vector<uint8_t> &copied,
+                const std::vector<size_t> &subplans, Plan *plan);
+  uoffset_t CopyTable(FlatBufferBuilder &fbb, size_t plan, const Table &table);
+  bool CopyInlineData(FlatBufferBuilder &fbb, const Plan &plan,
+                      const Table &table, size_t base);
+  uoffset_t CopyField(FlatBufferBuilder &fbb, const FieldPlan &field,
+                      const Table &table, const uint8_t *ref);
+  uoffset_t CopyString(FlatBufferBuilder &fbb, const uint8_t *ref);
+
+  const reflection::Schema &schema_;
+  size_t object_;
+  bool use_string_pooling_;
+  std::vector<std::string> keeps_;
+  std::vector<std::string> drops_;
+  // One plan per object of the schema, then those with fields left out, of
+  // which the one to copy with is root_plan_. Rebuilt by Copy() after
+  // Keep() or Drop().
+  std::vector<Plan> plans_;
+  std::vector<size_t> union_plans_;
+  size_t root_plan_;
+  bool planned_;
+  // The offsets of the fields and vector elements being copied.
+  std::vector<uoffset_t> offsets_;
+};
+
+// Re-encodes buffers of one version of a schema as buffers of another, e.g.
+// to rewrite stored data after fields were deprecated, renamed or moved.
+// Works out up front, once per type of table, which fields to carry over
+// and where to, much like TableCopier:
+// - Fields are matched by name, or failing that by id, so renamed fields
+//   keep their data. Fields deprecated or removed in "to" are left out.
+// - Scalars (and vectors of them) whose type changed are converted.
+// - Scalars that weren't set get the default of "from" stored where it
+//   differs from that of "to", so they read back the same.
+// - The types of unions are matched by name, so union members may be
+//   reordered.
+// Tables that are the same in both schemas, down to everything they refer
+// to, are copied by TableCopier, so with their inline data in one piece.
+// Changes that buffers can't be migrated across, such as fields changing
+// between tables and strings, structs changing layout, or enum values being
+// renumbered, are reported by errors(). Both schemas need a root type, and tables and enums keep their
+// (fully qualified) names.
+class SchemaMigrator {
+ public:
+  SchemaMigrator(const reflection::Schema &from, const reflection::Schema &to,
+                 bool use_string_pooling = false);
+
+  // Whether buffers of "from" can be migrated to "to", and if not, why not,
+  // in the style of Parser::ConformTo().
+  bool ok() const { return errors_.empty(); }
+  const std::vector<std::string> &errors() const { return errors_; }
+
+  // Migrates "table", which must be of the root type of "from", into "fbb".
+  Offset<const Table *> Migrate(FlatBufferBuilder &fbb, const Table &table);
+
+  // Migrates the buffer "buf" into "fbb", and finishes it with the file
+  // identifier of "to", if any.
+  void MigrateBuffer(FlatBufferBuilder &fbb, const uint8_t *buf);
+
+  // Migrates the "count" buffers at "buffers" into "migrated", in runs of
+  // "run" buffers spread over the threads of "executor" if given. For the
+  // records of a StreamReader, pass Record(i) + sizeof(uoffset_t).
+  void MigrateAll(const uint8_t *const *buffers, size_t count,
+                  std::vector<DetachedBuffer> *migrated,
+                  ParallelExecutor *executor = nullptr,
+                  size_t run = 256) const;
+
+ private:
+  struct FieldPlan {
+    voffset_t from;  // Offsets of the field in both versions of the table.
+    voffset_t to;
+    reflection::BaseType type;  // Of "to", converted from from_type.
+    reflection::BaseType from_type;
+    reflection::BaseType element;  // Of vectors.
+    reflection::BaseType from_element;
+    // Of scalars and structs in "to", or the elements of vectors of them.
+    uoffset_t size;
+    uoffset_t align;
+    uoffset_t from_size;
+    bool nested_flatbuffer;
+    size_t object;  // Of tables, or vectors of them, in "from".
+    // Of unions and their types: the type field in "from", and the types
+    // of "to" and objects of "from" by type of "from" in union_types_.
+    voffset_t union_type;
+    size_t unions;
+    size_t num_unions;
+    // Of scalars: stored where the field isn't set.
+    bool fill;
+    uint64_t fill_value;
+  };
+
+  struct UnionType {
+    uint8_t type;  // 0 leaves out the union.
+    size_t object;
+  };
+
+  struct Plan {
+    // The same as in "from", so copied by copier_.
+    bool unchanged;
+    // Scalars and structs, largest alignment first. Those before num_wide
+    // align to at least an offset, so are stored before the offsets.
+    std::vector<FieldPlan> inline_fields;
+    size_t num_wide;
+    std::vector<FieldPlan> offset_fields;  // Strings, tables etc.
+  };
+
+  void AddPlan(size_t object, const reflection::Object &to_objectdef);
+  void AddField(const reflection::Object &from_objectdef,
+                const reflection::Object &to_objectdef,
+                const reflection::Field &from_field,
+                const reflection::Field &to_field, Plan *plan);
+  bool SameStruct(const reflection::Object &from_objectdef,
+                  const reflection::Object &to_objectdef) const;
+  bool SameObject(uoffset_t from_index, uoffset_t to_index,
+                  bool *is_struct) const;
+  bool Unchanged(size_t object) const;
+  void FindUnchanged();
+  uoffset_t MigrateTable(FlatBufferBuilder &fbb, size_t object,
+                         const Table &table);
+  uoffset_t MigrateField(FlatBufferBuilder &fbb, const FieldPlan &field,
+                         const Table &table, const uint8_t *ref);
+  uoffset_t MigrateVector(FlatBufferBuilder &fbb, const FieldPlan &field,
+                          const uint8_t *ref);
+  uoffset_t MigrateString(FlatBufferBuilder &fbb, const uint8_t *ref);
+  const UnionType *GetUnionType(const FieldPlan &field, uint8_t type) const;
+
+  const reflection::Schema &from_;
+  const reflection::Schema &to_;
+  bool use_string_pooling_;
+  std::vector<std::string> errors_;
+  // One plan per object of "from".
+  std::vector<Plan> plans_;
+  std::vector<UnionType> union_types_;
+  TableCopier copier_;
+  // The offsets of the fields and vector elements being migrated.
+  std::vector<uoffset_t> offsets_;
+};
+
 // Verifies the provided flatbuffer using reflection.
 // root should point to the root type for this flatbuffer.
 // buf should point to the start of flatbuffer data.
@@ -472,6 +887,11 @@ Offset<const Table *> CopyTable(FlatBufferBuilder &fbb,
 bool Verify(const reflection::Schema &schema, const reflection::Object &root,
             const uint8_t *buf, size_t length);
 
+// As above, but with a Verifier for `buf` set up by the caller, e.g. with
+// other limits, or to collect VerifierStats.
+bool Verify(const reflection::Schema &schema, const reflection::Object &root,
+            const uint8_t *buf, Verifier &verifier);
+
 }  // namespace flatbuffers
 
 #endif  // FLATBUFFERS_REFLECTION_H_
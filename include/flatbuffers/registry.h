@@ -28,11 +28,13 @@ namespace flatbuffers {
 class Registry {
  public:
   // Call this for all schemas that may be in use. The identifier has
-  // a function in the generated code, e.g. MonsterIdentifier().
+  // a function in the generated code, e.g. MonsterIdentifier(). The schema
+  // may also be a binary one (.bfbs, see Parser::Deserialize()), which loads
+  // faster.
   void Register(const char *file_identifier, const char *schema_path) {
-    Schema schema;
+    auto &schema = schemas_[file_identifier];
     schema.path_ = schema_path;
-    schemas_[file_identifier] = schema;
+    schema.compiled_.reset();
   }
 
   // Generate text from an arbitrary FlatBuffer by looking up its
@@ -47,11 +49,11 @@ class Registry {
     std::string ident(
         reinterpret_cast<const char *>(flatbuf) + sizeof(uoffset_t),
         FlatBufferBuilder::kFileIdentifierLength);
-    // Load and parse the schema.
-    Parser parser;
-    if (!LoadSchema(ident, &parser)) return false;
+    // Load and parse the schema, the first time.
+    auto schema = LoadSchema(ident);
+    if (!schema) return false;
     // Now we're ready to generate text.
-    if (!GenerateText(parser, flatbuf, dest)) {
+    if (!GenerateText(schema->parser(), flatbuf, dest)) {
       lasterror_ = "unable to generate text for FlatBuffer binary";
       return false;
     }
@@ -63,10 +65,11 @@ class Registry {
   // If DetachedBuffer::data() is null then parsing failed.
   DetachedBuffer TextToFlatBuffer(const char *text,
                                   const char *file_identifier) {
-    // Load and parse the schema.
-    Parser parser;
-    if (!LoadSchema(file_identifier, &parser)) return DetachedBuffer();
+    // Load and parse the schema, the first time.
+    auto schema = LoadSchema(file_identifier);
+    if (!schema) return DetachedBuffer();
     // Parse the text.
+    Parser parser(*schema);
     if (!parser.Parse(text)) {
       lasterror_ = parser.error_;
       return DetachedBuffer();
@@ -76,7 +79,13 @@ class Registry {
   }
 
   // Modify any parsing / output options used by the other functions.
-  void SetOptions(const IDLOptions &opts) { opts_ = opts; }
+  void SetOptions(const IDLOptions &opts) {
+    opts_ = opts;
+    // The schemas may parse differently now.
+    for (auto it = schemas_.begin(); it != schemas_.end(); ++it) {
+      it->second.compiled_.reset();
+    }
+  }
 
   // If schemas used contain include statements, call this function for every
   // directory the parser should search them for.
@@ -86,34 +95,43 @@ class Registry {
   const std::string &GetLastError() { return lasterror_; }
 
  private:
-  bool LoadSchema(const std::string &ident, Parser *parser) {
+  const CompiledSchema *LoadSchema(const std::string &ident) {
     // Find the schema, if not, exit.
     auto it = schemas_.find(ident);
     if (it == schemas_.end()) {
       // Don't attach the identifier, since it may not be human readable.
       lasterror_ = "identifier for this buffer not in the registry";
-      return false;
+      return nullptr;
     }
     auto &schema = it->second;
+    if (schema.compiled_) return schema.compiled_.get();
     // Load the schema from disk. If not, exit.
+    auto binary = GetExtension(schema.path_) == reflection::SchemaExtension();
     std::string schematext;
-    if (!LoadFile(schema.path_.c_str(), false, &schematext)) {
+    if (!LoadFile(schema.path_.c_str(), binary, &schematext)) {
       lasterror_ = "could not load schema: " + schema.path_;
-      return false;
+      return nullptr;
     }
     // Parse schema.
-    parser->opts = opts_;
-    if (!parser->Parse(schematext.c_str(), vector_data(include_paths_),
-                       schema.path_.c_str())) {
-      lasterror_ = parser->error_;
-      return false;
+    flatbuffers::unique_ptr<CompiledSchema> compiled(new CompiledSchema(opts_));
+    auto ok = binary ? compiled->Deserialize(reinterpret_cast<const uint8_t *>(
+                                                 schematext.c_str()),
+                                             schematext.size())
+                     : compiled->Parse(schematext.c_str(),
+                                       vector_data(include_paths_),
+                                       schema.path_.c_str());
+    if (!ok) {
+      lasterror_ = compiled->parser().error_;
+      return nullptr;
     }
-    return true;
+    schema.compiled_ = std::move(compiled);
+    return schema.compiled_.get();
   }
 
   struct Schema {
     std::string path_;
-    // TODO(wvo) optionally cache schema file or parsed schema here.
+    // Parsed on first use.
+    flatbuffers::unique_ptr<CompiledSchema> compiled_;
   };
 
   std::string lasterror_;
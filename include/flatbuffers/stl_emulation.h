@@ -48,14 +48,15 @@ inline char string_back(const std::string &value) {
 
 // Helper method that retrieves ::data() from a vector in a way that is
 // compatible with pre C++11 STLs (e.g stlport).
-template <typename T> inline T *vector_data(std::vector<T> &vector) {
+template <typename T, typename Alloc>
+inline T *vector_data(std::vector<T, Alloc> &vector) {
   // In some debug environments, operator[] does bounds checking, so &vector[0]
   // can't be used.
   return vector.empty() ? nullptr : &vector[0];
 }
 
-template <typename T> inline const T *vector_data(
-    const std::vector<T> &vector) {
+template <typename T, typename Alloc> inline const T *vector_data(
+    const std::vector<T, Alloc> &vector) {
   return vector.empty() ? nullptr : &vector[0];
 }
 
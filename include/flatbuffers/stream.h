@@ -0,0 +1,392 @@
+/*
+ * Copyright 2018 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLATBUFFERS_STREAM_H_
+#define FLATBUFFERS_STREAM_H_
+
+#include "flatbuffers/flatbuffers.h"
+#include "flatbuffers/util.h"
+
+// A container for many size-prefixed FlatBuffers (records) in one file, such
+// as a log, that can be read back by record number without scanning it.
+//
+// A stream is laid out as:
+// - A 16 byte header: the magic "FBST", the format version, the index
+//   interval, and 4 bytes of zeros.
+// - The records, each a size-prefixed FlatBuffer (as made by
+//   FinishSizePrefixed()) stored as is, starting at a multiple of
+//   FLATBUFFERS_MAX_ALIGNMENT, zero padded in between.
+// - When the writer is finished, an index: the 64-bit file offset of every
+//   `interval`-th record (a sparse index), followed by a 24 byte trailer: the
+//   offset the index starts at (which is where the records end), the number
+//   of records (both 64-bit), `interval`, and the magic "FBSX".
+// All numbers are little endian. A stream that was never finished (e.g. the
+// writer crashed, or is still appending to it) has no index, and is read by
+// scanning the records once.
+
+namespace flatbuffers {
+
+static const char kStreamMagic[] = "FBST";
+static const char kStreamIndexMagic[] = "FBSX";
+static const uint32_t kStreamVersion = 1;
+static const size_t kStreamHeaderSize = 16;
+static const size_t kStreamTrailerSize = 24;
+
+// Reads a stream from memory, or from a file it maps into memory. Finding
+// record `i` takes the index entry for it and steps over at most `interval`
+// record sizes from there, wherever in the file it is.
+class StreamReader {
+ public:
+  StreamReader() { Clear(); }
+
+  // Reads the `size` bytes at `data`, which must stay valid while they are
+  // read. Returns false if they don't start with a stream header. A stream
+  // without an index, or one that is cut short, is scanned for the records
+  // that are complete.
+  bool Open(const uint8_t *data, size_t size) {
+    Clear();
+    if (size < kStreamHeaderSize || memcmp(data, kStreamMagic, 4) ||
+        ReadScalar<uint32_t>(data + 4) != kStreamVersion ||
+        !ReadScalar<uint32_t>(data + 8))
+      return false;
+    data_ = data;
+    size_ = size;
+    interval_ = ReadScalar<uint32_t>(data + 8);
+    if (!ReadIndex()) ScanRecords();
+    return true;
+  }
+
+  // Maps the file "name" and reads it as above.
+  bool Open(const char *name) {
+    MappedBuffer mapped;
+    if (!mapped.Map(name)) return false;
+    mapped_.swap(mapped);
+    return Open(mapped_.data(), mapped_.size());
+  }
+
+  // The number of records.
+  size_t size() const { return num_records_; }
+
+  // Whether the stream was read from its index, rather than scanned.
+  bool indexed() const { return indexed_; }
+
+  // Where the records end, and so where a StreamWriter carrying on with the
+  // stream starts writing (anything after it is replaced).
+  size_t records_end() const { return records_end_; }
+
+  uint32_t interval() const { return interval_; }
+
+  // Record `i` as a size-prefixed buffer, and its size including the prefix
+  // in `*size` if given. Returns nullptr if `i` is out of range or the
+  // record doesn't fit in the stream.
+  const uint8_t *Record(size_t i, size_t *size = nullptr) const {
+    if (i >= num_records_) return nullptr;
+    size_t pos = index_[i / interval_];
+    for (size_t n = i % interval_; n; n--) {
+      pos = NextRecord(pos);
+      if (!pos) return nullptr;
+    }
+    auto record_size = RecordSize(pos);
+    if (!record_size) return nullptr;
+    if (size) *size = record_size;
+    return data_ + pos;
+  }
+
+  // Where in the stream record `i` starts, or 0 if it can't be found.
+  size_t RecordOffset(size_t i) const {
+    auto record = Record(i);
+    return record ? static_cast<size_t>(record - data_) : 0;
+  }
+
+  template<typename T> const T *GetRoot(size_t i) const {
+    auto record = Record(i);
+    return record ? GetSizePrefixedRoot<T>(record) : nullptr;
+  }
+
+  template<typename T> bool VerifyRecord(size_t i) const {
+    size_t size;
+    auto record = Record(i, &size);
+    if (!record) return false;
+    Verifier verifier(record, size);
+    return verifier.VerifySizePrefixedBuffer<T>(nullptr);
+  }
+
+  // Verifies every record as a T, in runs of `interval` records, spread over
+  // the threads of `executor` if given. Returns the number of records that
+  // aren't valid.
+  template<typename T>
+  size_t VerifyAll(ParallelExecutor *executor = nullptr) const {
+    VerifyContext context = { this, &VerifyRun<T>, {} };
+    context.failures.resize(index_.size());
+    auto num_runs = index_.size();
+    if (executor) {
+      executor->ParallelFor(num_runs, &VerifyTask, &context);
+    } else {
+      for (size_t run = 0; run < num_runs; run++) VerifyTask(&context, run);
+    }
+    size_t failures = 0;
+    for (auto it = context.failures.begin(); it != context.failures.end();
+         ++it)
+      failures += *it;
+    return failures;
+  }
+
+ private:
+  FLATBUFFERS_DELETE_FUNC(StreamReader(const StreamReader &))
+  FLATBUFFERS_DELETE_FUNC(StreamReader &operator=(const StreamReader &))
+
+  struct VerifyContext {
+    const StreamReader *reader;
+    size_t (*run)(const StreamReader &reader, size_t run);
+    std::vector<size_t> failures;  // By run.
+  };
+
+  static void VerifyTask(void *context, size_t run) {
+    auto c = static_cast<VerifyContext *>(context);
+    c->failures[run] = c->run(*c->reader, run);
+  }
+
+  // Verifies the records of index entry `run`, stepping from one to the next
+  // rather than looking each one up.
+  template<typename T>
+  static size_t VerifyRun(const StreamReader &reader, size_t run) {
+    auto first = run * reader.interval_;
+    auto last = (std::min)(first + reader.interval_, reader.num_records_);
+    size_t pos = reader.index_[run];
+    size_t failures = 0;
+    for (auto i = first; i < last; i++) {
+      auto size = pos ? reader.RecordSize(pos) : 0;
+      if (size) {
+        Verifier verifier(reader.data_ + pos, size);
+        if (!verifier.VerifySizePrefixedBuffer<T>(nullptr)) failures++;
+        pos = reader.NextRecord(pos);
+      } else {
+        failures++;
+      }
+    }
+    return failures;
+  }
+
+  void Clear() {
+    data_ = nullptr;
+    size_ = 0;
+    interval_ = 1;
+    num_records_ = 0;
+    records_end_ = kStreamHeaderSize;
+    indexed_ = false;
+    index_.clear();
+  }
+
+  // The size, with its prefix, of the record at `pos`, or 0 if it doesn't
+  // fit before the end of the records.
+  size_t RecordSize(size_t pos) const {
+    auto end = indexed_ ? records_end_ : size_;
+    if (pos + sizeof(uoffset_t) > end) return 0;
+    size_t size = ReadScalar<uoffset_t>(data_ + pos) + sizeof(uoffset_t);
+    return size <= end - pos ? size : 0;
+  }
+
+  // Where the record after the one at `pos` starts, or 0 if the one at `pos`
+  // doesn't fit.
+  size_t NextRecord(size_t pos) const {
+    auto size = RecordSize(pos);
+    if (!size) return 0;
+    pos += size;
+    return pos + PaddingBytes(pos, FLATBUFFERS_MAX_ALIGNMENT);
+  }
+
+  bool ReadIndex() {
+    if (size_ < kStreamHeaderSize + kStreamTrailerSize) return false;
+    auto trailer = data_ + size_ - kStreamTrailerSize;
+    if (memcmp(trailer + 20, kStreamIndexMagic, 4) ||
+        ReadScalar<uint32_t>(trailer + 16) != interval_)
+      return false;
+    auto index_start = ReadScalar<uint64_t>(trailer);
+    auto num_records = ReadScalar<uint64_t>(trailer + 8);
+    if (index_start < kStreamHeaderSize ||
+        index_start > size_ - kStreamTrailerSize)
+      return false;
+    // The trailer may be anything, so bound the counts in it by the space
+    // there is for them before computing with them. Each record takes at
+    // least its size prefix.
+    auto max_entries =
+        (size_ - kStreamTrailerSize - index_start) / sizeof(uint64_t);
+    auto max_records = (index_start - kStreamHeaderSize) / sizeof(uoffset_t);
+    if (num_records > max_records) return false;
+    auto num_entries = num_records / interval_ + (num_records % interval_ != 0);
+    if (num_entries > max_entries ||
+        index_start + num_entries * sizeof(uint64_t) + kStreamTrailerSize !=
+            size_)
+      return false;
+    index_.resize(static_cast<size_t>(num_entries));
+    for (size_t i = 0; i < index_.size(); i++) {
+      auto offset =
+          ReadScalar<uint64_t>(data_ + index_start + i * sizeof(uint64_t));
+      if (offset < kStreamHeaderSize || offset >= index_start) {
+        index_.clear();
+        return false;
+      }
+      index_[i] = static_cast<size_t>(offset);
+    }
+    num_records_ = static_cast<size_t>(num_records);
+    records_end_ = static_cast<size_t>(index_start);
+    indexed_ = true;
+    return true;
+  }
+
+  // Whether the record at `pos` can be a FlatBuffer, with room for a root
+  // offset pointing past itself and a table. The index and trailer of a
+  // stream (whose index wasn't believed) can't: their 64-bit offsets have
+  // zeros where the root offset would be.
+  bool PlausibleRecord(size_t pos) const {
+    auto size = RecordSize(pos);
+    if (size < 3 * sizeof(uoffset_t)) return false;
+    auto root = ReadScalar<uoffset_t>(data_ + pos + sizeof(uoffset_t));
+    return root >= sizeof(uoffset_t) &&
+           root <= size - sizeof(uoffset_t) - sizeof(soffset_t);
+  }
+
+  void ScanRecords() {
+    size_t pos = kStreamHeaderSize;
+    while (PlausibleRecord(pos)) {
+      if (num_records_ % interval_ == 0) index_.push_back(pos);
+      num_records_++;
+      pos = NextRecord(pos);
+      // An unfinished stream may end in the middle of the padding.
+      records_end_ = (std::min)(pos, size_);
+      if (pos >= size_) break;
+    }
+  }
+
+  MappedBuffer mapped_;
+  const uint8_t *data_;
+  size_t size_;
+  uint32_t interval_;
+  size_t num_records_;
+  size_t records_end_;
+  bool indexed_;
+  std::vector<size_t> index_;  // Offsets of every `interval_`-th record.
+};
+
+// Writes records to a Sink as a stream, keeping the sparse index in memory
+// until Finish() writes it out after the records.
+class StreamWriter {
+ public:
+  // Starts a new stream, writing its header. Every `interval`-th record gets
+  // an index entry: a larger interval makes the index smaller, and finding a
+  // record slower. Check ok() to see whether writing the header worked.
+  explicit StreamWriter(Sink &out, uint32_t interval = 64)
+      : out_(out),
+        interval_(interval ? interval : 1),
+        pos_(0),
+        num_records_(0),
+        ok_(true) {
+    uint8_t header[kStreamHeaderSize] = {};
+    memcpy(header, kStreamMagic, 4);
+    WriteScalar(header + 4, kStreamVersion);
+    WriteScalar(header + 8, interval_);
+    Write(header, sizeof(header));
+  }
+
+  // Carries on with the stream in `existing`, writing to `out` where its
+  // records end, at `existing.records_end()`: e.g. a file truncated there
+  // and opened for appending. Its index is replaced when this is finished.
+  StreamWriter(Sink &out, const StreamReader &existing)
+      : out_(out),
+        interval_(existing.interval()),
+        pos_(existing.records_end()),
+        num_records_(existing.size()),
+        ok_(true) {
+    for (size_t i = 0; i < num_records_; i += interval_)
+      index_.push_back(existing.RecordOffset(i));
+    // An unfinished stream may end before the padding after its last record.
+    Pad();
+  }
+
+  // Appends the `size` byte size-prefixed FlatBuffer at `buf`. Returns false
+  // if it isn't one, or writing failed (after which the stream stays
+  // unusable).
+  bool Append(const uint8_t *buf, size_t size) {
+    if (!ok_ || size < sizeof(uoffset_t) ||
+        ReadScalar<uoffset_t>(buf) != size - sizeof(uoffset_t))
+      return false;
+    if (num_records_ % interval_ == 0) index_.push_back(pos_);
+    if (!Write(buf, size) || !Pad()) return false;
+    num_records_++;
+    return true;
+  }
+
+  // Appends the buffer `fbb` was finished with, using FinishSizePrefixed().
+  // The builder can then be Clear()-ed and reused for the next record.
+  bool Append(const FlatBufferBuilder &fbb) {
+    return Append(fbb.GetBufferPointer(), fbb.GetSize());
+  }
+
+  // Writes the index after the records. Nothing can be appended after this.
+  bool Finish() {
+    if (!ok_) return false;
+    auto index_start = pos_;
+    std::vector<uint8_t> index(index_.size() * sizeof(uint64_t) +
+                               kStreamTrailerSize);
+    for (size_t i = 0; i < index_.size(); i++)
+      WriteScalar(&index[i * sizeof(uint64_t)], index_[i]);
+    auto trailer = &index[index_.size() * sizeof(uint64_t)];
+    WriteScalar(trailer, index_start);
+    WriteScalar(trailer + 8, static_cast<uint64_t>(num_records_));
+    WriteScalar(trailer + 16, interval_);
+    memcpy(trailer + 20, kStreamIndexMagic, 4);
+    auto written = Write(index.data(), index.size());
+    ok_ = false;
+    return written;
+  }
+
+  // The number of records in the stream.
+  size_t size() const { return num_records_; }
+
+  // The number of bytes in the stream so far.
+  uint64_t bytes() const { return pos_; }
+
+  bool ok() const { return ok_; }
+
+ private:
+  FLATBUFFERS_DELETE_FUNC(StreamWriter(const StreamWriter &))
+  FLATBUFFERS_DELETE_FUNC(StreamWriter &operator=(const StreamWriter &))
+
+  bool Write(const uint8_t *data, size_t size) {
+    ok_ = ok_ && out_.Write(data, size);
+    pos_ += size;
+    return ok_;
+  }
+
+  // Zero pads so the next record starts aligned.
+  bool Pad() {
+    static const uint8_t zeros[FLATBUFFERS_MAX_ALIGNMENT] = {};
+    auto pad = PaddingBytes(static_cast<size_t>(pos_),
+                            FLATBUFFERS_MAX_ALIGNMENT);
+    return !pad || Write(zeros, pad);
+  }
+
+  Sink &out_;
+  uint32_t interval_;
+  uint64_t pos_;
+  size_t num_records_;
+  bool ok_;
+  std::vector<uint64_t> index_;  // Offsets of every `interval_`-th record.
+};
+
+}  // namespace flatbuffers
+
+#endif  // FLATBUFFERS_STREAM_H_
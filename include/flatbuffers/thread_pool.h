@@ -0,0 +1,134 @@
+/*
+ * Copyright 2018 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLATBUFFERS_THREAD_POOL_H_
+#define FLATBUFFERS_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "flatbuffers/flatbuffers.h"
+
+namespace flatbuffers {
+
+// A fixed set of worker threads running ParallelFor() loops, e.g. for
+// Verifier::SetParallel(). The thread calling ParallelFor() works on the
+// tasks too, and every thread claims the next task as soon as it is done with
+// its previous one, so threads that get cheap tasks simply do more of them.
+// One ParallelFor() runs at a time; tasks must not call ParallelFor() on the
+// same pool.
+class ThreadPool : public ParallelExecutor {
+ public:
+  // Starts `num_threads` threads besides the calling one, by default one less
+  // than the number of hardware threads.
+  explicit ThreadPool(size_t num_threads = DefaultNumThreads())
+      : task_(nullptr),
+        context_(nullptr),
+        num_tasks_(0),
+        next_(0),
+        busy_(0),
+        generation_(0),
+        stop_(false) {
+    for (size_t i = 0; i < num_threads; i++) {
+      workers_.push_back(std::thread(&ThreadPool::WorkerLoop, this));
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto it = workers_.begin(); it != workers_.end(); ++it) it->join();
+  }
+
+  void ParallelFor(size_t num_tasks, Task task,
+                   void *context) FLATBUFFERS_OVERRIDE {
+    if (workers_.empty() || num_tasks <= 1) {
+      for (size_t i = 0; i < num_tasks; i++) task(context, i);
+      return;
+    }
+    std::lock_guard<std::mutex> run_lock(run_mutex_);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      task_ = task;
+      context_ = context;
+      num_tasks_ = num_tasks;
+      next_ = 0;
+      busy_ = workers_.size();
+      generation_++;
+    }
+    wake_.notify_all();
+    RunTasks();
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (busy_) done_.wait(lock);
+  }
+
+  // The number of threads working on a ParallelFor(), including the caller.
+  size_t concurrency() const { return workers_.size() + 1; }
+
+  static size_t DefaultNumThreads() {
+    auto n = std::thread::hardware_concurrency();
+    return n > 1 ? n - 1 : 0;
+  }
+
+ private:
+  FLATBUFFERS_DELETE_FUNC(ThreadPool(const ThreadPool &))
+  FLATBUFFERS_DELETE_FUNC(ThreadPool &operator=(const ThreadPool &))
+
+  void RunTasks() {
+    for (;;) {
+      auto i = next_.fetch_add(1);
+      if (i >= num_tasks_) break;
+      task_(context_, i);
+    }
+  }
+
+  void WorkerLoop() {
+    size_t generation = 0;
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stop_ && generation == generation_) wake_.wait(lock);
+        if (stop_) return;
+        generation = generation_;
+      }
+      RunTasks();
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!--busy_) done_.notify_one();
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  std::mutex run_mutex_;  // Held for the duration of a ParallelFor().
+  std::mutex mutex_;      // Guards the fields below, except next_.
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  Task task_;
+  void *context_;
+  size_t num_tasks_;
+  std::atomic<size_t> next_;
+  size_t busy_;
+  size_t generation_;
+  bool stop_;
+};
+
+}  // namespace flatbuffers
+
+#endif  // FLATBUFFERS_THREAD_POOL_H_
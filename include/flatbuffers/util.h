@@ -34,14 +34,18 @@
 #  include <windows.h>  // Must be included before <direct.h>
 #  include <direct.h>
 #  include <winbase.h>
+#  include <io.h>
 #  undef interface  // This is also important because of reasons
 #else
 #  include <limits.h>
+#  include <unistd.h>
 #endif
+#include <errno.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 
 #include "flatbuffers/base.h"
+#include "flatbuffers/flatbuffers.h"
 
 namespace flatbuffers {
 
@@ -102,6 +106,69 @@ template<> inline std::string NumToString<float>(float t) {
   return FloatToString(t, 6);
 }
 
+// Helpers of AppendNumber() below.
+inline void AppendUInt(uint64_t val, std::string *text) {
+  char buf[24];
+  auto p = buf + sizeof(buf);
+  do {
+    *--p = static_cast<char>('0' + val % 10);
+    val /= 10;
+  } while (val);
+  text->append(p, buf + sizeof(buf));
+}
+
+inline void AppendInt(int64_t val, std::string *text) {
+  auto u = static_cast<uint64_t>(val);
+  if (val < 0) {
+    *text += '-';
+    u = 0 - u;
+  }
+  AppendUInt(u, text);
+}
+
+inline void AppendFloat(double val, int precision, std::string *text) {
+  char buf[64];
+  auto len = snprintf(buf, sizeof(buf), "%.*f", precision, val);
+  if (len < 0 || static_cast<size_t>(len) >= sizeof(buf)) {
+    // Only huge numbers have that many digits.
+    *text += FloatToString(val, precision);
+    return;
+  }
+  auto end = buf + len;
+  // snprintf() writes the decimal point of the current C locale, which is
+  // ',' (or even more than one char) in some, so put back the '.' JSON needs.
+  auto point = buf + (*buf == '-');
+  while (point != end && *point >= '0' && *point <= '9') point++;
+  if (point != end && point != buf + (*buf == '-') && *point != '.') {
+    auto digits = point;
+    while (digits != end && (*digits < '0' || *digits > '9')) digits++;
+    *point++ = '.';
+    memmove(point, digits, static_cast<size_t>(end - digits));
+    end -= digits - point;
+  }
+  auto last = end;
+  while (last != buf && last[-1] == '0') last--;
+  if (last != buf) {
+    // Strip trailing zeroes. If it is a whole number, keep one zero.
+    end = last[-1] == '.' ? last + 1 : last;
+  }
+  text->append(buf, end);
+}
+
+// Appends a number to "text" like NumToString() converts it, but without a
+// std::stringstream or a temporary string. Floats are written in fixed
+// notation without trailing zeros, with the precision NumToString() uses.
+template<typename T> inline void AppendNumber(T val, std::string *text) {
+  if (std::is_floating_point<T>::value) {
+    AppendFloat(static_cast<double>(val),
+                sizeof(T) == sizeof(float) ? 6 : 12, text);
+  } else if (std::is_signed<T>::value) {
+    AppendInt(static_cast<int64_t>(val), text);
+  } else {
+    AppendUInt(static_cast<uint64_t>(val), text);
+  }
+}
+
 // Convert an integer value to a hexadecimal string.
 // The returned string length is always xdigits long, prefixed by 0 digits.
 // For example, IntToStringHex(0x23, 8) returns the string "00000023".
@@ -139,18 +206,27 @@ inline uint64_t StringToUInt(const char *str, char **endptr = nullptr,
 typedef bool (*LoadFileFunction)(const char *filename, bool binary,
                                  std::string *dest);
 typedef bool (*FileExistsFunction)(const char *filename);
+typedef bool (*SaveFileFunction)(const char *name, const char *buf, size_t len,
+                                 bool binary);
 
 LoadFileFunction SetLoadFileFunction(LoadFileFunction load_file_function);
 
 FileExistsFunction SetFileExistsFunction(
     FileExistsFunction file_exists_function);
 
+SaveFileFunction SetSaveFileFunction(SaveFileFunction save_file_function);
+
 // Check if file "name" exists.
 bool FileExists(const char *name);
 
 // Check if "name" exists and it is also a directory.
 bool DirExists(const char *name);
 
+// Appends the paths of the files in directory "dir" and its subdirectories
+// to "files", relative to "dir" and with '/' separators, sorted. Returns
+// false if "dir" can't be read.
+bool ListFiles(const char *dir, std::vector<std::string> *files);
+
 // Load file "name" into "buf" returning true if successful
 // false otherwise.  If "binary" is false data is read
 // using ifstream's text mode, otherwise data is read with
@@ -162,13 +238,7 @@ bool LoadFile(const char *name, bool binary, std::string *buf);
 // If "binary" is false data is written using ifstream's
 // text mode, otherwise data is written with no
 // transcoding.
-inline bool SaveFile(const char *name, const char *buf, size_t len,
-                     bool binary) {
-  std::ofstream ofs(name, binary ? std::ofstream::binary : std::ofstream::out);
-  if (!ofs.is_open()) return false;
-  ofs.write(buf, len);
-  return !ofs.bad();
-}
+bool SaveFile(const char *name, const char *buf, size_t len, bool binary);
 
 // Save data "buf" into file "name" returning true if
 // successful, false otherwise.  If "binary" is false
@@ -178,6 +248,136 @@ inline bool SaveFile(const char *name, const std::string &buf, bool binary) {
   return SaveFile(name, buf.c_str(), buf.size(), binary);
 }
 
+// Like SaveFile(), but leaves "name" alone if it already holds exactly "buf",
+// so its modification time doesn't change and build systems don't redo the
+// work that depends on it. Can be passed to SetSaveFileFunction().
+bool SaveFileIfChanged(const char *name, const char *buf, size_t len,
+                       bool binary);
+
+// Sink writing to a file descriptor (file, pipe, socket...), which it
+// doesn't own. To write to a file opened with O_DIRECT, wrap it in a
+// BlockAlignedSink.
+class FileDescriptorSink : public Sink {
+ public:
+  explicit FileDescriptorSink(int fd) : fd_(fd) {}
+
+  bool Write(const uint8_t *data, size_t size) FLATBUFFERS_OVERRIDE {
+    while (size) {
+      // clang-format off
+      #ifdef _WIN32
+        auto n = _write(fd_, data, static_cast<unsigned int>(
+                                     (std::min)(size, size_t(1) << 30)));
+      #else
+        auto n = ::write(fd_, data, size);
+        if (n < 0 && errno == EINTR) continue;
+      #endif
+      // clang-format on
+      if (n <= 0) return false;
+      data += n;
+      size -= static_cast<size_t>(n);
+    }
+    return true;
+  }
+
+ private:
+  int fd_;
+};
+
+// A read-only memory mapping of a file, as an alternative to LoadFile() for
+// large buffers: nothing is read up front and no copy is made, pages are read
+// by the OS as they are accessed. The data is page aligned, so GetRoot() can
+// be used on it directly. The mapping is private, changes to the file while
+// it is mapped may or may not be visible.
+class MappedBuffer {
+ public:
+  // Hints about how the data is going to be accessed, see Advise().
+  enum Advice {
+    kAdviceNormal,
+    kAdviceSequential,  // Read ahead aggressively, pages may be freed early.
+    kAdviceRandom,      // Don't read ahead.
+    kAdviceWillNeed,    // Start reading the range in now.
+  };
+
+  MappedBuffer() : data_(nullptr), size_(0) {
+    // clang-format off
+    #ifdef _WIN32
+      mapping_ = nullptr;
+    #endif
+    // clang-format on
+  }
+
+  MappedBuffer(MappedBuffer &&other) : data_(nullptr), size_(0) {
+    // clang-format off
+    #ifdef _WIN32
+      mapping_ = nullptr;
+    #endif
+    // clang-format on
+    swap(other);
+  }
+
+  MappedBuffer &operator=(MappedBuffer &&other) {
+    MappedBuffer temp(std::move(other));
+    swap(temp);
+    return *this;
+  }
+
+  ~MappedBuffer() { Unmap(); }
+
+  // Map the file "name", replacing any previous mapping. Returns false if
+  // the file can't be opened or mapped. An empty file maps to an empty buffer.
+  bool Map(const char *name);
+
+  void Unmap();
+
+  // Tell the OS how [offset, offset + len) will be accessed; len 0 means up
+  // to the end. Returns false if the hint is not supported or failed, which
+  // is harmless.
+  bool Advise(Advice advice, size_t offset = 0, size_t len = 0) const;
+
+  const uint8_t *data() const { return data_; }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  template<typename T> const T *GetRoot() const {
+    return flatbuffers::GetRoot<T>(data_);
+  }
+
+  template<typename T> const T *GetSizePrefixedRoot() const {
+    return flatbuffers::GetSizePrefixedRoot<T>(data_);
+  }
+
+  // A Verifier or LazyVerifier for the whole mapping. Verifying all of it up
+  // front touches (and so reads) every page that is referenced, a
+  // LazyVerifier only touches the pages that are actually accessed.
+  Verifier GetVerifier(uoffset_t max_depth = 64,
+                       uoffset_t max_tables = 1000000) const {
+    return Verifier(data_, size_, max_depth, max_tables);
+  }
+  LazyVerifier GetLazyVerifier() const { return LazyVerifier(data_, size_); }
+
+  void swap(MappedBuffer &other) {
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    // clang-format off
+    #ifdef _WIN32
+      std::swap(mapping_, other.mapping_);
+    #endif
+    // clang-format on
+  }
+
+ private:
+  FLATBUFFERS_DELETE_FUNC(MappedBuffer(const MappedBuffer &other))
+  FLATBUFFERS_DELETE_FUNC(MappedBuffer &operator=(const MappedBuffer &other))
+
+  const uint8_t *data_;
+  size_t size_;
+  // clang-format off
+  #ifdef _WIN32
+    HANDLE mapping_;
+  #endif
+  // clang-format on
+};
+
 // Functionality for minimalistic portable path handling.
 
 // The functions below behave correctly regardless of whether posix ('/') or
@@ -380,11 +580,61 @@ inline std::string WordWrap(const std::string in, size_t max_length,
   return wrapped;
 }
 
+// clang-format off
+#if defined(FLATBUFFERS_SIMD_AVX2) || defined(FLATBUFFERS_SIMD_SSE2)
+  #ifdef _MSC_VER
+    #include <intrin.h>
+  #endif
+
+// The index of the lowest bit set in `mask`, which mustn't be 0.
+inline int FirstSetBit(uint32_t mask) {
+  #ifdef _MSC_VER
+    unsigned long i;
+    _BitScanForward(&i, mask);
+    return static_cast<int>(i);
+  #else
+    return __builtin_ctz(mask);
+  #endif
+}
+#endif
+// clang-format on
+
+// Returns the first char in [s, end) that EscapeString() doesn't copy as is.
+inline const char *SkipUnescapedChars(const char *s, const char *end) {
+  // clang-format off
+  #if defined(FLATBUFFERS_SIMD_AVX2) || defined(FLATBUFFERS_SIMD_SSE2)
+    for (; s + 16 <= end; s += 16) {
+      auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s));
+      // Below ' ' or above '~', compared unsigned.
+      auto low = _mm_cmpeq_epi8(_mm_min_epu8(chunk, _mm_set1_epi8(0x1F)),
+                                chunk);
+      auto high = _mm_cmpeq_epi8(_mm_max_epu8(chunk, _mm_set1_epi8(0x7F)),
+                                 chunk);
+      auto quote = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\"'));
+      auto backslash = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'));
+      auto mask = static_cast<uint32_t>(_mm_movemask_epi8(
+          _mm_or_si128(_mm_or_si128(low, high),
+                       _mm_or_si128(quote, backslash))));
+      if (mask) return s + FirstSetBit(mask);
+    }
+  #endif
+  // clang-format on
+  while (s < end && *s >= ' ' && *s <= '~' && *s != '\"' && *s != '\\') s++;
+  return s;
+}
+
 inline bool EscapeString(const char *s, size_t length, std::string *_text,
                          bool allow_non_utf8) {
   std::string &text = *_text;
   text += "\"";
   for (uoffset_t i = 0; i < length; i++) {
+    // Most strings are mostly printable ASCII, copy that in one go.
+    auto run = SkipUnescapedChars(s + i, s + length);
+    if (run != s + i) {
+      text.append(s + i, run);
+      i = static_cast<uoffset_t>(run - s);
+      if (i == length) break;
+    }
     char c = s[i];
     switch (c) {
       case '\n': text += "\\n"; break;
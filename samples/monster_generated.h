@@ -293,6 +293,12 @@ template<> inline const Weapon *Monster::equipped_as<Weapon>() const {
 struct MonsterBuilder {
   flatbuffers::FlatBufferBuilder &fbb_;
   flatbuffers::uoffset_t start_;
+  // The most the fields take up, padding included, if added
+  // in the order CreateMonster() adds them.
+  enum {
+    kMaxInlineSize = 37,
+    kNumFields = 10
+  };
   void add_pos(const Vec3 *pos) {
     fbb_.AddStruct(Monster::VT_POS, pos);
   }
@@ -322,7 +328,7 @@ struct MonsterBuilder {
   }
   explicit MonsterBuilder(flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
-    start_ = fbb_.StartTable();
+    start_ = fbb_.StartTable(kMaxInlineSize, kNumFields);
   }
   MonsterBuilder &operator=(const MonsterBuilder &);
   flatbuffers::Offset<Monster> Finish() {
@@ -427,6 +433,12 @@ struct Weapon FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
 struct WeaponBuilder {
   flatbuffers::FlatBufferBuilder &fbb_;
   flatbuffers::uoffset_t start_;
+  // The most the fields take up, padding included, if added
+  // in the order CreateWeapon() adds them.
+  enum {
+    kMaxInlineSize = 9,
+    kNumFields = 2
+  };
   void add_name(flatbuffers::Offset<flatbuffers::String> name) {
     fbb_.AddOffset(Weapon::VT_NAME, name);
   }
@@ -435,7 +447,7 @@ struct WeaponBuilder {
   }
   explicit WeaponBuilder(flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
-    start_ = fbb_.StartTable();
+    start_ = fbb_.StartTable(kMaxInlineSize, kNumFields);
   }
   WeaponBuilder &operator=(const WeaponBuilder &);
   flatbuffers::Offset<Weapon> Finish() {
@@ -476,14 +488,14 @@ inline MonsterT *Monster::UnPack(const flatbuffers::resolver_function_t *_resolv
 inline void Monster::UnPackTo(MonsterT *_o, const flatbuffers::resolver_function_t *_resolver) const {
   (void)_o;
   (void)_resolver;
-  { auto _e = pos(); if (_e) _o->pos = flatbuffers::unique_ptr<Vec3>(new Vec3(*_e)); };
+  { auto _e = pos(); if (_e) { if (_o->pos) *_o->pos = *_e; else _o->pos = flatbuffers::unique_ptr<Vec3>(new Vec3(*_e)); } else _o->pos.reset(); };
   { auto _e = mana(); _o->mana = _e; };
   { auto _e = hp(); _o->hp = _e; };
-  { auto _e = name(); if (_e) _o->name = _e->str(); };
-  { auto _e = inventory(); if (_e) { _o->inventory.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->inventory[_i] = _e->Get(_i); } } };
+  { auto _e = name(); if (_e) { _o->name.assign(_e->c_str(), _e->size()); } else _o->name.clear(); };
+  { auto _e = inventory(); if (_e) { _o->inventory.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->inventory[_i] = _e->Get(_i); } } else _o->inventory.clear(); };
   { auto _e = color(); _o->color = _e; };
-  { auto _e = weapons(); if (_e) { _o->weapons.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->weapons[_i] = flatbuffers::unique_ptr<WeaponT>(_e->Get(_i)->UnPack(_resolver)); } } };
-  { auto _e = equipped_type(); _o->equipped.type = _e; };
+  { auto _e = weapons(); if (_e) { _o->weapons.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { if (_o->weapons[_i]) _e->Get(_i)->UnPackTo(_o->weapons[_i].get(), _resolver); else _o->weapons[_i] = flatbuffers::unique_ptr<WeaponT>(_e->Get(_i)->UnPack(_resolver)); } } else _o->weapons.clear(); };
+  { auto _e = equipped_type(); _o->equipped.Reset(); _o->equipped.type = _e; };
   { auto _e = equipped(); if (_e) _o->equipped.value = EquipmentUnion::UnPack(_e, equipped_type(), _resolver); };
 }
 
@@ -526,7 +538,7 @@ inline WeaponT *Weapon::UnPack(const flatbuffers::resolver_function_t *_resolver
 inline void Weapon::UnPackTo(WeaponT *_o, const flatbuffers::resolver_function_t *_resolver) const {
   (void)_o;
   (void)_resolver;
-  { auto _e = name(); if (_e) _o->name = _e->str(); };
+  { auto _e = name(); if (_e) { _o->name.assign(_e->c_str(), _e->size()); } else _o->name.clear(); };
   { auto _e = damage(); _o->damage = _e; };
 }
 
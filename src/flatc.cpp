@@ -18,22 +18,270 @@
 
 #include <list>
 
+#include "flatbuffers/thread_pool.h"
+
 #define FLATC_VERSION "1.8.0 (" __DATE__ " " __TIME__ ")"
 
 namespace flatbuffers {
 
-void FlatCompiler::ParseFile(
+bool FlatCompiler::ParseFile(
     flatbuffers::Parser &parser, const std::string &filename,
     const std::string &contents,
-    std::vector<const char *> &include_directories) const {
+    const std::vector<const char *> &include_directories,
+    Messages *messages) const {
   auto local_include_directory = flatbuffers::StripFileName(filename);
-  include_directories.push_back(local_include_directory.c_str());
-  include_directories.push_back(nullptr);
-  if (!parser.Parse(contents.c_str(), &include_directories[0],
-                    filename.c_str()))
-    Error(parser.error_, false, false);
-  include_directories.pop_back();
-  include_directories.pop_back();
+  auto directories = include_directories;
+  directories.push_back(local_include_directory.c_str());
+  directories.push_back(nullptr);
+  if (parser.Parse(contents.c_str(), &directories[0], filename.c_str()))
+    return true;
+  messages->push_back(Message(Message::kError, parser.error_, false, false));
+  return false;
+}
+
+void FlatCompiler::CompileSchema(const Settings &settings,
+                                 const std::string &filename,
+                                 SchemaResult *result) const {
+  auto &messages = result->messages;
+  std::string contents;
+  if (!flatbuffers::LoadFile(filename.c_str(), true, &contents)) {
+    messages.push_back(Message(Message::kError,
+                               "unable to load file: " + filename, true, true));
+    return;
+  }
+  // Check if file contains 0 bytes.
+  if (contents.length() != strlen(contents.c_str())) {
+    messages.push_back(Message(Message::kError,
+                               "input file appears to be binary: " + filename,
+                               true, true));
+    return;
+  }
+  // If we're processing multiple schemas, make sure to start each one from
+  // scratch. If it depends on previous schemas it must do so explicitly using
+  // an include.
+  result->parser.reset(new flatbuffers::Parser(settings.opts));
+  auto &parser = *result->parser;
+  if (!ParseFile(parser, filename, contents, settings.include_directories,
+                 &messages))
+    return;
+  if (settings.conform_parser) {
+    auto err = parser.ConformTo(*settings.conform_parser);
+    if (!err.empty()) {
+      messages.push_back(
+          Message(Message::kError, "schemas don\'t conform: " + err, true,
+                  true));
+      return;
+    }
+  }
+  if (settings.schema_binary) {
+    parser.Serialize();
+    parser.file_extension_ = reflection::SchemaExtension();
+  }
+  if (!GenerateFiles(settings, parser, filename, true, &messages)) return;
+  // We do not want to generate code for the definitions in this file
+  // in any files coming up next.
+  parser.MarkGenerated();
+  if (!result->keep_parser) result->parser.reset();
+}
+
+void FlatCompiler::CompileSchemaTask(void *context, size_t i) {
+  auto tasks = reinterpret_cast<const SchemaTasks *>(context);
+  auto &schema = tasks->schemas[i];
+  tasks->flatc->CompileSchema(*tasks->settings, *schema.first, schema.second);
+}
+
+bool FlatCompiler::ParseConformSchema(
+    const std::string &dir,
+    const std::vector<const char *> &include_directories,
+    flatbuffers::Parser &parser, ConformResult *result) const {
+  auto filename = flatbuffers::ConCatPathFileName(dir, result->path);
+  std::string contents;
+  if (!flatbuffers::LoadFile(filename.c_str(), true, &contents)) {
+    result->errors.push_back("unable to load file: " + filename);
+    return false;
+  }
+  Messages messages;
+  if (ParseFile(parser, filename, contents, include_directories, &messages))
+    return true;
+  for (auto it = messages.begin(); it != messages.end(); ++it)
+    result->errors.push_back(it->text);
+  return false;
+}
+
+void FlatCompiler::ConformSchema(const ConformTasks &tasks,
+                                 ConformResult *result) const {
+  // Schemas that are only in one of the directories have nothing to conform
+  // to.
+  if (result->status != ConformResult::kOk) return;
+  auto &settings = *tasks.settings;
+  auto opts = settings.opts;
+  opts.proto_mode = flatbuffers::GetExtension(result->path) == "proto";
+  flatbuffers::Parser old_parser(opts);
+  flatbuffers::Parser new_parser(opts);
+  auto old_ok = ParseConformSchema(
+      tasks.old_dir, settings.conform_include_directories, old_parser, result);
+  auto new_ok = ParseConformSchema(tasks.new_dir, settings.include_directories,
+                                   new_parser, result);
+  if (!old_ok || !new_ok) {
+    result->status = ConformResult::kInvalid;
+  } else if (!new_parser.ConformTo(old_parser, &result->errors)) {
+    result->status = ConformResult::kIncompatible;
+  }
+}
+
+void FlatCompiler::ConformSchemaTask(void *context, size_t i) {
+  auto tasks = reinterpret_cast<const ConformTasks *>(context);
+  tasks->flatc->ConformSchema(*tasks, &(*tasks->results)[i]);
+}
+
+int FlatCompiler::ConformDirectories(const Settings &settings,
+                                     const std::string &old_dir,
+                                     const std::string &new_dir,
+                                     size_t jobs) const {
+  std::vector<std::string> old_files;
+  std::vector<std::string> new_files;
+  if (!flatbuffers::ListFiles(old_dir.c_str(), &old_files))
+    Error("unable to read directory: " + old_dir, false);
+  if (!flatbuffers::ListFiles(new_dir.c_str(), &new_files))
+    Error("unable to read directory: " + new_dir, false);
+  auto is_schema = [](const std::string &path) {
+    auto ext = flatbuffers::GetExtension(path);
+    return ext == "fbs" || ext == "proto";
+  };
+  // Both lists are sorted, so merging them pairs up the schemas at the same
+  // path.
+  std::vector<ConformResult> results;
+  size_t oi = 0, ni = 0;
+  while (oi < old_files.size() || ni < new_files.size()) {
+    if (oi < old_files.size() && !is_schema(old_files[oi])) {
+      oi++;
+      continue;
+    }
+    if (ni < new_files.size() && !is_schema(new_files[ni])) {
+      ni++;
+      continue;
+    }
+    ConformResult result;
+    if (ni == new_files.size() ||
+        (oi < old_files.size() && old_files[oi] < new_files[ni])) {
+      result.path = old_files[oi++];
+      result.status = ConformResult::kRemoved;
+    } else if (oi == old_files.size() || new_files[ni] < old_files[oi]) {
+      result.path = new_files[ni++];
+      result.status = ConformResult::kAdded;
+    } else {
+      result.path = new_files[ni++];
+      oi++;
+    }
+    results.push_back(result);
+  }
+
+  ConformTasks tasks;
+  tasks.flatc = this;
+  tasks.settings = &settings;
+  tasks.old_dir = old_dir;
+  tasks.new_dir = new_dir;
+  tasks.results = &results;
+  if (jobs > 1) {
+    flatbuffers::ThreadPool pool(jobs - 1);
+    pool.ParallelFor(results.size(), ConformSchemaTask, &tasks);
+  } else {
+    for (size_t i = 0; i < results.size(); i++) ConformSchemaTask(&tasks, i);
+  }
+
+  static const char *const status_names[] = { "ok", "added", "removed",
+                                              "incompatible", "invalid" };
+  auto failed = false;
+  std::string line;
+  for (auto it = results.begin(); it != results.end(); ++it) {
+    line = "{\"schema\": ";
+    flatbuffers::EscapeString(it->path.c_str(), it->path.size(), &line, true);
+    line += ", \"status\": \"";
+    line += status_names[it->status];
+    line += "\"";
+    if (!it->errors.empty()) {
+      line += ", \"errors\": [";
+      for (auto eit = it->errors.begin(); eit != it->errors.end(); ++eit) {
+        if (eit != it->errors.begin()) line += ", ";
+        flatbuffers::EscapeString(eit->c_str(), eit->size(), &line, true);
+      }
+      line += "]";
+    }
+    line += "}";
+    printf("%s\n", line.c_str());
+    failed = failed || it->status == ConformResult::kIncompatible ||
+             it->status == ConformResult::kInvalid;
+  }
+  return failed ? 1 : 0;
+}
+
+bool FlatCompiler::GenerateFiles(const Settings &settings,
+                                 flatbuffers::Parser &parser,
+                                 const std::string &filename, bool is_schema,
+                                 Messages *messages) const {
+  auto &output_path = settings.output_path;
+  std::string filebase =
+      flatbuffers::StripPath(flatbuffers::StripExtension(filename));
+
+  for (size_t i = 0; i < params_.num_generators; ++i) {
+    parser.opts.lang = params_.generators[i].lang;
+    if (settings.generator_enabled[i]) {
+      if (!settings.print_make_rules) {
+        flatbuffers::EnsureDirExists(output_path);
+        if ((!params_.generators[i].schema_only || is_schema) &&
+            !params_.generators[i].generate(parser, output_path, filebase)) {
+          messages->push_back(Message(
+              Message::kError,
+              std::string("Unable to generate ") +
+                  params_.generators[i].lang_name + " for " + filebase,
+              true, true));
+          return false;
+        }
+      } else {
+        std::string make_rule =
+            params_.generators[i].make_rule(parser, output_path, filename);
+        if (!make_rule.empty())
+          messages->push_back(
+              Message(Message::kMakeRule,
+                      flatbuffers::WordWrap(make_rule, 80, " ", " \\"),
+                      false, false));
+      }
+      if (settings.grpc_enabled) {
+        if (params_.generators[i].generateGRPC != nullptr) {
+          if (!params_.generators[i].generateGRPC(parser, output_path,
+                                                  filebase)) {
+            messages->push_back(Message(
+                Message::kError,
+                std::string("Unable to generate GRPC interface for") +
+                    params_.generators[i].lang_name,
+                true, true));
+            return false;
+          }
+        } else {
+          messages->push_back(Message(
+              Message::kWarning,
+              std::string("GRPC interface generator not implemented for ") +
+                  params_.generators[i].lang_name,
+              false, true));
+        }
+      }
+    }
+  }
+
+  if (settings.opts.proto_mode) GenerateFBS(parser, output_path, filebase);
+  return true;
+}
+
+void FlatCompiler::Report(const Messages &messages) const {
+  for (auto it = messages.begin(); it != messages.end(); ++it) {
+    switch (it->kind) {
+      case Message::kMakeRule: printf("%s\n", it->text.c_str()); break;
+      case Message::kWarning: Warn(it->text, it->show_exe_name); break;
+      case Message::kError:
+        Error(it->text, it->usage, it->show_exe_name);
+        break;
+    }
+  }
 }
 
 void FlatCompiler::Warn(const std::string &warn, bool show_exe_name) const {
@@ -86,6 +334,8 @@ std::string FlatCompiler::GetUsageString(const char *program_name) const {
     "  --gen-onefile      Generate single output file for C# and Go.\n"
     "  --gen-name-strings Generate type name functions for C++.\n"
     "  --gen-object-api   Generate an additional object-based API.\n"
+    "  --gen-json-api     Generate JSON parsers and printers for C++ that\n"
+    "                     don't need the schema at runtime.\n"
     "  --cpp-ptr-type T   Set object API pointer type (default std::unique_ptr)\n"
     "  --cpp-str-type T   Set object API string type (default std::string)\n"
     "                     T::c_str() and T::length() must be supported\n"
@@ -106,10 +356,16 @@ std::string FlatCompiler::GetUsageString(const char *program_name) const {
     "  --grpc             Generate GRPC interfaces for the specified languages\n"
     "  --schema           Serialize schemas instead of JSON (use with -b)\n"
     "  --bfbs-comments    Add doc comments to the binary schema files.\n"
+    "  --bfbs-builtins    Add builtin attributes to the binary schema files.\n"
     "  --conform FILE     Specify a schema the following schemas should be\n"
     "                     an evolution of. Gives errors if not.\n"
     "  --conform-includes Include path for the schema given with --conform\n"
-    "    PATH             \n"
+    "    PATH             (or the old schemas of --conform-dir)\n"
+    "  --conform-dir      Check that each schema under NEW_DIR is an\n"
+    "    OLD_DIR NEW_DIR  evolution of the one at the same path under\n"
+    "                     OLD_DIR, instead of compiling FILEs. Prints a line\n"
+    "                     of JSON per schema, fails if any don't conform.\n"
+    "                     Use with --jobs.\n"
     "  --include-prefix   Prefix this path to any generated include statements.\n"
     "    PATH\n"
     "  --keep-prefix      Keep original prefix of schema include statement.\n"
@@ -117,6 +373,11 @@ std::string FlatCompiler::GetUsageString(const char *program_name) const {
     "  --no-ts-reexport   Don't re-export imported dependencies for TypeScript.\n"
     "  --reflect-types    Add minimal type reflection to code generation.\n"
     "  --reflect-names    Add minimal type/name reflection.\n"
+    "  --jobs N           Compile up to N schema files at once, 0 for one per\n"
+    "                     hardware thread. (Default is 1.)\n"
+    "  --skip-unchanged   Don't write output files whose contents are\n"
+    "                     already up to date, so their modification times\n"
+    "                     don't change.\n"
     "FILEs may be schemas (must end in .fbs), or JSON files (conforming to preceding\n"
     "schema). FILEs after the -- must be binary flatbuffer format files.\n"
     "Output files are named using the base file name of the input,\n"
@@ -146,6 +407,9 @@ int FlatCompiler::Compile(int argc, const char **argv) {
   std::vector<bool> generator_enabled(params_.num_generators, false);
   size_t binary_files_from = std::numeric_limits<size_t>::max();
   std::string conform_to_schema;
+  std::string conform_old_dir;
+  std::string conform_new_dir;
+  size_t jobs = 1;
 
   for (int argi = 0; argi < argc; argi++) {
     std::string arg = argv[argi];
@@ -165,6 +429,10 @@ int FlatCompiler::Compile(int argc, const char **argv) {
       } else if (arg == "--conform") {
         if (++argi >= argc) Error("missing path following" + arg, true);
         conform_to_schema = flatbuffers::PosixPath(argv[argi]);
+      } else if (arg == "--conform-dir") {
+        if (argi + 2 >= argc) Error("missing paths following" + arg, true);
+        conform_old_dir = flatbuffers::PosixPath(argv[++argi]);
+        conform_new_dir = flatbuffers::PosixPath(argv[++argi]);
       } else if (arg == "--conform-includes") {
         if (++argi >= argc) Error("missing path following" + arg, true);
         include_directories_storage.push_back(
@@ -208,6 +476,8 @@ int FlatCompiler::Compile(int argc, const char **argv) {
         opts.generate_name_strings = true;
       } else if (arg == "--gen-object-api") {
         opts.generate_object_based_api = true;
+      } else if (arg == "--gen-json-api") {
+        opts.generate_json_api = true;
       } else if (arg == "--cpp-ptr-type") {
         if (++argi >= argc) Error("missing type following" + arg, true);
         opts.cpp_object_api_pointer_type = argv[argi];
@@ -253,6 +523,8 @@ int FlatCompiler::Compile(int argc, const char **argv) {
         grpc_enabled = true;
       } else if (arg == "--bfbs-comments") {
         opts.binary_schema_comments = true;
+      } else if (arg == "--bfbs-builtins") {
+        opts.binary_schema_builtins = true;
       } else if (arg == "--no-fb-import") {
         opts.skip_flatbuffers_import = true;
       } else if (arg == "--no-ts-reexport") {
@@ -261,6 +533,16 @@ int FlatCompiler::Compile(int argc, const char **argv) {
         opts.mini_reflect = IDLOptions::kTypes;
       } else if (arg == "--reflect-names") {
         opts.mini_reflect = IDLOptions::kTypesAndNames;
+      } else if (arg == "--jobs") {
+        if (++argi >= argc) Error("missing number following" + arg, true);
+        char *end;
+        auto n = flatbuffers::StringToUInt(argv[argi], &end);
+        if (*end || end == argv[argi])
+          Error("invalid number of jobs: " + std::string(argv[argi]), true);
+        jobs = n ? static_cast<size_t>(n)
+                 : flatbuffers::ThreadPool::DefaultNumThreads() + 1;
+      } else if (arg == "--skip-unchanged") {
+        flatbuffers::SetSaveFileFunction(flatbuffers::SaveFileIfChanged);
       } else {
         for (size_t i = 0; i < params_.num_generators; ++i) {
           if (arg == params_.generators[i].generator_opt_long ||
@@ -280,6 +562,22 @@ int FlatCompiler::Compile(int argc, const char **argv) {
     }
   }
 
+  if (!conform_old_dir.empty()) {
+    if (filenames.size() || any_generator || !conform_to_schema.empty())
+      Error("--conform-dir can't be combined with input files, generators or"
+            " --conform", true);
+    Settings settings;
+    settings.opts = opts;
+    settings.include_directories = include_directories;
+    settings.conform_include_directories = conform_include_directories;
+    settings.conform_parser = nullptr;
+    settings.print_make_rules = false;
+    settings.grpc_enabled = false;
+    settings.schema_binary = false;
+    return ConformDirectories(settings, conform_old_dir, conform_new_dir,
+                              jobs);
+  }
+
   if (!filenames.size()) Error("missing input files", false, true);
 
   if (opts.proto_mode) {
@@ -294,8 +592,49 @@ int FlatCompiler::Compile(int argc, const char **argv) {
     std::string contents;
     if (!flatbuffers::LoadFile(conform_to_schema.c_str(), true, &contents))
       Error("unable to load schema: " + conform_to_schema);
+    Messages messages;
     ParseFile(conform_parser, conform_to_schema, contents,
-              conform_include_directories);
+              conform_include_directories, &messages);
+    Report(messages);
+  }
+
+  Settings settings;
+  settings.opts = opts;
+  settings.output_path = output_path;
+  settings.include_directories = include_directories;
+  settings.generator_enabled = generator_enabled;
+  settings.conform_parser =
+      conform_to_schema.empty() ? nullptr : &conform_parser;
+  settings.conform_include_directories = conform_include_directories;
+  settings.print_make_rules = print_make_rules;
+  settings.grpc_enabled = grpc_enabled;
+  settings.schema_binary = schema_binary;
+
+  // Schema files don't depend on each other, just on the files they include,
+  // so with --jobs they're all compiled up front. Data files are parsed with
+  // the schema before them, so they're still done one after the other.
+  std::vector<SchemaResult> schemas(filenames.size());
+  for (size_t i = 0; i < filenames.size(); i++) {
+    auto ext = flatbuffers::GetExtension(filenames[i]);
+    if (i < binary_files_from && (ext == "fbs" || ext == "proto") &&
+        i + 1 < filenames.size()) {
+      auto next = flatbuffers::GetExtension(filenames[i + 1]);
+      schemas[i].keep_parser = i + 1 >= binary_files_from ||
+                               (next != "fbs" && next != "proto");
+    }
+  }
+  auto parallel = jobs > 1;
+  if (parallel) {
+    SchemaTasks tasks;
+    tasks.flatc = this;
+    tasks.settings = &settings;
+    for (size_t i = 0; i < filenames.size() && i < binary_files_from; i++) {
+      auto ext = flatbuffers::GetExtension(filenames[i]);
+      if (ext == "fbs" || ext == "proto")
+        tasks.schemas.push_back(std::make_pair(&filenames[i], &schemas[i]));
+    }
+    flatbuffers::ThreadPool pool(jobs - 1);
+    pool.ParallelFor(tasks.schemas.size(), CompileSchemaTask, &tasks);
   }
 
   std::unique_ptr<flatbuffers::Parser> parser(new flatbuffers::Parser(opts));
@@ -303,14 +642,23 @@ int FlatCompiler::Compile(int argc, const char **argv) {
   for (auto file_it = filenames.begin(); file_it != filenames.end();
        ++file_it) {
     auto &filename = *file_it;
+    auto index = static_cast<size_t>(file_it - filenames.begin());
+    bool is_binary = index >= binary_files_from;
+    auto ext = flatbuffers::GetExtension(filename);
+    auto is_schema = ext == "fbs" || ext == "proto";
+    if (is_schema && !is_binary) {
+      auto &schema = schemas[index];
+      if (!parallel) CompileSchema(settings, filename, &schema);
+      Report(schema.messages);
+      if (schema.parser) parser.swap(schema.parser);
+      schema.parser.reset();
+      continue;
+    }
+
     std::string contents;
     if (!flatbuffers::LoadFile(filename.c_str(), true, &contents))
       Error("unable to load file: " + filename);
 
-    bool is_binary =
-        static_cast<size_t>(file_it - filenames.begin()) >= binary_files_from;
-    auto ext = flatbuffers::GetExtension(filename);
-    auto is_schema = ext == "fbs" || ext == "proto";
     if (is_binary) {
       parser->builder_.Clear();
       parser->builder_.PushFlatBuffer(
@@ -340,67 +688,26 @@ int FlatCompiler::Compile(int argc, const char **argv) {
       if (contents.length() != strlen(contents.c_str())) {
         Error("input file appears to be binary: " + filename, true);
       }
-      if (is_schema) {
-        // If we're processing multiple schemas, make sure to start each
-        // one from scratch. If it depends on previous schemas it must do
-        // so explicitly using an include.
-        parser.reset(new flatbuffers::Parser(opts));
-      }
-      ParseFile(*parser.get(), filename, contents, include_directories);
-      if (!is_schema && !parser->builder_.GetSize()) {
+      Messages messages;
+      ParseFile(*parser.get(), filename, contents, include_directories,
+                &messages);
+      Report(messages);
+      if (!parser->builder_.GetSize()) {
         // If a file doesn't end in .fbs, it must be json/binary. Ensure we
         // didn't just parse a schema with a different extension.
         Error(
             "input file is neither json nor a .fbs (schema) file: " + filename,
             true);
       }
-      if (is_schema && !conform_to_schema.empty()) {
-        auto err = parser->ConformTo(conform_parser);
-        if (!err.empty()) Error("schemas don\'t conform: " + err);
-      }
       if (schema_binary) {
         parser->Serialize();
         parser->file_extension_ = reflection::SchemaExtension();
       }
     }
 
-    std::string filebase =
-        flatbuffers::StripPath(flatbuffers::StripExtension(filename));
-
-    for (size_t i = 0; i < params_.num_generators; ++i) {
-      parser->opts.lang = params_.generators[i].lang;
-      if (generator_enabled[i]) {
-        if (!print_make_rules) {
-          flatbuffers::EnsureDirExists(output_path);
-          if ((!params_.generators[i].schema_only || is_schema) &&
-              !params_.generators[i].generate(*parser.get(), output_path,
-                                              filebase)) {
-            Error(std::string("Unable to generate ") +
-                  params_.generators[i].lang_name + " for " + filebase);
-          }
-        } else {
-          std::string make_rule = params_.generators[i].make_rule(
-              *parser.get(), output_path, filename);
-          if (!make_rule.empty())
-            printf("%s\n",
-                   flatbuffers::WordWrap(make_rule, 80, " ", " \\").c_str());
-        }
-        if (grpc_enabled) {
-          if (params_.generators[i].generateGRPC != nullptr) {
-            if (!params_.generators[i].generateGRPC(*parser.get(), output_path,
-                                                    filebase)) {
-              Error(std::string("Unable to generate GRPC interface for") +
-                    params_.generators[i].lang_name);
-            }
-          } else {
-            Warn(std::string("GRPC interface generator not implemented for ") +
-                 params_.generators[i].lang_name);
-          }
-        }
-      }
-    }
-
-    if (opts.proto_mode) GenerateFBS(*parser.get(), output_path, filebase);
+    Messages messages;
+    GenerateFiles(settings, *parser.get(), filename, false, &messages);
+    Report(messages);
 
     // We do not want to generate code for the definitions in this file
     // in any files coming up next.
@@ -19,6 +19,7 @@
 #include "flatbuffers/code_generators.h"
 #include "flatbuffers/flatbuffers.h"
 #include "flatbuffers/idl.h"
+#include "flatbuffers/json.h"
 #include "flatbuffers/util.h"
 
 namespace flatbuffers {
@@ -209,6 +210,12 @@ class CppGenerator : public BaseGenerator {
     if (parser_.uses_flexbuffers_) {
       code_ += "#include \"flatbuffers/flexbuffers.h\"";
     }
+    if (parser_.uses_hash_indices_) {
+      code_ += "#include \"flatbuffers/hash.h\"";
+    }
+    if (parser_.opts.generate_json_api) {
+      code_ += "#include \"flatbuffers/json.h\"";
+    }
     code_ += "";
 
     if (parser_.opts.include_dependence_headers) { GenIncludeDependencies(); }
@@ -290,6 +297,45 @@ class CppGenerator : public BaseGenerator {
       }
     }
 
+    // Generate the JSON parsers and printers, declaring them all first since
+    // they may call each other.
+    if (parser_.opts.generate_json_api) {
+      for (auto it = parser_.enums_.vec.begin();
+           it != parser_.enums_.vec.end(); ++it) {
+        const auto &enum_def = **it;
+        if (!enum_def.generated) {
+          SetNameSpace(enum_def.defined_namespace);
+          GenEnumJson(enum_def);
+          if (enum_def.is_union) GenJsonDecls(enum_def, true);
+        }
+      }
+      for (auto it = parser_.structs_.vec.begin();
+           it != parser_.structs_.vec.end(); ++it) {
+        const auto &struct_def = **it;
+        if (!struct_def.generated) {
+          SetNameSpace(struct_def.defined_namespace);
+          GenJsonDecls(struct_def, false);
+        }
+      }
+      for (auto it = parser_.enums_.vec.begin();
+           it != parser_.enums_.vec.end(); ++it) {
+        const auto &enum_def = **it;
+        if (enum_def.is_union && !enum_def.generated) {
+          SetNameSpace(enum_def.defined_namespace);
+          GenUnionJson(enum_def);
+        }
+      }
+      for (auto it = parser_.structs_.vec.begin();
+           it != parser_.structs_.vec.end(); ++it) {
+        const auto &struct_def = **it;
+        if (!struct_def.generated) {
+          SetNameSpace(struct_def.defined_namespace);
+          GenStructJsonParser(struct_def);
+          GenStructJsonPrinter(struct_def);
+        }
+      }
+    }
+
     // Generate code for mini reflection.
     if (parser_.opts.mini_reflect != IDLOptions::kNone) {
       // Then the unions/enums that may refer to them.
@@ -430,6 +476,8 @@ class CppGenerator : public BaseGenerator {
         code_ += "}";
         code_ += "";
       }
+
+      if (parser_.opts.generate_json_api) GenRootJson();
     }
 
     if (cur_name_space_) SetNameSpace(nullptr);
@@ -1703,6 +1751,25 @@ class CppGenerator : public BaseGenerator {
         code_ += "  }";
       }
 
+      if (field.attributes.Lookup("hashed")) {
+        auto elem_def = field.value.type.struct_def;
+        auto key_field = HashKeyField(field);
+        code_.SetValue("ELEM_TYPE", WrapInNameSpace(*elem_def));
+        code_.SetValue("KEY_TYPE",
+                       key_field->value.type.base_type == BASE_TYPE_STRING
+                           ? "const char *"
+                           : GenTypeBasic(key_field->value.type, true) + " ");
+        code_.SetValue("INDEX_NAME", Name(field) + HashIndexFieldSuffix());
+
+        code_ +=
+            "  const {{ELEM_TYPE}} *{{FIELD_NAME}}_by_key({{KEY_TYPE}}key)"
+            " const {";
+        code_ +=
+            "    return flatbuffers::LookupByKeyHashed({{FIELD_NAME}}(), "
+            "{{INDEX_NAME}}(), key);";
+        code_ += "  }";
+      }
+
       if (field.flexbuffer) {
         code_ +=
             "  flexbuffers::Reference {{FIELD_NAME}}_flexbuffer_root()"
@@ -1750,6 +1817,8 @@ class CppGenerator : public BaseGenerator {
       }
     }
 
+    if (struct_def.columnar_row) { GenColumnarRow(struct_def); }
+
     // Generate a verifier function that can check a buffer from an untrusted
     // source will never cause reads outside the buffer.
     code_ += "  bool Verify(flatbuffers::Verifier &verifier) const {";
@@ -1823,6 +1892,57 @@ class CppGenerator : public BaseGenerator {
     }
   }
 
+  // Generate row access for a table generated for a (columnar) vector: a
+  // Row view with the accessors of the row table, reading element i of each
+  // column. Rows beyond the end of a column have the field's default.
+  void GenColumnarRow(const StructDef &struct_def) {
+    const auto &row = *struct_def.columnar_row;
+    code_.SetValue("ROW_NAME", Name(row));
+    code_ += "  // Row i of this table, with the accessors of {{ROW_NAME}}.";
+    code_ += "  struct Row {";
+    code_ += "    const {{STRUCT_NAME}} *columns_;";
+    code_ += "    flatbuffers::uoffset_t i_;";
+    for (auto it = row.fields.vec.begin(); it != row.fields.vec.end(); ++it) {
+      const auto &field = **it;
+      if (field.deprecated) { continue; }
+      const bool is_scalar = IsScalar(field.value.type.base_type);
+      std::string afterptr = " *" + NullableExtension();
+      code_.SetValue("FIELD_NAME", Name(field));
+      code_.SetValue("FIELD_TYPE", GenTypeGet(field.value.type, " ", "const ",
+                                              afterptr.c_str(), true));
+      code_.SetValue("FIELD_VALUE",
+                     GenUnderlyingCast(field, true, "column->Get(i_)"));
+      code_.SetValue("DEFAULT_VALUE", is_scalar
+                                          ? GetDefaultScalarValue(field, false)
+                                          : "nullptr");
+      code_ += "    {{FIELD_TYPE}}{{FIELD_NAME}}() const {";
+      code_ += "      auto column = columns_->{{FIELD_NAME}}();";
+      code_ +=
+          "      return column && i_ < column->size() ? {{FIELD_VALUE}} "
+          ": {{DEFAULT_VALUE}};";
+      code_ += "    }";
+    }
+    code_ += "  };";
+
+    // The number of rows is that of the longest column.
+    code_ += "  flatbuffers::uoffset_t GetRowCount() const {";
+    code_ += "    flatbuffers::uoffset_t rows = 0;";
+    for (auto it = struct_def.fields.vec.begin();
+         it != struct_def.fields.vec.end(); ++it) {
+      const auto &field = **it;
+      if (field.deprecated) { continue; }
+      code_.SetValue("FIELD_NAME", Name(field));
+      code_ += "    if ({{FIELD_NAME}}() && {{FIELD_NAME}}()->size() > rows) "
+               "rows = {{FIELD_NAME}}()->size();";
+    }
+    code_ += "    return rows;";
+    code_ += "  }";
+    code_ += "  Row GetRow(flatbuffers::uoffset_t i) const {";
+    code_ += "    Row row = { this, i };";
+    code_ += "    return row;";
+    code_ += "  }";
+  }
+
   void GenBuilders(const StructDef &struct_def) {
     code_.SetValue("STRUCT_NAME", Name(struct_def));
 
@@ -1831,6 +1951,33 @@ class CppGenerator : public BaseGenerator {
     code_ += "  flatbuffers::FlatBufferBuilder &fbb_;";
     code_ += "  flatbuffers::uoffset_t start_;";
 
+    // The space the fields take up when added the way CreateX() below adds
+    // them: largest alignment first, so only the first one may need padding
+    // in front of it, unless the fields are kept in their original order.
+    size_t max_align = 1;
+    size_t inline_size = 0;
+    for (auto it = struct_def.fields.vec.begin();
+         it != struct_def.fields.vec.end(); ++it) {
+      const auto &field = **it;
+      if (field.deprecated) { continue; }
+      const auto align = InlineAlignment(field.value.type);
+      inline_size += InlineSize(field.value.type);
+      if (struct_def.sortbysize) {
+        max_align = (std::max)(max_align, align);
+      } else {
+        inline_size += align - 1;
+      }
+    }
+    if (struct_def.sortbysize) { inline_size += max_align - 1; }
+    code_.SetValue("MAX_INLINE_SIZE", NumToString(inline_size));
+    code_.SetValue("NUM_FIELDS", NumToString(struct_def.fields.vec.size()));
+    code_ += "  // The most the fields take up, padding included, if added";
+    code_ += "  // in the order Create{{STRUCT_NAME}}() adds them.";
+    code_ += "  enum {";
+    code_ += "    kMaxInlineSize = {{MAX_INLINE_SIZE}},";
+    code_ += "    kNumFields = {{NUM_FIELDS}}";
+    code_ += "  };";
+
     bool has_string_or_vector_fields = false;
     for (auto it = struct_def.fields.vec.begin();
          it != struct_def.fields.vec.end(); ++it) {
@@ -1879,7 +2026,7 @@ class CppGenerator : public BaseGenerator {
         "  explicit {{STRUCT_NAME}}Builder(flatbuffers::FlatBufferBuilder "
         "&_fbb)";
     code_ += "        : fbb_(_fbb) {";
-    code_ += "    start_ = fbb_.StartTable();";
+    code_ += "    start_ = fbb_.StartTable(kMaxInlineSize, kNumFields);";
     code_ += "  }";
 
     // Assignment operator;
@@ -1920,13 +2067,16 @@ class CppGenerator : public BaseGenerator {
     code_ += ") {";
 
     code_ += "  {{STRUCT_NAME}}Builder builder_(_fbb);";
-    for (size_t size = struct_def.sortbysize ? sizeof(largest_scalar_t) : 1;
-         size; size /= 2) {
+    // Alignments are powers of two, and sizes multiples of them, so adding
+    // the fields largest alignment first leaves no padding between them.
+    for (size_t align = struct_def.sortbysize ? max_align : 1; align;
+         align /= 2) {
       for (auto it = struct_def.fields.vec.rbegin();
            it != struct_def.fields.vec.rend(); ++it) {
         const auto &field = **it;
-        if (!field.deprecated && (!struct_def.sortbysize ||
-                                  size == SizeOf(field.value.type.base_type))) {
+        if (!field.deprecated &&
+            (!struct_def.sortbysize ||
+             align == InlineAlignment(field.value.type))) {
           code_.SetValue("FIELD_NAME", Name(field));
           code_ += "  builder_.add_{{FIELD_NAME}}({{FIELD_NAME}});";
         }
@@ -2033,6 +2183,76 @@ class CppGenerator : public BaseGenerator {
     }
   };
 
+  // Generates code that assigns "val" to "dest" like GenUnpackVal(), but
+  // reuses what "dest" already holds where it can, so that unpacking into an
+  // object again doesn't allocate its strings and tables anew, of the forms:
+  //   dest.assign(val->c_str(), val->size())
+  //   if (dest) val->UnPackTo(dest.get(), _resolver); else dest = ...
+  std::string GenUnpackAssign(const Type &type, const std::string &dest,
+                              const std::string &val, bool invector,
+                              const FieldDef &afield) {
+    const auto assign =
+        dest + " = " + GenUnpackVal(type, val, invector, afield);
+    switch (type.base_type) {
+      case BASE_TYPE_STRING: {
+        if (NativeString(&afield) != "std::string") { return assign; }
+        return dest + ".assign(" + val + "->c_str(), " + val + "->size())";
+      }
+      case BASE_TYPE_STRUCT: {
+        if (PtrType(&afield) == "naked") { return assign; }
+        if (IsStruct(type)) {
+          if (type.struct_def->attributes.Lookup("native_type") || invector ||
+              afield.native_inline) {
+            return assign;
+          }
+          return "if (" + dest + ") *" + dest + " = *" + val + "; else " +
+                 assign;
+        }
+        return "if (" + dest + ") " + val + "->UnPackTo(" + dest +
+               GenPtrGet(afield) + ", _resolver); else " + assign;
+      }
+      default: {
+        return assign;
+      }
+    }
+  }
+
+  // Generates code that resets a field that isn't set in the buffer, for when
+  // unpacking into an object that was unpacked to before. Returns an empty
+  // string for fields that are left alone.
+  std::string GenUnpackClearStatement(const FieldDef &field) {
+    const auto &type = field.value.type;
+    const auto dest = "_o->" + Name(field);
+    switch (type.base_type) {
+      case BASE_TYPE_STRING: {
+        if (NativeString(&field) != "std::string") {
+          return dest + " = " + NativeString(&field) + "();";
+        }
+        return dest + ".clear();";
+      }
+      case BASE_TYPE_VECTOR: {
+        if (type.element == BASE_TYPE_UTYPE) {
+          return "_o->" + StripUnionType(Name(field)) + ".clear();";
+        }
+        return dest + ".clear();";
+      }
+      case BASE_TYPE_STRUCT: {
+        if (IsStruct(type) &&
+            type.struct_def->attributes.Lookup("native_type")) {
+          return "";
+        }
+        if (IsStruct(type) && field.native_inline) {
+          return dest + " = " + WrapInNameSpace(*type.struct_def) + "();";
+        }
+        if (PtrType(&field) == "naked") { return ""; }
+        return dest + ".reset();";
+      }
+      default: {
+        return "";
+      }
+    }
+  }
+
   std::string GenUnpackFieldStatement(const FieldDef &field,
                                       const FieldDef *union_field) {
     std::string code;
@@ -2081,17 +2301,22 @@ class CppGenerator : public BaseGenerator {
             code += "/* else do nothing */";
           }
         } else {
-          code += "_o->" + name + "[_i]" + access + " = ";
-          code +=
-            GenUnpackVal(field.value.type.VectorType(), indexing, true, field);
+          if (field.value.type.element == BASE_TYPE_UTYPE) {
+            code += "_o->" + name + "[_i].Reset(); ";
+          }
+          code += GenUnpackAssign(field.value.type.VectorType(),
+                                  "_o->" + name + "[_i]" + access, indexing,
+                                  true, field);
         }
         code += "; } }";
         break;
       }
       case BASE_TYPE_UTYPE: {
         assert(union_field->value.type.base_type == BASE_TYPE_UNION);
-        // Generate code that sets the union type, of the form:
-        //   _o->field.type = _e;
+        // Generate code that frees the old union value and sets the type, of
+        // the form:
+        //   _o->field.Reset(); _o->field.type = _e;
+        code += "_o->" + union_field->name + ".Reset(); ";
         code += "_o->" + union_field->name + ".type = _e;";
         break;
       }
@@ -2127,8 +2352,8 @@ class CppGenerator : public BaseGenerator {
         } else {
           // Generate code for assigning the value, of the form:
           //  _o->field = value;
-          code += "_o->" + Name(field) + " = ";
-          code += GenUnpackVal(field.value.type, "_e", false, field) + ";";
+          code += GenUnpackAssign(field.value.type, "_o->" + Name(field), "_e",
+                                  false, field) + ";";
         }
         break;
       }
@@ -2136,6 +2361,30 @@ class CppGenerator : public BaseGenerator {
     return code;
   }
 
+  // The hashed vector field whose hash index `field` is, if it is one.
+  static const FieldDef *HashedVectorOf(const StructDef &struct_def,
+                                        const FieldDef &field) {
+    for (auto it = struct_def.fields.vec.begin();
+         it != struct_def.fields.vec.end(); ++it) {
+      if ((*it)->attributes.Lookup("hashed") &&
+          (*it)->name + HashIndexFieldSuffix() == field.name)
+        return *it;
+    }
+    return nullptr;
+  }
+
+  // The key field of the tables of the hashed vector `field`.
+  static const FieldDef *HashKeyField(const FieldDef &field) {
+    auto elem_def = field.value.type.struct_def;
+    const FieldDef *key_field = nullptr;
+    for (auto it = elem_def->fields.vec.begin();
+         it != elem_def->fields.vec.end(); ++it) {
+      if ((*it)->key) key_field = *it;
+    }
+    assert(key_field);  // Guaranteed by the parser.
+    return key_field;
+  }
+
   std::string GenCreateParam(const FieldDef &field) {
     std::string value = "_o->";
     if (field.value.type.base_type == BASE_TYPE_UTYPE) {
@@ -2323,7 +2572,18 @@ class CppGenerator : public BaseGenerator {
         auto prefix = "  { auto _e = {{FIELD_NAME}}(); ";
         auto check = IsScalar(field.value.type.base_type) ? "" : "if (_e) ";
         auto postfix = " };";
-        code_ += std::string(prefix) + check + statement + postfix;
+        // Fields that aren't set are reset, in case |_o| was unpacked to
+        // before.
+        const auto clear =
+            *check ? GenUnpackClearStatement(field) : std::string();
+        if (clear.empty()) {
+          code_ += std::string(prefix) + check + statement + postfix;
+        } else {
+          const auto block =
+              statement[0] == '{' ? statement : "{ " + statement + " }";
+          code_ += std::string(prefix) + check + block + " else " + clear +
+                   postfix;
+        }
       }
       code_ += "}";
       code_ += "";
@@ -2355,7 +2615,17 @@ class CppGenerator : public BaseGenerator {
            it != struct_def.fields.vec.end(); ++it) {
         auto &field = **it;
         if (field.deprecated) { continue; }
-        code_ += "  auto _" + Name(field) + " = " + GenCreateParam(field) + ";";
+        auto hashed = HashedVectorOf(struct_def, field);
+        if (hashed) {
+          // Index the vector as packed, whatever index _o holds.
+          code_ += "  auto _" + Name(field) +
+                   " = flatbuffers::CreateHashIndex(_fbb, _" + Name(*hashed) +
+                   ", &" + WrapInNameSpace(*hashed->value.type.struct_def) +
+                   "::" + Name(*HashKeyField(*hashed)) + ");";
+        } else {
+          code_ += "  auto _" + Name(field) + " = " + GenCreateParam(field) +
+                   ";";
+        }
       }
       // Need to call "Create" with the struct namespace.
       const auto qualified_create_name =
@@ -2577,6 +2847,617 @@ class CppGenerator : public BaseGenerator {
     code_ += "";
   }
 
+  // JSON parsers and printers (--gen-json-api), using the runtime in
+  // flatbuffers/json.h.
+
+  std::string JsonFunction(const Definition &def, const std::string &prefix,
+                           const std::string &suffix) {
+    return WrapInNameSpace(def.defined_namespace, prefix + Name(def) + suffix);
+  }
+
+  std::string JsonParseSignature(const Definition &def, bool is_union) {
+    auto name = Name(def);
+    if (is_union) {
+      return "bool Parse" + name + "Json(flatbuffers::JsonReader &_json, " +
+             "flatbuffers::FlatBufferBuilder &_fbb, " + name +
+             " type, flatbuffers::Offset<void> *_o)";
+    }
+    auto &struct_def = static_cast<const StructDef &>(def);
+    if (struct_def.fixed) {
+      return "bool Parse" + name + "Json(flatbuffers::JsonReader &_json, " +
+             name + " *_o)";
+    }
+    return "bool Parse" + name + "Json(flatbuffers::JsonReader &_json, " +
+           "flatbuffers::FlatBufferBuilder &_fbb, flatbuffers::Offset<" +
+           name + "> *_o)";
+  }
+
+  std::string JsonPrintSignature(const Definition &def, bool is_union) {
+    auto name = Name(def);
+    if (is_union) {
+      return "void Print" + name + "Json(flatbuffers::JsonWriter &_json, " +
+             "const void *_o, " + name + " type)";
+    }
+    return "void Print" + name + "Json(flatbuffers::JsonWriter &_json, " +
+           "const " + name + " &_o)";
+  }
+
+  // The code to read the field's offset in a table.
+  std::string JsonFieldOffset(const StructDef &struct_def,
+                              const FieldDef &field) {
+    // Deprecated fields don't have an enum value.
+    if (field.deprecated) return NumToString(field.value.offset);
+    return Name(struct_def) + "::" + GenFieldOffsetName(field);
+  }
+
+  static size_t JsonFieldIndex(const StructDef &struct_def,
+                               const FieldDef &field) {
+    auto &fields = struct_def.fields.vec;
+    return static_cast<size_t>(
+        std::find(fields.begin(), fields.end(), &field) - fields.begin());
+  }
+
+  static std::string JsonHashFunction(const FieldDef &field) {
+    auto hash = field.attributes.Lookup("hash");
+    if (!hash) return "";
+    auto type = field.value.type.base_type == BASE_TYPE_VECTOR
+                    ? field.value.type.element
+                    : field.value.type.base_type;
+    // Parser only hashes strings for 32 and 64 bit fields.
+    if (type != BASE_TYPE_INT && type != BASE_TYPE_UINT &&
+        type != BASE_TYPE_LONG && type != BASE_TYPE_ULONG)
+      return "";
+    auto &name = hash->constant;
+    auto underscore = name.find('_');
+    if (underscore == std::string::npos) return "";
+    auto function = name.substr(0, underscore) == "fnv1a" ? "HashFnv1a"
+                                                          : "HashFnv1";
+    return "flatbuffers::" + std::string(function) + "<uint" +
+           name.substr(underscore + 1) + "_t>";
+  }
+
+  // The code to parse a scalar of `type` (the field's type, or its element
+  // type) into `*ptr`.
+  std::string JsonParseScalar(const FieldDef &field, const Type &type,
+                              const std::string &ptr) {
+    auto hash = JsonHashFunction(field);
+    if (!hash.empty()) return "_json.ParseHash(" + ptr + ", " + hash + ")";
+    if (type.base_type == BASE_TYPE_BOOL)
+      return "_json.ParseBool(" + ptr + ")";
+    if (type.enum_def) {
+      return "_json.ParseScalar(" + ptr + ", " +
+             JsonFunction(*type.enum_def, "", "FromJsonName") + ")";
+    }
+    return "_json.ParseScalar(" + ptr + ")";
+  }
+
+  // Generates a switch on the hash of `names`, running `cases[i]` for
+  // names[i] and breaking out of the switch for any other name. Field names
+  // are those of the reader, others the `name` and `len` parameters.
+  void GenJsonNameSwitch(const std::string &hashed, bool is_key,
+                         const std::vector<std::string> &names,
+                         const std::vector<std::string> &cases,
+                         const std::string &indent) {
+    std::map<uint64_t, std::vector<size_t>> by_hash;
+    for (size_t i = 0; i < names.size(); i++) {
+      by_hash[JsonReader::HashKey(names[i].c_str(), names[i].size())]
+          .push_back(i);
+    }
+    code_ += indent + "switch (" + hashed + ") {";
+    for (auto it = by_hash.begin(); it != by_hash.end(); ++it) {
+      code_ += indent + "  case " + NumToString(it->first) + "ULL:";
+      for (auto i = it->second.begin(); i != it->second.end(); ++i) {
+        auto quoted = "\"" + names[*i] + "\"";
+        auto len = NumToString(names[*i].size());
+        code_ += indent + "    if (" +
+                 (is_key ? "_json.KeyIs(" + quoted + ", " + len + ")"
+                         : "len == " + len + " && !memcmp(name, " + quoted +
+                               ", " + len + ")") +
+                 ") {";
+        code_ += cases[*i] + "\\";
+        code_ += indent + "    }";
+      }
+      code_ += indent + "    break;";
+    }
+    code_ += indent + "}";
+  }
+
+  void GenEnumJson(const EnumDef &enum_def) {
+    code_.SetValue("ENUM_NAME", Name(enum_def));
+    code_ += "inline bool {{ENUM_NAME}}FromJsonName(const char *name, "
+             "size_t len, int64_t *val) {";
+    std::vector<std::string> names, cases;
+    for (auto it = enum_def.vals.vec.begin(); it != enum_def.vals.vec.end();
+         ++it) {
+      names.push_back((*it)->name);
+      cases.push_back("        *val = " + NumToString((*it)->value) +
+                      ";\n        return true;\n");
+    }
+    GenJsonNameSwitch("flatbuffers::JsonReader::HashKey(name, len)", false,
+                      names, cases, "  ");
+    code_ += "  return false;";
+    code_ += "}";
+    code_ += "";
+
+    // Like EnumDef::ReverseLookup(), without the NONE of unions.
+    code_ += "inline const char *{{ENUM_NAME}}JsonName(int64_t val) {";
+    code_ += "  switch (val) {";
+    for (auto it = enum_def.vals.vec.begin() + enum_def.is_union;
+         it != enum_def.vals.vec.end(); ++it) {
+      code_ += "    case " + NumToString((*it)->value) + ": return \"" +
+               (*it)->name + "\";";
+    }
+    code_ += "    default: return nullptr;";
+    code_ += "  }";
+    code_ += "}";
+    code_ += "";
+  }
+
+  void GenJsonDecls(const Definition &def, bool is_union) {
+    code_ += "inline " + JsonParseSignature(def, is_union) + ";";
+    code_ += "inline " + JsonPrintSignature(def, is_union) + ";";
+    code_ += "";
+  }
+
+  void GenUnionJson(const EnumDef &enum_def) {
+    code_.SetValue("ENUM_NAME", Name(enum_def));
+    code_ += "inline " + JsonParseSignature(enum_def, true) + " {";
+    code_ += "  switch (type) {";
+    for (auto it = enum_def.vals.vec.begin() + 1;
+         it != enum_def.vals.vec.end(); ++it) {
+      const auto &ev = **it;
+      code_ += "    case " + GetEnumValUse(enum_def, ev) + ": {";
+      auto &type = ev.union_type;
+      if (type.base_type == BASE_TYPE_STRING) {
+        code_ += "      flatbuffers::Offset<flatbuffers::String> _v;";
+        code_ += "      if (!_json.ParseString(_fbb, &_v)) return false;";
+        code_ += "      *_o = _v.Union();";
+      } else if (type.struct_def->fixed) {
+        code_ += "      " + WrapInNameSpace(*type.struct_def) + " _v;";
+        code_ += "      if (!" +
+                 JsonFunction(*type.struct_def, "Parse", "Json") +
+                 "(_json, &_v)) return false;";
+        code_ += "      *_o = _fbb.CreateStruct(_v).Union();";
+      } else {
+        code_ += "      flatbuffers::Offset<" +
+                 WrapInNameSpace(*type.struct_def) + "> _v;";
+        code_ += "      if (!" +
+                 JsonFunction(*type.struct_def, "Parse", "Json") +
+                 "(_json, _fbb, &_v)) return false;";
+        code_ += "      *_o = _v.Union();";
+      }
+      code_ += "      return true;";
+      code_ += "    }";
+    }
+    code_ += "    default:";
+    code_ += "      return _json.Error(\"illegal type id for union: " +
+             enum_def.name + "\");";
+    code_ += "  }";
+    code_ += "}";
+    code_ += "";
+
+    code_ += "inline " + JsonPrintSignature(enum_def, true) + " {";
+    code_ += "  switch (type) {";
+    for (auto it = enum_def.vals.vec.begin() + 1;
+         it != enum_def.vals.vec.end(); ++it) {
+      const auto &ev = **it;
+      code_ += "    case " + GetEnumValUse(enum_def, ev) + ":";
+      auto &type = ev.union_type;
+      if (type.base_type == BASE_TYPE_STRING) {
+        code_ += "      _json.String(*reinterpret_cast<const "
+                 "flatbuffers::String *>(_o));";
+      } else {
+        code_ += "      " + JsonFunction(*type.struct_def, "Print", "Json") +
+                 "(_json, *reinterpret_cast<const " +
+                 WrapInNameSpace(*type.struct_def) + " *>(_o));";
+      }
+      code_ += "      break;";
+    }
+    code_ += "    default: _json.Null(); break;";
+    code_ += "  }";
+    code_ += "}";
+    code_ += "";
+  }
+
+  // The code to parse the value of `field` of a table into `field_`.
+  std::string JsonParseTableField(const StructDef &struct_def,
+                                  const FieldDef &field, size_t index) {
+    static const char *kIndent = "          ";
+    auto local = Name(field) + "_";
+    auto &type = field.value.type;
+    std::string code = kIndent + std::string("if (!_json.SetOnce(&_seen[") +
+                       NumToString(index) + "])) return false;\n";
+    std::string parse;
+    switch (type.base_type) {
+      case BASE_TYPE_STRING:
+        parse = "_json.ParseString(_fbb, &" + local + ")";
+        break;
+      case BASE_TYPE_STRUCT:
+        parse = JsonFunction(*type.struct_def, "Parse", "Json") + "(_json, " +
+                (type.struct_def->fixed ? "" : "_fbb, ") + "&" + local + ")";
+        break;
+      case BASE_TYPE_UNION: {
+        // The type may come after the value, then the value is parsed
+        // after the rest of the object.
+        auto type_field = struct_def.fields.Lookup(field.name +
+                                                   UnionTypeFieldSuffix());
+        auto type_index = JsonFieldIndex(struct_def, *type_field);
+        code += kIndent + std::string("if (!_seen[") +
+                NumToString(type_index) + "]) {\n";
+        code += kIndent + std::string("  ") + local +
+                "text_ = _json.cursor();\n";
+        code += kIndent + std::string("  if (!_json.SkipValue()) return ") +
+                "false;\n";
+        code += kIndent + std::string("  continue;\n");
+        code += kIndent + std::string("}\n");
+        parse = JsonFunction(*type.enum_def, "Parse", "Json") +
+                "(_json, _fbb, static_cast<" +
+                WrapInNameSpace(*type.enum_def) + ">(" + Name(*type_field) +
+                "_), &" + local + ")";
+        break;
+      }
+      case BASE_TYPE_VECTOR: {
+        auto element = type.VectorType();
+        if (field.flexbuffer) {
+          parse = "_json.ParseFlexBuffer(_fbb, &" + local + ")";
+        } else if (field.nested_flatbuffer) {
+          auto &nested = *field.nested_flatbuffer;
+          parse = "_json.ParseNestedFlatBuffer<" + WrapInNameSpace(nested) +
+                  ">(_fbb, &" + local + ", " +
+                  JsonFunction(nested, "Parse", "Json") + ")";
+        } else if (element.base_type == BASE_TYPE_UNION) {
+          parse = "_json.Error(\"vectors of unions are not supported in "
+                  "JSON: " + field.name + "\")";
+        } else {
+          std::string elem_parse;
+          std::string vector_parse = "ParseVector";
+          if (element.base_type == BASE_TYPE_STRING) {
+            elem_parse = "_json.ParseString(_fbb, _e)";
+          } else if (IsStruct(element)) {
+            vector_parse = "ParseStructVector";
+            elem_parse = JsonFunction(*element.struct_def, "Parse", "Json") +
+                         "(_json, _e)";
+          } else if (element.base_type == BASE_TYPE_STRUCT) {
+            elem_parse = JsonFunction(*element.struct_def, "Parse", "Json") +
+                         "(_json, _fbb, _e)";
+          } else {
+            elem_parse = JsonParseScalar(field, element, "_e");
+          }
+          auto elem_type = IsStruct(element)
+                               ? WrapInNameSpace(*element.struct_def)
+                               : GenTypeWire(element, "", false);
+          code += kIndent + std::string("if (!_json.") + vector_parse +
+                  "(_fbb, &" + local + ", [&](" + elem_type + " *_e) {\n";
+          code += kIndent + std::string("      return ") + elem_parse + ";\n";
+          code += kIndent + std::string("    }))\n");
+          code += kIndent + std::string("  return false;\n");
+          return code;
+        }
+        break;
+      }
+      default: parse = JsonParseScalar(field, type, "&" + local); break;
+    }
+    code += kIndent + std::string("if (!") + parse + ") return false;\n";
+    return code;
+  }
+
+  // Generates the JSON parser of a table or struct. Like Parser, it builds
+  // the table after reading the whole object, adding the fields in the same
+  // order, so it makes the same buffer.
+  void GenStructJsonParser(const StructDef &struct_def) {
+    const auto &fields = struct_def.fields.vec;
+    code_ += "inline " + JsonParseSignature(struct_def, false) + " {";
+    // Where the value of each field goes.
+    for (auto it = fields.begin(); it != fields.end(); ++it) {
+      const auto &field = **it;
+      auto &type = field.value.type;
+      auto local = Name(field) + "_";
+      if (IsScalar(type.base_type)) {
+        code_ += "  " + GenTypeBasic(type, false) + " " + local + " = " +
+                 (struct_def.fixed ? "0" : GenDefaultConstant(field)) + ";";
+      } else if (IsStruct(type)) {
+        code_ += "  " + WrapInNameSpace(*type.struct_def) + " " + local + ";";
+      } else {
+        code_ += "  " + GenTypeWire(type, " ", false) + local + ";";
+        if (type.base_type == BASE_TYPE_UNION)
+          code_ += "  const char *" + local + "text_ = nullptr;";
+      }
+    }
+    if (!fields.empty()) {
+      code_ += "  bool _seen[" + NumToString(fields.size()) + "] = {};";
+    }
+    code_ += "  if (!_json.StartObject()) return false;";
+    code_ += "  while (_json.NextKey()) {";
+    if (!fields.empty()) {
+      std::vector<std::string> names, cases;
+      for (size_t i = 0; i < fields.size(); i++) {
+        const auto &field = *fields[i];
+        names.push_back(field.name);
+        std::string code = "          if (_json.SkipNull()) continue;\n";
+        if (struct_def.fixed) {
+          code += "          if (!_json.SetOnce(&_seen[" + NumToString(i) +
+                  "]) ||\n              !";
+          code += IsStruct(field.value.type)
+                      ? JsonFunction(*field.value.type.struct_def, "Parse",
+                                     "Json") +
+                            "(_json, &" + Name(field) + "_)"
+                      : JsonParseScalar(field, field.value.type,
+                                        "&" + Name(field) + "_");
+          code += ")\n            return false;\n";
+        } else {
+          code += JsonParseTableField(struct_def, field, i);
+        }
+        code += "          continue;\n";
+        cases.push_back(code);
+      }
+      GenJsonNameSwitch("_json.key_hash()", true, names, cases, "    ");
+    }
+    code_ += "    if (!_json.UnknownField()) return false;";
+    code_ += "  }";
+    code_ += "  if (!_json.ok()) return false;";
+
+    if (struct_def.fixed) {
+      code_ += "  for (size_t _i = 0; _i < " + NumToString(fields.size()) +
+               "; _i++) {";
+      code_ += "    if (!_seen[_i])";
+      code_ += "      return _json.Error(\"struct: wrong number of "
+               "initializers: " + struct_def.name + "\");";
+      code_ += "  }";
+      std::string args;
+      for (auto it = fields.begin(); it != fields.end(); ++it) {
+        if (it != fields.begin()) args += ", ";
+        args += GenUnderlyingCast(**it, true, Name(**it) + "_");
+      }
+      code_ += "  *_o = " + Name(struct_def) + "(" + args + ");";
+      code_ += "  return true;";
+      code_ += "}";
+      code_ += "";
+      return;
+    }
+
+    for (size_t i = 0; i < fields.size(); i++) {
+      const auto &field = *fields[i];
+      if (!field.required) continue;
+      code_ += "  if (!_seen[" + NumToString(i) + "])";
+      code_ += "    return _json.Error(\"required field is missing: " +
+               field.name + " in " + struct_def.name + "\");";
+    }
+    for (size_t i = 0; i < fields.size(); i++) {
+      const auto &field = *fields[i];
+      if (field.value.type.base_type != BASE_TYPE_UNION) continue;
+      auto local = Name(field) + "_";
+      auto type_name = field.name + UnionTypeFieldSuffix();
+      auto type_field = struct_def.fields.Lookup(type_name);
+      code_ += "  if (" + local + "text_) {";
+      code_ += "    if (!_seen[" +
+               NumToString(JsonFieldIndex(struct_def, *type_field)) + "])";
+      code_ += "      return _json.Error(\"missing type field for this union "
+               "value: " + type_name + "\");";
+      code_ += "    auto _end = _json.cursor();";
+      code_ += "    _json.Seek(" + local + "text_);";
+      code_ += "    if (!" +
+               JsonFunction(*field.value.type.enum_def, "Parse", "Json") +
+               "(_json, _fbb, static_cast<" +
+               WrapInNameSpace(*field.value.type.enum_def) + ">(" +
+               Name(*type_field) + "_), &" + local + "))";
+      code_ += "      return false;";
+      code_ += "    _json.Seek(_end);";
+      code_ += "  }";
+    }
+
+    // Parser adds fields by size (unless original_order), and then by
+    // offset, descending.
+    std::vector<size_t> order;
+    for (size_t i = 0; i < fields.size(); i++) order.push_back(i);
+    std::stable_sort(order.begin(), order.end(),
+                     [&fields](size_t a, size_t b) {
+                       return fields[a]->value.offset >
+                              fields[b]->value.offset;
+                     });
+    code_ += "  const auto _start = _fbb.StartTable();";
+    for (size_t size = struct_def.sortbysize ? sizeof(largest_scalar_t) : 1;
+         size; size /= 2) {
+      for (auto it = order.begin(); it != order.end(); ++it) {
+        const auto &field = *fields[*it];
+        auto &type = field.value.type;
+        if (struct_def.sortbysize && size != SizeOf(type.base_type)) continue;
+        auto local = Name(field) + "_";
+        auto offset = JsonFieldOffset(struct_def, field);
+        code_ += "  if (_seen[" + NumToString(*it) + "]) \\";
+        if (IsScalar(type.base_type)) {
+          code_ += "_fbb.AddElement<" + GenTypeBasic(type, false) + ">(" +
+                   offset + ", " + local + ", " + GenDefaultConstant(field) +
+                   ");";
+        } else if (IsStruct(type)) {
+          code_ += "_fbb.AddStruct(" + offset + ", &" + local + ");";
+        } else {
+          code_ += "_fbb.AddOffset(" + offset + ", " + local + ");";
+        }
+      }
+    }
+    code_ += "  *_o = flatbuffers::Offset<" + Name(struct_def) +
+             ">(_fbb.EndTable(_start));";
+    code_ += "  return true;";
+    code_ += "}";
+    code_ += "";
+  }
+
+  // The code to print the value of a scalar field, or vector element.
+  std::string JsonPrintScalar(const Type &type, const std::string &val) {
+    if (type.base_type == BASE_TYPE_BOOL)
+      return "_json.Scalar(" + val + " != 0);";
+    if (type.enum_def) {
+      return "_json.Enum(" + val + ", " +
+             JsonFunction(*type.enum_def, "", "JsonName") + ");";
+    }
+    return "_json.Scalar(" + val + ");";
+  }
+
+  // Generates the JSON printer of a table or struct, writing the same text
+  // as GenerateText().
+  void GenStructJsonPrinter(const StructDef &struct_def) {
+    const auto &fields = struct_def.fields.vec;
+    code_ += "inline " + JsonPrintSignature(struct_def, false) + " {";
+    if (fields.empty()) {
+      code_ += "  (void)_o;";
+    } else if (struct_def.fixed) {
+      code_ += "  auto _s = reinterpret_cast<const flatbuffers::Struct *>"
+               "(&_o);";
+    } else {
+      code_ += "  auto _t = reinterpret_cast<const flatbuffers::Table *>"
+               "(&_o);";
+    }
+    code_ += "  _json.StartObject();";
+    for (auto it = fields.begin(); it != fields.end(); ++it) {
+      const auto &field = **it;
+      auto &type = field.value.type;
+      auto offset = struct_def.fixed ? NumToString(field.value.offset)
+                                     : JsonFieldOffset(struct_def, field);
+      auto key = "  _json.Key(\"" + field.name + "\");";
+      if (struct_def.fixed) {
+        code_ += key;
+        if (IsStruct(type)) {
+          code_ += "  " + JsonFunction(*type.struct_def, "Print", "Json") +
+                   "(_json, *_s->GetStruct<const " +
+                   WrapInNameSpace(*type.struct_def) + " *>(" + offset + "));";
+        } else {
+          code_ += "  " + JsonPrintScalar(type, "_s->GetField<" +
+                                                    GenTypeBasic(type, false) +
+                                                    ">(" + offset + ")");
+        }
+        continue;
+      }
+      code_ += "  if (_t->CheckField(" + offset + ")) {";
+      code_ += "  " + key;
+      auto pointer = [&](const std::string &pointee) {
+        return "_t->GetPointer<const " + pointee + " *>(" + offset + ")";
+      };
+      switch (type.base_type) {
+        case BASE_TYPE_STRING:
+          code_ += "    _json.String(*" + pointer("flatbuffers::String") +
+                   ");";
+          break;
+        case BASE_TYPE_STRUCT:
+          code_ += "    " + JsonFunction(*type.struct_def, "Print", "Json") +
+                   "(_json, *" +
+                   (IsStruct(type)
+                        ? "_t->GetStruct<const " +
+                              WrapInNameSpace(*type.struct_def) + " *>(" +
+                              offset + ")"
+                        : pointer(WrapInNameSpace(*type.struct_def))) +
+                   ");";
+          break;
+        case BASE_TYPE_UNION: {
+          auto type_field = struct_def.fields.Lookup(field.name +
+                                                     UnionTypeFieldSuffix());
+          code_ += "    " + JsonFunction(*type.enum_def, "Print", "Json") +
+                   "(_json, " + pointer("void") + ",";
+          code_ += "        static_cast<" + WrapInNameSpace(*type.enum_def) +
+                   ">(_t->GetField<uint8_t>(" +
+                   JsonFieldOffset(struct_def, *type_field) + ", 0)));";
+          break;
+        }
+        case BASE_TYPE_VECTOR: {
+          auto element = type.VectorType();
+          if (field.flexbuffer) {
+            code_ += "    _json.FlexBuffer(*" +
+                     pointer("flatbuffers::Vector<uint8_t>") + ");";
+            break;
+          }
+          if (field.nested_flatbuffer) {
+            auto &nested = *field.nested_flatbuffer;
+            code_ += "    " + JsonFunction(nested, "Print", "Json") +
+                     "(_json, *flatbuffers::GetRoot<" +
+                     WrapInNameSpace(nested) + ">(";
+            code_ += "        " + pointer("flatbuffers::Vector<uint8_t>") +
+                     "->data()));";
+            break;
+          }
+          auto vector_type = GenTypePointer(type);
+          if (element.base_type == BASE_TYPE_STRING) {
+            code_ += "    _json.StringVector(*" + pointer(vector_type) + ");";
+            break;
+          }
+          if (IsScalar(element.base_type) && !element.enum_def &&
+              element.base_type != BASE_TYPE_BOOL) {
+            code_ += "    _json.ScalarVector(*" + pointer(vector_type) + ");";
+            break;
+          }
+          code_ += "    auto _v = " + pointer(vector_type) + ";";
+          std::string elem;
+          if (element.base_type == BASE_TYPE_UNION) {
+            auto type_field = struct_def.fields.Lookup(field.name +
+                                                       UnionTypeFieldSuffix());
+            code_ += "    auto _types = _t->GetPointer<const "
+                     "flatbuffers::Vector<uint8_t> *>(";
+            code_ += "        " + JsonFieldOffset(struct_def, *type_field) +
+                     ");";
+            elem = JsonFunction(*element.enum_def, "Print", "Json") +
+                   "(_json, _v->Get(_i), static_cast<" +
+                   WrapInNameSpace(*element.enum_def) +
+                   ">(_types && _i < _types->size() ? _types->Get(_i) : 0));";
+          } else if (element.base_type == BASE_TYPE_STRUCT) {
+            elem = JsonFunction(*element.struct_def, "Print", "Json") +
+                   "(_json, *_v->Get(_i));";
+          } else {
+            elem = JsonPrintScalar(element, "_v->Get(_i)");
+          }
+          code_ += "    _json.StartArray();";
+          code_ += "    for (flatbuffers::uoffset_t _i = 0; _i < _v->size(); "
+                   "_i++) {";
+          code_ += "      _json.Element();";
+          code_ += "      " + elem;
+          code_ += "    }";
+          code_ += "    _json.EndArray();";
+          break;
+        }
+        default:
+          code_ += "    " +
+                   JsonPrintScalar(type, "_t->GetField<" +
+                                             GenTypeBasic(type, false) + ">(" +
+                                             offset + ", " +
+                                             GenDefaultConstant(field) + ")");
+          break;
+      }
+      code_ += "  }";
+    }
+    code_ += "  _json.EndObject();";
+    code_ += "}";
+    code_ += "";
+  }
+
+  // Generates the functions that parse a root table from text, and print a
+  // buffer as text.
+  void GenRootJson() {
+    code_ += "inline bool Parse{{STRUCT_NAME}}FromJson(";
+    code_ += "    const char *text, flatbuffers::FlatBufferBuilder &fbb,";
+    code_ += "    std::string *error = nullptr,";
+    code_ += "    const flatbuffers::JsonOptions &opts = "
+             "flatbuffers::JsonOptions()) {";
+    code_ += "  flatbuffers::JsonReader json(text, opts);";
+    code_ += "  flatbuffers::Offset<{{CPP_NAME}}> root;";
+    code_ += "  if (!Parse{{STRUCT_NAME}}Json(json, fbb, &root) || "
+             "!json.Finish()) {";
+    code_ += "    if (error) *error = json.error();";
+    code_ += "    return false;";
+    code_ += "  }";
+    code_ += "  Finish{{STRUCT_NAME}}Buffer(fbb, root);";
+    code_ += "  return true;";
+    code_ += "}";
+    code_ += "";
+
+    code_ += "inline bool {{STRUCT_NAME}}ToJson(";
+    code_ += "    const void *buf, std::string *text,";
+    code_ += "    const flatbuffers::JsonOptions &opts = "
+             "flatbuffers::JsonOptions()) {";
+    code_ += "  flatbuffers::JsonWriter json(text, opts);";
+    code_ += "  Print{{STRUCT_NAME}}Json(json, *Get{{STRUCT_NAME}}(buf));";
+    code_ += "  json.Finish();";
+    code_ += "  return json.ok();";
+    code_ += "}";
+    code_ += "";
+  }
+
   // Set up the correct namespace. Only open a namespace if the existing one is
   // different (closing/opening only what is necessary).
   //
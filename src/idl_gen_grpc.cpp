@@ -289,6 +289,8 @@ bool GenerateCppGRPC(const Parser &parser, const std::string &path,
   grpc_cpp_generator::Parameters generator_parameters;
   // TODO(wvo): make the other parameters in this struct configurable.
   generator_parameters.use_system_headers = true;
+  generator_parameters.generate_frame_readers = true;
+  generator_parameters.generate_arena_methods = true;
 
   FlatBufFile fbfile(parser, file_name, FlatBufFile::kLanguageCpp);
 
@@ -19,13 +19,11 @@
 #include "flatbuffers/flatbuffers.h"
 #include "flatbuffers/flexbuffers.h"
 #include "flatbuffers/idl.h"
+#include "flatbuffers/json.h"
 #include "flatbuffers/util.h"
 
 namespace flatbuffers {
 
-static bool GenStruct(const StructDef &struct_def, const Table *table,
-                      int indent, const IDLOptions &opts, std::string *_text);
-
 // If indentation is less than 0, that indicates we don't want any newlines
 // either.
 const char *NewLine(const IDLOptions &opts) {
@@ -43,13 +41,60 @@ void OutputIdentifier(const std::string &name, const IDLOptions &opts,
   if (opts.strict_json) text += "\"";
 }
 
+// Generates the text of one buffer. With a sink, passes the text on in
+// chunks as it goes, so it never has to be in memory all at once.
+class JsonPrinter {
+ public:
+  JsonPrinter(const IDLOptions &_opts, std::string *text, Sink *sink)
+      : opts(_opts), text_(*text), sink_(sink), sink_failed_(false) {}
+
+  bool GenStruct(const StructDef &struct_def, const Table *table, int indent);
+
+  // Writes the text so far to the sink.
+  bool Flush() {
+    if (sink_failed_) return false;
+    if (sink_ && !text_.empty()) {
+      sink_failed_ = !sink_->Write(
+          reinterpret_cast<const uint8_t *>(text_.data()), text_.size());
+      text_.clear();
+    }
+    return !sink_failed_;
+  }
+
+  static const size_t kChunkSize = 64 * 1024;
+
+  const IDLOptions &opts;
+
+ private:
+  JsonPrinter &operator=(const JsonPrinter &);
+
+  // Called between values, where the text can be cut.
+  bool MaybeFlush() {
+    return !sink_ || text_.size() < kChunkSize ? !sink_failed_ : Flush();
+  }
+
+  template<typename T>
+  bool Print(T val, Type type, int indent, Type *union_type);
+  template<typename T>
+  bool PrintVector(const Vector<T> &v, Type type, int indent);
+  template<typename T>
+  bool GenField(const FieldDef &fd, const Table *table, bool fixed,
+                int indent);
+  bool GenFieldOffset(const FieldDef &fd, const Table *table, bool fixed,
+                      int indent, Type *union_type);
+
+  std::string &text_;
+  Sink *sink_;
+  bool sink_failed_;
+};
+
 // Print (and its template specialization below for pointers) generate text
 // for a single FlatBuffer value into JSON format.
 // The general case for scalars:
 template<typename T>
-bool Print(T val, Type type, int /*indent*/, Type * /*union_type*/,
-           const IDLOptions &opts, std::string *_text) {
-  std::string &text = *_text;
+bool JsonPrinter::Print(T val, Type type, int /*indent*/,
+                        Type * /*union_type*/) {
+  std::string &text = text_;
   if (type.enum_def && opts.output_enum_identifiers) {
     auto enum_val = type.enum_def->ReverseLookup(static_cast<int64_t>(val));
     if (enum_val) {
@@ -63,7 +108,7 @@ bool Print(T val, Type type, int /*indent*/, Type * /*union_type*/,
   if (type.base_type == BASE_TYPE_BOOL) {
     text += val != 0 ? "true" : "false";
   } else {
-    text += NumToString(val);
+    AppendNumber(val, &text);
   }
 
   return true;
@@ -71,24 +116,24 @@ bool Print(T val, Type type, int /*indent*/, Type * /*union_type*/,
 
 // Print a vector a sequence of JSON values, comma separated, wrapped in "[]".
 template<typename T>
-bool PrintVector(const Vector<T> &v, Type type, int indent,
-                 const IDLOptions &opts, std::string *_text) {
-  std::string &text = *_text;
+bool JsonPrinter::PrintVector(const Vector<T> &v, Type type, int indent) {
+  std::string &text = text_;
   text += "[";
   text += NewLine(opts);
   for (uoffset_t i = 0; i < v.size(); i++) {
     if (i) {
       if (!opts.protobuf_ascii_alike) text += ",";
       text += NewLine(opts);
+      if (!MaybeFlush()) return false;
     }
     text.append(indent + Indent(opts), ' ');
     if (IsStruct(type)) {
       if (!Print(v.GetStructFromOffset(i * type.struct_def->bytesize), type,
-                 indent + Indent(opts), nullptr, opts, _text)) {
+                 indent + Indent(opts), nullptr)) {
         return false;
       }
     } else {
-      if (!Print(v[i], type, indent + Indent(opts), nullptr, opts, _text)) {
+      if (!Print(v[i], type, indent + Indent(opts), nullptr)) {
         return false;
       }
     }
@@ -101,25 +146,24 @@ bool PrintVector(const Vector<T> &v, Type type, int indent,
 
 // Specialization of Print above for pointer types.
 template<>
-bool Print<const void *>(const void *val, Type type, int indent,
-                         Type *union_type, const IDLOptions &opts,
-                         std::string *_text) {
+bool JsonPrinter::Print<const void *>(const void *val, Type type, int indent,
+                                      Type *union_type) {
   switch (type.base_type) {
     case BASE_TYPE_UNION:
       // If this assert hits, you have an corrupt buffer, a union type field
       // was not present or was out of range.
       assert(union_type);
-      return Print<const void *>(val, *union_type, indent, nullptr, opts,
-                                 _text);
+      return Print<const void *>(val, *union_type, indent, nullptr);
     case BASE_TYPE_STRUCT:
       if (!GenStruct(*type.struct_def, reinterpret_cast<const Table *>(val),
-                     indent, opts, _text)) {
+                     indent)) {
         return false;
       }
       break;
     case BASE_TYPE_STRING: {
       auto s = reinterpret_cast<const String *>(val);
-      if (!EscapeString(s->c_str(), s->Length(), _text, opts.allow_non_utf8)) {
+      if (!EscapeString(s->c_str(), s->Length(), &text_,
+                        opts.allow_non_utf8)) {
         return false;
       }
       break;
@@ -134,7 +178,7 @@ bool Print<const void *>(const void *val, Type type, int indent,
           case BASE_TYPE_ ## ENUM: \
             if (!PrintVector<CTYPE>( \
                   *reinterpret_cast<const Vector<CTYPE> *>(val), \
-                  type, indent, opts, _text)) { \
+                  type, indent)) { \
               return false; \
             } \
             break;
@@ -149,27 +193,21 @@ bool Print<const void *>(const void *val, Type type, int indent,
 }
 
 // Generate text for a scalar field.
-template<typename T> static bool GenField(const FieldDef &fd,
-                                          const Table *table, bool fixed,
-                                          const IDLOptions &opts,
-                                          int indent,
-                                          std::string *_text) {
+template<typename T>
+bool JsonPrinter::GenField(const FieldDef &fd, const Table *table, bool fixed,
+                           int indent) {
   return Print(fixed ?
     reinterpret_cast<const Struct *>(table)->GetField<T>(fd.value.offset) :
     table->GetField<T>(fd.value.offset,
     IsFloat(fd.value.type.base_type) ?
     static_cast<T>(strtod(fd.value.constant.c_str(), nullptr)) :
     static_cast<T>(StringToInt(fd.value.constant.c_str()))),
-    fd.value.type, indent, nullptr, opts, _text);
+    fd.value.type, indent, nullptr);
 }
 
-static bool GenStruct(const StructDef &struct_def, const Table *table,
-                      int indent, const IDLOptions &opts, std::string *_text);
-
 // Generate text for non-scalar field.
-static bool GenFieldOffset(const FieldDef &fd, const Table *table, bool fixed,
-                           int indent, Type *union_type, const IDLOptions &opts,
-                           std::string *_text) {
+bool JsonPrinter::GenFieldOffset(const FieldDef &fd, const Table *table,
+                                 bool fixed, int indent, Type *union_type) {
   const void *val = nullptr;
   if (fixed) {
     // The only non-scalar fields in structs are structs.
@@ -179,25 +217,25 @@ static bool GenFieldOffset(const FieldDef &fd, const Table *table, bool fixed,
   } else if (fd.flexbuffer) {
     auto vec = table->GetPointer<const Vector<uint8_t> *>(fd.value.offset);
     auto root = flexbuffers::GetRoot(vec->data(), vec->size());
-    root.ToString(true, opts.strict_json, *_text);
+    root.ToString(true, opts.strict_json, text_);
     return true;
   } else if (fd.nested_flatbuffer) {
     auto vec = table->GetPointer<const Vector<uint8_t> *>(fd.value.offset);
     auto root = GetRoot<Table>(vec->data());
-    return GenStruct(*fd.nested_flatbuffer, root, indent, opts, _text);
+    return GenStruct(*fd.nested_flatbuffer, root, indent);
   } else {
     val = IsStruct(fd.value.type)
               ? table->GetStruct<const void *>(fd.value.offset)
               : table->GetPointer<const void *>(fd.value.offset);
   }
-  return Print(val, fd.value.type, indent, union_type, opts, _text);
+  return Print(val, fd.value.type, indent, union_type);
 }
 
 // Generate text for a struct or table, values separated by commas, indented,
 // and bracketed by "{}"
-static bool GenStruct(const StructDef &struct_def, const Table *table,
-                      int indent, const IDLOptions &opts, std::string *_text) {
-  std::string &text = *_text;
+bool JsonPrinter::GenStruct(const StructDef &struct_def, const Table *table,
+                            int indent) {
+  std::string &text = text_;
   text += "{";
   int fieldout = 0;
   Type *union_type = nullptr;
@@ -210,10 +248,11 @@ static bool GenStruct(const StructDef &struct_def, const Table *table,
     if (is_present || output_anyway) {
       if (fieldout++) {
         if (!opts.protobuf_ascii_alike) text += ",";
+        if (!MaybeFlush()) return false;
       }
       text += NewLine(opts);
       text.append(indent + Indent(opts), ' ');
-      OutputIdentifier(fd.name, opts, _text);
+      OutputIdentifier(fd.name, opts, &text);
       if (!opts.protobuf_ascii_alike ||
           (fd.value.type.base_type != BASE_TYPE_STRUCT &&
            fd.value.type.base_type != BASE_TYPE_VECTOR))
@@ -225,7 +264,7 @@ static bool GenStruct(const StructDef &struct_def, const Table *table,
             CTYPE, JTYPE, GTYPE, NTYPE, PTYPE) \
             case BASE_TYPE_ ## ENUM: \
               if (!GenField<CTYPE>(fd, table, struct_def.fixed, \
-                                   opts, indent + Indent(opts), _text)) { \
+                                   indent + Indent(opts))) { \
                 return false; \
               } \
               break;
@@ -237,8 +276,8 @@ static bool GenStruct(const StructDef &struct_def, const Table *table,
           case BASE_TYPE_ ## ENUM:
           FLATBUFFERS_GEN_TYPES_POINTER(FLATBUFFERS_TD)
         #undef FLATBUFFERS_TD
-            if (!GenFieldOffset(fd, table, struct_def.fixed, indent + Indent(opts),
-                                union_type, opts, _text)) {
+            if (!GenFieldOffset(fd, table, struct_def.fixed,
+                                indent + Indent(opts), union_type)) {
               return false;
             }
             break;
@@ -257,21 +296,33 @@ static bool GenStruct(const StructDef &struct_def, const Table *table,
   return true;
 }
 
-// Generate a text representation of a flatbuffer in JSON format.
-bool GenerateText(const Parser &parser, const void *flatbuffer,
-                  std::string *_text) {
-  std::string &text = *_text;
+static bool GenerateRoot(const Parser &parser, const void *flatbuffer,
+                         JsonPrinter *printer, std::string *_text) {
   assert(parser.root_struct_def_);  // call SetRootType()
-  text.reserve(1024);               // Reduce amount of inevitable reallocs.
   auto root = parser.opts.size_prefixed ?
       GetSizePrefixedRoot<Table>(flatbuffer) : GetRoot<Table>(flatbuffer);
-  if (!GenStruct(*parser.root_struct_def_, root, 0, parser.opts, _text)) {
-    return false;
-  }
-  text += NewLine(parser.opts);
+  if (!printer->GenStruct(*parser.root_struct_def_, root, 0)) return false;
+  *_text += NewLine(parser.opts);
   return true;
 }
 
+// Generate a text representation of a flatbuffer in JSON format.
+bool GenerateText(const Parser &parser, const void *flatbuffer,
+                  std::string *_text) {
+  std::string &text = *_text;
+  text.reserve(1024);  // Reduce amount of inevitable reallocs.
+  JsonPrinter printer(parser.opts, _text, nullptr);
+  return GenerateRoot(parser, flatbuffer, &printer, _text);
+}
+
+bool GenerateTextTo(const Parser &parser, const void *flatbuffer,
+                    Sink &sink) {
+  std::string text;
+  text.reserve(JsonPrinter::kChunkSize + 1024);
+  JsonPrinter printer(parser.opts, &text, &sink);
+  return GenerateRoot(parser, flatbuffer, &printer, &text) && printer.Flush();
+}
+
 std::string TextFileName(const std::string &path,
                          const std::string &file_name) {
   return path + file_name + ".json";
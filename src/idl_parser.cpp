@@ -76,6 +76,79 @@ static bool ValidateUTF8(const std::string &str) {
   return true;
 }
 
+// clang-format off
+#if defined(FLATBUFFERS_SIMD_AVX2) || defined(FLATBUFFERS_SIMD_SSE2)
+  #define FLATBUFFERS_SIMD_SCAN
+
+static uint32_t EqualMask(__m128i chunk, char c) {
+  return static_cast<uint32_t>(
+      _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(c))));
+}
+
+static int CountBits(uint32_t mask) {
+  int n = 0;
+  for (; mask; mask &= mask - 1) n++;
+  return n;
+}
+#endif
+// clang-format on
+
+// Returns the first char from `p` on that isn't whitespace, adding the
+// newlines before it to `*newlines`. `end` is the terminating 0.
+static const char *SkipWhitespace(const char *p, const char *end,
+                                  int *newlines) {
+  // clang-format off
+  #ifdef FLATBUFFERS_SIMD_SCAN
+    for (; p + 16 <= end; p += 16) {
+      auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+      auto lines = EqualMask(chunk, '\n');
+      auto space = lines | EqualMask(chunk, ' ') | EqualMask(chunk, '\t') |
+                   EqualMask(chunk, '\r');
+      if (space != 0xFFFF) {
+        auto n = FirstSetBit(~space);
+        *newlines += CountBits(lines & ((1u << n) - 1));
+        return p + n;
+      }
+      *newlines += CountBits(lines);
+    }
+  #else
+    (void)end;
+  #endif
+  // clang-format on
+  for (;; p++) {
+    if (*p == '\n') {
+      (*newlines)++;
+    } else if (*p != ' ' && *p != '\t' && *p != '\r') {
+      return p;
+    }
+  }
+}
+
+// Returns the first char from `p` on that may end a string constant or needs
+// handling in it: a quote, backslash or control character. `end` is the
+// terminating 0.
+static const char *SkipStringChars(const char *p, const char *end) {
+  // clang-format off
+  #ifdef FLATBUFFERS_SIMD_SCAN
+    for (; p + 16 <= end; p += 16) {
+      auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+      // Bytes below ' ': their maximum with 0x1F is 0x1F itself.
+      auto control = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(
+          _mm_max_epu8(chunk, _mm_set1_epi8(0x1F)), _mm_set1_epi8(0x1F))));
+      auto special = control | EqualMask(chunk, '\"') |
+                     EqualMask(chunk, '\'') | EqualMask(chunk, '\\');
+      if (special) return p + FirstSetBit(special);
+    }
+  #else
+    (void)end;
+  #endif
+  // clang-format on
+  while (static_cast<unsigned char>(*p) >= ' ' && *p != '\"' && *p != '\'' &&
+         *p != '\\')
+    p++;
+  return p;
+}
+
 // Convert an underscore_based_indentifier in to camelCase.
 // Also uppercases the first character if first is true.
 std::string MakeCamel(const std::string &in, bool first) {
@@ -269,13 +342,22 @@ CheckedError Parser::Next() {
         cursor_--;
         token_ = kTokenEof;
         return NoError();
-      case ' ':
-      case '\r':
-      case '\t': break;
       case '\n':
         line_++;
         seen_newline = true;
+        // fall thru
+      case ' ':
+      case '\r':
+      case '\t': {
+        // Indentation and such come in runs, skip them in one go.
+        int newlines = 0;
+        cursor_ = SkipWhitespace(cursor_, source_end_, &newlines);
+        if (newlines) {
+          line_ += newlines;
+          seen_newline = true;
+        }
         break;
+      }
       case '{':
       case '}':
       case '(':
@@ -385,7 +467,10 @@ CheckedError Parser::Next() {
               return Error(
                   "illegal Unicode sequence (unpaired high surrogate)");
             }
-            attribute_ += *cursor_++;
+            // Copy all of them up to the next char that needs a closer look.
+            auto run_end = SkipStringChars(cursor_ + 1, source_end_);
+            attribute_.append(cursor_, run_end);
+            cursor_ = run_end;
           }
         }
         if (unicode_high_surrogate != -1) {
@@ -505,11 +590,189 @@ CheckedError Parser::ParseNamespacing(std::string *id, std::string *last) {
   return NoError();
 }
 
+Parser::Parser(const CompiledSchema &schema)
+    : current_namespace_(nullptr),
+      empty_namespace_(nullptr),
+      root_struct_def_(schema.parser().root_struct_def_),
+      file_identifier_(schema.parser().file_identifier_),
+      file_extension_(schema.parser().file_extension_),
+      opts(schema.parser().opts),
+      uses_flexbuffers_(schema.parser().uses_flexbuffers_),
+      uses_hash_indices_(schema.parser().uses_hash_indices_),
+      schema_(&schema.parser()),
+      source_(nullptr),
+      source_end_(nullptr),
+      anonymous_counter(0) {
+  empty_namespace_ = new Namespace();
+  namespaces_.push_back(empty_namespace_);
+  // Where the schema ended, for SetRootType().
+  current_namespace_ = schema.parser().current_namespace_;
+}
+
+// What ParseRecords() works on, shared by its tasks.
+struct CompiledSchema::Records {
+  struct Line {
+    const char *start;
+    const char *end;
+    size_t number;
+  };
+
+  const CompiledSchema *schema;
+  std::vector<Line> lines;  // The lines with a record.
+  // The lines of task i are lines[groups[i]] up to lines[groups[i + 1]].
+  std::vector<size_t> groups;
+  std::vector<std::string> errors;  // The first error of each task.
+  // Where the records go: one buffer each, or else a stream per task.
+  std::vector<DetachedBuffer> *buffers;
+  std::vector<std::vector<uint8_t>> streams;
+  size_t alignment;
+
+  static void ParseGroup(void *context, size_t group) {
+    auto &records = *static_cast<Records *>(context);
+    Parser parser(*records.schema);
+    parser.opts.size_prefixed = !records.buffers;
+    std::string text;
+    for (auto i = records.groups[group]; i < records.groups[group + 1]; i++) {
+      auto &line = records.lines[i];
+      // Parse() wants the record 0-terminated.
+      text.assign(line.start, line.end);
+      if (!parser.Parse(text.c_str())) {
+        records.errors[group] =
+            "record on line " + NumToString(line.number) + ": " + parser.error_;
+        return;
+      }
+      auto &builder = parser.builder_;
+      if (records.buffers) {
+        // A copy rather than Release(), so the builder keeps its memory for
+        // the next record, and the buffer is no bigger than it needs to be.
+        auto &allocator = DefaultAllocator::instance();
+        auto size = builder.GetSize();
+        auto buf = allocator.allocate(size);
+        memcpy(buf, builder.GetBufferPointer(), size);
+        (*records.buffers)[i] =
+            DetachedBuffer(&allocator, false, buf, size, buf, size);
+        continue;
+      }
+      auto &stream = records.streams[group];
+      auto start = stream.size();
+      auto size = (builder.GetSize() + records.alignment - 1) &
+                  ~(records.alignment - 1);
+      stream.resize(start + size);
+      memcpy(&stream[start], builder.GetBufferPointer(), builder.GetSize());
+      // The padding goes at the end of the record.
+      WriteScalar(&stream[start],
+                  static_cast<uoffset_t>(size - sizeof(uoffset_t)));
+    }
+  }
+};
+
+bool CompiledSchema::ParseRecords(const char *text, size_t len,
+                                  std::vector<DetachedBuffer> *buffers,
+                                  std::string *error,
+                                  ParallelExecutor *executor) const {
+  Records records;
+  records.buffers = buffers;
+  buffers->clear();
+  if (ParseRecords(text, len, &records, error, executor)) return true;
+  buffers->clear();
+  return false;
+}
+
+bool CompiledSchema::ParseRecordsToStream(const char *text, size_t len,
+                                          std::vector<uint8_t> *stream,
+                                          std::string *error,
+                                          ParallelExecutor *executor) const {
+  Records records;
+  records.buffers = nullptr;
+  records.alignment = StreamAlignment();
+  stream->clear();
+  if (!ParseRecords(text, len, &records, error, executor)) return false;
+  size_t size = 0;
+  for (auto it = records.streams.begin(); it != records.streams.end(); ++it) {
+    size += it->size();
+  }
+  stream->reserve(size);
+  for (auto it = records.streams.begin(); it != records.streams.end(); ++it) {
+    stream->insert(stream->end(), it->begin(), it->end());
+  }
+  return true;
+}
+
+bool CompiledSchema::ParseRecords(const char *text, size_t len,
+                                  Records *records, std::string *error,
+                                  ParallelExecutor *executor) const {
+  // Tasks get about this much text each: enough to be worth handing out,
+  // small enough for there to be plenty to go round.
+  const size_t kGroupSize = 64 * 1024;
+  records->schema = this;
+  records->groups.push_back(0);
+  auto end = text + len;
+  auto group_start = text;
+  size_t number = 1;
+  for (auto p = text; p < end; number++) {
+    auto line_end = static_cast<const char *>(
+        memchr(p, '\n', static_cast<size_t>(end - p)));
+    if (!line_end) line_end = end;
+    auto q = p;
+    while (q < line_end && isspace(static_cast<unsigned char>(*q))) q++;
+    if (q < line_end) {
+      Records::Line line = { p, line_end, number };
+      records->lines.push_back(line);
+    }
+    p = line_end < end ? line_end + 1 : end;
+    if (static_cast<size_t>(p - group_start) >= kGroupSize) {
+      records->groups.push_back(records->lines.size());
+      group_start = p;
+    }
+  }
+  if (records->groups.back() != records->lines.size())
+    records->groups.push_back(records->lines.size());
+  auto num_groups = records->groups.size() - 1;
+  records->errors.resize(num_groups);
+  if (records->buffers) {
+    records->buffers->resize(records->lines.size());
+  } else {
+    records->streams.resize(num_groups);
+  }
+  if (executor) {
+    executor->ParallelFor(num_groups, Records::ParseGroup, records);
+  } else {
+    for (size_t i = 0; i < num_groups; i++) Records::ParseGroup(records, i);
+  }
+  for (auto it = records->errors.begin(); it != records->errors.end(); ++it) {
+    if (!it->empty()) {
+      *error = *it;
+      return false;
+    }
+  }
+  error->clear();
+  return true;
+}
+
+// The largest alignment a buffer of this schema may need.
+size_t CompiledSchema::StreamAlignment() const {
+  size_t alignment = sizeof(uoffset_t);
+  auto &structs = parser_.structs_.vec;
+  for (auto it = structs.begin(); it != structs.end(); ++it) {
+    alignment = (std::max)(alignment, (*it)->minalign);
+    auto &fields = (*it)->fields.vec;
+    for (auto field_it = fields.begin(); field_it != fields.end();
+         ++field_it) {
+      auto &type = (*field_it)->value.type;
+      alignment = (std::max)(alignment, InlineAlignment(type));
+      if (type.base_type == BASE_TYPE_VECTOR)
+        alignment = (std::max)(alignment, InlineAlignment(type.VectorType()));
+    }
+  }
+  return alignment;
+}
+
 EnumDef *Parser::LookupEnum(const std::string &id) {
+  auto &enums = schema_ ? schema_->enums_ : enums_;
   // Search thru parent namespaces.
   for (int components = static_cast<int>(current_namespace_->components.size());
        components >= 0; components--) {
-    auto ed = enums_.Lookup(
+    auto ed = enums.Lookup(
         current_namespace_->GetFullyQualifiedName(id, components));
     if (ed) return ed;
   }
@@ -517,6 +780,8 @@ EnumDef *Parser::LookupEnum(const std::string &id) {
 }
 
 StructDef *Parser::LookupStruct(const std::string &id) const {
+  // A shared schema isn't changed, not even its use counts.
+  if (schema_) return schema_->structs_.Lookup(id);
   auto sd = structs_.Lookup(id);
   if (sd) sd->refcount++;
   return sd;
@@ -599,7 +864,7 @@ CheckedError Parser::ParseType(Type &type) {
 
 CheckedError Parser::AddField(StructDef &struct_def, const std::string &name,
                               const Type &type, FieldDef **dest) {
-  auto &field = *new FieldDef();
+  auto &field = *arena_.New<FieldDef>();
   field.value.offset =
       FieldIndexToOffset(static_cast<voffset_t>(struct_def.fields.vec.size()));
   field.name = name;
@@ -617,6 +882,8 @@ CheckedError Parser::AddField(StructDef &struct_def, const std::string &name,
   }
   if (struct_def.fields.Add(name, &field))
     return Error("field already exists: " + name);
+  // Rebuilt once all fields have been added, rather than after each one.
+  struct_def.field_slots.clear();
   *dest = &field;
   return NoError();
 }
@@ -729,7 +996,7 @@ CheckedError Parser::ParseField(StructDef &struct_def) {
     /// forcing cpp_ptr_type to 'naked' if unset
     auto cpp_ptr_type = field->attributes.Lookup("cpp_ptr_type");
     if (!cpp_ptr_type) {
-      auto val = new Value();
+      auto val = arena_.New<Value>();
       val->type = cpp_type->type;
       val->constant = "naked";
       field->attributes.Add("cpp_ptr_type", val);
@@ -789,6 +1056,46 @@ CheckedError Parser::ParseField(StructDef &struct_def) {
       return Error("flexbuffer attribute may only apply to a vector of ubyte");
   }
 
+  FieldDef *hash_index_field = nullptr;
+  if (field->attributes.Lookup("hashed")) {
+    if (type.base_type != BASE_TYPE_VECTOR ||
+        type.element != BASE_TYPE_STRUCT || type.struct_def->fixed)
+      return Error("hashed attribute may only apply to a vector of tables");
+    // Add a field for the hash index after the vector. Whether the tables
+    // have a key is checked once all types are known.
+    Type index_type(BASE_TYPE_VECTOR);
+    index_type.element = BASE_TYPE_UINT;
+    ECHECK(AddField(struct_def, name + HashIndexFieldSuffix(), index_type,
+                    &hash_index_field));
+    uses_hash_indices_ = true;
+  }
+
+  if (field->attributes.Lookup("columnar")) {
+    if (type.base_type != BASE_TYPE_VECTOR ||
+        type.element != BASE_TYPE_STRUCT || type.struct_def->fixed)
+      return Error("columnar attribute may only apply to a vector of tables");
+    if (type.struct_def->predecl || type.struct_def == &struct_def)
+      return Error("columnar table must be declared before it is used: " +
+                   type.struct_def->name);
+    // Store the vector as a table with a vector per field of the row table.
+    StructDef *columns;
+    ECHECK(LookupCreateColumns(*type.struct_def, &columns));
+    field->value.type = Type(BASE_TYPE_STRUCT, columns);
+  }
+
+  if (hash_index_field) {
+    // Like for union type fields, a manually assigned id is followed by one
+    // for the index (N + 1).
+    auto attr = field->attributes.Lookup("id");
+    if (attr) {
+      auto id = atoi(attr->constant.c_str());
+      auto val = arena_.New<Value>();
+      val->type = attr->type;
+      val->constant = NumToString(id + 1);
+      hash_index_field->attributes.Add("id", val);
+    }
+  }
+
   if (typefield) {
     if (!IsScalar(typefield->value.type.base_type)) {
       // this is a union vector field
@@ -799,7 +1106,7 @@ CheckedError Parser::ParseField(StructDef &struct_def) {
     auto attr = field->attributes.Lookup("id");
     if (attr) {
       auto id = atoi(attr->constant.c_str());
-      auto val = new Value();
+      auto val = arena_.New<Value>();
       val->type = attr->type;
       val->constant = NumToString(id - 1);
       typefield->attributes.Add("id", val);
@@ -810,10 +1117,56 @@ CheckedError Parser::ParseField(StructDef &struct_def) {
   return NoError();
 }
 
+CheckedError Parser::LookupCreateColumns(StructDef &row, StructDef **dest) {
+  auto name = row.name + "Columns";
+  auto qualified_name = row.defined_namespace->GetFullyQualifiedName(name);
+  auto existing = LookupStruct(qualified_name);
+  if (existing) {
+    if (existing->columnar_row != &row)
+      return Error("datatype already exists: " + qualified_name);
+    *dest = existing;
+    return NoError();
+  }
+  auto &columns = *arena_.New<StructDef>();
+  columns.name = name;
+  columns.file = file_being_parsed_;
+  columns.defined_namespace = row.defined_namespace;
+  columns.predecl = false;
+  columns.columnar_row = &row;
+  columns.doc_comment.push_back(" The fields of " + row.name +
+                                ", stored column by column.");
+  structs_.Add(qualified_name, &columns);
+  // Declare it right after the row table, before any table that uses it.
+  auto &vec = structs_.vec;
+  vec.pop_back();
+  vec.insert(std::find(vec.begin(), vec.end(), &row) + 1, &columns);
+  // The columns get the same ids as the fields of the row, so that
+  // evolving the row table evolves the columns table compatibly.
+  for (auto it = row.fields.vec.begin(); it != row.fields.vec.end(); ++it) {
+    auto &row_field = **it;
+    auto &row_type = row_field.value.type;
+    if (!IsScalar(row_type.base_type) && !IsStruct(row_type) &&
+        row_type.base_type != BASE_TYPE_STRING)
+      return Error("columnar tables may contain only scalar, string or "
+                   "struct fields: " + row_field.name);
+    Type column_type(BASE_TYPE_VECTOR, row_type.struct_def, row_type.enum_def);
+    column_type.element = row_type.base_type;
+    FieldDef *column;
+    ECHECK(AddField(columns, row_field.name, column_type, &column));
+    column->value.offset = row_field.value.offset;
+    column->doc_comment = row_field.doc_comment;
+    column->deprecated = row_field.deprecated;
+  }
+  types_.Add(qualified_name,
+             arena_.New<Type>(BASE_TYPE_STRUCT, &columns, nullptr));
+  *dest = &columns;
+  return NoError();
+}
+
 CheckedError Parser::ParseString(Value &val) {
-  auto s = attribute_;
-  EXPECT(kTokenStringConstant);
-  val.constant = NumToString(builder_.CreateString(s).o);
+  if (!Is(kTokenStringConstant)) return Expect(kTokenStringConstant);
+  val.constant = NumToString(builder_.CreateString(attribute_).o);
+  NEXT();
   return NoError();
 }
 
@@ -845,7 +1198,8 @@ CheckedError Parser::ParseAnyValue(Value &val, FieldDef *field,
         // value. So we scan past the value to find it, then come back here.
         auto type_name = field->name + UnionTypeFieldSuffix();
         assert(parent_struct_def);
-        auto type_field = parent_struct_def->fields.Lookup(type_name);
+        auto type_field = parent_struct_def->LookupField(type_name.c_str(),
+                                                         type_name.length());
         assert(type_field);  // Guaranteed by ParseField().
         // Remember where we are in the source file, so we can come back here.
         auto backup = *static_cast<ParserState *>(this);
@@ -939,21 +1293,23 @@ CheckedError Parser::ParseTableDelimiters(size_t &fieldn,
   } else {
     EXPECT('{');
   }
+  // Reused for every field, trading buffers with attribute_ rather than
+  // copying it.
+  std::string name;
   for (;;) {
     if ((!opts.strict_json || !fieldn) && Is(terminator)) break;
-    std::string name;
     if (is_nested_vector) {
       if (fieldn > struct_def->fields.vec.size()) {
         return Error("too many unnamed fields in nested array");
       }
       name = struct_def->fields.vec[fieldn]->name;
     } else {
-      name = attribute_;
-      if (Is(kTokenStringConstant)) {
-        NEXT();
-      } else {
+      // Only take the name once it is known to be one, so errors report it.
+      if (!Is(kTokenStringConstant) &&
+          (opts.strict_json || !Is(kTokenIdentifier)))
         EXPECT(opts.strict_json ? kTokenStringConstant : kTokenIdentifier);
-      }
+      name.swap(attribute_);
+      NEXT();
       if (!opts.protobuf_ascii_alike || !(Is('{') || Is('['))) EXPECT(':');
     }
     ECHECK(body(name, fieldn, struct_def, state));
@@ -979,7 +1335,8 @@ CheckedError Parser::ParseTable(const StructDef &struct_def, std::string *value,
           ECHECK(parser->Expect(kTokenStringConstant));
           return NoError();
         }
-        auto field = struct_def_inner->fields.Lookup(name);
+        auto field =
+            struct_def_inner->LookupField(name.c_str(), name.length());
         if (!field) {
           if (!parser->opts.skip_unexpected_fields_in_json) {
             return parser->Error("unknown field: " + name);
@@ -1051,6 +1408,8 @@ CheckedError Parser::ParseTable(const StructDef &struct_def, std::string *value,
   if (struct_def.fixed && fieldn_outer != struct_def.fields.vec.size())
     return Error("struct: wrong number of initializers: " + struct_def.name);
 
+  if (!struct_def.fixed) ECHECK(AddHashIndices(struct_def, fieldn_outer));
+
   auto start = struct_def.fixed ? builder_.StartStruct(struct_def.minalign)
                                 : builder_.StartTable();
 
@@ -1122,6 +1481,73 @@ CheckedError Parser::ParseTable(const StructDef &struct_def, std::string *value,
   return NoError();
 }
 
+// Serializes the hash index of every hashed vector among the `fieldn` fields
+// of a table on top of field_stack_ that doesn't come with one, so that
+// lookups work on buffers made from JSON too.
+CheckedError Parser::AddHashIndices(const StructDef &struct_def,
+                                    size_t &fieldn) {
+  for (auto field_it = struct_def.fields.vec.begin();
+       field_it != struct_def.fields.vec.end(); ++field_it) {
+    auto field = *field_it;
+    if (!field->attributes.Lookup("hashed")) continue;
+    auto index_field =
+        struct_def.fields.Lookup(field->name + HashIndexFieldSuffix());
+    const Value *vec_value = nullptr;
+    bool has_index = false;
+    for (auto it = field_stack_.end() - fieldn; it != field_stack_.end();
+         ++it) {
+      if (it->second == field) vec_value = &it->first;
+      if (it->second == index_field) has_index = true;
+    }
+    if (!vec_value || has_index) continue;
+    uoffset_t off;
+    ECHECK(atot(vec_value->constant.c_str(), *this, &off));
+    auto vec = reinterpret_cast<const Vector<Offset<Table>> *>(
+        builder_.GetCurrentBufferPointer() + builder_.GetSize() - off);
+    auto elem_def = field->value.type.struct_def;
+    const FieldDef *key = nullptr;
+    for (auto key_it = elem_def->fields.vec.begin();
+         key_it != elem_def->fields.vec.end(); ++key_it) {
+      if ((*key_it)->key) key = *key_it;
+    }
+    std::vector<uint32_t> hashes(vec->size());
+    for (uoffset_t i = 0; i < vec->size(); i++) {
+      auto table = vec->Get(i);
+      switch (key->value.type.base_type) {
+        case BASE_TYPE_STRING: {
+          auto str = table->GetPointer<const String *>(key->value.offset);
+          hashes[i] = HashKey(str ? str->c_str() : "");
+          break;
+        }
+        // clang-format off
+        #define FLATBUFFERS_TD(ENUM, IDLTYPE, \
+          CTYPE, JTYPE, GTYPE, NTYPE, PTYPE) \
+          case BASE_TYPE_ ## ENUM: { \
+            CTYPE def; \
+            ECHECK(atot(key->value.constant.c_str(), *this, &def)); \
+            hashes[i] = HashKey(table->GetField<CTYPE>(key->value.offset, \
+                                                       def)); \
+            break; \
+          }
+          FLATBUFFERS_GEN_TYPES_SCALAR(FLATBUFFERS_TD);
+        #undef FLATBUFFERS_TD
+        // clang-format on
+        default: assert(false);
+      }
+    }
+    Value index_value = index_field->value;
+    index_value.constant = NumToString(CreateHashIndex(builder_, hashes).o);
+    // Keep the fields sorted by offset, as ParseTable() does.
+    auto elem = field_stack_.rbegin();
+    while (elem != field_stack_.rbegin() + fieldn &&
+           elem->second->value.offset > index_field->value.offset)
+      ++elem;
+    field_stack_.insert(elem.base(), std::make_pair(index_value, index_field));
+    fieldn++;
+  }
+  return NoError();
+}
+
 CheckedError Parser::ParseVectorDelimiters(size_t &count,
                                            ParseVectorDelimitersBody body,
                                            void *state) {
@@ -1198,6 +1624,7 @@ CheckedError Parser::ParseNestedFlatbuffer(Value &val, FieldDef *field,
     Parser nested_parser;
     assert(field->nested_flatbuffer);
     nested_parser.root_struct_def_ = field->nested_flatbuffer;
+    nested_parser.schema_ = schema_;
     nested_parser.enums_ = enums_;
     nested_parser.opts = opts;
     nested_parser.uses_flexbuffers_ = uses_flexbuffers_;
@@ -1209,11 +1636,6 @@ CheckedError Parser::ParseNestedFlatbuffer(Value &val, FieldDef *field,
     auto off = builder_.CreateVector(nested_parser.builder_.GetBufferPointer(),
                                      nested_parser.builder_.GetSize());
     val.constant = NumToString(off.o);
-
-    // Clean nested_parser before destruction to avoid deleting the elements in
-    // the SymbolTables
-    nested_parser.enums_.dict.clear();
-    nested_parser.enums_.vec.clear();
   }
   return NoError();
 }
@@ -1227,7 +1649,7 @@ CheckedError Parser::ParseMetaData(SymbolTable<Value> *attributes) {
       if (known_attributes_.find(name) == known_attributes_.end())
         return Error("user define attributes must be declared before use: " +
                      name);
-      auto e = new Value();
+      auto e = arena_.New<Value>();
       attributes->Add(name, e);
       if (Is(':')) {
         NEXT();
@@ -1456,7 +1878,7 @@ StructDef *Parser::LookupCreateStruct(const std::string &name,
     }
   }
   if (!struct_def && create_if_new) {
-    struct_def = new StructDef();
+    struct_def = arena_.New<StructDef>();
     if (definition) {
       structs_.Add(qualified_name, struct_def);
       struct_def->name = name;
@@ -1504,7 +1926,7 @@ CheckedError Parser::ParseEnum(bool is_union, EnumDef **dest) {
   }
   ECHECK(ParseMetaData(&enum_def->attributes));
   EXPECT('{');
-  if (is_union) enum_def->vals.Add("NONE", new EnumVal("NONE", 0));
+  if (is_union) enum_def->vals.Add("NONE", arena_.New<EnumVal>("NONE", 0));
   for (;;) {
     if (opts.proto_mode && attribute_ == "option") {
       ECHECK(ParseProtoOption());
@@ -1526,7 +1948,7 @@ CheckedError Parser::ParseEnum(bool is_union, EnumDef **dest) {
       auto value = !enum_def->vals.vec.empty()
           ? enum_def->vals.vec.back()->value + 1
           : 0;
-      auto &ev = *new EnumVal(value_name, value);
+      auto &ev = *arena_.New<EnumVal>(value_name, value);
       if (enum_def->vals.Add(value_name, &ev))
         return Error("enum value already exists: " + value_name);
       ev.doc_comment = value_comment;
@@ -1577,7 +1999,7 @@ CheckedError Parser::ParseEnum(bool is_union, EnumDef **dest) {
   }
   if (dest) *dest = enum_def;
   types_.Add(current_namespace_->GetFullyQualifiedName(enum_def->name),
-             new Type(BASE_TYPE_UNION, nullptr, enum_def));
+             arena_.New<Type>(BASE_TYPE_UNION, nullptr, enum_def));
   return NoError();
 }
 
@@ -1700,9 +2122,10 @@ CheckedError Parser::ParseDecl() {
   ECHECK(CheckClash(fields, struct_def, "Length", BASE_TYPE_VECTOR));
   ECHECK(CheckClash(fields, struct_def, "_byte_vector", BASE_TYPE_STRING));
   ECHECK(CheckClash(fields, struct_def, "ByteVector", BASE_TYPE_STRING));
+  struct_def->IndexFields();
   EXPECT('}');
   types_.Add(current_namespace_->GetFullyQualifiedName(struct_def->name),
-             new Type(BASE_TYPE_STRUCT, struct_def, nullptr));
+             arena_.New<Type>(BASE_TYPE_STRUCT, struct_def, nullptr));
   return NoError();
 }
 
@@ -1711,7 +2134,7 @@ CheckedError Parser::ParseService() {
   NEXT();
   auto service_name = attribute_;
   EXPECT(kTokenIdentifier);
-  auto &service_def = *new ServiceDef();
+  auto &service_def = *arena_.New<ServiceDef>();
   service_def.name = service_name;
   service_def.file = file_being_parsed_;
   service_def.doc_comment = service_comment;
@@ -1734,7 +2157,7 @@ CheckedError Parser::ParseService() {
     if (reqtype.base_type != BASE_TYPE_STRUCT || reqtype.struct_def->fixed ||
         resptype.base_type != BASE_TYPE_STRUCT || resptype.struct_def->fixed)
       return Error("rpc request and response types must be tables");
-    auto &rpc = *new RPCCall();
+    auto &rpc = *arena_.New<RPCCall>();
     rpc.name = rpc_name;
     rpc.request = reqtype.struct_def;
     rpc.response = resptype.struct_def;
@@ -1869,7 +2292,7 @@ CheckedError Parser::ParseProtoDecl() {
 
 CheckedError Parser::StartEnum(const std::string &enum_name, bool is_union,
                                EnumDef **dest) {
-  auto &enum_def = *new EnumDef();
+  auto &enum_def = *arena_.New<EnumDef>();
   enum_def.name = enum_name;
   enum_def.file = file_being_parsed_;
   enum_def.doc_comment = doc_comment_;
@@ -2017,8 +2440,8 @@ CheckedError Parser::ParseProtoFields(StructDef *struct_def, bool isextend,
             return Error("oneof '" + name +
                 "' cannot be mapped to a union because member '" +
                 oneof_field.name + "' is not a table type.");
-          auto enum_val = new EnumVal(oneof_type.struct_def->name,
-                                      oneof_union->vals.vec.size());
+          auto enum_val = arena_.New<EnumVal>(oneof_type.struct_def->name,
+                                              oneof_union->vals.vec.size());
           enum_val->union_type = oneof_type;
           enum_val->doc_comment = oneof_field.doc_comment;
           oneof_union->vals.Add(oneof_field.name, enum_val);
@@ -2234,6 +2657,7 @@ CheckedError Parser::StartParseFile(const char *source,
                                     const char *source_filename) {
   file_being_parsed_ = source_filename ? source_filename : "";
   source_ = cursor_ = source;
+  source_end_ = source + strlen(source);
   line_ = 1;
   error_.clear();
   ECHECK(SkipByteOrderMark());
@@ -2289,9 +2713,9 @@ CheckedError Parser::ParseRoot(const char *source, const char **include_paths,
                          NumToString(initial_count) +
                          " use(s) of pre-declaration enum not accounted for: " +
                          enum_def->name);
-          structs_.dict.erase(structs_.dict.find(struct_def.name));
+          // It stays in the arena until the parser is destroyed.
+          structs_.Remove(struct_def.name);
           it = structs_.vec.erase(it);
-          delete &struct_def;
           continue;  // Skip error.
         }
       }
@@ -2304,6 +2728,21 @@ CheckedError Parser::ParseRoot(const char *source, const char **include_paths,
     ++it;
   }
 
+  // Tables may be declared after the hashed vectors that hold them, so
+  // check for their keys once all are known. Also index the fields of those
+  // that were added to since they were last indexed (e.g. from .proto files).
+  for (auto it = structs_.vec.begin(); it != structs_.vec.end(); ++it) {
+    if ((*it)->field_slots.empty()) (*it)->IndexFields();
+    auto &fields = (*it)->fields.vec;
+    for (auto field_it = fields.begin(); field_it != fields.end(); ++field_it) {
+      auto &field = **field_it;
+      if (field.attributes.Lookup("hashed") &&
+          !field.value.type.struct_def->has_key)
+        return Error("hashed vector of a table without a key field: " +
+                     field.name);
+    }
+  }
+
   // This check has to happen here and not earlier, because only now do we
   // know for sure what the type of these are.
   for (auto it = enums_.vec.begin(); it != enums_.vec.end(); ++it) {
@@ -2341,6 +2780,8 @@ CheckedError Parser::DoParse(const char *source, const char **include_paths,
   current_namespace_ = empty_namespace_;
 
   ECHECK(StartParseFile(source, source_filename));
+  if (schema_ && !Is('{'))
+    return Error("only JSON can be parsed with a compiled schema");
 
   // Includes must come before type declarations:
   for (;;) {
@@ -2400,7 +2841,9 @@ CheckedError Parser::DoParse(const char *source, const char **include_paths,
   }
   // Now parse all other kinds of declarations:
   while (token_ != kTokenEof) {
-    if (opts.proto_mode) {
+    if (schema_ && token_ != '{') {
+      return Error("only JSON can be parsed with a compiled schema");
+    } else if (opts.proto_mode) {
       ECHECK(ParseProtoDecl());
     } else if (IsIdent("namespace")) {
       ECHECK(ParseNamespace());
@@ -2534,6 +2977,326 @@ void Parser::Serialize() {
   }
 }
 
+bool Parser::Deserialize(const uint8_t *buf, size_t size) {
+  const size_t kMinSize =
+      sizeof(uoffset_t) + FlatBufferBuilder::kFileIdentifierLength;
+  if (size < kMinSize) return DeserializeError("truncated");
+  Verifier verifier(buf, size);
+  if (reflection::SchemaBufferHasIdentifier(buf)) {
+    if (!reflection::VerifySchemaBuffer(verifier))
+      return DeserializeError("invalid");
+    return Deserialize(reflection::GetSchema(buf));
+  }
+  if (size >= kMinSize + sizeof(uoffset_t) &&
+      BufferHasIdentifier(buf, reflection::SchemaIdentifier(), true)) {
+    if (!verifier.VerifySizePrefixedBuffer<reflection::Schema>(
+            reflection::SchemaIdentifier()))
+      return DeserializeError("invalid");
+    return Deserialize(GetSizePrefixedRoot<reflection::Schema>(buf));
+  }
+  return DeserializeError("no " + std::string(reflection::SchemaIdentifier()) +
+                          " file_identifier");
+}
+
+bool Parser::Deserialize(const reflection::Schema *schema) {
+  if (schema_)
+    return DeserializeError("only JSON can be parsed with a compiled schema");
+  auto &objects = *schema->objects();
+  auto &enums = *schema->enums();
+  // Create all definitions first, so types can refer to them by index.
+  auto first_struct = structs_.vec.size();
+  for (uoffset_t i = 0; i < objects.size(); i++) {
+    auto object = objects.Get(i);
+    auto &struct_def = *arena_.New<StructDef>();
+    struct_def.defined_namespace =
+        DeserializeName(object->name(), &struct_def.name);
+    struct_def.predecl = false;
+    struct_def.fixed = object->is_struct();
+    struct_def.minalign = static_cast<size_t>(object->minalign());
+    struct_def.bytesize = static_cast<size_t>(object->bytesize());
+    if (structs_.Add(object->name()->str(), &struct_def))
+      return DeserializeError("datatype already exists: " +
+                              object->name()->str());
+    types_.Add(object->name()->str(),
+               arena_.New<Type>(BASE_TYPE_STRUCT, &struct_def, nullptr));
+  }
+  auto first_enum = enums_.vec.size();
+  for (uoffset_t i = 0; i < enums.size(); i++) {
+    auto serialized = enums.Get(i);
+    auto &enum_def = *arena_.New<EnumDef>();
+    enum_def.defined_namespace =
+        DeserializeName(serialized->name(), &enum_def.name);
+    if (enums_.Add(serialized->name()->str(), &enum_def))
+      return DeserializeError("enum already exists: " +
+                              serialized->name()->str());
+    types_.Add(serialized->name()->str(),
+               arena_.New<Type>(BASE_TYPE_UNION, nullptr, &enum_def));
+  }
+  // Types refer to the definitions of this schema only.
+  deserialized_structs_.assign(structs_.vec.begin() + first_struct,
+                               structs_.vec.end());
+  deserialized_enums_.assign(enums_.vec.begin() + first_enum,
+                             enums_.vec.end());
+  auto ok = true;
+  for (uoffset_t i = 0; ok && i < objects.size(); i++) {
+    ok = DeserializeStruct(*objects.Get(i), deserialized_structs_[i]);
+    if (objects.Get(i) == schema->root_table()) {
+      root_struct_def_ = deserialized_structs_[i];
+      current_namespace_ = root_struct_def_->defined_namespace;
+    }
+  }
+  for (uoffset_t i = 0; ok && i < enums.size(); i++) {
+    ok = DeserializeEnum(*enums.Get(i), deserialized_enums_[i]);
+  }
+  deserialized_structs_.clear();
+  deserialized_enums_.clear();
+  if (!ok) return false;
+  if (schema->file_ident()) file_identifier_ = schema->file_ident()->str();
+  if (schema->file_ext()) file_extension_ = schema->file_ext()->str();
+  return true;
+}
+
+bool Parser::DeserializeError(const std::string &msg) {
+  error_ = "binary schema: " + msg;
+  return false;
+}
+
+Namespace *Parser::DeserializeName(const flatbuffers::String *qualified_name,
+                                   std::string *name) {
+  auto ns = new Namespace();
+  auto full = qualified_name->str();
+  size_t start = 0;
+  for (auto dot = full.find('.'); dot != std::string::npos;
+       dot = full.find('.', start)) {
+    ns->components.push_back(full.substr(start, dot - start));
+    start = dot + 1;
+  }
+  *name = full.substr(start);
+  return UniqueNamespace(ns);
+}
+
+bool Parser::DeserializeStruct(const reflection::Object &object,
+                               StructDef *struct_def) {
+  if (!DeserializeAttributes(object.attributes(), struct_def)) return false;
+  struct_def->sortbysize =
+      !struct_def->fixed && !struct_def->attributes.Lookup("original_order");
+  // The fields are sorted by name: put them back in the order of their ids.
+  auto &fields = *object.fields();
+  std::vector<const reflection::Field *> by_id(fields.size(), nullptr);
+  for (uoffset_t i = 0; i < fields.size(); i++) {
+    auto id = fields.Get(i)->id();
+    if (id >= by_id.size() || by_id[id])
+      return DeserializeError("field ids of " + object.name()->str() +
+                              " are not 0.." + NumToString(by_id.size() - 1));
+    by_id[id] = fields.Get(i);
+  }
+  for (size_t i = 0; i < by_id.size(); i++) {
+    auto &field_def = *arena_.New<FieldDef>();
+    if (!DeserializeField(*by_id[i], *struct_def, &field_def)) return false;
+    if (struct_def->fields.Add(field_def.name, &field_def))
+      return DeserializeError("field already exists: " + field_def.name);
+    if (field_def.key) struct_def->has_key = true;
+    if (struct_def->fixed) {
+      // The padding isn't serialized, it's what's between the fields.
+      auto end = field_def.value.offset + InlineSize(field_def.value.type);
+      auto next = i + 1 < by_id.size() ? by_id[i + 1]->offset()
+                                       : struct_def->bytesize;
+      if (next < end)
+        return DeserializeError("fields of struct " + object.name()->str() +
+                                " overlap");
+      field_def.padding = next - end;
+    }
+  }
+  struct_def->IndexFields();
+  if (object.documentation()) {
+    for (auto it = object.documentation()->begin();
+         it != object.documentation()->end(); ++it) {
+      struct_def->doc_comment.push_back(it->str());
+    }
+  }
+  return true;
+}
+
+bool Parser::DeserializeField(const reflection::Field &field,
+                              const StructDef &struct_def,
+                              FieldDef *field_def) {
+  field_def->name = field.name()->str();
+  field_def->defined_namespace = struct_def.defined_namespace;
+  if (!DeserializeType(field.type(), &field_def->value.type)) return false;
+  auto &type = field_def->value.type;
+  field_def->value.offset = field.offset();
+  if (IsInteger(type.base_type)) {
+    field_def->value.constant = NumToString(field.default_integer());
+  } else if (IsFloat(type.base_type)) {
+    field_def->value.constant = NumToString(field.default_real());
+  }
+  field_def->deprecated = field.deprecated();
+  field_def->required = field.required();
+  field_def->key = field.key();
+  if (!DeserializeAttributes(field.attributes(), field_def)) return false;
+  auto &attributes = field_def->attributes;
+  field_def->native_inline = attributes.Lookup("native_inline") != nullptr;
+  auto nested = attributes.Lookup("nested_flatbuffer");
+  if (nested) {
+    auto nested_def = LookupStruct(
+        struct_def.defined_namespace->GetFullyQualifiedName(nested->constant));
+    if (!nested_def) nested_def = LookupStruct(nested->constant);
+    if (!nested_def)
+      return DeserializeError("nested_flatbuffer type not found: " +
+                              nested->constant);
+    field_def->nested_flatbuffer = nested_def;
+  }
+  if (attributes.Lookup("flexbuffer")) {
+    field_def->flexbuffer = true;
+    uses_flexbuffers_ = true;
+  }
+  if (attributes.Lookup("hashed")) uses_hash_indices_ = true;
+  if (field.documentation()) {
+    for (auto it = field.documentation()->begin();
+         it != field.documentation()->end(); ++it) {
+      field_def->doc_comment.push_back(it->str());
+    }
+  }
+  return true;
+}
+
+bool Parser::DeserializeEnum(const reflection::Enum &serialized,
+                             EnumDef *enum_def) {
+  enum_def->is_union = serialized.is_union();
+  if (!DeserializeType(serialized.underlying_type(),
+                       &enum_def->underlying_type) ||
+      !DeserializeAttributes(serialized.attributes(), enum_def))
+    return false;
+  auto &values = *serialized.values();
+  for (uoffset_t i = 0; i < values.size(); i++) {
+    auto value = values.Get(i);
+    auto &enum_val =
+        *arena_.New<EnumVal>(value->name()->str(), value->value());
+    if (!DeserializeType(value->union_type(), &enum_val.union_type))
+      return false;
+    if (enum_def->is_union && enum_val.union_type.struct_def) {
+      auto &vals = enum_def->vals.vec;
+      for (auto it = vals.begin(); it != vals.end(); ++it) {
+        if ((*it)->union_type.struct_def == enum_val.union_type.struct_def)
+          enum_def->uses_type_aliases = true;
+      }
+    }
+    if (enum_def->vals.Add(enum_val.name, &enum_val))
+      return DeserializeError("enum value already exists: " + enum_val.name);
+  }
+  if (serialized.documentation()) {
+    for (auto it = serialized.documentation()->begin();
+         it != serialized.documentation()->end(); ++it) {
+      enum_def->doc_comment.push_back(it->str());
+    }
+  }
+  return true;
+}
+
+bool Parser::DeserializeType(const reflection::Type *type, Type *dest) {
+  if (!type) return true;  // Only EnumVal::union_type is optional.
+  if (type->base_type() > reflection::Union ||
+      type->element() > reflection::Union)
+    return DeserializeError("unknown type");
+  dest->base_type = static_cast<BaseType>(type->base_type());
+  dest->element = static_cast<BaseType>(type->element());
+  if (type->index() < 0) {
+    if (dest->base_type == BASE_TYPE_STRUCT ||
+        dest->base_type == BASE_TYPE_UNION ||
+        (dest->base_type == BASE_TYPE_VECTOR &&
+         (dest->element == BASE_TYPE_STRUCT ||
+          dest->element == BASE_TYPE_UNION)))
+      return DeserializeError("type without a definition");
+    return true;
+  }
+  auto index = static_cast<size_t>(type->index());
+  if (dest->base_type == BASE_TYPE_STRUCT ||
+      (dest->base_type == BASE_TYPE_VECTOR &&
+       dest->element == BASE_TYPE_STRUCT)) {
+    if (index >= deserialized_structs_.size())
+      return DeserializeError("type index out of range");
+    dest->struct_def = deserialized_structs_[index];
+  } else {
+    if (index >= deserialized_enums_.size())
+      return DeserializeError("type index out of range");
+    dest->enum_def = deserialized_enums_[index];
+  }
+  return true;
+}
+
+bool Parser::DeserializeAttributes(
+    const Vector<Offset<reflection::KeyValue>> *attributes, Definition *def) {
+  if (!attributes) return true;
+  for (uoffset_t i = 0; i < attributes->size(); i++) {
+    auto kv = attributes->Get(i);
+    auto &value = *arena_.New<Value>();
+    value.constant = kv->value() ? kv->value()->str() : "";
+    if (def->attributes.Add(kv->key()->str(), &value))
+      return DeserializeError("attribute already exists: " + kv->key()->str());
+    // Custom attributes count as declared, the builtin ones stay builtin.
+    known_attributes_.insert(std::make_pair(kv->key()->str(), false));
+  }
+  return true;
+}
+
+void StructDef::IndexFields() {
+  // Only the first field of a name, like fields.Lookup().
+  std::vector<FieldDef *> unique;
+  for (auto it = fields.vec.begin(); it != fields.vec.end(); ++it) {
+    if (fields.Lookup((*it)->name) == *it) unique.push_back(*it);
+  }
+  size_t num_slots = 1;
+  while (num_slots < 2 * unique.size()) num_slots *= 2;
+  // Every doubling makes collisions less likely: only names with the same
+  // 64 bit hash never stop colliding, then fields.Lookup() has to do.
+  for (; num_slots <= 64 * (unique.size() + 1); num_slots *= 2) {
+    auto num_buckets = (std::max)(num_slots / 4, static_cast<size_t>(1));
+    field_slots.assign(num_slots, nullptr);
+    field_seeds.assign(num_buckets, 0);
+    std::vector<std::vector<FieldDef *>> buckets(num_buckets);
+    for (auto it = unique.begin(); it != unique.end(); ++it) {
+      auto hash = HashName((*it)->name.c_str(), (*it)->name.length());
+      buckets[(hash >> 48) & (num_buckets - 1)].push_back(*it);
+    }
+    // Place the biggest buckets first, while most slots are free.
+    std::vector<size_t> order;
+    for (size_t i = 0; i < num_buckets; i++) order.push_back(i);
+    std::stable_sort(order.begin(), order.end(),
+                     [&buckets](size_t a, size_t b) {
+                       return buckets[a].size() > buckets[b].size();
+                     });
+    auto placed_all = true;
+    for (auto it = order.begin(); placed_all && it != order.end(); ++it) {
+      auto &bucket = buckets[*it];
+      placed_all = false;
+      for (uint32_t seed = 0; !placed_all && seed < 1024; seed++) {
+        size_t i = 0;
+        for (; i < bucket.size(); i++) {
+          auto &field_name = bucket[i]->name;
+          auto &slot = field_slots[FieldSlot(
+              HashName(field_name.c_str(), field_name.length()), seed)];
+          if (slot) break;
+          slot = bucket[i];
+        }
+        placed_all = i == bucket.size();
+        if (placed_all) {
+          field_seeds[*it] = seed;
+        } else {
+          while (i--) {
+            auto &field_name = bucket[i]->name;
+            field_slots[FieldSlot(
+                HashName(field_name.c_str(), field_name.length()),
+                seed)] = nullptr;
+          }
+        }
+      }
+    }
+    if (placed_all) return;
+  }
+  field_slots.clear();
+  field_seeds.clear();
+}
+
 Offset<reflection::Object> StructDef::Serialize(FlatBufferBuilder *builder,
                                                 const Parser &parser) const {
   std::vector<Offset<reflection::Field>> field_offsets;
@@ -2604,15 +3367,21 @@ flatbuffers::Offset<
     flatbuffers::Vector<flatbuffers::Offset<reflection::KeyValue>>>
 Definition::SerializeAttributes(FlatBufferBuilder *builder,
                                 const Parser &parser) const {
-  std::vector<flatbuffers::Offset<reflection::KeyValue>> attrs;
-  for (auto kv = attributes.dict.begin(); kv != attributes.dict.end(); ++kv) {
-    auto it = parser.known_attributes_.find(kv->first);
+  // Custom attributes (and builtin ones if asked for), in the order of their
+  // names so the strings are laid out the same way every time.
+  std::vector<std::pair<std::string, const Value *>> custom;
+  attributes.ForEach([&](const std::string &key, const Value *value) {
+    auto it = parser.known_attributes_.find(key);
     assert(it != parser.known_attributes_.end());
-    if (!it->second) {  // Custom attribute.
-      attrs.push_back(reflection::CreateKeyValue(
-          *builder, builder->CreateString(kv->first),
-          builder->CreateString(kv->second->constant)));
-    }
+    if (!it->second || parser.opts.binary_schema_builtins)
+      custom.push_back(std::make_pair(key, value));
+  });
+  std::sort(custom.begin(), custom.end());
+  std::vector<flatbuffers::Offset<reflection::KeyValue>> attrs;
+  for (auto kv = custom.begin(); kv != custom.end(); ++kv) {
+    attrs.push_back(reflection::CreateKeyValue(
+        *builder, builder->CreateString(kv->first),
+        builder->CreateString(kv->second->constant)));
   }
   if (attrs.size()) {
     return builder->CreateVectorOfSortedTables(&attrs);
@@ -2622,6 +3391,13 @@ Definition::SerializeAttributes(FlatBufferBuilder *builder,
 }
 
 std::string Parser::ConformTo(const Parser &base) {
+  std::vector<std::string> errors;
+  return ConformTo(base, &errors) ? "" : errors.front();
+}
+
+bool Parser::ConformTo(const Parser &base,
+                       std::vector<std::string> *errors) const {
+  auto num_errors = errors->size();
   for (auto sit = structs_.vec.begin(); sit != structs_.vec.end(); ++sit) {
     auto &struct_def = **sit;
     auto qualified_name =
@@ -2631,14 +3407,15 @@ std::string Parser::ConformTo(const Parser &base) {
     for (auto fit = struct_def.fields.vec.begin();
          fit != struct_def.fields.vec.end(); ++fit) {
       auto &field = **fit;
+      auto field_name = qualified_name + "." + field.name;
       auto field_base = struct_def_base->fields.Lookup(field.name);
       if (field_base) {
         if (field.value.offset != field_base->value.offset)
-          return "offsets differ for field: " + field.name;
+          errors->push_back("offsets differ for field: " + field_name);
         if (field.value.constant != field_base->value.constant)
-          return "defaults differ for field: " + field.name;
+          errors->push_back("defaults differ for field: " + field_name);
         if (!EqualByName(field.value.type, field_base->value.type))
-          return "types differ for field: " + field.name;
+          errors->push_back("types differ for field: " + field_name);
       } else {
         // Doesn't have to exist, deleting fields is fine.
         // But we should check if there is a field that has the same offset
@@ -2648,7 +3425,8 @@ std::string Parser::ConformTo(const Parser &base) {
           field_base = *fbit;
           if (field.value.offset == field_base->value.offset) {
             if (!EqualByName(field.value.type, field_base->value.type))
-              return "field renamed to different type: " + field.name;
+              errors->push_back("field renamed to different type: " +
+                                field_name);
             break;
           }
         }
@@ -2667,11 +3445,12 @@ std::string Parser::ConformTo(const Parser &base) {
       auto enum_val_base = enum_def_base->vals.Lookup(enum_val.name);
       if (enum_val_base) {
         if (enum_val.value != enum_val_base->value)
-          return "values differ for enum: " + enum_val.name;
+          errors->push_back("values differ for enum: " + qualified_name + "." +
+                            enum_val.name);
       }
     }
   }
-  return "";
+  return errors->size() == num_errors;
 }
 
 }  // namespace flatbuffers
@@ -112,6 +112,78 @@ std::string GetAnyValueS(reflection::BaseType type, const uint8_t *data,
   }
 }
 
+bool FieldAccessor::Resolve(const reflection::Schema &schema,
+                            const reflection::Object &object,
+                            const char *path) {
+  schema_ = &schema;
+  field_ = nullptr;
+  steps_.clear();
+  auto objectdef = &object;
+  auto in_struct = false;
+  for (;;) {
+    auto end = strchr(path, '.');
+    auto name = end ? std::string(path, end) : std::string(path);
+    auto fielddef = objectdef->fields()->LookupByKey(name.c_str());
+    if (!fielddef) {
+      steps_.clear();
+      return false;
+    }
+    Step step;
+    step.offset = fielddef->offset();
+    step.in_struct = in_struct;
+    if (!end) {
+      steps_.push_back(step);
+      field_ = fielddef;
+      break;
+    }
+    if (fielddef->type()->base_type() != reflection::Obj) {
+      steps_.clear();
+      return false;
+    }
+    objectdef = schema.objects()->Get(fielddef->type()->index());
+    in_struct = objectdef->is_struct();
+    steps_.push_back(step);
+    path = end + 1;
+  }
+  auto type = field_->type()->base_type();
+  // clang-format off
+  #define FLATBUFFERS_READ(T) get_i_ = ReadI<T>; get_f_ = ReadF<T>; break
+  switch (type) {
+    case reflection::UType:
+    case reflection::Bool:
+    case reflection::UByte:  FLATBUFFERS_READ(uint8_t);
+    case reflection::Byte:   FLATBUFFERS_READ(int8_t);
+    case reflection::Short:  FLATBUFFERS_READ(int16_t);
+    case reflection::UShort: FLATBUFFERS_READ(uint16_t);
+    case reflection::Int:    FLATBUFFERS_READ(int32_t);
+    case reflection::UInt:   FLATBUFFERS_READ(uint32_t);
+    case reflection::Long:   FLATBUFFERS_READ(int64_t);
+    case reflection::ULong:  FLATBUFFERS_READ(uint64_t);
+    case reflection::Float:  FLATBUFFERS_READ(float);
+    case reflection::Double: FLATBUFFERS_READ(double);
+    default: get_i_ = nullptr; get_f_ = nullptr; break;
+  }
+  #undef FLATBUFFERS_READ
+  // clang-format on
+  if (IsFloat(type)) {
+    default_f_ = field_->default_real();
+    default_i_ = static_cast<int64_t>(default_f_);
+  } else {
+    default_i_ = field_->default_integer();
+    default_f_ = static_cast<double>(default_i_);
+  }
+  return true;
+}
+
+std::string FieldAccessor::GetS(const Table &table) const {
+  auto type = field_->type()->base_type();
+  auto p = Locate(table);
+  if (p) return GetAnyValueS(type, p, schema_, field_->type()->index());
+  if (IsFloat(type)) return NumToString(default_f_);
+  if (IsScalar(type)) return NumToString(default_i_);
+  return "";
+}
+
 void SetAnyValueI(reflection::BaseType type, uint8_t *data, int64_t val) {
   // clang-format off
   #define FLATBUFFERS_SET(T) WriteScalar(data, static_cast<T>(val))
@@ -155,190 +227,273 @@ void SetAnyValueS(reflection::BaseType type, uint8_t *data, const char *val) {
   }
 }
 
-// Resize a FlatBuffer in-place by iterating through all offsets in the buffer
-// and adjusting them by "delta" if they straddle the start offset.
-// Once that is done, bytes can now be inserted/deleted safely.
-// "delta" may be negative (shrinking).
-// Unless "delta" is a multiple of the largest alignment, you'll create a small
+// Resizing a FlatBuffer in-place works by iterating through all offsets in
+// the buffer, and adjusting each by how much further apart the two ends get
+// because of the bytes inserted or deleted between them. Once that is done,
+// bytes can be inserted/deleted safely.
+// Unless a delta is a multiple of the largest alignment, you'll create a small
 // amount of garbage space in the buffer (usually 0..7 bytes).
-// If your FlatBuffer's root table is not the schema's root table, you should
-// pass in your root_table type as well.
-class ResizeContext {
- public:
-  ResizeContext(const reflection::Schema &schema, uoffset_t start, int delta,
-                std::vector<uint8_t> *flatbuf,
-                const reflection::Object *root_table = nullptr)
-      : schema_(schema),
-        startptr_(vector_data(*flatbuf) + start),
-        delta_(delta),
-        buf_(*flatbuf),
-        dag_check_(flatbuf->size() / sizeof(uoffset_t), false) {
-    auto mask = static_cast<int>(sizeof(largest_scalar_t) - 1);
-    delta_ = (delta_ + mask) & ~mask;
-    if (!delta_) return;  // We can't shrink by less than largest_scalar_t.
-    // Now change all the offsets by delta_.
-    auto root = GetAnyRoot(vector_data(buf_));
-    Straddle<uoffset_t, 1>(vector_data(buf_), root, vector_data(buf_));
-    ResizeTable(root_table ? *root_table : *schema.root_table(), root);
-    // We can now add or remove bytes at start.
-    if (delta_ > 0)
-      buf_.insert(buf_.begin() + start, delta_, 0);
-    else
-      buf_.erase(buf_.begin() + start, buf_.begin() + start - delta_);
-  }
-
-  // Check if the range between first (lower address) and second straddles
-  // the insertion point. If it does, change the offset at offsetloc (of
-  // type T, with direction D).
-  template<typename T, int D>
-  void Straddle(const void *first, const void *second, void *offsetloc) {
-    if (first <= startptr_ && second >= startptr_) {
-      WriteScalar<T>(offsetloc, ReadScalar<T>(offsetloc) + delta_ * D);
-      DagCheck(offsetloc) = true;
-    }
-  }
-
-  // This returns a boolean that records if the corresponding offset location
-  // has been modified already. If so, we can't even read the corresponding
-  // offset, since it is pointing to a location that is illegal until the
-  // resize actually happens.
-  // This must be checked for every offset, since we can't know which offsets
-  // will straddle and which won't.
-  uint8_t &DagCheck(const void *offsetloc) {
-    auto dag_idx = reinterpret_cast<const uoffset_t *>(offsetloc) -
-                   reinterpret_cast<const uoffset_t *>(vector_data(buf_));
-    return dag_check_[dag_idx];
-  }
-
-  void ResizeTable(const reflection::Object &objectdef, Table *table) {
-    if (DagCheck(table)) return;  // Table already visited.
-    auto vtable = table->GetVTable();
-    // Early out: since all fields inside the table must point forwards in
-    // memory, if the insertion point is before the table we can stop here.
-    auto tableloc = reinterpret_cast<uint8_t *>(table);
-    if (startptr_ <= tableloc) {
-      // Check if insertion point is between the table and a vtable that
-      // precedes it. This can't happen in current construction code, but check
-      // just in case we ever change the way flatbuffers are built.
-      Straddle<soffset_t, -1>(vtable, table, table);
-    } else {
-      // Check each field.
-      auto fielddefs = objectdef.fields();
-      for (auto it = fielddefs->begin(); it != fielddefs->end(); ++it) {
-        auto &fielddef = **it;
-        auto base_type = fielddef.type()->base_type();
-        // Ignore scalars.
-        if (base_type <= reflection::Double) continue;
-        // Ignore fields that are not stored.
-        auto offset = table->GetOptionalFieldOffset(fielddef.offset());
-        if (!offset) continue;
-        // Ignore structs.
-        auto subobjectdef =
-            base_type == reflection::Obj
-                ? schema_.objects()->Get(fielddef.type()->index())
-                : nullptr;
-        if (subobjectdef && subobjectdef->is_struct()) continue;
-        // Get this fields' offset, and read it if safe.
-        auto offsetloc = tableloc + offset;
-        if (DagCheck(offsetloc)) continue;  // This offset already visited.
-        auto ref = offsetloc + ReadScalar<uoffset_t>(offsetloc);
-        Straddle<uoffset_t, 1>(offsetloc, ref, offsetloc);
-        // Recurse.
-        switch (base_type) {
-          case reflection::Obj: {
-            ResizeTable(*subobjectdef, reinterpret_cast<Table *>(ref));
-            break;
-          }
-          case reflection::Vector: {
-            auto elem_type = fielddef.type()->element();
-            if (elem_type != reflection::Obj && elem_type != reflection::String)
-              break;
-            auto vec = reinterpret_cast<Vector<uoffset_t> *>(ref);
-            auto elemobjectdef =
-                elem_type == reflection::Obj
-                    ? schema_.objects()->Get(fielddef.type()->index())
-                    : nullptr;
-            if (elemobjectdef && elemobjectdef->is_struct()) break;
-            for (uoffset_t i = 0; i < vec->size(); i++) {
-              auto loc = vec->Data() + i * sizeof(uoffset_t);
-              if (DagCheck(loc)) continue;  // This offset already visited.
-              auto dest = loc + vec->Get(i);
-              Straddle<uoffset_t, 1>(loc, dest, loc);
-              if (elemobjectdef)
-                ResizeTable(*elemobjectdef, reinterpret_cast<Table *>(dest));
-            }
-            break;
-          }
-          case reflection::Union: {
-            ResizeTable(GetUnionType(schema_, objectdef, fielddef, *table),
-                        reinterpret_cast<Table *>(ref));
+
+ResizeBatch::Edit &ResizeBatch::Add(const void *length_loc, uoffset_t length,
+                                    uoffset_t start, int delta) {
+  auto mask = static_cast<int>(sizeof(largest_scalar_t) - 1);
+  Edit edit;
+  edit.length_loc = static_cast<uoffset_t>(
+      reinterpret_cast<const uint8_t *>(length_loc) - vector_data(flatbuf_));
+  edit.length = length;
+  edit.start = start;
+  // We can't shrink by less than largest_scalar_t.
+  edit.delta = (delta + mask) & ~mask;
+  edit.clear = 0;
+  edit.payload = payloads_.size();
+  edit.payload_size = 0;
+  edit.count = 0;
+  edits_.push_back(edit);
+  return edits_.back();
+}
+
+void ResizeBatch::SetString(const String *str, const std::string &val) {
+  auto delta = static_cast<int>(val.size()) - static_cast<int>(str->Length());
+  auto str_start = static_cast<uoffset_t>(
+      reinterpret_cast<const uint8_t *>(str) - vector_data(flatbuf_));
+  auto start = str_start + static_cast<uoffset_t>(sizeof(uoffset_t));
+  auto &edit = Add(str, static_cast<uoffset_t>(val.size()), start, delta);
+  // Clear the old string, since we don't want parts of it remaining.
+  edit.clear = str->Length();
+  edit.payload_size = static_cast<uoffset_t>(val.size() + 1);
+  edit.count = 1;
+  payloads_.insert(payloads_.end(), val.c_str(),
+                   val.c_str() + val.size() + 1);
+}
+
+void ResizeBatch::AddVector(const VectorOfAny *vec, uoffset_t num_elems,
+                            uoffset_t elem_size, uoffset_t newsize,
+                            const uint8_t *elem) {
+  auto delta_elem = static_cast<int>(newsize) - static_cast<int>(num_elems);
+  auto delta_bytes = delta_elem * static_cast<int>(elem_size);
+  auto vec_start =
+      reinterpret_cast<const uint8_t *>(vec) - vector_data(flatbuf_);
+  // Elements are added or removed at the end.
+  auto kept = (std::min)(num_elems, newsize);
+  auto start = static_cast<uoffset_t>(vec_start + sizeof(uoffset_t) +
+                                      elem_size * kept);
+  auto &edit = Add(vec, newsize, start, delta_bytes);
+  // Clear elements we're throwing away, since some might remain in the
+  // buffer.
+  edit.clear = (num_elems - kept) * elem_size;
+  if (elem && delta_elem > 0) {
+    edit.payload_size = elem_size;
+    edit.count = static_cast<uoffset_t>(delta_elem);
+    payloads_.insert(payloads_.end(), elem, elem + elem_size);
+  }
+}
+
+int ResizeBatch::Shift(const uint8_t *pos) const {
+  // Bytes at the start of an edit move with it.
+  auto offset = static_cast<uoffset_t>(pos - vector_data(flatbuf_));
+  auto it = std::upper_bound(
+      edits_.begin(), edits_.end(), offset,
+      [](uoffset_t o, const Edit &edit) { return o < edit.start; });
+  return it == edits_.begin() ? 0 : shifts_[it - edits_.begin() - 1];
+}
+
+// Changes the offset at offsetloc (of type T) from "from" to "to" by how
+// much further apart they get.
+template<typename T>
+void ResizeBatch::FixOffset(uint8_t *offsetloc, const uint8_t *from,
+                            const uint8_t *to) {
+  auto delta = Shift(to) - Shift(from);
+  if (delta) WriteScalar<T>(offsetloc, ReadScalar<T>(offsetloc) + delta);
+}
+
+// This returns a boolean that records if the corresponding offset location
+// has been visited already. If so, we can't even read the corresponding
+// offset, since it may have been changed to where it will point after the
+// bytes move.
+uint8_t &ResizeBatch::Visited(const void *offsetloc) {
+  auto idx = reinterpret_cast<const uoffset_t *>(offsetloc) -
+             reinterpret_cast<const uoffset_t *>(vector_data(flatbuf_));
+  return visited_[idx];
+}
+
+void ResizeBatch::FixTable(const reflection::Object &objectdef, Table *table) {
+  auto &visited = Visited(table);
+  if (visited) return;  // Table already visited.
+  visited = true;
+  auto vtable = table->GetVTable();
+  auto tableloc = reinterpret_cast<uint8_t *>(table);
+  // Early out: since all fields inside the table must point forwards in
+  // memory, if all edits are before the table we can stop here.
+  if (tableloc < vector_data(flatbuf_) + edits_.back().start) {
+    // Check each field.
+    auto fielddefs = objectdef.fields();
+    for (auto it = fielddefs->begin(); it != fielddefs->end(); ++it) {
+      auto &fielddef = **it;
+      auto base_type = fielddef.type()->base_type();
+      // Ignore scalars.
+      if (base_type <= reflection::Double) continue;
+      // Ignore fields that are not stored.
+      auto offset = table->GetOptionalFieldOffset(fielddef.offset());
+      if (!offset) continue;
+      // Ignore structs.
+      auto subobjectdef =
+          base_type == reflection::Obj
+              ? schema_.objects()->Get(fielddef.type()->index())
+              : nullptr;
+      if (subobjectdef && subobjectdef->is_struct()) continue;
+      // Get this fields' offset, and read it if safe.
+      auto offsetloc = tableloc + offset;
+      auto &visited_offset = Visited(offsetloc);
+      if (visited_offset) continue;  // This offset already visited.
+      visited_offset = true;
+      auto ref = offsetloc + ReadScalar<uoffset_t>(offsetloc);
+      FixOffset<uoffset_t>(offsetloc, offsetloc, ref);
+      // Recurse.
+      switch (base_type) {
+        case reflection::Obj: {
+          FixTable(*subobjectdef, reinterpret_cast<Table *>(ref));
+          break;
+        }
+        case reflection::Vector: {
+          auto elem_type = fielddef.type()->element();
+          if (elem_type != reflection::Obj && elem_type != reflection::String)
             break;
+          auto vec = reinterpret_cast<Vector<uoffset_t> *>(ref);
+          auto elemobjectdef =
+              elem_type == reflection::Obj
+                  ? schema_.objects()->Get(fielddef.type()->index())
+                  : nullptr;
+          if (elemobjectdef && elemobjectdef->is_struct()) break;
+          for (uoffset_t i = 0; i < vec->size(); i++) {
+            auto loc = vec->Data() + i * sizeof(uoffset_t);
+            auto &visited_elem = Visited(loc);
+            if (visited_elem) continue;  // This offset already visited.
+            visited_elem = true;
+            auto dest = loc + vec->Get(i);
+            FixOffset<uoffset_t>(loc, loc, dest);
+            if (elemobjectdef)
+              FixTable(*elemobjectdef, reinterpret_cast<Table *>(dest));
           }
-          case reflection::String: break;
-          default: assert(false);
+          break;
+        }
+        case reflection::Union: {
+          FixTable(GetUnionType(schema_, objectdef, fielddef, *table),
+                   reinterpret_cast<Table *>(ref));
+          break;
         }
+        case reflection::String: break;
+        default: assert(false);
       }
-      // Check if the vtable offset points beyond the insertion point.
-      // Must do this last, since GetOptionalFieldOffset above still reads
-      // this value.
-      Straddle<soffset_t, -1>(table, vtable, table);
     }
   }
+  // Check if the vtable offset changes. Must do this last, since
+  // GetOptionalFieldOffset above still reads this value.
+  FixOffset<soffset_t>(tableloc, vtable, tableloc);
+}
 
-  void operator=(const ResizeContext &rc);
+// Each edit is followed by a segment of the buffer, up to the next edit, that
+// moves by the sum of the deltas of the edits so far.
+void ResizeBatch::MoveBytes() {
+  auto old_size = flatbuf_.size();
+  auto new_size = old_size + shifts_.back();
+  auto growing = true;
+  auto shrinking = true;
+  for (auto it = edits_.begin(); it != edits_.end(); ++it) {
+    growing = growing && it->delta >= 0;
+    shrinking = shrinking && it->delta <= 0;
+  }
+  // If all segments move the same way they can move inside the buffer,
+  // otherwise they would overwrite each other.
+  if (growing) flatbuf_.resize(new_size);
+  auto src = vector_data(flatbuf_);
+  auto dest = src;
+  if (!growing && !shrinking) {
+    moved_.resize(new_size);
+    dest = vector_data(moved_);
+    memcpy(dest, src, edits_.front().start);
+  }
+  auto num_edits = edits_.size();
+  for (size_t j = 0; j < num_edits; j++) {
+    // Back to front when growing, so segments don't overwrite the ones yet
+    // to move.
+    auto i = growing ? num_edits - 1 - j : j;
+    auto &edit = edits_[i];
+    auto from = edit.start;
+    if (edit.delta < 0) from += static_cast<uoffset_t>(-edit.delta);
+    auto end = i + 1 < num_edits ? edits_[i + 1].start : old_size;
+    memmove(dest + from + shifts_[i], src + from, end - from);
+    if (edit.delta > 0) {
+      memset(dest + edit.start + shifts_[i] - edit.delta, 0, edit.delta);
+    }
+  }
+  if (shrinking) flatbuf_.resize(new_size);
+  if (!growing && !shrinking) flatbuf_.swap(moved_);
+}
 
- private:
-  const reflection::Schema &schema_;
-  uint8_t *startptr_;
-  int delta_;
-  std::vector<uint8_t> &buf_;
-  std::vector<uint8_t> dag_check_;
-};
+void ResizeBatch::Apply() {
+  if (edits_.empty()) return;
+  std::sort(edits_.begin(), edits_.end());
+  auto buf = vector_data(flatbuf_);
+  shifts_.resize(edits_.size());
+  int shift = 0;
+  auto resize = false;
+  for (size_t i = 0; i < edits_.size(); i++) {
+    auto &edit = edits_[i];
+    // Each string or vector may only be edited once.
+    assert(!i || (edits_[i - 1].start < edit.start &&
+                  edits_[i - 1].start + edits_[i - 1].clear <= edit.start));
+    memset(buf + edit.start, 0, edit.clear);
+    shift += edit.delta;
+    shifts_[i] = shift;
+    resize = resize || edit.delta;
+  }
+  if (resize) {
+    // Now change all the offsets, then move the bytes.
+    visited_.assign(flatbuf_.size() / sizeof(uoffset_t), false);
+    auto root = GetAnyRoot(buf);
+    FixOffset<uoffset_t>(buf, buf, reinterpret_cast<uint8_t *>(root));
+    FixTable(root_table_, root);
+    MoveBytes();
+    buf = vector_data(flatbuf_);
+  }
+  // Set the new lengths and contents, safe because we created the right
+  // amount of space.
+  for (size_t i = 0; i < edits_.size(); i++) {
+    auto &edit = edits_[i];
+    auto moved = i ? shifts_[i - 1] : 0;
+    WriteScalar(buf + edit.length_loc + moved, edit.length);
+    auto dest = buf + edit.start + moved;
+    for (uoffset_t j = 0; j < edit.count; j++) {
+      memcpy(dest + j * edit.payload_size, &payloads_[edit.payload],
+             edit.payload_size);
+    }
+  }
+  edits_.clear();
+  payloads_.clear();
+}
 
 void SetString(const reflection::Schema &schema, const std::string &val,
                const String *str, std::vector<uint8_t> *flatbuf,
                const reflection::Object *root_table) {
-  auto delta = static_cast<int>(val.size()) - static_cast<int>(str->Length());
-  auto str_start = static_cast<uoffset_t>(
-      reinterpret_cast<const uint8_t *>(str) - vector_data(*flatbuf));
-  auto start = str_start + static_cast<uoffset_t>(sizeof(uoffset_t));
-  if (delta) {
-    // Clear the old string, since we don't want parts of it remaining.
-    memset(vector_data(*flatbuf) + start, 0, str->Length());
-    // Different size, we must expand (or contract).
-    ResizeContext(schema, start, delta, flatbuf, root_table);
-    // Set the new length.
-    WriteScalar(vector_data(*flatbuf) + str_start,
-                static_cast<uoffset_t>(val.size()));
-  }
-  // Copy new data. Safe because we created the right amount of space.
-  memcpy(vector_data(*flatbuf) + start, val.c_str(), val.size() + 1);
+  ResizeBatch batch(schema, flatbuf, root_table);
+  batch.SetString(str, val);
+  batch.Apply();
 }
 
 uint8_t *ResizeAnyVector(const reflection::Schema &schema, uoffset_t newsize,
                          const VectorOfAny *vec, uoffset_t num_elems,
                          uoffset_t elem_size, std::vector<uint8_t> *flatbuf,
                          const reflection::Object *root_table) {
-  auto delta_elem = static_cast<int>(newsize) - static_cast<int>(num_elems);
-  auto delta_bytes = delta_elem * static_cast<int>(elem_size);
   auto vec_start =
       reinterpret_cast<const uint8_t *>(vec) - vector_data(*flatbuf);
+  auto kept = (std::min)(num_elems, newsize);
   auto start = static_cast<uoffset_t>(vec_start + sizeof(uoffset_t) +
-                                      elem_size * num_elems);
-  if (delta_bytes) {
-    if (delta_elem < 0) {
-      // Clear elements we're throwing away, since some might remain in the
-      // buffer.
-      auto size_clear = -delta_elem * elem_size;
-      memset(vector_data(*flatbuf) + start - size_clear, 0, size_clear);
-    }
-    ResizeContext(schema, start, delta_bytes, flatbuf, root_table);
-    WriteScalar(vector_data(*flatbuf) + vec_start, newsize);  // Length field.
-    // Set new elements to 0.. this can be overwritten by the caller.
-    if (delta_elem > 0) {
-      memset(vector_data(*flatbuf) + start, 0, delta_elem * elem_size);
-    }
-  }
+                                      elem_size * kept);
+  ResizeBatch batch(schema, flatbuf, root_table);
+  batch.ResizeAnyVector(vec, num_elems, elem_size, newsize);
+  batch.Apply();
+  // Where the new elements are, if any. This can be overwritten by the
+  // caller.
   return vector_data(*flatbuf) + start;
 }
 
@@ -487,6 +642,904 @@ Offset<const Table *> CopyTable(FlatBufferBuilder &fbb,
   }
 }
 
+static const size_t kNoPlan = ~static_cast<size_t>(0);
+
+TableCopier::TableCopier(const reflection::Schema &schema,
+                         const reflection::Object &objectdef,
+                         bool use_string_pooling)
+    : schema_(schema),
+      object_(ObjectIndex(&objectdef)),
+      use_string_pooling_(use_string_pooling),
+      root_plan_(0),
+      planned_(false) {
+  assert(!objectdef.is_struct());
+}
+
+bool TableCopier::Keep(const char *path) {
+  if (!ValidPath(path, false)) return false;
+  keeps_.push_back(path);
+  planned_ = false;
+  return true;
+}
+
+bool TableCopier::Drop(const char *path) {
+  if (!ValidPath(path, true)) return false;
+  drops_.push_back(path);
+  planned_ = false;
+  return true;
+}
+
+bool TableCopier::ValidPath(const char *path, bool drop) const {
+  auto objectdef = schema_.objects()->Get(static_cast<uoffset_t>(object_));
+  for (;;) {
+    auto end = strchr(path, '.');
+    auto name = end ? std::string(path, end) : std::string(path);
+    auto fielddef = objectdef->fields()->LookupByKey(name.c_str());
+    if (!fielddef) return false;
+    if (!end) return !drop || !fielddef->required();
+    auto type = fielddef->type();
+    if (type->base_type() != reflection::Obj &&
+        (type->base_type() != reflection::Vector ||
+         type->element() != reflection::Obj))
+      return false;
+    objectdef = schema_.objects()->Get(type->index());
+    // Structs are copied whole, anything inside them can only be kept.
+    if (drop && objectdef->is_struct()) return false;
+    path = end + 1;
+  }
+}
+
+size_t TableCopier::ObjectIndex(const reflection::Object *objectdef) const {
+  auto objects = schema_.objects();
+  for (uoffset_t i = 0; i < objects->size(); i++) {
+    if (objects->Get(i) == objectdef) return i;
+  }
+  assert(false);  // Not an object of this schema.
+  return 0;
+}
+
+// If "path" is "name" or goes through it, sets "rest" to what follows.
+static bool SplitPath(const std::string &path, const std::string &name,
+                      std::string *rest) {
+  if (path.compare(0, name.size(), name)) return false;
+  if (path.size() == name.size()) {
+    rest->clear();
+    return true;
+  }
+  if (path[name.size()] != '.') return false;
+  *rest = path.substr(name.size() + 1);
+  return true;
+}
+
+// Adds a plan for "object" with just the fields of "keeps" (or all if there
+// are none) minus those of "drops", both relative to the object. Returns the
+// plan to use.
+size_t TableCopier::AddPlan(size_t object,
+                            const std::vector<std::string> &keeps,
+                            const std::vector<std::string> &drops) {
+  if (keeps.empty() && drops.empty()) return object;
+  auto &objectdef = *schema_.objects()->Get(static_cast<uoffset_t>(object));
+  auto fielddefs = objectdef.fields();
+  std::vector<uint8_t> copied(fielddefs->size(), false);
+  std::vector<size_t> subplans(fielddefs->size(), kNoPlan);
+  std::string rest;
+  for (uoffset_t i = 0; i < fielddefs->size(); i++) {
+    auto &fielddef = *fielddefs->Get(i);
+    auto name = fielddef.name()->str();
+    std::vector<std::string> sub_keeps;
+    std::vector<std::string> sub_drops;
+    auto whole = keeps.empty();
+    for (auto it = keeps.begin(); it != keeps.end(); ++it) {
+      if (!SplitPath(*it, name, &rest)) continue;
+      if (rest.empty()) {
+        whole = true;
+      } else {
+        sub_keeps.push_back(rest);
+      }
+    }
+    auto dropped = false;
+    for (auto it = drops.begin(); it != drops.end(); ++it) {
+      if (!SplitPath(*it, name, &rest)) continue;
+      if (rest.empty()) {
+        dropped = true;
+      } else {
+        sub_drops.push_back(rest);
+      }
+    }
+    if (whole) sub_keeps.clear();
+    copied[i] =
+        !dropped && (whole || !sub_keeps.empty() || fielddef.required());
+    if (!copied[i] || (sub_keeps.empty() && sub_drops.empty())) continue;
+    auto subobject = schema_.objects()->Get(fielddef.type()->index());
+    if (!subobject->is_struct()) {
+      subplans[i] = AddPlan(fielddef.type()->index(), sub_keeps, sub_drops);
+    }
+  }
+  // The type of a union goes with its value.
+  for (uoffset_t i = 0; i < fielddefs->size(); i++) {
+    auto &fielddef = *fielddefs->Get(i);
+    if (fielddef.type()->base_type() != reflection::Union) continue;
+    auto type_field = fielddefs->LookupByKey(
+        (fielddef.name()->str() + UnionTypeFieldSuffix()).c_str());
+    assert(type_field);
+    for (uoffset_t j = 0; j < fielddefs->size(); j++) {
+      if (fielddefs->Get(j) == type_field) copied[j] = copied[i];
+    }
+  }
+  Plan plan;
+  FillPlan(object, copied, subplans, &plan);
+  plans_.push_back(plan);
+  return plans_.size() - 1;
+}
+
+void TableCopier::FillPlan(size_t object, const std::vector<uint8_t> &copied,
+                           const std::vector<size_t> &subplans, Plan *plan) {
+  auto &objectdef = *schema_.objects()->Get(static_cast<uoffset_t>(object));
+  auto fielddefs = objectdef.fields();
+  for (uoffset_t i = 0; i < fielddefs->size(); i++) {
+    if (!copied[i]) continue;
+    auto &fielddef = *fielddefs->Get(i);
+    auto type = fielddef.type();
+    FieldPlan field;
+    field.offset = fielddef.offset();
+    field.type = type->base_type();
+    field.element = type->element();
+    field.size = 0;
+    field.align = 0;
+    field.nested_flatbuffer =
+        fielddef.attributes() &&
+        fielddef.attributes()->LookupByKey("nested_flatbuffer");
+    field.plan = kNoPlan;
+    field.union_type = 0;
+    field.unions = 0;
+    field.num_unions = 0;
+    auto subobject = (field.type == reflection::Obj ||
+                      (field.type == reflection::Vector &&
+                       field.element == reflection::Obj))
+                         ? schema_.objects()->Get(type->index())
+                         : nullptr;
+    if (subobject && subobject->is_struct()) {
+      field.size = static_cast<uoffset_t>(subobject->bytesize());
+      field.align = static_cast<uoffset_t>(subobject->minalign());
+    } else if (subobject) {
+      field.plan = subplans[i] != kNoPlan
+                       ? subplans[i]
+                       : static_cast<size_t>(type->index());
+    } else if (field.type == reflection::Vector) {
+      if (IsScalar(field.element)) {
+        field.size = static_cast<uoffset_t>(GetTypeSize(field.element));
+        field.align = field.size;
+      }
+    } else if (field.type == reflection::Union) {
+      auto type_field = fielddefs->LookupByKey(
+          (fielddef.name()->str() + UnionTypeFieldSuffix()).c_str());
+      assert(type_field);
+      field.union_type = type_field->offset();
+      field.unions = union_plans_.size();
+      auto values = schema_.enums()->Get(type->index())->values();
+      for (auto it = values->begin(); it != values->end(); ++it) {
+        auto value = static_cast<size_t>(it->value());
+        if (value >= field.num_unions) {
+          field.num_unions = value + 1;
+          union_plans_.resize(field.unions + field.num_unions, kNoPlan);
+        }
+        if (it->object())
+          union_plans_[field.unions + value] = ObjectIndex(it->object());
+      }
+    } else if (IsScalar(field.type)) {
+      field.size = static_cast<uoffset_t>(GetTypeSize(field.type));
+      field.align = field.size;
+    }
+    if (field.type == reflection::Obj ? subobject->is_struct()
+                                      : IsScalar(field.type)) {
+      plan->inline_fields.push_back(field);
+    } else {
+      plan->offset_fields.push_back(field);
+    }
+  }
+  std::stable_sort(plan->inline_fields.begin(), plan->inline_fields.end(),
+                   [](const FieldPlan &a, const FieldPlan &b) {
+                     return a.align > b.align;
+                   });
+  plan->whole = std::find(copied.begin(), copied.end(), false) == copied.end();
+  plan->num_wide = 0;
+  while (plan->num_wide < plan->inline_fields.size() &&
+         plan->inline_fields[plan->num_wide].align >= sizeof(uoffset_t)) {
+    plan->num_wide++;
+  }
+}
+
+Offset<const Table *> TableCopier::Copy(FlatBufferBuilder &fbb,
+                                        const Table &table) {
+  if (!planned_) MakePlans();
+  return CopyTable(fbb, root_plan_, table);
+}
+
+// The plans for copying all fields come first, by object.
+void TableCopier::MakePlans() {
+  auto objects = schema_.objects();
+  plans_.clear();
+  union_plans_.clear();
+  plans_.resize(objects->size());
+  for (uoffset_t i = 0; i < objects->size(); i++) {
+    if (objects->Get(i)->is_struct()) continue;
+    std::vector<uint8_t> copied(objects->Get(i)->fields()->size(), true);
+    std::vector<size_t> subplans(copied.size(), kNoPlan);
+    FillPlan(i, copied, subplans, &plans_[i]);
+  }
+  root_plan_ = AddPlan(object_, keeps_, drops_);
+  planned_ = true;
+}
+
+uoffset_t TableCopier::CopyTable(FlatBufferBuilder &fbb, size_t plan_index,
+                                 const Table &table) {
+  auto &plan = plans_[plan_index];
+  // Before we can construct the table, we have to first generate any
+  // subobjects, and collect their offsets.
+  auto base = offsets_.size();
+  for (auto it = plan.offset_fields.begin(); it != plan.offset_fields.end();
+       ++it) {
+    auto p = table.GetAddressOf(it->offset);
+    auto offset =
+        p ? CopyField(fbb, *it, table, p + ReadScalar<uoffset_t>(p)) : 0;
+    offsets_.push_back(offset);
+  }
+  auto start = fbb.StartTable();
+  if (plan.whole && CopyInlineData(fbb, plan, table, base)) {
+    offsets_.resize(base);
+    return fbb.EndTable(start);
+  }
+  auto &inline_fields = plan.inline_fields;
+  for (size_t i = 0; i <= inline_fields.size(); i++) {
+    if (i == plan.num_wide) {
+      for (size_t j = 0; j < plan.offset_fields.size(); j++) {
+        auto offset = offsets_[base + j];
+        if (offset)
+          fbb.AddOffset(plan.offset_fields[j].offset, Offset<void>(offset));
+      }
+    }
+    if (i == inline_fields.size()) break;
+    auto &field = inline_fields[i];
+    auto p = table.GetAddressOf(field.offset);
+    if (!p) continue;
+    fbb.Align(field.align);
+    fbb.PushBytes(p, field.size);
+    fbb.TrackField(field.offset, fbb.GetSize());
+  }
+  offsets_.resize(base);
+  return fbb.EndTable(start);
+}
+
+// Copies the fields of "table" stored in it in one piece, keeping them at
+// the same place relative to each other, then points its offsets at the
+// copies of what they refer to, starting at offsets_[base]. Returns false,
+// without copying anything, if the source isn't aligned in memory the way it
+// is within its buffer.
+bool TableCopier::CopyInlineData(FlatBufferBuilder &fbb, const Plan &plan,
+                                 const Table &table, size_t base) {
+  auto vtable = table.GetVTable();
+  // What follows the offset to the vtable.
+  auto data = reinterpret_cast<const uint8_t *>(&table) + sizeof(soffset_t);
+  auto size = ReadScalar<voffset_t>(vtable + sizeof(voffset_t)) -
+              sizeof(soffset_t);
+  // The fields are aligned in the source, so they will be in the copy if it
+  // is aligned the same way for the largest of them that are set. Offsets in
+  // the builder count from the end.
+  auto align = static_cast<uoffset_t>(sizeof(uoffset_t));
+  auto widest = reinterpret_cast<const uint8_t *>(&table);
+  for (auto it = plan.inline_fields.begin();
+       it != plan.inline_fields.end() && it->align > align; ++it) {
+    auto p = table.GetAddressOf(it->offset);
+    if (p) {
+      align = it->align;
+      widest = p;
+    }
+  }
+  // Where the data sits relative to that alignment is taken from its
+  // address, which is only where it sits in its buffer if the buffer is
+  // aligned as well. The widest field is aligned within the buffer, so is
+  // at an aligned address if it is.
+  if (reinterpret_cast<size_t>(widest) % align) return false;
+  auto misalign = reinterpret_cast<size_t>(data) % align;
+  fbb.TrackMinAlign(align);
+  fbb.Pad((align - (fbb.GetSize() + size + misalign) % align) % align);
+  fbb.PushBytes(data, size);
+  auto copy_off = fbb.GetSize();
+  // Point the offsets at the copies first, since tracking fields may move
+  // the copy.
+  auto copy = fbb.GetCurrentBufferPointer();
+  for (size_t j = 0; j < plan.offset_fields.size(); j++) {
+    auto field_off = table.GetOptionalFieldOffset(plan.offset_fields[j].offset);
+    if (!field_off) continue;
+    auto loc = field_off - sizeof(soffset_t);
+    auto offset = offsets_[base + j];
+    WriteScalar<uoffset_t>(
+        copy + loc,
+        offset ? static_cast<uoffset_t>(copy_off - loc) - offset : 0);
+  }
+  for (auto it = plan.inline_fields.begin(); it != plan.inline_fields.end();
+       ++it) {
+    auto field_off = table.GetOptionalFieldOffset(it->offset);
+    if (!field_off) continue;
+    fbb.TrackField(it->offset, static_cast<uoffset_t>(
+                                   copy_off - (field_off - sizeof(soffset_t))));
+  }
+  for (size_t j = 0; j < plan.offset_fields.size(); j++) {
+    auto field_off = table.GetOptionalFieldOffset(plan.offset_fields[j].offset);
+    if (!field_off || !offsets_[base + j]) continue;
+    fbb.TrackField(plan.offset_fields[j].offset,
+                   static_cast<uoffset_t>(
+                       copy_off - (field_off - sizeof(soffset_t))));
+  }
+  return true;
+}
+
+uoffset_t TableCopier::CopyString(FlatBufferBuilder &fbb,
+                                  const uint8_t *ref) {
+  auto str = reinterpret_cast<const String *>(ref);
+  return use_string_pooling_ ? fbb.CreateSharedString(str).o
+                             : fbb.CreateString(str).o;
+}
+
+uoffset_t TableCopier::CopyField(FlatBufferBuilder &fbb,
+                                 const FieldPlan &field, const Table &table,
+                                 const uint8_t *ref) {
+  switch (field.type) {
+    case reflection::String: return CopyString(fbb, ref);
+    case reflection::Obj:
+      return CopyTable(fbb, field.plan, *reinterpret_cast<const Table *>(ref));
+    case reflection::Union: {
+      auto type = table.GetField<uint8_t>(field.union_type, 0);
+      if (type >= field.num_unions) return 0;
+      auto plan = union_plans_[field.unions + type];
+      if (plan == kNoPlan) return 0;
+      return CopyTable(fbb, plan, *reinterpret_cast<const Table *>(ref));
+    }
+    case reflection::Vector: {
+      auto len = ReadScalar<uoffset_t>(ref);
+      auto elems = ref + sizeof(uoffset_t);
+      if (field.size) {  // Scalars and structs.
+        if (field.nested_flatbuffer)
+          fbb.ForceVectorAlignment(len, field.size, sizeof(largest_scalar_t));
+        fbb.StartVector(len * field.size / field.align, field.align);
+        fbb.PushBytes(elems, len * field.size);
+        return fbb.EndVector(len);
+      }
+      if (field.element != reflection::String && field.plan == kNoPlan)
+        return 0;  // Vectors of unions aren't supported.
+      auto base = offsets_.size();
+      for (uoffset_t i = 0; i < len; i++) {
+        auto loc = elems + i * sizeof(uoffset_t);
+        auto elem = loc + ReadScalar<uoffset_t>(loc);
+        offsets_.push_back(
+            field.element == reflection::String
+                ? CopyString(fbb, elem)
+                : CopyTable(fbb, field.plan,
+                            *reinterpret_cast<const Table *>(elem)));
+      }
+      fbb.StartVector(len, sizeof(uoffset_t));
+      for (auto i = len; i > 0;) {
+        fbb.PushElement(Offset<void>(offsets_[base + --i]));
+      }
+      offsets_.resize(base);
+      return fbb.EndVector(len);
+    }
+    default: assert(false); return 0;
+  }
+}
+
+// Scalars other than the types of unions.
+static bool IsValue(reflection::BaseType t) {
+  return t > reflection::UType && t <= reflection::Double;
+}
+
+// Converts the scalar at "p" to "type" in "value", and returns where it is.
+static const uint8_t *ConvertScalar(reflection::BaseType type,
+                                    reflection::BaseType from_type,
+                                    const uint8_t *p, uint64_t *value) {
+  auto data = reinterpret_cast<uint8_t *>(value);
+  if (IsFloat(from_type)) {
+    SetAnyValueF(type, data, GetAnyValueF(from_type, p));
+  } else {
+    SetAnyValueI(type, data, GetAnyValueI(from_type, p));
+  }
+  return data;
+}
+
+SchemaMigrator::SchemaMigrator(const reflection::Schema &from,
+                               const reflection::Schema &to,
+                               bool use_string_pooling)
+    : from_(from),
+      to_(to),
+      use_string_pooling_(use_string_pooling),
+      copier_(from, *from.root_table(), use_string_pooling) {
+  auto objects = from_.objects();
+  plans_.resize(objects->size());
+  for (uoffset_t i = 0; i < objects->size(); i++) {
+    auto &objectdef = *objects->Get(i);
+    if (objectdef.is_struct()) continue;
+    // Tables that aren't in "to" can't be referred to either, see AddField().
+    auto to_objectdef = to_.objects()->LookupByKey(objectdef.name()->c_str());
+    if (to_objectdef && !to_objectdef->is_struct()) AddPlan(i, *to_objectdef);
+  }
+  // Enum values are stored as numbers, so unlike the members of unions
+  // (matched by name, see AddField()) can't be renumbered.
+  auto enums = from_.enums();
+  for (auto it = enums->begin(); it != enums->end(); ++it) {
+    auto to_enumdef = to_.enums()->LookupByKey(it->name()->c_str());
+    if (it->is_union() || !to_enumdef) continue;
+    auto to_values = to_enumdef->values();
+    for (auto vit = it->values()->begin(); vit != it->values()->end(); ++vit) {
+      for (auto tit = to_values->begin(); tit != to_values->end(); ++tit) {
+        if (tit->name()->str() != vit->name()->str()) continue;
+        if (tit->value() != vit->value())
+          errors_.push_back("values differ for enum: " + it->name()->str() +
+                            "." + vit->name()->str());
+        break;
+      }
+    }
+  }
+  auto root = from_.root_table();
+  auto to_root = to_.root_table();
+  if (!to_root || root->name()->str() != to_root->name()->str())
+    errors_.push_back("root types differ: " + root->name()->str());
+  FindUnchanged();
+  copier_.MakePlans();
+}
+
+void SchemaMigrator::AddPlan(size_t object,
+                             const reflection::Object &to_objectdef) {
+  auto &objectdef = *from_.objects()->Get(static_cast<uoffset_t>(object));
+  auto fielddefs = objectdef.fields();
+  auto to_fielddefs = to_objectdef.fields();
+  auto &plan = plans_[object];
+  for (uoffset_t i = 0; i < to_fielddefs->size(); i++) {
+    auto &to_field = *to_fielddefs->Get(i);
+    // The types of unions go with their values.
+    if (to_field.deprecated() ||
+        to_field.type()->base_type() == reflection::UType)
+      continue;
+    auto from_field = fielddefs->LookupByKey(to_field.name()->c_str());
+    if (!from_field) {
+      // Renamed, so has the id of a field that isn't in "to".
+      for (auto it = fielddefs->begin(); it != fielddefs->end(); ++it) {
+        if (it->offset() == to_field.offset() &&
+            !to_fielddefs->LookupByKey(it->name()->c_str())) {
+          from_field = *it;
+          break;
+        }
+      }
+    }
+    if (!from_field || from_field->deprecated()) {
+      if (to_field.required())
+        errors_.push_back("required field added: " +
+                          to_objectdef.name()->str() + "." +
+                          to_field.name()->str());
+      continue;
+    }
+    AddField(objectdef, to_objectdef, *from_field, to_field, &plan);
+  }
+  std::stable_sort(plan.inline_fields.begin(), plan.inline_fields.end(),
+                   [](const FieldPlan &a, const FieldPlan &b) {
+                     return a.align > b.align;
+                   });
+  plan.num_wide = 0;
+  while (plan.num_wide < plan.inline_fields.size() &&
+         plan.inline_fields[plan.num_wide].align >= sizeof(uoffset_t)) {
+    plan.num_wide++;
+  }
+}
+
+void SchemaMigrator::AddField(const reflection::Object &from_objectdef,
+                              const reflection::Object &to_objectdef,
+                              const reflection::Field &from_field,
+                              const reflection::Field &to_field, Plan *plan) {
+  auto from_type = from_field.type();
+  auto type = to_field.type();
+  FieldPlan field;
+  field.from = from_field.offset();
+  field.to = to_field.offset();
+  field.type = type->base_type();
+  field.from_type = from_type->base_type();
+  field.element = type->element();
+  field.from_element = from_type->element();
+  field.size = 0;
+  field.align = 0;
+  field.from_size = 0;
+  field.nested_flatbuffer =
+      to_field.attributes() &&
+      to_field.attributes()->LookupByKey("nested_flatbuffer");
+  field.object = kNoPlan;
+  field.union_type = 0;
+  field.unions = 0;
+  field.num_unions = 0;
+  field.fill = false;
+  field.fill_value = 0;
+  auto same = false;
+  auto is_struct = false;
+  switch (field.type) {
+    case reflection::String:
+      same = field.from_type == reflection::String;
+      break;
+    case reflection::Obj:
+      same = field.from_type == reflection::Obj &&
+             SameObject(from_type->index(), type->index(), &is_struct);
+      break;
+    case reflection::Vector:
+      if (field.from_type != reflection::Vector) break;
+      if (field.element == reflection::Obj) {
+        same = field.from_element == reflection::Obj &&
+               SameObject(from_type->index(), type->index(), &is_struct);
+      } else if (field.element == reflection::String) {
+        same = field.from_element == reflection::String;
+      } else {
+        same = IsValue(field.element) && IsValue(field.from_element);
+      }
+      break;
+    case reflection::Union:
+      same = field.from_type == reflection::Union;
+      break;
+    default:
+      same = IsValue(field.type) && IsValue(field.from_type);
+      break;
+  }
+  auto name = to_objectdef.name()->str() + "." + to_field.name()->str();
+  if (!same) {
+    errors_.push_back("types differ for field: " + name);
+    return;
+  }
+  if (field.type == reflection::Union) {
+    auto suffix = UnionTypeFieldSuffix();
+    auto from_type_field = from_objectdef.fields()->LookupByKey(
+        (from_field.name()->str() + suffix).c_str());
+    auto to_type_field = to_objectdef.fields()->LookupByKey(
+        (to_field.name()->str() + suffix).c_str());
+    assert(from_type_field && to_type_field);
+    field.union_type = from_type_field->offset();
+    field.unions = union_types_.size();
+    auto from_enumdef = from_.enums()->Get(from_type->index());
+    auto values = to_.enums()->Get(type->index())->values();
+    for (auto it = from_enumdef->values()->begin();
+         it != from_enumdef->values()->end(); ++it) {
+      auto value = static_cast<size_t>(it->value());
+      if (value >= field.num_unions) {
+        field.num_unions = value + 1;
+        UnionType none = { 0, kNoPlan };
+        union_types_.resize(field.unions + field.num_unions, none);
+      }
+      if (!it->object()) continue;
+      auto &union_type = union_types_[field.unions + value];
+      union_type.object = copier_.ObjectIndex(it->object());
+      // Members left out of "to" are left out of the migrated buffers.
+      for (auto vit = values->begin(); vit != values->end(); ++vit) {
+        if (vit->name()->str() != it->name()->str()) continue;
+        if (vit->object() && !vit->object()->is_struct() &&
+            vit->object()->name()->str() == it->object()->name()->str()) {
+          union_type.type = static_cast<uint8_t>(vit->value());
+        } else {
+          errors_.push_back("types differ for union member: " +
+                            from_enumdef->name()->str() + "." +
+                            it->name()->str());
+        }
+        break;
+      }
+    }
+    auto type_field = field;
+    type_field.from = field.union_type;
+    type_field.to = to_type_field->offset();
+    type_field.type = reflection::UType;
+    type_field.from_type = reflection::UType;
+    type_field.size = 1;
+    type_field.align = 1;
+    type_field.from_size = 1;
+    plan->inline_fields.push_back(type_field);
+    plan->offset_fields.push_back(field);
+    return;
+  }
+  if (field.type == reflection::Obj || field.element == reflection::Obj) {
+    auto &to_objdef = *to_.objects()->Get(type->index());
+    if (is_struct) {
+      field.size = static_cast<uoffset_t>(to_objdef.bytesize());
+      field.align = static_cast<uoffset_t>(to_objdef.minalign());
+      field.from_size = field.size;
+    } else {
+      field.object = static_cast<size_t>(from_type->index());
+    }
+  } else if (field.type == reflection::Vector) {
+    if (IsScalar(field.element)) {
+      field.size = static_cast<uoffset_t>(GetTypeSize(field.element));
+      field.align = field.size;
+      field.from_size =
+          static_cast<uoffset_t>(GetTypeSize(field.from_element));
+    }
+  } else if (IsScalar(field.type)) {
+    field.size = static_cast<uoffset_t>(GetTypeSize(field.type));
+    field.align = field.size;
+    field.from_size = static_cast<uoffset_t>(GetTypeSize(field.from_type));
+    // Compare the defaults as stored in "to".
+    uint64_t from_default = 0;
+    auto data = reinterpret_cast<uint8_t *>(&from_default);
+    if (IsFloat(field.from_type)) {
+      SetAnyValueF(field.type, data, from_field.default_real());
+    } else {
+      SetAnyValueI(field.type, data, from_field.default_integer());
+    }
+    uint64_t to_default = 0;
+    data = reinterpret_cast<uint8_t *>(&to_default);
+    if (IsFloat(field.type)) {
+      SetAnyValueF(field.type, data, to_field.default_real());
+    } else {
+      SetAnyValueI(field.type, data, to_field.default_integer());
+    }
+    field.fill = from_default != to_default;
+    field.fill_value = from_default;
+  }
+  if (field.type == reflection::Obj ? is_struct : IsScalar(field.type)) {
+    plan->inline_fields.push_back(field);
+  } else {
+    plan->offset_fields.push_back(field);
+  }
+}
+
+bool SchemaMigrator::SameObject(uoffset_t from_index, uoffset_t to_index,
+                                bool *is_struct) const {
+  auto &from_objectdef = *from_.objects()->Get(from_index);
+  auto &to_objectdef = *to_.objects()->Get(to_index);
+  if (from_objectdef.name()->str() != to_objectdef.name()->str() ||
+      from_objectdef.is_struct() != to_objectdef.is_struct())
+    return false;
+  *is_struct = from_objectdef.is_struct();
+  return !*is_struct || SameStruct(from_objectdef, to_objectdef);
+}
+
+// Structs are stored inline, so can't change layout.
+bool SchemaMigrator::SameStruct(const reflection::Object &from_objectdef,
+                                const reflection::Object &to_objectdef) const {
+  auto fielddefs = from_objectdef.fields();
+  auto to_fielddefs = to_objectdef.fields();
+  if (from_objectdef.bytesize() != to_objectdef.bytesize() ||
+      from_objectdef.minalign() != to_objectdef.minalign() ||
+      fielddefs->size() != to_fielddefs->size())
+    return false;
+  for (auto it = fielddefs->begin(); it != fielddefs->end(); ++it) {
+    auto match = false;
+    for (auto tit = to_fielddefs->begin(); tit != to_fielddefs->end(); ++tit) {
+      if (tit->offset() != it->offset()) continue;
+      auto type = it->type()->base_type();
+      auto is_struct = false;
+      match = tit->type()->base_type() == type &&
+              (type != reflection::Obj ||
+               SameObject(it->type()->index(), tit->type()->index(),
+                          &is_struct));
+      break;
+    }
+    if (!match) return false;
+  }
+  return true;
+}
+
+// Whether the fields of "object" are all kept as they are. The tables it
+// refers to are checked by FindUnchanged().
+bool SchemaMigrator::Unchanged(size_t object) const {
+  auto &plan = plans_[object];
+  auto &objectdef = *from_.objects()->Get(static_cast<uoffset_t>(object));
+  auto fielddefs = objectdef.fields();
+  size_t num_fields = 0;
+  for (auto it = fielddefs->begin(); it != fielddefs->end(); ++it) {
+    if (!it->deprecated()) num_fields++;
+  }
+  if (plan.inline_fields.size() + plan.offset_fields.size() != num_fields)
+    return false;
+  for (size_t i = 0; i < num_fields; i++) {
+    auto &field = i < plan.inline_fields.size()
+                      ? plan.inline_fields[i]
+                      : plan.offset_fields[i - plan.inline_fields.size()];
+    if (field.from != field.to || field.type != field.from_type ||
+        field.element != field.from_element || field.fill)
+      return false;
+    for (size_t j = 0; j < field.num_unions; j++) {
+      auto &union_type = union_types_[field.unions + j];
+      if (union_type.object != kNoPlan && union_type.type != j) return false;
+    }
+  }
+  return true;
+}
+
+void SchemaMigrator::FindUnchanged() {
+  for (size_t i = 0; i < plans_.size(); i++) {
+    plans_[i].unchanged = Unchanged(i);
+  }
+  // Tables referring to changed tables change too.
+  for (auto changed = true; changed;) {
+    changed = false;
+    for (auto pit = plans_.begin(); pit != plans_.end(); ++pit) {
+      if (!pit->unchanged) continue;
+      for (auto it = pit->offset_fields.begin();
+           it != pit->offset_fields.end() && pit->unchanged; ++it) {
+        if (it->object != kNoPlan && !plans_[it->object].unchanged)
+          pit->unchanged = false;
+        for (size_t j = 0; j < it->num_unions; j++) {
+          auto object = union_types_[it->unions + j].object;
+          if (object != kNoPlan && !plans_[object].unchanged)
+            pit->unchanged = false;
+        }
+      }
+      if (!pit->unchanged) changed = true;
+    }
+  }
+}
+
+Offset<const Table *> SchemaMigrator::Migrate(FlatBufferBuilder &fbb,
+                                              const Table &table) {
+  assert(ok());
+  return MigrateTable(fbb, copier_.object_, table);
+}
+
+void SchemaMigrator::MigrateBuffer(FlatBufferBuilder &fbb,
+                                   const uint8_t *buf) {
+  auto root = Migrate(fbb, *GetAnyRoot(buf));
+  auto file_ident = to_.file_ident();
+  fbb.Finish(root, file_ident && file_ident->size() ? file_ident->c_str()
+                                                    : nullptr);
+}
+
+struct MigrateContext {
+  const SchemaMigrator *migrator;
+  const uint8_t *const *buffers;
+  size_t count;
+  size_t run;
+  DetachedBuffer *migrated;
+};
+
+static void MigrateTask(void *context, size_t run) {
+  auto c = static_cast<MigrateContext *>(context);
+  // Migrators keep what they're working on, so each run needs its own.
+  SchemaMigrator migrator(*c->migrator);
+  auto last = (std::min)((run + 1) * c->run, c->count);
+  for (auto i = run * c->run; i < last; i++) {
+    // Builders hand over their allocator with the buffer.
+    FlatBufferBuilder fbb;
+    migrator.MigrateBuffer(fbb, c->buffers[i]);
+    c->migrated[i] = fbb.Release();
+  }
+}
+
+void SchemaMigrator::MigrateAll(const uint8_t *const *buffers, size_t count,
+                                std::vector<DetachedBuffer> *migrated,
+                                ParallelExecutor *executor,
+                                size_t run) const {
+  migrated->clear();
+  migrated->resize(count);
+  if (!count) return;
+  MigrateContext context = { this, buffers, count, run, &(*migrated)[0] };
+  auto num_runs = (count + run - 1) / run;
+  if (executor) {
+    executor->ParallelFor(num_runs, &MigrateTask, &context);
+  } else {
+    for (size_t i = 0; i < num_runs; i++) MigrateTask(&context, i);
+  }
+}
+
+const SchemaMigrator::UnionType *SchemaMigrator::GetUnionType(
+    const FieldPlan &field, uint8_t type) const {
+  return type < field.num_unions ? &union_types_[field.unions + type]
+                                 : nullptr;
+}
+
+uoffset_t SchemaMigrator::MigrateTable(FlatBufferBuilder &fbb, size_t object,
+                                       const Table &table) {
+  auto &plan = plans_[object];
+  if (plan.unchanged) return copier_.CopyTable(fbb, object, table);
+  auto base = offsets_.size();
+  for (auto it = plan.offset_fields.begin(); it != plan.offset_fields.end();
+       ++it) {
+    auto p = table.GetAddressOf(it->from);
+    auto offset =
+        p ? MigrateField(fbb, *it, table, p + ReadScalar<uoffset_t>(p)) : 0;
+    offsets_.push_back(offset);
+  }
+  auto start = fbb.StartTable();
+  auto &inline_fields = plan.inline_fields;
+  for (size_t i = 0; i <= inline_fields.size(); i++) {
+    if (i == plan.num_wide) {
+      for (size_t j = 0; j < plan.offset_fields.size(); j++) {
+        auto offset = offsets_[base + j];
+        if (offset)
+          fbb.AddOffset(plan.offset_fields[j].to, Offset<void>(offset));
+      }
+    }
+    if (i == inline_fields.size()) break;
+    auto &field = inline_fields[i];
+    auto p = table.GetAddressOf(field.from);
+    if (field.type == reflection::UType) {
+      auto union_type = p ? GetUnionType(field, ReadScalar<uint8_t>(p))
+                          : nullptr;
+      if (union_type && union_type->type)
+        fbb.TrackField(field.to, fbb.PushElement(union_type->type));
+      continue;
+    }
+    uint64_t value = 0;
+    if (!p) {
+      if (!field.fill) continue;
+      p = reinterpret_cast<const uint8_t *>(&field.fill_value);
+    } else if (field.type != field.from_type) {
+      p = ConvertScalar(field.type, field.from_type, p, &value);
+    }
+    fbb.Align(field.align);
+    fbb.PushBytes(p, field.size);
+    fbb.TrackField(field.to, fbb.GetSize());
+  }
+  offsets_.resize(base);
+  return fbb.EndTable(start);
+}
+
+uoffset_t SchemaMigrator::MigrateString(FlatBufferBuilder &fbb,
+                                        const uint8_t *ref) {
+  auto str = reinterpret_cast<const String *>(ref);
+  return use_string_pooling_ ? fbb.CreateSharedString(str).o
+                             : fbb.CreateString(str).o;
+}
+
+uoffset_t SchemaMigrator::MigrateField(FlatBufferBuilder &fbb,
+                                       const FieldPlan &field,
+                                       const Table &table,
+                                       const uint8_t *ref) {
+  switch (field.type) {
+    case reflection::String: return MigrateString(fbb, ref);
+    case reflection::Obj:
+      return MigrateTable(fbb, field.object,
+                          *reinterpret_cast<const Table *>(ref));
+    case reflection::Union: {
+      auto union_type =
+          GetUnionType(field, table.GetField<uint8_t>(field.union_type, 0));
+      if (!union_type || !union_type->type) return 0;
+      return MigrateTable(fbb, union_type->object,
+                          *reinterpret_cast<const Table *>(ref));
+    }
+    case reflection::Vector: return MigrateVector(fbb, field, ref);
+    default: assert(false); return 0;
+  }
+}
+
+uoffset_t SchemaMigrator::MigrateVector(FlatBufferBuilder &fbb,
+                                        const FieldPlan &field,
+                                        const uint8_t *ref) {
+  auto len = ReadScalar<uoffset_t>(ref);
+  auto elems = ref + sizeof(uoffset_t);
+  if (field.size) {  // Scalars and structs.
+    if (field.nested_flatbuffer)
+      fbb.ForceVectorAlignment(len, field.size, sizeof(largest_scalar_t));
+    fbb.StartVector(len * field.size / field.align, field.align);
+    if (field.element == field.from_element) {
+      fbb.PushBytes(elems, len * field.size);
+    } else {
+      for (auto i = len; i > 0;) {
+        uint64_t value = 0;
+        fbb.PushBytes(ConvertScalar(field.element, field.from_element,
+                                    elems + --i * field.from_size, &value),
+                      field.size);
+      }
+    }
+    return fbb.EndVector(len);
+  }
+  auto base = offsets_.size();
+  for (uoffset_t i = 0; i < len; i++) {
+    auto loc = elems + i * sizeof(uoffset_t);
+    auto elem = loc + ReadScalar<uoffset_t>(loc);
+    offsets_.push_back(
+        field.element == reflection::String
+            ? MigrateString(fbb, elem)
+            : MigrateTable(fbb, field.object,
+                           *reinterpret_cast<const Table *>(elem)));
+  }
+  fbb.StartVector(len, sizeof(uoffset_t));
+  for (auto i = len; i > 0;) {
+    fbb.PushElement(Offset<void>(offsets_[base + --i]));
+  }
+  offsets_.resize(base);
+  return fbb.EndVector(len);
+}
+
 bool VerifyStruct(flatbuffers::Verifier &v,
                   const flatbuffers::Table &parent_table,
                   voffset_t field_offset, const reflection::Object &obj,
@@ -592,6 +1645,11 @@ bool VerifyObject(flatbuffers::Verifier &v, const reflection::Schema &schema,
       return false;
   }
 
+  // clang-format off
+  #ifdef FLATBUFFERS_VERIFIER_STATS
+    v.SetNextTableType(obj.name()->c_str());
+  #endif
+  // clang-format on
   if (!table->VerifyTableStart(v)) return false;
 
   for (uoffset_t i = 0; i < obj.fields()->size(); i++) {
@@ -677,7 +1735,25 @@ bool VerifyObject(flatbuffers::Verifier &v, const reflection::Schema &schema,
 bool Verify(const reflection::Schema &schema, const reflection::Object &root,
             const uint8_t *buf, size_t length) {
   Verifier v(buf, length);
-  return VerifyObject(v, schema, root, flatbuffers::GetAnyRoot(buf), true);
+  return Verify(schema, root, buf, v);
+}
+
+bool Verify(const reflection::Schema &schema, const reflection::Object &root,
+            const uint8_t *buf, Verifier &v) {
+  // clang-format off
+  #ifdef FLATBUFFERS_VERIFIER_STATS
+    // Like the Verifier does for generated code, end the tables failing
+    // leaves behind in its statistics.
+    auto stats = v.GetStats();
+    auto stats_depth = stats ? stats->depth() : 0;
+    if (VerifyObject(v, schema, root, flatbuffers::GetAnyRoot(buf), true))
+      return true;
+    if (stats) stats->Unwind(stats_depth);
+    return false;
+  #else
+    return VerifyObject(v, schema, root, flatbuffers::GetAnyRoot(buf), true);
+  #endif
+  // clang-format on
 }
 
 }  // namespace flatbuffers
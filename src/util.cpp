@@ -16,6 +16,12 @@
 
 #include "flatbuffers/util.h"
 
+#ifndef _WIN32
+#  include <dirent.h>
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#endif
+
 namespace flatbuffers {
 
 bool FileExistsRaw(const char *name) {
@@ -43,8 +49,16 @@ bool LoadFileRaw(const char *name, bool binary, std::string *buf) {
   return !ifs.bad();
 }
 
+bool SaveFileRaw(const char *name, const char *buf, size_t len, bool binary) {
+  std::ofstream ofs(name, binary ? std::ofstream::binary : std::ofstream::out);
+  if (!ofs.is_open()) return false;
+  ofs.write(buf, len);
+  return !ofs.bad();
+}
+
 static LoadFileFunction g_load_file_function = LoadFileRaw;
 static FileExistsFunction g_file_exists_function = FileExistsRaw;
+static SaveFileFunction g_save_file_function = SaveFileRaw;
 
 bool LoadFile(const char *name, bool binary, std::string *buf) {
   assert(g_load_file_function);
@@ -56,6 +70,22 @@ bool FileExists(const char *name) {
   return g_file_exists_function(name);
 }
 
+bool SaveFile(const char *name, const char *buf, size_t len, bool binary) {
+  assert(g_save_file_function);
+  return g_save_file_function(name, buf, len, binary);
+}
+
+bool SaveFileIfChanged(const char *name, const char *buf, size_t len,
+                       bool binary) {
+  // Read in the same mode it would be written in, so text files compare
+  // equal regardless of the platform's line endings.
+  std::string old;
+  if (LoadFileRaw(name, binary, &old) && old.size() == len &&
+      !memcmp(old.c_str(), buf, len))
+    return true;
+  return SaveFileRaw(name, buf, len, binary);
+}
+
 bool DirExists(const char *name) {
   // clang-format off
   #ifdef _WIN32
@@ -71,6 +101,46 @@ bool DirExists(const char *name) {
   return (file_info.st_mode & FLATBUFFERS_S_IFDIR) != 0;
 }
 
+// Lists "dir", with "prefix" in front of the names it finds.
+static bool ListFilesIn(const std::string &dir, const std::string &prefix,
+                        std::vector<std::string> *files) {
+  std::vector<std::string> names;
+  // clang-format off
+  #ifdef _WIN32
+    WIN32_FIND_DATAA data;
+    auto find = FindFirstFileA(ConCatPathFileName(dir, "*").c_str(), &data);
+    if (find == INVALID_HANDLE_VALUE) return false;
+    do {
+      names.push_back(data.cFileName);
+    } while (FindNextFileA(find, &data));
+    FindClose(find);
+  #else
+    auto d = opendir(dir.c_str());
+    if (!d) return false;
+    while (auto entry = readdir(d)) names.push_back(entry->d_name);
+    closedir(d);
+  #endif
+  // clang-format on
+  for (auto it = names.begin(); it != names.end(); ++it) {
+    if (*it == "." || *it == "..") continue;
+    if (DirExists(ConCatPathFileName(dir, *it).c_str())) {
+      if (!ListFilesIn(ConCatPathFileName(dir, *it),
+                       prefix + *it + kPathSeparator, files))
+        return false;
+    } else {
+      files->push_back(prefix + *it);
+    }
+  }
+  return true;
+}
+
+bool ListFiles(const char *dir, std::vector<std::string> *files) {
+  auto start = files->size();
+  if (!ListFilesIn(PosixPath(dir), "", files)) return false;
+  std::sort(files->begin() + static_cast<ptrdiff_t>(start), files->end());
+  return true;
+}
+
 LoadFileFunction SetLoadFileFunction(LoadFileFunction load_file_function) {
   LoadFileFunction previous_function = g_load_file_function;
   g_load_file_function = load_file_function ? load_file_function : LoadFileRaw;
@@ -85,4 +155,99 @@ FileExistsFunction SetFileExistsFunction(
   return previous_function;
 }
 
+SaveFileFunction SetSaveFileFunction(SaveFileFunction save_file_function) {
+  SaveFileFunction previous_function = g_save_file_function;
+  g_save_file_function =
+      save_file_function ? save_file_function : SaveFileRaw;
+  return previous_function;
+}
+
+bool MappedBuffer::Map(const char *name) {
+  Unmap();
+  // clang-format off
+  #ifdef _WIN32
+    auto file = CreateFileA(name, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER file_size;
+    bool ok = GetFileSizeEx(file, &file_size) != 0 &&
+              static_cast<uint64_t>(file_size.QuadPart) <=
+                  static_cast<uint64_t>(SIZE_MAX);
+    if (ok && file_size.QuadPart) {
+      mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0,
+                                    nullptr);
+      if (mapping_) {
+        data_ = reinterpret_cast<const uint8_t *>(
+            MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+      }
+      ok = data_ != nullptr;
+      if (ok) size_ = static_cast<size_t>(file_size.QuadPart);
+    }
+    CloseHandle(file);
+    if (!ok) Unmap();
+    return ok;
+  #else
+    int fd;
+    do {
+      fd = open(name, O_RDONLY);
+    } while (fd < 0 && errno == EINTR);
+    if (fd < 0) return false;
+    struct stat file_info;
+    bool ok = fstat(fd, &file_info) == 0 && !S_ISDIR(file_info.st_mode) &&
+              static_cast<uint64_t>(file_info.st_size) <=
+                  static_cast<uint64_t>(SIZE_MAX);
+    if (ok && file_info.st_size) {
+      auto size = static_cast<size_t>(file_info.st_size);
+      auto addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      ok = addr != MAP_FAILED;
+      if (ok) {
+        data_ = reinterpret_cast<const uint8_t *>(addr);
+        size_ = size;
+      }
+    }
+    // The mapping keeps the file alive, the descriptor isn't needed anymore.
+    close(fd);
+    return ok;
+  #endif
+  // clang-format on
+}
+
+void MappedBuffer::Unmap() {
+  // clang-format off
+  #ifdef _WIN32
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_) CloseHandle(mapping_);
+    mapping_ = nullptr;
+  #else
+    if (data_) munmap(const_cast<uint8_t *>(data_), size_);
+  #endif
+  // clang-format on
+  data_ = nullptr;
+  size_ = 0;
+}
+
+bool MappedBuffer::Advise(Advice advice, size_t offset, size_t len) const {
+  if (offset >= size_) return false;
+  if (!len || len > size_ - offset) len = size_ - offset;
+  // clang-format off
+  #if defined(_WIN32) || !defined(POSIX_MADV_NORMAL)
+    (void)advice;
+    return false;
+  #else
+    // The start of the range has to be page aligned, data_ itself is.
+    static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    auto aligned = offset - offset % page_size;
+    int posix_advice = POSIX_MADV_NORMAL;
+    switch (advice) {
+      case kAdviceNormal: posix_advice = POSIX_MADV_NORMAL; break;
+      case kAdviceSequential: posix_advice = POSIX_MADV_SEQUENTIAL; break;
+      case kAdviceRandom: posix_advice = POSIX_MADV_RANDOM; break;
+      case kAdviceWillNeed: posix_advice = POSIX_MADV_WILLNEED; break;
+    }
+    return posix_madvise(const_cast<uint8_t *>(data_) + aligned,
+                         len + offset - aligned, posix_advice) == 0;
+  #endif
+  // clang-format on
+}
+
 }  // namespace flatbuffers
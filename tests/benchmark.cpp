@@ -0,0 +1,413 @@
+/*
+ * Copyright 2018 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Throughput benchmarks of the C++ library, to catch performance regressions
+// from one release to the next. Built with FLATBUFFERS_BUILD_BENCHMARKS.
+//
+// Usage: flatbenchmarks [--filter=SUBSTRING] [--min_time=SECONDS]
+//                       [--json=FILE]
+//
+// Runs every benchmark whose name contains SUBSTRING (all by default) for at
+// least SECONDS (0.5 by default), and prints a table of the results. With
+// --json, also writes them to FILE as JSON, for tools that compare runs.
+// Expects to be run from the root of the repository (or the build directory,
+// which has a copy of tests/).
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "flatbuffers/flatbuffers.h"
+#include "flatbuffers/flexbuffers.h"
+#include "flatbuffers/hash.h"
+#include "flatbuffers/idl.h"
+#include "flatbuffers/reflection.h"
+#include "flatbuffers/util.h"
+
+#include "monster_test_generated.h"
+
+using namespace MyGame::Example;
+
+namespace {
+
+std::string test_data_path = "tests/";
+
+// Keeps results alive, so the compiler can't drop the work leading to them.
+volatile size_t sink = 0;
+
+// A benchmark does one operation per call, and returns the number of bytes
+// it processed (to report throughput), or 0 if that makes no sense.
+typedef size_t (*BenchmarkFn)();
+
+struct Benchmark {
+  const char *name;
+  BenchmarkFn fn;
+};
+
+struct Result {
+  std::string name;
+  size_t iterations;
+  double ns_per_op;
+  size_t bytes_per_op;
+};
+
+// Shared inputs, set up once in main().
+flatbuffers::Parser *parser = nullptr;
+std::string json;
+std::vector<uint8_t> monster;  // monsterdata_test.json, as binary.
+std::vector<uint8_t> schema;   // monster_test.fbs, as binary schema.
+std::vector<uint8_t> flex;     // From FlexBuild().
+
+size_t BuildMonster(flatbuffers::FlatBufferBuilder &fbb) {
+  auto name = fbb.CreateString("MyMonster");
+  unsigned char inv_data[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+  auto inventory = fbb.CreateVector(inv_data, 10);
+  Test tests[] = { Test(10, 20), Test(30, 40) };
+  auto test4 = fbb.CreateVectorOfStructs(tests, 2);
+  flatbuffers::Offset<Monster> mlocs[3];
+  const char *names[] = { "Fred", "Barney", "Wilma" };
+  for (int i = 0; i < 3; i++) {
+    mlocs[i] = CreateMonster(fbb, nullptr, static_cast<int16_t>(100 * i), 150,
+                             fbb.CreateString(names[i]));
+  }
+  auto tables = fbb.CreateVectorOfSortedTables(mlocs, 3);
+  auto enemy = CreateMonster(fbb, nullptr, 150, 150, fbb.CreateString("Enemy"));
+  Vec3 pos(1, 2, 3, 0, Color_Red, Test(10, 20));
+  auto root = CreateMonster(fbb, &pos, 80, 150, name, inventory, Color_Blue,
+                            Any_Monster, enemy.Union(), test4, 0, tables);
+  FinishMonsterBuffer(fbb, root);
+  return fbb.GetSize();
+}
+
+// Building and finishing a monster_test table with nested tables, strings and
+// vectors, in a builder that's reused.
+size_t Build() {
+  static flatbuffers::FlatBufferBuilder fbb;
+  fbb.Clear();
+  return BuildMonster(fbb);
+}
+
+// The same with a new builder each time, so including its allocations.
+size_t BuildFresh() {
+  flatbuffers::FlatBufferBuilder fbb;
+  return BuildMonster(fbb);
+}
+
+size_t Verify() {
+  flatbuffers::Verifier verifier(monster.data(), monster.size());
+  sink += VerifyMonsterBuffer(verifier);
+  return monster.size();
+}
+
+// Read all of the commonly used fields.
+size_t Access() {
+  auto m = GetMonster(monster.data());
+  size_t sum = static_cast<size_t>(m->hp() + m->mana()) + m->name()->size();
+  sum += static_cast<size_t>(m->pos()->x());
+  if (m->inventory()) {
+    for (auto it = m->inventory()->begin(); it != m->inventory()->end(); ++it)
+      sum += *it;
+  }
+  if (m->testarrayoftables()) {
+    for (auto it = m->testarrayoftables()->begin();
+         it != m->testarrayoftables()->end(); ++it)
+      sum += it->name()->size();
+  }
+  sink += sum;
+  return monster.size();
+}
+
+size_t ParseJson() {
+  sink += parser->Parse(json.c_str());
+  return json.size();
+}
+
+size_t GenerateText() {
+  std::string text;
+  sink += flatbuffers::GenerateText(*parser, monster.data(), &text);
+  return text.size();
+}
+
+size_t FlexBuild(flexbuffers::Builder &fbb) {
+  fbb.Map([&]() {
+    fbb.Int("hp", 80);
+    fbb.Double("speed", 4.5);
+    fbb.String("name", "MyMonster");
+    fbb.Vector("inventory", [&]() {
+      for (int i = 0; i < 10; i++) fbb.UInt(static_cast<uint64_t>(i));
+    });
+    fbb.Vector("friends", [&]() {
+      const char *names[] = { "Fred", "Barney", "Wilma" };
+      for (int i = 0; i < 3; i++) {
+        fbb.Map([&]() {
+          fbb.String("name", names[i]);
+          fbb.Int("hp", 100 * i);
+        });
+      }
+    });
+  });
+  fbb.Finish();
+  return fbb.GetSize();
+}
+
+size_t FlexBuild() {
+  static flexbuffers::Builder fbb;
+  fbb.Clear();
+  return FlexBuild(fbb);
+}
+
+size_t FlexRead() {
+  auto map = flexbuffers::GetRoot(flex).AsMap();
+  size_t sum = static_cast<size_t>(map["hp"].AsInt64());
+  sum += static_cast<size_t>(map["speed"].AsDouble());
+  sum += map["name"].AsString().length();
+  auto inventory = map["inventory"].AsVector();
+  for (size_t i = 0; i < inventory.size(); i++)
+    sum += static_cast<size_t>(inventory[i].AsUInt64());
+  auto friends = map["friends"].AsVector();
+  for (size_t i = 0; i < friends.size(); i++)
+    sum += friends[i].AsMap()["name"].AsString().length();
+  sink += sum;
+  return flex.size();
+}
+
+size_t CopyTable() {
+  static flatbuffers::FlatBufferBuilder fbb;
+  fbb.Clear();
+  auto &s = *reflection::GetSchema(schema.data());
+  fbb.Finish(flatbuffers::CopyTable(fbb, s, *s.root_table(),
+                                    *flatbuffers::GetAnyRoot(monster.data())),
+             MonsterIdentifier());
+  return fbb.GetSize();
+}
+
+size_t TableCopierCopy() {
+  static flatbuffers::FlatBufferBuilder fbb;
+  auto &s = *reflection::GetSchema(schema.data());
+  static flatbuffers::TableCopier copier(s, *s.root_table());
+  fbb.Clear();
+  fbb.Finish(copier.Copy(fbb, *flatbuffers::GetAnyRoot(monster.data())),
+             MonsterIdentifier());
+  return fbb.GetSize();
+}
+
+size_t UnPack() {
+  MonsterT m;
+  GetMonster(monster.data())->UnPackTo(&m);
+  sink += m.name.size();
+  return monster.size();
+}
+
+size_t Pack() {
+  static MonsterT m;
+  if (m.name.empty()) GetMonster(monster.data())->UnPackTo(&m);
+  static flatbuffers::FlatBufferBuilder fbb;
+  fbb.Clear();
+  FinishMonsterBuffer(fbb, Monster::Pack(fbb, &m));
+  return fbb.GetSize();
+}
+
+// Identifiers to hash, each in an allocation of its own.
+struct Identifiers {
+  Identifiers() : bytes(0) {
+    for (int i = 0; i < 1000; i++) {
+      names.push_back("identifier_" + flatbuffers::NumToString(i * 7919));
+      bytes += names.back().size();
+    }
+    for (auto it = names.begin(); it != names.end(); ++it) {
+      strings.push_back(it->c_str());
+      lengths.push_back(it->size());
+    }
+    hashes.resize(names.size());
+  }
+  std::vector<std::string> names;
+  std::vector<const char *> strings;
+  std::vector<size_t> lengths;
+  std::vector<uint64_t> hashes;
+  size_t bytes;
+};
+
+size_t HashFnv1a() {
+  static Identifiers ids;
+  uint64_t h = 0;
+  for (auto it = ids.strings.begin(); it != ids.strings.end(); ++it)
+    h += flatbuffers::HashFnv1a<uint64_t>(*it);
+  sink += static_cast<size_t>(h);
+  return ids.bytes;
+}
+
+size_t HashXxHash64() {
+  static Identifiers ids;
+  uint64_t h = 0;
+  for (size_t i = 0; i < ids.strings.size(); i++)
+    h += flatbuffers::XxHash64::Hash(ids.strings[i], ids.lengths[i]);
+  sink += static_cast<size_t>(h);
+  return ids.bytes;
+}
+
+size_t HashXxHash64Batch() {
+  static Identifiers ids;
+  flatbuffers::XxHash64::HashBatch(flatbuffers::vector_data(ids.strings),
+                                   flatbuffers::vector_data(ids.lengths),
+                                   ids.strings.size(),
+                                   flatbuffers::vector_data(ids.hashes));
+  sink += static_cast<size_t>(ids.hashes[0]);
+  return ids.bytes;
+}
+
+const Benchmark benchmarks[] = {
+  { "builder/build", Build },
+  { "builder/build_fresh", BuildFresh },
+  { "verifier/verify", Verify },
+  { "access/read", Access },
+  { "parser/parse_json", ParseJson },
+  { "text/generate_text", GenerateText },
+  { "flexbuffers/build", FlexBuild },
+  { "flexbuffers/read", FlexRead },
+  { "reflection/copy_table", CopyTable },
+  { "reflection/table_copier", TableCopierCopy },
+  { "object_api/unpack", UnPack },
+  { "object_api/pack", Pack },
+  { "hash/fnv1a_64", HashFnv1a },
+  { "hash/xxhash_64", HashXxHash64 },
+  { "hash/xxhash_64_batch", HashXxHash64Batch },
+};
+
+// Runs `fn` in batches, doubling in size, until a batch takes at least
+// `min_time` seconds.
+Result Run(const Benchmark &benchmark, double min_time) {
+  typedef std::chrono::steady_clock Clock;
+  Result result;
+  result.name = benchmark.name;
+  result.bytes_per_op = benchmark.fn();  // Warm up.
+  for (size_t iterations = 1;; iterations *= 2) {
+    auto start = Clock::now();
+    for (size_t i = 0; i < iterations; i++) benchmark.fn();
+    double elapsed =
+        std::chrono::duration<double>(Clock::now() - start).count();
+    if (elapsed >= min_time || iterations >= (static_cast<size_t>(1) << 40)) {
+      result.iterations = iterations;
+      result.ns_per_op = elapsed * 1e9 / static_cast<double>(iterations);
+      return result;
+    }
+  }
+}
+
+double MegabytesPerSecond(const Result &result) {
+  return result.bytes_per_op
+             ? static_cast<double>(result.bytes_per_op) * 1e3 / result.ns_per_op
+             : 0;
+}
+
+bool WriteJson(const std::vector<Result> &results, const char *file_name) {
+  std::string out = "{\n  \"context\": {\n";
+  out += "    \"flatbuffers_version\": \"" +
+         flatbuffers::NumToString(FLATBUFFERS_VERSION_MAJOR) + "." +
+         flatbuffers::NumToString(FLATBUFFERS_VERSION_MINOR) + "." +
+         flatbuffers::NumToString(FLATBUFFERS_VERSION_REVISION) + "\"\n";
+  out += "  },\n  \"benchmarks\": [\n";
+  for (auto it = results.begin(); it != results.end(); ++it) {
+    out += "    {\"name\": \"" + it->name + "\", \"iterations\": " +
+           flatbuffers::NumToString(it->iterations) + ", \"ns_per_op\": " +
+           flatbuffers::FloatToString(it->ns_per_op, 2) +
+           ", \"bytes_per_op\": " + flatbuffers::NumToString(it->bytes_per_op) +
+           ", \"mb_per_s\": " +
+           flatbuffers::FloatToString(MegabytesPerSecond(*it), 2) + "}";
+    out += it + 1 != results.end() ? ",\n" : "\n";
+  }
+  out += "  ]\n}\n";
+  return flatbuffers::SaveFile(file_name, out, false);
+}
+
+bool Setup() {
+  std::string fbs;
+  if (!flatbuffers::LoadFile((test_data_path + "monster_test.fbs").c_str(),
+                             false, &fbs) ||
+      !flatbuffers::LoadFile((test_data_path + "monsterdata_test.json").c_str(),
+                             false, &json)) {
+    fprintf(stderr, "flatbenchmarks: can't load the test data in %s\n",
+            test_data_path.c_str());
+    return false;
+  }
+  auto include_test_path =
+      flatbuffers::ConCatPathFileName(test_data_path, "include_test");
+  const char *include_directories[] = { test_data_path.c_str(),
+                                        include_test_path.c_str(), nullptr };
+  static flatbuffers::Parser p;
+  parser = &p;
+  if (!parser->Parse(fbs.c_str(), include_directories)) {
+    fprintf(stderr, "flatbenchmarks: %s\n", parser->error_.c_str());
+    return false;
+  }
+  parser->Serialize();
+  schema.assign(parser->builder_.GetBufferPointer(),
+                parser->builder_.GetBufferPointer() +
+                    parser->builder_.GetSize());
+  if (!parser->Parse(json.c_str(), include_directories)) {
+    fprintf(stderr, "flatbenchmarks: %s\n", parser->error_.c_str());
+    return false;
+  }
+  monster.assign(parser->builder_.GetBufferPointer(),
+                 parser->builder_.GetBufferPointer() +
+                     parser->builder_.GetSize());
+  flexbuffers::Builder fbb;
+  FlexBuild(fbb);
+  flex = fbb.GetBuffer();
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, const char *argv[]) {
+  std::string filter;
+  std::string json_file;
+  double min_time = 0.5;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg.find("--filter=") == 0) {
+      filter = arg.substr(9);
+    } else if (arg.find("--min_time=") == 0) {
+      min_time = strtod(arg.c_str() + 11, nullptr);
+    } else if (arg.find("--json=") == 0) {
+      json_file = arg.substr(7);
+    } else {
+      fprintf(stderr, "flatbenchmarks: unknown argument: %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (!Setup()) return 1;
+
+  std::vector<Result> results;
+  printf("%-28s %12s %12s %10s\n", "benchmark", "iterations", "ns/op",
+         "MB/s");
+  for (size_t i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); i++) {
+    if (!filter.empty() &&
+        std::string(benchmarks[i].name).find(filter) == std::string::npos)
+      continue;
+    results.push_back(Run(benchmarks[i], min_time));
+    auto &result = results.back();
+    printf("%-28s %12zu %12.1f %10.1f\n", result.name.c_str(),
+           result.iterations, result.ns_per_op, MegabytesPerSecond(result));
+    fflush(stdout);
+  }
+  if (!json_file.empty() && !WriteJson(results, json_file.c_str())) {
+    fprintf(stderr, "flatbenchmarks: can't write %s\n", json_file.c_str());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,823 @@
+// automatically generated by the FlatBuffers compiler, do not modify
+
+
+#ifndef FLATBUFFERS_GENERATED_COLUMNARTEST_COLUMNAR_H_
+#define FLATBUFFERS_GENERATED_COLUMNARTEST_COLUMNAR_H_
+
+#include "flatbuffers/flatbuffers.h"
+
+namespace Columnar {
+
+struct Point;
+
+struct Reading;
+struct ReadingT;
+
+struct ReadingColumns;
+struct ReadingColumnsT;
+
+struct Log;
+struct LogT;
+
+inline flatbuffers::TypeTable *PointTypeTable();
+
+inline flatbuffers::TypeTable *ReadingTypeTable();
+
+inline flatbuffers::TypeTable *ReadingColumnsTypeTable();
+
+inline flatbuffers::TypeTable *LogTypeTable();
+
+enum Kind {
+  Kind_Unknown = 0,
+  Kind_Sensor = 1,
+  Kind_Actuator = 2,
+  Kind_MIN = Kind_Unknown,
+  Kind_MAX = Kind_Actuator
+};
+
+inline Kind (&EnumValuesKind())[3] {
+  static Kind values[] = {
+    Kind_Unknown,
+    Kind_Sensor,
+    Kind_Actuator
+  };
+  return values;
+}
+
+inline const char **EnumNamesKind() {
+  static const char *names[] = {
+    "Unknown",
+    "Sensor",
+    "Actuator",
+    nullptr
+  };
+  return names;
+}
+
+inline const char *EnumNameKind(Kind e) {
+  const size_t index = static_cast<int>(e);
+  return EnumNamesKind()[index];
+}
+
+MANUALLY_ALIGNED_STRUCT(4) Point FLATBUFFERS_FINAL_CLASS {
+ private:
+  float x_;
+  float y_;
+
+ public:
+  Point() {
+    memset(this, 0, sizeof(Point));
+  }
+  Point(float _x, float _y)
+      : x_(flatbuffers::EndianScalar(_x)),
+        y_(flatbuffers::EndianScalar(_y)) {
+  }
+  float x() const {
+    return flatbuffers::EndianScalar(x_);
+  }
+  void mutate_x(float _x) {
+    flatbuffers::WriteScalar(&x_, _x);
+  }
+  float y() const {
+    return flatbuffers::EndianScalar(y_);
+  }
+  void mutate_y(float _y) {
+    flatbuffers::WriteScalar(&y_, _y);
+  }
+};
+STRUCT_END(Point, 8);
+
+struct ReadingT : public flatbuffers::NativeTable {
+  typedef Reading TableType;
+  uint32_t id;
+  double value;
+  Kind kind;
+  bool valid;
+  std::string label;
+  flatbuffers::unique_ptr<Point> location;
+  ReadingT()
+      : id(0),
+        value(1.5),
+        kind(Kind_Sensor),
+        valid(true) {
+  }
+};
+
+struct Reading FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  typedef ReadingT NativeTableType;
+  static flatbuffers::TypeTable *MiniReflectTypeTable() {
+    return ReadingTypeTable();
+  }
+  enum {
+    VT_ID = 4,
+    VT_VALUE = 6,
+    VT_KIND = 10,
+    VT_VALID = 12,
+    VT_LABEL = 14,
+    VT_LOCATION = 16
+  };
+  uint32_t id() const {
+    return GetField<uint32_t>(VT_ID, 0);
+  }
+  bool mutate_id(uint32_t _id) {
+    return SetField<uint32_t>(VT_ID, _id, 0);
+  }
+  bool KeyCompareLessThan(const Reading *o) const {
+    return id() < o->id();
+  }
+  int KeyCompareWithValue(uint32_t val) const {
+    const auto key = id();
+    if (key < val) {
+      return -1;
+    } else if (key > val) {
+      return 1;
+    } else {
+      return 0;
+    }
+  }
+  double value() const {
+    return GetField<double>(VT_VALUE, 1.5);
+  }
+  bool mutate_value(double _value) {
+    return SetField<double>(VT_VALUE, _value, 1.5);
+  }
+  Kind kind() const {
+    return static_cast<Kind>(GetField<int8_t>(VT_KIND, 1));
+  }
+  bool mutate_kind(Kind _kind) {
+    return SetField<int8_t>(VT_KIND, static_cast<int8_t>(_kind), 1);
+  }
+  bool valid() const {
+    return GetField<uint8_t>(VT_VALID, 1) != 0;
+  }
+  bool mutate_valid(bool _valid) {
+    return SetField<uint8_t>(VT_VALID, static_cast<uint8_t>(_valid), 1);
+  }
+  const flatbuffers::String *label() const {
+    return GetPointer<const flatbuffers::String *>(VT_LABEL);
+  }
+  flatbuffers::String *mutable_label() {
+    return GetPointer<flatbuffers::String *>(VT_LABEL);
+  }
+  const Point *location() const {
+    return GetStruct<const Point *>(VT_LOCATION);
+  }
+  Point *mutable_location() {
+    return GetStruct<Point *>(VT_LOCATION);
+  }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<uint32_t>(verifier, VT_ID) &&
+           VerifyField<double>(verifier, VT_VALUE) &&
+           VerifyField<int8_t>(verifier, VT_KIND) &&
+           VerifyField<uint8_t>(verifier, VT_VALID) &&
+           VerifyOffset(verifier, VT_LABEL) &&
+           verifier.Verify(label()) &&
+           VerifyField<Point>(verifier, VT_LOCATION) &&
+           verifier.EndTable();
+  }
+  ReadingT *UnPack(const flatbuffers::resolver_function_t *_resolver = nullptr) const;
+  void UnPackTo(ReadingT *_o, const flatbuffers::resolver_function_t *_resolver = nullptr) const;
+  static flatbuffers::Offset<Reading> Pack(flatbuffers::FlatBufferBuilder &_fbb, const ReadingT* _o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
+};
+
+struct ReadingBuilder {
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  // The most the fields take up, padding included, if added
+  // in the order CreateReading() adds them.
+  enum {
+    kMaxInlineSize = 33,
+    kNumFields = 7
+  };
+  void add_id(uint32_t id) {
+    fbb_.AddElement<uint32_t>(Reading::VT_ID, id, 0);
+  }
+  void add_value(double value) {
+    fbb_.AddElement<double>(Reading::VT_VALUE, value, 1.5);
+  }
+  void add_kind(Kind kind) {
+    fbb_.AddElement<int8_t>(Reading::VT_KIND, static_cast<int8_t>(kind), 1);
+  }
+  void add_valid(bool valid) {
+    fbb_.AddElement<uint8_t>(Reading::VT_VALID, static_cast<uint8_t>(valid), 1);
+  }
+  void add_label(flatbuffers::Offset<flatbuffers::String> label) {
+    fbb_.AddOffset(Reading::VT_LABEL, label);
+  }
+  void add_location(const Point *location) {
+    fbb_.AddStruct(Reading::VT_LOCATION, location);
+  }
+  explicit ReadingBuilder(flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable(kMaxInlineSize, kNumFields);
+  }
+  ReadingBuilder &operator=(const ReadingBuilder &);
+  flatbuffers::Offset<Reading> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = flatbuffers::Offset<Reading>(end);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<Reading> CreateReading(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    uint32_t id = 0,
+    double value = 1.5,
+    Kind kind = Kind_Sensor,
+    bool valid = true,
+    flatbuffers::Offset<flatbuffers::String> label = 0,
+    const Point *location = 0) {
+  ReadingBuilder builder_(_fbb);
+  builder_.add_value(value);
+  builder_.add_location(location);
+  builder_.add_label(label);
+  builder_.add_id(id);
+  builder_.add_valid(valid);
+  builder_.add_kind(kind);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<Reading> CreateReadingDirect(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    uint32_t id = 0,
+    double value = 1.5,
+    Kind kind = Kind_Sensor,
+    bool valid = true,
+    const char *label = nullptr,
+    const Point *location = 0) {
+  return Columnar::CreateReading(
+      _fbb,
+      id,
+      value,
+      kind,
+      valid,
+      label ? _fbb.CreateString(label) : 0,
+      location);
+}
+
+flatbuffers::Offset<Reading> CreateReading(flatbuffers::FlatBufferBuilder &_fbb, const ReadingT *_o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
+
+struct ReadingColumnsT : public flatbuffers::NativeTable {
+  typedef ReadingColumns TableType;
+  std::vector<uint32_t> id;
+  std::vector<double> value;
+  std::vector<Kind> kind;
+  std::vector<bool> valid;
+  std::vector<std::string> label;
+  std::vector<Point> location;
+  ReadingColumnsT() {
+  }
+};
+
+/// The fields of Reading, stored column by column.
+struct ReadingColumns FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  typedef ReadingColumnsT NativeTableType;
+  static flatbuffers::TypeTable *MiniReflectTypeTable() {
+    return ReadingColumnsTypeTable();
+  }
+  enum {
+    VT_ID = 4,
+    VT_VALUE = 6,
+    VT_KIND = 10,
+    VT_VALID = 12,
+    VT_LABEL = 14,
+    VT_LOCATION = 16
+  };
+  const flatbuffers::Vector<uint32_t> *id() const {
+    return GetPointer<const flatbuffers::Vector<uint32_t> *>(VT_ID);
+  }
+  flatbuffers::Vector<uint32_t> *mutable_id() {
+    return GetPointer<flatbuffers::Vector<uint32_t> *>(VT_ID);
+  }
+  const flatbuffers::Vector<double> *value() const {
+    return GetPointer<const flatbuffers::Vector<double> *>(VT_VALUE);
+  }
+  flatbuffers::Vector<double> *mutable_value() {
+    return GetPointer<flatbuffers::Vector<double> *>(VT_VALUE);
+  }
+  const flatbuffers::Vector<int8_t> *kind() const {
+    return GetPointer<const flatbuffers::Vector<int8_t> *>(VT_KIND);
+  }
+  flatbuffers::Vector<int8_t> *mutable_kind() {
+    return GetPointer<flatbuffers::Vector<int8_t> *>(VT_KIND);
+  }
+  const flatbuffers::Vector<uint8_t> *valid() const {
+    return GetPointer<const flatbuffers::Vector<uint8_t> *>(VT_VALID);
+  }
+  flatbuffers::Vector<uint8_t> *mutable_valid() {
+    return GetPointer<flatbuffers::Vector<uint8_t> *>(VT_VALID);
+  }
+  const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *label() const {
+    return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *>(VT_LABEL);
+  }
+  flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *mutable_label() {
+    return GetPointer<flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *>(VT_LABEL);
+  }
+  const flatbuffers::Vector<const Point *> *location() const {
+    return GetPointer<const flatbuffers::Vector<const Point *> *>(VT_LOCATION);
+  }
+  flatbuffers::Vector<const Point *> *mutable_location() {
+    return GetPointer<flatbuffers::Vector<const Point *> *>(VT_LOCATION);
+  }
+  // Row i of this table, with the accessors of Reading.
+  struct Row {
+    const ReadingColumns *columns_;
+    flatbuffers::uoffset_t i_;
+    uint32_t id() const {
+      auto column = columns_->id();
+      return column && i_ < column->size() ? column->Get(i_) : 0;
+    }
+    double value() const {
+      auto column = columns_->value();
+      return column && i_ < column->size() ? column->Get(i_) : 1.5;
+    }
+    Kind kind() const {
+      auto column = columns_->kind();
+      return column && i_ < column->size() ? static_cast<Kind>(column->Get(i_)) : Kind_Sensor;
+    }
+    bool valid() const {
+      auto column = columns_->valid();
+      return column && i_ < column->size() ? column->Get(i_) != 0 : true;
+    }
+    const flatbuffers::String *label() const {
+      auto column = columns_->label();
+      return column && i_ < column->size() ? column->Get(i_) : nullptr;
+    }
+    const Point *location() const {
+      auto column = columns_->location();
+      return column && i_ < column->size() ? column->Get(i_) : nullptr;
+    }
+  };
+  flatbuffers::uoffset_t GetRowCount() const {
+    flatbuffers::uoffset_t rows = 0;
+    if (id() && id()->size() > rows) rows = id()->size();
+    if (value() && value()->size() > rows) rows = value()->size();
+    if (kind() && kind()->size() > rows) rows = kind()->size();
+    if (valid() && valid()->size() > rows) rows = valid()->size();
+    if (label() && label()->size() > rows) rows = label()->size();
+    if (location() && location()->size() > rows) rows = location()->size();
+    return rows;
+  }
+  Row GetRow(flatbuffers::uoffset_t i) const {
+    Row row = { this, i };
+    return row;
+  }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyOffset(verifier, VT_ID) &&
+           verifier.Verify(id()) &&
+           VerifyOffset(verifier, VT_VALUE) &&
+           verifier.Verify(value()) &&
+           VerifyOffset(verifier, VT_KIND) &&
+           verifier.Verify(kind()) &&
+           VerifyOffset(verifier, VT_VALID) &&
+           verifier.Verify(valid()) &&
+           VerifyOffset(verifier, VT_LABEL) &&
+           verifier.Verify(label()) &&
+           verifier.VerifyVectorOfStrings(label()) &&
+           VerifyOffset(verifier, VT_LOCATION) &&
+           verifier.Verify(location()) &&
+           verifier.EndTable();
+  }
+  ReadingColumnsT *UnPack(const flatbuffers::resolver_function_t *_resolver = nullptr) const;
+  void UnPackTo(ReadingColumnsT *_o, const flatbuffers::resolver_function_t *_resolver = nullptr) const;
+  static flatbuffers::Offset<ReadingColumns> Pack(flatbuffers::FlatBufferBuilder &_fbb, const ReadingColumnsT* _o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
+};
+
+struct ReadingColumnsBuilder {
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  // The most the fields take up, padding included, if added
+  // in the order CreateReadingColumns() adds them.
+  enum {
+    kMaxInlineSize = 27,
+    kNumFields = 7
+  };
+  void add_id(flatbuffers::Offset<flatbuffers::Vector<uint32_t>> id) {
+    fbb_.AddOffset(ReadingColumns::VT_ID, id);
+  }
+  void add_value(flatbuffers::Offset<flatbuffers::Vector<double>> value) {
+    fbb_.AddOffset(ReadingColumns::VT_VALUE, value);
+  }
+  void add_kind(flatbuffers::Offset<flatbuffers::Vector<int8_t>> kind) {
+    fbb_.AddOffset(ReadingColumns::VT_KIND, kind);
+  }
+  void add_valid(flatbuffers::Offset<flatbuffers::Vector<uint8_t>> valid) {
+    fbb_.AddOffset(ReadingColumns::VT_VALID, valid);
+  }
+  void add_label(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>> label) {
+    fbb_.AddOffset(ReadingColumns::VT_LABEL, label);
+  }
+  void add_location(flatbuffers::Offset<flatbuffers::Vector<const Point *>> location) {
+    fbb_.AddOffset(ReadingColumns::VT_LOCATION, location);
+  }
+  explicit ReadingColumnsBuilder(flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable(kMaxInlineSize, kNumFields);
+  }
+  ReadingColumnsBuilder &operator=(const ReadingColumnsBuilder &);
+  flatbuffers::Offset<ReadingColumns> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = flatbuffers::Offset<ReadingColumns>(end);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<ReadingColumns> CreateReadingColumns(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    flatbuffers::Offset<flatbuffers::Vector<uint32_t>> id = 0,
+    flatbuffers::Offset<flatbuffers::Vector<double>> value = 0,
+    flatbuffers::Offset<flatbuffers::Vector<int8_t>> kind = 0,
+    flatbuffers::Offset<flatbuffers::Vector<uint8_t>> valid = 0,
+    flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>> label = 0,
+    flatbuffers::Offset<flatbuffers::Vector<const Point *>> location = 0) {
+  ReadingColumnsBuilder builder_(_fbb);
+  builder_.add_location(location);
+  builder_.add_label(label);
+  builder_.add_valid(valid);
+  builder_.add_kind(kind);
+  builder_.add_value(value);
+  builder_.add_id(id);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<ReadingColumns> CreateReadingColumnsDirect(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    const std::vector<uint32_t> *id = nullptr,
+    const std::vector<double> *value = nullptr,
+    const std::vector<int8_t> *kind = nullptr,
+    const std::vector<uint8_t> *valid = nullptr,
+    const std::vector<flatbuffers::Offset<flatbuffers::String>> *label = nullptr,
+    const std::vector<Point> *location = nullptr) {
+  return Columnar::CreateReadingColumns(
+      _fbb,
+      id ? _fbb.CreateVector<uint32_t>(*id) : 0,
+      value ? _fbb.CreateVector<double>(*value) : 0,
+      kind ? _fbb.CreateVector<int8_t>(*kind) : 0,
+      valid ? _fbb.CreateVector<uint8_t>(*valid) : 0,
+      label ? _fbb.CreateVector<flatbuffers::Offset<flatbuffers::String>>(*label) : 0,
+      location ? _fbb.CreateVectorOfStructs<Point>(*location) : 0);
+}
+
+flatbuffers::Offset<ReadingColumns> CreateReadingColumns(flatbuffers::FlatBufferBuilder &_fbb, const ReadingColumnsT *_o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
+
+struct LogT : public flatbuffers::NativeTable {
+  typedef Log TableType;
+  flatbuffers::unique_ptr<ReadingColumnsT> readings;
+  std::vector<flatbuffers::unique_ptr<ReadingT>> rows;
+  LogT() {
+  }
+};
+
+struct Log FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  typedef LogT NativeTableType;
+  static flatbuffers::TypeTable *MiniReflectTypeTable() {
+    return LogTypeTable();
+  }
+  enum {
+    VT_READINGS = 4,
+    VT_ROWS = 6
+  };
+  const ReadingColumns *readings() const {
+    return GetPointer<const ReadingColumns *>(VT_READINGS);
+  }
+  ReadingColumns *mutable_readings() {
+    return GetPointer<ReadingColumns *>(VT_READINGS);
+  }
+  const flatbuffers::Vector<flatbuffers::Offset<Reading>> *rows() const {
+    return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<Reading>> *>(VT_ROWS);
+  }
+  flatbuffers::Vector<flatbuffers::Offset<Reading>> *mutable_rows() {
+    return GetPointer<flatbuffers::Vector<flatbuffers::Offset<Reading>> *>(VT_ROWS);
+  }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyOffset(verifier, VT_READINGS) &&
+           verifier.VerifyTable(readings()) &&
+           VerifyOffset(verifier, VT_ROWS) &&
+           verifier.Verify(rows()) &&
+           verifier.VerifyVectorOfTables(rows()) &&
+           verifier.EndTable();
+  }
+  LogT *UnPack(const flatbuffers::resolver_function_t *_resolver = nullptr) const;
+  void UnPackTo(LogT *_o, const flatbuffers::resolver_function_t *_resolver = nullptr) const;
+  static flatbuffers::Offset<Log> Pack(flatbuffers::FlatBufferBuilder &_fbb, const LogT* _o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
+};
+
+struct LogBuilder {
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  // The most the fields take up, padding included, if added
+  // in the order CreateLog() adds them.
+  enum {
+    kMaxInlineSize = 11,
+    kNumFields = 2
+  };
+  void add_readings(flatbuffers::Offset<ReadingColumns> readings) {
+    fbb_.AddOffset(Log::VT_READINGS, readings);
+  }
+  void add_rows(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<Reading>>> rows) {
+    fbb_.AddOffset(Log::VT_ROWS, rows);
+  }
+  explicit LogBuilder(flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable(kMaxInlineSize, kNumFields);
+  }
+  LogBuilder &operator=(const LogBuilder &);
+  flatbuffers::Offset<Log> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = flatbuffers::Offset<Log>(end);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<Log> CreateLog(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    flatbuffers::Offset<ReadingColumns> readings = 0,
+    flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<Reading>>> rows = 0) {
+  LogBuilder builder_(_fbb);
+  builder_.add_rows(rows);
+  builder_.add_readings(readings);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<Log> CreateLogDirect(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    flatbuffers::Offset<ReadingColumns> readings = 0,
+    const std::vector<flatbuffers::Offset<Reading>> *rows = nullptr) {
+  return Columnar::CreateLog(
+      _fbb,
+      readings,
+      rows ? _fbb.CreateVector<flatbuffers::Offset<Reading>>(*rows) : 0);
+}
+
+flatbuffers::Offset<Log> CreateLog(flatbuffers::FlatBufferBuilder &_fbb, const LogT *_o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
+
+inline ReadingT *Reading::UnPack(const flatbuffers::resolver_function_t *_resolver) const {
+  auto _o = new ReadingT();
+  UnPackTo(_o, _resolver);
+  return _o;
+}
+
+inline void Reading::UnPackTo(ReadingT *_o, const flatbuffers::resolver_function_t *_resolver) const {
+  (void)_o;
+  (void)_resolver;
+  { auto _e = id(); _o->id = _e; };
+  { auto _e = value(); _o->value = _e; };
+  { auto _e = kind(); _o->kind = _e; };
+  { auto _e = valid(); _o->valid = _e; };
+  { auto _e = label(); if (_e) { _o->label.assign(_e->c_str(), _e->size()); } else _o->label.clear(); };
+  { auto _e = location(); if (_e) { if (_o->location) *_o->location = *_e; else _o->location = flatbuffers::unique_ptr<Point>(new Point(*_e)); } else _o->location.reset(); };
+}
+
+inline flatbuffers::Offset<Reading> Reading::Pack(flatbuffers::FlatBufferBuilder &_fbb, const ReadingT* _o, const flatbuffers::rehasher_function_t *_rehasher) {
+  return CreateReading(_fbb, _o, _rehasher);
+}
+
+inline flatbuffers::Offset<Reading> CreateReading(flatbuffers::FlatBufferBuilder &_fbb, const ReadingT *_o, const flatbuffers::rehasher_function_t *_rehasher) {
+  (void)_rehasher;
+  (void)_o;
+  struct _VectorArgs { flatbuffers::FlatBufferBuilder *__fbb; const ReadingT* __o; const flatbuffers::rehasher_function_t *__rehasher; } _va = { &_fbb, _o, _rehasher}; (void)_va;
+  auto _id = _o->id;
+  auto _value = _o->value;
+  auto _kind = _o->kind;
+  auto _valid = _o->valid;
+  auto _label = _o->label.empty() ? 0 : _fbb.CreateString(_o->label);
+  auto _location = _o->location ? _o->location.get() : 0;
+  return Columnar::CreateReading(
+      _fbb,
+      _id,
+      _value,
+      _kind,
+      _valid,
+      _label,
+      _location);
+}
+
+inline ReadingColumnsT *ReadingColumns::UnPack(const flatbuffers::resolver_function_t *_resolver) const {
+  auto _o = new ReadingColumnsT();
+  UnPackTo(_o, _resolver);
+  return _o;
+}
+
+inline void ReadingColumns::UnPackTo(ReadingColumnsT *_o, const flatbuffers::resolver_function_t *_resolver) const {
+  (void)_o;
+  (void)_resolver;
+  { auto _e = id(); if (_e) { _o->id.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->id[_i] = _e->Get(_i); } } else _o->id.clear(); };
+  { auto _e = value(); if (_e) { _o->value.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->value[_i] = _e->Get(_i); } } else _o->value.clear(); };
+  { auto _e = kind(); if (_e) { _o->kind.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->kind[_i] = (Kind)_e->Get(_i); } } else _o->kind.clear(); };
+  { auto _e = valid(); if (_e) { _o->valid.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->valid[_i] = _e->Get(_i) != 0; } } else _o->valid.clear(); };
+  { auto _e = label(); if (_e) { _o->label.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->label[_i].assign(_e->Get(_i)->c_str(), _e->Get(_i)->size()); } } else _o->label.clear(); };
+  { auto _e = location(); if (_e) { _o->location.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->location[_i] = *_e->Get(_i); } } else _o->location.clear(); };
+}
+
+inline flatbuffers::Offset<ReadingColumns> ReadingColumns::Pack(flatbuffers::FlatBufferBuilder &_fbb, const ReadingColumnsT* _o, const flatbuffers::rehasher_function_t *_rehasher) {
+  return CreateReadingColumns(_fbb, _o, _rehasher);
+}
+
+inline flatbuffers::Offset<ReadingColumns> CreateReadingColumns(flatbuffers::FlatBufferBuilder &_fbb, const ReadingColumnsT *_o, const flatbuffers::rehasher_function_t *_rehasher) {
+  (void)_rehasher;
+  (void)_o;
+  struct _VectorArgs { flatbuffers::FlatBufferBuilder *__fbb; const ReadingColumnsT* __o; const flatbuffers::rehasher_function_t *__rehasher; } _va = { &_fbb, _o, _rehasher}; (void)_va;
+  auto _id = _o->id.size() ? _fbb.CreateVector(_o->id) : 0;
+  auto _value = _o->value.size() ? _fbb.CreateVector(_o->value) : 0;
+  auto _kind = _o->kind.size() ? _fbb.CreateVector((const int8_t*)_o->kind.data(), _o->kind.size()) : 0;
+  auto _valid = _o->valid.size() ? _fbb.CreateVector(_o->valid) : 0;
+  auto _label = _o->label.size() ? _fbb.CreateVectorOfStrings(_o->label) : 0;
+  auto _location = _o->location.size() ? _fbb.CreateVectorOfStructs(_o->location) : 0;
+  return Columnar::CreateReadingColumns(
+      _fbb,
+      _id,
+      _value,
+      _kind,
+      _valid,
+      _label,
+      _location);
+}
+
+inline LogT *Log::UnPack(const flatbuffers::resolver_function_t *_resolver) const {
+  auto _o = new LogT();
+  UnPackTo(_o, _resolver);
+  return _o;
+}
+
+inline void Log::UnPackTo(LogT *_o, const flatbuffers::resolver_function_t *_resolver) const {
+  (void)_o;
+  (void)_resolver;
+  { auto _e = readings(); if (_e) { if (_o->readings) _e->UnPackTo(_o->readings.get(), _resolver); else _o->readings = flatbuffers::unique_ptr<ReadingColumnsT>(_e->UnPack(_resolver)); } else _o->readings.reset(); };
+  { auto _e = rows(); if (_e) { _o->rows.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { if (_o->rows[_i]) _e->Get(_i)->UnPackTo(_o->rows[_i].get(), _resolver); else _o->rows[_i] = flatbuffers::unique_ptr<ReadingT>(_e->Get(_i)->UnPack(_resolver)); } } else _o->rows.clear(); };
+}
+
+inline flatbuffers::Offset<Log> Log::Pack(flatbuffers::FlatBufferBuilder &_fbb, const LogT* _o, const flatbuffers::rehasher_function_t *_rehasher) {
+  return CreateLog(_fbb, _o, _rehasher);
+}
+
+inline flatbuffers::Offset<Log> CreateLog(flatbuffers::FlatBufferBuilder &_fbb, const LogT *_o, const flatbuffers::rehasher_function_t *_rehasher) {
+  (void)_rehasher;
+  (void)_o;
+  struct _VectorArgs { flatbuffers::FlatBufferBuilder *__fbb; const LogT* __o; const flatbuffers::rehasher_function_t *__rehasher; } _va = { &_fbb, _o, _rehasher}; (void)_va;
+  auto _readings = _o->readings ? CreateReadingColumns(_fbb, _o->readings.get(), _rehasher) : 0;
+  auto _rows = _o->rows.size() ? _fbb.CreateVector<flatbuffers::Offset<Reading>> (_o->rows.size(), [](size_t i, _VectorArgs *__va) { return CreateReading(*__va->__fbb, __va->__o->rows[i].get(), __va->__rehasher); }, &_va ) : 0;
+  return Columnar::CreateLog(
+      _fbb,
+      _readings,
+      _rows);
+}
+
+inline flatbuffers::TypeTable *KindTypeTable() {
+  static flatbuffers::TypeCode type_codes[] = {
+    { flatbuffers::ET_CHAR, 0, 0 },
+    { flatbuffers::ET_CHAR, 0, 0 },
+    { flatbuffers::ET_CHAR, 0, 0 }
+  };
+  static flatbuffers::TypeFunction type_refs[] = {
+    KindTypeTable
+  };
+  static const char *names[] = {
+    "Unknown",
+    "Sensor",
+    "Actuator"
+  };
+  static flatbuffers::TypeTable tt = {
+    flatbuffers::ST_ENUM, 3, type_codes, type_refs, nullptr, names
+  };
+  return &tt;
+}
+
+inline flatbuffers::TypeTable *PointTypeTable() {
+  static flatbuffers::TypeCode type_codes[] = {
+    { flatbuffers::ET_FLOAT, 0, -1 },
+    { flatbuffers::ET_FLOAT, 0, -1 }
+  };
+  static const int32_t values[] = { 0, 4, 8 };
+  static const char *names[] = {
+    "x",
+    "y"
+  };
+  static flatbuffers::TypeTable tt = {
+    flatbuffers::ST_STRUCT, 2, type_codes, nullptr, values, names
+  };
+  return &tt;
+}
+
+inline flatbuffers::TypeTable *ReadingTypeTable() {
+  static flatbuffers::TypeCode type_codes[] = {
+    { flatbuffers::ET_UINT, 0, -1 },
+    { flatbuffers::ET_DOUBLE, 0, -1 },
+    { flatbuffers::ET_INT, 0, -1 },
+    { flatbuffers::ET_CHAR, 0, 0 },
+    { flatbuffers::ET_BOOL, 0, -1 },
+    { flatbuffers::ET_STRING, 0, -1 },
+    { flatbuffers::ET_SEQUENCE, 0, 1 }
+  };
+  static flatbuffers::TypeFunction type_refs[] = {
+    KindTypeTable,
+    PointTypeTable
+  };
+  static const char *names[] = {
+    "id",
+    "value",
+    "old",
+    "kind",
+    "valid",
+    "label",
+    "location"
+  };
+  static flatbuffers::TypeTable tt = {
+    flatbuffers::ST_TABLE, 7, type_codes, type_refs, nullptr, names
+  };
+  return &tt;
+}
+
+inline flatbuffers::TypeTable *ReadingColumnsTypeTable() {
+  static flatbuffers::TypeCode type_codes[] = {
+    { flatbuffers::ET_UINT, 1, -1 },
+    { flatbuffers::ET_DOUBLE, 1, -1 },
+    { flatbuffers::ET_INT, 1, -1 },
+    { flatbuffers::ET_CHAR, 1, 0 },
+    { flatbuffers::ET_BOOL, 1, -1 },
+    { flatbuffers::ET_STRING, 1, -1 },
+    { flatbuffers::ET_SEQUENCE, 1, 1 }
+  };
+  static flatbuffers::TypeFunction type_refs[] = {
+    KindTypeTable,
+    PointTypeTable
+  };
+  static const char *names[] = {
+    "id",
+    "value",
+    "old",
+    "kind",
+    "valid",
+    "label",
+    "location"
+  };
+  static flatbuffers::TypeTable tt = {
+    flatbuffers::ST_TABLE, 7, type_codes, type_refs, nullptr, names
+  };
+  return &tt;
+}
+
+inline flatbuffers::TypeTable *LogTypeTable() {
+  static flatbuffers::TypeCode type_codes[] = {
+    { flatbuffers::ET_SEQUENCE, 0, 0 },
+    { flatbuffers::ET_SEQUENCE, 1, 1 }
+  };
+  static flatbuffers::TypeFunction type_refs[] = {
+    ReadingColumnsTypeTable,
+    ReadingTypeTable
+  };
+  static const char *names[] = {
+    "readings",
+    "rows"
+  };
+  static flatbuffers::TypeTable tt = {
+    flatbuffers::ST_TABLE, 2, type_codes, type_refs, nullptr, names
+  };
+  return &tt;
+}
+
+inline const Columnar::Log *GetLog(const void *buf) {
+  return flatbuffers::GetRoot<Columnar::Log>(buf);
+}
+
+inline const Columnar::Log *GetSizePrefixedLog(const void *buf) {
+  return flatbuffers::GetSizePrefixedRoot<Columnar::Log>(buf);
+}
+
+inline Log *GetMutableLog(void *buf) {
+  return flatbuffers::GetMutableRoot<Log>(buf);
+}
+
+inline bool VerifyLogBuffer(
+    flatbuffers::Verifier &verifier) {
+  return verifier.VerifyBuffer<Columnar::Log>(nullptr);
+}
+
+inline bool VerifySizePrefixedLogBuffer(
+    flatbuffers::Verifier &verifier) {
+  return verifier.VerifySizePrefixedBuffer<Columnar::Log>(nullptr);
+}
+
+inline void FinishLogBuffer(
+    flatbuffers::FlatBufferBuilder &fbb,
+    flatbuffers::Offset<Columnar::Log> root) {
+  fbb.Finish(root);
+}
+
+inline void FinishSizePrefixedLogBuffer(
+    flatbuffers::FlatBufferBuilder &fbb,
+    flatbuffers::Offset<Columnar::Log> root) {
+  fbb.FinishSizePrefixed(root);
+}
+
+inline flatbuffers::unique_ptr<LogT> UnPackLog(
+    const void *buf,
+    const flatbuffers::resolver_function_t *res = nullptr) {
+  return flatbuffers::unique_ptr<LogT>(GetLog(buf)->UnPack(res));
+}
+
+}  // namespace Columnar
+
+#endif  // FLATBUFFERS_GENERATED_COLUMNARTEST_COLUMNAR_H_
@@ -0,0 +1,572 @@
+// automatically generated by the FlatBuffers compiler, do not modify
+
+
+#ifndef FLATBUFFERS_GENERATED_HASHINDEXTEST_HASHINDEX_H_
+#define FLATBUFFERS_GENERATED_HASHINDEXTEST_HASHINDEX_H_
+
+#include "flatbuffers/flatbuffers.h"
+#include "flatbuffers/hash.h"
+
+namespace HashIndex {
+
+struct Route;
+struct RouteT;
+
+struct Host;
+struct HostT;
+
+struct RoutingTable;
+struct RoutingTableT;
+
+inline flatbuffers::TypeTable *RouteTypeTable();
+
+inline flatbuffers::TypeTable *HostTypeTable();
+
+inline flatbuffers::TypeTable *RoutingTableTypeTable();
+
+struct RouteT : public flatbuffers::NativeTable {
+  typedef Route TableType;
+  std::string prefix;
+  uint16_t port;
+  RouteT()
+      : port(0) {
+  }
+};
+
+struct Route FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  typedef RouteT NativeTableType;
+  static flatbuffers::TypeTable *MiniReflectTypeTable() {
+    return RouteTypeTable();
+  }
+  enum {
+    VT_PREFIX = 4,
+    VT_PORT = 6
+  };
+  const flatbuffers::String *prefix() const {
+    return GetPointer<const flatbuffers::String *>(VT_PREFIX);
+  }
+  flatbuffers::String *mutable_prefix() {
+    return GetPointer<flatbuffers::String *>(VT_PREFIX);
+  }
+  bool KeyCompareLessThan(const Route *o) const {
+    return *prefix() < *o->prefix();
+  }
+  int KeyCompareWithValue(const char *val) const {
+    return strcmp(prefix()->c_str(), val);
+  }
+  uint16_t port() const {
+    return GetField<uint16_t>(VT_PORT, 0);
+  }
+  bool mutate_port(uint16_t _port) {
+    return SetField<uint16_t>(VT_PORT, _port, 0);
+  }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyOffsetRequired(verifier, VT_PREFIX) &&
+           verifier.Verify(prefix()) &&
+           VerifyField<uint16_t>(verifier, VT_PORT) &&
+           verifier.EndTable();
+  }
+  RouteT *UnPack(const flatbuffers::resolver_function_t *_resolver = nullptr) const;
+  void UnPackTo(RouteT *_o, const flatbuffers::resolver_function_t *_resolver = nullptr) const;
+  static flatbuffers::Offset<Route> Pack(flatbuffers::FlatBufferBuilder &_fbb, const RouteT* _o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
+};
+
+struct RouteBuilder {
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  // The most the fields take up, padding included, if added
+  // in the order CreateRoute() adds them.
+  enum {
+    kMaxInlineSize = 9,
+    kNumFields = 2
+  };
+  void add_prefix(flatbuffers::Offset<flatbuffers::String> prefix) {
+    fbb_.AddOffset(Route::VT_PREFIX, prefix);
+  }
+  void add_port(uint16_t port) {
+    fbb_.AddElement<uint16_t>(Route::VT_PORT, port, 0);
+  }
+  explicit RouteBuilder(flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable(kMaxInlineSize, kNumFields);
+  }
+  RouteBuilder &operator=(const RouteBuilder &);
+  flatbuffers::Offset<Route> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = flatbuffers::Offset<Route>(end);
+    fbb_.Required(o, Route::VT_PREFIX);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<Route> CreateRoute(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    flatbuffers::Offset<flatbuffers::String> prefix = 0,
+    uint16_t port = 0) {
+  RouteBuilder builder_(_fbb);
+  builder_.add_prefix(prefix);
+  builder_.add_port(port);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<Route> CreateRouteDirect(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    const char *prefix = nullptr,
+    uint16_t port = 0) {
+  return HashIndex::CreateRoute(
+      _fbb,
+      prefix ? _fbb.CreateString(prefix) : 0,
+      port);
+}
+
+flatbuffers::Offset<Route> CreateRoute(flatbuffers::FlatBufferBuilder &_fbb, const RouteT *_o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
+
+struct HostT : public flatbuffers::NativeTable {
+  typedef Host TableType;
+  int64_t id;
+  std::string name;
+  HostT()
+      : id(0) {
+  }
+};
+
+struct Host FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  typedef HostT NativeTableType;
+  static flatbuffers::TypeTable *MiniReflectTypeTable() {
+    return HostTypeTable();
+  }
+  enum {
+    VT_ID = 4,
+    VT_NAME = 6
+  };
+  int64_t id() const {
+    return GetField<int64_t>(VT_ID, 0);
+  }
+  bool mutate_id(int64_t _id) {
+    return SetField<int64_t>(VT_ID, _id, 0);
+  }
+  bool KeyCompareLessThan(const Host *o) const {
+    return id() < o->id();
+  }
+  int KeyCompareWithValue(int64_t val) const {
+    const auto key = id();
+    if (key < val) {
+      return -1;
+    } else if (key > val) {
+      return 1;
+    } else {
+      return 0;
+    }
+  }
+  const flatbuffers::String *name() const {
+    return GetPointer<const flatbuffers::String *>(VT_NAME);
+  }
+  flatbuffers::String *mutable_name() {
+    return GetPointer<flatbuffers::String *>(VT_NAME);
+  }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<int64_t>(verifier, VT_ID) &&
+           VerifyOffset(verifier, VT_NAME) &&
+           verifier.Verify(name()) &&
+           verifier.EndTable();
+  }
+  HostT *UnPack(const flatbuffers::resolver_function_t *_resolver = nullptr) const;
+  void UnPackTo(HostT *_o, const flatbuffers::resolver_function_t *_resolver = nullptr) const;
+  static flatbuffers::Offset<Host> Pack(flatbuffers::FlatBufferBuilder &_fbb, const HostT* _o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
+};
+
+struct HostBuilder {
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  // The most the fields take up, padding included, if added
+  // in the order CreateHost() adds them.
+  enum {
+    kMaxInlineSize = 19,
+    kNumFields = 2
+  };
+  void add_id(int64_t id) {
+    fbb_.AddElement<int64_t>(Host::VT_ID, id, 0);
+  }
+  void add_name(flatbuffers::Offset<flatbuffers::String> name) {
+    fbb_.AddOffset(Host::VT_NAME, name);
+  }
+  explicit HostBuilder(flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable(kMaxInlineSize, kNumFields);
+  }
+  HostBuilder &operator=(const HostBuilder &);
+  flatbuffers::Offset<Host> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = flatbuffers::Offset<Host>(end);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<Host> CreateHost(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    int64_t id = 0,
+    flatbuffers::Offset<flatbuffers::String> name = 0) {
+  HostBuilder builder_(_fbb);
+  builder_.add_id(id);
+  builder_.add_name(name);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<Host> CreateHostDirect(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    int64_t id = 0,
+    const char *name = nullptr) {
+  return HashIndex::CreateHost(
+      _fbb,
+      id,
+      name ? _fbb.CreateString(name) : 0);
+}
+
+flatbuffers::Offset<Host> CreateHost(flatbuffers::FlatBufferBuilder &_fbb, const HostT *_o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
+
+struct RoutingTableT : public flatbuffers::NativeTable {
+  typedef RoutingTable TableType;
+  int32_t version;
+  std::vector<flatbuffers::unique_ptr<HostT>> hosts;
+  std::vector<uint32_t> hosts_hash_index;
+  std::vector<flatbuffers::unique_ptr<RouteT>> routes;
+  std::vector<uint32_t> routes_hash_index;
+  RoutingTableT()
+      : version(0) {
+  }
+};
+
+struct RoutingTable FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  typedef RoutingTableT NativeTableType;
+  static flatbuffers::TypeTable *MiniReflectTypeTable() {
+    return RoutingTableTypeTable();
+  }
+  enum {
+    VT_VERSION = 4,
+    VT_HOSTS = 6,
+    VT_HOSTS_HASH_INDEX = 8,
+    VT_ROUTES = 10,
+    VT_ROUTES_HASH_INDEX = 12
+  };
+  int32_t version() const {
+    return GetField<int32_t>(VT_VERSION, 0);
+  }
+  bool mutate_version(int32_t _version) {
+    return SetField<int32_t>(VT_VERSION, _version, 0);
+  }
+  const flatbuffers::Vector<flatbuffers::Offset<Host>> *hosts() const {
+    return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<Host>> *>(VT_HOSTS);
+  }
+  flatbuffers::Vector<flatbuffers::Offset<Host>> *mutable_hosts() {
+    return GetPointer<flatbuffers::Vector<flatbuffers::Offset<Host>> *>(VT_HOSTS);
+  }
+  const Host *hosts_by_key(int64_t key) const {
+    return flatbuffers::LookupByKeyHashed(hosts(), hosts_hash_index(), key);
+  }
+  const flatbuffers::Vector<uint32_t> *hosts_hash_index() const {
+    return GetPointer<const flatbuffers::Vector<uint32_t> *>(VT_HOSTS_HASH_INDEX);
+  }
+  flatbuffers::Vector<uint32_t> *mutable_hosts_hash_index() {
+    return GetPointer<flatbuffers::Vector<uint32_t> *>(VT_HOSTS_HASH_INDEX);
+  }
+  const flatbuffers::Vector<flatbuffers::Offset<Route>> *routes() const {
+    return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<Route>> *>(VT_ROUTES);
+  }
+  flatbuffers::Vector<flatbuffers::Offset<Route>> *mutable_routes() {
+    return GetPointer<flatbuffers::Vector<flatbuffers::Offset<Route>> *>(VT_ROUTES);
+  }
+  const Route *routes_by_key(const char *key) const {
+    return flatbuffers::LookupByKeyHashed(routes(), routes_hash_index(), key);
+  }
+  const flatbuffers::Vector<uint32_t> *routes_hash_index() const {
+    return GetPointer<const flatbuffers::Vector<uint32_t> *>(VT_ROUTES_HASH_INDEX);
+  }
+  flatbuffers::Vector<uint32_t> *mutable_routes_hash_index() {
+    return GetPointer<flatbuffers::Vector<uint32_t> *>(VT_ROUTES_HASH_INDEX);
+  }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<int32_t>(verifier, VT_VERSION) &&
+           VerifyOffset(verifier, VT_HOSTS) &&
+           verifier.Verify(hosts()) &&
+           verifier.VerifyVectorOfTables(hosts()) &&
+           VerifyOffset(verifier, VT_HOSTS_HASH_INDEX) &&
+           verifier.Verify(hosts_hash_index()) &&
+           VerifyOffset(verifier, VT_ROUTES) &&
+           verifier.Verify(routes()) &&
+           verifier.VerifyVectorOfTables(routes()) &&
+           VerifyOffset(verifier, VT_ROUTES_HASH_INDEX) &&
+           verifier.Verify(routes_hash_index()) &&
+           verifier.EndTable();
+  }
+  RoutingTableT *UnPack(const flatbuffers::resolver_function_t *_resolver = nullptr) const;
+  void UnPackTo(RoutingTableT *_o, const flatbuffers::resolver_function_t *_resolver = nullptr) const;
+  static flatbuffers::Offset<RoutingTable> Pack(flatbuffers::FlatBufferBuilder &_fbb, const RoutingTableT* _o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
+};
+
+struct RoutingTableBuilder {
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  // The most the fields take up, padding included, if added
+  // in the order CreateRoutingTable() adds them.
+  enum {
+    kMaxInlineSize = 23,
+    kNumFields = 5
+  };
+  void add_version(int32_t version) {
+    fbb_.AddElement<int32_t>(RoutingTable::VT_VERSION, version, 0);
+  }
+  void add_hosts(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<Host>>> hosts) {
+    fbb_.AddOffset(RoutingTable::VT_HOSTS, hosts);
+  }
+  void add_hosts_hash_index(flatbuffers::Offset<flatbuffers::Vector<uint32_t>> hosts_hash_index) {
+    fbb_.AddOffset(RoutingTable::VT_HOSTS_HASH_INDEX, hosts_hash_index);
+  }
+  void add_routes(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<Route>>> routes) {
+    fbb_.AddOffset(RoutingTable::VT_ROUTES, routes);
+  }
+  void add_routes_hash_index(flatbuffers::Offset<flatbuffers::Vector<uint32_t>> routes_hash_index) {
+    fbb_.AddOffset(RoutingTable::VT_ROUTES_HASH_INDEX, routes_hash_index);
+  }
+  explicit RoutingTableBuilder(flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable(kMaxInlineSize, kNumFields);
+  }
+  RoutingTableBuilder &operator=(const RoutingTableBuilder &);
+  flatbuffers::Offset<RoutingTable> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = flatbuffers::Offset<RoutingTable>(end);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<RoutingTable> CreateRoutingTable(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    int32_t version = 0,
+    flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<Host>>> hosts = 0,
+    flatbuffers::Offset<flatbuffers::Vector<uint32_t>> hosts_hash_index = 0,
+    flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<Route>>> routes = 0,
+    flatbuffers::Offset<flatbuffers::Vector<uint32_t>> routes_hash_index = 0) {
+  RoutingTableBuilder builder_(_fbb);
+  builder_.add_routes_hash_index(routes_hash_index);
+  builder_.add_routes(routes);
+  builder_.add_hosts_hash_index(hosts_hash_index);
+  builder_.add_hosts(hosts);
+  builder_.add_version(version);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<RoutingTable> CreateRoutingTableDirect(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    int32_t version = 0,
+    const std::vector<flatbuffers::Offset<Host>> *hosts = nullptr,
+    const std::vector<uint32_t> *hosts_hash_index = nullptr,
+    const std::vector<flatbuffers::Offset<Route>> *routes = nullptr,
+    const std::vector<uint32_t> *routes_hash_index = nullptr) {
+  return HashIndex::CreateRoutingTable(
+      _fbb,
+      version,
+      hosts ? _fbb.CreateVector<flatbuffers::Offset<Host>>(*hosts) : 0,
+      hosts_hash_index ? _fbb.CreateVector<uint32_t>(*hosts_hash_index) : 0,
+      routes ? _fbb.CreateVector<flatbuffers::Offset<Route>>(*routes) : 0,
+      routes_hash_index ? _fbb.CreateVector<uint32_t>(*routes_hash_index) : 0);
+}
+
+flatbuffers::Offset<RoutingTable> CreateRoutingTable(flatbuffers::FlatBufferBuilder &_fbb, const RoutingTableT *_o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
+
+inline RouteT *Route::UnPack(const flatbuffers::resolver_function_t *_resolver) const {
+  auto _o = new RouteT();
+  UnPackTo(_o, _resolver);
+  return _o;
+}
+
+inline void Route::UnPackTo(RouteT *_o, const flatbuffers::resolver_function_t *_resolver) const {
+  (void)_o;
+  (void)_resolver;
+  { auto _e = prefix(); if (_e) { _o->prefix.assign(_e->c_str(), _e->size()); } else _o->prefix.clear(); };
+  { auto _e = port(); _o->port = _e; };
+}
+
+inline flatbuffers::Offset<Route> Route::Pack(flatbuffers::FlatBufferBuilder &_fbb, const RouteT* _o, const flatbuffers::rehasher_function_t *_rehasher) {
+  return CreateRoute(_fbb, _o, _rehasher);
+}
+
+inline flatbuffers::Offset<Route> CreateRoute(flatbuffers::FlatBufferBuilder &_fbb, const RouteT *_o, const flatbuffers::rehasher_function_t *_rehasher) {
+  (void)_rehasher;
+  (void)_o;
+  struct _VectorArgs { flatbuffers::FlatBufferBuilder *__fbb; const RouteT* __o; const flatbuffers::rehasher_function_t *__rehasher; } _va = { &_fbb, _o, _rehasher}; (void)_va;
+  auto _prefix = _fbb.CreateString(_o->prefix);
+  auto _port = _o->port;
+  return HashIndex::CreateRoute(
+      _fbb,
+      _prefix,
+      _port);
+}
+
+inline HostT *Host::UnPack(const flatbuffers::resolver_function_t *_resolver) const {
+  auto _o = new HostT();
+  UnPackTo(_o, _resolver);
+  return _o;
+}
+
+inline void Host::UnPackTo(HostT *_o, const flatbuffers::resolver_function_t *_resolver) const {
+  (void)_o;
+  (void)_resolver;
+  { auto _e = id(); _o->id = _e; };
+  { auto _e = name(); if (_e) { _o->name.assign(_e->c_str(), _e->size()); } else _o->name.clear(); };
+}
+
+inline flatbuffers::Offset<Host> Host::Pack(flatbuffers::FlatBufferBuilder &_fbb, const HostT* _o, const flatbuffers::rehasher_function_t *_rehasher) {
+  return CreateHost(_fbb, _o, _rehasher);
+}
+
+inline flatbuffers::Offset<Host> CreateHost(flatbuffers::FlatBufferBuilder &_fbb, const HostT *_o, const flatbuffers::rehasher_function_t *_rehasher) {
+  (void)_rehasher;
+  (void)_o;
+  struct _VectorArgs { flatbuffers::FlatBufferBuilder *__fbb; const HostT* __o; const flatbuffers::rehasher_function_t *__rehasher; } _va = { &_fbb, _o, _rehasher}; (void)_va;
+  auto _id = _o->id;
+  auto _name = _o->name.empty() ? 0 : _fbb.CreateString(_o->name);
+  return HashIndex::CreateHost(
+      _fbb,
+      _id,
+      _name);
+}
+
+inline RoutingTableT *RoutingTable::UnPack(const flatbuffers::resolver_function_t *_resolver) const {
+  auto _o = new RoutingTableT();
+  UnPackTo(_o, _resolver);
+  return _o;
+}
+
+inline void RoutingTable::UnPackTo(RoutingTableT *_o, const flatbuffers::resolver_function_t *_resolver) const {
+  (void)_o;
+  (void)_resolver;
+  { auto _e = version(); _o->version = _e; };
+  { auto _e = hosts(); if (_e) { _o->hosts.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { if (_o->hosts[_i]) _e->Get(_i)->UnPackTo(_o->hosts[_i].get(), _resolver); else _o->hosts[_i] = flatbuffers::unique_ptr<HostT>(_e->Get(_i)->UnPack(_resolver)); } } else _o->hosts.clear(); };
+  { auto _e = hosts_hash_index(); if (_e) { _o->hosts_hash_index.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->hosts_hash_index[_i] = _e->Get(_i); } } else _o->hosts_hash_index.clear(); };
+  { auto _e = routes(); if (_e) { _o->routes.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { if (_o->routes[_i]) _e->Get(_i)->UnPackTo(_o->routes[_i].get(), _resolver); else _o->routes[_i] = flatbuffers::unique_ptr<RouteT>(_e->Get(_i)->UnPack(_resolver)); } } else _o->routes.clear(); };
+  { auto _e = routes_hash_index(); if (_e) { _o->routes_hash_index.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->routes_hash_index[_i] = _e->Get(_i); } } else _o->routes_hash_index.clear(); };
+}
+
+inline flatbuffers::Offset<RoutingTable> RoutingTable::Pack(flatbuffers::FlatBufferBuilder &_fbb, const RoutingTableT* _o, const flatbuffers::rehasher_function_t *_rehasher) {
+  return CreateRoutingTable(_fbb, _o, _rehasher);
+}
+
+inline flatbuffers::Offset<RoutingTable> CreateRoutingTable(flatbuffers::FlatBufferBuilder &_fbb, const RoutingTableT *_o, const flatbuffers::rehasher_function_t *_rehasher) {
+  (void)_rehasher;
+  (void)_o;
+  struct _VectorArgs { flatbuffers::FlatBufferBuilder *__fbb; const RoutingTableT* __o; const flatbuffers::rehasher_function_t *__rehasher; } _va = { &_fbb, _o, _rehasher}; (void)_va;
+  auto _version = _o->version;
+  auto _hosts = _o->hosts.size() ? _fbb.CreateVector<flatbuffers::Offset<Host>> (_o->hosts.size(), [](size_t i, _VectorArgs *__va) { return CreateHost(*__va->__fbb, __va->__o->hosts[i].get(), __va->__rehasher); }, &_va ) : 0;
+  auto _hosts_hash_index = flatbuffers::CreateHashIndex(_fbb, _hosts, &Host::id);
+  auto _routes = _o->routes.size() ? _fbb.CreateVector<flatbuffers::Offset<Route>> (_o->routes.size(), [](size_t i, _VectorArgs *__va) { return CreateRoute(*__va->__fbb, __va->__o->routes[i].get(), __va->__rehasher); }, &_va ) : 0;
+  auto _routes_hash_index = flatbuffers::CreateHashIndex(_fbb, _routes, &Route::prefix);
+  return HashIndex::CreateRoutingTable(
+      _fbb,
+      _version,
+      _hosts,
+      _hosts_hash_index,
+      _routes,
+      _routes_hash_index);
+}
+
+inline flatbuffers::TypeTable *RouteTypeTable() {
+  static flatbuffers::TypeCode type_codes[] = {
+    { flatbuffers::ET_STRING, 0, -1 },
+    { flatbuffers::ET_USHORT, 0, -1 }
+  };
+  static const char *names[] = {
+    "prefix",
+    "port"
+  };
+  static flatbuffers::TypeTable tt = {
+    flatbuffers::ST_TABLE, 2, type_codes, nullptr, nullptr, names
+  };
+  return &tt;
+}
+
+inline flatbuffers::TypeTable *HostTypeTable() {
+  static flatbuffers::TypeCode type_codes[] = {
+    { flatbuffers::ET_LONG, 0, -1 },
+    { flatbuffers::ET_STRING, 0, -1 }
+  };
+  static const char *names[] = {
+    "id",
+    "name"
+  };
+  static flatbuffers::TypeTable tt = {
+    flatbuffers::ST_TABLE, 2, type_codes, nullptr, nullptr, names
+  };
+  return &tt;
+}
+
+inline flatbuffers::TypeTable *RoutingTableTypeTable() {
+  static flatbuffers::TypeCode type_codes[] = {
+    { flatbuffers::ET_INT, 0, -1 },
+    { flatbuffers::ET_SEQUENCE, 1, 0 },
+    { flatbuffers::ET_UINT, 1, -1 },
+    { flatbuffers::ET_SEQUENCE, 1, 1 },
+    { flatbuffers::ET_UINT, 1, -1 }
+  };
+  static flatbuffers::TypeFunction type_refs[] = {
+    HostTypeTable,
+    RouteTypeTable
+  };
+  static const char *names[] = {
+    "version",
+    "hosts",
+    "hosts_hash_index",
+    "routes",
+    "routes_hash_index"
+  };
+  static flatbuffers::TypeTable tt = {
+    flatbuffers::ST_TABLE, 5, type_codes, type_refs, nullptr, names
+  };
+  return &tt;
+}
+
+inline const HashIndex::RoutingTable *GetRoutingTable(const void *buf) {
+  return flatbuffers::GetRoot<HashIndex::RoutingTable>(buf);
+}
+
+inline const HashIndex::RoutingTable *GetSizePrefixedRoutingTable(const void *buf) {
+  return flatbuffers::GetSizePrefixedRoot<HashIndex::RoutingTable>(buf);
+}
+
+inline RoutingTable *GetMutableRoutingTable(void *buf) {
+  return flatbuffers::GetMutableRoot<RoutingTable>(buf);
+}
+
+inline bool VerifyRoutingTableBuffer(
+    flatbuffers::Verifier &verifier) {
+  return verifier.VerifyBuffer<HashIndex::RoutingTable>(nullptr);
+}
+
+inline bool VerifySizePrefixedRoutingTableBuffer(
+    flatbuffers::Verifier &verifier) {
+  return verifier.VerifySizePrefixedBuffer<HashIndex::RoutingTable>(nullptr);
+}
+
+inline void FinishRoutingTableBuffer(
+    flatbuffers::FlatBufferBuilder &fbb,
+    flatbuffers::Offset<HashIndex::RoutingTable> root) {
+  fbb.Finish(root);
+}
+
+inline void FinishSizePrefixedRoutingTableBuffer(
+    flatbuffers::FlatBufferBuilder &fbb,
+    flatbuffers::Offset<HashIndex::RoutingTable> root) {
+  fbb.FinishSizePrefixed(root);
+}
+
+inline flatbuffers::unique_ptr<RoutingTableT> UnPackRoutingTable(
+    const void *buf,
+    const flatbuffers::resolver_function_t *res = nullptr) {
+  return flatbuffers::unique_ptr<RoutingTableT>(GetRoutingTable(buf)->UnPack(res));
+}
+
+}  // namespace HashIndex
+
+#endif  // FLATBUFFERS_GENERATED_HASHINDEXTEST_HASHINDEX_H_
@@ -32,6 +32,7 @@ class MonsterStorage final {
   static constexpr char const* service_full_name() {
     return "MyGame.Example.MonsterStorage";
   }
+  typedef ::flatbuffers::grpc::FrameReader< flatbuffers::grpc::Message<Monster>> RetrieveResponseFrameReader;
   class StubInterface {
    public:
     virtual ~StubInterface() {}
@@ -194,6 +195,27 @@ class MonsterStorage final {
   };
   typedef   WithStreamedUnaryMethod_Store<  Service   >   StreamedUnaryService;
   template <class BaseClass>
+  class WithArenaMethod_Store : public BaseClass {
+   private:
+    void BaseClassMustBeDerivedFromService(const Service *service) {}
+   public:
+    ~WithArenaMethod_Store() override {
+      BaseClassMustBeDerivedFromService(this);
+    }
+    // build the response with the calling thread's builder
+    ::grpc::Status Store(::grpc::ServerContext* context, const flatbuffers::grpc::Message<Monster>* request, flatbuffers::grpc::Message<Stat>* response) final override {
+      auto &fbb = ::flatbuffers::grpc::ThreadMessageBuilder();
+      auto status = BuildStore(context, request, &fbb);
+      if (status.ok()) {
+        *response = fbb.ReleaseMessage< flatbuffers::grpc::Message<Stat>::RootType>();
+      }
+      return status;
+    }
+    // finish the response in fbb, don't release it
+    virtual ::grpc::Status BuildStore(::grpc::ServerContext* context, const flatbuffers::grpc::Message<Monster>* request, ::flatbuffers::grpc::MessageBuilder* fbb) = 0;
+  };
+  typedef   WithArenaMethod_Store<  Service   >   ArenaService;
+  template <class BaseClass>
   class WithSplitStreamingMethod_Retrieve : public BaseClass {
    private:
     void BaseClassMustBeDerivedFromService(const Service *service) {}
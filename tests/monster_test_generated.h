@@ -6,6 +6,7 @@
 
 #include "flatbuffers/flatbuffers.h"
 #include "flatbuffers/flexbuffers.h"
+#include "flatbuffers/json.h"
 
 namespace MyGame {
 
@@ -378,9 +379,15 @@ struct InParentNamespace FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
 struct InParentNamespaceBuilder {
   flatbuffers::FlatBufferBuilder &fbb_;
   flatbuffers::uoffset_t start_;
+  // The most the fields take up, padding included, if added
+  // in the order CreateInParentNamespace() adds them.
+  enum {
+    kMaxInlineSize = 0,
+    kNumFields = 0
+  };
   explicit InParentNamespaceBuilder(flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
-    start_ = fbb_.StartTable();
+    start_ = fbb_.StartTable(kMaxInlineSize, kNumFields);
   }
   InParentNamespaceBuilder &operator=(const InParentNamespaceBuilder &);
   flatbuffers::Offset<InParentNamespace> Finish() {
@@ -423,9 +430,15 @@ struct Monster FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
 struct MonsterBuilder {
   flatbuffers::FlatBufferBuilder &fbb_;
   flatbuffers::uoffset_t start_;
+  // The most the fields take up, padding included, if added
+  // in the order CreateMonster() adds them.
+  enum {
+    kMaxInlineSize = 0,
+    kNumFields = 0
+  };
   explicit MonsterBuilder(flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
-    start_ = fbb_.StartTable();
+    start_ = fbb_.StartTable(kMaxInlineSize, kNumFields);
   }
   MonsterBuilder &operator=(const MonsterBuilder &);
   flatbuffers::Offset<Monster> Finish() {
@@ -482,12 +495,18 @@ struct TestSimpleTableWithEnum FLATBUFFERS_FINAL_CLASS : private flatbuffers::Ta
 struct TestSimpleTableWithEnumBuilder {
   flatbuffers::FlatBufferBuilder &fbb_;
   flatbuffers::uoffset_t start_;
+  // The most the fields take up, padding included, if added
+  // in the order CreateTestSimpleTableWithEnum() adds them.
+  enum {
+    kMaxInlineSize = 1,
+    kNumFields = 1
+  };
   void add_color(Color color) {
     fbb_.AddElement<int8_t>(TestSimpleTableWithEnum::VT_COLOR, static_cast<int8_t>(color), 2);
   }
   explicit TestSimpleTableWithEnumBuilder(flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
-    start_ = fbb_.StartTable();
+    start_ = fbb_.StartTable(kMaxInlineSize, kNumFields);
   }
   TestSimpleTableWithEnumBuilder &operator=(const TestSimpleTableWithEnumBuilder &);
   flatbuffers::Offset<TestSimpleTableWithEnum> Finish() {
@@ -562,6 +581,12 @@ struct Stat FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
 struct StatBuilder {
   flatbuffers::FlatBufferBuilder &fbb_;
   flatbuffers::uoffset_t start_;
+  // The most the fields take up, padding included, if added
+  // in the order CreateStat() adds them.
+  enum {
+    kMaxInlineSize = 21,
+    kNumFields = 3
+  };
   void add_id(flatbuffers::Offset<flatbuffers::String> id) {
     fbb_.AddOffset(Stat::VT_ID, id);
   }
@@ -573,7 +598,7 @@ struct StatBuilder {
   }
   explicit StatBuilder(flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
-    start_ = fbb_.StartTable();
+    start_ = fbb_.StartTable(kMaxInlineSize, kNumFields);
   }
   StatBuilder &operator=(const StatBuilder &);
   flatbuffers::Offset<Stat> Finish() {
@@ -657,12 +682,18 @@ struct Referrable FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
 struct ReferrableBuilder {
   flatbuffers::FlatBufferBuilder &fbb_;
   flatbuffers::uoffset_t start_;
+  // The most the fields take up, padding included, if added
+  // in the order CreateReferrable() adds them.
+  enum {
+    kMaxInlineSize = 15,
+    kNumFields = 1
+  };
   void add_id(uint64_t id) {
     fbb_.AddElement<uint64_t>(Referrable::VT_ID, id, 0);
   }
   explicit ReferrableBuilder(flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
-    start_ = fbb_.StartTable();
+    start_ = fbb_.StartTable(kMaxInlineSize, kNumFields);
   }
   ReferrableBuilder &operator=(const ReferrableBuilder &);
   flatbuffers::Offset<Referrable> Finish() {
@@ -1167,6 +1198,12 @@ template<> inline const MyGame::Example2::Monster *Monster::test_as<MyGame::Exam
 struct MonsterBuilder {
   flatbuffers::FlatBufferBuilder &fbb_;
   flatbuffers::uoffset_t start_;
+  // The most the fields take up, padding included, if added
+  // in the order CreateMonster() adds them.
+  enum {
+    kMaxInlineSize = 226,
+    kNumFields = 43
+  };
   void add_pos(const Vec3 *pos) {
     fbb_.AddStruct(Monster::VT_POS, pos);
   }
@@ -1295,7 +1332,7 @@ struct MonsterBuilder {
   }
   explicit MonsterBuilder(flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
-    start_ = fbb_.StartTable();
+    start_ = fbb_.StartTable(kMaxInlineSize, kNumFields);
   }
   MonsterBuilder &operator=(const MonsterBuilder &);
   flatbuffers::Offset<Monster> Finish() {
@@ -1351,6 +1388,7 @@ inline flatbuffers::Offset<Monster> CreateMonster(
     uint64_t non_owning_reference = 0,
     flatbuffers::Offset<flatbuffers::Vector<uint64_t>> vector_of_non_owning_references = 0) {
   MonsterBuilder builder_(_fbb);
+  builder_.add_pos(pos);
   builder_.add_non_owning_reference(non_owning_reference);
   builder_.add_co_owning_reference(co_owning_reference);
   builder_.add_single_weak_reference(single_weak_reference);
@@ -1387,7 +1425,6 @@ inline flatbuffers::Offset<Monster> CreateMonster(
   builder_.add_test(test);
   builder_.add_inventory(inventory);
   builder_.add_name(name);
-  builder_.add_pos(pos);
   builder_.add_hp(hp);
   builder_.add_mana(mana);
   builder_.add_testbool(testbool);
@@ -1633,6 +1670,12 @@ struct TypeAliases FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
 struct TypeAliasesBuilder {
   flatbuffers::FlatBufferBuilder &fbb_;
   flatbuffers::uoffset_t start_;
+  // The most the fields take up, padding included, if added
+  // in the order CreateTypeAliases() adds them.
+  enum {
+    kMaxInlineSize = 57,
+    kNumFields = 12
+  };
   void add_i8(int8_t i8) {
     fbb_.AddElement<int8_t>(TypeAliases::VT_I8, i8, 0);
   }
@@ -1671,7 +1714,7 @@ struct TypeAliasesBuilder {
   }
   explicit TypeAliasesBuilder(flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
-    start_ = fbb_.StartTable();
+    start_ = fbb_.StartTable(kMaxInlineSize, kNumFields);
   }
   TypeAliasesBuilder &operator=(const TypeAliasesBuilder &);
   flatbuffers::Offset<TypeAliases> Finish() {
@@ -1832,7 +1875,7 @@ inline StatT *Stat::UnPack(const flatbuffers::resolver_function_t *_resolver) co
 inline void Stat::UnPackTo(StatT *_o, const flatbuffers::resolver_function_t *_resolver) const {
   (void)_o;
   (void)_resolver;
-  { auto _e = id(); if (_e) _o->id = _e->str(); };
+  { auto _e = id(); if (_e) { _o->id.assign(_e->c_str(), _e->size()); } else _o->id.clear(); };
   { auto _e = val(); _o->val = _e; };
   { auto _e = count(); _o->count = _e; };
 }
@@ -1890,20 +1933,20 @@ inline MonsterT *Monster::UnPack(const flatbuffers::resolver_function_t *_resolv
 inline void Monster::UnPackTo(MonsterT *_o, const flatbuffers::resolver_function_t *_resolver) const {
   (void)_o;
   (void)_resolver;
-  { auto _e = pos(); if (_e) _o->pos = flatbuffers::unique_ptr<Vec3>(new Vec3(*_e)); };
+  { auto _e = pos(); if (_e) { if (_o->pos) *_o->pos = *_e; else _o->pos = flatbuffers::unique_ptr<Vec3>(new Vec3(*_e)); } else _o->pos.reset(); };
   { auto _e = mana(); _o->mana = _e; };
   { auto _e = hp(); _o->hp = _e; };
-  { auto _e = name(); if (_e) _o->name = _e->str(); };
-  { auto _e = inventory(); if (_e) { _o->inventory.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->inventory[_i] = _e->Get(_i); } } };
+  { auto _e = name(); if (_e) { _o->name.assign(_e->c_str(), _e->size()); } else _o->name.clear(); };
+  { auto _e = inventory(); if (_e) { _o->inventory.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->inventory[_i] = _e->Get(_i); } } else _o->inventory.clear(); };
   { auto _e = color(); _o->color = _e; };
-  { auto _e = test_type(); _o->test.type = _e; };
+  { auto _e = test_type(); _o->test.Reset(); _o->test.type = _e; };
   { auto _e = test(); if (_e) _o->test.value = AnyUnion::UnPack(_e, test_type(), _resolver); };
-  { auto _e = test4(); if (_e) { _o->test4.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->test4[_i] = *_e->Get(_i); } } };
-  { auto _e = testarrayofstring(); if (_e) { _o->testarrayofstring.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->testarrayofstring[_i] = _e->Get(_i)->str(); } } };
-  { auto _e = testarrayoftables(); if (_e) { _o->testarrayoftables.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->testarrayoftables[_i] = flatbuffers::unique_ptr<MonsterT>(_e->Get(_i)->UnPack(_resolver)); } } };
-  { auto _e = enemy(); if (_e) _o->enemy = flatbuffers::unique_ptr<MonsterT>(_e->UnPack(_resolver)); };
-  { auto _e = testnestedflatbuffer(); if (_e) { _o->testnestedflatbuffer.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->testnestedflatbuffer[_i] = _e->Get(_i); } } };
-  { auto _e = testempty(); if (_e) _o->testempty = flatbuffers::unique_ptr<StatT>(_e->UnPack(_resolver)); };
+  { auto _e = test4(); if (_e) { _o->test4.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->test4[_i] = *_e->Get(_i); } } else _o->test4.clear(); };
+  { auto _e = testarrayofstring(); if (_e) { _o->testarrayofstring.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->testarrayofstring[_i].assign(_e->Get(_i)->c_str(), _e->Get(_i)->size()); } } else _o->testarrayofstring.clear(); };
+  { auto _e = testarrayoftables(); if (_e) { _o->testarrayoftables.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { if (_o->testarrayoftables[_i]) _e->Get(_i)->UnPackTo(_o->testarrayoftables[_i].get(), _resolver); else _o->testarrayoftables[_i] = flatbuffers::unique_ptr<MonsterT>(_e->Get(_i)->UnPack(_resolver)); } } else _o->testarrayoftables.clear(); };
+  { auto _e = enemy(); if (_e) { if (_o->enemy) _e->UnPackTo(_o->enemy.get(), _resolver); else _o->enemy = flatbuffers::unique_ptr<MonsterT>(_e->UnPack(_resolver)); } else _o->enemy.reset(); };
+  { auto _e = testnestedflatbuffer(); if (_e) { _o->testnestedflatbuffer.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->testnestedflatbuffer[_i] = _e->Get(_i); } } else _o->testnestedflatbuffer.clear(); };
+  { auto _e = testempty(); if (_e) { if (_o->testempty) _e->UnPackTo(_o->testempty.get(), _resolver); else _o->testempty = flatbuffers::unique_ptr<StatT>(_e->UnPack(_resolver)); } else _o->testempty.reset(); };
   { auto _e = testbool(); _o->testbool = _e; };
   { auto _e = testhashs32_fnv1(); _o->testhashs32_fnv1 = _e; };
   { auto _e = testhashu32_fnv1(); _o->testhashu32_fnv1 = _e; };
@@ -1914,31 +1957,31 @@ inline void Monster::UnPackTo(MonsterT *_o, const flatbuffers::resolver_function
 if (_resolver) (*_resolver)(reinterpret_cast<void **>(&_o->testhashu32_fnv1a), static_cast<flatbuffers::hash_value_t>(_e)); else _o->testhashu32_fnv1a = nullptr; };
   { auto _e = testhashs64_fnv1a(); _o->testhashs64_fnv1a = _e; };
   { auto _e = testhashu64_fnv1a(); _o->testhashu64_fnv1a = _e; };
-  { auto _e = testarrayofbools(); if (_e) { _o->testarrayofbools.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->testarrayofbools[_i] = _e->Get(_i) != 0; } } };
+  { auto _e = testarrayofbools(); if (_e) { _o->testarrayofbools.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->testarrayofbools[_i] = _e->Get(_i) != 0; } } else _o->testarrayofbools.clear(); };
   { auto _e = testf(); _o->testf = _e; };
   { auto _e = testf2(); _o->testf2 = _e; };
   { auto _e = testf3(); _o->testf3 = _e; };
-  { auto _e = testarrayofstring2(); if (_e) { _o->testarrayofstring2.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->testarrayofstring2[_i] = _e->Get(_i)->str(); } } };
-  { auto _e = testarrayofsortedstruct(); if (_e) { _o->testarrayofsortedstruct.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->testarrayofsortedstruct[_i] = *_e->Get(_i); } } };
-  { auto _e = flex(); if (_e) { _o->flex.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->flex[_i] = _e->Get(_i); } } };
-  { auto _e = test5(); if (_e) { _o->test5.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->test5[_i] = *_e->Get(_i); } } };
-  { auto _e = vector_of_longs(); if (_e) { _o->vector_of_longs.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->vector_of_longs[_i] = _e->Get(_i); } } };
-  { auto _e = vector_of_doubles(); if (_e) { _o->vector_of_doubles.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->vector_of_doubles[_i] = _e->Get(_i); } } };
-  { auto _e = parent_namespace_test(); if (_e) _o->parent_namespace_test = flatbuffers::unique_ptr<MyGame::InParentNamespaceT>(_e->UnPack(_resolver)); };
-  { auto _e = vector_of_referrables(); if (_e) { _o->vector_of_referrables.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->vector_of_referrables[_i] = flatbuffers::unique_ptr<ReferrableT>(_e->Get(_i)->UnPack(_resolver)); } } };
+  { auto _e = testarrayofstring2(); if (_e) { _o->testarrayofstring2.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->testarrayofstring2[_i].assign(_e->Get(_i)->c_str(), _e->Get(_i)->size()); } } else _o->testarrayofstring2.clear(); };
+  { auto _e = testarrayofsortedstruct(); if (_e) { _o->testarrayofsortedstruct.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->testarrayofsortedstruct[_i] = *_e->Get(_i); } } else _o->testarrayofsortedstruct.clear(); };
+  { auto _e = flex(); if (_e) { _o->flex.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->flex[_i] = _e->Get(_i); } } else _o->flex.clear(); };
+  { auto _e = test5(); if (_e) { _o->test5.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->test5[_i] = *_e->Get(_i); } } else _o->test5.clear(); };
+  { auto _e = vector_of_longs(); if (_e) { _o->vector_of_longs.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->vector_of_longs[_i] = _e->Get(_i); } } else _o->vector_of_longs.clear(); };
+  { auto _e = vector_of_doubles(); if (_e) { _o->vector_of_doubles.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->vector_of_doubles[_i] = _e->Get(_i); } } else _o->vector_of_doubles.clear(); };
+  { auto _e = parent_namespace_test(); if (_e) { if (_o->parent_namespace_test) _e->UnPackTo(_o->parent_namespace_test.get(), _resolver); else _o->parent_namespace_test = flatbuffers::unique_ptr<MyGame::InParentNamespaceT>(_e->UnPack(_resolver)); } else _o->parent_namespace_test.reset(); };
+  { auto _e = vector_of_referrables(); if (_e) { _o->vector_of_referrables.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { if (_o->vector_of_referrables[_i]) _e->Get(_i)->UnPackTo(_o->vector_of_referrables[_i].get(), _resolver); else _o->vector_of_referrables[_i] = flatbuffers::unique_ptr<ReferrableT>(_e->Get(_i)->UnPack(_resolver)); } } else _o->vector_of_referrables.clear(); };
   { auto _e = single_weak_reference(); //scalar resolver, naked 
 if (_resolver) (*_resolver)(reinterpret_cast<void **>(&_o->single_weak_reference), static_cast<flatbuffers::hash_value_t>(_e)); else _o->single_weak_reference = nullptr; };
   { auto _e = vector_of_weak_references(); if (_e) { _o->vector_of_weak_references.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { //vector resolver, naked
-if (_resolver) (*_resolver)(reinterpret_cast<void **>(&_o->vector_of_weak_references[_i]), static_cast<flatbuffers::hash_value_t>(_e->Get(_i))); else _o->vector_of_weak_references[_i] = nullptr; } } };
-  { auto _e = vector_of_strong_referrables(); if (_e) { _o->vector_of_strong_referrables.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->vector_of_strong_referrables[_i] = std::unique_ptr<ReferrableT>(_e->Get(_i)->UnPack(_resolver)); } } };
+if (_resolver) (*_resolver)(reinterpret_cast<void **>(&_o->vector_of_weak_references[_i]), static_cast<flatbuffers::hash_value_t>(_e->Get(_i))); else _o->vector_of_weak_references[_i] = nullptr; } } else _o->vector_of_weak_references.clear(); };
+  { auto _e = vector_of_strong_referrables(); if (_e) { _o->vector_of_strong_referrables.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { if (_o->vector_of_strong_referrables[_i]) _e->Get(_i)->UnPackTo(_o->vector_of_strong_referrables[_i].get(), _resolver); else _o->vector_of_strong_referrables[_i] = std::unique_ptr<ReferrableT>(_e->Get(_i)->UnPack(_resolver)); } } else _o->vector_of_strong_referrables.clear(); };
   { auto _e = co_owning_reference(); //scalar resolver, naked 
 if (_resolver) (*_resolver)(reinterpret_cast<void **>(&_o->co_owning_reference), static_cast<flatbuffers::hash_value_t>(_e)); else _o->co_owning_reference = nullptr; };
   { auto _e = vector_of_co_owning_references(); if (_e) { _o->vector_of_co_owning_references.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { //vector resolver, std::unique_ptr
-if (_resolver) (*_resolver)(reinterpret_cast<void **>(&_o->vector_of_co_owning_references[_i]), static_cast<flatbuffers::hash_value_t>(_e->Get(_i)));/* else do nothing */; } } };
+if (_resolver) (*_resolver)(reinterpret_cast<void **>(&_o->vector_of_co_owning_references[_i]), static_cast<flatbuffers::hash_value_t>(_e->Get(_i)));/* else do nothing */; } } else _o->vector_of_co_owning_references.clear(); };
   { auto _e = non_owning_reference(); //scalar resolver, naked 
 if (_resolver) (*_resolver)(reinterpret_cast<void **>(&_o->non_owning_reference), static_cast<flatbuffers::hash_value_t>(_e)); else _o->non_owning_reference = nullptr; };
   { auto _e = vector_of_non_owning_references(); if (_e) { _o->vector_of_non_owning_references.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { //vector resolver, naked
-if (_resolver) (*_resolver)(reinterpret_cast<void **>(&_o->vector_of_non_owning_references[_i]), static_cast<flatbuffers::hash_value_t>(_e->Get(_i))); else _o->vector_of_non_owning_references[_i] = nullptr; } } };
+if (_resolver) (*_resolver)(reinterpret_cast<void **>(&_o->vector_of_non_owning_references[_i]), static_cast<flatbuffers::hash_value_t>(_e->Get(_i))); else _o->vector_of_non_owning_references[_i] = nullptr; } } else _o->vector_of_non_owning_references.clear(); };
 }
 
 inline flatbuffers::Offset<Monster> Monster::Pack(flatbuffers::FlatBufferBuilder &_fbb, const MonsterT* _o, const flatbuffers::rehasher_function_t *_rehasher) {
@@ -2056,8 +2099,8 @@ inline void TypeAliases::UnPackTo(TypeAliasesT *_o, const flatbuffers::resolver_
   { auto _e = u64(); _o->u64 = _e; };
   { auto _e = f32(); _o->f32 = _e; };
   { auto _e = f64(); _o->f64 = _e; };
-  { auto _e = v8(); if (_e) { _o->v8.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->v8[_i] = _e->Get(_i); } } };
-  { auto _e = vf64(); if (_e) { _o->vf64.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->vf64[_i] = _e->Get(_i); } } };
+  { auto _e = v8(); if (_e) { _o->v8.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->v8[_i] = _e->Get(_i); } } else _o->v8.clear(); };
+  { auto _e = vf64(); if (_e) { _o->vf64.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->vf64[_i] = _e->Get(_i); } } else _o->vf64.clear(); };
 }
 
 inline flatbuffers::Offset<TypeAliases> TypeAliases::Pack(flatbuffers::FlatBufferBuilder &_fbb, const TypeAliasesT* _o, const flatbuffers::rehasher_function_t *_rehasher) {
@@ -2207,6 +2250,1442 @@ inline void AnyUnion::Reset() {
   type = Any_NONE;
 }
 
+inline bool ColorFromJsonName(const char *name, size_t len, int64_t *val) {
+  switch (flatbuffers::JsonReader::HashKey(name, len)) {
+    case 6750471596913316700ULL:
+      if (len == 3 && !memcmp(name, "Red", 3)) {
+        *val = 1;
+        return true;
+      }
+      break;
+    case 6968451286814585229ULL:
+      if (len == 4 && !memcmp(name, "Blue", 4)) {
+        *val = 8;
+        return true;
+      }
+      break;
+    case 11270997851680043260ULL:
+      if (len == 5 && !memcmp(name, "Green", 5)) {
+        *val = 2;
+        return true;
+      }
+      break;
+  }
+  return false;
+}
+
+inline const char *ColorJsonName(int64_t val) {
+  switch (val) {
+    case 1: return "Red";
+    case 2: return "Green";
+    case 8: return "Blue";
+    default: return nullptr;
+  }
+}
+
+inline bool AnyFromJsonName(const char *name, size_t len, int64_t *val) {
+  switch (flatbuffers::JsonReader::HashKey(name, len)) {
+    case 6410290001126112384ULL:
+      if (len == 23 && !memcmp(name, "TestSimpleTableWithEnum", 23)) {
+        *val = 2;
+        return true;
+      }
+      break;
+    case 9387407097548898095ULL:
+      if (len == 23 && !memcmp(name, "MyGame_Example2_Monster", 23)) {
+        *val = 3;
+        return true;
+      }
+      break;
+    case 11057303190708820123ULL:
+      if (len == 4 && !memcmp(name, "NONE", 4)) {
+        *val = 0;
+        return true;
+      }
+      break;
+    case 12574387895785686577ULL:
+      if (len == 7 && !memcmp(name, "Monster", 7)) {
+        *val = 1;
+        return true;
+      }
+      break;
+  }
+  return false;
+}
+
+inline const char *AnyJsonName(int64_t val) {
+  switch (val) {
+    case 1: return "Monster";
+    case 2: return "TestSimpleTableWithEnum";
+    case 3: return "MyGame_Example2_Monster";
+    default: return nullptr;
+  }
+}
+
+inline bool ParseAnyJson(flatbuffers::JsonReader &_json, flatbuffers::FlatBufferBuilder &_fbb, Any type, flatbuffers::Offset<void> *_o);
+inline void PrintAnyJson(flatbuffers::JsonWriter &_json, const void *_o, Any type);
+
+}  // namespace Example
+
+inline bool ParseInParentNamespaceJson(flatbuffers::JsonReader &_json, flatbuffers::FlatBufferBuilder &_fbb, flatbuffers::Offset<InParentNamespace> *_o);
+inline void PrintInParentNamespaceJson(flatbuffers::JsonWriter &_json, const InParentNamespace &_o);
+
+namespace Example2 {
+
+inline bool ParseMonsterJson(flatbuffers::JsonReader &_json, flatbuffers::FlatBufferBuilder &_fbb, flatbuffers::Offset<Monster> *_o);
+inline void PrintMonsterJson(flatbuffers::JsonWriter &_json, const Monster &_o);
+
+}  // namespace Example2
+
+namespace Example {
+
+inline bool ParseTestJson(flatbuffers::JsonReader &_json, Test *_o);
+inline void PrintTestJson(flatbuffers::JsonWriter &_json, const Test &_o);
+
+inline bool ParseTestSimpleTableWithEnumJson(flatbuffers::JsonReader &_json, flatbuffers::FlatBufferBuilder &_fbb, flatbuffers::Offset<TestSimpleTableWithEnum> *_o);
+inline void PrintTestSimpleTableWithEnumJson(flatbuffers::JsonWriter &_json, const TestSimpleTableWithEnum &_o);
+
+inline bool ParseVec3Json(flatbuffers::JsonReader &_json, Vec3 *_o);
+inline void PrintVec3Json(flatbuffers::JsonWriter &_json, const Vec3 &_o);
+
+inline bool ParseAbilityJson(flatbuffers::JsonReader &_json, Ability *_o);
+inline void PrintAbilityJson(flatbuffers::JsonWriter &_json, const Ability &_o);
+
+inline bool ParseStatJson(flatbuffers::JsonReader &_json, flatbuffers::FlatBufferBuilder &_fbb, flatbuffers::Offset<Stat> *_o);
+inline void PrintStatJson(flatbuffers::JsonWriter &_json, const Stat &_o);
+
+inline bool ParseReferrableJson(flatbuffers::JsonReader &_json, flatbuffers::FlatBufferBuilder &_fbb, flatbuffers::Offset<Referrable> *_o);
+inline void PrintReferrableJson(flatbuffers::JsonWriter &_json, const Referrable &_o);
+
+inline bool ParseMonsterJson(flatbuffers::JsonReader &_json, flatbuffers::FlatBufferBuilder &_fbb, flatbuffers::Offset<Monster> *_o);
+inline void PrintMonsterJson(flatbuffers::JsonWriter &_json, const Monster &_o);
+
+inline bool ParseTypeAliasesJson(flatbuffers::JsonReader &_json, flatbuffers::FlatBufferBuilder &_fbb, flatbuffers::Offset<TypeAliases> *_o);
+inline void PrintTypeAliasesJson(flatbuffers::JsonWriter &_json, const TypeAliases &_o);
+
+inline bool ParseAnyJson(flatbuffers::JsonReader &_json, flatbuffers::FlatBufferBuilder &_fbb, Any type, flatbuffers::Offset<void> *_o) {
+  switch (type) {
+    case Any_Monster: {
+      flatbuffers::Offset<Monster> _v;
+      if (!ParseMonsterJson(_json, _fbb, &_v)) return false;
+      *_o = _v.Union();
+      return true;
+    }
+    case Any_TestSimpleTableWithEnum: {
+      flatbuffers::Offset<TestSimpleTableWithEnum> _v;
+      if (!ParseTestSimpleTableWithEnumJson(_json, _fbb, &_v)) return false;
+      *_o = _v.Union();
+      return true;
+    }
+    case Any_MyGame_Example2_Monster: {
+      flatbuffers::Offset<MyGame::Example2::Monster> _v;
+      if (!MyGame::Example2::ParseMonsterJson(_json, _fbb, &_v)) return false;
+      *_o = _v.Union();
+      return true;
+    }
+    default:
+      return _json.Error("illegal type id for union: Any");
+  }
+}
+
+inline void PrintAnyJson(flatbuffers::JsonWriter &_json, const void *_o, Any type) {
+  switch (type) {
+    case Any_Monster:
+      PrintMonsterJson(_json, *reinterpret_cast<const Monster *>(_o));
+      break;
+    case Any_TestSimpleTableWithEnum:
+      PrintTestSimpleTableWithEnumJson(_json, *reinterpret_cast<const TestSimpleTableWithEnum *>(_o));
+      break;
+    case Any_MyGame_Example2_Monster:
+      MyGame::Example2::PrintMonsterJson(_json, *reinterpret_cast<const MyGame::Example2::Monster *>(_o));
+      break;
+    default: _json.Null(); break;
+  }
+}
+
+}  // namespace Example
+
+inline bool ParseInParentNamespaceJson(flatbuffers::JsonReader &_json, flatbuffers::FlatBufferBuilder &_fbb, flatbuffers::Offset<InParentNamespace> *_o) {
+  if (!_json.StartObject()) return false;
+  while (_json.NextKey()) {
+    if (!_json.UnknownField()) return false;
+  }
+  if (!_json.ok()) return false;
+  const auto _start = _fbb.StartTable();
+  *_o = flatbuffers::Offset<InParentNamespace>(_fbb.EndTable(_start));
+  return true;
+}
+
+inline void PrintInParentNamespaceJson(flatbuffers::JsonWriter &_json, const InParentNamespace &_o) {
+  (void)_o;
+  _json.StartObject();
+  _json.EndObject();
+}
+
+namespace Example2 {
+
+inline bool ParseMonsterJson(flatbuffers::JsonReader &_json, flatbuffers::FlatBufferBuilder &_fbb, flatbuffers::Offset<Monster> *_o) {
+  if (!_json.StartObject()) return false;
+  while (_json.NextKey()) {
+    if (!_json.UnknownField()) return false;
+  }
+  if (!_json.ok()) return false;
+  const auto _start = _fbb.StartTable();
+  *_o = flatbuffers::Offset<Monster>(_fbb.EndTable(_start));
+  return true;
+}
+
+inline void PrintMonsterJson(flatbuffers::JsonWriter &_json, const Monster &_o) {
+  (void)_o;
+  _json.StartObject();
+  _json.EndObject();
+}
+
+}  // namespace Example2
+
+namespace Example {
+
+inline bool ParseTestJson(flatbuffers::JsonReader &_json, Test *_o) {
+  int16_t a_ = 0;
+  int8_t b_ = 0;
+  bool _seen[2] = {};
+  if (!_json.StartObject()) return false;
+  while (_json.NextKey()) {
+    switch (_json.key_hash()) {
+      case 12638996441114005292ULL:
+        if (_json.KeyIs("a", 1)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[0]) ||
+              !_json.ParseScalar(&a_))
+            return false;
+          continue;
+        }
+        break;
+      case 12638999739648889925ULL:
+        if (_json.KeyIs("b", 1)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[1]) ||
+              !_json.ParseScalar(&b_))
+            return false;
+          continue;
+        }
+        break;
+    }
+    if (!_json.UnknownField()) return false;
+  }
+  if (!_json.ok()) return false;
+  for (size_t _i = 0; _i < 2; _i++) {
+    if (!_seen[_i])
+      return _json.Error("struct: wrong number of initializers: Test");
+  }
+  *_o = Test(a_, b_);
+  return true;
+}
+
+inline void PrintTestJson(flatbuffers::JsonWriter &_json, const Test &_o) {
+  auto _s = reinterpret_cast<const flatbuffers::Struct *>(&_o);
+  _json.StartObject();
+  _json.Key("a");
+  _json.Scalar(_s->GetField<int16_t>(0));
+  _json.Key("b");
+  _json.Scalar(_s->GetField<int8_t>(2));
+  _json.EndObject();
+}
+
+inline bool ParseTestSimpleTableWithEnumJson(flatbuffers::JsonReader &_json, flatbuffers::FlatBufferBuilder &_fbb, flatbuffers::Offset<TestSimpleTableWithEnum> *_o) {
+  int8_t color_ = 2;
+  bool _seen[1] = {};
+  if (!_json.StartObject()) return false;
+  while (_json.NextKey()) {
+    switch (_json.key_hash()) {
+      case 13802233191497649624ULL:
+        if (_json.KeyIs("color", 5)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[0])) return false;
+          if (!_json.ParseScalar(&color_, ColorFromJsonName)) return false;
+          continue;
+        }
+        break;
+    }
+    if (!_json.UnknownField()) return false;
+  }
+  if (!_json.ok()) return false;
+  const auto _start = _fbb.StartTable();
+  if (_seen[0]) _fbb.AddElement<int8_t>(TestSimpleTableWithEnum::VT_COLOR, color_, 2);
+  *_o = flatbuffers::Offset<TestSimpleTableWithEnum>(_fbb.EndTable(_start));
+  return true;
+}
+
+inline void PrintTestSimpleTableWithEnumJson(flatbuffers::JsonWriter &_json, const TestSimpleTableWithEnum &_o) {
+  auto _t = reinterpret_cast<const flatbuffers::Table *>(&_o);
+  _json.StartObject();
+  if (_t->CheckField(TestSimpleTableWithEnum::VT_COLOR)) {
+    _json.Key("color");
+    _json.Enum(_t->GetField<int8_t>(TestSimpleTableWithEnum::VT_COLOR, 2), ColorJsonName);
+  }
+  _json.EndObject();
+}
+
+inline bool ParseVec3Json(flatbuffers::JsonReader &_json, Vec3 *_o) {
+  float x_ = 0;
+  float y_ = 0;
+  float z_ = 0;
+  double test1_ = 0;
+  int8_t test2_ = 0;
+  Test test3_;
+  bool _seen[6] = {};
+  if (!_json.StartObject()) return false;
+  while (_json.NextKey()) {
+    switch (_json.key_hash()) {
+      case 1579237753783488028ULL:
+        if (_json.KeyIs("test1", 5)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[3]) ||
+              !_json.ParseScalar(&test1_))
+            return false;
+          continue;
+        }
+        break;
+      case 1579239952806744450ULL:
+        if (_json.KeyIs("test3", 5)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[5]) ||
+              !ParseTestJson(_json, &test3_))
+            return false;
+          continue;
+        }
+        break;
+      case 1579241052318372661ULL:
+        if (_json.KeyIs("test2", 5)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[4]) ||
+              !_json.ParseScalar(&test2_, ColorFromJsonName))
+            return false;
+          continue;
+        }
+        break;
+      case 12639022829393082356ULL:
+        if (_json.KeyIs("y", 1)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[1]) ||
+              !_json.ParseScalar(&y_))
+            return false;
+          continue;
+        }
+        break;
+      case 12639023928904710567ULL:
+        if (_json.KeyIs("x", 1)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[0]) ||
+              !_json.ParseScalar(&x_))
+            return false;
+          continue;
+        }
+        break;
+      case 12639026127927966989ULL:
+        if (_json.KeyIs("z", 1)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[2]) ||
+              !_json.ParseScalar(&z_))
+            return false;
+          continue;
+        }
+        break;
+    }
+    if (!_json.UnknownField()) return false;
+  }
+  if (!_json.ok()) return false;
+  for (size_t _i = 0; _i < 6; _i++) {
+    if (!_seen[_i])
+      return _json.Error("struct: wrong number of initializers: Vec3");
+  }
+  *_o = Vec3(x_, y_, z_, test1_, static_cast<Color>(test2_), test3_);
+  return true;
+}
+
+inline void PrintVec3Json(flatbuffers::JsonWriter &_json, const Vec3 &_o) {
+  auto _s = reinterpret_cast<const flatbuffers::Struct *>(&_o);
+  _json.StartObject();
+  _json.Key("x");
+  _json.Scalar(_s->GetField<float>(0));
+  _json.Key("y");
+  _json.Scalar(_s->GetField<float>(4));
+  _json.Key("z");
+  _json.Scalar(_s->GetField<float>(8));
+  _json.Key("test1");
+  _json.Scalar(_s->GetField<double>(16));
+  _json.Key("test2");
+  _json.Enum(_s->GetField<int8_t>(24), ColorJsonName);
+  _json.Key("test3");
+  PrintTestJson(_json, *_s->GetStruct<const Test *>(26));
+  _json.EndObject();
+}
+
+inline bool ParseAbilityJson(flatbuffers::JsonReader &_json, Ability *_o) {
+  uint32_t id_ = 0;
+  uint32_t distance_ = 0;
+  bool _seen[2] = {};
+  if (!_json.StartObject()) return false;
+  while (_json.NextKey()) {
+    switch (_json.key_hash()) {
+      case 1331990200576435168ULL:
+        if (_json.KeyIs("id", 2)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[0]) ||
+              !_json.ParseScalar(&id_))
+            return false;
+          continue;
+        }
+        break;
+      case 7764009881384197986ULL:
+        if (_json.KeyIs("distance", 8)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[1]) ||
+              !_json.ParseScalar(&distance_))
+            return false;
+          continue;
+        }
+        break;
+    }
+    if (!_json.UnknownField()) return false;
+  }
+  if (!_json.ok()) return false;
+  for (size_t _i = 0; _i < 2; _i++) {
+    if (!_seen[_i])
+      return _json.Error("struct: wrong number of initializers: Ability");
+  }
+  *_o = Ability(id_, distance_);
+  return true;
+}
+
+inline void PrintAbilityJson(flatbuffers::JsonWriter &_json, const Ability &_o) {
+  auto _s = reinterpret_cast<const flatbuffers::Struct *>(&_o);
+  _json.StartObject();
+  _json.Key("id");
+  _json.Scalar(_s->GetField<uint32_t>(0));
+  _json.Key("distance");
+  _json.Scalar(_s->GetField<uint32_t>(4));
+  _json.EndObject();
+}
+
+inline bool ParseStatJson(flatbuffers::JsonReader &_json, flatbuffers::FlatBufferBuilder &_fbb, flatbuffers::Offset<Stat> *_o) {
+  flatbuffers::Offset<flatbuffers::String> id_;
+  int64_t val_ = 0;
+  uint16_t count_ = 0;
+  bool _seen[3] = {};
+  if (!_json.StartObject()) return false;
+  while (_json.NextKey()) {
+    switch (_json.key_hash()) {
+      case 1331990200576435168ULL:
+        if (_json.KeyIs("id", 2)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[0])) return false;
+          if (!_json.ParseString(_fbb, &id_)) return false;
+          continue;
+        }
+        break;
+      case 5722951594770981596ULL:
+        if (_json.KeyIs("val", 3)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[1])) return false;
+          if (!_json.ParseScalar(&val_)) return false;
+          continue;
+        }
+        break;
+      case 18221989560278266644ULL:
+        if (_json.KeyIs("count", 5)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[2])) return false;
+          if (!_json.ParseScalar(&count_)) return false;
+          continue;
+        }
+        break;
+    }
+    if (!_json.UnknownField()) return false;
+  }
+  if (!_json.ok()) return false;
+  const auto _start = _fbb.StartTable();
+  if (_seen[1]) _fbb.AddElement<int64_t>(Stat::VT_VAL, val_, 0);
+  if (_seen[0]) _fbb.AddOffset(Stat::VT_ID, id_);
+  if (_seen[2]) _fbb.AddElement<uint16_t>(Stat::VT_COUNT, count_, 0);
+  *_o = flatbuffers::Offset<Stat>(_fbb.EndTable(_start));
+  return true;
+}
+
+inline void PrintStatJson(flatbuffers::JsonWriter &_json, const Stat &_o) {
+  auto _t = reinterpret_cast<const flatbuffers::Table *>(&_o);
+  _json.StartObject();
+  if (_t->CheckField(Stat::VT_ID)) {
+    _json.Key("id");
+    _json.String(*_t->GetPointer<const flatbuffers::String *>(Stat::VT_ID));
+  }
+  if (_t->CheckField(Stat::VT_VAL)) {
+    _json.Key("val");
+    _json.Scalar(_t->GetField<int64_t>(Stat::VT_VAL, 0));
+  }
+  if (_t->CheckField(Stat::VT_COUNT)) {
+    _json.Key("count");
+    _json.Scalar(_t->GetField<uint16_t>(Stat::VT_COUNT, 0));
+  }
+  _json.EndObject();
+}
+
+inline bool ParseReferrableJson(flatbuffers::JsonReader &_json, flatbuffers::FlatBufferBuilder &_fbb, flatbuffers::Offset<Referrable> *_o) {
+  uint64_t id_ = 0;
+  bool _seen[1] = {};
+  if (!_json.StartObject()) return false;
+  while (_json.NextKey()) {
+    switch (_json.key_hash()) {
+      case 1331990200576435168ULL:
+        if (_json.KeyIs("id", 2)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[0])) return false;
+          if (!_json.ParseHash(&id_, flatbuffers::HashFnv1a<uint64_t>)) return false;
+          continue;
+        }
+        break;
+    }
+    if (!_json.UnknownField()) return false;
+  }
+  if (!_json.ok()) return false;
+  const auto _start = _fbb.StartTable();
+  if (_seen[0]) _fbb.AddElement<uint64_t>(Referrable::VT_ID, id_, 0);
+  *_o = flatbuffers::Offset<Referrable>(_fbb.EndTable(_start));
+  return true;
+}
+
+inline void PrintReferrableJson(flatbuffers::JsonWriter &_json, const Referrable &_o) {
+  auto _t = reinterpret_cast<const flatbuffers::Table *>(&_o);
+  _json.StartObject();
+  if (_t->CheckField(Referrable::VT_ID)) {
+    _json.Key("id");
+    _json.Scalar(_t->GetField<uint64_t>(Referrable::VT_ID, 0));
+  }
+  _json.EndObject();
+}
+
+inline bool ParseMonsterJson(flatbuffers::JsonReader &_json, flatbuffers::FlatBufferBuilder &_fbb, flatbuffers::Offset<Monster> *_o) {
+  Vec3 pos_;
+  int16_t mana_ = 150;
+  int16_t hp_ = 100;
+  flatbuffers::Offset<flatbuffers::String> name_;
+  uint8_t friendly_ = 0;
+  flatbuffers::Offset<flatbuffers::Vector<uint8_t>> inventory_;
+  int8_t color_ = 8;
+  uint8_t test_type_ = 0;
+  flatbuffers::Offset<void> test_;
+  const char *test_text_ = nullptr;
+  flatbuffers::Offset<flatbuffers::Vector<const Test *>> test4_;
+  flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>> testarrayofstring_;
+  flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<Monster>>> testarrayoftables_;
+  flatbuffers::Offset<Monster> enemy_;
+  flatbuffers::Offset<flatbuffers::Vector<uint8_t>> testnestedflatbuffer_;
+  flatbuffers::Offset<Stat> testempty_;
+  uint8_t testbool_ = 0;
+  int32_t testhashs32_fnv1_ = 0;
+  uint32_t testhashu32_fnv1_ = 0;
+  int64_t testhashs64_fnv1_ = 0;
+  uint64_t testhashu64_fnv1_ = 0;
+  int32_t testhashs32_fnv1a_ = 0;
+  uint32_t testhashu32_fnv1a_ = 0;
+  int64_t testhashs64_fnv1a_ = 0;
+  uint64_t testhashu64_fnv1a_ = 0;
+  flatbuffers::Offset<flatbuffers::Vector<uint8_t>> testarrayofbools_;
+  float testf_ = 3.14159f;
+  float testf2_ = 3.0f;
+  float testf3_ = 0.0f;
+  flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>> testarrayofstring2_;
+  flatbuffers::Offset<flatbuffers::Vector<const Ability *>> testarrayofsortedstruct_;
+  flatbuffers::Offset<flatbuffers::Vector<uint8_t>> flex_;
+  flatbuffers::Offset<flatbuffers::Vector<const Test *>> test5_;
+  flatbuffers::Offset<flatbuffers::Vector<int64_t>> vector_of_longs_;
+  flatbuffers::Offset<flatbuffers::Vector<double>> vector_of_doubles_;
+  flatbuffers::Offset<MyGame::InParentNamespace> parent_namespace_test_;
+  flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<Referrable>>> vector_of_referrables_;
+  uint64_t single_weak_reference_ = 0;
+  flatbuffers::Offset<flatbuffers::Vector<uint64_t>> vector_of_weak_references_;
+  flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<Referrable>>> vector_of_strong_referrables_;
+  uint64_t co_owning_reference_ = 0;
+  flatbuffers::Offset<flatbuffers::Vector<uint64_t>> vector_of_co_owning_references_;
+  uint64_t non_owning_reference_ = 0;
+  flatbuffers::Offset<flatbuffers::Vector<uint64_t>> vector_of_non_owning_references_;
+  bool _seen[43] = {};
+  if (!_json.StartObject()) return false;
+  while (_json.NextKey()) {
+    switch (_json.key_hash()) {
+      case 849412380330613488ULL:
+        if (_json.KeyIs("testarrayofbools", 16)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[24])) return false;
+          if (!_json.ParseVector(_fbb, &testarrayofbools_, [&](uint8_t *_e) {
+                return _json.ParseBool(_e);
+              }))
+            return false;
+          continue;
+        }
+        break;
+      case 1332863212809045477ULL:
+        if (_json.KeyIs("hp", 2)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[2])) return false;
+          if (!_json.ParseScalar(&hp_)) return false;
+          continue;
+        }
+        break;
+      case 1579148693341602937ULL:
+        if (_json.KeyIs("testf", 5)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[25])) return false;
+          if (!_json.ParseScalar(&testf_)) return false;
+          continue;
+        }
+        break;
+      case 1579233355736975184ULL:
+        if (_json.KeyIs("test5", 5)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[31])) return false;
+          if (!_json.ParseStructVector(_fbb, &test5_, [&](Test *_e) {
+                return ParseTestJson(_json, _e);
+              }))
+            return false;
+          continue;
+        }
+        break;
+      case 1579234455248603395ULL:
+        if (_json.KeyIs("test4", 5)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[9])) return false;
+          if (!_json.ParseStructVector(_fbb, &test4_, [&](Test *_e) {
+                return ParseTestJson(_json, _e);
+              }))
+            return false;
+          continue;
+        }
+        break;
+      case 3660729852578883600ULL:
+        if (_json.KeyIs("testarrayofstring2", 18)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[28])) return false;
+          if (!_json.ParseVector(_fbb, &testarrayofstring2_, [&](flatbuffers::Offset<flatbuffers::String> *_e) {
+                return _json.ParseString(_fbb, _e);
+              }))
+            return false;
+          continue;
+        }
+        break;
+      case 3723849852751644070ULL:
+        if (_json.KeyIs("name", 4)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[3])) return false;
+          if (!_json.ParseString(_fbb, &name_)) return false;
+          continue;
+        }
+        break;
+      case 3832344346046409555ULL:
+        if (_json.KeyIs("testnestedflatbuffer", 20)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[13])) return false;
+          if (!_json.ParseNestedFlatBuffer<Monster>(_fbb, &testnestedflatbuffer_, ParseMonsterJson)) return false;
+          continue;
+        }
+        break;
+      case 3953782575463089258ULL:
+        if (_json.KeyIs("testhashu32_fnv1a", 17)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[21])) return false;
+          if (!_json.ParseHash(&testhashu32_fnv1a_, flatbuffers::HashFnv1a<uint32_t>)) return false;
+          continue;
+        }
+        break;
+      case 4449896613926113423ULL:
+        if (_json.KeyIs("testhashu32_fnv1", 16)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[17])) return false;
+          if (!_json.ParseHash(&testhashu32_fnv1_, flatbuffers::HashFnv1<uint32_t>)) return false;
+          continue;
+        }
+        break;
+      case 4604717797205585057ULL:
+        if (_json.KeyIs("testhashu64_fnv1a", 17)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[23])) return false;
+          if (!_json.ParseHash(&testhashu64_fnv1a_, flatbuffers::HashFnv1a<uint64_t>)) return false;
+          continue;
+        }
+        break;
+      case 5292433532645469250ULL:
+        if (_json.KeyIs("co_owning_reference", 19)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[39])) return false;
+          if (!_json.ParseHash(&co_owning_reference_, flatbuffers::HashFnv1a<uint64_t>)) return false;
+          continue;
+        }
+        break;
+      case 5618316676019296225ULL:
+        if (_json.KeyIs("vector_of_co_owning_references", 30)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[40])) return false;
+          if (!_json.ParseVector(_fbb, &vector_of_co_owning_references_, [&](uint64_t *_e) {
+                return _json.ParseHash(_e, flatbuffers::HashFnv1a<uint64_t>);
+              }))
+            return false;
+          continue;
+        }
+        break;
+      case 5671318325839275278ULL:
+        if (_json.KeyIs("vector_of_longs", 15)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[32])) return false;
+          if (!_json.ParseVector(_fbb, &vector_of_longs_, [&](int64_t *_e) {
+                return _json.ParseScalar(_e);
+              }))
+            return false;
+          continue;
+        }
+        break;
+      case 6996292581071551615ULL:
+        if (_json.KeyIs("inventory", 9)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[5])) return false;
+          if (!_json.ParseVector(_fbb, &inventory_, [&](uint8_t *_e) {
+                return _json.ParseScalar(_e);
+              }))
+            return false;
+          continue;
+        }
+        break;
+      case 7019206534860460553ULL:
+        if (_json.KeyIs("pos", 3)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[0])) return false;
+          if (!ParseVec3Json(_json, &pos_)) return false;
+          continue;
+        }
+        break;
+      case 7136966255761152502ULL:
+        if (_json.KeyIs("parent_namespace_test", 21)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[34])) return false;
+          if (!MyGame::ParseInParentNamespaceJson(_json, _fbb, &parent_namespace_test_)) return false;
+          continue;
+        }
+        break;
+      case 7139546713552406974ULL:
+        if (_json.KeyIs("testf3", 6)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[27])) return false;
+          if (!_json.ParseScalar(&testf3_)) return false;
+          continue;
+        }
+        break;
+      case 7139547813064035185ULL:
+        if (_json.KeyIs("testf2", 6)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[26])) return false;
+          if (!_json.ParseScalar(&testf2_)) return false;
+          continue;
+        }
+        break;
+      case 8488589182274030603ULL:
+        if (_json.KeyIs("testarrayofsortedstruct", 23)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[29])) return false;
+          if (!_json.ParseStructVector(_fbb, &testarrayofsortedstruct_, [&](Ability *_e) {
+                return ParseAbilityJson(_json, _e);
+              }))
+            return false;
+          continue;
+        }
+        break;
+      case 8823109925680085782ULL:
+        if (_json.KeyIs("vector_of_weak_references", 25)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[37])) return false;
+          if (!_json.ParseVector(_fbb, &vector_of_weak_references_, [&](uint64_t *_e) {
+                return _json.ParseHash(_e, flatbuffers::HashFnv1a<uint64_t>);
+              }))
+            return false;
+          continue;
+        }
+        break;
+      case 9154866974497338747ULL:
+        if (_json.KeyIs("non_owning_reference", 20)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[41])) return false;
+          if (!_json.ParseHash(&non_owning_reference_, flatbuffers::HashFnv1a<uint64_t>)) return false;
+          continue;
+        }
+        break;
+      case 9500922428855546308ULL:
+        if (_json.KeyIs("testhashs32_fnv1a", 17)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[20])) return false;
+          if (!_json.ParseHash(&testhashs32_fnv1a_, flatbuffers::HashFnv1a<uint32_t>)) return false;
+          continue;
+        }
+        break;
+      case 9875348813340489550ULL:
+        if (_json.KeyIs("testempty", 9)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[14])) return false;
+          if (!ParseStatJson(_json, _fbb, &testempty_)) return false;
+          continue;
+        }
+        break;
+      case 9887572513510024427ULL:
+        if (_json.KeyIs("enemy", 5)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[12])) return false;
+          if (!ParseMonsterJson(_json, _fbb, &enemy_)) return false;
+          continue;
+        }
+        break;
+      case 11194811158672889330ULL:
+        if (_json.KeyIs("flex", 4)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[30])) return false;
+          if (!_json.ParseFlexBuffer(_fbb, &flex_)) return false;
+          continue;
+        }
+        break;
+      case 11768054756621862718ULL:
+        if (_json.KeyIs("friendly", 8)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[4])) return false;
+          if (!_json.ParseBool(&friendly_)) return false;
+          continue;
+        }
+        break;
+      case 13111460237977553092ULL:
+        if (_json.KeyIs("single_weak_reference", 21)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[36])) return false;
+          if (!_json.ParseHash(&single_weak_reference_, flatbuffers::HashFnv1a<uint64_t>)) return false;
+          continue;
+        }
+        break;
+      case 13802233191497649624ULL:
+        if (_json.KeyIs("color", 5)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[6])) return false;
+          if (!_json.ParseScalar(&color_, ColorFromJsonName)) return false;
+          continue;
+        }
+        break;
+      case 14034059651497366341ULL:
+        if (_json.KeyIs("test", 4)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[8])) return false;
+          if (!_seen[7]) {
+            test_text_ = _json.cursor();
+            if (!_json.SkipValue()) return false;
+            continue;
+          }
+          if (!ParseAnyJson(_json, _fbb, static_cast<Any>(test_type_), &test_)) return false;
+          continue;
+        }
+        break;
+      case 14885696661185287251ULL:
+        if (_json.KeyIs("vector_of_doubles", 17)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[33])) return false;
+          if (!_json.ParseVector(_fbb, &vector_of_doubles_, [&](double *_e) {
+                return _json.ParseScalar(_e);
+              }))
+            return false;
+          continue;
+        }
+        break;
+      case 15403372039305091598ULL:
+        if (_json.KeyIs("testarrayoftables", 17)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[11])) return false;
+          if (!_json.ParseVector(_fbb, &testarrayoftables_, [&](flatbuffers::Offset<Monster> *_e) {
+                return ParseMonsterJson(_json, _fbb, _e);
+              }))
+            return false;
+          continue;
+        }
+        break;
+      case 15561622869014990722ULL:
+        if (_json.KeyIs("testarrayofstring", 17)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[10])) return false;
+          if (!_json.ParseVector(_fbb, &testarrayofstring_, [&](flatbuffers::Offset<flatbuffers::String> *_e) {
+                return _json.ParseString(_fbb, _e);
+              }))
+            return false;
+          continue;
+        }
+        break;
+      case 15616638138407522004ULL:
+        if (_json.KeyIs("testhashs64_fnv1", 16)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[18])) return false;
+          if (!_json.ParseHash(&testhashs64_fnv1_, flatbuffers::HashFnv1<uint64_t>)) return false;
+          continue;
+        }
+        break;
+      case 15864722631238614415ULL:
+        if (_json.KeyIs("testhashs64_fnv1a", 17)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[22])) return false;
+          if (!_json.ParseHash(&testhashs64_fnv1a_, flatbuffers::HashFnv1a<uint64_t>)) return false;
+          continue;
+        }
+        break;
+      case 16240589190456590392ULL:
+        if (_json.KeyIs("vector_of_referrables", 21)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[35])) return false;
+          if (!_json.ParseVector(_fbb, &vector_of_referrables_, [&](flatbuffers::Offset<Referrable> *_e) {
+                return ParseReferrableJson(_json, _fbb, _e);
+              }))
+            return false;
+          continue;
+        }
+        break;
+      case 16490609093273660810ULL:
+        if (_json.KeyIs("mana", 4)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[1])) return false;
+          if (!_json.ParseScalar(&mana_)) return false;
+          continue;
+        }
+        break;
+      case 16659982906745568589ULL:
+        if (_json.KeyIs("testhashs32_fnv1", 16)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[16])) return false;
+          if (!_json.ParseHash(&testhashs32_fnv1_, flatbuffers::HashFnv1<uint32_t>)) return false;
+          continue;
+        }
+        break;
+      case 17079661358424854749ULL:
+        if (_json.KeyIs("testbool", 8)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[15])) return false;
+          if (!_json.ParseBool(&testbool_)) return false;
+          continue;
+        }
+        break;
+      case 17235589162519012802ULL:
+        if (_json.KeyIs("vector_of_strong_referrables", 28)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[38])) return false;
+          if (!_json.ParseVector(_fbb, &vector_of_strong_referrables_, [&](flatbuffers::Offset<Referrable> *_e) {
+                return ParseReferrableJson(_json, _fbb, _e);
+              }))
+            return false;
+          continue;
+        }
+        break;
+      case 17536961480105139022ULL:
+        if (_json.KeyIs("test_type", 9)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[7])) return false;
+          if (!_json.ParseScalar(&test_type_, AnyFromJsonName)) return false;
+          continue;
+        }
+        break;
+      case 17568348816577420646ULL:
+        if (_json.KeyIs("vector_of_non_owning_references", 31)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[42])) return false;
+          if (!_json.ParseVector(_fbb, &vector_of_non_owning_references_, [&](uint64_t *_e) {
+                return _json.ParseHash(_e, flatbuffers::HashFnv1a<uint64_t>);
+              }))
+            return false;
+          continue;
+        }
+        break;
+      case 18405042351349933626ULL:
+        if (_json.KeyIs("testhashu64_fnv1", 16)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[19])) return false;
+          if (!_json.ParseHash(&testhashu64_fnv1_, flatbuffers::HashFnv1<uint64_t>)) return false;
+          continue;
+        }
+        break;
+    }
+    if (!_json.UnknownField()) return false;
+  }
+  if (!_json.ok()) return false;
+  if (!_seen[3])
+    return _json.Error("required field is missing: name in Monster");
+  if (test_text_) {
+    if (!_seen[7])
+      return _json.Error("missing type field for this union value: test_type");
+    auto _end = _json.cursor();
+    _json.Seek(test_text_);
+    if (!ParseAnyJson(_json, _fbb, static_cast<Any>(test_type_), &test_))
+      return false;
+    _json.Seek(_end);
+  }
+  const auto _start = _fbb.StartTable();
+  if (_seen[41]) _fbb.AddElement<uint64_t>(Monster::VT_NON_OWNING_REFERENCE, non_owning_reference_, 0);
+  if (_seen[39]) _fbb.AddElement<uint64_t>(Monster::VT_CO_OWNING_REFERENCE, co_owning_reference_, 0);
+  if (_seen[36]) _fbb.AddElement<uint64_t>(Monster::VT_SINGLE_WEAK_REFERENCE, single_weak_reference_, 0);
+  if (_seen[23]) _fbb.AddElement<uint64_t>(Monster::VT_TESTHASHU64_FNV1A, testhashu64_fnv1a_, 0);
+  if (_seen[22]) _fbb.AddElement<int64_t>(Monster::VT_TESTHASHS64_FNV1A, testhashs64_fnv1a_, 0);
+  if (_seen[19]) _fbb.AddElement<uint64_t>(Monster::VT_TESTHASHU64_FNV1, testhashu64_fnv1_, 0);
+  if (_seen[18]) _fbb.AddElement<int64_t>(Monster::VT_TESTHASHS64_FNV1, testhashs64_fnv1_, 0);
+  if (_seen[42]) _fbb.AddOffset(Monster::VT_VECTOR_OF_NON_OWNING_REFERENCES, vector_of_non_owning_references_);
+  if (_seen[40]) _fbb.AddOffset(Monster::VT_VECTOR_OF_CO_OWNING_REFERENCES, vector_of_co_owning_references_);
+  if (_seen[38]) _fbb.AddOffset(Monster::VT_VECTOR_OF_STRONG_REFERRABLES, vector_of_strong_referrables_);
+  if (_seen[37]) _fbb.AddOffset(Monster::VT_VECTOR_OF_WEAK_REFERENCES, vector_of_weak_references_);
+  if (_seen[35]) _fbb.AddOffset(Monster::VT_VECTOR_OF_REFERRABLES, vector_of_referrables_);
+  if (_seen[34]) _fbb.AddOffset(Monster::VT_PARENT_NAMESPACE_TEST, parent_namespace_test_);
+  if (_seen[33]) _fbb.AddOffset(Monster::VT_VECTOR_OF_DOUBLES, vector_of_doubles_);
+  if (_seen[32]) _fbb.AddOffset(Monster::VT_VECTOR_OF_LONGS, vector_of_longs_);
+  if (_seen[31]) _fbb.AddOffset(Monster::VT_TEST5, test5_);
+  if (_seen[30]) _fbb.AddOffset(Monster::VT_FLEX, flex_);
+  if (_seen[29]) _fbb.AddOffset(Monster::VT_TESTARRAYOFSORTEDSTRUCT, testarrayofsortedstruct_);
+  if (_seen[28]) _fbb.AddOffset(Monster::VT_TESTARRAYOFSTRING2, testarrayofstring2_);
+  if (_seen[27]) _fbb.AddElement<float>(Monster::VT_TESTF3, testf3_, 0.0f);
+  if (_seen[26]) _fbb.AddElement<float>(Monster::VT_TESTF2, testf2_, 3.0f);
+  if (_seen[25]) _fbb.AddElement<float>(Monster::VT_TESTF, testf_, 3.14159f);
+  if (_seen[24]) _fbb.AddOffset(Monster::VT_TESTARRAYOFBOOLS, testarrayofbools_);
+  if (_seen[21]) _fbb.AddElement<uint32_t>(Monster::VT_TESTHASHU32_FNV1A, testhashu32_fnv1a_, 0);
+  if (_seen[20]) _fbb.AddElement<int32_t>(Monster::VT_TESTHASHS32_FNV1A, testhashs32_fnv1a_, 0);
+  if (_seen[17]) _fbb.AddElement<uint32_t>(Monster::VT_TESTHASHU32_FNV1, testhashu32_fnv1_, 0);
+  if (_seen[16]) _fbb.AddElement<int32_t>(Monster::VT_TESTHASHS32_FNV1, testhashs32_fnv1_, 0);
+  if (_seen[14]) _fbb.AddOffset(Monster::VT_TESTEMPTY, testempty_);
+  if (_seen[13]) _fbb.AddOffset(Monster::VT_TESTNESTEDFLATBUFFER, testnestedflatbuffer_);
+  if (_seen[12]) _fbb.AddOffset(Monster::VT_ENEMY, enemy_);
+  if (_seen[11]) _fbb.AddOffset(Monster::VT_TESTARRAYOFTABLES, testarrayoftables_);
+  if (_seen[10]) _fbb.AddOffset(Monster::VT_TESTARRAYOFSTRING, testarrayofstring_);
+  if (_seen[9]) _fbb.AddOffset(Monster::VT_TEST4, test4_);
+  if (_seen[8]) _fbb.AddOffset(Monster::VT_TEST, test_);
+  if (_seen[5]) _fbb.AddOffset(Monster::VT_INVENTORY, inventory_);
+  if (_seen[3]) _fbb.AddOffset(Monster::VT_NAME, name_);
+  if (_seen[0]) _fbb.AddStruct(Monster::VT_POS, &pos_);
+  if (_seen[2]) _fbb.AddElement<int16_t>(Monster::VT_HP, hp_, 100);
+  if (_seen[1]) _fbb.AddElement<int16_t>(Monster::VT_MANA, mana_, 150);
+  if (_seen[15]) _fbb.AddElement<uint8_t>(Monster::VT_TESTBOOL, testbool_, 0);
+  if (_seen[7]) _fbb.AddElement<uint8_t>(Monster::VT_TEST_TYPE, test_type_, 0);
+  if (_seen[6]) _fbb.AddElement<int8_t>(Monster::VT_COLOR, color_, 8);
+  if (_seen[4]) _fbb.AddElement<uint8_t>(12, friendly_, 0);
+  *_o = flatbuffers::Offset<Monster>(_fbb.EndTable(_start));
+  return true;
+}
+
+inline void PrintMonsterJson(flatbuffers::JsonWriter &_json, const Monster &_o) {
+  auto _t = reinterpret_cast<const flatbuffers::Table *>(&_o);
+  _json.StartObject();
+  if (_t->CheckField(Monster::VT_POS)) {
+    _json.Key("pos");
+    PrintVec3Json(_json, *_t->GetStruct<const Vec3 *>(Monster::VT_POS));
+  }
+  if (_t->CheckField(Monster::VT_MANA)) {
+    _json.Key("mana");
+    _json.Scalar(_t->GetField<int16_t>(Monster::VT_MANA, 150));
+  }
+  if (_t->CheckField(Monster::VT_HP)) {
+    _json.Key("hp");
+    _json.Scalar(_t->GetField<int16_t>(Monster::VT_HP, 100));
+  }
+  if (_t->CheckField(Monster::VT_NAME)) {
+    _json.Key("name");
+    _json.String(*_t->GetPointer<const flatbuffers::String *>(Monster::VT_NAME));
+  }
+  if (_t->CheckField(12)) {
+    _json.Key("friendly");
+    _json.Scalar(_t->GetField<uint8_t>(12, 0) != 0);
+  }
+  if (_t->CheckField(Monster::VT_INVENTORY)) {
+    _json.Key("inventory");
+    _json.ScalarVector(*_t->GetPointer<const flatbuffers::Vector<uint8_t> *>(Monster::VT_INVENTORY));
+  }
+  if (_t->CheckField(Monster::VT_COLOR)) {
+    _json.Key("color");
+    _json.Enum(_t->GetField<int8_t>(Monster::VT_COLOR, 8), ColorJsonName);
+  }
+  if (_t->CheckField(Monster::VT_TEST_TYPE)) {
+    _json.Key("test_type");
+    _json.Enum(_t->GetField<uint8_t>(Monster::VT_TEST_TYPE, 0), AnyJsonName);
+  }
+  if (_t->CheckField(Monster::VT_TEST)) {
+    _json.Key("test");
+    PrintAnyJson(_json, _t->GetPointer<const void *>(Monster::VT_TEST),
+        static_cast<Any>(_t->GetField<uint8_t>(Monster::VT_TEST_TYPE, 0)));
+  }
+  if (_t->CheckField(Monster::VT_TEST4)) {
+    _json.Key("test4");
+    auto _v = _t->GetPointer<const flatbuffers::Vector<const Test *> *>(Monster::VT_TEST4);
+    _json.StartArray();
+    for (flatbuffers::uoffset_t _i = 0; _i < _v->size(); _i++) {
+      _json.Element();
+      PrintTestJson(_json, *_v->Get(_i));
+    }
+    _json.EndArray();
+  }
+  if (_t->CheckField(Monster::VT_TESTARRAYOFSTRING)) {
+    _json.Key("testarrayofstring");
+    _json.StringVector(*_t->GetPointer<const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *>(Monster::VT_TESTARRAYOFSTRING));
+  }
+  if (_t->CheckField(Monster::VT_TESTARRAYOFTABLES)) {
+    _json.Key("testarrayoftables");
+    auto _v = _t->GetPointer<const flatbuffers::Vector<flatbuffers::Offset<Monster>> *>(Monster::VT_TESTARRAYOFTABLES);
+    _json.StartArray();
+    for (flatbuffers::uoffset_t _i = 0; _i < _v->size(); _i++) {
+      _json.Element();
+      PrintMonsterJson(_json, *_v->Get(_i));
+    }
+    _json.EndArray();
+  }
+  if (_t->CheckField(Monster::VT_ENEMY)) {
+    _json.Key("enemy");
+    PrintMonsterJson(_json, *_t->GetPointer<const Monster *>(Monster::VT_ENEMY));
+  }
+  if (_t->CheckField(Monster::VT_TESTNESTEDFLATBUFFER)) {
+    _json.Key("testnestedflatbuffer");
+    PrintMonsterJson(_json, *flatbuffers::GetRoot<Monster>(
+        _t->GetPointer<const flatbuffers::Vector<uint8_t> *>(Monster::VT_TESTNESTEDFLATBUFFER)->data()));
+  }
+  if (_t->CheckField(Monster::VT_TESTEMPTY)) {
+    _json.Key("testempty");
+    PrintStatJson(_json, *_t->GetPointer<const Stat *>(Monster::VT_TESTEMPTY));
+  }
+  if (_t->CheckField(Monster::VT_TESTBOOL)) {
+    _json.Key("testbool");
+    _json.Scalar(_t->GetField<uint8_t>(Monster::VT_TESTBOOL, 0) != 0);
+  }
+  if (_t->CheckField(Monster::VT_TESTHASHS32_FNV1)) {
+    _json.Key("testhashs32_fnv1");
+    _json.Scalar(_t->GetField<int32_t>(Monster::VT_TESTHASHS32_FNV1, 0));
+  }
+  if (_t->CheckField(Monster::VT_TESTHASHU32_FNV1)) {
+    _json.Key("testhashu32_fnv1");
+    _json.Scalar(_t->GetField<uint32_t>(Monster::VT_TESTHASHU32_FNV1, 0));
+  }
+  if (_t->CheckField(Monster::VT_TESTHASHS64_FNV1)) {
+    _json.Key("testhashs64_fnv1");
+    _json.Scalar(_t->GetField<int64_t>(Monster::VT_TESTHASHS64_FNV1, 0));
+  }
+  if (_t->CheckField(Monster::VT_TESTHASHU64_FNV1)) {
+    _json.Key("testhashu64_fnv1");
+    _json.Scalar(_t->GetField<uint64_t>(Monster::VT_TESTHASHU64_FNV1, 0));
+  }
+  if (_t->CheckField(Monster::VT_TESTHASHS32_FNV1A)) {
+    _json.Key("testhashs32_fnv1a");
+    _json.Scalar(_t->GetField<int32_t>(Monster::VT_TESTHASHS32_FNV1A, 0));
+  }
+  if (_t->CheckField(Monster::VT_TESTHASHU32_FNV1A)) {
+    _json.Key("testhashu32_fnv1a");
+    _json.Scalar(_t->GetField<uint32_t>(Monster::VT_TESTHASHU32_FNV1A, 0));
+  }
+  if (_t->CheckField(Monster::VT_TESTHASHS64_FNV1A)) {
+    _json.Key("testhashs64_fnv1a");
+    _json.Scalar(_t->GetField<int64_t>(Monster::VT_TESTHASHS64_FNV1A, 0));
+  }
+  if (_t->CheckField(Monster::VT_TESTHASHU64_FNV1A)) {
+    _json.Key("testhashu64_fnv1a");
+    _json.Scalar(_t->GetField<uint64_t>(Monster::VT_TESTHASHU64_FNV1A, 0));
+  }
+  if (_t->CheckField(Monster::VT_TESTARRAYOFBOOLS)) {
+    _json.Key("testarrayofbools");
+    auto _v = _t->GetPointer<const flatbuffers::Vector<uint8_t> *>(Monster::VT_TESTARRAYOFBOOLS);
+    _json.StartArray();
+    for (flatbuffers::uoffset_t _i = 0; _i < _v->size(); _i++) {
+      _json.Element();
+      _json.Scalar(_v->Get(_i) != 0);
+    }
+    _json.EndArray();
+  }
+  if (_t->CheckField(Monster::VT_TESTF)) {
+    _json.Key("testf");
+    _json.Scalar(_t->GetField<float>(Monster::VT_TESTF, 3.14159f));
+  }
+  if (_t->CheckField(Monster::VT_TESTF2)) {
+    _json.Key("testf2");
+    _json.Scalar(_t->GetField<float>(Monster::VT_TESTF2, 3.0f));
+  }
+  if (_t->CheckField(Monster::VT_TESTF3)) {
+    _json.Key("testf3");
+    _json.Scalar(_t->GetField<float>(Monster::VT_TESTF3, 0.0f));
+  }
+  if (_t->CheckField(Monster::VT_TESTARRAYOFSTRING2)) {
+    _json.Key("testarrayofstring2");
+    _json.StringVector(*_t->GetPointer<const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *>(Monster::VT_TESTARRAYOFSTRING2));
+  }
+  if (_t->CheckField(Monster::VT_TESTARRAYOFSORTEDSTRUCT)) {
+    _json.Key("testarrayofsortedstruct");
+    auto _v = _t->GetPointer<const flatbuffers::Vector<const Ability *> *>(Monster::VT_TESTARRAYOFSORTEDSTRUCT);
+    _json.StartArray();
+    for (flatbuffers::uoffset_t _i = 0; _i < _v->size(); _i++) {
+      _json.Element();
+      PrintAbilityJson(_json, *_v->Get(_i));
+    }
+    _json.EndArray();
+  }
+  if (_t->CheckField(Monster::VT_FLEX)) {
+    _json.Key("flex");
+    _json.FlexBuffer(*_t->GetPointer<const flatbuffers::Vector<uint8_t> *>(Monster::VT_FLEX));
+  }
+  if (_t->CheckField(Monster::VT_TEST5)) {
+    _json.Key("test5");
+    auto _v = _t->GetPointer<const flatbuffers::Vector<const Test *> *>(Monster::VT_TEST5);
+    _json.StartArray();
+    for (flatbuffers::uoffset_t _i = 0; _i < _v->size(); _i++) {
+      _json.Element();
+      PrintTestJson(_json, *_v->Get(_i));
+    }
+    _json.EndArray();
+  }
+  if (_t->CheckField(Monster::VT_VECTOR_OF_LONGS)) {
+    _json.Key("vector_of_longs");
+    _json.ScalarVector(*_t->GetPointer<const flatbuffers::Vector<int64_t> *>(Monster::VT_VECTOR_OF_LONGS));
+  }
+  if (_t->CheckField(Monster::VT_VECTOR_OF_DOUBLES)) {
+    _json.Key("vector_of_doubles");
+    _json.ScalarVector(*_t->GetPointer<const flatbuffers::Vector<double> *>(Monster::VT_VECTOR_OF_DOUBLES));
+  }
+  if (_t->CheckField(Monster::VT_PARENT_NAMESPACE_TEST)) {
+    _json.Key("parent_namespace_test");
+    MyGame::PrintInParentNamespaceJson(_json, *_t->GetPointer<const MyGame::InParentNamespace *>(Monster::VT_PARENT_NAMESPACE_TEST));
+  }
+  if (_t->CheckField(Monster::VT_VECTOR_OF_REFERRABLES)) {
+    _json.Key("vector_of_referrables");
+    auto _v = _t->GetPointer<const flatbuffers::Vector<flatbuffers::Offset<Referrable>> *>(Monster::VT_VECTOR_OF_REFERRABLES);
+    _json.StartArray();
+    for (flatbuffers::uoffset_t _i = 0; _i < _v->size(); _i++) {
+      _json.Element();
+      PrintReferrableJson(_json, *_v->Get(_i));
+    }
+    _json.EndArray();
+  }
+  if (_t->CheckField(Monster::VT_SINGLE_WEAK_REFERENCE)) {
+    _json.Key("single_weak_reference");
+    _json.Scalar(_t->GetField<uint64_t>(Monster::VT_SINGLE_WEAK_REFERENCE, 0));
+  }
+  if (_t->CheckField(Monster::VT_VECTOR_OF_WEAK_REFERENCES)) {
+    _json.Key("vector_of_weak_references");
+    _json.ScalarVector(*_t->GetPointer<const flatbuffers::Vector<uint64_t> *>(Monster::VT_VECTOR_OF_WEAK_REFERENCES));
+  }
+  if (_t->CheckField(Monster::VT_VECTOR_OF_STRONG_REFERRABLES)) {
+    _json.Key("vector_of_strong_referrables");
+    auto _v = _t->GetPointer<const flatbuffers::Vector<flatbuffers::Offset<Referrable>> *>(Monster::VT_VECTOR_OF_STRONG_REFERRABLES);
+    _json.StartArray();
+    for (flatbuffers::uoffset_t _i = 0; _i < _v->size(); _i++) {
+      _json.Element();
+      PrintReferrableJson(_json, *_v->Get(_i));
+    }
+    _json.EndArray();
+  }
+  if (_t->CheckField(Monster::VT_CO_OWNING_REFERENCE)) {
+    _json.Key("co_owning_reference");
+    _json.Scalar(_t->GetField<uint64_t>(Monster::VT_CO_OWNING_REFERENCE, 0));
+  }
+  if (_t->CheckField(Monster::VT_VECTOR_OF_CO_OWNING_REFERENCES)) {
+    _json.Key("vector_of_co_owning_references");
+    _json.ScalarVector(*_t->GetPointer<const flatbuffers::Vector<uint64_t> *>(Monster::VT_VECTOR_OF_CO_OWNING_REFERENCES));
+  }
+  if (_t->CheckField(Monster::VT_NON_OWNING_REFERENCE)) {
+    _json.Key("non_owning_reference");
+    _json.Scalar(_t->GetField<uint64_t>(Monster::VT_NON_OWNING_REFERENCE, 0));
+  }
+  if (_t->CheckField(Monster::VT_VECTOR_OF_NON_OWNING_REFERENCES)) {
+    _json.Key("vector_of_non_owning_references");
+    _json.ScalarVector(*_t->GetPointer<const flatbuffers::Vector<uint64_t> *>(Monster::VT_VECTOR_OF_NON_OWNING_REFERENCES));
+  }
+  _json.EndObject();
+}
+
+inline bool ParseTypeAliasesJson(flatbuffers::JsonReader &_json, flatbuffers::FlatBufferBuilder &_fbb, flatbuffers::Offset<TypeAliases> *_o) {
+  int8_t i8_ = 0;
+  uint8_t u8_ = 0;
+  int16_t i16_ = 0;
+  uint16_t u16_ = 0;
+  int32_t i32_ = 0;
+  uint32_t u32_ = 0;
+  int64_t i64_ = 0;
+  uint64_t u64_ = 0;
+  float f32_ = 0.0f;
+  double f64_ = 0.0;
+  flatbuffers::Offset<flatbuffers::Vector<int8_t>> v8_;
+  flatbuffers::Offset<flatbuffers::Vector<double>> vf64_;
+  bool _seen[12] = {};
+  if (!_json.StartObject()) return false;
+  while (_json.NextKey()) {
+    switch (_json.key_hash()) {
+      case 1332091355646230580ULL:
+        if (_json.KeyIs("i8", 2)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[0])) return false;
+          if (!_json.ParseScalar(&i8_)) return false;
+          continue;
+        }
+        break;
+      case 1335882471739545208ULL:
+        if (_json.KeyIs("u8", 2)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[1])) return false;
+          if (!_json.ParseScalar(&u8_)) return false;
+          continue;
+        }
+        break;
+      case 1338699420530454115ULL:
+        if (_json.KeyIs("v8", 2)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[10])) return false;
+          if (!_json.ParseVector(_fbb, &v8_, [&](int8_t *_e) {
+                return _json.ParseScalar(_e);
+              }))
+            return false;
+          continue;
+        }
+        break;
+      case 1368125785669869670ULL:
+        if (_json.KeyIs("i64", 3)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[6])) return false;
+          if (!_json.ParseScalar(&i64_)) return false;
+          continue;
+        }
+        break;
+      case 1371098865111984539ULL:
+        if (_json.KeyIs("i16", 3)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[2])) return false;
+          if (!_json.ParseScalar(&i16_)) return false;
+          continue;
+        }
+        break;
+      case 1372915258321410661ULL:
+        if (_json.KeyIs("i32", 3)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[4])) return false;
+          if (!_json.ParseScalar(&i32_)) return false;
+          continue;
+        }
+        break;
+      case 3837123126629783135ULL:
+        if (_json.KeyIs("u16", 3)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[3])) return false;
+          if (!_json.ParseScalar(&u16_)) return false;
+          continue;
+        }
+        break;
+      case 3838965908118286321ULL:
+        if (_json.KeyIs("u32", 3)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[5])) return false;
+          if (!_json.ParseScalar(&u32_)) return false;
+          continue;
+        }
+        break;
+      case 3841908201234811282ULL:
+        if (_json.KeyIs("u64", 3)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[7])) return false;
+          if (!_json.ParseScalar(&u64_)) return false;
+          continue;
+        }
+        break;
+      case 4998188509141613439ULL:
+        if (_json.KeyIs("vf64", 4)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[11])) return false;
+          if (!_json.ParseVector(_fbb, &vf64_, [&](double *_e) {
+                return _json.ParseScalar(_e);
+              }))
+            return false;
+          continue;
+        }
+        break;
+      case 14108423202161240548ULL:
+        if (_json.KeyIs("f32", 3)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[8])) return false;
+          if (!_json.ParseScalar(&f32_)) return false;
+          continue;
+        }
+        break;
+      case 14113203878719755851ULL:
+        if (_json.KeyIs("f64", 3)) {
+          if (_json.SkipNull()) continue;
+          if (!_json.SetOnce(&_seen[9])) return false;
+          if (!_json.ParseScalar(&f64_)) return false;
+          continue;
+        }
+        break;
+    }
+    if (!_json.UnknownField()) return false;
+  }
+  if (!_json.ok()) return false;
+  const auto _start = _fbb.StartTable();
+  if (_seen[9]) _fbb.AddElement<double>(TypeAliases::VT_F64, f64_, 0.0);
+  if (_seen[7]) _fbb.AddElement<uint64_t>(TypeAliases::VT_U64, u64_, 0);
+  if (_seen[6]) _fbb.AddElement<int64_t>(TypeAliases::VT_I64, i64_, 0);
+  if (_seen[11]) _fbb.AddOffset(TypeAliases::VT_VF64, vf64_);
+  if (_seen[10]) _fbb.AddOffset(TypeAliases::VT_V8, v8_);
+  if (_seen[8]) _fbb.AddElement<float>(TypeAliases::VT_F32, f32_, 0.0f);
+  if (_seen[5]) _fbb.AddElement<uint32_t>(TypeAliases::VT_U32, u32_, 0);
+  if (_seen[4]) _fbb.AddElement<int32_t>(TypeAliases::VT_I32, i32_, 0);
+  if (_seen[3]) _fbb.AddElement<uint16_t>(TypeAliases::VT_U16, u16_, 0);
+  if (_seen[2]) _fbb.AddElement<int16_t>(TypeAliases::VT_I16, i16_, 0);
+  if (_seen[1]) _fbb.AddElement<uint8_t>(TypeAliases::VT_U8, u8_, 0);
+  if (_seen[0]) _fbb.AddElement<int8_t>(TypeAliases::VT_I8, i8_, 0);
+  *_o = flatbuffers::Offset<TypeAliases>(_fbb.EndTable(_start));
+  return true;
+}
+
+inline void PrintTypeAliasesJson(flatbuffers::JsonWriter &_json, const TypeAliases &_o) {
+  auto _t = reinterpret_cast<const flatbuffers::Table *>(&_o);
+  _json.StartObject();
+  if (_t->CheckField(TypeAliases::VT_I8)) {
+    _json.Key("i8");
+    _json.Scalar(_t->GetField<int8_t>(TypeAliases::VT_I8, 0));
+  }
+  if (_t->CheckField(TypeAliases::VT_U8)) {
+    _json.Key("u8");
+    _json.Scalar(_t->GetField<uint8_t>(TypeAliases::VT_U8, 0));
+  }
+  if (_t->CheckField(TypeAliases::VT_I16)) {
+    _json.Key("i16");
+    _json.Scalar(_t->GetField<int16_t>(TypeAliases::VT_I16, 0));
+  }
+  if (_t->CheckField(TypeAliases::VT_U16)) {
+    _json.Key("u16");
+    _json.Scalar(_t->GetField<uint16_t>(TypeAliases::VT_U16, 0));
+  }
+  if (_t->CheckField(TypeAliases::VT_I32)) {
+    _json.Key("i32");
+    _json.Scalar(_t->GetField<int32_t>(TypeAliases::VT_I32, 0));
+  }
+  if (_t->CheckField(TypeAliases::VT_U32)) {
+    _json.Key("u32");
+    _json.Scalar(_t->GetField<uint32_t>(TypeAliases::VT_U32, 0));
+  }
+  if (_t->CheckField(TypeAliases::VT_I64)) {
+    _json.Key("i64");
+    _json.Scalar(_t->GetField<int64_t>(TypeAliases::VT_I64, 0));
+  }
+  if (_t->CheckField(TypeAliases::VT_U64)) {
+    _json.Key("u64");
+    _json.Scalar(_t->GetField<uint64_t>(TypeAliases::VT_U64, 0));
+  }
+  if (_t->CheckField(TypeAliases::VT_F32)) {
+    _json.Key("f32");
+    _json.Scalar(_t->GetField<float>(TypeAliases::VT_F32, 0.0f));
+  }
+  if (_t->CheckField(TypeAliases::VT_F64)) {
+    _json.Key("f64");
+    _json.Scalar(_t->GetField<double>(TypeAliases::VT_F64, 0.0));
+  }
+  if (_t->CheckField(TypeAliases::VT_V8)) {
+    _json.Key("v8");
+    _json.ScalarVector(*_t->GetPointer<const flatbuffers::Vector<int8_t> *>(TypeAliases::VT_V8));
+  }
+  if (_t->CheckField(TypeAliases::VT_VF64)) {
+    _json.Key("vf64");
+    _json.ScalarVector(*_t->GetPointer<const flatbuffers::Vector<double> *>(TypeAliases::VT_VF64));
+  }
+  _json.EndObject();
+}
+
 inline flatbuffers::TypeTable *ColorTypeTable() {
   static flatbuffers::TypeCode type_codes[] = {
     { flatbuffers::ET_CHAR, 0, 0 },
@@ -2576,6 +4055,29 @@ inline flatbuffers::unique_ptr<MonsterT> UnPackMonster(
   return flatbuffers::unique_ptr<MonsterT>(GetMonster(buf)->UnPack(res));
 }
 
+inline bool ParseMonsterFromJson(
+    const char *text, flatbuffers::FlatBufferBuilder &fbb,
+    std::string *error = nullptr,
+    const flatbuffers::JsonOptions &opts = flatbuffers::JsonOptions()) {
+  flatbuffers::JsonReader json(text, opts);
+  flatbuffers::Offset<MyGame::Example::Monster> root;
+  if (!ParseMonsterJson(json, fbb, &root) || !json.Finish()) {
+    if (error) *error = json.error();
+    return false;
+  }
+  FinishMonsterBuffer(fbb, root);
+  return true;
+}
+
+inline bool MonsterToJson(
+    const void *buf, std::string *text,
+    const flatbuffers::JsonOptions &opts = flatbuffers::JsonOptions()) {
+  flatbuffers::JsonWriter json(text, opts);
+  PrintMonsterJson(json, *GetMonster(buf));
+  json.Finish();
+  return json.ok();
+}
+
 }  // namespace Example
 }  // namespace MyGame
 
@@ -100,12 +100,18 @@ struct TableInNestedNS FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
 struct TableInNestedNSBuilder {
   flatbuffers::FlatBufferBuilder &fbb_;
   flatbuffers::uoffset_t start_;
+  // The most the fields take up, padding included, if added
+  // in the order CreateTableInNestedNS() adds them.
+  enum {
+    kMaxInlineSize = 7,
+    kNumFields = 1
+  };
   void add_foo(int32_t foo) {
     fbb_.AddElement<int32_t>(TableInNestedNS::VT_FOO, foo, 0);
   }
   explicit TableInNestedNSBuilder(flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
-    start_ = fbb_.StartTable();
+    start_ = fbb_.StartTable(kMaxInlineSize, kNumFields);
   }
   TableInNestedNSBuilder &operator=(const TableInNestedNSBuilder &);
   flatbuffers::Offset<TableInNestedNS> Finish() {
@@ -78,6 +78,12 @@ struct TableInFirstNS FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
 struct TableInFirstNSBuilder {
   flatbuffers::FlatBufferBuilder &fbb_;
   flatbuffers::uoffset_t start_;
+  // The most the fields take up, padding included, if added
+  // in the order CreateTableInFirstNS() adds them.
+  enum {
+    kMaxInlineSize = 16,
+    kNumFields = 3
+  };
   void add_foo_table(flatbuffers::Offset<NamespaceA::NamespaceB::TableInNestedNS> foo_table) {
     fbb_.AddOffset(TableInFirstNS::VT_FOO_TABLE, foo_table);
   }
@@ -89,7 +95,7 @@ struct TableInFirstNSBuilder {
   }
   explicit TableInFirstNSBuilder(flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
-    start_ = fbb_.StartTable();
+    start_ = fbb_.StartTable(kMaxInlineSize, kNumFields);
   }
   TableInFirstNSBuilder &operator=(const TableInFirstNSBuilder &);
   flatbuffers::Offset<TableInFirstNS> Finish() {
@@ -148,6 +154,12 @@ struct TableInC FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
 struct TableInCBuilder {
   flatbuffers::FlatBufferBuilder &fbb_;
   flatbuffers::uoffset_t start_;
+  // The most the fields take up, padding included, if added
+  // in the order CreateTableInC() adds them.
+  enum {
+    kMaxInlineSize = 11,
+    kNumFields = 2
+  };
   void add_refer_to_a1(flatbuffers::Offset<NamespaceA::TableInFirstNS> refer_to_a1) {
     fbb_.AddOffset(TableInC::VT_REFER_TO_A1, refer_to_a1);
   }
@@ -156,7 +168,7 @@ struct TableInCBuilder {
   }
   explicit TableInCBuilder(flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
-    start_ = fbb_.StartTable();
+    start_ = fbb_.StartTable(kMaxInlineSize, kNumFields);
   }
   TableInCBuilder &operator=(const TableInCBuilder &);
   flatbuffers::Offset<TableInC> Finish() {
@@ -204,12 +216,18 @@ struct SecondTableInA FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
 struct SecondTableInABuilder {
   flatbuffers::FlatBufferBuilder &fbb_;
   flatbuffers::uoffset_t start_;
+  // The most the fields take up, padding included, if added
+  // in the order CreateSecondTableInA() adds them.
+  enum {
+    kMaxInlineSize = 7,
+    kNumFields = 1
+  };
   void add_refer_to_c(flatbuffers::Offset<NamespaceC::TableInC> refer_to_c) {
     fbb_.AddOffset(SecondTableInA::VT_REFER_TO_C, refer_to_c);
   }
   explicit SecondTableInABuilder(flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
-    start_ = fbb_.StartTable();
+    start_ = fbb_.StartTable(kMaxInlineSize, kNumFields);
   }
   SecondTableInABuilder &operator=(const SecondTableInABuilder &);
   flatbuffers::Offset<SecondTableInA> Finish() {
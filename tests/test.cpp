@@ -14,10 +14,18 @@
  * limitations under the License.
  */
 
+#include "flatbuffers/builder_pool.h"
+#include "flatbuffers/column_extractor.h"
 #include "flatbuffers/flatbuffers.h"
+#include "flatbuffers/flex_patch.h"
+#include "flatbuffers/flex_transcoder.h"
+#include "flatbuffers/hash.h"
 #include "flatbuffers/idl.h"
 #include "flatbuffers/minireflect.h"
 #include "flatbuffers/registry.h"
+#include "flatbuffers/stream.h"
+#include "flatbuffers/compressed_stream.h"
+#include "flatbuffers/thread_pool.h"
 #include "flatbuffers/util.h"
 
 // clang-format off
@@ -33,6 +41,10 @@
 #include "namespace_test/namespace_test1_generated.h"
 #include "namespace_test/namespace_test2_generated.h"
 #include "union_vector/union_vector_generated.h"
+#include "columnar_test/columnar_test_generated.h"
+#include "hash_index_test/hash_index_test_generated.h"
+
+#include <clocale>
 
 // clang-format off
 #ifndef FLATBUFFERS_CPP98_STL
@@ -519,6 +531,97 @@ void ObjectFlatBuffersTest(uint8_t *flatbuf) {
   TEST_EQ(tests[1].b(), 40);
 }
 
+// Packs an object into a new buffer.
+std::string PackMonster(const MonsterT &monster) {
+  flatbuffers::FlatBufferBuilder fbb;
+  fbb.Finish(CreateMonster(fbb, &monster), MonsterIdentifier());
+  return std::string(reinterpret_cast<const char *>(fbb.GetBufferPointer()),
+                     fbb.GetSize());
+}
+
+// Unpacking into an object that was unpacked to before reuses its memory,
+// and gives the same object as unpacking into a new one.
+void UnPackToReuseTest(uint8_t *flatbuf) {
+  MonsterT monster;
+  GetMonster(flatbuf)->UnPackTo(&monster);
+  auto pos = monster.pos.get();
+  auto table = monster.testarrayoftables[0].get();
+  TEST_NOTNULL(pos);
+  TEST_EQ(monster.test.type, Any_Monster);
+
+  // A monster with a lot less set.
+  flatbuffers::FlatBufferBuilder fbb;
+  std::vector<flatbuffers::Offset<Monster>> tables;
+  tables.push_back(CreateMonster(fbb, nullptr, 0, 10, fbb.CreateString("a")));
+  tables.push_back(CreateMonster(fbb, nullptr, 0, 20, fbb.CreateString("b")));
+  auto name = fbb.CreateString("Bob");
+  auto vec = fbb.CreateVector(tables);
+  MonsterBuilder builder(fbb);
+  builder.add_name(name);
+  builder.add_testarrayoftables(vec);
+  FinishMonsterBuffer(fbb, builder.Finish());
+  auto small = GetMonster(fbb.GetBufferPointer());
+
+  small->UnPackTo(&monster);
+  TEST_EQ_STR(monster.name.c_str(), "Bob");
+  TEST_EQ(monster.hp, 100);  // default
+  TEST_EQ(monster.pos.get() == nullptr, true);
+  TEST_EQ(monster.inventory.size(), 0U);
+  TEST_EQ(monster.test.type, Any_NONE);
+  TEST_EQ(monster.test.value == nullptr, true);
+  TEST_EQ(monster.testarrayofstring.size(), 0U);
+  TEST_EQ(monster.testarrayoftables.size(), 2U);
+  TEST_EQ(monster.testarrayoftables[0].get(), table);
+  TEST_EQ_STR(monster.testarrayoftables[1]->name.c_str(), "b");
+  TEST_EQ(monster.testarrayoftables[1]->hp, 20);
+  flatbuffers::unique_ptr<MonsterT> fresh(small->UnPack());
+  TEST_EQ(PackMonster(monster) == PackMonster(*fresh), true);
+
+  // And back.
+  monster.pos.reset(new Vec3());
+  pos = monster.pos.get();
+  GetMonster(flatbuf)->UnPackTo(&monster);
+  TEST_EQ(monster.pos.get(), pos);
+  TEST_EQ(monster.testarrayoftables[0].get(), table);
+  fresh.reset(GetMonster(flatbuf)->UnPack());
+  TEST_EQ(PackMonster(monster) == PackMonster(*fresh), true);
+}
+
+// Generated Create functions reserve room for the whole table up front, and
+// add the fields without padding between them.
+void SizedCreateTest() {
+  flatbuffers::FlatBufferBuilder fbb(8);
+  auto name = fbb.CreateString("MyMonster");
+  Vec3 pos(1, 2, 3, 4, Color_Green, Test(5, 6));
+  auto reallocations = fbb.GetReallocationCount();
+  auto monster = CreateMonster(fbb, &pos, 150, 80, name, 0, Color_Red, Any_NONE,
+                               0, 0, 0, 0, 0, 0, 0, true, 1, 2, 3, 4, 5, 6, 7,
+                               8, 0, 1.0f, 2.0f, 3.0f);
+  TEST_EQ(fbb.GetReallocationCount() <= reallocations + 1, true);
+  fbb.Finish(monster);
+  auto table = flatbuffers::GetAnyRoot(fbb.GetBufferPointer());
+  auto table_size =
+      flatbuffers::ReadScalar<flatbuffers::voffset_t>(table->GetVTable() + 2);
+  TEST_EQ(table_size <= MonsterBuilder::kMaxInlineSize + 4, true);
+  // 100 bytes of fields that aren't defaults, the vtable offset, and any
+  // padding in front of pos (it comes first, into the end of the table),
+  // none between the fields.
+  TEST_EQ(table_size >= 104 && table_size < 104 + 16, true);
+  auto pos_offset = reinterpret_cast<const uint8_t *>(
+                        GetMonster(fbb.GetBufferPointer())->pos()) -
+                    reinterpret_cast<const uint8_t *>(table);
+  TEST_EQ(pos_offset + 32 + 16 > table_size, true);
+
+  // Also with fields that aren't set.
+  flatbuffers::FlatBufferBuilder fbb2(8);
+  reallocations = fbb2.GetReallocationCount();
+  fbb2.Finish(CreateStat(fbb2, 0, 10, 20));
+  TEST_EQ(fbb2.GetReallocationCount() <= reallocations + 1, true);
+  auto stat = flatbuffers::GetRoot<Stat>(fbb2.GetBufferPointer());
+  TEST_EQ(stat->val(), 10);
+  TEST_EQ(stat->count(), 20);
+}
+
 // Prefix a FlatBuffer with a size field.
 void SizePrefixedTest() {
   // Create size prefixed buffer.
@@ -538,6 +641,849 @@ void SizePrefixedTest() {
   TEST_EQ_STR(m->name()->c_str(), "bob");
 }
 
+// Builds tables with many distinct vtables, so EndTable needs to dedup
+// against a large set of them.
+void CreateManyVtables(flatbuffers::FlatBufferBuilder &builder) {
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int round = 0; round < 2; round++) {
+    for (int i = 0; i < 256; i++) {
+      auto name = builder.CreateString("many");
+      MonsterBuilder mb(builder);
+      mb.add_name(name);
+      if (i & 1) mb.add_mana(static_cast<int16_t>(i));
+      if (i & 2) mb.add_hp(static_cast<int16_t>(i));
+      if (i & 4) mb.add_testbool(true);
+      if (i & 8) mb.add_testhashs32_fnv1(i);
+      if (i & 16) mb.add_testhashu32_fnv1(i);
+      if (i & 32) mb.add_testf(1.0f);
+      if (i & 64) mb.add_testf2(2.0f);
+      if (i & 128) mb.add_color(Color_Red);
+      monsters.push_back(mb.Finish());
+    }
+  }
+  auto vec = builder.CreateVector(monsters);
+  auto name = builder.CreateString("root");
+  MonsterBuilder root(builder);
+  root.add_name(name);
+  root.add_testarrayoftables(vec);
+  FinishMonsterBuffer(builder, root.Finish());
+}
+
+void VtableIndexTest() {
+  flatbuffers::FlatBufferBuilder linear;
+  linear.VtableIndexThreshold(0);
+  CreateManyVtables(linear);
+
+  flatbuffers::FlatBufferBuilder hashed;
+  hashed.VtableIndexThreshold(4);
+  CreateManyVtables(hashed);
+
+  // Both dedup modes must produce the exact same bytes.
+  TEST_EQ(linear.GetSize(), hashed.GetSize());
+  TEST_EQ(memcmp(linear.GetBufferPointer(), hashed.GetBufferPointer(),
+                 linear.GetSize()),
+          0);
+  flatbuffers::Verifier verifier(hashed.GetBufferPointer(), hashed.GetSize());
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+
+  // Reusing the builder must reset the index along with the vtables.
+  hashed.Clear();
+  CreateManyVtables(hashed);
+  TEST_EQ(linear.GetSize(), hashed.GetSize());
+  TEST_EQ(memcmp(linear.GetBufferPointer(), hashed.GetBufferPointer(),
+                 linear.GetSize()),
+          0);
+
+  auto monsters = GetMonster(hashed.GetBufferPointer())->testarrayoftables();
+  TEST_EQ(monsters->size(), 512U);
+  TEST_EQ(monsters->Get(256 + 3)->hp(), 3);
+  TEST_EQ(monsters->Get(256 + 3)->mana(), 3);
+  TEST_EQ(monsters->Get(255)->color(), Color_Red);
+}
+
+void AllocatorsTest() {
+  flatbuffers::FlatBufferBuilder reference;
+  CreateManyVtables(reference);
+
+  // A small initial size forces many reallocations, which the arena should
+  // mostly serve in place.
+  flatbuffers::ArenaAllocator arena(256);
+  flatbuffers::DetachedBuffer detached;
+  for (int i = 0; i < 3; i++) {
+    flatbuffers::FlatBufferBuilder builder(16, &arena);
+    CreateManyVtables(builder);
+    TEST_EQ(builder.GetSize(), reference.GetSize());
+    TEST_EQ(memcmp(builder.GetBufferPointer(), reference.GetBufferPointer(),
+                   reference.GetSize()),
+            0);
+    if (i == 2) detached = builder.Release();
+  }
+  TEST_EQ(detached.size(), reference.GetSize());
+  TEST_EQ(memcmp(detached.data(), reference.GetBufferPointer(),
+                 reference.GetSize()),
+          0);
+  detached = flatbuffers::DetachedBuffer();
+  arena.Reset();
+  auto capacity = arena.capacity();
+  {
+    flatbuffers::FlatBufferBuilder builder(16, &arena);
+    CreateManyVtables(builder);
+    TEST_EQ(builder.GetSize(), reference.GetSize());
+  }
+  // The block kept by Reset() was large enough for the whole buffer.
+  TEST_EQ(arena.capacity(), capacity);
+
+  // An arena over caller provided memory.
+  uint8_t storage[64 * 1024];
+  flatbuffers::ArenaAllocator stack_arena(storage, sizeof(storage));
+  {
+    flatbuffers::FlatBufferBuilder builder(16, &stack_arena);
+    CreateManyVtables(builder);
+    TEST_EQ(builder.GetBufferPointer() >= storage &&
+                builder.GetBufferPointer() < storage + sizeof(storage),
+            true);
+    TEST_EQ(memcmp(builder.GetBufferPointer(), reference.GetBufferPointer(),
+                   reference.GetSize()),
+            0);
+  }
+  TEST_EQ(stack_arena.capacity(), sizeof(storage));
+
+  // clang-format off
+  #ifdef FLATBUFFERS_THREAD_LOCAL
+    for (int i = 0; i < 3; i++) {
+      flatbuffers::FlatBufferBuilder builder(
+          16, &flatbuffers::PoolAllocator::instance());
+      CreateManyVtables(builder);
+      TEST_EQ(builder.GetSize(), reference.GetSize());
+      TEST_EQ(memcmp(builder.GetBufferPointer(), reference.GetBufferPointer(),
+                     reference.GetSize()),
+              0);
+      detached = builder.Release();
+    }
+    TEST_EQ(memcmp(detached.data(), reference.GetBufferPointer(),
+                   reference.GetSize()),
+            0);
+    detached = flatbuffers::DetachedBuffer();
+    flatbuffers::PoolAllocator::Trim();
+  #endif
+  // clang-format on
+}
+
+void SizeHintTest() {
+  flatbuffers::BufferSizeHint hint;
+  TEST_EQ(hint.Estimate(), 0U);
+
+  flatbuffers::FlatBufferBuilder builder(64);
+  builder.SetSizeHint(&hint);
+  CreateManyVtables(builder);
+  auto size = builder.GetSize();
+  TEST_EQ(builder.GetReallocationCount() > 0, true);
+  TEST_EQ(builder.GetReallocatedBytes() > 0, true);
+  TEST_EQ(hint.Estimate() >= size, true);
+
+  // Having seen a buffer this large, the builder reserves enough upfront.
+  builder.Clear();
+  TEST_EQ(builder.GetReallocationCount(), 0U);
+  CreateManyVtables(builder);
+  TEST_EQ(builder.GetSize(), size);
+  TEST_EQ(builder.GetReallocationCount(), 0U);
+  TEST_EQ(builder.GetReallocatedBytes(), 0U);
+
+  builder.Reset();
+  CreateManyVtables(builder);
+  TEST_EQ(builder.GetReallocationCount(), 0U);
+
+  // Other builders sharing the hint benefit as well.
+  flatbuffers::FlatBufferBuilder other(64);
+  other.SetSizeHint(&hint);
+  CreateManyVtables(other);
+  TEST_EQ(other.GetReallocationCount(), 0U);
+  TEST_EQ(memcmp(builder.GetBufferPointer(), other.GetBufferPointer(), size),
+          0);
+}
+
+void SegmentedBuilderTest() {
+  flatbuffers::FlatBufferBuilder reference;
+  CreateManyVtables(reference);
+
+  for (size_t segment_size = 64; segment_size <= 4096; segment_size *= 8) {
+    flatbuffers::FlatBufferBuilder builder;
+    builder.BuildInSegments(segment_size);
+    CreateManyVtables(builder);
+    auto segments = builder.GetBufferSegments();
+    TEST_EQ(segments.size() > 1, true);
+    std::string concatenated;
+    for (auto it = segments.begin(); it != segments.end(); ++it) {
+      concatenated.append(reinterpret_cast<const char *>(it->data), it->size);
+    }
+    TEST_EQ(concatenated.size(), reference.GetSize());
+    TEST_EQ(memcmp(concatenated.c_str(), reference.GetBufferPointer(),
+                   reference.GetSize()),
+            0);
+
+    // Release() flattens the segments into a contiguous buffer.
+    auto flat = builder.Release();
+    TEST_EQ(flat.size(), reference.GetSize());
+    TEST_EQ(memcmp(flat.data(), reference.GetBufferPointer(), flat.size()),
+            0);
+  }
+
+  // Objects larger than a segment, strings pooled across segments, and a
+  // reused builder.
+  flatbuffers::FlatBufferBuilder builder;
+  builder.BuildInSegments(256);
+  for (int i = 0; i < 2; i++) {
+    builder.Clear();
+    std::vector<int64_t> longs(100, 42);
+    auto longs_vec = builder.CreateVector(longs);
+    std::vector<flatbuffers::Offset<flatbuffers::String>> strings;
+    for (int j = 0; j < 100; j++) {
+      strings.push_back(builder.CreateSharedString(j % 2 ? "odd" : "even"));
+    }
+    auto strings_vec = builder.CreateVector(strings);
+    auto name = builder.CreateString(std::string(1000, 'x'));
+    MonsterBuilder mb(builder);
+    mb.add_name(name);
+    mb.add_vector_of_longs(longs_vec);
+    mb.add_testarrayofstring(strings_vec);
+    FinishMonsterBuffer(builder, mb.Finish());
+    TEST_EQ(builder.GetBufferSegments().size() > 1, true);
+  }
+  auto flat = builder.Release();
+  flatbuffers::Verifier verifier(flat.data(), flat.size());
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+  auto monster = GetMonster(flat.data());
+  TEST_EQ(monster->name()->size(), 1000U);
+  TEST_EQ(monster->vector_of_longs()->Get(99), 42);
+  TEST_EQ_STR(monster->testarrayofstring()->Get(3)->c_str(), "odd");
+  // Shared strings were deduplicated.
+  TEST_EQ(monster->testarrayofstring()->Get(1),
+          monster->testarrayofstring()->Get(3));
+}
+
+void SharedStringTest() {
+  flatbuffers::FlatBufferBuilder builder;
+  for (int round = 0; round < 2; round++) {
+    builder.Clear();
+    std::vector<flatbuffers::Offset<flatbuffers::String>> strings;
+    // Enough distinct strings for the pool to grow a few times.
+    for (int i = 0; i < 1000; i++) {
+      strings.push_back(
+          builder.CreateSharedString(flatbuffers::NumToString(i % 300)));
+    }
+    // Strings only differing after an embedded 0 are different strings.
+    auto a = builder.CreateSharedString(std::string("x\0a", 3));
+    auto b = builder.CreateSharedString(std::string("x\0b", 3));
+    auto x = builder.CreateSharedString("x");
+    TEST_EQ(a.o != b.o, true);
+    TEST_EQ(a.o != x.o, true);
+    TEST_EQ(builder.CreateSharedString(std::string("x\0b", 3)).o, b.o);
+    TEST_EQ(builder.CreateSharedString("").o,
+            builder.CreateSharedString("").o);
+
+    for (int i = 0; i < 300; i++) {
+      TEST_EQ(strings[i].o, strings[i + 300].o);
+      TEST_EQ(strings[i].o, strings[i + 600].o);
+      if (i) TEST_EQ(strings[i].o != strings[i - 1].o, true);
+    }
+    auto vec = builder.CreateVector(strings);
+    auto name = builder.CreateSharedString("299");
+    TEST_EQ(name.o, strings[299].o);
+    MonsterBuilder mb(builder);
+    mb.add_name(name);
+    mb.add_testarrayofstring(vec);
+    FinishMonsterBuffer(builder, mb.Finish());
+
+    auto monster = GetMonster(builder.GetBufferPointer());
+    TEST_EQ_STR(monster->testarrayofstring()->Get(999)->c_str(), "99");
+    TEST_EQ_STR(monster->name()->c_str(), "299");
+  }
+}
+
+void AddElementsTest() {
+  for (int force_defaults = 0; force_defaults < 2; force_defaults++) {
+    flatbuffers::FlatBufferBuilder one_by_one, bulk;
+    one_by_one.ForceDefaults(force_defaults != 0);
+    bulk.ForceDefaults(force_defaults != 0);
+
+    auto name = one_by_one.CreateString("MyMonster");
+    MonsterBuilder mb(one_by_one);
+    mb.add_name(name);
+    mb.add_hp(80);
+    mb.add_testf(1.0f);
+    mb.add_testf2(3.0f);  // Default.
+    mb.add_testf3(2.0f);
+    mb.add_mana(0);
+    one_by_one.Finish(mb.Finish());
+
+    name = bulk.CreateString("MyMonster");
+    auto start = bulk.StartTable();
+    bulk.AddOffset(Monster::VT_NAME, name);
+    const flatbuffers::voffset_t float_fields[] = { Monster::VT_TESTF,
+                                                    Monster::VT_TESTF2,
+                                                    Monster::VT_TESTF3 };
+    const float floats[] = { 1.0f, 3.0f, 2.0f };
+    const float float_defs[] = { 3.14159f, 3.0f, 0.0f };
+    const flatbuffers::voffset_t short_fields[] = { Monster::VT_HP,
+                                                    Monster::VT_MANA };
+    const int16_t shorts[] = { 80, 0 };
+    const int16_t short_defs[] = { 100, 150 };
+    // Same order as the calls above.
+    bulk.AddElements(short_fields, shorts, short_defs, 1);
+    bulk.AddElements(float_fields, floats, float_defs, 3);
+    bulk.AddElements(short_fields + 1, shorts + 1, short_defs + 1, 1);
+    bulk.Finish(flatbuffers::Offset<Monster>(bulk.EndTable(start)));
+
+    TEST_EQ(bulk.GetSize(), one_by_one.GetSize());
+    TEST_EQ(memcmp(bulk.GetBufferPointer(), one_by_one.GetBufferPointer(),
+                   bulk.GetSize()),
+            0);
+    auto monster = GetMonster(bulk.GetBufferPointer());
+    TEST_EQ(monster->hp(), 80);
+    TEST_EQ(monster->mana(), 0);
+    TEST_EQ(monster->testf(), 1.0f);
+    TEST_EQ(monster->testf3(), 2.0f);
+  }
+}
+
+void ReferenceVectorTest() {
+  std::vector<uint8_t> bytes(1000);
+  std::vector<int64_t> longs(500);
+  for (size_t i = 0; i < bytes.size(); i++) bytes[i] = static_cast<uint8_t>(i);
+  for (size_t i = 0; i < longs.size(); i++) longs[i] = -static_cast<int>(i);
+
+  flatbuffers::FlatBufferBuilder reference;
+  {
+    auto inv = reference.CreateVector(bytes);
+    auto name = reference.CreateString("copied");
+    auto lv = reference.CreateVector(longs);
+    MonsterBuilder mb(reference);
+    mb.add_name(name);
+    mb.add_inventory(inv);
+    mb.add_vector_of_longs(lv);
+    FinishMonsterBuffer(reference, mb.Finish());
+  }
+
+  for (size_t segment_size = 0; segment_size <= 256; segment_size += 256) {
+    flatbuffers::FlatBufferBuilder builder(64);
+    builder.BuildInSegments(segment_size);
+    for (int round = 0; round < 2; round++) {
+      builder.Clear();
+      auto inv = builder.CreateReferenceVector(bytes.data(), bytes.size());
+      auto name = builder.CreateString("copied");
+      auto lv = builder.CreateReferenceVector(longs.data(), longs.size());
+      MonsterBuilder mb(builder);
+      mb.add_name(name);
+      mb.add_inventory(inv);
+      mb.add_vector_of_longs(lv);
+      FinishMonsterBuffer(builder, mb.Finish());
+
+      // The arrays are referenced by the output, not copied.
+      auto segments = builder.GetBufferSegments();
+      std::string concatenated;
+      int external = 0;
+      for (auto it = segments.begin(); it != segments.end(); ++it) {
+        concatenated.append(reinterpret_cast<const char *>(it->data), it->size);
+        if (it->data == bytes.data() ||
+            it->data == reinterpret_cast<const uint8_t *>(longs.data()))
+          external++;
+      }
+      TEST_EQ(external, 2);
+      TEST_EQ(concatenated.size(), reference.GetSize());
+      TEST_EQ(memcmp(concatenated.c_str(), reference.GetBufferPointer(),
+                     reference.GetSize()),
+              0);
+    }
+    auto flat = builder.Release();
+    TEST_EQ(flat.size(), reference.GetSize());
+    TEST_EQ(memcmp(flat.data(), reference.GetBufferPointer(), flat.size()),
+            0);
+  }
+}
+
+// Collects what is written to it, and checks writes are block-aligned if
+// asked to.
+class TestSink : public flatbuffers::Sink {
+ public:
+  explicit TestSink(size_t block_size = 0)
+      : writes(0), block_size_(block_size) {}
+
+  bool Write(const uint8_t *data, size_t size) FLATBUFFERS_OVERRIDE {
+    writes++;
+    if (block_size_) {
+      TEST_EQ(reinterpret_cast<size_t>(data) % block_size_, 0);
+      TEST_EQ(size % block_size_, 0);
+    }
+    written.append(reinterpret_cast<const char *>(data), size);
+    return true;
+  }
+
+  std::string written;
+  size_t writes;
+
+ private:
+  size_t block_size_;
+};
+
+class FailingSink : public flatbuffers::Sink {
+ public:
+  bool Write(const uint8_t *, size_t) FLATBUFFERS_OVERRIDE { return false; }
+};
+
+void SinkTest() {
+  flatbuffers::FlatBufferBuilder reference;
+  CreateManyVtables(reference);
+
+  flatbuffers::FlatBufferBuilder builder;
+  builder.BuildInSegments(1024);
+  CreateManyVtables(builder);
+  TestSink sink;
+  TEST_EQ(builder.WriteTo(sink), true);
+  TEST_EQ(sink.written.size(), reference.GetSize());
+  TEST_EQ(memcmp(sink.written.c_str(), reference.GetBufferPointer(),
+                 reference.GetSize()),
+          0);
+
+  // Several size-prefixed buffers in a row, in whole aligned blocks.
+  TestSink blocks(512);
+  flatbuffers::BlockAlignedSink aligned(blocks, 512, 2);
+  std::string expected;
+  for (int i = 0; i < 20; i++) {
+    builder.Clear();
+    auto name = builder.CreateString(std::string(i * 20, 'x'));
+    auto root = CreateMonster(builder, nullptr, 0, 0, name);
+    TEST_EQ(builder.FinishSizePrefixedTo(root, aligned, MonsterIdentifier()),
+            true);
+    auto segments = builder.GetBufferSegments();
+    for (auto it = segments.begin(); it != segments.end(); ++it) {
+      expected.append(reinterpret_cast<const char *>(it->data), it->size);
+    }
+  }
+  TEST_EQ(aligned.pending(), expected.size() % 1024);
+  size_t padding = 0;
+  TEST_EQ(aligned.Flush(&padding), true);
+  TEST_EQ(blocks.written.size(), expected.size() + padding);
+  TEST_EQ(blocks.written.size() % 512, 0);
+  TEST_EQ(blocks.written.compare(0, expected.size(), expected), 0);
+  auto first =
+      flatbuffers::GetSizePrefixedRoot<Monster>(blocks.written.c_str());
+  TEST_EQ(first->name()->size(), 0U);
+}
+
+void ParallelVerifierTest() {
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  const int kMonsters = 3000;
+  for (int i = 0; i < kMonsters; i++) {
+    auto enemy_name = builder.CreateString("enemy");
+    auto enemy = CreateMonster(builder, nullptr, 0, 0, enemy_name);
+    auto name = builder.CreateString(flatbuffers::NumToString(i));
+    monsters.push_back(CreateMonster(builder, nullptr, 0, 0, name, 0,
+                                     Color_Blue, Any_NONE, 0, 0, 0, 0, enemy));
+  }
+  auto vec = builder.CreateVector(monsters);
+  auto name = builder.CreateString("root");
+  MonsterBuilder mb(builder);
+  mb.add_name(name);
+  mb.add_testarrayoftables(vec);
+  FinishMonsterBuffer(builder, mb.Finish());
+
+  // The root, plus each monster and its enemy.
+  const flatbuffers::uoffset_t num_tables = 1 + 2 * kMonsters;
+  flatbuffers::Verifier sequential(builder.GetBufferPointer(),
+                                   builder.GetSize(), 64, num_tables);
+  TEST_EQ(VerifyMonsterBuffer(sequential), true);
+
+  flatbuffers::ThreadPool pool(3);
+  for (int i = 0; i < 2; i++) {
+    flatbuffers::Verifier verifier(builder.GetBufferPointer(),
+                                   builder.GetSize(), 64, num_tables);
+    verifier.SetParallel(&pool, 1000);
+    TEST_EQ(VerifyMonsterBuffer(verifier), true);
+    // clang-format off
+    #ifdef FLATBUFFERS_TRACK_VERIFIER_BUFFER_SIZE
+      TEST_EQ(verifier.GetComputedSize(), sequential.GetComputedSize());
+    #endif
+    // clang-format on
+  }
+
+  // ParallelFor() runs every task exactly once.
+  std::vector<int> counts(1000);
+  pool.ParallelFor(counts.size(), [](void *context, size_t i) {
+    (*reinterpret_cast<std::vector<int> *>(context))[i]++;
+  }, &counts);
+  TEST_EQ(std::count(counts.begin(), counts.end(), 1), 1000);
+}
+
+void LazyVerifierTest() {
+  std::string rawbuf;
+  auto flatbuf = CreateFlatBufferTest(rawbuf);
+  flatbuffers::LazyVerifier lazy(flatbuf.data(), flatbuf.size());
+  TEST_EQ(lazy.VerifyRoot<Monster>(MonsterIdentifier()), true);
+  auto monster = GetMonster(flatbuf.data());
+  TEST_EQ(lazy.Verify(monster->name()), true);
+  TEST_EQ_STR(monster->name()->c_str(), "MyMonster");
+
+  auto tables = monster->testarrayoftables();
+  TEST_EQ(lazy.Verify(tables), true);
+  for (int round = 0; round < 2; round++) {
+    // The second time around, the tables are found in the bitmap.
+    for (flatbuffers::uoffset_t i = 0; i < tables->size(); i++) {
+      auto table = tables->Get(i);
+      TEST_EQ(lazy.Verify(table), true);
+      TEST_EQ(lazy.Verify(table->name()), true);
+    }
+  }
+  TEST_EQ_STR(tables->Get(1)->name()->c_str(), "Fred");
+
+  auto strings = monster->testarrayofstring();
+  TEST_EQ(lazy.Verify(strings), true);
+  TEST_EQ(lazy.Verify(strings->Get(0)), true);
+  TEST_EQ_STR(strings->Get(0)->c_str(), "bob");
+
+  auto union_monster = monster->test_as_Monster();
+  TEST_EQ(lazy.Verify(union_monster), true);
+  TEST_EQ(lazy.Verify(union_monster->name()), true);
+  TEST_EQ_STR(union_monster->name()->c_str(), "Fred");
+  TEST_EQ(lazy.Verify(monster->enemy()), true);  // Null.
+
+  // Shallow verification doesn't visit the tables below the root.
+  flatbuffers::Verifier shallow(flatbuf.data(), flatbuf.size(), 1, 1);
+  shallow.SetShallow(true);
+  TEST_EQ(VerifyMonsterBuffer(shallow), true);
+}
+
+void BulkStringVerifierTest() {
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<std::string> strings;
+  for (int i = 0; i < 1001; i++) strings.push_back(std::string(i % 17, 'a'));
+  auto vec = builder.CreateVectorOfStrings(strings);
+  auto name = builder.CreateString("strings");
+  MonsterBuilder mb(builder);
+  mb.add_name(name);
+  mb.add_testarrayofstring(vec);
+  FinishMonsterBuffer(builder, mb.Finish());
+  flatbuffers::Verifier verifier(builder.GetBufferPointer(),
+                                 builder.GetSize());
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+
+  // Each offset may point at most `limit` bytes past the first element, for
+  // every number of offsets and every position of a bad one.
+  for (size_t count = 1; count < 20; count++) {
+    std::vector<flatbuffers::uoffset_t> offsets(count);
+    const flatbuffers::uoffset_t limit = 100;
+    for (size_t i = 0; i < count; i++) {
+      offsets[i] = limit - static_cast<flatbuffers::uoffset_t>(i * 4);
+    }
+    auto data = reinterpret_cast<const uint8_t *>(offsets.data());
+    TEST_EQ(flatbuffers::OffsetsWithinLimit(data, count, limit), true);
+    for (size_t bad = 0; bad < count; bad++) {
+      offsets[bad]++;
+      TEST_EQ(flatbuffers::OffsetsWithinLimit(data, count, limit), false);
+      // Offsets with the top bit set must not pass as small.
+      offsets[bad] = 0xFFFFFFF0u;
+      TEST_EQ(flatbuffers::OffsetsWithinLimit(data, count, limit), false);
+      offsets[bad] = limit - static_cast<flatbuffers::uoffset_t>(bad * 4);
+    }
+  }
+}
+
+void VerificationCacheTest() {
+  // Reference values of xxHash64.
+  TEST_EQ(flatbuffers::XxHash64::Hash("", 0), 0xEF46DB3751D8E999ULL);
+  TEST_EQ(flatbuffers::XxHash64::Hash("abc", 3), 0x44BC2CF5AD770999ULL);
+  const char *longer = "Nobody inspects the spammish repetition";
+  TEST_EQ(flatbuffers::XxHash64::Hash(longer, strlen(longer)),
+          0xFBCEA83C8A378BF1ULL);
+
+  std::string rawbuf;
+  auto flatbuf = CreateFlatBufferTest(rawbuf);
+  flatbuffers::VerificationCache cache(16);
+  for (int i = 0; i < 3; i++) {
+    TEST_EQ(cache.VerifyBuffer<Monster>(flatbuf.data(), flatbuf.size(),
+                                        MonsterIdentifier()),
+            true);
+  }
+  TEST_EQ(cache.misses(), 1);
+  TEST_EQ(cache.hits(), 2);
+
+  // A copy of the buffer is recognized, a different buffer is verified.
+  std::vector<uint8_t> copy(flatbuf.data(), flatbuf.data() + flatbuf.size());
+  TEST_EQ(cache.VerifyBuffer<Monster>(copy.data(), copy.size()), true);
+  TEST_EQ(cache.hits(), 3);
+  flatbuffers::FlatBufferBuilder builder;
+  builder.FinishSizePrefixed(
+      CreateMonster(builder, nullptr, 0, 0, builder.CreateString("x")));
+  TEST_EQ(cache.VerifySizePrefixedBuffer<Monster>(builder.GetBufferPointer(),
+                                                  builder.GetSize()),
+          true);
+  TEST_EQ(cache.misses(), 2);
+
+  cache.Clear();
+  TEST_EQ(cache.VerifyBuffer<Monster>(copy.data(), copy.size()), true);
+  TEST_EQ(cache.misses(), 3);
+}
+
+void HashBatchTest() {
+  // Strings of all lengths up to 40, shorter and longer than 32 bytes.
+  std::string text;
+  for (int i = 0; i < 100; i++) text += static_cast<char>('a' + i * 7 % 26);
+  std::vector<const char *> strings;
+  std::vector<size_t> lengths;
+  for (size_t len = 0; len <= 40; len++) {
+    for (size_t offset = 0; offset < 3; offset++) {
+      strings.push_back(text.c_str() + offset);
+      lengths.push_back((len * 5 + offset * 11) % 41);
+    }
+  }
+  std::vector<uint64_t> hashes(strings.size());
+  for (uint64_t seed = 0; seed < 2; seed++) {
+    flatbuffers::XxHash64::HashBatch(strings.data(), lengths.data(),
+                                     strings.size(), hashes.data(), seed);
+    for (size_t i = 0; i < strings.size(); i++) {
+      TEST_EQ(hashes[i],
+              flatbuffers::XxHash64::Hash(strings[i], lengths[i], seed));
+    }
+  }
+
+  // 0-terminated ones.
+  std::vector<std::string> names;
+  for (int i = 0; i < 150; i++)
+    names.push_back("field_" + flatbuffers::NumToString(i));
+  std::vector<const char *> c_strings;
+  for (auto it = names.begin(); it != names.end(); ++it)
+    c_strings.push_back(it->c_str());
+  hashes.resize(names.size());
+  flatbuffers::XxHash64::HashBatch(c_strings.data(), c_strings.size(),
+                                   hashes.data());
+  for (size_t i = 0; i < names.size(); i++) {
+    TEST_EQ(hashes[i],
+            flatbuffers::XxHash64::Hash(names[i].c_str(), names[i].size()));
+  }
+
+  // As `hash` attribute values, the smaller ones are its low bits.
+  TEST_EQ(flatbuffers::FindHashFunction64("xxhash_64")("abc"),
+          0x44BC2CF5AD770999ULL);
+  TEST_EQ(flatbuffers::FindHashFunction32("xxhash_32")("abc"), 0xAD770999U);
+  TEST_EQ(flatbuffers::FindHashFunction16("xxhash_16")("abc"), 0x0999);
+  flatbuffers::Parser parser;
+  TEST_EQ(parser.Parse("table T { h:ulong (hash:\"xxhash_64\"); "
+                       "i:int (hash:\"xxhash_32\"); }"
+                       "root_type T;"
+                       "{ h: \"abc\", i: \"abc\" }"),
+          true);
+  auto table = flatbuffers::GetRoot<flatbuffers::Table>(
+      parser.builder_.GetBufferPointer());
+  TEST_EQ(table->GetField<uint64_t>(4, 0), 0x44BC2CF5AD770999ULL);
+  TEST_EQ(table->GetField<int32_t>(6, 0),
+          static_cast<int32_t>(0xAD770999U));
+}
+
+void KeyIndexTest() {
+  // Prefixes keep the order of keys.
+  TEST_EQ(flatbuffers::KeyPrefix(-5) < flatbuffers::KeyPrefix(3), true);
+  TEST_EQ(
+      flatbuffers::KeyPrefix(int8_t(-1)) < flatbuffers::KeyPrefix(int8_t(0)),
+      true);
+  TEST_EQ(flatbuffers::KeyPrefix(uint16_t(0xFFFF)) >
+              flatbuffers::KeyPrefix(uint16_t(1)),
+          true);
+  TEST_EQ(flatbuffers::KeyPrefix(-1LL) < flatbuffers::KeyPrefix(1LL), true);
+  TEST_EQ(flatbuffers::KeyPrefix(-2.5) < flatbuffers::KeyPrefix(-1.5f), true);
+  TEST_EQ(flatbuffers::KeyPrefix(-0.0) == flatbuffers::KeyPrefix(0.0), true);
+  TEST_EQ(flatbuffers::KeyPrefix("ab") < flatbuffers::KeyPrefix("abc"), true);
+  TEST_EQ(flatbuffers::KeyPrefix("abcdX") == flatbuffers::KeyPrefix("abcdY"),
+          true);
+  TEST_EQ(flatbuffers::KeyPrefix("\xff") > flatbuffers::KeyPrefix("a"), true);
+
+  // Scalar keys: even ids from 0 to 1998, in shuffled order.
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<Columnar::Reading>> readings;
+  for (uint32_t i = 0; i < 1000; i++) {
+    readings.push_back(
+        Columnar::CreateReading(builder, (i * 337) % 1000 * 2));
+  }
+  auto rows = builder.CreateVectorOfSortedTables(&readings);
+  auto id_index = builder.CreateKeyIndex(readings, &Columnar::Reading::id);
+  // String keys that mostly share their first 4 characters.
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int i = 0; i < 300; i++) {
+    auto name = i % 3 ? "Monster" + flatbuffers::NumToString(i)
+                      : flatbuffers::NumToString(i);
+    monsters.push_back(CreateMonster(builder, nullptr, 0, 0,
+                                     builder.CreateString(name)));
+  }
+  auto tables = builder.CreateVectorOfSortedTables(&monsters);
+  auto name_index = builder.CreateKeyIndex(monsters, &Monster::name);
+  builder.Finish(Columnar::CreateLog(builder, 0, rows));
+
+  auto vec = flatbuffers::GetTemporaryPointer(builder, rows);
+  auto index = flatbuffers::GetTemporaryPointer(builder, id_index);
+  for (uint32_t id = 0; id < 2002; id++) {
+    auto expected = id % 2 || id >= 2000 ? nullptr : vec->Get(id / 2);
+    TEST_EQ(vec->LookupByKey(id) == expected, true);
+    TEST_EQ(vec->LookupByKey(id, index) == expected, true);
+  }
+  auto monster_vec = flatbuffers::GetTemporaryPointer(builder, tables);
+  index = flatbuffers::GetTemporaryPointer(builder, name_index);
+  for (int i = 0; i < 300; i++) {
+    auto name = i % 3 ? "Monster" + flatbuffers::NumToString(i)
+                      : flatbuffers::NumToString(i);
+    auto monster = monster_vec->LookupByKey(name.c_str(), index);
+    TEST_NOTNULL(monster);
+    TEST_EQ_STR(monster->name()->c_str(), name.c_str());
+    TEST_EQ(monster_vec->LookupByKey(name.c_str()) == monster, true);
+    TEST_EQ(monster_vec->LookupByKey((name + "x").c_str(), index) == nullptr,
+            true);
+  }
+  TEST_EQ(monster_vec->LookupByKey("", index) == nullptr, true);
+  TEST_EQ(monster_vec->LookupByKey("Z", index) == nullptr, true);
+  // A missing index falls back to the plain search.
+  TEST_NOTNULL(monster_vec->LookupByKey("Monster1", nullptr));
+
+  // Keys of another type are converted to that of the key field first.
+  flatbuffers::FlatBufferBuilder ulong_builder;
+  std::vector<flatbuffers::Offset<Referrable>> referrables;
+  for (uint64_t id = 0; id < 10; id++) {
+    referrables.push_back(CreateReferrable(ulong_builder, id));
+  }
+  auto ulong_rows = ulong_builder.CreateVectorOfSortedTables(&referrables);
+  auto ulong_index =
+      ulong_builder.CreateKeyIndex(referrables, &Referrable::id);
+  auto ulong_vec = flatbuffers::GetTemporaryPointer(ulong_builder, ulong_rows);
+  auto ulong_keys =
+      flatbuffers::GetTemporaryPointer(ulong_builder, ulong_index);
+  TEST_NOTNULL(ulong_vec->LookupByKey(5, ulong_keys));
+  TEST_EQ(ulong_vec->LookupByKey(5, ulong_keys) == ulong_vec->LookupByKey(5),
+          true);
+}
+
+void PrefetchingRangeTest() {
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int i = 0; i < 1000; i++) {
+    auto name = builder.CreateString(flatbuffers::NumToString(i));
+    monsters.push_back(
+        CreateMonster(builder, nullptr, 0, static_cast<int16_t>(i), name));
+  }
+  auto root = CreateMonster(builder, nullptr, 0, 0, builder.CreateString("x"),
+                            0, Color_Blue, Any_NONE, 0, 0, 0,
+                            builder.CreateVector(monsters));
+  FinishMonsterBuffer(builder, root);
+  auto tables = GetMonster(builder.GetBufferPointer())->testarrayoftables();
+
+  // Distances 0 (no prefetching), 1, and beyond the end of the vector.
+  const flatbuffers::uoffset_t distances[] = { 0, 1, 8, 5000 };
+  for (size_t d = 0; d < sizeof(distances) / sizeof(distances[0]); d++) {
+    flatbuffers::PrefetchingRange<Monster> range(tables, distances[d]);
+    TEST_EQ(range.size(), 1000);
+    auto it = tables->begin();
+    int i = 0;
+    for (auto monster : range) {
+      TEST_EQ(monster == *it, true);
+      TEST_EQ(monster->hp(), i);
+      ++it;
+      i++;
+    }
+    TEST_EQ(i, 1000);
+  }
+
+  // Absent vectors are empty ranges.
+  flatbuffers::PrefetchingRange<Monster> empty(
+      GetMonster(builder.GetBufferPointer())->testarrayoftables()->Get(0)
+          ->testarrayoftables());
+  TEST_EQ(empty.size(), 0);
+  TEST_EQ(empty.begin() == empty.end(), true);
+}
+
+void SpliceTest() {
+  // Build the elements of a vector of tables in separate builders, as
+  // worker threads would, then splice them into one buffer.
+  const int kSubs = 4, kPerSub = 50;
+  flatbuffers::FlatBufferBuilder subs[kSubs];
+  std::vector<flatbuffers::Offset<Monster>> sub_monsters[kSubs];
+  subs[3].BuildInSegments(256);
+  for (int s = 0; s < kSubs; s++) {
+    for (int i = 0; i < kPerSub; i++) {
+      auto name = subs[s].CreateString(
+          flatbuffers::NumToString(s * kPerSub + i));
+      // Don't start on a table-aligned size, to exercise padding.
+      if (!i) subs[s].CreateString("x");
+      sub_monsters[s].push_back(CreateMonster(
+          subs[s], nullptr, 0, static_cast<int16_t>(s * kPerSub + i), name));
+    }
+  }
+
+  flatbuffers::FlatBufferBuilder builder;
+  builder.CreateString("unaligned");
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int s = 0; s < kSubs; s++) {
+    auto base = builder.Splice(subs[s]);
+    for (auto it = sub_monsters[s].begin(); it != sub_monsters[s].end(); ++it)
+      monsters.push_back(builder.Relocate(*it, base));
+  }
+  // A table built here afterwards reuses a spliced vtable.
+  auto name = builder.CreateString("root");
+  auto same_layout = CreateMonster(builder, nullptr, 0, 1, name);
+  auto vec = builder.CreateVector(monsters);
+  MonsterBuilder mb(builder);
+  mb.add_name(name);
+  mb.add_testarrayoftables(vec);
+  mb.add_enemy(same_layout);
+  FinishMonsterBuffer(builder, mb.Finish());
+
+  flatbuffers::Verifier verifier(builder.GetBufferPointer(),
+                                 builder.GetSize());
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+  auto root = GetMonster(builder.GetBufferPointer());
+  auto tables = root->testarrayoftables();
+  TEST_EQ(tables->size(), static_cast<flatbuffers::uoffset_t>(kSubs * kPerSub));
+  for (flatbuffers::uoffset_t i = 0; i < tables->size(); i++) {
+    TEST_EQ(tables->Get(i)->hp(), static_cast<int16_t>(i));
+    TEST_EQ_STR(tables->Get(i)->name()->c_str(),
+                flatbuffers::NumToString(i).c_str());
+  }
+  auto vtable = [](const Monster *m) {
+    return reinterpret_cast<const flatbuffers::Table *>(m)->GetVTable();
+  };
+  TEST_EQ(vtable(root->enemy()), vtable(tables->Get(0)));
+}
+
+void BuilderPoolTest() {
+  flatbuffers::FlatBufferBuilderPool pool(2, 64 * 1024);
+  size_t capacity;
+  {
+    auto fbb = pool.Acquire();
+    fbb->Finish(CreateMonster(*fbb, nullptr, 0, 0, fbb->CreateString("a")));
+    capacity = fbb->GetCapacity();
+  }
+  TEST_EQ(pool.idle(), 1);
+  {
+    // A returned builder is cleared, but keeps its buffer.
+    auto fbb = pool.Acquire();
+    TEST_EQ(pool.created(), 1);
+    TEST_EQ(fbb->GetSize(), 0);
+    TEST_EQ(fbb->GetCapacity(), capacity);
+    auto name = fbb->CreateString("b");
+    FinishMonsterBuffer(*fbb, CreateMonster(*fbb, nullptr, 0, 0, name));
+    TEST_EQ_STR(GetMonster(fbb->GetBufferPointer())->name()->c_str(), "b");
+
+    // Growing past the high-water mark gets the buffer freed on return.
+    auto big = pool.Acquire();
+    auto third = pool.Acquire();
+    TEST_EQ(pool.created(), 3);
+    big->CreateString(std::string(100 * 1024, 'x'));
+    big.reset();
+    TEST_EQ(pool.idle(), 1);
+    auto reused = pool.Acquire();
+    TEST_EQ(reused->GetCapacity(), 0);
+  }
+  // Only two idle builders are kept.
+  TEST_EQ(pool.idle(), 2);
+  pool.Trim(0);
+  TEST_EQ(pool.idle(), 0);
+}
+
 void TriviallyCopyableTest() {
   // clang-format off
   #if __GNUG__ && __GNUC__ < 5
@@ -611,40 +1557,1206 @@ void ParseAndGenerateTextTest() {
                                  parser.builder_.GetSize());
   TEST_EQ(VerifyMonsterBuffer(verifier), true);
 
-  AccessFlatBufferTest(parser.builder_.GetBufferPointer(),
-                       parser.builder_.GetSize(), false);
+  AccessFlatBufferTest(parser.builder_.GetBufferPointer(),
+                       parser.builder_.GetSize(), false);
+
+  // to ensure it is correct, we now generate text back from the binary,
+  // and compare the two:
+  std::string jsongen;
+  auto result =
+      GenerateText(parser, parser.builder_.GetBufferPointer(), &jsongen);
+  TEST_EQ(result, true);
+  TEST_EQ_STR(jsongen.c_str(), jsonfile.c_str());
+
+  // We can also do the above using the convenient Registry that knows about
+  // a set of file_identifiers mapped to schemas.
+  flatbuffers::Registry registry;
+  // Make sure schemas can find their includes.
+  registry.AddIncludeDirectory(test_data_path.c_str());
+  registry.AddIncludeDirectory(include_test_path.c_str());
+  // Call this with many schemas if possible.
+  registry.Register(MonsterIdentifier(),
+                    (test_data_path + "monster_test.fbs").c_str());
+  // Now we got this set up, we can parse by just specifying the identifier,
+  // the correct schema will be loaded on the fly:
+  auto buf = registry.TextToFlatBuffer(jsonfile.c_str(), MonsterIdentifier());
+  // If this fails, check registry.lasterror_.
+  TEST_NOTNULL(buf.data());
+  // Test the buffer, to be sure:
+  AccessFlatBufferTest(buf.data(), buf.size(), false);
+  // We can use the registry to turn this back into text, in this case it
+  // will get the file_identifier from the binary:
+  std::string text;
+  auto ok = registry.FlatBufferToText(buf.data(), buf.size(), &text);
+  // If this fails, check registry.lasterror_.
+  TEST_EQ(ok, true);
+  TEST_EQ_STR(text.c_str(), jsonfile.c_str());
+}
+
+void JsonApiTest() {
+  std::string schemafile;
+  std::string jsonfile;
+  TEST_EQ(flatbuffers::LoadFile((test_data_path + "monster_test.fbs").c_str(),
+                                false, &schemafile),
+          true);
+  TEST_EQ(flatbuffers::LoadFile(
+              (test_data_path + "monsterdata_test.golden").c_str(), false,
+              &jsonfile),
+          true);
+  flatbuffers::Parser parser;
+  auto include_test_path =
+      flatbuffers::ConCatPathFileName(test_data_path, "include_test");
+  const char *include_directories[] = { test_data_path.c_str(),
+                                        include_test_path.c_str(), nullptr };
+  TEST_EQ(parser.Parse(schemafile.c_str(), include_directories), true);
+  TEST_EQ(parser.Parse(jsonfile.c_str(), include_directories), true);
+
+  // The generated parser makes the same buffer as Parser.
+  flatbuffers::FlatBufferBuilder fbb;
+  std::string error;
+  TEST_EQ(ParseMonsterFromJson(jsonfile.c_str(), fbb, &error), true);
+  TEST_EQ_STR(error.c_str(), "");
+  TEST_EQ(fbb.GetSize(), parser.builder_.GetSize());
+  TEST_EQ(memcmp(fbb.GetBufferPointer(), parser.builder_.GetBufferPointer(),
+                 fbb.GetSize()),
+          0);
+  AccessFlatBufferTest(fbb.GetBufferPointer(), fbb.GetSize(), false);
+
+  // And the generated printer the same text as GenerateText().
+  std::string text;
+  TEST_EQ(MonsterToJson(fbb.GetBufferPointer(), &text), true);
+  TEST_EQ_STR(text.c_str(), jsonfile.c_str());
+
+  flatbuffers::JsonOptions strict;
+  strict.strict_json = true;
+  strict.indent_step = -1;
+  parser.opts.strict_json = true;
+  parser.opts.indent_step = -1;
+  std::string generated;
+  TEST_EQ(GenerateText(parser, fbb.GetBufferPointer(), &generated), true);
+  text.clear();
+  TEST_EQ(MonsterToJson(fbb.GetBufferPointer(), &text, strict), true);
+  TEST_EQ_STR(text.c_str(), generated.c_str());
+
+  // Strict JSON parses back to the same buffer.
+  flatbuffers::FlatBufferBuilder strict_fbb;
+  TEST_EQ(ParseMonsterFromJson(text.c_str(), strict_fbb, &error, strict),
+          true);
+  TEST_EQ(strict_fbb.GetSize(), fbb.GetSize());
+  TEST_EQ(memcmp(strict_fbb.GetBufferPointer(), fbb.GetBufferPointer(),
+                 fbb.GetSize()),
+          0);
+
+  // The type of a union may come after its value, enum values may be given
+  // by name or number, and strings may have escapes.
+  flatbuffers::FlatBufferBuilder union_fbb;
+  TEST_EQ(ParseMonsterFromJson(
+              "{ name: 'A\\tB\\u00e9', test: { color: 'Red Blue' },"
+              " test_type: TestSimpleTableWithEnum, color: 1,"
+              " enemy: null, testhashu32_fnv1: \"foo\", }",
+              union_fbb, &error),
+          true);
+  auto monster = GetMonster(union_fbb.GetBufferPointer());
+  TEST_EQ_STR(monster->name()->c_str(), "A\tB\xC3\xA9");
+  TEST_EQ(monster->test_type(), Any_TestSimpleTableWithEnum);
+  TEST_EQ(monster->test_as_TestSimpleTableWithEnum()->color(),
+          Color_Red | Color_Blue);
+  TEST_EQ(monster->color(), Color_Red);
+  TEST_EQ(monster->testhashu32_fnv1(), flatbuffers::HashFnv1<uint32_t>("foo"));
+
+  // Errors are those of Parser.
+  struct {
+    const char *json;
+    const char *error;
+  } errors[] = {
+    { "{ name: \"A\", foo: 1 }", "line 1: unknown field: foo" },
+    { "{ name: \"A\", name: \"B\" }",
+      "line 1: field set more than once: name" },
+    { "{ hp: 10 }", "line 1: required field is missing: name in Monster" },
+    { "{ name: \"A\",\n hp: 100000 }",
+      "line 2: constant does not fit in a 16-bit field: 100000" },
+    { "{ name: \"A\", color: Purple }", "line 1: unknown enum value: Purple" },
+    { "{ name: \"A\", pos: { x: 1 } }",
+      "line 1: struct: wrong number of initializers: Vec3" },
+    { "{ name: \"A\", test: {} }",
+      "line 1: missing type field for this union value: test_type" },
+    { "{ name: \"A\" } x", "line 1: unexpected text after the root value" },
+  };
+  for (size_t i = 0; i < sizeof(errors) / sizeof(errors[0]); i++) {
+    flatbuffers::FlatBufferBuilder error_fbb;
+    TEST_EQ(ParseMonsterFromJson(errors[i].json, error_fbb, &error), false);
+    TEST_EQ_STR(error.c_str(), errors[i].error);
+  }
+
+  // Keys and strings of flexbuffer fields are taken straight from the text.
+  flatbuffers::FlatBufferBuilder flex_fbb;
+  TEST_EQ(ParseMonsterFromJson(
+              "{ name: \"A\", flex: { key: \"value\", other: [\"s\"] } }",
+              flex_fbb, &error),
+          true);
+  auto flex = GetMonster(flex_fbb.GetBufferPointer())->flex();
+  auto flex_map = flexbuffers::GetRoot(flex->data(), flex->size()).AsMap();
+  TEST_EQ_STR(flex_map.Keys()[0].AsKey(), "key");
+  TEST_EQ_STR(flex_map["key"].AsString().c_str(), "value");
+  TEST_EQ_STR(flex_map["other"].AsVector()[0].AsString().c_str(), "s");
+
+  // Text shorter than a byte order mark.
+  flatbuffers::FlatBufferBuilder short_fbb;
+  TEST_EQ(ParseMonsterFromJson("", short_fbb, &error), false);
+
+  // Unless unknown fields are to be skipped.
+  flatbuffers::JsonOptions skip;
+  skip.skip_unexpected_fields_in_json = true;
+  flatbuffers::FlatBufferBuilder skip_fbb;
+  TEST_EQ(ParseMonsterFromJson("{ foo: [1, { a: 'b' }], name: \"A\" }",
+                               skip_fbb, &error, skip),
+          true);
+  TEST_EQ_STR(GetMonster(skip_fbb.GetBufferPointer())->name()->c_str(), "A");
+}
+
+void DeserializeTest() {
+  std::string schemafile;
+  std::string jsonfile;
+  TEST_EQ(flatbuffers::LoadFile((test_data_path + "monster_test.fbs").c_str(),
+                                false, &schemafile),
+          true);
+  TEST_EQ(flatbuffers::LoadFile(
+              (test_data_path + "monsterdata_test.golden").c_str(), false,
+              &jsonfile),
+          true);
+  auto include_test_path =
+      flatbuffers::ConCatPathFileName(test_data_path, "include_test");
+  const char *include_directories[] = { test_data_path.c_str(),
+                                        include_test_path.c_str(), nullptr };
+  flatbuffers::IDLOptions opts;
+  opts.binary_schema_builtins = true;
+  opts.binary_schema_comments = true;
+  flatbuffers::Parser parser(opts);
+  TEST_EQ(parser.Parse(schemafile.c_str(), include_directories), true);
+  parser.Serialize();
+  std::string bfbs(
+      reinterpret_cast<const char *>(parser.builder_.GetBufferPointer()),
+      parser.builder_.GetSize());
+  TEST_EQ(parser.Parse(jsonfile.c_str(), include_directories), true);
+
+  // JSON parses into the same buffer, and back into the same text.
+  flatbuffers::Parser loaded(opts);
+  TEST_EQ(loaded.Deserialize(reinterpret_cast<const uint8_t *>(bfbs.c_str()),
+                             bfbs.size()),
+          true);
+  TEST_EQ(loaded.Parse(jsonfile.c_str()), true);
+  TEST_EQ(loaded.builder_.GetSize(), parser.builder_.GetSize());
+  TEST_EQ(memcmp(loaded.builder_.GetBufferPointer(),
+                 parser.builder_.GetBufferPointer(),
+                 parser.builder_.GetSize()),
+          0);
+  std::string jsongen;
+  TEST_EQ(GenerateText(loaded, loaded.builder_.GetBufferPointer(), &jsongen),
+          true);
+  TEST_EQ_STR(jsongen.c_str(), jsonfile.c_str());
+  TEST_EQ(loaded.file_identifier_ == "MONS", true);
+  auto monster = loaded.LookupStruct("MyGame.Example.Monster");
+  TEST_NOTNULL(monster);
+  TEST_EQ(monster->fields.vec[0]->name == "pos", true);
+  TEST_EQ(monster->doc_comment.size(), 1);
+  TEST_NOTNULL(monster->fields.Lookup("testhashu32_fnv1")->attributes.Lookup(
+      "hash"));
+
+  // Hashes of strings need the builtin attributes.
+  const char *hashed = "{ name: \"x\", testhashu32_fnv1: \"This string\" }";
+  TEST_EQ(loaded.Parse(hashed), true);
+  flatbuffers::Parser no_builtins;
+  TEST_EQ(no_builtins.Parse(schemafile.c_str(), include_directories), true);
+  no_builtins.Serialize();
+  flatbuffers::Parser loaded_no_builtins;
+  TEST_EQ(loaded_no_builtins.Deserialize(
+              no_builtins.builder_.GetBufferPointer(),
+              no_builtins.builder_.GetSize()),
+          true);
+  TEST_EQ(loaded_no_builtins.Parse(hashed), false);
+
+  // The same, size prefixed.
+  opts.size_prefixed = true;
+  flatbuffers::Parser prefixed(opts);
+  TEST_EQ(prefixed.Parse(schemafile.c_str(), include_directories), true);
+  prefixed.Serialize();
+  flatbuffers::Parser loaded_prefixed;
+  TEST_EQ(loaded_prefixed.Deserialize(prefixed.builder_.GetBufferPointer(),
+                                      prefixed.builder_.GetSize()),
+          true);
+  TEST_EQ(loaded_prefixed.Parse(jsonfile.c_str()), true);
+
+  // Anything else is rejected.
+  flatbuffers::Parser bad;
+  TEST_EQ(bad.Deserialize(parser.builder_.GetBufferPointer(), 4), false);
+  TEST_EQ(bad.Deserialize(parser.builder_.GetBufferPointer(),
+                          parser.builder_.GetSize()),
+          false);
+  TEST_NOTNULL(strstr(bad.error_.c_str(), "BFBS"));
+  TEST_EQ(loaded.Deserialize(reinterpret_cast<const uint8_t *>(bfbs.c_str()),
+                             bfbs.size()),
+          false);
+  TEST_NOTNULL(strstr(loaded.error_.c_str(), "already exists"));
+
+  // The registry loads binary schemas too.
+  auto bfbs_path = test_data_path + "deserialize_test.bfbs";
+  TEST_EQ(flatbuffers::SaveFile(bfbs_path.c_str(), bfbs, true), true);
+  flatbuffers::Registry registry;
+  registry.Register(MonsterIdentifier(), bfbs_path.c_str());
+  auto buf = registry.TextToFlatBuffer(jsonfile.c_str(), MonsterIdentifier());
+  TEST_NOTNULL(buf.data());
+  std::string text;
+  TEST_EQ(registry.FlatBufferToText(buf.data(), buf.size(), &text), true);
+  TEST_EQ_STR(text.c_str(), jsonfile.c_str());
+  std::remove(bfbs_path.c_str());
+}
+
+struct CompiledSchemaTask {
+  const flatbuffers::CompiledSchema *schema;
+  const std::string *json;
+  std::vector<int> ok;
+};
+
+void CompiledSchemaTest() {
+  std::string schemafile;
+  std::string jsonfile;
+  TEST_EQ(flatbuffers::LoadFile((test_data_path + "monster_test.fbs").c_str(),
+                                false, &schemafile),
+          true);
+  TEST_EQ(flatbuffers::LoadFile(
+              (test_data_path + "monsterdata_test.golden").c_str(), false,
+              &jsonfile),
+          true);
+  auto include_test_path =
+      flatbuffers::ConCatPathFileName(test_data_path, "include_test");
+  const char *include_directories[] = { test_data_path.c_str(),
+                                        include_test_path.c_str(), nullptr };
+  flatbuffers::CompiledSchema schema;
+  TEST_EQ(schema.Parse(schemafile.c_str(), include_directories), true);
+
+  flatbuffers::Parser parser(schema);
+  TEST_EQ(parser.Parse(jsonfile.c_str()), true);
+  AccessFlatBufferTest(parser.builder_.GetBufferPointer(),
+                       parser.builder_.GetSize(), false);
+  std::string jsongen;
+  TEST_EQ(GenerateText(schema.parser(), parser.builder_.GetBufferPointer(),
+                       &jsongen),
+          true);
+  TEST_EQ_STR(jsongen.c_str(), jsonfile.c_str());
+  // A parser can be used again, and its options changed.
+  parser.opts.strict_json = true;
+  TEST_EQ(parser.Parse("{ name: \"x\" }"), false);
+  TEST_EQ(parser.Parse("{ \"name\": \"x\" }"), true);
+  // It can't add to the schema.
+  TEST_EQ(parser.Parse("table Extra { a:int; }"), false);
+  TEST_NOTNULL(strstr(parser.error_.c_str(), "compiled schema"));
+  TEST_EQ(schema.parser().LookupStruct("Extra"),
+          static_cast<flatbuffers::StructDef *>(nullptr));
+  // But it can pick another root type.
+  TEST_EQ(parser.SetRootType("MyGame.Example.Stat"), true);
+  TEST_EQ(parser.Parse("{ \"id\": \"s\", \"val\": 3 }"), true);
+  auto stat = flatbuffers::GetRoot<MyGame::Example::Stat>(
+      parser.builder_.GetBufferPointer());
+  TEST_EQ(stat->val(), 3);
+
+  // Many threads can share the schema, each with its own parser.
+  CompiledSchemaTask task;
+  task.schema = &schema;
+  task.json = &jsonfile;
+  task.ok.resize(16);
+  flatbuffers::ThreadPool pool(3);
+  pool.ParallelFor(task.ok.size(), [](void *context, size_t i) {
+    auto &t = *reinterpret_cast<CompiledSchemaTask *>(context);
+    flatbuffers::Parser json_parser(*t.schema);
+    std::string text;
+    t.ok[i] = json_parser.Parse(t.json->c_str()) &&
+              GenerateText(t.schema->parser(),
+                           json_parser.builder_.GetBufferPointer(), &text) &&
+              text == *t.json;
+  }, &task);
+  TEST_EQ(std::count(task.ok.begin(), task.ok.end(), 1), 16);
+}
+
+void GenerateTextToTest() {
+  flatbuffers::Parser parser;
+  TEST_EQ(parser.Parse("table T { b:byte; l:long; u:ulong; f:float; d:double;"
+                       " s:[string]; v:[double]; } root_type T;"),
+          true);
+  std::string json = "{ b: -128, l: -9223372036854775808, "
+                     "u: 18446744073709551615, f: 3.25, d: -1e30, s: [";
+  // Long strings, with things to escape here and there.
+  for (int i = 0; i < 3000; i++) {
+    json += "\"" + std::string(static_cast<size_t>(i % 40), 'x');
+    if (i % 3 == 0) json += "\\\"\\\\";
+    if (i % 5 == 0) json += "\\n\\u20AC\\u0001";
+    json += "tail\",";
+  }
+  json += "], v: [0.5, 1e-7, 123456789.125, 1e300, -0.0] }";
+  TEST_EQ(parser.Parse(json.c_str()), true);
+
+  std::string text;
+  TEST_EQ(GenerateText(parser, parser.builder_.GetBufferPointer(), &text),
+          true);
+  // Numbers print the same as with NumToString().
+  TEST_NOTNULL(strstr(text.c_str(), "b: -128,"));
+  TEST_NOTNULL(strstr(text.c_str(), "l: -9223372036854775808,"));
+  TEST_NOTNULL(strstr(text.c_str(), "u: 18446744073709551615,"));
+  TEST_NOTNULL(strstr(text.c_str(), "f: 3.25,"));
+  TEST_NOTNULL(
+      strstr(text.c_str(), (flatbuffers::NumToString(-1e30) + ",").c_str()));
+  const double doubles[] = { 0.5, 1e-7, 123456789.125, 1e300, -0.0 };
+  for (size_t i = 0; i < sizeof(doubles) / sizeof(doubles[0]); i++) {
+    TEST_NOTNULL(strstr(text.c_str(),
+                        ("  " + flatbuffers::NumToString(doubles[i])).c_str()));
+  }
+  // Whatever the decimal point of the C locale, if one with another one is
+  // installed.
+  const char *comma_locales[] = { "de_DE.UTF-8", "de_DE.utf8", "de_DE",
+                                  "fr_FR.UTF-8", "fr_FR" };
+  for (size_t i = 0; i < sizeof(comma_locales) / sizeof(comma_locales[0]);
+       i++) {
+    if (!setlocale(LC_NUMERIC, comma_locales[i])) continue;
+    std::string number;
+    flatbuffers::AppendNumber(-1.5, &number);
+    setlocale(LC_NUMERIC, "C");
+    TEST_EQ_STR(number.c_str(), "-1.5");
+    break;
+  }
+  TEST_NOTNULL(strstr(text.c_str(), "\"xxx\\\"\\\\tail\""));
+  TEST_NOTNULL(strstr(text.c_str(), "\"\\n\\u20AC\\u0001tail\""));
+  // Parsing the text gives the same buffer.
+  flatbuffers::Parser reparser;
+  TEST_EQ(reparser.Parse("table T { b:byte; l:long; u:ulong; f:float;"
+                         " d:double; s:[string]; v:[double]; } root_type T;"),
+          true);
+  TEST_EQ(reparser.Parse(text.c_str()), true);
+  std::string retext;
+  TEST_EQ(GenerateText(reparser, reparser.builder_.GetBufferPointer(),
+                       &retext),
+          true);
+  TEST_EQ(retext == text, true);
+
+  // The sink gets the same text, in chunks.
+  TestSink sink;
+  TEST_EQ(GenerateTextTo(parser, parser.builder_.GetBufferPointer(), sink),
+          true);
+  TEST_EQ(sink.written == text, true);
+  TEST_EQ(sink.writes > 1, true);
+  FailingSink failing;
+  TEST_EQ(GenerateTextTo(parser, parser.builder_.GetBufferPointer(), failing),
+          false);
+}
+
+void ParseRecordsTest() {
+  flatbuffers::CompiledSchema schema;
+  TEST_EQ(schema.Parse("table R { id:long; name:string; v:[short]; }"
+                       "root_type R;"),
+          true);
+  // Enough records for several parallel tasks, and some blank lines.
+  const int kRecords = 5000;
+  std::string text;
+  for (int i = 0; i < kRecords; i++) {
+    auto id = flatbuffers::NumToString(i + 1);
+    text += "{ id: " + id + ", name: \"record " + id + "\", v: [";
+    for (int j = 0; j < i % 7; j++) text += flatbuffers::NumToString(j) + ",";
+    text += "] }\n";
+    if (i % 1000 == 0) text += "\n  \r\n";
+  }
+
+  flatbuffers::ThreadPool pool(3);
+  std::vector<flatbuffers::DetachedBuffer> buffers;
+  std::string error;
+  TEST_EQ(schema.ParseRecords(text.c_str(), text.size(), &buffers, &error,
+                              &pool),
+          true);
+  TEST_EQ(buffers.size(), static_cast<size_t>(kRecords));
+  flatbuffers::Parser parser(schema);
+  auto &r = *parser.LookupStruct("R");
+  for (int i = 0; i < kRecords; i++) {
+    auto root = flatbuffers::GetRoot<flatbuffers::Table>(buffers[i].data());
+    TEST_EQ(root->GetField<int64_t>(r.fields.Lookup("id")->value.offset, -1),
+            i + 1);
+  }
+
+  std::vector<uint8_t> stream;
+  TEST_EQ(schema.ParseRecordsToStream(text.c_str(), text.size(), &stream,
+                                      &error, &pool),
+          true);
+  size_t pos = 0;
+  for (int i = 0; i < kRecords; i++) {
+    // Every record is aligned for its longs.
+    TEST_EQ(pos % 8, 0);
+    auto size = flatbuffers::ReadScalar<flatbuffers::uoffset_t>(&stream[pos]);
+    auto root = flatbuffers::GetSizePrefixedRoot<flatbuffers::Table>(
+        &stream[pos]);
+    TEST_EQ(root->GetField<int64_t>(r.fields.Lookup("id")->value.offset, -1),
+            i + 1);
+    TEST_EQ(size >= buffers[i].size() - sizeof(flatbuffers::uoffset_t), true);
+    pos += sizeof(flatbuffers::uoffset_t) + size;
+  }
+  TEST_EQ(pos, stream.size());
+
+  // Sequentially the result is the same.
+  std::vector<uint8_t> sequential;
+  TEST_EQ(schema.ParseRecordsToStream(text.c_str(), text.size(), &sequential,
+                                      &error),
+          true);
+  TEST_EQ(sequential == stream, true);
+
+  // The first bad record is reported, with its line.
+  std::string bad = "{ id: 1 }\n\n{ id: 2, what: 3 }\n{ id: }\n";
+  TEST_EQ(schema.ParseRecords(bad.c_str(), bad.size(), &buffers, &error,
+                              &pool),
+          false);
+  TEST_EQ(error.find("record on line 3: "), 0);
+  TEST_NOTNULL(strstr(error.c_str(), "unknown field: what"));
+  TEST_EQ(buffers.size(), 0);
+}
+
+void FlexTranscoderTest() {
+  std::string schemafile;
+  std::string jsonfile;
+  std::string bfbsfile;
+  TEST_EQ(flatbuffers::LoadFile((test_data_path + "monster_test.fbs").c_str(),
+                                false, &schemafile),
+          true);
+  TEST_EQ(flatbuffers::LoadFile(
+              (test_data_path + "monsterdata_test.json").c_str(), false,
+              &jsonfile),
+          true);
+  TEST_EQ(flatbuffers::LoadFile((test_data_path + "monster_test.bfbs").c_str(),
+                                true, &bfbsfile),
+          true);
+  auto include_test_path =
+      flatbuffers::ConCatPathFileName(test_data_path, "include_test");
+  const char *include_directories[] = { test_data_path.c_str(),
+                                        include_test_path.c_str(), nullptr };
+  // Binary schemas don't say which fields are hashed, so leave those out.
+  for (;;) {
+    auto hash = jsonfile.find("testhash");
+    if (hash == std::string::npos) break;
+    jsonfile.erase(hash, jsonfile.find('\n', hash) - hash);
+  }
+
+  // The reference: the JSON parsed with its schema.
+  flatbuffers::Parser parser;
+  TEST_EQ(parser.Parse(schemafile.c_str(), include_directories), true);
+  TEST_EQ(parser.Parse(jsonfile.c_str(), include_directories), true);
+  std::string expected;
+  GenerateText(parser, parser.builder_.GetBufferPointer(), &expected);
+
+  // The same JSON as a schema-less FlexBuffer, which needs the enum values
+  // that are identifiers quoted.
+  auto quote = [&](const std::string &id) {
+    auto pos = jsonfile.find(": " + id + ",");
+    TEST_EQ(pos != std::string::npos, true);
+    jsonfile.replace(pos + 2, id.size(), "\"" + id + "\"");
+  };
+  quote("Green");
+  quote("Monster");
+  flatbuffers::Parser flex_parser;
+  flexbuffers::Builder flex;
+  TEST_EQ(flex_parser.ParseFlexBuffer(jsonfile.c_str(), nullptr, &flex), true);
+
+  auto &schema = *reflection::GetSchema(bfbsfile.c_str());
+  flatbuffers::FlexTranscoder transcoder(schema);
+  flatbuffers::FlatBufferBuilder fbb;
+  for (int i = 0; i < 2; i++) {  // Reusing the transcoder gives the same.
+    fbb.Clear();
+    TEST_EQ(transcoder.Transcode(fbb, flexbuffers::GetRoot(flex.GetBuffer())),
+            true);
+    flatbuffers::Verifier verifier(fbb.GetBufferPointer(), fbb.GetSize());
+    TEST_EQ(VerifyMonsterBuffer(verifier), true);
+    TEST_EQ(MonsterBufferHasIdentifier(fbb.GetBufferPointer()), true);
+    std::string text;
+    GenerateText(parser, fbb.GetBufferPointer(), &text);
+    TEST_EQ_STR(text.c_str(), expected.c_str());
+  }
+
+  // Errors.
+  auto check_error = [&](const char *json, const char *error) {
+    flexbuffers::Builder slb;
+    TEST_EQ(flex_parser.ParseFlexBuffer(json, nullptr, &slb), true);
+    flatbuffers::FlatBufferBuilder builder;
+    auto root = flexbuffers::GetRoot(slb.GetBuffer());
+    TEST_EQ(transcoder.Transcode(builder, root), false);
+    TEST_NOTNULL(strstr(transcoder.error().c_str(), error));
+  };
+  check_error("{ hp: 1 }", "required field is missing");
+  check_error("{ name: \"a\", hp: \"lots\" }", "expected a number");
+  check_error("{ name: \"a\", hp: 100000 }", "out of range");
+  check_error("{ name: \"a\", hp: 1e30 }", "out of range");
+  check_error("{ name: \"a\", testhashs64_fnv1: -1e19 }", "out of range");
+  check_error("{ name: \"a\", testhashu64_fnv1: -1.5 }", "out of range");
+  check_error("{ name: \"a\", color: \"Purple\" }", "expected a number");
+  check_error("{ name: \"a\", nonsense: 1 }", "unknown field: nonsense");
+  check_error("{ name: \"a\", pos: { x: 1 } }", "all fields of a struct");
+  check_error("{ name: \"a\", test: { name: \"b\" } }", "missing union type");
+  check_error("{ name: \"a\", test_type: 7, test: { name: \"b\" } }",
+              "unknown union type");
+  check_error("{ name: \"a\", inventory: 1 }", "expected a vector");
+  check_error("[ 1 ]", "table must be a map");
+  {
+    // A uint past the range of a long doesn't wrap around.
+    flexbuffers::Builder slb;
+    slb.Map([&]() {
+      slb.String("name", "a");
+      slb.Key("testhashs64_fnv1");
+      slb.UInt(0xFFFFFFFFFFFFFFFFULL);
+    });
+    slb.Finish();
+    flatbuffers::FlatBufferBuilder builder;
+    auto root = flexbuffers::GetRoot(slb.GetBuffer());
+    TEST_EQ(transcoder.Transcode(builder, root), false);
+    TEST_NOTNULL(strstr(transcoder.error().c_str(), "out of range"));
+  }
+
+  flatbuffers::FlexTranscoder lenient(schema, true);
+  flexbuffers::Builder slb;
+  TEST_EQ(flex_parser.ParseFlexBuffer(
+              "{ name: \"a\", nonsense: 1, color: \"Red\" }", nullptr,
+              &slb),
+          true);
+  fbb.Clear();
+  TEST_EQ(lenient.Transcode(fbb, flexbuffers::GetRoot(slb.GetBuffer())), true);
+  auto monster = GetMonster(fbb.GetBufferPointer());
+  TEST_EQ_STR(monster->name()->c_str(), "a");
+  TEST_EQ(monster->color(), Color_Red);
+}
+
+void VerifierStatsTest(const uint8_t *flatbuf, size_t length) {
+  // clang-format off
+  #ifdef FLATBUFFERS_VERIFIER_STATS
+  // clang-format on
+  flatbuffers::VerifierStats stats;
+  flatbuffers::Verifier verifier(flatbuf, length);
+  verifier.SetStats(&stats);
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+  // The root, the 3 monsters in testarrayoftables and the one in the union.
+  auto monsters = stats.Find(flatbuffers::TableTypeName<Monster>());
+  TEST_NOTNULL(monsters);
+  TEST_EQ(monsters->tables, 5);
+  TEST_EQ(monsters->max_depth, 2);
+  TEST_EQ(stats.tables(), 5);
+  TEST_EQ(stats.max_depth(), 2);
+  TEST_EQ(monsters->bytes > 0 && monsters->bytes <= stats.bytes(), true);
+  TEST_EQ(monsters->seconds >= 0, true);
+  TEST_EQ(stats.failed_type() == nullptr, true);
+  TEST_EQ(stats.depth(), 0);
+  // Tables a failure leaves unfinished are ended back to where it started.
+  stats.BeginTable("Outer", 1);
+  stats.BeginTable("Inner", 2);
+  stats.BeginTable("Inner", 3);
+  stats.Fail();
+  stats.Unwind(1);
+  TEST_EQ(stats.depth(), 1);
+  TEST_EQ_STR(stats.failed_type(), "Inner");
+  TEST_EQ(stats.Find("Inner")->tables, 2);
+  stats.Unwind(0);
+  TEST_EQ(stats.depth(), 0);
+
+  // The same through reflection.
+  std::string bfbsfile;
+  TEST_EQ(flatbuffers::LoadFile((test_data_path + "monster_test.bfbs").c_str(),
+                                true, &bfbsfile),
+          true);
+  auto &schema = *reflection::GetSchema(bfbsfile.c_str());
+  flatbuffers::VerifierStats reflection_stats;
+  flatbuffers::Verifier reflection_verifier(flatbuf, length);
+  reflection_verifier.SetStats(&reflection_stats);
+  TEST_EQ(flatbuffers::Verify(schema, *schema.root_table(), flatbuf,
+                              reflection_verifier),
+          true);
+  auto reflected = reflection_stats.Find("MyGame.Example.Monster");
+  TEST_NOTNULL(reflected);
+  TEST_EQ(reflected->tables, 5);
+  TEST_EQ(reflected->max_depth, 2);
+  // clang-format off
+  #else
+    (void)flatbuf;
+    (void)length;
+  #endif
+  // clang-format on
+}
+
+// clang-format off
+#ifdef FLATBUFFERS_BUILDER_STATS
+// clang-format on
+// Also counts the calls, as a metrics system hooked up to it would.
+struct CountingBuilderStats : flatbuffers::BuilderStats {
+  CountingBuilderStats() : calls(0) {}
+  void Count(Counter counter, size_t n) FLATBUFFERS_OVERRIDE {
+    calls++;
+    BuilderStats::Count(counter, n);
+  }
+  size_t calls;
+};
+// clang-format off
+#endif
+// clang-format on
+
+void BuilderStatsTest() {
+  // clang-format off
+  #ifdef FLATBUFFERS_BUILDER_STATS
+  // clang-format on
+  typedef flatbuffers::BuilderStats Stats;
+  CountingBuilderStats stats;
+  flatbuffers::FlatBufferBuilder fbb(16);
+  fbb.SetStats(&stats);
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int i = 0; i < 3; i++) {
+    auto name = fbb.CreateSharedString("Fred");
+    monsters.push_back(CreateMonster(fbb, nullptr, 0, 0, name));
+  }
+  auto name = fbb.CreateSharedString("Barney");
+  auto inventory = fbb.CreateVector(std::vector<uint8_t>(3, 1));
+  FinishMonsterBuffer(fbb, CreateMonster(fbb, nullptr, 0, 0, name, inventory,
+                                         Color_Blue, Any_NONE, 0, 0, 0,
+                                         fbb.CreateVector(monsters)));
+  TEST_EQ(stats.count(Stats::kReallocations), fbb.GetReallocationCount());
+  TEST_EQ(stats.count(Stats::kReallocations) > 0, true);
+  TEST_EQ(stats.count(Stats::kBytesCopied), fbb.GetReallocatedBytes());
+  TEST_EQ(stats.count(Stats::kSharedStrings), 2U);
+  TEST_EQ(stats.count(Stats::kSharedStringHits), 2U);
+  TEST_EQ(stats.count(Stats::kVtablesEmitted), 2U);
+  TEST_EQ(stats.count(Stats::kVtablesDeduped), 2U);
+  TEST_EQ(stats.count(Stats::kPaddingBytes) > 0, true);
+  TEST_EQ(stats.count(Stats::kBuffersFinished), 1U);
+  TEST_EQ(stats.count(Stats::kFinishedBytes), fbb.GetSize());
+  TEST_EQ(stats.calls > 0, true);
+  TEST_EQ_STR(Stats::CounterName(Stats::kVtablesDeduped), "vtables_deduped");
+
+  // Without stats, nothing is counted.
+  fbb.SetStats(nullptr);
+  fbb.Clear();
+  FinishMonsterBuffer(fbb, CreateMonster(fbb, nullptr, 0, 0,
+                                         fbb.CreateSharedString("Fred")));
+  TEST_EQ(stats.count(Stats::kBuffersFinished), 1U);
+
+  // FlexBuffers count keys with strings, and key vectors as vtables.
+  stats.Clear();
+  flexbuffers::Builder slb(16, flexbuffers::BUILDER_FLAG_SHARE_ALL);
+  slb.SetStats(&stats);
+  slb.Vector([&]() {
+    for (int i = 0; i < 3; i++) {
+      slb.Map([&]() {
+        slb.String("name", "Fred");
+        slb.Int("hp", i);
+      });
+    }
+  });
+  slb.Finish();
+  TEST_EQ(stats.count(Stats::kSharedStrings), 3U);
+  TEST_EQ(stats.count(Stats::kSharedStringHits), 6U);
+  TEST_EQ(stats.count(Stats::kVtablesEmitted), 1U);
+  TEST_EQ(stats.count(Stats::kVtablesDeduped), 2U);
+  TEST_EQ(stats.count(Stats::kReallocations) > 0, true);
+  TEST_EQ(stats.count(Stats::kFinishedBytes), slb.GetSize());
+  // clang-format off
+  #endif
+  // clang-format on
+}
+
+void MappedBufferTest() {
+  auto filename = test_data_path + "monsterdata_test.mon";
+  std::string loaded;
+  TEST_EQ(flatbuffers::LoadFile(filename.c_str(), true, &loaded), true);
+
+  flatbuffers::MappedBuffer mapped;
+  TEST_EQ(mapped.Map(filename.c_str()), true);
+  TEST_EQ(mapped.size(), loaded.size());
+  TEST_EQ(memcmp(mapped.data(), loaded.data(), loaded.size()), 0);
+  // Not every platform takes hints, just check they're harmless.
+  mapped.Advise(flatbuffers::MappedBuffer::kAdviceWillNeed);
+  mapped.Advise(flatbuffers::MappedBuffer::kAdviceRandom, 5, 10);
+
+  auto verifier = mapped.GetVerifier();
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+  auto lazy = mapped.GetLazyVerifier();
+  TEST_EQ(lazy.VerifyRoot<Monster>(MonsterIdentifier()), true);
+  auto monster = mapped.GetRoot<Monster>();
+  TEST_EQ_STR(monster->name()->c_str(), "MyMonster");
+  TEST_EQ(lazy.Verify(monster->name()), true);
+
+  // The mapping moves along with the buffer.
+  auto data = mapped.data();
+  flatbuffers::MappedBuffer moved(std::move(mapped));
+  TEST_EQ(mapped.data() == nullptr, true);
+  TEST_EQ(moved.data() == data, true);
+  moved.Unmap();
+  TEST_EQ(moved.empty(), true);
+
+  TEST_EQ(moved.Map((test_data_path + "does_not_exist.mon").c_str()), false);
+  TEST_EQ(moved.Map(test_data_path.c_str()), false);
+  TEST_EQ(moved.empty(), true);
+}
+
+void StreamTest() {
+  TestSink sink;
+  flatbuffers::StreamWriter writer(sink, 4);
+  TEST_EQ(writer.ok(), true);
+  flatbuffers::FlatBufferBuilder builder;
+  for (int i = 0; i < 10; i++) {
+    builder.Clear();
+    auto name = builder.CreateString(std::string(i * 10, 'x'));
+    builder.FinishSizePrefixed(
+        CreateMonster(builder, nullptr, 0, static_cast<int16_t>(i), name),
+        MonsterIdentifier());
+    TEST_EQ(writer.Append(builder), true);
+  }
+  // Buffers without a size prefix aren't records.
+  builder.Clear();
+  builder.Finish(CreateMonster(builder, nullptr, 0, 0,
+                               builder.CreateString("Fred")));
+  TEST_EQ(writer.Append(builder), false);
+  TEST_EQ(writer.size(), 10U);
+  auto unfinished = sink.written;
+  TEST_EQ(writer.Finish(), true);
+  TEST_EQ(writer.Append(builder), false);
+
+  auto data = reinterpret_cast<const uint8_t *>(sink.written.data());
+  flatbuffers::StreamReader reader;
+  TEST_EQ(reader.Open(data, sink.written.size()), true);
+  TEST_EQ(reader.indexed(), true);
+  TEST_EQ(reader.size(), 10U);
+  TEST_EQ(reader.GetRoot<Monster>(7)->hp(), 7);
+  TEST_EQ(reader.GetRoot<Monster>(9)->name()->size(), 90U);
+  TEST_EQ(reader.VerifyRecord<Monster>(3), true);
+  TEST_EQ(reader.Record(10) == nullptr, true);
+  TEST_EQ(reader.RecordOffset(0), flatbuffers::kStreamHeaderSize);
+  TEST_EQ(reader.RecordOffset(5) % FLATBUFFERS_MAX_ALIGNMENT, 0U);
+  TEST_EQ(reader.VerifyAll<Monster>(), 0U);
+  flatbuffers::ThreadPool pool(3);
+  TEST_EQ(reader.VerifyAll<Monster>(&pool), 0U);
+
+  // Without an index, the records are found by scanning them.
+  flatbuffers::StreamReader scanned;
+  TEST_EQ(scanned.Open(reinterpret_cast<const uint8_t *>(unfinished.data()),
+                       unfinished.size()),
+          true);
+  TEST_EQ(scanned.indexed(), false);
+  TEST_EQ(scanned.size(), 10U);
+  TEST_EQ(scanned.GetRoot<Monster>(9)->hp(), 9);
+  TEST_EQ(scanned.records_end(), reader.records_end());
+  // A record that was cut short doesn't count.
+  auto last = scanned.RecordOffset(9);
+  TEST_EQ(scanned.Open(reinterpret_cast<const uint8_t *>(unfinished.data()),
+                       last + 8),
+          true);
+  TEST_EQ(scanned.size(), 9U);
+
+  // Carry on with a finished stream, replacing its index.
+  TestSink appended;
+  appended.written = sink.written.substr(0, reader.records_end());
+  flatbuffers::StreamWriter more(appended, reader);
+  for (int i = 10; i < 13; i++) {
+    builder.Clear();
+    builder.FinishSizePrefixed(
+        CreateMonster(builder, nullptr, 0, static_cast<int16_t>(i),
+                      builder.CreateString("more")),
+        MonsterIdentifier());
+    TEST_EQ(more.Append(builder), true);
+  }
+  TEST_EQ(more.Finish(), true);
+  flatbuffers::StreamReader longer;
+  auto appended_data =
+      reinterpret_cast<const uint8_t *>(appended.written.data());
+  TEST_EQ(longer.Open(appended_data, appended.written.size()), true);
+  TEST_EQ(longer.indexed(), true);
+  TEST_EQ(longer.size(), 13U);
+  TEST_EQ(longer.GetRoot<Monster>(8)->hp(), 8);
+  TEST_EQ(longer.GetRoot<Monster>(12)->hp(), 12);
+  TEST_EQ(longer.VerifyAll<Monster>(&pool), 0U);
+
+  // A record with a broken size can't be read, nor can the ones after it up
+  // to the next index entry.
+  std::string corrupt = sink.written;
+  corrupt[reader.RecordOffset(5) + 3] = '\x7f';
+  TEST_EQ(reader.Open(reinterpret_cast<const uint8_t *>(corrupt.data()),
+                      corrupt.size()),
+          true);
+  TEST_EQ(reader.VerifyRecord<Monster>(5), false);
+  TEST_EQ(reader.Record(7) == nullptr, true);
+  TEST_EQ(reader.GetRoot<Monster>(8)->hp(), 8);
+  TEST_EQ(reader.VerifyAll<Monster>(&pool), 3U);
+
+  // A record count that would make the size of the index wrap around isn't
+  // believed, the stream is scanned instead, up to the index.
+  std::string huge = sink.written;
+  flatbuffers::WriteScalar<uint64_t>(
+      &huge[huge.size() - flatbuffers::kStreamTrailerSize + 8],
+      10 + (1ULL << 63));
+  TEST_EQ(reader.Open(reinterpret_cast<const uint8_t *>(huge.data()),
+                      huge.size()),
+          true);
+  TEST_EQ(reader.indexed(), false);
+  TEST_EQ(reader.size(), 10U);
+  TEST_EQ(reader.GetRoot<Monster>(9)->hp(), 9);
+
+  // So is a stream that lost its last byte, which a writer carrying on with
+  // it appends to right after the records.
+  std::string cut = sink.written.substr(0, sink.written.size() - 1);
+  TEST_EQ(reader.Open(reinterpret_cast<const uint8_t *>(cut.data()),
+                      cut.size()),
+          true);
+  TEST_EQ(reader.indexed(), false);
+  TEST_EQ(reader.size(), 10U);
+  TEST_EQ(reader.VerifyAll<Monster>(), 0U);
+  TEST_EQ(reader.records_end(),
+          flatbuffers::ReadScalar<uint64_t>(
+              &sink.written[sink.written.size() -
+                            flatbuffers::kStreamTrailerSize]));
+
+  // Streams can be mapped from files.
+  auto filename = test_data_path + "stream_test.tmp";
+  TEST_EQ(flatbuffers::SaveFile(filename.c_str(), sink.written, true), true);
+  TEST_EQ(reader.Open(filename.c_str()), true);
+  TEST_EQ(reader.size(), 10U);
+  TEST_EQ(reader.GetRoot<Monster>(4)->hp(), 4);
+  std::remove(filename.c_str());
+
+  const uint8_t not_a_stream[] = "FBSS not a stream";
+  TEST_EQ(reader.Open(not_a_stream, sizeof(not_a_stream)), false);
+  TEST_EQ(reader.size(), 0U);
+}
+
+void CompressedStreamTest() {
+  // The codec on its own: repetitive data shrinks, and round trips.
+  std::string text;
+  for (int i = 0; i < 100; i++)
+    text += "monster " + flatbuffers::NumToString(i % 7);
+  auto raw = reinterpret_cast<const uint8_t *>(text.data());
+  flatbuffers::LzBlockCodec codec;
+  std::vector<uint8_t> packed;
+  TEST_EQ(codec.Compress(raw, text.size(), &packed), true);
+  TEST_EQ(packed.size() < text.size() / 4, true);
+  std::vector<uint8_t> unpacked(text.size());
+  TEST_EQ(codec.Decompress(packed.data(), packed.size(), unpacked.data(),
+                           unpacked.size()),
+          true);
+  TEST_EQ(memcmp(unpacked.data(), raw, text.size()), 0);
+  TEST_EQ(codec.Decompress(packed.data(), packed.size() - 1, unpacked.data(),
+                           unpacked.size()),
+          false);
+
+  // A dictionary lets even a short block refer back to it.
+  flatbuffers::LzBlockCodec dict_codec(raw, text.size());
+  std::vector<uint8_t> with_dict, without_dict;
+  TEST_EQ(dict_codec.Compress(raw + 100, 40, &with_dict), true);
+  TEST_EQ(codec.Compress(raw + 100, 40, &without_dict), true);
+  TEST_EQ(with_dict.size() < without_dict.size(), true);
+  TEST_EQ(dict_codec.Decompress(with_dict.data(), with_dict.size(),
+                                unpacked.data(), 40),
+          true);
+  TEST_EQ(memcmp(unpacked.data(), raw + 100, 40), 0);
+
+  TestSink sink;
+  flatbuffers::CompressedStreamWriter writer(sink, codec, 8);
+  flatbuffers::FlatBufferBuilder builder;
+  size_t raw_size = 0;
+  for (int i = 0; i < 20; i++) {
+    builder.Clear();
+    auto name = builder.CreateString(std::string(i * 10, 'x'));
+    builder.FinishSizePrefixed(
+        CreateMonster(builder, nullptr, 0, static_cast<int16_t>(i), name),
+        MonsterIdentifier());
+    TEST_EQ(writer.Append(builder), true);
+    raw_size += builder.GetSize();
+  }
+  TEST_EQ(writer.size(), 20U);
+  TEST_EQ(writer.Finish(), true);
+  TEST_EQ(sink.written.size() < raw_size / 2, true);
+  TEST_EQ(writer.Append(builder), false);
+
+  flatbuffers::CompressedStreamReader reader(codec);
+  TEST_EQ(reader.Open(reinterpret_cast<const uint8_t *>(sink.written.data()),
+                      sink.written.size()),
+          true);
+  TEST_EQ(reader.size(), 20U);
+  TEST_EQ(reader.num_blocks(), 3U);
+  for (size_t i = 0; i < reader.size(); i++) {
+    TEST_EQ(reader.VerifyRecord<Monster>(i), true);
+    TEST_EQ(reader.GetRoot<Monster>(i)->hp(), static_cast<int16_t>(i));
+  }
+  // Records can be taken out in memory of their own, in any order.
+  auto record = reader.Record(17);
+  auto first = reader.Record(3);
+  TEST_EQ(
+      flatbuffers::GetSizePrefixedRoot<Monster>(record.data())->name()->size(),
+      170U);
+  TEST_EQ(flatbuffers::GetSizePrefixedRoot<Monster>(first.data())->hp(), 3);
+  TEST_EQ(reader.Record(20).size(), 0U);
+  TEST_EQ(reader.GetRoot<Monster>(20) == nullptr, true);
+
+  // Blocks that don't compress are stored as they are.
+  TestSink stored_sink;
+  flatbuffers::CompressedStreamWriter stored(stored_sink, codec, 1);
+  uint8_t noise[68];
+  uint32_t state = 12345;
+  for (size_t i = 0; i < sizeof(noise); i++) {
+    state = state * 1103515245 + 12345;
+    noise[i] = static_cast<uint8_t>(state >> 24);
+  }
+  flatbuffers::WriteScalar(noise, static_cast<flatbuffers::uoffset_t>(64));
+  TEST_EQ(stored.Append(noise, sizeof(noise)), true);
+  TEST_EQ(stored.Finish(), true);
+  flatbuffers::CompressedStreamReader stored_reader(codec);
+  TEST_EQ(stored_reader.Open(
+              reinterpret_cast<const uint8_t *>(stored_sink.written.data()),
+              stored_sink.written.size()),
+          true);
+  size_t size = 0;
+  auto p = stored_reader.RecordPointer(0, &size);
+  TEST_EQ(size, sizeof(noise));
+  TEST_EQ(memcmp(p, noise, size), 0);
+
+  // A block that doesn't decompress to its size can't be read, but the
+  // others still can.
+  std::string corrupt = sink.written;
+  corrupt[flatbuffers::kStreamHeaderSize + 8] ^= 0x01;
+  flatbuffers::CompressedStreamReader damaged(codec);
+  TEST_EQ(damaged.Open(reinterpret_cast<const uint8_t *>(corrupt.data()),
+                       corrupt.size()),
+          true);
+  TEST_EQ(damaged.VerifyRecord<Monster>(0), false);
+  TEST_EQ(damaged.Record(7).size(), 0U);
+  TEST_EQ(damaged.GetRoot<Monster>(8)->hp(), 8);
+
+  // Nor can one claiming to be larger than its data could decompress to,
+  // which is rejected before allocating that much.
+  std::string inflated = sink.written;
+  memset(&inflated[flatbuffers::kStreamHeaderSize + 8], 0xFF, 4);
+  flatbuffers::CompressedStreamReader bloated(codec);
+  TEST_EQ(bloated.Open(reinterpret_cast<const uint8_t *>(inflated.data()),
+                       inflated.size()),
+          true);
+  TEST_EQ(bloated.Record(0).size(), 0U);
+  TEST_EQ(bloated.GetRoot<Monster>(8)->hp(), 8);
+}
+
+static std::string saved_file_name;
+bool RecordingSaveFile(const char *name, const char *buf, size_t len,
+                       bool binary) {
+  (void)buf;
+  (void)len;
+  (void)binary;
+  saved_file_name = name;
+  return true;
+}
+
+void SaveFileTest() {
+  auto filename = test_data_path + "save_file_test.tmp";
+  std::string loaded;
+  TEST_EQ(flatbuffers::SaveFile(filename.c_str(), "abc", 3, true), true);
+  TEST_EQ(flatbuffers::SaveFileIfChanged(filename.c_str(), "abc", 3, true),
+          true);
+  TEST_EQ(flatbuffers::LoadFile(filename.c_str(), true, &loaded), true);
+  TEST_EQ(loaded == "abc", true);
+  TEST_EQ(flatbuffers::SaveFileIfChanged(filename.c_str(), "abcd", 4, true),
+          true);
+  TEST_EQ(flatbuffers::LoadFile(filename.c_str(), true, &loaded), true);
+  TEST_EQ(loaded == "abcd", true);
+  TEST_EQ(flatbuffers::SaveFileIfChanged(filename.c_str(), "abce", 4, false),
+          true);
+  TEST_EQ(flatbuffers::LoadFile(filename.c_str(), true, &loaded), true);
+  TEST_EQ(loaded == "abce", true);
+  std::remove(filename.c_str());
+
+  // Everything saving files goes through the hook, e.g. code generators.
+  auto previous = flatbuffers::SetSaveFileFunction(RecordingSaveFile);
+  TEST_EQ(flatbuffers::SaveFile(filename.c_str(), std::string("abc"), false),
+          true);
+  TEST_EQ(saved_file_name == filename, true);
+  TEST_EQ(flatbuffers::FileExists(filename.c_str()), false);
+  flatbuffers::SetSaveFileFunction(previous);
+}
+
+void FieldAccessorTest(const uint8_t *flatbuf) {
+  std::string bfbsfile;
+  TEST_EQ(flatbuffers::LoadFile((test_data_path + "monster_test.bfbs").c_str(),
+                                true, &bfbsfile),
+          true);
+  auto &schema = *reflection::GetSchema(bfbsfile.c_str());
+  auto &root_table = *schema.root_table();
+  auto &root = *flatbuffers::GetAnyRoot(flatbuf);
+  auto monster = GetMonster(flatbuf);
+
+  // The same as GetAnyFieldI() for all the scalars that are set.
+  auto fields = root_table.fields();
+  for (auto it = fields->begin(); it != fields->end(); ++it) {
+    if (!flatbuffers::IsScalar(it->type()->base_type())) continue;
+    flatbuffers::FieldAccessor accessor;
+    TEST_EQ(accessor.Resolve(schema, root_table, it->name()->c_str()), true);
+    TEST_EQ(accessor.IsPresent(root), root.CheckField(it->offset()));
+    if (!accessor.IsPresent(root)) continue;
+    TEST_EQ(accessor.GetI(root), flatbuffers::GetAnyFieldI(root, **it));
+    TEST_EQ(accessor.GetF(root), flatbuffers::GetAnyFieldF(root, **it));
+    TEST_EQ(accessor.GetS(root),
+            flatbuffers::GetAnyFieldS(root, **it, &schema));
+  }
+
+  flatbuffers::FieldAccessor hp;
+  TEST_EQ(hp.valid(), false);
+  TEST_EQ(hp.Resolve(schema, root_table, "hp"), true);
+  TEST_EQ(hp.valid(), true);
+  TEST_EQ_STR(hp.field().name()->c_str(), "hp");
+  TEST_EQ(hp.GetI(root), 80);
+  TEST_EQ(hp.GetF(root), 80.0);
+  TEST_EQ_STR(hp.GetS(root).c_str(), "80");
+
+  // Through structs.
+  flatbuffers::FieldAccessor pos_z, test3_b;
+  TEST_EQ(pos_z.Resolve(schema, root_table, "pos.z"), true);
+  TEST_EQ(pos_z.GetF(root), monster->pos()->z());
+  TEST_EQ(test3_b.Resolve(schema, root_table, "pos.test3.b"), true);
+  TEST_EQ(test3_b.GetI(root), monster->pos()->test3().b());
+
+  flatbuffers::FieldAccessor name;
+  TEST_EQ(name.Resolve(schema, root_table, "name"), true);
+  TEST_EQ_STR(name.GetString(root)->c_str(), "MyMonster");
+  TEST_EQ_STR(name.GetS(root).c_str(), "MyMonster");
+
+  // Through a table that isn't set: the default, converted to the type asked
+  // for.
+  flatbuffers::FieldAccessor enemy_hp, enemy_name, enemy;
+  TEST_EQ(enemy_hp.Resolve(schema, root_table, "enemy.hp"), true);
+  TEST_EQ(enemy_hp.IsPresent(root), false);
+  TEST_EQ(enemy_hp.GetI(root), 100);
+  TEST_EQ(enemy_hp.GetF(root), 100.0);
+  TEST_EQ_STR(enemy_hp.GetS(root).c_str(), "100");
+  TEST_EQ(enemy_name.Resolve(schema, root_table, "enemy.name"), true);
+  TEST_EQ(enemy_name.GetString(root) == nullptr, true);
+  TEST_EQ(enemy.Resolve(schema, root_table, "enemy"), true);
+  TEST_EQ(enemy.GetTable(root) == nullptr, true);
+
+  // And through one that is: the union's table, a Monster.
+  auto &monster_table =
+      *schema.objects()->LookupByKey("MyGame.Example.Monster");
+  flatbuffers::FieldAccessor test;
+  TEST_EQ(test.Resolve(schema, monster_table, "name"), true);
+  auto union_table = flatbuffers::GetFieldT(root, *fields->LookupByKey("test"));
+  TEST_EQ_STR(test.GetString(*union_table)->c_str(),
+              monster->test_as_Monster()->name()->c_str());
+
+  flatbuffers::FieldAccessor bad;
+  TEST_EQ(bad.Resolve(schema, root_table, "nope"), false);
+  TEST_EQ(bad.valid(), false);
+  TEST_EQ(bad.Resolve(schema, root_table, "name.x"), false);
+  TEST_EQ(bad.Resolve(schema, root_table, "pos.w"), false);
+  TEST_EQ(bad.Resolve(schema, root_table, "testarrayoftables.hp"), false);
+  TEST_EQ(bad.Resolve(schema, root_table, "hp."), false);
+  TEST_EQ(bad.valid(), false);
+}
 
-  // to ensure it is correct, we now generate text back from the binary,
-  // and compare the two:
-  std::string jsongen;
-  auto result =
-      GenerateText(parser, parser.builder_.GetBufferPointer(), &jsongen);
-  TEST_EQ(result, true);
-  TEST_EQ_STR(jsongen.c_str(), jsonfile.c_str());
+void ColumnExtractorTest() {
+  std::string bfbsfile;
+  TEST_EQ(flatbuffers::LoadFile((test_data_path + "monster_test.bfbs").c_str(),
+                                true, &bfbsfile),
+          true);
+  auto &schema = *reflection::GetSchema(bfbsfile.c_str());
 
-  // We can also do the above using the convenient Registry that knows about
-  // a set of file_identifiers mapped to schemas.
-  flatbuffers::Registry registry;
-  // Make sure schemas can find their includes.
-  registry.AddIncludeDirectory(test_data_path.c_str());
-  registry.AddIncludeDirectory(include_test_path.c_str());
-  // Call this with many schemas if possible.
-  registry.Register(MonsterIdentifier(),
-                    (test_data_path + "monster_test.fbs").c_str());
-  // Now we got this set up, we can parse by just specifying the identifier,
-  // the correct schema will be loaded on the fly:
-  auto buf = registry.TextToFlatBuffer(jsonfile.c_str(), MonsterIdentifier());
-  // If this fails, check registry.lasterror_.
-  TEST_NOTNULL(buf.data());
-  // Test the buffer, to be sure:
-  AccessFlatBufferTest(buf.data(), buf.size(), false);
-  // We can use the registry to turn this back into text, in this case it
-  // will get the file_identifier from the binary:
-  std::string text;
-  auto ok = registry.FlatBufferToText(buf.data(), buf.size(), &text);
-  // If this fails, check registry.lasterror_.
-  TEST_EQ(ok, true);
-  TEST_EQ_STR(text.c_str(), jsonfile.c_str());
+  // Rows with a few different vtables: with pos, enemy and testbool set or
+  // not.
+  const size_t kRows = 2501;
+  std::vector<flatbuffers::DetachedBuffer> rows;
+  std::vector<const uint8_t *> buffers;
+  for (size_t i = 0; i < kRows; i++) {
+    flatbuffers::FlatBufferBuilder fbb;
+    auto name = fbb.CreateString("m" + flatbuffers::NumToString(i));
+    flatbuffers::Offset<Monster> enemy;
+    if (i % 5 == 0) {
+      enemy = CreateMonster(fbb, nullptr, 0, static_cast<int16_t>(i),
+                            fbb.CreateString("e"));
+    }
+    Vec3 pos(static_cast<float>(i), 2, 3, 0, Color_Red, Test(10, 20));
+    MonsterBuilder mb(fbb);
+    mb.add_name(name);
+    mb.add_hp(static_cast<int16_t>(i * 3));
+    if (i % 3) mb.add_pos(&pos);
+    if (i % 5 == 0) mb.add_enemy(enemy);
+    if (i % 7 == 0) mb.add_testbool(true);
+    mb.add_testhashu64_fnv1(i * 1000000007ULL);
+    FinishMonsterBuffer(fbb, mb.Finish());
+    rows.push_back(fbb.Release());
+    buffers.push_back(rows.back().data());
+  }
+
+  flatbuffers::ColumnExtractor extractor(schema, *schema.root_table());
+  TEST_EQ(extractor.AddColumn("hp"), true);
+  TEST_EQ(extractor.AddColumn("pos.x"), true);
+  TEST_EQ(extractor.AddColumn("name"), true);
+  TEST_EQ(extractor.AddColumn("enemy.name"), true);
+  TEST_EQ(extractor.AddColumn("enemy.hp"), true);
+  TEST_EQ(extractor.AddColumn("testbool"), true);
+  TEST_EQ(extractor.AddColumn("testhashu64_fnv1"), true);
+  TEST_EQ(extractor.AddColumn("pos.test3.b"), true);
+  TEST_EQ(extractor.AddColumn("nope"), false);
+  TEST_EQ(extractor.AddColumn("pos"), false);  // Not a scalar or string.
+  TEST_EQ(extractor.AddColumn("inventory"), false);
+  TEST_EQ(extractor.num_columns(), 8);
+
+  flatbuffers::ThreadPool pool(3);
+  for (int parallel = 0; parallel < 2; parallel++) {
+    extractor.Extract(flatbuffers::vector_data(buffers), buffers.size(),
+                      parallel ? &pool : nullptr);
+    auto &hp = extractor.column(0);
+    auto &pos_x = extractor.column(1);
+    auto &name = extractor.column(2);
+    auto &enemy_name = extractor.column(3);
+    auto &enemy_hp = extractor.column(4);
+    auto &testbool = extractor.column(5);
+    auto &hash = extractor.column(6);
+    auto &test3_b = extractor.column(7);
+    TEST_EQ_STR(hp.path.c_str(), "hp");
+    TEST_EQ(hp.type, reflection::Short);
+    TEST_EQ(hp.length, kRows);
+    TEST_EQ(hp.null_count, 0);
+    TEST_EQ(hp.values.size(), kRows * sizeof(int16_t));
+    TEST_EQ(name.offsets.size(), kRows + 1);
+    TEST_EQ(name.null_count, 0);
+    TEST_EQ(enemy_name.null_count, kRows - (kRows + 4) / 5);
+    TEST_EQ(enemy_hp.null_count, 0);
+    TEST_EQ(testbool.values.size(), (kRows + 7) / 8);
+    auto is_set = [](const std::vector<uint8_t> &bits, size_t i) {
+      return ((bits[i / 8] >> (i % 8)) & 1) != 0;
+    };
+    for (size_t i = 0; i < kRows; i++) {
+      auto monster = GetMonster(buffers[i]);
+      int16_t hp_val;
+      memcpy(&hp_val, &hp.values[i * sizeof(hp_val)], sizeof(hp_val));
+      TEST_EQ(hp_val, monster->hp());
+      TEST_EQ(is_set(hp.validity, i), true);
+      float x;
+      memcpy(&x, &pos_x.values[i * sizeof(x)], sizeof(x));
+      TEST_EQ(x, monster->pos() ? monster->pos()->x() : 0.0f);
+      int8_t b;
+      memcpy(&b, &test3_b.values[i * sizeof(b)], sizeof(b));
+      TEST_EQ(b, monster->pos() ? monster->pos()->test3().b() : 0);
+      std::string row_name(&name.data[0] + name.offsets[i],
+                           &name.data[0] + name.offsets[i + 1]);
+      TEST_EQ_STR(row_name.c_str(), monster->name()->c_str());
+      TEST_EQ(is_set(enemy_name.validity, i), monster->enemy() != nullptr);
+      if (monster->enemy()) {
+        TEST_EQ(enemy_name.offsets[i + 1] - enemy_name.offsets[i], 1);
+      } else {
+        TEST_EQ(enemy_name.offsets[i + 1], enemy_name.offsets[i]);
+      }
+      int16_t enemy_hp_val;
+      memcpy(&enemy_hp_val, &enemy_hp.values[i * sizeof(enemy_hp_val)],
+             sizeof(enemy_hp_val));
+      // The default if there's no enemy.
+      TEST_EQ(enemy_hp_val, monster->enemy() ? monster->enemy()->hp() : 100);
+      TEST_EQ(is_set(testbool.values, i), monster->testbool());
+      uint64_t hash_val;
+      memcpy(&hash_val, &hash.values[i * sizeof(hash_val)], sizeof(hash_val));
+      TEST_EQ(hash_val, monster->testhashu64_fnv1());
+    }
+  }
+  // Fewer rows reuse the columns.
+  extractor.Extract(flatbuffers::vector_data(buffers), 3);
+  TEST_EQ(extractor.column(2).length, 3);
+  TEST_EQ(extractor.column(2).data.size(), 6);  // "m0m1m2"
+  TEST_EQ(extractor.column(2).offsets[3], 6);
 }
 
 void ReflectionTest(uint8_t *flatbuf, size_t length) {
@@ -827,6 +2939,355 @@ void ReflectionTest(uint8_t *flatbuf, size_t length) {
           true);
 }
 
+// Resizes strings and vectors of a Monster with a ResizeBatch, "step" picks
+// the edit, or does all of them if -1.
+void ResizeMonster(const reflection::Schema &schema, int step,
+                   std::vector<uint8_t> *buf) {
+  auto fields = schema.root_table()->fields();
+  auto &root = *flatbuffers::GetAnyRoot(flatbuffers::vector_data(*buf));
+  auto strings =
+      flatbuffers::GetFieldV<flatbuffers::Offset<flatbuffers::String>>(
+          root, *fields->LookupByKey("testarrayofstring"));
+  auto tables = flatbuffers::GetFieldV<flatbuffers::Offset<Monster>>(
+      root, *fields->LookupByKey("testarrayoftables"));
+  flatbuffers::ResizeBatch batch(schema, buf);
+  // Growing, shrinking by less than the alignment, and shrinking by more.
+  if (step < 0 || step == 0)
+    batch.SetString(GetFieldS(root, *fields->LookupByKey("name")),
+                    "a much longer name than before");
+  if (step < 0 || step == 1) batch.SetString(strings->Get(1), "");
+  if (step < 0 || step == 2)
+    batch.ResizeVector<uint8_t>(
+        flatbuffers::GetFieldV<uint8_t>(root,
+                                        *fields->LookupByKey("inventory")),
+        1, 0);
+  if (step < 0 || step == 3)
+    batch.SetString(tables->Get(1)->name(), "Frodo Baggins of Bag End");
+  if (step < 0 || step == 4)
+    batch.ResizeVector<Test>(
+        flatbuffers::GetFieldV<Test>(root, *fields->LookupByKey("test4")), 5,
+        Test(7, 8));
+  batch.Apply();
+  TEST_EQ(batch.size(), 0U);
+}
+
+void ResizeBatchTest(const uint8_t *flatbuf, size_t length) {
+  std::string bfbsfile;
+  TEST_EQ(flatbuffers::LoadFile((test_data_path + "monster_test.bfbs").c_str(),
+                                true, &bfbsfile),
+          true);
+  auto &schema = *reflection::GetSchema(bfbsfile.c_str());
+
+  std::vector<uint8_t> batched(flatbuf, flatbuf + length);
+  ResizeMonster(schema, -1, &batched);
+  flatbuffers::Verifier verifier(flatbuffers::vector_data(batched),
+                                 batched.size());
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+  TEST_EQ(flatbuffers::Verify(schema, *schema.root_table(),
+                              flatbuffers::vector_data(batched),
+                              batched.size()),
+          true);
+  auto monster = GetMonster(flatbuffers::vector_data(batched));
+  TEST_EQ_STR(monster->name()->c_str(), "a much longer name than before");
+  TEST_EQ_STR(monster->testarrayofstring()->Get(0)->c_str(), "bob");
+  TEST_EQ(monster->testarrayofstring()->Get(1)->size(), 0U);
+  TEST_EQ(monster->inventory()->size(), 1U);
+  TEST_EQ(monster->inventory()->Get(0), 0);
+  TEST_EQ_STR(monster->testarrayoftables()->Get(0)->name()->c_str(),
+              "Barney");
+  TEST_EQ_STR(monster->testarrayoftables()->Get(1)->name()->c_str(),
+              "Frodo Baggins of Bag End");
+  TEST_EQ_STR(monster->testarrayoftables()->Get(2)->name()->c_str(), "Wilma");
+  auto test4 = monster->test4();
+  TEST_EQ(test4->size(), 5U);
+  TEST_EQ(test4->Get(1)->b(), 40);
+  TEST_EQ(test4->Get(4)->a(), 7);
+  TEST_EQ(test4->Get(4)->b(), 8);
+  TEST_EQ(monster->hp(), 80);
+
+  // Doing the edits one at a time gives the same buffer.
+  std::vector<uint8_t> one_by_one(flatbuf, flatbuf + length);
+  for (int step = 0; step < 5; step++) {
+    ResizeMonster(schema, step, &one_by_one);
+  }
+  TEST_EQ(one_by_one == batched, true);
+}
+
+void TableCopierTest(const uint8_t *flatbuf) {
+  std::string bfbsfile;
+  TEST_EQ(flatbuffers::LoadFile((test_data_path + "monster_test.bfbs").c_str(),
+                                true, &bfbsfile),
+          true);
+  auto &schema = *reflection::GetSchema(bfbsfile.c_str());
+  auto &root = *flatbuffers::GetAnyRoot(flatbuf);
+
+  // A full copy reads back the same as the original, and is no bigger than
+  // one by CopyTable().
+  flatbuffers::TableCopier copier(schema, *schema.root_table(), true);
+  flatbuffers::FlatBufferBuilder fbb;
+  fbb.Finish(copier.Copy(fbb, root), MonsterIdentifier());
+  AccessFlatBufferTest(fbb.GetBufferPointer(), fbb.GetSize());
+  TEST_EQ(flatbuffers::Verify(schema, *schema.root_table(),
+                              fbb.GetBufferPointer(), fbb.GetSize()),
+          true);
+  flatbuffers::FlatBufferBuilder copy_table_fbb;
+  copy_table_fbb.Finish(
+      flatbuffers::CopyTable(copy_table_fbb, schema, *schema.root_table(),
+                             root, true),
+      MonsterIdentifier());
+  TEST_EQ(fbb.GetSize() <= copy_table_fbb.GetSize(), true);
+  // The copier can be reused.
+  flatbuffers::FlatBufferBuilder again;
+  again.Finish(copier.Copy(again, root), MonsterIdentifier());
+  TEST_EQ(again.GetSize(), fbb.GetSize());
+  TEST_EQ(memcmp(again.GetBufferPointer(), fbb.GetBufferPointer(),
+                 fbb.GetSize()),
+          0);
+
+  // Projecting down to a few fields.
+  flatbuffers::TableCopier projection(schema, *schema.root_table());
+  TEST_EQ(projection.Keep("hp"), true);
+  TEST_EQ(projection.Keep("pos.x"), true);
+  TEST_EQ(projection.Keep("testarrayoftables.hp"), true);
+  TEST_EQ(projection.Keep("test"), true);
+  TEST_EQ(projection.Keep("hp.x"), false);
+  TEST_EQ(projection.Keep("nosuchfield"), false);
+  fbb.Clear();
+  fbb.Finish(projection.Copy(fbb, root), MonsterIdentifier());
+  flatbuffers::Verifier verifier(fbb.GetBufferPointer(), fbb.GetSize());
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+  auto monster = GetMonster(fbb.GetBufferPointer());
+  TEST_EQ(monster->hp(), 80);
+  TEST_EQ_STR(monster->name()->c_str(), "MyMonster");  // Required.
+  TEST_EQ(monster->pos()->x(), 1.0f);
+  TEST_EQ(monster->pos()->test3().b(), 20);  // Structs are kept whole.
+  TEST_EQ(monster->inventory() == nullptr, true);
+  TEST_EQ(monster->testarrayofstring() == nullptr, true);
+  auto tables = monster->testarrayoftables();
+  TEST_EQ(tables->size(), 3U);
+  TEST_EQ_STR(tables->Get(1)->name()->c_str(), "Fred");
+  TEST_EQ(tables->Get(0)->hp(), 1000);
+  TEST_EQ(monster->test_type(), Any_Monster);  // Kept with the union.
+  TEST_EQ_STR(monster->test_as_Monster()->name()->c_str(), "Fred");
+  TEST_EQ(fbb.GetSize() < copy_table_fbb.GetSize() / 2, true);
+
+  // Dropping fields.
+  flatbuffers::TableCopier dropper(schema, *schema.root_table(), true);
+  TEST_EQ(dropper.Drop("inventory"), true);
+  TEST_EQ(dropper.Drop("test"), true);
+  TEST_EQ(dropper.Drop("testarrayoftables.hp"), true);
+  TEST_EQ(dropper.Drop("name"), false);  // Required.
+  TEST_EQ(dropper.Drop("pos.x"), false);  // In a struct.
+  fbb.Clear();
+  fbb.Finish(dropper.Copy(fbb, root), MonsterIdentifier());
+  flatbuffers::Verifier drop_verifier(fbb.GetBufferPointer(), fbb.GetSize());
+  TEST_EQ(VerifyMonsterBuffer(drop_verifier), true);
+  monster = GetMonster(fbb.GetBufferPointer());
+  TEST_EQ(monster->inventory() == nullptr, true);
+  TEST_EQ(monster->test_type(), Any_NONE);
+  TEST_EQ(monster->testarrayoftables()->Get(0)->hp(), 100);  // The default.
+  TEST_EQ_STR(monster->testarrayoftables()->Get(0)->name()->c_str(),
+              "Barney");
+  TEST_EQ_STR(monster->testarrayofstring()->Get(1)->c_str(), "fred");
+  TEST_EQ(monster->pos()->z(), 3.0f);
+
+  // A source buffer that isn't 8 byte aligned in memory still gives a copy
+  // with its structs aligned within the buffer.
+  flatbuffers::FlatBufferBuilder source;
+  source.Finish(copier.Copy(source, root), MonsterIdentifier());
+  std::vector<uint64_t> storage(source.GetSize() / sizeof(uint64_t) + 2);
+  auto shifted = reinterpret_cast<uint8_t *>(storage.data()) + 4;
+  memcpy(shifted, source.GetBufferPointer(), source.GetSize());
+  fbb.Clear();
+  fbb.Finish(copier.Copy(fbb, *flatbuffers::GetAnyRoot(shifted)),
+             MonsterIdentifier());
+  TEST_EQ(flatbuffers::Verify(schema, *schema.root_table(),
+                              fbb.GetBufferPointer(), fbb.GetSize()),
+          true);
+  monster = GetMonster(fbb.GetBufferPointer());
+  TEST_EQ((reinterpret_cast<const uint8_t *>(monster->pos()) -
+           fbb.GetBufferPointer()) % 8,
+          0);
+  TEST_EQ(monster->pos()->z(), 3.0f);
+}
+
+void SchemaMigratorTest() {
+  // Record gets a field renamed and one deprecated, a scalar (and a vector
+  // of them) widened, a default changed and a field added. Item is left
+  // as it is, and the union has its members swapped.
+  const char *from_schema =
+      "namespace Migrate;"
+      "struct Vec2 { x:float; y:float; }"
+      "table Item { id:int; label:string; weight:float = 1.0; }"
+      "table Extra { note:string; }"
+      "union Any { Item, Extra }"
+      "table Record { id:int; name:string; score:short = 5; legacy:int;"
+      "  pos:Vec2; items:[Item]; tags:[string]; samples:[short]; any:Any; }"
+      "root_type Record;"
+      "file_identifier \"MIG1\";";
+  const char *to_schema =
+      "namespace Migrate;"
+      "struct Vec2 { x:float; y:float; }"
+      "table Item { id:int; label:string; weight:float = 1.0; }"
+      "table Extra { note:string; }"
+      "union Any { Extra, Item }"
+      "table Record { id:int; title:string; score:int = 7;"
+      "  legacy:int (deprecated); pos:Vec2; items:[Item]; tags:[string];"
+      "  samples:[int]; any:Any; added:long = 3; }"
+      "root_type Record;"
+      "file_identifier \"MIG2\";";
+  const char *json =
+      "{ id: 1, name: \"rec\", legacy: 9, pos: { x: 1.0, y: 2.0 },"
+      "  items: [ { id: 2, label: \"a\" }, { id: 3, weight: 2.5 } ],"
+      "  tags: [ \"x\", \"y\" ], samples: [ 1, -2 ],"
+      "  any_type: Extra, any: { note: \"n\" } }";
+
+  flatbuffers::Parser from_parser;
+  TEST_EQ(from_parser.Parse(from_schema), true);
+  from_parser.Serialize();
+  std::string from_bfbs(
+      reinterpret_cast<const char *>(from_parser.builder_.GetBufferPointer()),
+      from_parser.builder_.GetSize());
+  TEST_EQ(from_parser.Parse(json), true);
+  std::vector<uint8_t> buf(from_parser.builder_.GetBufferPointer(),
+                           from_parser.builder_.GetBufferPointer() +
+                               from_parser.builder_.GetSize());
+  flatbuffers::Parser to_parser;
+  TEST_EQ(to_parser.Parse(to_schema), true);
+  to_parser.Serialize();
+  std::string to_bfbs(
+      reinterpret_cast<const char *>(to_parser.builder_.GetBufferPointer()),
+      to_parser.builder_.GetSize());
+  auto &from = *reflection::GetSchema(from_bfbs.c_str());
+  auto &to = *reflection::GetSchema(to_bfbs.c_str());
+
+  flatbuffers::SchemaMigrator migrator(from, to, true);
+  TEST_EQ(migrator.ok(), true);
+  flatbuffers::FlatBufferBuilder fbb;
+  migrator.MigrateBuffer(fbb, buf.data());
+  TEST_EQ(flatbuffers::Verify(to, *to.root_table(), fbb.GetBufferPointer(),
+                              fbb.GetSize()),
+          true);
+  TEST_EQ(flatbuffers::BufferHasIdentifier(fbb.GetBufferPointer(), "MIG2"),
+          true);
+  std::string text;
+  TEST_EQ(GenerateText(to_parser, fbb.GetBufferPointer(), &text), true);
+  // The score wasn't set, so keeps the default it had.
+  const char *expected =
+      "{\n"
+      "  id: 1,\n"
+      "  title: \"rec\",\n"
+      "  score: 5,\n"
+      "  pos: {\n"
+      "    x: 1.0,\n"
+      "    y: 2.0\n"
+      "  },\n"
+      "  items: [\n"
+      "    {\n"
+      "      id: 2,\n"
+      "      label: \"a\"\n"
+      "    },\n"
+      "    {\n"
+      "      id: 3,\n"
+      "      weight: 2.5\n"
+      "    }\n"
+      "  ],\n"
+      "  tags: [\n"
+      "    \"x\",\n"
+      "    \"y\"\n"
+      "  ],\n"
+      "  samples: [\n"
+      "    1,\n"
+      "    -2\n"
+      "  ],\n"
+      "  any_type: \"Extra\",\n"
+      "  any: {\n"
+      "    note: \"n\"\n"
+      "  }\n"
+      "}\n";
+  TEST_EQ_STR(text.c_str(), expected);
+
+  // Many buffers at once, over a few threads.
+  std::vector<const uint8_t *> buffers(1000, buf.data());
+  std::vector<flatbuffers::DetachedBuffer> migrated;
+  flatbuffers::ThreadPool pool(3);
+  migrator.MigrateAll(buffers.data(), buffers.size(), &migrated, &pool, 64);
+  TEST_EQ(migrated.size(), buffers.size());
+  for (size_t i = 0; i < migrated.size(); i++) {
+    TEST_EQ(migrated[i].size(), fbb.GetSize());
+    TEST_EQ(memcmp(migrated[i].data(), fbb.GetBufferPointer(), fbb.GetSize()),
+            0);
+  }
+
+  // Changes buffers can't be migrated across.
+  flatbuffers::Parser bad_parser;
+  TEST_EQ(bad_parser.Parse(
+              "namespace Migrate;"
+              "struct Vec2 { x:double; y:double; }"
+              "table Item { id:int; label:string; }"
+              "table Extra { note:string; }"
+              "union Any { Item, Extra:Item }"
+              "table Record { id:string; pos:Vec2; any:Any;"
+              "  needed:string (required); }"
+              "root_type Record;"),
+          true);
+  bad_parser.Serialize();
+  flatbuffers::SchemaMigrator bad_migrator(
+      from, *reflection::GetSchema(bad_parser.builder_.GetBufferPointer()));
+  TEST_EQ(bad_migrator.ok(), false);
+  auto &errors = bad_migrator.errors();
+  TEST_EQ(errors.size(), 4U);
+  TEST_EQ(std::find(errors.begin(), errors.end(),
+                    "types differ for field: Migrate.Record.id") !=
+              errors.end(),
+          true);
+  TEST_EQ(std::find(errors.begin(), errors.end(),
+                    "types differ for field: Migrate.Record.pos") !=
+              errors.end(),
+          true);
+  TEST_EQ(std::find(errors.begin(), errors.end(),
+                    "types differ for union member: Migrate.Any.Extra") !=
+              errors.end(),
+          true);
+  TEST_EQ(std::find(errors.begin(), errors.end(),
+                    "required field added: Migrate.Record.needed") !=
+              errors.end(),
+          true);
+
+  // Enum values are stored as numbers, so can't be renumbered.
+  flatbuffers::Parser enum_parser;
+  TEST_EQ(enum_parser.Parse("namespace Migrate;"
+                            "enum Color:byte { Red = 1, Green = 2 }"
+                            "table Record { c:Color = Red; }"
+                            "root_type Record;"),
+          true);
+  enum_parser.Serialize();
+  std::string enum_bfbs(
+      reinterpret_cast<const char *>(enum_parser.builder_.GetBufferPointer()),
+      enum_parser.builder_.GetSize());
+  flatbuffers::Parser renumbered_parser;
+  TEST_EQ(renumbered_parser.Parse("namespace Migrate;"
+                                  "enum Color:byte { Green = 1, Red = 2 }"
+                                  "table Record { c:Color = Red; }"
+                                  "root_type Record;"),
+          true);
+  renumbered_parser.Serialize();
+  flatbuffers::SchemaMigrator enum_migrator(
+      *reflection::GetSchema(enum_bfbs.c_str()),
+      *reflection::GetSchema(renumbered_parser.builder_.GetBufferPointer()));
+  TEST_EQ(enum_migrator.ok(), false);
+  TEST_EQ(enum_migrator.errors().size(), 2U);
+  TEST_EQ_STR(enum_migrator.errors()[0].c_str(),
+              "values differ for enum: Migrate.Color.Red");
+  // As Parser::ConformTo() reports it.
+  std::vector<std::string> conform_errors;
+  TEST_EQ(renumbered_parser.ConformTo(enum_parser, &conform_errors), false);
+  TEST_EQ(std::find(conform_errors.begin(), conform_errors.end(),
+                    "values differ for enum: Migrate.Color.Red") !=
+              conform_errors.end(),
+          true);
+}
+
 void MiniReflectFlatBuffersTest(uint8_t *flatbuf) {
   auto s = flatbuffers::FlatBufferToString(flatbuf, Monster::MiniReflectTypeTable());
   TEST_EQ_STR(
@@ -858,6 +3319,52 @@ void MiniReflectFlatBuffersTest(uint8_t *flatbuf) {
       "}");
 }
 
+// Counts the values of a buffer, called without virtual functions.
+struct CountingVisitor : public flatbuffers::StaticIterationVisitor {
+  CountingVisitor() : fields(0), shorts(0), strings(0) {}
+  void Field(size_t, size_t, flatbuffers::ElementaryType, bool,
+             const flatbuffers::TypeTable *, const char *,
+             const uint8_t *val) {
+    if (val) fields++;
+  }
+  void Short(int16_t, const char *) { shorts++; }
+  void String(const flatbuffers::String *) { strings++; }
+  size_t fields;
+  size_t shorts;
+  size_t strings;
+};
+
+void MiniReflectVisitorTest(uint8_t *flatbuf) {
+  auto type_table = Monster::MiniReflectTypeTable();
+  auto expected = flatbuffers::FlatBufferToString(flatbuf, type_table);
+
+  // The virtual visitor produces the same text as the static one.
+  flatbuffers::ToStringVisitor tostring;
+  flatbuffers::IterationVisitor *visitor = &tostring;
+  flatbuffers::IterateFlatBuffer(flatbuf, type_table, visitor);
+  TEST_EQ_STR(tostring.s.c_str(), expected.c_str());
+
+  // Appending to a reused string.
+  std::string text;
+  flatbuffers::FlatBufferToString(flatbuf, type_table, &text);
+  TEST_EQ_STR(text.c_str(), expected.c_str());
+  auto capacity = text.capacity();
+  text.clear();
+  flatbuffers::FlatBufferToString(flatbuf, type_table, &text);
+  TEST_EQ_STR(text.c_str(), expected.c_str());
+  TEST_EQ(text.capacity(), capacity);
+  flatbuffers::FlatBufferToString(flatbuf, type_table, &text);
+  TEST_EQ(text, expected + expected);
+
+  CountingVisitor counter;
+  flatbuffers::IterateFlatBuffer(flatbuf, type_table, &counter);
+  TEST_EQ(counter.fields > 0, true);
+  // hp, pos.test3.a, 2 test4 a, testarrayoftables hp and 2 test5 a.
+  TEST_EQ(counter.shorts, 7U);
+  // name, test.name, testarrayofstring(2) and testarrayoftables names.
+  TEST_EQ(counter.strings, 11U);
+}
+
 // Parse a .proto schema, output as .fbs
 void ParseProtoTest() {
   // load the .proto and the golden file from disk
@@ -1216,6 +3723,8 @@ void ErrorTest() {
             "type id");
   TestError("table X { Y:int; } root_type X; { Z:", "unknown field");
   TestError("table X { Y:int; } root_type X; { Y:", "string constant", true);
+  TestError("table X { Y:int; } root_type X; { Y: 1 }", "instead got: Y",
+            true);
   TestError("table X { Y:int; } root_type X; { \"Y\":1, }", "string constant",
             true);
   TestError(
@@ -1588,6 +4097,111 @@ void UnknownFieldsTest() {
   TEST_EQ_STR(jsongen.c_str(), "{str: \"test\",i: 10}");
 }
 
+struct CountedDefinition {
+  explicit CountedDefinition(int *_count) : count(_count) {}
+  ~CountedDefinition() { (*count)++; }
+  int *count;
+  std::string payload;
+};
+
+void SymbolTableTest() {
+  int destroyed = 0;
+  {
+    flatbuffers::DefinitionArena arena;
+    flatbuffers::SymbolTable<CountedDefinition> table;
+    // Enough to grow the table (and the arena) a few times.
+    for (int i = 0; i < 1000; i++) {
+      auto def = arena.New<CountedDefinition>(&destroyed);
+      def->payload = flatbuffers::NumToString(i);
+      TEST_EQ(table.Add("def" + def->payload, def), false);
+    }
+    TEST_EQ(table.vec.size(), 1000);
+    for (int i = 0; i < 1000; i++) {
+      auto def = table.Lookup("def" + flatbuffers::NumToString(i));
+      TEST_NOTNULL(def);
+      TEST_EQ(def->payload == flatbuffers::NumToString(i), true);
+    }
+    TEST_EQ(table.Lookup("def1000") == nullptr, true);
+    TEST_EQ(table.Lookup("def12", 4) == table.Lookup("def1"), true);
+
+    // The first of a name is the one found.
+    auto first = table.Lookup("def7");
+    TEST_EQ(table.Add("def7", arena.New<CountedDefinition>(&destroyed)),
+            true);
+    TEST_EQ(table.Lookup("def7") == first, true);
+    TEST_EQ(table.vec.size(), 1001);
+
+    table.Move("def7", "seven");
+    TEST_EQ(table.Lookup("def7") == nullptr, true);
+    TEST_EQ(table.Lookup("seven") == first, true);
+    for (int i = 0; i < 1000; i += 2) {
+      table.Remove("def" + flatbuffers::NumToString(i));
+    }
+    for (int i = 0; i < 1000; i++) {
+      auto def = table.Lookup("def" + flatbuffers::NumToString(i));
+      TEST_EQ(def != nullptr, i % 2 == 1 && i != 7);
+    }
+    size_t names = 0;
+    table.ForEach([&](const std::string &, const CountedDefinition *) {
+      names++;
+    });
+    TEST_EQ(names, 500);
+    TEST_EQ(destroyed, 0);
+  }
+  // The arena destroys everything, the table nothing.
+  TEST_EQ(destroyed, 1001);
+}
+
+// Long strings and whitespace runs, and tables with many fields, which take
+// the parser's faster paths.
+void JsonScanTest() {
+  std::string schema = "table T { s:string; ";
+  std::string json = "{\n";
+  for (int i = 0; i < 200; i++) {
+    auto name = "f" + flatbuffers::NumToString(i);
+    schema += name + ":int; ";
+    json += "                " + name + ": " +
+            flatbuffers::NumToString(i * 3 + 1) + ",\n";
+  }
+  schema += "} root_type T;";
+  std::string text(100, 'a');
+  text += "\n'\"\\" + std::string(40, 'b') + "\xE2\x82\xAC";
+  json += "  s: \"" + std::string(100, 'a') + "\\n'\\\"\\\\" +
+          std::string(40, 'b') + "\\u20AC\"\n}\n";
+
+  flatbuffers::Parser parser;
+  TEST_EQ(parser.Parse(schema.c_str()), true);
+  TEST_EQ(parser.Parse(json.c_str()), true);
+  auto root = flatbuffers::GetRoot<flatbuffers::Table>(
+      parser.builder_.GetBufferPointer());
+  for (int i = 0; i < 200; i++) {
+    TEST_EQ(root->GetField<int32_t>(
+                flatbuffers::FieldIndexToOffset(
+                    static_cast<flatbuffers::voffset_t>(i + 1)),
+                -1),
+            i * 3 + 1);
+  }
+  auto s = root->GetPointer<const flatbuffers::String *>(
+      flatbuffers::FieldIndexToOffset(0));
+  TEST_NOTNULL(s);
+  TEST_EQ(s->str() == text, true);
+  auto struct_def = parser.LookupStruct("T");
+  TEST_EQ(struct_def->LookupField("f123", 4),
+          struct_def->fields.Lookup("f123"));
+  TEST_EQ(struct_def->LookupField("f200", 4),
+          static_cast<flatbuffers::FieldDef *>(nullptr));
+
+  // Lines are still counted across runs of whitespace.
+  std::string bad = "{\n" + std::string(50, ' ') + "\n\n   \t\r\n" +
+                    std::string(20, ' ') + "f200: 1 }";
+  TEST_EQ(parser.Parse(bad.c_str()), false);
+  TEST_EQ(parser.error_.find("5:0: error: unknown field: f200"), 0);
+  // Control characters are found inside long strings too.
+  std::string control = "{ s: \"" + std::string(40, 'a') + "\t\" }";
+  TEST_EQ(parser.Parse(control.c_str()), false);
+  TEST_NOTNULL(strstr(parser.error_.c_str(), "illegal character"));
+}
+
 void ParseUnionTest() {
   // Unions must be parseable with the type field following the object.
   flatbuffers::Parser parser;
@@ -1708,6 +4322,185 @@ void UnionVectorTest() {
       "{ books_read: 2 }, \"Other\", \"Unused\" ] }");
 }
 
+void HashIndexTest() {
+  using namespace HashIndex;
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<Route>> routes;
+  std::vector<flatbuffers::Offset<Host>> hosts;
+  for (int i = 0; i < 5000; i++) {
+    auto prefix = "10." + flatbuffers::NumToString(i / 256) + "." +
+                  flatbuffers::NumToString(i % 256) + ".0/24";
+    routes.push_back(CreateRoute(builder, builder.CreateString(prefix),
+                                 static_cast<uint16_t>(i)));
+    hosts.push_back(CreateHost(builder, int64_t(i) * -7919));
+  }
+  auto routes_index = flatbuffers::CreateHashIndex(builder, routes,
+                                                   &Route::prefix);
+  auto hosts_index = flatbuffers::CreateHashIndex(builder, hosts, &Host::id);
+  builder.Finish(CreateRoutingTable(builder, 1, builder.CreateVector(hosts),
+                                    hosts_index, builder.CreateVector(routes),
+                                    routes_index));
+  flatbuffers::Verifier verifier(builder.GetBufferPointer(),
+                                 builder.GetSize());
+  TEST_EQ(verifier.VerifyBuffer<RoutingTable>(nullptr), true);
+
+  auto table = flatbuffers::GetRoot<RoutingTable>(builder.GetBufferPointer());
+  TEST_EQ(table->routes_hash_index()->size(), 16384);
+  for (int i = 0; i < 5000; i++) {
+    auto prefix = "10." + flatbuffers::NumToString(i / 256) + "." +
+                  flatbuffers::NumToString(i % 256) + ".0/24";
+    auto route = table->routes_by_key(prefix.c_str());
+    TEST_NOTNULL(route);
+    TEST_EQ(route->port(), i);
+    auto host = table->hosts_by_key(int64_t(i) * -7919);
+    TEST_NOTNULL(host);
+    TEST_EQ(host == table->hosts()->Get(i), true);
+  }
+  TEST_EQ(table->routes_by_key("10.0.0.0/8") == nullptr, true);
+  TEST_EQ(table->hosts_by_key(1) == nullptr, true);
+
+  // No index, or an empty vector.
+  TEST_EQ(flatbuffers::LookupByKeyHashed(table->routes(), nullptr, "x") ==
+              nullptr,
+          true);
+  flatbuffers::FlatBufferBuilder empty_builder;
+  std::vector<flatbuffers::Offset<Route>> no_routes;
+  auto empty_index =
+      flatbuffers::CreateHashIndex(empty_builder, no_routes, &Route::prefix);
+  empty_builder.Finish(CreateRoutingTable(
+      empty_builder, 0, 0, 0, empty_builder.CreateVector(no_routes),
+      empty_index));
+  auto empty =
+      flatbuffers::GetRoot<RoutingTable>(empty_builder.GetBufferPointer());
+  TEST_EQ(empty->routes_by_key("10.0.0.0/24") == nullptr, true);
+
+  // Keys are converted to the type of the key field before hashing.
+  TEST_EQ(table->hosts_by_key(-7919) == table->hosts()->Get(1), true);
+  TEST_EQ(flatbuffers::LookupByKeyHashed(table->hosts(),
+                                         table->hosts_hash_index(), -7919) ==
+              table->hosts()->Get(1),
+          true);
+
+  // Pack() indexes the vectors it packs, and the parser those it parses,
+  // unless given an index.
+  flatbuffers::unique_ptr<RoutingTableT> unpacked(table->UnPack());
+  unpacked->hosts.resize(10);
+  unpacked->hosts_hash_index.clear();
+  unpacked->routes_hash_index.clear();
+  flatbuffers::FlatBufferBuilder packed_builder;
+  packed_builder.Finish(RoutingTable::Pack(packed_builder, unpacked.get()));
+  auto packed =
+      flatbuffers::GetRoot<RoutingTable>(packed_builder.GetBufferPointer());
+  TEST_EQ(packed->routes_by_key("10.19.135.0/24")->port(), 4999);
+  TEST_EQ(packed->hosts_by_key(-9 * 7919) == packed->hosts()->Get(9), true);
+  TEST_EQ(packed->hosts_by_key(-10 * 7919) == nullptr, true);
+
+  std::string schema;
+  TEST_EQ(flatbuffers::LoadFile(
+              (test_data_path + "hash_index_test/hash_index_test.fbs").c_str(),
+              false, &schema),
+          true);
+  flatbuffers::Parser parser;
+  TEST_EQ(parser.Parse(schema.c_str()), true);
+  TEST_EQ(parser.Parse("{ hosts: [ { id: 3 }, { id: -2 }, {} ],"
+                       "  routes: [ { prefix: \"a\", port: 1 },"
+                       "            { prefix: \"b\", port: 2 } ] }"),
+          true);
+  auto parsed =
+      flatbuffers::GetRoot<RoutingTable>(parser.builder_.GetBufferPointer());
+  TEST_EQ(parsed->hosts_hash_index()->size(), 8);
+  TEST_EQ(parsed->hosts_by_key(-2) == parsed->hosts()->Get(1), true);
+  TEST_EQ(parsed->hosts_by_key(0) == parsed->hosts()->Get(2), true);
+  TEST_EQ(parsed->routes_by_key("b")->port(), 2);
+  TEST_EQ(parsed->routes_by_key("c") == nullptr, true);
+  TEST_EQ(parser.Parse("{ hosts: [ { id: 3 } ], hosts_hash_index: [] }"),
+          true);
+  parsed =
+      flatbuffers::GetRoot<RoutingTable>(parser.builder_.GetBufferPointer());
+  TEST_EQ(parsed->hosts_hash_index()->size(), 0);
+  TEST_EQ(parsed->hosts_by_key(3) == nullptr, true);
+
+  TestError(
+      "table T { a:int (key); } table R { t:[T] (hashed); t_hash_index:int; }",
+      "field already exists");
+  TestError("table T { a:int; } table R { t:[T] (hashed); }",
+            "hashed vector of a table without a key field");
+  TestError("table R { t:[int] (hashed); }",
+            "hashed attribute may only apply to a vector of tables");
+}
+
+void ColumnarTest() {
+  using namespace Columnar;
+  // Build a vector of readings column by column, leaving some columns
+  // shorter (or absent) to get defaults.
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<uint32_t> ids;
+  std::vector<double> values;
+  std::vector<flatbuffers::Offset<flatbuffers::String>> labels;
+  for (uint32_t i = 0; i < 10; i++) {
+    ids.push_back(i * 2);
+    if (i < 5) values.push_back(i * 0.5);
+    labels.push_back(builder.CreateString(flatbuffers::NumToString(i)));
+  }
+  std::vector<uint8_t> valid(2, 0);
+  std::vector<Point> locations(1, Point(1, 2));
+  auto readings = CreateReadingColumnsDirect(builder, &ids, &values, nullptr,
+                                             &valid, &labels, &locations);
+  FinishLogBuffer(builder, CreateLog(builder, readings));
+  flatbuffers::Verifier verifier(builder.GetBufferPointer(),
+                                 builder.GetSize());
+  TEST_EQ(VerifyLogBuffer(verifier), true);
+
+  auto columns = GetLog(builder.GetBufferPointer())->readings();
+  TEST_EQ(columns->GetRowCount(), 10);
+  // A scan over one field reads a single contiguous vector.
+  uint32_t sum = 0;
+  for (auto it = columns->id()->begin(); it != columns->id()->end(); ++it) {
+    sum += *it;
+  }
+  TEST_EQ(sum, 90);
+  for (flatbuffers::uoffset_t i = 0; i < columns->GetRowCount(); i++) {
+    auto row = columns->GetRow(i);
+    TEST_EQ(row.id(), i * 2);
+    TEST_EQ(row.value(), i < 5 ? i * 0.5 : 1.5);
+    TEST_EQ(row.kind(), Kind_Sensor);
+    TEST_EQ(row.valid(), i >= 2);
+    TEST_EQ_STR(row.label()->c_str(), flatbuffers::NumToString(i).c_str());
+    TEST_EQ(row.location() != nullptr, i == 0);
+  }
+  TEST_EQ(columns->GetRow(0).location()->y(), 2);
+
+  // The same from JSON, where the vector is an object of columns.
+  std::string schemafile;
+  TEST_EQ(flatbuffers::LoadFile(
+              (test_data_path + "columnar_test/columnar_test.fbs").c_str(),
+              false, &schemafile),
+          true);
+  flatbuffers::Parser parser;
+  TEST_EQ(parser.Parse(schemafile.c_str()), true);
+  TEST_EQ(parser.Parse("{ readings: { id: [5, 6], kind: [Actuator],"
+                       " label: [\"a\", \"b\"] } }"),
+          true);
+  columns = GetLog(parser.builder_.GetBufferPointer())->readings();
+  TEST_EQ(columns->GetRowCount(), 2);
+  TEST_EQ(columns->GetRow(0).kind(), Kind_Actuator);
+  TEST_EQ(columns->GetRow(1).kind(), Kind_Sensor);
+  TEST_EQ_STR(columns->GetRow(1).label()->c_str(), "b");
+  std::string jsongen;
+  GenerateText(parser, parser.builder_.GetBufferPointer(), &jsongen);
+  TEST_NOTNULL(strstr(jsongen.c_str(), "id: [\n      5,\n      6\n    ]"));
+
+  TestError("table R { a:int; } table T { r:R (columnar); }",
+            "columnar attribute may only apply to a vector of tables");
+  TestError("table T { r:[R] (columnar); } table R { a:int; }",
+            "columnar table must be declared before it is used");
+  TestError("table R { a:[int]; } table T { r:[R] (columnar); }",
+            "columnar tables may contain only scalar, string or struct");
+  TestError(
+      "table R { a:int; } table RColumns {} table T { r:[R] (columnar); }",
+      "datatype already exists");
+}
+
 void ConformTest() {
   flatbuffers::Parser parser;
   TEST_EQ(parser.Parse("table T { A:int; } enum E:byte { A }"), true);
@@ -1726,6 +4519,30 @@ void ConformTest() {
   test_conform(parser, "table T { B:float; }",
                "field renamed to different type");
   test_conform(parser, "enum E:byte { B, A }", "values differ for enum");
+
+  // All the problems, not just the first.
+  flatbuffers::Parser parser3;
+  TEST_EQ(parser3.Parse("table T { A:byte = 1; } enum E:byte { B, A }"), true);
+  std::vector<std::string> errors;
+  TEST_EQ(parser3.ConformTo(parser, &errors), false);
+  TEST_EQ(errors.size(), 3);
+  TEST_EQ_STR(errors[0].c_str(), "defaults differ for field: T.A");
+  TEST_EQ_STR(errors[1].c_str(), "types differ for field: T.A");
+  TEST_EQ_STR(errors[2].c_str(), "values differ for enum: E.A");
+  errors.clear();
+  TEST_EQ(parser.ConformTo(parser, &errors), true);
+  TEST_EQ(errors.empty(), true);
+}
+
+void ListFilesTest() {
+  std::vector<std::string> files;
+  auto dir = test_data_path + "include_test";
+  TEST_EQ(flatbuffers::ListFiles(dir.c_str(), &files), true);
+  TEST_EQ(files.size(), 2);
+  TEST_EQ_STR(files[0].c_str(), "include_test1.fbs");
+  TEST_EQ_STR(files[1].c_str(), "sub/include_test2.fbs");
+  dir = test_data_path + "no_such_directory";
+  TEST_EQ(flatbuffers::ListFiles(dir.c_str(), &files), false);
 }
 
 void ParseProtoBufAsciiTest() {
@@ -1882,6 +4699,807 @@ void FlexBuffersTest() {
   TEST_EQ_STR(jsontest, jsonback.c_str());
 }
 
+void JsonFlexParserTest() {
+  // The same buffers as Parser::ParseFlexBuffer().
+  const char *docs[] = {
+    "{ a: [ 123, -4.5e2, \"hi\\n\", null ], 'b': { a: true, c: false },"
+    "  /* comment */ \"c\": [ [], {}, [ 1, [ 2 ] ] ], // more\n d: 0x10 }",
+    "[ { key: 1 }, { key: 2 }, { key: 3, other: \"}{][\" } ]",
+    "\"just a string\"",
+    "42",
+  };
+  flatbuffers::JsonFlexParser json_flex;
+  for (int i = 0; i < 2; i++) {  // Again, reusing the memory.
+    for (size_t d = 0; d < sizeof(docs) / sizeof(*docs); d++) {
+      flatbuffers::Parser parser;
+      flexbuffers::Builder expected;
+      TEST_EQ(parser.ParseFlexBuffer(docs[d], nullptr, &expected), true);
+      TEST_EQ(json_flex.Parse(docs[d]), true);
+      TEST_EQ(json_flex.GetBuffer() == expected.GetBuffer(), true);
+    }
+  }
+  TEST_EQ(json_flex.Parse(docs[1]), true);
+  auto vec = flexbuffers::GetRoot(json_flex.GetBuffer()).AsVector();
+  TEST_EQ(vec.size(), 3);
+  TEST_EQ(vec[2].AsMap()["key"].AsInt64(), 3);
+  TEST_EQ_STR(vec[2].AsMap()["other"].AsString().c_str(), "}{][");
+
+  TEST_EQ(json_flex.Parse("{ a: nope }"), false);
+  TEST_EQ_STR(json_flex.error().c_str(),
+              "line 1: cannot parse value starting with: nope");
+  TEST_EQ(json_flex.Parse("[ 1 ] 2"), false);
+  TEST_EQ_STR(json_flex.error().c_str(),
+              "line 1: unexpected text after the root value");
+  TEST_EQ(json_flex.Parse("[ \"unterminated ]"), false);
+  TEST_EQ(json_flex.Parse("{ x: 1 }"), true);
+  TEST_EQ(json_flex.error().empty(), true);
+  TEST_EQ(flexbuffers::GetRoot(json_flex.GetBuffer()).AsMap()["x"].AsInt64(),
+          1);
+}
+
+// Counts the allocations it passes on to the default allocator.
+class CountingAllocator : public flatbuffers::Allocator {
+ public:
+  CountingAllocator() : allocations(0), live(0) {}
+  virtual uint8_t *allocate(size_t size) FLATBUFFERS_OVERRIDE {
+    allocations++;
+    live++;
+    return flatbuffers::DefaultAllocator::instance().allocate(size);
+  }
+  virtual void deallocate(uint8_t *p, size_t size) FLATBUFFERS_OVERRIDE {
+    live--;
+    flatbuffers::DefaultAllocator::instance().deallocate(p, size);
+  }
+  size_t allocations;
+  size_t live;
+};
+
+void BuildFlexEvent(flexbuffers::Builder &fbb, int i) {
+  auto map = fbb.StartMap();
+  fbb.String("kind", i % 2 ? "click" : "view");
+  fbb.Int("seq", i);
+  fbb.Key("tags");
+  auto vec = fbb.StartVector();
+  for (int j = 0; j < 8; j++) fbb.String(j % 3 ? "shared" : "other");
+  fbb.EndVector(vec, false, false);
+  auto inner = fbb.StartMap("inner");
+  fbb.String("kind", "view");
+  fbb.EndMap(inner);
+  fbb.EndMap(map);
+  fbb.Finish();
+}
+
+void FlexBuilderAllocatorTest() {
+  auto flags = flexbuffers::BUILDER_FLAG_SHARE_KEYS_AND_STRINGS;
+  flexbuffers::Builder reference(16, flags);
+  CountingAllocator counter;
+  {
+    flexbuffers::Builder fbb(16, flags, &counter);
+    size_t warm = 0;
+    for (int i = 0; i < 10; i++) {
+      fbb.Clear();
+      reference.Clear();
+      BuildFlexEvent(fbb, i);
+      BuildFlexEvent(reference, i);
+      TEST_EQ(fbb.GetBuffer() == reference.GetBuffer(), true);
+      auto root = flexbuffers::GetRoot(fbb.GetBuffer()).AsMap();
+      TEST_EQ(root["seq"].AsInt32(), i);
+      TEST_EQ_STR(root["kind"].AsString().c_str(), i % 2 ? "click" : "view");
+      auto tags = root["tags"].AsVector();
+      TEST_EQ(tags.size(), 8U);
+      TEST_EQ_STR(tags[7].AsString().c_str(), "shared");
+      // Shared strings point to the same bytes.
+      TEST_EQ(tags[1].AsString().c_str() == tags[7].AsString().c_str(), true);
+      if (i == 1) warm = counter.allocations;
+    }
+    TEST_EQ(counter.allocations > 0, true);
+    // Once warmed up, Clear() keeps the stack and pools allocated.
+    TEST_EQ(counter.allocations, warm);
+  }
+  TEST_EQ(counter.live, 0U);
+}
+
+void BuildFlexRecords(flexbuffers::Builder &fbb) {
+  auto vec = fbb.StartVector();
+  for (int i = 0; i < 20; i++) {
+    auto map = fbb.StartMap();
+    // Odd records have an extra field, so not all maps have the same keys.
+    for (int j = 0; j < 40 + i % 2; j++) {
+      auto key = "field" + flatbuffers::NumToString(j);
+      fbb.Int(key.c_str(), i * 100 + j);
+    }
+    fbb.EndMap(map);
+  }
+  fbb.EndVector(vec, false, false);
+  fbb.Finish();
+}
+
+void FlexMapKeyHashTest() {
+  flexbuffers::Builder plain;
+  BuildFlexRecords(plain);
+  auto flags = static_cast<flexbuffers::BuilderFlag>(
+      flexbuffers::BUILDER_FLAG_SHARE_KEYS |
+      flexbuffers::BUILDER_FLAG_HASH_MAP_KEYS);
+  flexbuffers::Builder hashed(256, flags);
+  BuildFlexRecords(hashed);
+
+  auto plain_root = flexbuffers::GetRoot(plain.GetBuffer()).AsVector();
+  auto root = flexbuffers::GetRoot(hashed.GetBuffer()).AsVector();
+  // Readers that don't use the hashes see the same data.
+  TEST_EQ(root.size(), 20U);
+  TEST_EQ_STR(flexbuffers::GetRoot(hashed.GetBuffer()).ToString().c_str(),
+              flexbuffers::GetRoot(plain.GetBuffer()).ToString().c_str());
+  TEST_EQ(plain_root[0].AsMap().HasKeyHashes(), false);
+  TEST_EQ(flexbuffers::Map::EmptyMap().HasKeyHashes(), false);
+
+  for (size_t i = 0; i < root.size(); i++) {
+    auto map = root[i].AsMap();
+    auto plain_map = plain_root[i].AsMap();
+    TEST_EQ(map.HasKeyHashes(), true);
+    for (int j = 0; j < 42; j++) {
+      auto key = "field" + flatbuffers::NumToString(j);
+      auto expected = j < 40 + static_cast<int>(i % 2)
+                          ? static_cast<int64_t>(i * 100 + j)
+                          : 0;
+      TEST_EQ(map[key].AsInt64(), expected);
+      TEST_EQ(plain_map[key].AsInt64(), expected);
+      TEST_EQ(map[key].IsNull(), !expected && j);
+    }
+    TEST_EQ(map["field"].IsNull(), true);
+    TEST_EQ(map[""].IsNull(), true);
+  }
+
+  // Cached keys give the same results, with or without hashes.
+  flexbuffers::CachedKey field7("field7");
+  flexbuffers::CachedKey field40("field40");
+  flexbuffers::CachedKey missing("missing");
+  for (size_t i = 0; i < root.size(); i++) {
+    auto maps = { root[i].AsMap(), plain_root[i].AsMap() };
+    for (auto it = maps.begin(); it != maps.end(); ++it) {
+      TEST_EQ((*it)[field7].AsInt64(), static_cast<int64_t>(i * 100 + 7));
+      TEST_EQ((*it)[field40].AsInt64(),
+              i % 2 ? static_cast<int64_t>(i * 100 + 40) : 0);
+      TEST_EQ((*it)[missing].IsNull(), true);
+    }
+  }
+}
+
+void FlexStreamTest() {
+  flexbuffers::Builder fbb;
+  fbb.StartStream();
+  std::vector<size_t> ready;  // What can be sent after each element.
+  for (int i = 0; i < 50; i++) {
+    if (i % 5 == 4) {
+      fbb.Int(i);  // Inline values work too.
+    } else {
+      auto map = fbb.StartMap();
+      fbb.Int("id", i);
+      fbb.String("name", "element" + flatbuffers::NumToString(i));
+      fbb.EndMap(map);
+    }
+    fbb.EndStreamElement();
+    ready.push_back(fbb.GetStreamReadySize());
+    TEST_EQ(ready.size() < 2 || ready[ready.size() - 2] < ready.back(), true);
+  }
+  TEST_EQ(fbb.EndStream(), 50U);
+  auto &buf = fbb.GetBuffer();
+  TEST_EQ(fbb.GetStreamReadySize(), buf.size());
+
+  // Receive the buffer in small chunks, and read elements as soon as they
+  // have arrived.
+  flexbuffers::StreamReader reader;
+  std::vector<uint8_t> received;
+  for (size_t pos = 0; pos < buf.size(); pos += 7) {
+    auto end = (std::min)(pos + 7, buf.size());
+    received.insert(received.end(), buf.begin() + pos, buf.begin() + end);
+    flexbuffers::Reference elem(nullptr, 1, 0);
+    while (reader.Next(flatbuffers::vector_data(received), received.size(),
+                       &elem)) {
+      auto i = static_cast<int>(reader.count() - 1);
+      // Not before it was ready to be sent.
+      TEST_EQ(received.size() >= ready[i], true);
+      if (i % 5 == 4) {
+        TEST_EQ(elem.AsInt32(), i);
+      } else {
+        auto map = elem.AsMap();
+        TEST_EQ(map["id"].AsInt32(), i);
+        TEST_EQ(map["name"].AsString().str(),
+                "element" + flatbuffers::NumToString(i));
+      }
+    }
+    TEST_EQ(reader.error(), false);
+  }
+  TEST_EQ(reader.done(), true);
+  TEST_EQ(reader.count(), 50U);
+
+  // And it's an ordinary FlexBuffer.
+  auto root = flexbuffers::GetRoot(received).AsVector();
+  TEST_EQ(root.size(), 50U);
+  TEST_EQ(root[3].AsMap()["id"].AsInt32(), 3);
+  TEST_EQ(root[49].AsInt32(), 49);
+
+  // An empty stream.
+  fbb.Clear();
+  fbb.StartStream();
+  TEST_EQ(fbb.EndStream(), 0U);
+  flexbuffers::StreamReader empty_reader;
+  flexbuffers::Reference elem(nullptr, 1, 0);
+  TEST_EQ(empty_reader.Next(flatbuffers::vector_data(fbb.GetBuffer()),
+                            fbb.GetBuffer().size(), &elem),
+          false);
+  TEST_EQ(empty_reader.done(), true);
+  TEST_EQ(flexbuffers::GetRoot(fbb.GetBuffer()).AsVector().size(), 0U);
+
+  // The root stays untyped even if vectors of one type would be typed.
+  flexbuffers::Builder typed_fbb(512,
+                                 flexbuffers::BUILDER_FLAG_AUTO_TYPED_VECTORS);
+  typed_fbb.StartStream();
+  for (int i = 0; i < 3; i++) {
+    typed_fbb.Int(i);
+    typed_fbb.EndStreamElement();
+  }
+  TEST_EQ(typed_fbb.EndStream(), 3U);
+  auto typed_root = flexbuffers::GetRoot(typed_fbb.GetBuffer());
+  TEST_EQ(typed_root.GetType(), flexbuffers::TYPE_VECTOR);
+  TEST_EQ(typed_root.AsVector().size(), 3U);
+  TEST_EQ(typed_root.AsVector()[2].AsInt32(), 2);
+
+  // Not a stream.
+  flexbuffers::StreamReader bad_reader;
+  uint8_t not_a_stream[] = { 1, 2, 3, 4, 5, 6 };
+  TEST_EQ(bad_reader.Next(not_a_stream, sizeof(not_a_stream), &elem), false);
+  TEST_EQ(bad_reader.error(), true);
+}
+
+// Checks CopyTo<T>() against reading the elements one at a time.
+template<typename T, typename V> void CheckFlexCopyTo(const V &vec,
+                                                      size_t size) {
+  // Not std::vector, which has no data() for bools.
+  std::unique_ptr<T[]> out(new T[size + 1]);
+  TEST_EQ(vec.CopyTo(out.get(), size + 1), size);
+  for (size_t i = 0; i < size; i++) TEST_EQ(out[i], vec[i].template As<T>());
+  // It only writes `max` elements.
+  std::unique_ptr<T[]> part(new T[size + 1]);
+  std::fill(part.get(), part.get() + size + 1, T(42));
+  auto half = size / 2;
+  TEST_EQ(vec.CopyTo(part.get(), half), half);
+  for (size_t i = 0; i < half; i++) TEST_EQ(part[i], out[i]);
+  if (half < size) TEST_EQ(part[half], T(42));
+}
+
+template<typename S> void CheckFlexTypedVectorCopy(size_t size) {
+  flexbuffers::Builder fbb;
+  std::vector<S> values;
+  for (size_t i = 0; i < size; i++) {
+    // Covers negative numbers and the extremes of S. Floats stay positive
+    // and in range, since converting anything else to an int is undefined.
+    auto limit = i % 2 ? flatbuffers::numeric_limits<S>::max()
+                       : flatbuffers::numeric_limits<S>::lowest();
+    auto v = std::is_floating_point<S>::value
+                 ? static_cast<S>(i * 1.25)
+                 : i % 3 ? static_cast<S>(static_cast<int64_t>(i * 37) -
+                                          static_cast<int64_t>(size))
+                         : limit;
+    values.push_back(v);
+  }
+  fbb.Vector(flatbuffers::vector_data(values), values.size());
+  fbb.Finish();
+  auto vec = flexbuffers::GetRoot(fbb.GetBuffer()).AsTypedVector();
+  TEST_EQ(vec.size(), size);
+  CheckFlexCopyTo<int64_t>(vec, size);
+  CheckFlexCopyTo<uint64_t>(vec, size);
+  CheckFlexCopyTo<int32_t>(vec, size);
+  CheckFlexCopyTo<double>(vec, size);
+  CheckFlexCopyTo<float>(vec, size);
+  CheckFlexCopyTo<S>(vec, size);
+}
+
+void FlexTypedVectorCopyTest() {
+  // Sizes that exercise both the SIMD loops and their tails.
+  size_t sizes[] = { 0, 1, 5, 17, 100 };
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(*sizes); i++) {
+    CheckFlexTypedVectorCopy<int8_t>(sizes[i]);
+    CheckFlexTypedVectorCopy<int16_t>(sizes[i]);
+    CheckFlexTypedVectorCopy<int32_t>(sizes[i]);
+    CheckFlexTypedVectorCopy<int64_t>(sizes[i]);
+    CheckFlexTypedVectorCopy<uint8_t>(sizes[i]);
+    CheckFlexTypedVectorCopy<uint16_t>(sizes[i]);
+    CheckFlexTypedVectorCopy<uint32_t>(sizes[i]);
+    CheckFlexTypedVectorCopy<uint64_t>(sizes[i]);
+    CheckFlexTypedVectorCopy<float>(sizes[i]);
+    CheckFlexTypedVectorCopy<double>(sizes[i]);
+  }
+
+  flexbuffers::Builder fbb;
+  fbb.Vector([&]() {
+    fbb.TypedVector([&]() {
+      for (int i = 0; i < 20; i++) fbb.Int(i * 1000 - 5000);
+    });
+    fbb.TypedVector([&]() {
+      for (int i = 0; i < 20; i++) fbb.Bool(i % 3 == 0);
+    });
+    fbb.TypedVector([&]() {
+      fbb.String("a");
+      fbb.String("bc");
+    });
+    int32_t ints[] = { -1, 2, -3 };
+    fbb.FixedTypedVector(ints, 3);
+    double doubles[] = { 1.5, -2.5 };
+    fbb.FixedTypedVector(doubles, 2);
+  });
+  fbb.Finish();
+  auto root = flexbuffers::GetRoot(fbb.GetBuffer()).AsVector();
+
+  // Ints are stored as int16_t here.
+  auto ints = root[0].AsTypedVector();
+  CheckFlexCopyTo<int64_t>(ints, 20);
+  CheckFlexCopyTo<double>(ints, 20);
+  TEST_NOTNULL(ints.Data<int16_t>());
+  TEST_EQ(ints.Data<int16_t>()[3], -2000);
+  TEST_EQ(ints.Data<uint16_t>() == nullptr, true);
+  TEST_EQ(ints.Data<int32_t>() == nullptr, true);
+
+  auto bools = root[1].AsTypedVector();
+  CheckFlexCopyTo<bool>(bools, 20);
+  CheckFlexCopyTo<int32_t>(bools, 20);
+  TEST_NOTNULL(bools.Data<bool>());
+  TEST_EQ(bools.Data<bool>()[3], true);
+  TEST_EQ(bools.Data<bool>()[4], false);
+
+  // Not numbers: converted one at a time, like As<T>().
+  auto strings = root[2].AsTypedVector();
+  CheckFlexCopyTo<int64_t>(strings, 2);
+  TEST_EQ(strings.Data<int8_t>() == nullptr, true);
+
+  auto fixed_ints = root[3].AsFixedTypedVector();
+  CheckFlexCopyTo<int64_t>(fixed_ints, 3);
+  CheckFlexCopyTo<float>(fixed_ints, 3);
+  TEST_EQ(fixed_ints.Data<int32_t>()[2], -3);
+
+  auto fixed_doubles = root[4].AsFixedTypedVector();
+  CheckFlexCopyTo<double>(fixed_doubles, 2);
+  CheckFlexCopyTo<int64_t>(fixed_doubles, 2);
+  TEST_EQ(fixed_doubles.Data<float>() == nullptr, true);
+}
+
+void FlexAutoTypedVectorTest() {
+  auto json =
+      "{ points: [ { x: 1, y: 2 }, { x: -3, y: 4 }, { x: 5, y: 600 } ],"
+      "  ids: [ 10, 20, 30, 40, 50, 60 ],"
+      "  weights: [ 0.5, 1.5 ],"
+      "  flags: [ true, false, true ],"
+      "  mixed: [ 1, \"two\", 3.0 ],"
+      "  empty: [] }";
+  flatbuffers::Parser parser;
+  flexbuffers::Builder plain;
+  TEST_EQ(parser.ParseFlexBuffer(json, nullptr, &plain), true);
+  flexbuffers::Builder compact(
+      256, static_cast<flexbuffers::BuilderFlag>(
+               flexbuffers::BUILDER_FLAG_SHARE_ALL |
+               flexbuffers::BUILDER_FLAG_AUTO_TYPED_VECTORS));
+  flatbuffers::Parser compact_parser;
+  TEST_EQ(compact_parser.ParseFlexBuffer(json, nullptr, &compact), true);
+  TEST_EQ(compact.GetSize() < plain.GetSize(), true);
+
+  // The same values, differently stored.
+  auto plain_root = flexbuffers::GetRoot(plain.GetBuffer());
+  auto root = flexbuffers::GetRoot(compact.GetBuffer());
+  TEST_EQ(root.ToString(), plain_root.ToString());
+  auto map = root.AsMap();
+  TEST_EQ(map["points"].GetType(), flexbuffers::TYPE_VECTOR);  // Of maps.
+  TEST_EQ(map["points"].AsVector()[2].AsMap()["y"].AsInt32(), 600);
+  TEST_EQ(map["ids"].GetType(), flexbuffers::TYPE_VECTOR_INT);
+  TEST_EQ(map["ids"].AsTypedVector()[5].AsInt32(), 60);
+  TEST_EQ(map["weights"].GetType(), flexbuffers::TYPE_VECTOR_FLOAT2);
+  TEST_EQ(map["weights"].AsFixedTypedVector()[1].AsDouble(), 1.5);
+  TEST_EQ(map["flags"].GetType(), flexbuffers::TYPE_VECTOR_BOOL);
+  TEST_EQ(map["flags"].AsTypedVector()[2].AsBool(), true);
+  TEST_EQ(map["mixed"].GetType(), flexbuffers::TYPE_VECTOR);
+  TEST_EQ(map["empty"].GetType(), flexbuffers::TYPE_VECTOR);
+
+  // Maps with the same keys share their keys vector, also with hashed keys.
+  for (int hashed = 0; hashed < 2; hashed++) {
+    auto build = [&](flexbuffers::Builder &fbb) {
+      fbb.Vector([&]() {
+        for (int i = 0; i < 10; i++) {
+          fbb.Map([&]() {
+            fbb.Int("x", i);
+            fbb.Int("y", -i);
+            if (i % 2) fbb.Int("z", i * i);
+          });
+        }
+      });
+      fbb.Finish();
+    };
+    auto hash_flag = hashed ? flexbuffers::BUILDER_FLAG_HASH_MAP_KEYS
+                            : flexbuffers::BUILDER_FLAG_NONE;
+    flexbuffers::Builder unshared(
+        256, static_cast<flexbuffers::BuilderFlag>(
+                 flexbuffers::BUILDER_FLAG_SHARE_KEYS | hash_flag));
+    build(unshared);
+    flexbuffers::Builder shared(
+        256, static_cast<flexbuffers::BuilderFlag>(
+                 flexbuffers::BUILDER_FLAG_SHARE_KEYS |
+                 flexbuffers::BUILDER_FLAG_SHARE_KEY_VECTORS | hash_flag));
+    build(shared);
+    TEST_EQ(shared.GetSize() < unshared.GetSize(), true);
+    auto maps = flexbuffers::GetRoot(shared.GetBuffer()).AsVector();
+    TEST_EQ(maps.size(), 10U);
+    for (size_t i = 0; i < maps.size(); i++) {
+      auto m = maps[i].AsMap();
+      auto n = static_cast<int>(i);
+      TEST_EQ(m.size(), n % 2 ? 3U : 2U);
+      TEST_EQ(m.HasKeyHashes(), hashed == 1);
+      TEST_EQ(m["x"].AsInt32(), n);
+      TEST_EQ(m["y"].AsInt32(), -n);
+      TEST_EQ(m["z"].AsInt32(), n % 2 ? n * n : 0);
+    }
+    // Clear() forgets the keys vectors of the last buffer.
+    shared.Clear();
+    build(shared);
+    TEST_EQ(flexbuffers::GetRoot(shared.GetBuffer())
+                .AsVector()[9]
+                .AsMap()["z"]
+                .AsInt32(),
+            81);
+  }
+}
+
+void FlexReleaseTest() {
+  flexbuffers::Builder fbb;
+  auto build = [&](int n) {
+    fbb.Map([&]() {
+      fbb.Int("n", n);
+      fbb.String("s", "released");
+    });
+    fbb.Finish();
+  };
+
+  // Release() hands over the buffer itself, no copy.
+  build(1);
+  auto data = flatbuffers::vector_data(fbb.GetBuffer());
+  auto size = fbb.GetSize();
+  auto detached = fbb.Release();
+  TEST_EQ(detached.data() == data, true);
+  TEST_EQ(detached.size(), size);
+  auto map = flexbuffers::GetRoot(detached.data(), detached.size()).AsMap();
+  TEST_EQ(map["n"].AsInt32(), 1);
+  TEST_EQ_STR(map["s"].AsString().c_str(), "released");
+  TEST_EQ(fbb.GetSize(), 0U);
+
+  // The builder carries on with a new buffer.
+  build(2);
+  data = flatbuffers::vector_data(fbb.GetBuffer());
+  auto vec = fbb.ReleaseVector();
+  TEST_EQ(flatbuffers::vector_data(vec) == data, true);
+  TEST_EQ(flexbuffers::GetRoot(vec).AsMap()["n"].AsInt32(), 2);
+  // The first buffer is unaffected.
+  TEST_EQ(map["n"].AsInt32(), 1);
+
+  // Give the released vector back to build the next buffer in.
+  fbb.Clear(std::move(vec));
+  build(3);
+  TEST_EQ(flatbuffers::vector_data(fbb.GetBuffer()) == data, true);
+  TEST_EQ(flexbuffers::GetRoot(fbb.GetBuffer()).AsMap()["n"].AsInt32(), 3);
+}
+
+// Builds the buffer FlexPathTest() and FlexPatchTest() query and patch.
+void BuildFlexUsers(flexbuffers::Builder &fbb, const char *first_name,
+                    int64_t second_age, int64_t second_id) {
+  fbb.Map([&]() {
+    fbb.Vector("users", [&]() {
+      fbb.Map([&]() {
+        fbb.String("name", first_name);
+        fbb.Int("age", 30);
+        fbb.Vector("tags", [&]() {
+          fbb.String("a");
+          fbb.String("b");
+        });
+      });
+      fbb.Map([&]() {
+        fbb.String("name", "bob");
+        fbb.Int("age", second_age);
+        fbb.Double("score", 1.5);
+      });
+    });
+    fbb.Int("count", 2);
+    fbb.Bool("flag", true);
+    int64_t ids[] = { 1, 2, second_id };
+    fbb.Vector("ids", ids, 3);
+  });
+  fbb.Finish();
+}
+
+void FlexPathTest() {
+  flexbuffers::Builder fbb;
+  BuildFlexUsers(fbb, "ann", 40, 3);
+  auto root = flexbuffers::GetRoot(fbb.GetBuffer());
+
+  TEST_EQ_STR(flexbuffers::Path("users[1].name")(root).AsString().c_str(),
+              "bob");
+  TEST_EQ_STR(flexbuffers::Path("users[0].tags[1]")(root).AsString().c_str(),
+              "b");
+  TEST_EQ(flexbuffers::Path("ids[2]")(root).AsInt64(), 3);
+  TEST_EQ(flexbuffers::Path("count")(root).AsInt64(), 2);
+  // Maps can be indexed too, in key order.
+  TEST_EQ(flexbuffers::Path("users[1][0]")(root).AsInt64(), 40);
+  flexbuffers::Reference value(nullptr, 1, 0);
+  TEST_EQ(flexbuffers::Path("").Find(root, &value), true);
+  TEST_EQ(value.IsMap(), true);
+
+  // Values that don't exist.
+  const char *missing[] = { "users[2]", "nokey", "count.x", "users.name",
+                            "ids[3]", "flag[0]" };
+  for (size_t i = 0; i < sizeof(missing) / sizeof(*missing); i++) {
+    flexbuffers::Path path(missing[i]);
+    TEST_EQ(path.valid(), true);
+    TEST_EQ(path.Find(root, &value), false);
+    TEST_EQ(path(root).IsNull(), true);
+  }
+
+  // Paths that don't parse.
+  const char *invalid[] = { "a.", ".a", "a..b", "[x]", "[1", "a[1]b",
+                            "a.[1]", "[-1]" };
+  for (size_t i = 0; i < sizeof(invalid) / sizeof(*invalid); i++) {
+    flexbuffers::Path path(invalid[i]);
+    TEST_EQ(path.valid(), false);
+    TEST_EQ(path.size(), 0U);
+  }
+  TEST_EQ(flexbuffers::Path("users[0].tags[1]").size(), 4U);
+}
+
+void FlexPathSetTest() {
+  flexbuffers::PathSet paths;
+  const char *texts[] = { "users[0].name", "users[1].age", "users[0].age",
+                          "count",         "users[5].age", "a..b",
+                          "users[0].name", "users[1].score" };
+  size_t num_paths = sizeof(texts) / sizeof(*texts);
+  for (size_t i = 0; i < num_paths; i++) TEST_EQ(paths.Add(texts[i]), i);
+  TEST_EQ(paths.size(), num_paths);
+
+  std::vector<flexbuffers::Reference> values;
+  for (int i = 0; i < 3; i++) {
+    flexbuffers::Builder fbb;
+    if (i < 2) {
+      BuildFlexUsers(fbb, i ? "bea" : "ann", 40 + i, 3);
+    } else {
+      // Differently shaped, so the remembered key positions are wrong.
+      fbb.Map([&]() {
+        fbb.Vector("users", [&]() {
+          fbb.Map([&]() {
+            fbb.String("aaa", "first");
+            fbb.String("name", "cid");
+            fbb.Int("age", 50);
+          });
+        });
+        fbb.Int("count", 1);
+      });
+      fbb.Finish();
+    }
+    auto root = flexbuffers::GetRoot(fbb.GetBuffer());
+    auto num_found = paths.Find(root, &values);
+    TEST_EQ(values.size(), num_paths);
+    size_t expected_found = 0;
+    for (size_t p = 0; p < num_paths; p++) {
+      flexbuffers::Path path(texts[p]);
+      flexbuffers::Reference value(nullptr, 1, 0);
+      auto found = path.Find(root, &value);
+      expected_found += found;
+      TEST_EQ(paths.found(p), found);
+      TEST_EQ(values[p].ToString(), path(root).ToString());
+    }
+    TEST_EQ(num_found, expected_found);
+    TEST_EQ(num_found, i < 2 ? 6U : 4U);
+  }
+}
+
+void FlexPatchTest() {
+  flexbuffers::Builder fbb;
+  BuildFlexUsers(fbb, "ann", 40, 3);
+  auto buf = fbb.GetBuffer();
+
+  // Updates that fit in place.
+  flexbuffers::Patch in_place;
+  in_place.SetInt("users[0].age", 31);
+  in_place.SetString("users[1].name", "bub");
+  in_place.SetBool("flag", false);
+  in_place.SetInt("count", 5);
+  in_place.SetInt("count", 7);  // The last update of a path wins.
+  auto copy = buf;
+  TEST_EQ(in_place.ApplyInPlace(flatbuffers::vector_data(copy), copy.size()),
+          true);
+  auto root = flexbuffers::GetRoot(copy);
+  TEST_EQ(flexbuffers::Path("users[0].age")(root).AsInt64(), 31);
+  TEST_EQ_STR(flexbuffers::Path("users[1].name")(root).AsString().c_str(),
+              "bub");
+  TEST_EQ(flexbuffers::Path("flag")(root).AsBool(), false);
+  TEST_EQ(flexbuffers::Path("count")(root).AsInt64(), 7);
+  // Then Apply() just copies the buffer.
+  std::vector<uint8_t> out;
+  TEST_EQ(in_place.Apply(flatbuffers::vector_data(buf), buf.size(), &out),
+          true);
+  TEST_EQ(out == copy, true);
+
+  // Updates that don't fit, mixed with some that do.
+  flexbuffers::Patch patch;
+  patch.SetString("users[0].name", "annabelle");
+  patch.SetInt("users[1].age", 100000);
+  patch.SetInt("ids[2]", 1000000);
+  patch.SetInt("count", 3);
+  copy = buf;
+  TEST_EQ(patch.ApplyInPlace(flatbuffers::vector_data(copy), copy.size()),
+          false);
+  TEST_EQ(patch.error().empty(), true);
+  TEST_EQ(patch.Apply(flatbuffers::vector_data(buf), buf.size(), &out), true);
+  // Same as building it with the new values from scratch.
+  flexbuffers::Builder expected;
+  BuildFlexUsers(expected, "annabelle", 100000, 1000000);
+  auto patched = flexbuffers::GetRoot(out);
+  auto expected_root = flexbuffers::GetRoot(expected.GetBuffer());
+  auto patched_str = patched.ToString();
+  auto expected_str = expected_root.ToString();
+  TEST_EQ(patched_str.find("count: 3") != std::string::npos, true);
+  patched_str.replace(patched_str.find("count: 3"), 8, "count: 2");
+  TEST_EQ(patched_str, expected_str);
+  TEST_EQ(patched.AsMap()["ids"].GetType(), flexbuffers::TYPE_VECTOR_INT);
+  // Only the maps and vectors leading to the updates were written again,
+  // e.g. not users[0].tags.
+  TEST_EQ(out.size() < buf.size() * 2, true);
+  TEST_EQ(flexbuffers::Path("users[0].tags")(patched).AsVector().size(), 2U);
+
+  // A typed vector that gets an element of another type becomes untyped.
+  flexbuffers::Patch retype;
+  retype.SetString("ids[0]", "one");
+  TEST_EQ(retype.Apply(flatbuffers::vector_data(buf), buf.size(), &out), true);
+  auto ids = flexbuffers::GetRoot(out).AsMap()["ids"];
+  TEST_EQ(ids.GetType(), flexbuffers::TYPE_VECTOR);
+  TEST_EQ_STR(ids.AsVector()[0].AsString().c_str(), "one");
+  TEST_EQ(ids.AsVector()[2].AsInt64(), 3);
+
+  // The root itself.
+  flexbuffers::Patch replace_root;
+  replace_root.SetString("", "root");
+  TEST_EQ(replace_root.Apply(flatbuffers::vector_data(buf), buf.size(), &out),
+          true);
+  TEST_EQ_STR(flexbuffers::GetRoot(out).AsString().c_str(), "root");
+
+  // Maps with hashed keys keep them.
+  flexbuffers::Builder hashed(256, flexbuffers::BUILDER_FLAG_HASH_MAP_KEYS);
+  BuildFlexUsers(hashed, "ann", 40, 3);
+  TEST_EQ(patch.Apply(flatbuffers::vector_data(hashed.GetBuffer()),
+                      hashed.GetSize(), &out),
+          true);
+  auto user = flexbuffers::Path("users[0]")(flexbuffers::GetRoot(out)).AsMap();
+  TEST_EQ(user.HasKeyHashes(), true);
+  TEST_EQ_STR(user["name"].AsString().c_str(), "annabelle");
+
+  // Errors.
+  flexbuffers::Patch missing;
+  missing.SetInt("users[2].age", 1);
+  TEST_EQ(missing.Apply(flatbuffers::vector_data(buf), buf.size(), &out),
+          false);
+  TEST_EQ(missing.error(), std::string("no such value: users[2].age"));
+  flexbuffers::Patch invalid;
+  invalid.SetInt("users..age", 1);
+  TEST_EQ(invalid.Apply(flatbuffers::vector_data(buf), buf.size(), &out),
+          false);
+  TEST_EQ(invalid.error(), std::string("invalid path: users..age"));
+  flexbuffers::Patch overlapping;
+  overlapping.SetInt("users[0].age", 1);
+  overlapping.SetNull("users[0]");
+  TEST_EQ(overlapping.Apply(flatbuffers::vector_data(buf), buf.size(), &out),
+          false);
+  TEST_EQ(overlapping.error(),
+          std::string("path inside another update: users[0].age"));
+}
+
+void FlexVerifierTest() {
+  flexbuffers::Builder fbb;
+  BuildFlexUsers(fbb, "ann", 40, 3);
+  auto buf = fbb.GetBuffer();
+  TEST_EQ(flexbuffers::VerifyBuffer(buf), true);
+
+  // All kinds of values, built in various ways.
+  flexbuffers::Builder all(256, static_cast<flexbuffers::BuilderFlag>(
+                                    flexbuffers::BUILDER_FLAG_SHARE_ALL |
+                                    flexbuffers::BUILDER_FLAG_HASH_MAP_KEYS));
+  all.Vector([&]() {
+    all.Null();
+    all.Int(-5);
+    all.UInt(500);
+    all.Double(2.5);
+    all.Bool(true);
+    all.IndirectInt(-100000);
+    all.IndirectUInt(100000);
+    all.IndirectFloat(0.25f);
+    all.String("string");
+    all.Key("key");
+    uint8_t blob[] = { 1, 2, 3 };
+    all.Blob(blob, sizeof(blob));
+    all.TypedVector([&]() {
+      all.String("a");
+      all.String("bc");
+    });
+    int16_t ints[] = { 1, 2, 3 };
+    all.FixedTypedVector(ints, 3);
+    all.Vector(ints, 3);
+    for (int i = 0; i < 3; i++) {
+      all.Map([&]() {
+        all.Int("x", i);
+        all.Int("y", -i);
+      });
+    }
+  });
+  all.Finish();
+  TEST_EQ(flexbuffers::VerifyBuffer(all.GetBuffer()), true);
+
+  // Streams are FlexBuffers too.
+  flexbuffers::Builder stream;
+  stream.StartStream();
+  stream.Int(1);
+  stream.EndStreamElement();
+  stream.EndStream();
+  TEST_EQ(flexbuffers::VerifyBuffer(stream.GetBuffer()), true);
+
+  // Damaged buffers either fail verification, or are still safe to read all
+  // of (which ASan / UBSan builds check).
+  const std::vector<uint8_t> *bufs[] = { &buf, &all.GetBuffer() };
+  for (size_t b = 0; b < 2; b++) {
+    auto damaged = *bufs[b];
+    for (size_t i = 0; i < damaged.size(); i++) {
+      auto orig = damaged[i];
+      uint8_t values[] = { 0, 1, 0x7F, 0x80, 0xFF,
+                           static_cast<uint8_t>(orig + 1) };
+      for (size_t v = 0; v < sizeof(values); v++) {
+        damaged[i] = values[v];
+        if (flexbuffers::VerifyBuffer(damaged)) {
+          flexbuffers::GetRoot(damaged).ToString();
+        }
+      }
+      damaged[i] = orig;
+      // And cut short.
+      TEST_EQ(flexbuffers::VerifyBuffer(flatbuffers::vector_data(damaged), i) &&
+                  i < 3,
+              false);
+    }
+  }
+
+  // Keys must be sorted.
+  auto unsorted = buf;
+  auto users = flexbuffers::GetRoot(unsorted).AsMap()["users"].AsVector();
+  auto name = users[0].AsMap().Keys()[1].AsKey();  // After "age".
+  TEST_EQ_STR(name, "name");
+  *const_cast<char *>(name) = 'A';
+  TEST_EQ(flexbuffers::VerifyBuffer(unsorted), false);
+
+  // Strings must be terminated.
+  auto unterminated = buf;
+  auto count = flexbuffers::GetRoot(unterminated)
+                   .AsMap()["users"]
+                   .AsVector()[0]
+                   .AsMap()["name"]
+                   .AsString();
+  const_cast<char *>(count.c_str())[count.length()] = 'x';
+  TEST_EQ(flexbuffers::VerifyBuffer(unterminated), false);
+
+  // Limits.
+  flexbuffers::Builder deep;
+  std::vector<size_t> starts;
+  for (int i = 0; i < 10; i++) starts.push_back(deep.StartVector());
+  deep.Int(1);
+  while (!starts.empty()) {
+    deep.EndVector(starts.back(), false, false);
+    starts.pop_back();
+  }
+  deep.Finish();
+  TEST_EQ(flexbuffers::VerifyBuffer(deep.GetBuffer()), true);
+  flexbuffers::Verifier shallow(flatbuffers::vector_data(deep.GetBuffer()),
+                                deep.GetSize(), 5);
+  TEST_EQ(shallow.VerifyBuffer(), false);
+  flexbuffers::Verifier few(flatbuffers::vector_data(buf), buf.size(), 64, 3);
+  TEST_EQ(few.VerifyBuffer(), false);
+}
+
 void TypeAliasesTest() {
   flatbuffers::FlatBufferBuilder builder;
 
@@ -1958,10 +5576,32 @@ int main(int /*argc*/, const char * /*argv*/ []) {
   MutateFlatBuffersTest(flatbuf.data(), flatbuf.size());
 
   ObjectFlatBuffersTest(flatbuf.data());
+  UnPackToReuseTest(flatbuf.data());
+  SizedCreateTest();
+  BuilderStatsTest();
 
   MiniReflectFlatBuffersTest(flatbuf.data());
+  MiniReflectVisitorTest(flatbuf.data());
 
   SizePrefixedTest();
+  VtableIndexTest();
+  AllocatorsTest();
+  SizeHintTest();
+  SegmentedBuilderTest();
+  SharedStringTest();
+  BuilderPoolTest();
+  AddElementsTest();
+  SpliceTest();
+  ReferenceVectorTest();
+  SinkTest();
+  ParallelVerifierTest();
+  LazyVerifierTest();
+  BulkStringVerifierTest();
+  VerificationCacheTest();
+  HashBatchTest();
+  PrefetchingRangeTest();
+  KeyIndexTest();
+  HashIndexTest();
 
   #ifndef FLATBUFFERS_NO_FILE_TESTS
     #ifdef FLATBUFFERS_TEST_PATH_PREFIX
@@ -1969,9 +5609,25 @@ int main(int /*argc*/, const char * /*argv*/ []) {
                        test_data_path;
     #endif
     ParseAndGenerateTextTest();
+    DeserializeTest();
+    JsonApiTest();
+    CompiledSchemaTest();
     ReflectionTest(flatbuf.data(), flatbuf.size());
+    FieldAccessorTest(flatbuf.data());
+    ResizeBatchTest(flatbuf.data(), flatbuf.size());
+    TableCopierTest(flatbuf.data());
+    SchemaMigratorTest();
+    ColumnExtractorTest();
+    FlexTranscoderTest();
+    VerifierStatsTest(flatbuf.data(), flatbuf.size());
+    MappedBufferTest();
+    StreamTest();
+    CompressedStreamTest();
+    SaveFileTest();
+    ListFilesTest();
     ParseProtoTest();
     UnionVectorTest();
+    ColumnarTest();
   #endif
   // clang-format on
 
@@ -1990,6 +5646,10 @@ int main(int /*argc*/, const char * /*argv*/ []) {
   UnicodeInvalidSurrogatesTest();
   InvalidUTF8Test();
   UnknownFieldsTest();
+  SymbolTableTest();
+  JsonScanTest();
+  ParseRecordsTest();
+  GenerateTextToTest();
   ParseUnionTest();
   ConformTest();
   ParseProtoBufAsciiTest();
@@ -1999,6 +5659,17 @@ int main(int /*argc*/, const char * /*argv*/ []) {
   JsonDefaultTest();
 
   FlexBuffersTest();
+  JsonFlexParserTest();
+  FlexBuilderAllocatorTest();
+  FlexMapKeyHashTest();
+  FlexStreamTest();
+  FlexTypedVectorCopyTest();
+  FlexAutoTypedVectorTest();
+  FlexReleaseTest();
+  FlexPathTest();
+  FlexPathSetTest();
+  FlexPatchTest();
+  FlexVerifierTest();
 
   if (!testing_fails) {
     TEST_OUTPUT_LINE("ALL TESTS PASSED");